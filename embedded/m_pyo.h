@@ -304,6 +304,141 @@ inline int pyo_exec_statement(PyThreadState *interp, char *msg, int debug) {
     return err;
 }
 
+/*
+** Handle of a pyo server computing planar buffers directly. Its members
+** are private to this header, only use the pyo_server_* functions.
+**
+** A server created with pyo_server_new runs without the GIL: the strings
+** of the functions above are only exchanged at creation, and
+** pyo_server_process can be called concurrently, from any thread of the
+** host, for different servers. The python statements executed in one
+** server's interpreter only wait for the buffer of that server.
+*/
+typedef int (*pyo_process_callback)(void *server, float **ins, float **outs, int frames);
+
+typedef struct pyo_server {
+    PyThreadState *interp;
+    void *server;
+    pyo_process_callback process;
+    int ichnls;
+    int nchnls;
+} pyo_server;
+
+/*
+** Creates a new python interpreter and starts a GIL-free pyo server in it.
+**
+** arguments:
+**  ichnls : int, number of input channels of the pyo server.
+**  nchnls : int, number of output channels of the pyo server.
+**  sr : float, host sampling rate.
+**  bufsize : int, host buffer size.
+**
+** returns the server handle, NULL if the server can't be started.
+*/
+inline pyo_server * pyo_server_new(int ichnls, int nchnls, float sr, int bufsize) {
+    char msg[128];
+    PyObject *module, *obj;
+    pyo_server *server = (pyo_server *)calloc(1, sizeof(pyo_server));
+    if(!Py_IsInitialized()) {
+        Py_Initialize();
+        PyEval_InitThreads();
+        PyEval_ReleaseLock();
+    }
+    server->ichnls = ichnls;
+    server->nchnls = nchnls;
+    PyEval_AcquireLock();
+    server->interp = Py_NewInterpreter();
+    PyRun_SimpleString("from pyo import *");
+    sprintf(msg, "_s_ = Server(sr=%f, nchnls=%d, buffersize=%d, duplex=1, audio='embedded', ichnls=%d)",
+            sr, nchnls, bufsize, ichnls);
+    PyRun_SimpleString(msg);
+    PyRun_SimpleString("_s_.setGILFree(True)\n_s_.boot()\n_s_.start()");
+    PyRun_SimpleString("_emb_process_ = _s_.getEmbedPCallback()");
+    module = PyImport_AddModule("__main__");
+    obj = PyObject_GetAttrString(module, "_emb_process_");
+    if (obj != NULL && PyTuple_Check(obj)) {
+        server->server = PyLong_AsVoidPtr(PyTuple_GetItem(obj, 0));
+        server->process = (pyo_process_callback)PyLong_AsVoidPtr(PyTuple_GetItem(obj, 1));
+    }
+    Py_XDECREF(obj);
+    PyErr_Clear();
+    if (server->process == NULL) {
+        Py_EndInterpreter(server->interp);
+        PyEval_ReleaseLock();
+        free(server);
+        return NULL;
+    }
+    PyEval_ReleaseThread(server->interp);
+    return server;
+}
+
+/*
+** Computes "frames" frames, a multiple of the server's buffer size, from
+** the host's planar buffers. Called without any python state, from any
+** thread, but only by one thread at a time for a given server.
+**
+** arguments:
+**  server : pointer, server handle.
+**  ins : float **, "ichnls" input buffers, or NULL for silence.
+**  outs : float **, "nchnls" output buffers.
+**  frames : int, number of frames per channel.
+**
+** returns 0, or -1 if "frames" is not a multiple of the buffer size.
+*/
+inline int pyo_server_process(pyo_server *server, float **ins, float **outs, int frames) {
+    return (*server->process)(server->server, ins, outs, frames);
+}
+
+/*
+** Returns the python thread state of the server's interpreter, to use with
+** the functions above (pyo_exec_statement, pyo_set_server_params, etc.).
+** Rebooting the server keeps the handle valid, as long as no buffer is
+** computed meanwhile.
+**
+** arguments:
+**  server : pointer, server handle.
+*/
+inline PyThreadState * pyo_server_get_interpreter(pyo_server *server) {
+    return server->interp;
+}
+
+/*
+** Reboots the server with new sampling rate and buffer size. The handle
+** holds no buffer address, so the server's buffers are reallocated to the
+** new size. No buffer may be computed meanwhile.
+**
+** arguments:
+**  server : pointer, server handle.
+**  sr : float, host sampling rate.
+**  bufsize : int, host buffer size.
+*/
+inline void pyo_server_set_params(pyo_server *server, float sr, int bufsize) {
+    char msg[64];
+    PyEval_AcquireThread(server->interp);
+    PyRun_SimpleString("_s_.setServer()\n_s_.stop()\n_s_.shutdown()");
+    sprintf(msg, "_s_.setSamplingRate(%f)", sr);
+    PyRun_SimpleString(msg);
+    sprintf(msg, "_s_.setBufferSize(%d)", bufsize);
+    PyRun_SimpleString(msg);
+    PyRun_SimpleString("_s_.boot(newBuffer=True).start()");
+    PyEval_ReleaseThread(server->interp);
+}
+
+/*
+** Shuts down the server and closes its interpreter. No buffer may be
+** computed anymore.
+**
+** arguments:
+**  server : pointer, server handle.
+*/
+inline void pyo_server_free(pyo_server *server) {
+    PyEval_AcquireThread(server->interp);
+    PyRun_SimpleString("_s_.stop()\n_s_.shutdown()");
+    Py_EndInterpreter(server->interp);
+    PyEval_ReleaseLock();
+    free(server);
+}
+
 #if defined(_LANGUAGE_C_PLUS_PLUS) || defined(__cplusplus)
 }
 #endif
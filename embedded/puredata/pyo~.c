@@ -16,31 +16,18 @@ typedef struct _pyo_tilde {
     char *file;
     t_sample **in;
     t_sample **out;
-    int id;                 /* pyo server id */
-    float *inbuf;           /* pyo input buffer */
-    float *outbuf;          /* pyo output buffer */
     char *msg;              /* preallocated string to construct message for pyo */
-    void (*callback)(int);  /* pointer to pyo embedded server callback */
+    pyo_server *server;     /* pyo server computing Pd's vectors in place */
     PyThreadState *interp;  /* Python thread state linked to this sub interpreter */
 } t_pyo_tilde;
 
+/* Runs without the GIL, instances of different Pd threads don't wait for each other. */
 t_int *pyo_tilde_perform(t_int *w) {
-    int i, j, n;
     t_pyo_tilde *x = (t_pyo_tilde *)(w[1]); /* pointer to instance struct */
-    n = (int)(w[2]);                        /* vector size */
-    t_sample **in = x->in;
-    t_sample **out = x->out;
-    for (i=0; i<n; i++) {
-        for (j=0; j<x->chnls; j++) {
-            x->inbuf[i*x->chnls+j] = in[j][i];
-        }
-    }
-    (*x->callback)(x->id);
-    for (i=0; i<n; i++) {
-        for (j=0; j<x->chnls; j++) {
-            out[j][i] = x->outbuf[i*x->chnls+j];
-        }
-    }
+    int n = (int)(w[2]);                    /* vector size */
+    /* Pd may give the same vector to an inlet and an outlet, the server
+       reads all the inputs of a buffer before writing the outputs. */
+    pyo_server_process(x->server, x->in, x->out, n);
     return (w+3);
 }
 
@@ -56,7 +43,7 @@ void pyo_tilde_dsp(t_pyo_tilde *x, t_signal **sp) {
     if ((float)sp[0]->s_sr != x->sr || (int)sp[0]->s_n != x->bs) {
         x->sr = (float)sp[0]->s_sr;
         x->bs = (int)sp[0]->s_n;
-        pyo_set_server_params(x->interp, x->sr, x->bs);
+        pyo_server_set_params(x->server, x->sr, x->bs);
         if (x->file != NULL) {
             err = pyo_exec_file(x->interp, x->file, x->msg, x->add);
             if (err) {
@@ -93,12 +80,13 @@ void *pyo_tilde_new(t_floatarg f) {
     for (i=0; i<x->chnls; i++)
         x->in[i] = x->out[i] = 0;
 
-    x->interp = pyo_new_interpreter(x->chnls);
-    
-    x->inbuf = (float *)pyo_get_input_buffer_address(x->interp);
-    x->outbuf = (float *)pyo_get_output_buffer_address(x->interp);
-    x->callback = (void *)pyo_get_embedded_callback_address(x->interp);
-    x->id = pyo_get_server_id(x->interp);
+    x->server = pyo_server_new(x->chnls, x->chnls, sys_getsr(), sys_getblksize());
+    if (x->server == NULL) {
+        post("pyo~: unable to start the pyo server");
+        pd_free((t_pd *)x);
+        return NULL;
+    }
+    x->interp = pyo_server_get_interpreter(x->server);
 
     return (void *)x;
 }
@@ -107,7 +95,8 @@ void pyo_tilde_free(t_pyo_tilde *x) {
     freebytes(x->in, sizeof(x->in));
     freebytes(x->out, sizeof(x->out));
     freebytes(x->msg, sizeof(x->msg));
-    pyo_end_interpreter(x->interp);
+    if (x->server != NULL)
+        pyo_server_free(x->server);
 }
 
 void pyo_tilde_set_value(t_pyo_tilde *x, char *att, int argc, t_atom *argv) {
@@ -492,3 +492,56 @@ Gain_members,                                   /* tp_members */
 0,                                              /* tp_alloc */
 Gain_new,                                       /* tp_new */
 };
+
+/*****************************************************
+Template for a block processing unit. A unit is only
+a DSP routine, hosted by the "Unit" object of pyo, which
+takes care of the streams, the multi-channel expansion,
+the parameters given as PyoObjects and mul/add.
+*****************************************************/
+#include "pyounit.h"
+
+typedef struct {
+    MYFLT db; /* last value of the parameter */
+    MYFLT amp; /* its amplitude, recomputed when the value changes */
+} GainUnitState;
+
+static const PyoUnitParam GainUnit_params[] = {
+    {"db", -3.0, PYO_UNIT_ARATE},
+};
+
+static void
+GainUnit_init(void *state, double sr, int bufsize)
+{
+    GainUnitState *st = (GainUnitState *)state;
+    st->db = 0.0;
+    st->amp = 1.0;
+}
+
+static void
+GainUnit_process(void *state, const MYFLT **in, MYFLT **out, const MYFLT **params, int nframes)
+{
+    int i;
+    GainUnitState *st = (GainUnitState *)state;
+    const MYFLT *db = params[0];
+
+    for (i=0; i<nframes; i++) {
+        if (db[i] != st->db) {
+            st->db = db[i];
+            st->amp = MYPOW(10.0, st->db * 0.05);
+        }
+        out[0][i] = in[0][i] * st->amp;
+    }
+}
+
+/* Registered by name in EXTERNAL_UNITS, then Unit("gain", input). */
+const PyoUnit GainUnit = {
+    PYO_UNIT_HEADER,
+    "gain",                 /* name */
+    1, 1,                   /* ninputs, noutputs */
+    1, GainUnit_params,     /* nparams, params */
+    sizeof(GainUnitState),  /* size of the state, allocated by the host */
+    GainUnit_init,          /* init, or NULL */
+    NULL,                   /* release, or NULL */
+    GainUnit_process,
+};
@@ -12,3 +12,15 @@ with your object's name and type for each external object.
 #define EXTERNAL_OBJECTS \
     module_add_object(m, "Gain_base", &GainType); \
 
+
+/********************************************************** 
+Declare each block processing unit and register it by name
+in this macro, called when "_pyo" is imported. Units are
+hosted by the "Unit" object, see include/pyounit.h.
+**********************************************************/
+struct PyoUnit;
+extern const struct PyoUnit GainUnit;
+
+#define EXTERNAL_UNITS \
+    PyoUnit_register(&GainUnit); \
+
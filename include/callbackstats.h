@@ -0,0 +1,112 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _CALLBACKSTATS_
+#define _CALLBACKSTATS_
+
+#include <stdio.h>
+#include <pthread.h>
+#include "pyomodule.h"
+
+/* Timing of the audio callbacks against their deadline.
+ *
+ * The audio thread times each callback and adds it to a histogram of its
+ * load, the callback time in percent of the duration of the host buffer.
+ * It counts the callbacks late and the underflows and overflows reported by
+ * the backend, and keeps the longest callbacks with their server time. The
+ * counters are written under a sequence number, a reader copies them
+ * without lock and retries if the audio thread wrote meanwhile.
+ *
+ * Xruns signaled from another thread (jack, coreaudio) are only counted,
+ * the audio thread reports them with its next callback.
+ *
+ * The late or flagged callbacks are also pushed in a ring, drained by an
+ * optional log thread writing one line per event.
+ */
+#define CBSTATS_BINS 32     /* the last bin holds the callbacks longer than the others */
+#define CBSTATS_BIN_WIDTH 10 /* percent of the deadline */
+#define CBSTATS_WORST 8
+#define CBSTATS_EVENTS 256
+
+/* Flags of the events. */
+#define CBSTATS_LATE 1
+#define CBSTATS_UNDERFLOW 2
+#define CBSTATS_OVERFLOW 4
+#define CBSTATS_XRUN 8
+
+typedef struct {
+    double time; /* server time at the start of the callback, in seconds */
+    unsigned long long elapsed; /* nanoseconds */
+    int flags;
+} CallbackEvent;
+
+typedef struct {
+    double deadline; /* duration of the host buffer, in nanoseconds */
+    unsigned long count;
+    unsigned long late;
+    unsigned long underflows;
+    unsigned long overflows;
+    unsigned long xruns;
+    unsigned long long total;
+    unsigned long long max;
+    unsigned long bins[CBSTATS_BINS];
+    CallbackEvent worst[CBSTATS_WORST]; /* longest first, elapsed is 0 in the free slots */
+} CallbackCounters;
+
+typedef struct {
+    CallbackCounters counters;
+    volatile unsigned int seq; /* odd while the audio thread writes the counters */
+    volatile int reset; /* asked by a reader, done by the next callback */
+    volatile unsigned long signaled; /* xruns signaled by other threads */
+    unsigned long reported; /* signaled xruns already counted */
+    CallbackEvent events[CBSTATS_EVENTS];
+    volatile unsigned long written;
+    volatile unsigned long read;
+    unsigned long dropped; /* events not logged, the ring was full */
+    FILE *log;
+    volatile int logging;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} CallbackStats;
+
+extern CallbackStats * CallbackStats_new(void);
+extern void CallbackStats_free(CallbackStats *self);
+/* Before the stream starts, `bufsize` frames at `sr`. */
+extern void CallbackStats_setDeadline(CallbackStats *self, int bufsize, double sr);
+
+/* From the audio thread, at the start of the callback. */
+extern unsigned long long CallbackStats_begin(CallbackStats *self);
+/* From the audio thread, at the end of the callback started at `start`.
+ * `flags` are the underflows and overflows reported by the backend. */
+extern void CallbackStats_end(CallbackStats *self, unsigned long long start, int flags, double time);
+/* From any thread, an xrun reported by the backend. */
+extern void CallbackStats_xrun(CallbackStats *self);
+
+/* Copies consistent counters in `out`. */
+extern void CallbackStats_read(CallbackStats *self, CallbackCounters *out);
+extern void CallbackStats_reset(CallbackStats *self);
+
+/* Writes the events to `path`, or to stderr if NULL, from a log thread.
+ * Returns -1 if the file can't be opened or the thread started. */
+extern int CallbackStats_startLog(CallbackStats *self, const char *path);
+extern void CallbackStats_stopLog(CallbackStats *self);
+
+#endif
@@ -0,0 +1,50 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _CAPTURERING_
+#define _CAPTURERING_
+
+#include "pyomodule.h"
+
+/* Recent samples of a stream, for the display objects.
+ *
+ * The audio thread only copies its blocks in a ring and publishes the count
+ * of samples written. Readers take a snapshot of the last samples whenever
+ * they need one, without lock: a snapshot overwritten while it was copied is
+ * detected and copied again. The ring must be freed or resized while the
+ * audio thread doesn't write in it.
+ */
+typedef struct {
+    int size;           /* capacity, a power of two */
+    int length;         /* longest snapshot */
+    volatile unsigned long written;
+    MYFLT *data;
+} CaptureRing;
+
+/* Snapshots of up to `length` samples, written by blocks of up to `blocksize`. */
+extern CaptureRing * CaptureRing_new(int length, int blocksize);
+extern void CaptureRing_free(CaptureRing *self);
+/* From the audio thread. */
+extern void CaptureRing_write(CaptureRing *self, MYFLT *in, int num);
+/* Copies the last `num` samples, oldest first, in `out`. Samples never written
+ * are zeros. Returns the count of samples written so far. */
+extern unsigned long CaptureRing_read(CaptureRing *self, MYFLT *out, int num);
+
+#endif
@@ -0,0 +1,55 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _DISKSTREAM_
+#define _DISKSTREAM_
+
+#include "pyomodule.h"
+#include "sndfile.h"
+
+/* Read-ahead of sound files for the players.
+ *
+ * A single I/O thread reads the frames ahead of the play head of every
+ * player in blocks of DISKSTREAM_BLOCK frames, kept in a small ring of
+ * slots indexed by block number. The audio thread tells where it reads and
+ * where the reading will jump next (loop point, next marker), in either
+ * direction, then copies the blocks without lock. A block not yet read is
+ * read from the player's own file handle, as before, so the output doesn't
+ * depend on the I/O thread being in time.
+ */
+#define DISKSTREAM_BLOCK 4096
+#define DISKSTREAM_SLOTS 16
+#define DISKSTREAM_AHEAD 12
+
+typedef struct DiskStream DiskStream;
+
+/* `sf` is the player's handle, used on misses. The I/O thread opens `path`
+ * again for itself. Returns NULL if `sf` is NULL. */
+extern DiskStream * DiskStream_new(const char *path, SNDFILE *sf, SF_INFO *info);
+extern void DiskStream_free(DiskStream *self);
+
+/* From the audio thread. Copies `items` interleaved samples starting at
+ * frame `pos`, frames outside of the file are zeros. */
+extern void DiskStream_read(DiskStream *self, long pos, MYFLT *buf, long items);
+/* The play head is at `pos` and moves forward (dir > 0) or backward until
+ * `end`, then reading goes on from `next` (-1 when it stops). */
+extern void DiskStream_hint(DiskStream *self, long pos, int dir, long end, long next);
+
+#endif
@@ -0,0 +1,58 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _DISKWRITER_
+#define _DISKWRITER_
+
+#include "pyomodule.h"
+#include "sndfile.h"
+
+/* Asynchronous writing of sound files.
+ *
+ * The audio thread copies its frames in a lock-free ring and returns at
+ * once. A single writer thread drains the rings of every open writer to
+ * their files. When a ring is full, the block is dropped and counted, the audio
+ * thread never waits for the disk.
+ */
+typedef struct DiskWriter DiskWriter;
+
+/* Takes ownership of `sf`. The ring holds at least `frames` frames. Returns
+ * NULL if the writer thread can't be started. */
+extern DiskWriter * DiskWriter_new(SNDFILE *sf, int chnls, long frames);
+/* Writes the frames left in the ring, closes the file and frees the writer. */
+extern void DiskWriter_close(DiskWriter *self);
+
+/* A blocking writer waits for room in the ring instead of dropping frames,
+ * for offline rendering where the disk sets the pace. */
+extern void DiskWriter_setBlocking(DiskWriter *self, int blocking);
+/* `fd` is the file descriptor of the file. The written data is periodically
+ * committed to the disk and dropped from the page cache. */
+extern void DiskWriter_setSync(DiskWriter *self, int fd);
+
+/* From the audio thread. `buf` holds `frames` interleaved frames. Return
+ * the number of frames dropped. */
+extern long DiskWriter_write(DiskWriter *self, MYFLT *buf, long frames);
+extern long DiskWriter_writeFloat(DiskWriter *self, float *buf, long frames);
+
+/* Number of blocks dropped and total of frames dropped. */
+extern unsigned long DiskWriter_getOverflows(DiskWriter *self);
+extern unsigned long DiskWriter_getDropped(DiskWriter *self);
+
+#endif
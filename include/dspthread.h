@@ -0,0 +1,117 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_DSPTHREAD_H
+#define Py_DSPTHREAD_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <Python.h>
+
+/* DSP lock.
+ *
+ * When a server computes its streams without the GIL, the audio thread holds
+ * the DSP lock for the duration of a buffer. Once DspLock_install has been
+ * called, python threads take it on every entry into a pyo object (creation,
+ * destruction, method calls, attributes and arithmetic), so the processing
+ * graph is never modified while a buffer is computed.
+ *
+ * Each interpreter has its own lock: servers embedded in different
+ * sub-interpreters compute their buffers concurrently, a python thread only
+ * waits for the server of its own interpreter.
+ */
+typedef struct DspLock DspLock;
+
+extern void DspLock_install(PyObject *module, PyTypeObject *skip);
+/* Lock of the current interpreter, created the first time. With the GIL held. */
+extern DspLock * DspLock_get(void);
+/* Lets a method run without the lock. It must only read data the audio
+ * thread publishes without lock (see capturering.h). With the GIL held. */
+extern void DspLock_exempt(PyCFunction func);
+/* From a thread holding the GIL. The GIL is released while waiting for the lock. */
+extern void DspLock_enter(void);
+extern void DspLock_leave(void);
+/* From the audio thread, which doesn't hold the GIL. */
+extern void DspLock_lock(DspLock *lock);
+extern void DspLock_unlock(DspLock *lock);
+
+/* Takes the GIL from a thread without python state. PyGILState always
+ * attaches the thread to the main interpreter, so a thread working for a
+ * sub-interpreter gets a state of that interpreter instead, created on its
+ * first use. A PyoThreadState must only be used by one thread at a time. */
+typedef struct {
+    PyInterpreterState *interp; /* NULL for the main interpreter (PyGILState) */
+    PyThreadState *tstate;
+    PyGILState_STATE gstate;
+} PyoThreadState;
+
+/* Records the current interpreter. With the GIL held. */
+extern void PyoThreadState_init(PyoThreadState *self);
+extern void PyoThreadState_acquire(PyoThreadState *self);
+extern void PyoThreadState_release(PyoThreadState *self);
+/* Deletes the thread state, with the GIL held, from any other thread. */
+extern void PyoThreadState_clear(PyoThreadState *self);
+
+/* Interpreter calls deferred by the audio thread. They are executed,
+ * in the order they were posted, by a dispatcher thread holding the GIL. */
+typedef void (*PyoCallbackFunc)(PyObject *obj, double value);
+typedef struct CallbackQueue CallbackQueue;
+
+/* Creates the queue and starts its dispatcher thread. Must be called with the GIL held. */
+extern CallbackQueue * CallbackQueue_new(int size);
+/* Stops the dispatcher thread, pending calls are dropped. Must be called with the GIL held. */
+extern void CallbackQueue_free(CallbackQueue *self);
+/* Posts a call to `func(obj, value)`. Never blocks for long, safe from the audio thread. */
+extern void CallbackQueue_post(CallbackQueue *self, PyObject *obj, PyoCallbackFunc func, double value);
+/* Wakes up the dispatcher thread if calls are pending (called once per buffer). */
+extern void CallbackQueue_flush(CallbackQueue *self);
+
+/* Helper thread running a job posted by the audio thread, one at a time. Used
+ * to move heavy, periodic computations off the audio thread, the result being
+ * collected by the audio thread at a later block. */
+typedef void (*PyoJobFunc)(void *data);
+typedef struct HelperThread HelperThread;
+
+/* Starts the thread, which will run `func(data)` for each job. Returns NULL on failure. */
+extern HelperThread * HelperThread_new(PyoJobFunc func, void *data);
+/* Waits for the pending job, if any, and stops the thread. */
+extern void HelperThread_free(HelperThread *self);
+/* Starts a job. The previous one must be over (see HelperThread_wait). */
+extern void HelperThread_post(HelperThread *self);
+/* Waits until the last posted job is done. Returns immediately if no job is pending. */
+extern void HelperThread_wait(HelperThread *self);
+
+/* Denormal mode of the calling thread. When `flush` is true, denormal
+ * inputs and results are flushed to zero by the FPU (FTZ and DAZ on x86, FZ
+ * on arm64), so decaying feedback loops never hit the slow path. No-op on
+ * other architectures. Returns the previous state, for DenormalMode_restore. */
+extern unsigned int DenormalMode_set(int flush);
+extern void DenormalMode_restore(unsigned int state);
+/* Mode applied by the threads owned by pyo (worker and helper threads),
+ * set by the server. */
+extern void DenormalMode_setDefault(int flush);
+extern int DenormalMode_getDefault(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_DSPTHREAD_H) */
@@ -26,8 +26,14 @@ typedef struct {
     PyObject *input;
     Stream *input_stream;
     int modebuffer[2]; // need at least 2 slots for mul & add
+    int registered; /* added to the server once something reads the stream */
+    int fused; /* the input is a Dummy computed in this one's chain */
+    int depth; /* number of Dummies in the chain */
 } Dummy;
 
+/* Longest chain of Dummies computed in a single buffer. */
+#define DUMMY_MAX_FUSED 32
+
 extern PyObject * Dummy_initialize(Dummy *self);
 
 #define MAKE_NEW_DUMMY(self, type, rt_error)	\
@@ -0,0 +1,84 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _EVENTFILE_
+#define _EVENTFILE_
+
+#include <stdint.h>
+#include "pyomodule.h"
+
+/* Timestamped event files, the automation recorded by ControlRec and
+ * NoteinRec.
+ *
+ * A 64 bytes header followed by the events, in increasing time. An event
+ * holds its time in samples as a 64 bits integer, then its `nfields` values
+ * as 32 bits floats, padded to a multiple of 8 bytes. Native byte order:
+ *
+ *   "PYEV"  version  nfields  stride (bytes per event)  sr (double)
+ *   numEvents (64 bits)  zeros up to 64 bytes
+ *
+ * Files are written by a background thread, the audio thread only copies the
+ * events in a ring. They are mapped read-only for playback, a position is
+ * found with a binary search on the times.
+ */
+#define EVENTFILE_HEADER_SIZE 64
+#define EVENTFILE_VERSION 1
+#define EVENTFILE_MAX_FIELDS 8
+
+typedef struct {
+    int nfields;
+    long stride;
+    double sr;
+    long numEvents;
+    unsigned char *data; /* first event */
+    void *map;           /* whole file */
+    size_t maplength;
+    int mapped;          /* 0 when the file was read in memory */
+} EventFile;
+
+typedef struct EventWriter EventWriter;
+
+/* Returns NULL if the file can't be opened or isn't an event file. */
+extern EventFile * EventFile_open(const char *path);
+extern void EventFile_close(EventFile *self);
+/* Index of the first event at or after `time` (samples of the file), or
+ * numEvents if there is none. */
+extern long EventFile_search(EventFile *self, int64_t time);
+
+static inline int64_t EventFile_getTime(EventFile *self, long event) {
+    return *(int64_t *)(self->data + event * self->stride);
+}
+static inline float EventFile_getField(EventFile *self, long event, int field) {
+    return ((float *)(self->data + event * self->stride + sizeof(int64_t)))[field];
+}
+
+/* Creates the file, `events` is the capacity of the ring. Returns NULL if the
+ * file or the writer thread can't be created. */
+extern EventWriter * EventWriter_new(const char *path, int nfields, double sr, long events);
+/* From the audio thread. Returns -1 if the ring is full, the event is dropped
+ * and counted. */
+extern int EventWriter_write(EventWriter *self, long time, MYFLT *fields);
+/* Writes the pending events and completes the header, returns -1 if anything
+ * failed to be written. */
+extern int EventWriter_close(EventWriter *self);
+extern unsigned long EventWriter_getDropped(EventWriter *self);
+extern long EventWriter_getMemory(EventWriter *self);
+
+#endif
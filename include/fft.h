@@ -32,4 +32,14 @@ void irealfft_packed(MYFLT *data, MYFLT *outdata, int size, MYFLT *twiddle);
 /* Prototype for array generation of twiddle factors */
 void fft_compute_split_twiddle(MYFLT **twiddle, int size);
 void fft_compute_radix2_twiddle(MYFLT *twiddle, int size);
+
+/* Process-wide cache of the tables above, shared by all objects using the
+ * same fft size (and window type). Tables are reference counted and must not
+ * be modified. Released tables stay cached for a while, so that changing the
+ * size of an object back and forth does not compute them again.
+ * Safe to call from any thread. fft_release_table accepts NULL. */
+MYFLT ** fft_acquire_split_twiddle(int size);
+MYFLT * fft_acquire_radix2_twiddle(int size);
+const MYFLT * fft_acquire_window(int size, int wintype);
+void fft_release_table(const void *table);
 #endif
@@ -27,4 +27,15 @@ MYFLT linear(MYFLT *buf, int index, MYFLT frac, int size);
 MYFLT cosine(MYFLT *buf, int index, MYFLT frac, int size);
 MYFLT cubic(MYFLT *buf, int index, MYFLT frac, int size);
 
+/* Interpolation of table samples stored in any format (see tablemodule.h). */
+typedef MYFLT (*TableInterpFunc)(void *buf, int index, MYFLT frac, int size);
+/* `interp`: 1 = nointerp, 2 = linear, 3 = cosine, 4 = cubic. */
+TableInterpFunc TableInterp_get(int interp, int format);
+
+/* Block interpolation, out[i] is the table read at index[i] + frac[i]. Use
+ * it for a whole buffer instead of calling a TableInterpFunc per sample,
+ * the kernels are inlined and vectorized. */
+typedef void (*TableInterpBlockFunc)(void *buf, int *index, MYFLT *frac, MYFLT *out, int num, int size);
+TableInterpBlockFunc TableInterp_getBlock(int interp, int format);
+
 #endif
@@ -23,11 +23,15 @@
 
 #ifdef __MATRIX_MODULE
 
+/* The points of a matrix are stored in one aligned block of (height + 1)
+ * rows of `stride` samples, the point (x, y) is data[y * stride + x]. The
+ * extra row and column are read by the bilinear interpolation. */
 typedef struct {
     PyObject_HEAD
     int width;
     int height;
-    MYFLT **data;
+    int stride;
+    MYFLT *data;
 } MatrixStream;
 
 
@@ -35,7 +39,7 @@ typedef struct {
 (self) = (MatrixStream *)(type)->tp_alloc((type), 0);	\
 if ((self) == rt_error) { return rt_error; }	\
 \
-(self)->width = (self)->height = 0
+(self)->width = (self)->height = (self)->stride = 0
 
 #else
 
@@ -43,6 +47,8 @@ int MatrixStream_getWidth(PyObject *self);
 int MatrixStream_getHeight(PyObject *self);
 MYFLT MatrixStream_getPointFromPos(PyObject *self, long x, long y);
 MYFLT MatrixStream_getInterpPointFromPos(PyObject *self, MYFLT x, MYFLT y);
+/* Block version, out[i] is the matrix read at x[i], y[i]. */
+void MatrixStream_getInterpPointsFromPos(PyObject *self, MYFLT *x, MYFLT *y, MYFLT *out, int num);
 extern PyTypeObject MatrixStreamType;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _MIDIRING_
+#define _MIDIRING_
+
+#include <pthread.h>
+#include "portmidi.h"
+
+/* MIDI input events on their way from the MIDI thread to the audio thread.
+ *
+ * The MIDI thread polls the input devices every millisecond and stamps each
+ * event with the monotonic clock (Stream_clock) when it is read. The ring
+ * has one producer and one consumer and no lock: the producer publishes the
+ * count of events written, the consumer the count of events read. When the
+ * ring is full, the new events are dropped and counted.
+ */
+typedef struct {
+    PmMessage message;
+    unsigned long long time; /* arrival, in nanoseconds */
+} MidiRingEvent;
+
+typedef struct {
+    int size; /* capacity, a power of two */
+    volatile unsigned long written;
+    volatile unsigned long read;
+    volatile unsigned long dropped;
+    MidiRingEvent *events;
+    PmStream **inputs;
+    int numinputs;
+    int running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} MidiRing;
+
+/* A ring of at least `size` events. */
+extern MidiRing * MidiRing_new(int size);
+/* Stops the thread first. */
+extern void MidiRing_free(MidiRing *self);
+/* From the producer. Returns -1 when the ring is full. */
+extern int MidiRing_push(MidiRing *self, PmMessage message, unsigned long long time);
+/* From the consumer. Moves up to `num` events, oldest first, in `out` and
+ * returns their count. */
+extern int MidiRing_pop(MidiRing *self, MidiRingEvent *out, int num);
+/* Starts the thread reading the `num` opened `inputs`, which must stay open
+ * until MidiRing_stop returns. Returns -1 if the thread can't be created. */
+extern int MidiRing_start(MidiRing *self, PmStream **inputs, int num);
+extern void MidiRing_stop(MidiRing *self);
+
+#endif
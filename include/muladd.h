@@ -0,0 +1,78 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _MULADD_
+#define _MULADD_
+
+/* Vectorized kernels of the mul/add post-processing macros (see pyomodule.h).
+ *
+ * SSE, SSE2 (double), AVX and aarch64 NEON are used when the compiler targets
+ * them, with a scalar tail. Results are identical to the scalar loops: the
+ * kernels only use separate multiplies, adds and divides, never fused ones.
+ *
+ * The suffixes follow the muladd modes: i is a scalar, a an audio stream,
+ * rev a stream used as a divisor (mul) or subtracted (add).
+ */
+void pyo_muladd_ii(MYFLT *data, MYFLT mul, MYFLT add, int size);
+void pyo_muladd_ai(MYFLT *data, MYFLT *mul, MYFLT add, int size);
+void pyo_muladd_ia(MYFLT *data, MYFLT mul, MYFLT *add, int size);
+void pyo_muladd_aa(MYFLT *data, MYFLT *mul, MYFLT *add, int size);
+void pyo_muladd_revai(MYFLT *data, MYFLT *mul, MYFLT add, int size);
+void pyo_muladd_revaa(MYFLT *data, MYFLT *mul, MYFLT *add, int size);
+void pyo_muladd_ireva(MYFLT *data, MYFLT mul, MYFLT *add, int size);
+void pyo_muladd_areva(MYFLT *data, MYFLT *mul, MYFLT *add, int size);
+void pyo_muladd_revareva(MYFLT *data, MYFLT *mul, MYFLT *add, int size);
+
+/* Post-processing of generators applying scalar mul and add in their main
+ * loop. Setting muladd_func_ptr to this function in muladd mode 0 enables the
+ * FUSED_MULADD_INIT and FUSED_MULADD(x) macros of pyomodule.h. */
+void pyo_postprocessing_fused(void *self);
+
+/* Mixing and device buffer kernels of the server.
+ * pyo_accumulate adds `in` (times `gain` for pyo_accumulate_gain) to `out`.
+ * pyo_gain_to_float writes one planar channel: out[i] = (float)in[i] * gain[i].
+ * pyo_interleave_gain does the same for `nchnls` planar channels, `stride`
+ * samples apart in `in`, into an interleaved buffer. */
+void pyo_accumulate(MYFLT *out, MYFLT *in, int size);
+void pyo_accumulate_gain(MYFLT *out, MYFLT *in, MYFLT gain, int size);
+void pyo_gain_to_float(float *out, MYFLT *in, MYFLT *gain, int size);
+void pyo_interleave_gain(float *out, MYFLT *in, int stride, MYFLT *gain, int nchnls, int size);
+/* pyo_deinterleave splits the interleaved `in` into `nchnls` planar
+ * channels, `stride` samples apart in `out`. */
+void pyo_deinterleave(MYFLT *out, int stride, MYFLT *in, int nchnls, int size);
+/* pyo_peak_power gives the largest square of in[i] * gain[i] in `peak` and
+ * the sum of the squares in `sum`, for the meters. */
+void pyo_peak_power(MYFLT *in, MYFLT *gain, int size, MYFLT *peak, MYFLT *sum);
+
+/* Buffer of a control-rate stream: a linear ramp from `from`, the last value
+ * of the previous buffer, to `to`, written exactly in the last sample. */
+void pyo_fill_ramp(MYFLT *data, MYFLT from, MYFLT to, int size);
+
+/* Buffer of a constant stream, every sample is `value`. */
+void pyo_fill(MYFLT *data, MYFLT value, int size);
+
+/* Buffers aligned on PYO_ALIGNMENT bytes, zeroed. PYO_ALIGN_FRAMES rounds a
+ * number of samples so that consecutive channels stay aligned. */
+#define PYO_ALIGNMENT 64
+#define PYO_ALIGN_FRAMES(n) (((n) + PYO_ALIGNMENT / sizeof(MYFLT) - 1) & ~(PYO_ALIGNMENT / sizeof(MYFLT) - 1))
+void * pyo_aligned_calloc(size_t size);
+void pyo_aligned_free(void *ptr);
+
+#endif
@@ -0,0 +1,78 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _OSCARRAY_
+#define _OSCARRAY_
+
+#include "pyomodule.h"
+
+/* Bank of oscillators rendered together, for the additive synthesis objects.
+ *
+ * The state of the oscillators is stored as one array per parameter, so that
+ * the inner loops process OSCARRAY_LANES oscillators side by side and are
+ * vectorized by the compiler whatever the vector width of the target (4, 8 or
+ * 16 oscillators per instruction). Per oscillator, the amplitude and the phase
+ * increment can ramp linearly in the course of a call.
+ *
+ * Two modes are available:
+ *  - table: linear interpolation in a table whose period is `size` samples
+ *    (the table must hold `size + 1` samples). Only the reads of the table
+ *    are scalar.
+ *  - quadrature: each oscillator is a phasor rotated every sample, which
+ *    outputs a pure sine without any table read. The rotations are updated
+ *    recursively to follow the frequency ramps and their sine and cosine are
+ *    only computed when an increment changes.
+ */
+#define OSCARRAY_LANES 16
+
+typedef struct {
+    int num;            /* number of oscillators */
+    int capacity;       /* allocated oscillators, a multiple of OSCARRAY_LANES */
+    int quadrature;
+    MYFLT *pos;         /* phase, in table samples */
+    MYFLT *inc;         /* phase increment per sample, in table samples */
+    MYFLT *dinc;        /* increment added to `inc` every sample */
+    MYFLT *amp;
+    MYFLT *damp;        /* increment added to `amp` every sample */
+    MYFLT *re;          /* phasor of the quadrature mode */
+    MYFLT *im;
+    MYFLT *rc;          /* rotation per sample of the phasor */
+    MYFLT *rs;
+    MYFLT *rinc;        /* increment the rotation has been computed from */
+    MYFLT *block;
+} OscArray;
+
+/* Allocates `num` oscillators with null phases, increments and amplitudes. */
+extern OscArray * OscArray_new(int num);
+extern void OscArray_free(OscArray *self);
+/* Changes the number of oscillators, the state of the others is kept. */
+extern void OscArray_resize(OscArray *self, int num);
+/* Bytes allocated for the oscillators. */
+extern size_t OscArray_getMemory(OscArray *self);
+/* Resets all phases to 0. */
+extern void OscArray_resetPhases(OscArray *self);
+/* Switches between the table and the quadrature modes, converting the phases. */
+extern void OscArray_setQuadrature(OscArray *self, int quadrature, int size);
+/* Adds `count` samples of the first `num` oscillators to `out`. `table` is
+ * not read in quadrature mode. `inc` and `amp` are left at their value for
+ * the next sample, `dinc` and `damp` are not modified. */
+extern void OscArray_process(OscArray *self, MYFLT *out, int count, int num, MYFLT *table, int size);
+
+#endif
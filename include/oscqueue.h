@@ -0,0 +1,91 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _OSCQUEUE_
+#define _OSCQUEUE_
+
+#include <pthread.h>
+#include "lo/lo.h"
+
+#define OSC_QUEUE_PATH 128
+#define OSC_QUEUE_ARGS 32
+#define OSC_QUEUE_TEXT 256
+
+/* Messages received on an OSC port on their way from the network thread to
+ * the audio thread.
+ *
+ * The network thread waits on the socket in liblo and copies each message,
+ * with the time at which it is due, in a ring with one producer and one
+ * consumer and no lock. The consumer looks at the queued messages in place
+ * and releases them when it doesn't need them anymore. When the ring is
+ * full, the network thread waits for the audio thread.
+ */
+typedef union {
+    long long h; /* 'i' and 'h' */
+    double d; /* 'f' and 'd' */
+    int s; /* 's' and 'S', offset of the string in `text` */
+} OscQueueValue;
+
+typedef struct {
+    char path[OSC_QUEUE_PATH];
+    char types[OSC_QUEUE_ARGS+1]; /* the arguments after one that doesn't fit are dropped */
+    int argc;
+    OscQueueValue values[OSC_QUEUE_ARGS];
+    char text[OSC_QUEUE_TEXT];
+    int textlen; /* bytes used in `text` */
+    unsigned long long time; /* due time, Stream_clock nanoseconds */
+} OscQueueEvent;
+
+typedef struct {
+    lo_server osc_server;
+    int port;
+    int size; /* capacity, a power of two */
+    volatile unsigned long written;
+    volatile unsigned long read;
+    volatile unsigned long dropped; /* messages received while stopping */
+    OscQueueEvent *events;
+    volatile int running;
+    pthread_t thread;
+} OscQueue;
+
+/* Opens an OSC server on `port` with a queue of at least `size` messages
+ * and starts its thread. Returns NULL if the port can't be opened. */
+extern OscQueue * OscQueue_new(int port, int size);
+/* Stops the thread and closes the port. */
+extern void OscQueue_free(OscQueue *self);
+/* From the consumer. Count of queued messages, oldest first. */
+extern int OscQueue_count(OscQueue *self);
+/* Message `i` in [0, OscQueue_count). */
+extern OscQueueEvent * OscQueue_get(OscQueue *self, int i);
+/* Gives the `num` oldest messages back to the producer. */
+extern void OscQueue_release(OscQueue *self, int num);
+/* Builds a message with no argument in `ev`, the path is truncated to
+ * OSC_QUEUE_PATH - 1 characters. */
+extern void OscQueue_setPath(OscQueueEvent *ev, const char *path);
+/* Append an argument of `type`, they return -1 when it doesn't fit. */
+extern int OscQueue_addInt(OscQueueEvent *ev, char type, long long value);
+extern int OscQueue_addDouble(OscQueueEvent *ev, char type, double value);
+extern int OscQueue_addString(OscQueueEvent *ev, char type, const char *value);
+/* Argument `i` as a number, 0 if it isn't one. */
+extern double OscQueue_number(OscQueueEvent *ev, int i);
+/* Whether argument `i` is a number. */
+extern int OscQueue_isNumber(OscQueueEvent *ev, int i);
+
+#endif
@@ -0,0 +1,88 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _OSCSENDER_
+#define _OSCSENDER_
+
+#include <pthread.h>
+#include "lo/lo.h"
+#include "oscqueue.h"
+
+#define OSC_SENDER_DESTINATIONS 256
+/* Messages of a destination held while it waits for its rate limit. */
+#define OSC_SENDER_PENDING 256
+/* Messages sent in a bundle at once. */
+#define OSC_SENDER_BUNDLE 64
+
+/* OSC messages of the audio thread on their way to the network.
+ *
+ * The objects build their messages in place in a ring with one producer,
+ * the audio thread, and one consumer, the network thread. The server
+ * publishes the messages at the end of every host buffer. The network thread
+ * sends the published messages of a destination in bundles. With a rate
+ * limit, a destination gets at most `rate` bundles per second, and only the
+ * latest message of each path is kept meanwhile.
+ */
+typedef struct {
+    lo_address address;
+    char *host;
+    int port;
+    OscQueueEvent *pending; /* latest message of each path, with a rate limit */
+    int numpending;
+    unsigned long long next; /* earliest time of its next bundle */
+} OscSenderDestination;
+
+typedef struct {
+    int size; /* capacity, a power of two */
+    unsigned long written; /* messages built by the producer */
+    volatile unsigned long published; /* messages of the finished host buffers */
+    volatile unsigned long read;
+    volatile unsigned long dropped;
+    unsigned long reported; /* drops already reported, on the network thread */
+    OscQueueEvent *events;
+    int *targets; /* destination of each message */
+    OscQueueEvent **scratch; /* messages of a destination, on the network thread */
+    OscSenderDestination *destinations;
+    volatile int numdestinations;
+    volatile double rate; /* bundles per second and destination, 0 for no limit */
+    int running;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} OscSender;
+
+/* A ring of at least `size` messages and its running thread, NULL if the
+ * thread can't be created. */
+extern OscSender * OscSender_new(int size);
+/* Sends the published messages and stops the thread. */
+extern void OscSender_free(OscSender *self);
+/* Index of the destination `host`:`port`, opened the first time, or -1 when
+ * there are too many destinations. From the python thread. */
+extern int OscSender_getDestination(OscSender *self, const char *host, int port);
+extern void OscSender_setRate(OscSender *self, double rate);
+/* From the producer. The next message to build, with OscQueue_setPath and
+ * the OscQueue_add functions, for `destination`, or NULL when the ring is
+ * full. OscSender_commit keeps it. */
+extern OscQueueEvent * OscSender_reserve(OscSender *self, int destination);
+extern void OscSender_commit(OscSender *self);
+/* From the producer. The messages committed can be sent. */
+extern void OscSender_publish(OscSender *self);
+
+#endif
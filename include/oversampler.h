@@ -0,0 +1,92 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+
+#ifndef _OVERSAMPLER_
+#define _OVERSAMPLER_
+
+#include "pyomodule.h"
+
+/* Oversampling by 2, 4 or 8 around a nonlinear process.
+ *
+ * Each factor of 2 is a stage of half-band FIR filters, applied in
+ * polyphase form: half of the taps of a half-band filter are zeros and the
+ * center one is 1/2, so an upsampled block copies the input on its even
+ * samples and computes only its odd samples, and a downsampled block is
+ * computed from its odd-branch taps and the center sample. The taps are
+ * symmetric, the samples sharing a coefficient are summed before the
+ * multiplication. The loops run over the outputs for each tap, so that they
+ * are vectorized (see simd.h).
+ *
+ * The first stage, next to the base rate, has the sharpest filter (80 dB of
+ * stopband attenuation above 0.58 of the Nyquist frequency), the following
+ * ones only remove the images far from the signal and are shorter. The
+ * filters are linear phase, a round trip delays the signal by about 32
+ * samples at 2x and 39 samples at 8x.
+ */
+#define OVERSAMPLER_MAX_STAGES 3
+#define OVERSAMPLER_MAX_FACTOR 8
+/* Buffers holding an audio rate parameter at the oversampled rate. */
+#define OVERSAMPLER_PARAMS 2
+
+typedef struct {
+    int taps; /* odd-branch coefficients on each side of the center */
+    MYFLT *coeffs; /* taps, symmetric half of the odd branch */
+    MYFLT *up; /* 2 * taps - 1 samples of history, then the input */
+    MYFLT *even; /* 2 * taps - 1 samples of history, then the even samples */
+    MYFLT *odd; /* taps samples of history, then the odd samples */
+    MYFLT *tmp; /* odd samples of an upsampled block */
+} OversamplerStage;
+
+typedef struct {
+    int factor;
+    int stages;
+    int bufsize;
+    OversamplerStage stage[OVERSAMPLER_MAX_STAGES];
+    MYFLT *work[2]; /* bufsize * factor samples each */
+    MYFLT *hold[OVERSAMPLER_PARAMS];
+} Oversampler;
+
+/* `factor` is rounded down to 1, 2, 4 or 8. Returns NULL for 1, there is
+ * nothing to do. `bufsize` is the largest block processed. */
+extern Oversampler * Oversampler_new(int factor, int bufsize);
+extern void Oversampler_free(Oversampler *self);
+/* Clears the filter memories. */
+extern void Oversampler_reset(Oversampler *self);
+/* Rounds a requested factor to the supported ones. */
+extern int Oversampler_getFactor(int factor);
+/* Delay of a round trip, in samples at the base rate. */
+extern double Oversampler_getLatency(Oversampler *self);
+/* Heap memory of the oversampler, in bytes. */
+extern long Oversampler_getMemory(Oversampler *self);
+
+/* Upsamples `num` samples of `in`. Returns a buffer of num * factor
+ * samples, owned by the oversampler, which may be processed in place until
+ * the next call to Oversampler_up. */
+extern MYFLT * Oversampler_up(Oversampler *self, MYFLT *in, int num);
+/* Downsamples the num * factor samples returned by Oversampler_up into
+ * `num` samples of `out`. */
+extern void Oversampler_down(Oversampler *self, MYFLT *out, int num);
+/* Parameter buffer `slot` holding each of the `num` samples of `in`, or
+ * `value`, factor times. */
+extern MYFLT * Oversampler_hold(Oversampler *self, int slot, MYFLT *in, int num);
+extern MYFLT * Oversampler_fill(Oversampler *self, int slot, MYFLT value, int num);
+
+#endif
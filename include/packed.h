@@ -0,0 +1,109 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _PACKED_
+#define _PACKED_
+
+#include "pyomodule.h"
+
+/* Kernels processing many channels of the same filter or delay at once.
+ *
+ * The channels are split in groups of VSIZE (see simd.h), each channel of a
+ * group runs in one lane of the vectors. A group is interleaved in a small
+ * scratch buffer, processed one frame at a time and deinterleaved in the
+ * output buffers. The recursive filters are bound by their feedback
+ * latency, so the lanes come almost for free. Without SIMD, the channels
+ * are processed one after the other.
+ *
+ * `in` and `out` hold one pointer per channel, `out` may be `in`.
+ */
+
+/* Reads a list of floats or PyoObjects, wrapped around `chnls`. `list`
+ * receives a new list of their streams, None for a float. For a float,
+ * `values` gets the value and `streams` NULL. If `values` is NULL, the list
+ * must hold PyoObjects only. Returns -1 with an exception set on error.
+ * Needs streammodule.h, included before this header. */
+extern int Packed_setValues(PyObject *arg, int chnls, PyObject **list, MYFLT *values, Stream **streams);
+
+/* Biquads with per channel coefficients, normalized by a0. */
+typedef struct {
+    int chnls;
+    int pchnls; /* chnls rounded up to a multiple of VSIZE */
+    MYFLT *coeffs; /* b0, b1, b2, a1, a2, pchnls values each */
+    MYFLT *incs; /* per sample increments of the coefficients */
+    MYFLT *state; /* x1, x2, y1, y2, pchnls values each */
+} PackedBiquad;
+
+extern PackedBiquad * PackedBiquad_new(int chnls);
+extern void PackedBiquad_free(PackedBiquad *self);
+/* Sets the coefficients of channel `chnl`, reached after `num` samples (0
+ * sets them at once). */
+extern void PackedBiquad_setCoeffs(PackedBiquad *self, int chnl, MYFLT b0, MYFLT b1, MYFLT b2,
+                                   MYFLT a0, MYFLT a1, MYFLT a2, int num);
+/* Sets the memories of every channel to its first input sample. */
+extern void PackedBiquad_prime(PackedBiquad *self, MYFLT **in);
+extern void PackedBiquad_process(PackedBiquad *self, MYFLT **in, MYFLT **out, int num);
+
+/* Delay lines with feedback. The channels of a group share a ring, one
+ * frame of it holds a sample of each. Delays are in samples, between 1 and
+ * `size`, and can change at every sample. When all the channels share a
+ * constant delay, the frames are read and written with vectors. */
+typedef struct {
+    int chnls;
+    int pchnls;
+    long size;
+    long mask; /* frames per group - 1, a power of two above `size` */
+    long in_count;
+    MYFLT *ring;
+    MYFLT *scratch; /* interleaved frames of a group, then its feedbacks */
+} PackedDelay;
+
+extern PackedDelay * PackedDelay_new(int chnls, long size);
+extern void PackedDelay_free(PackedDelay *self);
+extern void PackedDelay_reset(PackedDelay *self);
+/* `delay` and `feed` hold one pointer per channel, to `num` values, or
+ * NULL for the constant in `cdelay` and `cfeed`. */
+extern void PackedDelay_process(PackedDelay *self, MYFLT **in, MYFLT **out, MYFLT **delay, MYFLT *cdelay,
+                                MYFLT **feed, MYFLT *cfeed, int num);
+
+/* Lowpass feedback combs, as in Freeverb, fed by the same input and summed
+ * in one output. All the combs write the same frame of a ring of `size`
+ * frames, the longest length, and each one reads its own, `lengths[c]`
+ * samples behind. The frames are read and written with vectors. */
+typedef struct {
+    int chnls;
+    int pchnls;
+    long size;
+    long in_count;
+    long *lengths;
+    long minlength;
+    MYFLT *ring; /* size frames of pchnls samples */
+    MYFLT *state; /* lowpass memories */
+    MYFLT *scratch; /* frames read by the combs */
+} PackedComb;
+
+/* `lengths` (at least 1 sample) is copied. */
+extern PackedComb * PackedComb_new(int chnls, long *lengths);
+extern void PackedComb_free(PackedComb *self);
+/* `feed` and `damp` hold `num` values, `out` receives the sum of the
+ * combs outputs, in channel order. */
+extern void PackedComb_process(PackedComb *self, MYFLT *in, MYFLT *out, MYFLT *feed, MYFLT *damp, int num);
+
+#endif
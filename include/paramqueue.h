@@ -0,0 +1,80 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_PARAMQUEUE_H
+#define Py_PARAMQUEUE_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <Python.h>
+
+/* Timestamped parameter changes.
+ *
+ * Python threads post changes in a lock-free single producer, single consumer
+ * ring (producers are serialized by the GIL). The audio thread fetches them once
+ * per buffer and applies those due in the buffer. Scalar `mul` and `add` changes
+ * land at the exact sample, by splitting the post-processing of the target's
+ * stream. Other changes call the object's setter at the start of the buffer.
+ *
+ * All reference counting is done by the producer: objects released by the
+ * audio thread go back through a second ring, emptied on every post.
+ */
+#define PARAM_MUL 0
+#define PARAM_ADD 1
+#define PARAM_CALL 2
+
+typedef struct ParamEvent {
+    PyObject *obj;      /* target audio object */
+    PyObject *method;   /* name of the setter */
+    PyObject *value;    /* new value, replaced by the old one once applied */
+    int kind;
+    int offset;         /* position in the current buffer */
+    int done;
+    unsigned long long time;
+    struct ParamEvent *next; /* next change of the same stream in the current buffer */
+} ParamEvent;
+
+typedef struct ParamQueue ParamQueue;
+
+/* Producer side, with the GIL held. */
+extern ParamQueue * ParamQueue_new(int size);
+extern void ParamQueue_free(ParamQueue *self);
+/* Returns -1 if the queue is full. New references are taken on obj, method and value. */
+extern int ParamQueue_post(ParamQueue *self, PyObject *obj, PyObject *method, PyObject *value,
+                           int kind, unsigned long long time);
+
+/* Consumer side, from the audio thread. `gil` tells if the caller holds the GIL. */
+extern void ParamQueue_begin(ParamQueue *self, unsigned long long start, int bufsize, int gil);
+extern void ParamQueue_end(ParamQueue *self, int gil);
+/* Computes a stream which has changes attached for the current buffer. */
+extern void ParamQueue_compute(PyObject *stream);
+
+#define Stream_compute(s) \
+    ((s)->timed ? (void)0 : \
+     (Stream_suspension && Stream_isSilent(s)) ? (void)0 : \
+     (s)->profile != NULL ? Stream_callProfiled(s) : \
+     (s)->params != NULL ? ParamQueue_compute((PyObject *)(s)) : Stream_callFunction(s))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_PARAMQUEUE_H) */
@@ -0,0 +1,111 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _PARTCONV_
+#define _PARTCONV_
+
+#include "pyomodule.h"
+#include "dspthread.h"
+
+/* Uniformly partitioned overlap-save convolution.
+ *
+ * The impulse response is cut in partitions of one block, each transformed
+ * once with realfft_split on a frame of two blocks. Every block, the spectrum
+ * of the last two input blocks is computed and the products with all the
+ * partition spectra, taken against the spectra of the previous blocks, are
+ * summed before a single inverse transform. The output is aligned with the
+ * input: there is no latency added to the direct form.
+ *
+ * PartConv_new returns NULL if the block size is not a power of two (16 or
+ * more) or if the impulse is too short to gain anything, so the callers keep
+ * their direct form loop as fallback.
+ */
+#define PARTCONV_MIN_LENGTH 128
+
+typedef struct {
+    int size;           /* block and partition size */
+    int size2;          /* fft size */
+    int parts;
+    int length;         /* maximum impulse length, delay included */
+    int delay;          /* samples of silence prepended to the impulse */
+    int current;        /* slot of the newest input spectrum */
+    int stride;         /* size of one spectrum, real parts then imaginary parts */
+    int impulse_len;
+    MYFLT **twiddle;
+    MYFLT *impulse;     /* last impulse given, to detect changes */
+    MYFLT *spectra;     /* partition spectra, parts * stride */
+    MYFLT *inspectra;   /* ring of input spectra, parts * stride */
+    MYFLT *inframe;     /* previous and current input blocks */
+    MYFLT *frame;
+    MYFLT *accum;
+    MYFLT *outframe;
+} PartConv;
+
+/* `length` is the maximum impulse length and `delay` an offset, in samples,
+ * applied to the impulse (1 reproduces the one sample delay of the direct
+ * form loops of the IR* objects). */
+extern PartConv * PartConv_new(int blocksize, int length, int delay);
+extern void PartConv_free(PartConv *self);
+/* Computes the partition spectra. `len` is clipped to the maximum length. */
+extern void PartConv_setImpulse(PartConv *self, MYFLT *impulse, int len);
+/* Calls PartConv_setImpulse only if the impulse differs from the last one. */
+extern void PartConv_checkImpulse(PartConv *self, MYFLT *impulse, int len);
+/* Convolves one block of `size` samples. `in` and `out` may not overlap. */
+extern void PartConv_process(PartConv *self, MYFLT *in, MYFLT *out);
+/* Bytes allocated by the engine, 0 for NULL. */
+extern size_t PartConv_getMemory(PartConv *self);
+
+/* Non-uniformly partitioned convolution, for long impulses.
+ *
+ * The head of the impulse, `2 * tailsize` samples, is convolved by a PartConv
+ * of `blocksize` on the calling thread. The rest goes to a PartConv of
+ * `tailsize` samples, whose blocks are computed by a helper thread: the block
+ * posted once `tailsize` input samples are gathered is collected at the next
+ * post, which is still `tailsize` samples before its first output is due.
+ * The output is the same as with the uniform partitioning, only the cost of
+ * the tail is divided by `tailsize / blocksize` and moved off the audio
+ * thread. Without helper thread, the tail blocks are computed in place.
+ *
+ * `tailsize` is a power of two chosen from the impulse length, the tail is
+ * left out if the impulse fits in the head.
+ */
+typedef struct {
+    int size;           /* head block size */
+    int tailsize;
+    int tailcount;      /* samples gathered in tail_in */
+    PartConv *head;
+    PartConv *tail;     /* NULL when the impulse fits in the head */
+    HelperThread *helper;
+    MYFLT *tail_in;     /* tail block being gathered */
+    MYFLT *tail_out;    /* tail block being played */
+    MYFLT *job_in;      /* buffers of the job posted to the helper */
+    MYFLT *job_out;
+} SplitConv;
+
+/* Same conditions on `blocksize` than PartConv_new, NULL is returned if they
+ * are not met. */
+extern SplitConv * SplitConv_new(int blocksize, int length);
+extern void SplitConv_free(SplitConv *self);
+extern void SplitConv_setImpulse(SplitConv *self, MYFLT *impulse, int len);
+/* Convolves one block of `size` samples. `in` and `out` may not overlap. */
+extern void SplitConv_process(SplitConv *self, MYFLT *in, MYFLT *out);
+extern size_t SplitConv_getMemory(SplitConv *self);
+
+#endif
@@ -0,0 +1,41 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _POWKERNEL_
+#define _POWKERNEL_
+
+#include "pyomodule.h"
+
+/* Powers computed as exp2(e * log2(x)), with polynomials instead of libm so
+ * that the loops are vectorized. The polynomials are as precise as MYFLT,
+ * the error grows with |e * log2(x)|, as it does when the product is
+ * rounded. The double precision build keeps libm unless AVX2 is enabled. */
+
+/* out[i] = x[i] ^ e[i] for 0 <= x[i] <= 1 and 0 < e[i] < 2^20, 0 gives 0.
+ * `e` holds `num` exponents, or is NULL for the constant `ce`. `out` may be
+ * `x`. */
+extern void PowKernel_process(MYFLT *x, MYFLT *e, MYFLT ce, MYFLT *out, int num);
+/* out[i] = ln(x[i]) for normal x[i] > 0. `out` may be `x`. */
+extern void PowKernel_log(MYFLT *x, MYFLT *out, int num);
+/* out[i] = e^x[i] for x[i] < 88, flushed to 0 below the smallest normal
+ * number. `out` may be `x`. */
+extern void PowKernel_exp(MYFLT *x, MYFLT *out, int num);
+
+#endif
@@ -0,0 +1,76 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _PVFILE_
+#define _PVFILE_
+
+#include "pyomodule.h"
+
+/* Phase vocoder analysis files.
+ *
+ * A 64 bytes header followed by the frames, in the order of analysis. A frame
+ * holds the magnitudes of the `hsize` bins, then their frequencies, as 32 bits
+ * floats in the native byte order:
+ *
+ *   "PYPV"  version  fftsize  olaps  hsize  unused  sr (double)
+ *   numFrames (64 bits)  zeros up to 64 bytes
+ *
+ * Files are written frame by frame and mapped read-only for playback, the
+ * system only pages in the frames that are actually read.
+ */
+#define PVFILE_HEADER_SIZE 64
+#define PVFILE_VERSION 1
+
+typedef struct {
+    int fftsize;
+    int olaps;
+    int hsize;
+    double sr;
+    long numFrames;
+    float *data;        /* first frame */
+    void *map;          /* whole file */
+    size_t maplength;
+    int mapped;         /* 0 when the file was read in memory */
+} PVFile;
+
+typedef struct {
+    FILE *fp;
+    int hsize;
+    long numFrames;
+    float *frame;
+} PVFileWriter;
+
+/* Returns NULL if the file can't be opened or isn't a pv analysis file. */
+extern PVFile * PVFile_open(const char *path);
+extern void PVFile_close(PVFile *self);
+
+static inline float * PVFile_getMagn(PVFile *self, long frame) {
+    return self->data + frame * 2 * self->hsize;
+}
+static inline float * PVFile_getFreq(PVFile *self, long frame) {
+    return self->data + (frame * 2 + 1) * self->hsize;
+}
+
+extern PVFileWriter * PVFileWriter_new(const char *path, int fftsize, int olaps, double sr);
+extern int PVFileWriter_write(PVFileWriter *self, MYFLT *magn, MYFLT *freq);
+/* Completes the header, returns -1 if anything failed to be written. */
+extern int PVFileWriter_close(PVFileWriter *self);
+
+#endif
@@ -21,13 +21,18 @@
 #include <Python.h>
 #include "pyomodule.h"
 
-typedef struct {
+typedef struct PVStream {
     PyObject_HEAD
     int fftsize;
     int olaps;
-    MYFLT **magn;
+    MYFLT **magn;   /* frames read by the consumers */
     MYFLT **freq;
     int *count;
+    int overcount;  /* overlap at the start of the last computed block */
+    unsigned long stamp; /* server time of that block */
+    MYFLT *frames;  /* frames owned by the stream, in one aligned block */
+    MYFLT **rows;   /* olaps magnitude rows followed by olaps frequency rows */
+    struct PVStream *shared; /* borrowed, input whose frames are published instead */
 } PVStream;
 
 extern int PVStream_getFFTsize(PVStream *self);
@@ -40,6 +45,19 @@ extern void PVStream_setOlaps(PVStream * self, int olaps);
 extern void PVStream_setMagn(PVStream * self, MYFLT **data);
 extern void PVStream_setFreq(PVStream * self, MYFLT **data);
 extern void PVStream_setCount(PVStream * self, int *data);
+/* Called by the producer before computing a block. */
+extern void PVStream_beginFrame(PVStream *self, int overcount, unsigned long stamp);
+/* Allocates the frames owned by the stream (olaps rows of fftsize/2 bins for
+ * magnitudes and frequencies), zeroed, and publishes them. */
+extern void PVStream_allocFrames(PVStream *self, int fftsize, int olaps);
+/* Bytes of the frames owned by the stream. */
+extern size_t PVStream_getMemory(PVStream *self);
+/* Publishes the frames of `input` instead of the stream's own ones if the
+ * caller is the only consumer of `input`, `input` has already computed the
+ * current block from the same overlap and the sizes match. The getters
+ * follow `input` until the next call, so the caller passes NULL before it
+ * releases `input`. Returns 1 if the frames are shared. */
+extern int PVStream_shareFrames(PVStream *self, PVStream *input);
 extern PyTypeObject PVStreamType;
 
 #define MAKE_NEW_PV_STREAM(self, type, rt_error) \
@@ -47,7 +65,21 @@ extern PyTypeObject PVStreamType;
     if ((self) == rt_error) { return rt_error; } \
  \
     (self)->fftsize = 1024; \
-    (self)->olaps = 4;
+    (self)->olaps = 4; \
+    (self)->stamp = (unsigned long)-1;
+
+/* At the start of the computing function of a PV object owning a pv_stream. */
+#define PV_BEGIN_FRAME \
+    PVStream_beginFrame(self->pv_stream, self->overcount, ((Server *)self->server)->elapsedSamples);
+
+/* For processors computing each output bin from the same input bin only:
+ * writes the output frames in place when nothing else reads the input. Called
+ * after the size checks of the process function, in place of PV_BEGIN_FRAME. */
+#define PV_PROCESS_IN_PLACE \
+    PV_BEGIN_FRAME \
+    PVStream_shareFrames(self->pv_stream, self->input_stream); \
+    self->magn = PVStream_getMagn(self->pv_stream); \
+    self->freq = PVStream_getFreq(self->pv_stream);
 
 #ifdef __PV_STREAM_MODULE
 /* include from pvstream.c */
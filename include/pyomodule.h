@@ -45,12 +45,16 @@
 #define TYPE__OF "|Of"
 #define TYPE_O_FOO "O|fOO"
 #define TYPE_O_FIOO "O|fiOO"
+#define TYPE_I_F "i|f"
 #define TYPE_I_FFOO "i|ffOO"
 #define TYPE_I_FFFOO "i|fffOO"
 #define TYPE_I_FFFIOO "i|fffiOO"
+#define TYPE_IOOO_F "iOOO|f"
 #define TYPE_O_IF "O|if"
 #define TYPE_O_IFS "O|ifs"
 #define TYPE_S_IFF "s|iff"
+#define TYPE_S_IFFS "s|iffs"
+#define TYPE_S_IFFSI "s|iffsi"
 #define TYPE_S_FIFF "s|fiff"
 #define TYPE_S_FFIFF "s|ffiff"
 #define TYPE_S__OIFI "s|Oifi"
@@ -71,6 +75,7 @@
 #define TYPE_O_FFFFII "O|ffffii"
 #define TYPE_F_O "f|O"
 #define TYPE_F_OF "f|Of"
+#define TYPE_F_OFI "f|Ofi"
 #define TYPE__OFFI "|Offi"
 #define TYPE__OFII "|Ofii"
 #define TYPE__FIIOO "|fiiOO"
@@ -87,6 +92,7 @@
 #define TYPE_O_OOFFOO "O|OOffOO"
 #define TYPE_O_OOOFOO "O|OOOfOO"
 #define TYPE_OO_OOOIFOO "OO|OOOifOO"
+#define TYPE_O_IFFFFFF "O|iffffff"
 
 #define SF_WRITE sf_write_float
 #define SF_READ sf_read_float
@@ -129,12 +135,16 @@
 #define TYPE__OF "|Od"
 #define TYPE_O_FOO "O|dOO"
 #define TYPE_O_FIOO "O|diOO"
+#define TYPE_I_F "i|d"
 #define TYPE_I_FFOO "i|ddOO"
 #define TYPE_I_FFFOO "i|dddOO"
 #define TYPE_I_FFFIOO "i|dddiOO"
+#define TYPE_IOOO_F "iOOO|d"
 #define TYPE_O_IF "O|id"
 #define TYPE_O_IFS "O|ids"
 #define TYPE_S_IFF "s|idd"
+#define TYPE_S_IFFS "s|idds"
+#define TYPE_S_IFFSI "s|iddsi"
 #define TYPE_S_FIFF "s|didd"
 #define TYPE_S_FFIFF "s|ddidd"
 #define TYPE_S__OIFI "s|Oidi"
@@ -155,6 +165,7 @@
 #define TYPE_O_FFFFII "O|ddddii"
 #define TYPE_F_O "d|O"
 #define TYPE_F_OF "d|Od"
+#define TYPE_F_OFI "d|Odi"
 #define TYPE__OFFI "|Oddi"
 #define TYPE__OFII "|Odii"
 #define TYPE__FIIOO "|diiOO"
@@ -171,6 +182,7 @@
 #define TYPE_O_OOFFOO "O|OOddOO"
 #define TYPE_O_OOOFOO "O|OOOdOO"
 #define TYPE_OO_OOOIFOO "OO|OOOidOO"
+#define TYPE_O_IFFFFFF "O|idddddd"
 
 #define SF_WRITE sf_write_double
 #define SF_READ sf_read_double
@@ -197,6 +209,9 @@
 #endif
 #endif
 
+#include "muladd.h"
+#include "pyorand.h"
+
 #ifdef COMPILE_EXTERNALS
 #include "externalmodule.h"
 #endif
@@ -212,6 +227,8 @@ extern PyTypeObject RosslerAltType;
 extern PyTypeObject LorenzType;
 extern PyTypeObject LorenzAltType;
 extern PyTypeObject PhasorType;
+extern PyTypeObject MultiOscMainType;
+extern PyTypeObject PackedChannelType;
 extern PyTypeObject SuperSawType;
 extern PyTypeObject PointerType;
 extern PyTypeObject TableIndexType;
@@ -227,6 +244,7 @@ extern PyTypeObject NoiseType;
 extern PyTypeObject PinkNoiseType;
 extern PyTypeObject BrownNoiseType;
 extern PyTypeObject InputType;
+extern PyTypeObject BusInType;
 extern PyTypeObject SfPlayerType;
 extern PyTypeObject SfPlayType;
 extern PyTypeObject SfMarkerShufflerType;
@@ -268,6 +286,7 @@ extern PyTypeObject XnoiseMidiType;
 extern PyTypeObject XnoiseDurType;
 extern PyTypeObject UrnType;
 extern PyTypeObject BiquadType;
+extern PyTypeObject MultiBiquadMainType;
 extern PyTypeObject BiquadxType;
 extern PyTypeObject BiquadaType;
 extern PyTypeObject EQType;
@@ -290,6 +309,7 @@ extern PyTypeObject CompressType;
 extern PyTypeObject GateType;
 extern PyTypeObject BalanceType;
 extern PyTypeObject DelayType;
+extern PyTypeObject MultiDelayMainType;
 extern PyTypeObject SDelayType;
 extern PyTypeObject WaveguideType;
 extern PyTypeObject AllpassWGType;
@@ -341,6 +361,7 @@ extern PyTypeObject CosTableType;
 extern PyTypeObject CurveTableType;
 extern PyTypeObject ExpTableType;
 extern PyTypeObject SndTableType;
+extern PyTypeObject SndTableLoaderType;
 extern PyTypeObject DataTableType;
 extern PyTypeObject NewTableType;
 extern PyTypeObject TableRecType;
@@ -482,17 +503,23 @@ extern PyTypeObject TrigBurstDurStreamType;
 extern PyTypeObject TrigBurstEndStreamType;
 extern PyTypeObject ScopeType;
 extern PyTypeObject PeakAmpType;
+extern PyTypeObject FeaturesMainType;
+extern PyTypeObject FeaturesType;
 extern PyTypeObject MainParticleType;
 extern PyTypeObject ParticleType;
 extern PyTypeObject AtanTableType;
+extern PyTypeObject UnitMainType;
 
 /* Constants */
 #define E M_E
 #define PI M_PI
 #define TWOPI (2 * M_PI)
 
-/* random uniform (0.0 -> 1.0) */
-#define RANDOM_UNIFORM rand()/((MYFLT)(RAND_MAX)+1)
+/* random uniform (0.0 -> 1.0), from the `rng` member of the object (see pyorand.h) */
+#define RANDOM_UNIFORM PyoRand_uniform(&self->rng)
+/* random integer (0 -> RANDOM_MAX) */
+#define RANDOM_INT ((int)(PyoRand_next(&self->rng) >> 1))
+#define RANDOM_MAX 2147483647
 
 /* random objects identifier */
 #define BEATER_ID 0
@@ -524,6 +551,9 @@ extern PyTypeObject AtanTableType;
 #define URN_ID 26
 #define GRANULE_ID 27
 #define MAINPARTICLE_ID 28
+#define WGVERB_ID 29
+#define STREV_ID 30
+#define PVBUFLOOPS_ID 31
 /* Do not forget to modify Server_generateSeed function */
 
 /* object headers */
@@ -557,7 +587,11 @@ extern PyTypeObject AtanTableType;
     MatrixStream *matrixstream; \
     int width; \
     int height; \
-    MYFLT **data;
+    int stride; \
+    MYFLT *data;
+
+/* Point (x, y) of a matrix object or of a MatrixStream. */
+#define MATRIX_POINT(self, x, y) ((self)->data[(y) * (self)->stride + (x)])
 
 /* VISIT & CLEAR */
 #define pyo_VISIT \
@@ -606,7 +640,7 @@ extern PyTypeObject AtanTableType;
 
 #define pyo_DEALLOC \
     if (PyServer_get_server() != NULL) \
-        Server_removeStream((Server *)self->server, Stream_getStreamId(self->stream)); \
+        Server_removeStream((Server *)self->server, self->stream); \
     free(self->data); \
 
 /* INIT INPUT STREAM */
@@ -621,7 +655,9 @@ extern PyTypeObject AtanTableType;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getStream", NULL); \
     Py_INCREF(input_streamtmp); \
     Py_XDECREF(self->input_stream); \
-    self->input_stream = (Stream *)input_streamtmp;
+    self->input_stream = (Stream *)input_streamtmp; \
+    if (self->stream != NULL) \
+        self->stream->input = self->input_stream;
 
 #define INIT_INPUT_TRIGGER_STREAM \
     Py_INCREF(inputtmp); \
@@ -650,6 +686,15 @@ extern PyTypeObject AtanTableType;
     Stream_setBufferSize(self->stream, self->bufsize); \
     Stream_setData(self->stream, self->data);
 
+/* Makes the stream a packed one, `chnls` buffers one after the other in
+ * data, each read by a PackedChannel object. */
+#define INIT_PACKED_STREAM(chnls) \
+    self->data = (MYFLT *)realloc(self->data, (chnls) * self->bufsize * sizeof(MYFLT)); \
+    for (i=0; i<(chnls) * self->bufsize; i++) \
+        self->data[i] = 0.0; \
+    Stream_setData(self->stream, self->data); \
+    Stream_setPackedChannels(self->stream, (chnls));
+
 #define SET_INTERP_POINTER \
     if (self->interp == 0) \
         self->interp = 2; \
@@ -662,6 +707,12 @@ extern PyTypeObject AtanTableType;
     else if (self->interp == 4) \
         self->interp_func_ptr = cubic; \
 
+/* Table readers resolve their interpolation function at each buffer, for the
+   storage format of the table (see TableInterp_get). */
+#define SET_TABLE_INTERP \
+    if (self->interp == 0) \
+        self->interp = 2; \
+
 /* Set data */
 #define SET_TABLE_DATA \
     int i; \
@@ -692,21 +743,14 @@ extern PyTypeObject AtanTableType;
     } \
     self->height = PyList_Size(arg); \
     self->width = PyList_Size(PyList_GetItem(arg, 0)); \
-    self->data = (MYFLT **)realloc(self->data, (self->height + 1) * sizeof(MYFLT)); \
-    for (i=0; i<(self->height+1); i++) { \
-        self->data[i] = (MYFLT *)realloc(self->data[i], (self->width + 1) * sizeof(MYFLT)); \
-    } \
-    MatrixStream_setWidth(self->matrixstream, self->width); \
-    MatrixStream_setHeight(self->matrixstream, self->height); \
+    NewMatrix_allocate(self); \
  \
     for(i=0; i<self->height; i++) { \
         innerlist = PyList_GetItem(arg, i); \
         for (j=0; j<self->width; j++) { \
-            self->data[i][j] = PyFloat_AS_DOUBLE(PyNumber_Float(PyList_GET_ITEM(innerlist, j))); \
+            MATRIX_POINT(self, j, i) = PyFloat_AS_DOUBLE(PyNumber_Float(PyList_GET_ITEM(innerlist, j))); \
         } \
     } \
- \
-    MatrixStream_setData(self->matrixstream, self->data); \
  \
     Py_INCREF(Py_None); \
     return Py_None; \
@@ -1090,13 +1134,13 @@ extern PyTypeObject AtanTableType;
 #define NORMALIZE_MATRIX \
     int i, j; \
     MYFLT mi, ma, max, ratio; \
-    mi = ma = self->data[0][0]; \
+    mi = ma = MATRIX_POINT(self, 0, 0); \
     for (i=1; i<self->height; i++) { \
         for (j=1; j<self->width; j++) { \
-            if (mi > self->data[i][j]) \
-                mi = self->data[i][j]; \
-            if (ma < self->data[i][j]) \
-                ma = self->data[i][j]; \
+            if (mi > MATRIX_POINT(self, j, i)) \
+                mi = MATRIX_POINT(self, j, i); \
+            if (ma < MATRIX_POINT(self, j, i)) \
+                ma = MATRIX_POINT(self, j, i); \
         } \
     } \
     if ((mi*mi) > (ma*ma)) \
@@ -1108,7 +1152,7 @@ extern PyTypeObject AtanTableType;
         ratio = 0.99 / max; \
         for (i=0; i<self->height+1; i++) { \
             for (j=0; j<self->width+1; j++) { \
-                self->data[i][j] *= ratio; \
+                MATRIX_POINT(self, j, i) *= ratio; \
             } \
         } \
     } \
@@ -1150,29 +1194,32 @@ extern PyTypeObject AtanTableType;
 /* Matrix macros */
 #define MATRIX_BLUR \
     int i,j; \
-    MYFLT tmp[self->height][self->width]; \
+    /* On the heap, a large matrix doesn't fit on the stack. */ \
+    MYFLT *tmp = (MYFLT *)malloc(self->height * self->width * sizeof(MYFLT)); \
  \
+    int w = self->width; \
     int lw = self->width - 1; \
     int lh = self->height - 1; \
     for (i=1; i<lw; i++) { \
-        tmp[0][i] = (self->data[0][i-1] + self->data[0][i] + self->data[1][i] + self->data[0][i+1]) * 0.25; \
-        tmp[lh][i] = (self->data[lh][i-1] + self->data[lh][i] + self->data[lh-1][i] + self->data[lh][i+1]) * 0.25; \
+        tmp[i] = (MATRIX_POINT(self, i-1, 0) + MATRIX_POINT(self, i, 0) + MATRIX_POINT(self, i, 1) + MATRIX_POINT(self, i+1, 0)) * 0.25; \
+        tmp[lh*w+i] = (MATRIX_POINT(self, i-1, lh) + MATRIX_POINT(self, i, lh) + MATRIX_POINT(self, i, lh-1) + MATRIX_POINT(self, i+1, lh)) * 0.25; \
     } \
     for (i=1; i<lh; i++) { \
-        tmp[i][0] = (self->data[i-1][0] + self->data[i][0] + self->data[i][1] + self->data[i+1][0]) * 0.25; \
-        tmp[i][lw] = (self->data[i-1][lw] + self->data[i][lw] + self->data[i][lw-1] + self->data[i+1][lw]) * 0.25; \
+        tmp[i*w] = (MATRIX_POINT(self, 0, i-1) + MATRIX_POINT(self, 0, i) + MATRIX_POINT(self, 1, i) + MATRIX_POINT(self, 0, i+1)) * 0.25; \
+        tmp[i*w+lw] = (MATRIX_POINT(self, lw, i-1) + MATRIX_POINT(self, lw, i) + MATRIX_POINT(self, lw-1, i) + MATRIX_POINT(self, lw, i+1)) * 0.25; \
     } \
  \
     for (i=1; i<lh; i++) { \
         for (j=1; j<lw; j++) { \
-            tmp[i][j] = (self->data[i][j-1] + self->data[i][j] + self->data[i][j+1]) * 0.3333333; \
+            tmp[i*w+j] = (MATRIX_POINT(self, j-1, i) + MATRIX_POINT(self, j, i) + MATRIX_POINT(self, j+1, i)) * 0.3333333; \
         } \
     } \
     for (j=1; j<lw; j++) { \
         for (i=1; i<lh; i++) { \
-            self->data[i][j] = (tmp[i-1][j] + tmp[i][j] + tmp[i+1][j]) * 0.3333333; \
+            MATRIX_POINT(self, j, i) = (tmp[(i-1)*w+j] + tmp[i*w+j] + tmp[(i+1)*w+j]) * 0.3333333; \
         } \
     } \
+    free(tmp); \
     Py_INCREF(Py_None); \
     return Py_None;
 
@@ -1191,8 +1238,8 @@ extern PyTypeObject AtanTableType;
  \
     for (i=0; i<self->height; i++) { \
         for (j=0; j<self->width; j++) { \
-            val = self->data[i][j]; \
-            self->data[i][j] = NewMatrix_clip(val + (val-mid) * boost, min, max); \
+            val = MATRIX_POINT(self, j, i); \
+            MATRIX_POINT(self, j, i) = NewMatrix_clip(val + (val-mid) * boost, min, max); \
         } \
     } \
     Py_INCREF(Py_None); \
@@ -1217,7 +1264,7 @@ extern PyTypeObject AtanTableType;
         return PyInt_FromLong(-1); \
     } \
  \
-    self->data[y][x] = val; \
+    MATRIX_POINT(self, x, y) = val; \
  \
     Py_INCREF(Py_None); \
     return Py_None; \
@@ -1239,7 +1286,7 @@ extern PyTypeObject AtanTableType;
         return PyInt_FromLong(-1); \
     } \
  \
-    return PyFloat_FromDouble(self->data[y][x]); \
+    return PyFloat_FromDouble(MATRIX_POINT(self, x, y)); \
 
 /* GETS & SETS */
 #define GET_SERVER \
@@ -1541,116 +1588,137 @@ extern PyTypeObject AtanTableType;
     for (i=0; i<self->bufsize; i++) { \
         self->data[i] = 0; \
     } \
+    Stream_setConstant(self->stream, 1); \
+    Stream_setTriggers(self->stream, NULL, 0); \
+    Py_INCREF(Py_None); \
+    return Py_None;
+
+/* STOP for an object whose stream is packed, all its channels are cleared. */
+#define STOP_PACKED(chnls) \
+    int i; \
+    Stream_setStreamActive(self->stream, 0); \
+    Stream_setStreamChnl(self->stream, 0); \
+    Stream_setStreamToDac(self->stream, 0); \
+    for (i=0; i<(chnls) * self->bufsize; i++) { \
+        self->data[i] = 0; \
+    } \
+    Stream_setConstant(self->stream, 1); \
+    Stream_setTriggers(self->stream, NULL, 0); \
     Py_INCREF(Py_None); \
     return Py_None;
 
+/* Trigger lists of a generator with `voices` trigger buffers: the offsets of
+ * the triggers of voice v in the current buffer are trigs[v * bufsize] to
+ * trigs[v * bufsize + numtrigs[v] - 1]. */
+#define TRIGGER_LIST_ALLOC(trigs, numtrigs, voices) \
+    trigs = (int *)realloc(trigs, (voices) * self->bufsize * sizeof(int)); \
+    numtrigs = (int *)realloc(numtrigs, (voices) * sizeof(int)); \
+    memset(numtrigs, 0, (voices) * sizeof(int));
+
+#define TRIGGER_LIST_CLEAR(numtrigs, voices) \
+    memset(numtrigs, 0, (voices) * sizeof(int));
+
+#define TRIGGER_LIST_ADD(trigs, numtrigs, voice, pos) \
+    (trigs)[(voice) * self->bufsize + (numtrigs)[voice]++] = (pos);
+
+/* Lists the triggers of the stream, after mul and add, if its samples still
+ * hold 1 where the triggers are. */
+#define TRIGGER_LIST_SET(trigs, num) \
+    if (self->modebuffer[0] == 0 && self->modebuffer[1] == 0 && \
+        PyFloat_AS_DOUBLE(self->mul) == 1 && PyFloat_AS_DOUBLE(self->add) == 0) \
+        Stream_setTriggers(self->stream, trigs, num);
+
+/* Ends the process function of an object that computed only the first
+ * sample because its inputs are constant. */
+#define CONSTANT_OUTPUT \
+    pyo_fill(self->data, self->data[0], self->bufsize); \
+    Stream_setConstant(self->stream, 1);
+
 /* Post processing (mul & add) macros */
+/* A constant mul or add stream is applied as a scalar. The output stays
+ * constant only if the data and every stream applied are. */
 #define POST_PROCESSING_II \
-    MYFLT mul, add, old, val; \
-    int i; \
+    MYFLT mul, add; \
     mul = PyFloat_AS_DOUBLE(self->mul); \
     add = PyFloat_AS_DOUBLE(self->add); \
-    if (mul != 1 || add != 0) { \
-        for (i=0; i<self->bufsize; i++) { \
-            old = self->data[i]; \
-            val = mul * old + add; \
-            self->data[i] = val; \
-        } \
-    }
+    if (mul != 1 || add != 0) \
+        pyo_muladd_ii(self->data, mul, add, self->bufsize);
 
 #define POST_PROCESSING_AI \
-    MYFLT add, old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    add = PyFloat_AS_DOUBLE(self->add); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        val = mul[i] * old + add; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->mul_stream)) \
+        pyo_muladd_ii(self->data, Stream_getData((Stream *)self->mul_stream)[0], PyFloat_AS_DOUBLE(self->add), self->bufsize); \
+    else { \
+        pyo_muladd_ai(self->data, Stream_getData((Stream *)self->mul_stream), PyFloat_AS_DOUBLE(self->add), self->bufsize); \
+        Stream_setConstant(self->stream, 0); \
     }
 
 #define POST_PROCESSING_IA \
-    MYFLT mul, old, val; \
-    int i; \
-    mul = PyFloat_AS_DOUBLE(self->mul); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        val = mul * old + add[i]; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->add_stream)) \
+        pyo_muladd_ii(self->data, PyFloat_AS_DOUBLE(self->mul), Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else { \
+        pyo_muladd_ia(self->data, PyFloat_AS_DOUBLE(self->mul), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        Stream_setConstant(self->stream, 0); \
     }
 
 #define POST_PROCESSING_AA \
-    MYFLT old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        val = mul[i] * old + add[i]; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->mul_stream) && Stream_isConstant(self->add_stream)) \
+        pyo_muladd_ii(self->data, Stream_getData((Stream *)self->mul_stream)[0], Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else { \
+        if (Stream_isConstant(self->mul_stream)) \
+            pyo_muladd_ia(self->data, Stream_getData((Stream *)self->mul_stream)[0], Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        else if (Stream_isConstant(self->add_stream)) \
+            pyo_muladd_ai(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+        else \
+            pyo_muladd_aa(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        Stream_setConstant(self->stream, 0); \
     }
 
 #define POST_PROCESSING_REVAI \
-    MYFLT tmp, add, old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    add = PyFloat_AS_DOUBLE(self->add); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        tmp = mul[i]; \
-        if (tmp < 0.00001 && tmp > -0.00001) \
-            tmp = 0.00001; \
-        val = old / tmp + add; \
-        self->data[i] = val; \
-    }
+    pyo_muladd_revai(self->data, Stream_getData((Stream *)self->mul_stream), PyFloat_AS_DOUBLE(self->add), self->bufsize); \
+    Stream_setConstant(self->stream, 0);
 
 #define POST_PROCESSING_REVAA \
-    MYFLT tmp, old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        tmp = mul[i]; \
-        if (tmp < 0.00001 && tmp > -0.00001) \
-            tmp = 0.00001; \
-        val = old / tmp + add[i]; \
-        self->data[i] = val; \
-    }
+    if (Stream_isConstant(self->add_stream)) \
+        pyo_muladd_revai(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else \
+        pyo_muladd_revaa(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+    Stream_setConstant(self->stream, 0);
 
 #define POST_PROCESSING_IREVA \
-    MYFLT mul, old, val; \
-    int i; \
-    mul = PyFloat_AS_DOUBLE(self->mul); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        val = mul * old - add[i]; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->add_stream)) \
+        pyo_muladd_ii(self->data, PyFloat_AS_DOUBLE(self->mul), -Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else { \
+        pyo_muladd_ireva(self->data, PyFloat_AS_DOUBLE(self->mul), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        Stream_setConstant(self->stream, 0); \
     }
 
 #define POST_PROCESSING_AREVA \
-    MYFLT old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        val = mul[i] * old - add[i]; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->mul_stream) && Stream_isConstant(self->add_stream)) \
+        pyo_muladd_ii(self->data, Stream_getData((Stream *)self->mul_stream)[0], -Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else { \
+        if (Stream_isConstant(self->mul_stream)) \
+            pyo_muladd_ireva(self->data, Stream_getData((Stream *)self->mul_stream)[0], Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        else if (Stream_isConstant(self->add_stream)) \
+            pyo_muladd_ai(self->data, Stream_getData((Stream *)self->mul_stream), -Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+        else \
+            pyo_muladd_areva(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+        Stream_setConstant(self->stream, 0); \
     }
 
 #define POST_PROCESSING_REVAREVA \
-    MYFLT tmp, old, val; \
-    int i; \
-    MYFLT *mul = Stream_getData((Stream *)self->mul_stream); \
-    MYFLT *add = Stream_getData((Stream *)self->add_stream); \
-    for (i=0; i<self->bufsize; i++) { \
-        old = self->data[i]; \
-        tmp = mul[i]; \
-        if (tmp < 0.00001 && tmp > -0.00001) \
-            tmp = 0.00001; \
-        val = old / tmp - add[i]; \
-        self->data[i] = val; \
+    if (Stream_isConstant(self->add_stream)) \
+        pyo_muladd_revai(self->data, Stream_getData((Stream *)self->mul_stream), -Stream_getData((Stream *)self->add_stream)[0], self->bufsize); \
+    else \
+        pyo_muladd_revareva(self->data, Stream_getData((Stream *)self->mul_stream), Stream_getData((Stream *)self->add_stream), self->bufsize); \
+    Stream_setConstant(self->stream, 0);
+
+/* Scalar mul and add applied in the main loop of a generator whose
+ * muladd_func_ptr is pyo_postprocessing_fused. Otherwise FUSED_MULADD(x) is x. */
+#define FUSED_MULADD_INIT \
+    MYFLT fused_mul = 1.0, fused_add = 0.0; \
+    if (self->muladd_func_ptr == (void (*)())pyo_postprocessing_fused) { \
+        fused_mul = PyFloat_AS_DOUBLE(self->mul); \
+        fused_add = PyFloat_AS_DOUBLE(self->add); \
     }
+
+#define FUSED_MULADD(x) ((MYFLT)(x) * fused_mul + fused_add)
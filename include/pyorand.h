@@ -0,0 +1,97 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _PYORAND_
+#define _PYORAND_
+
+#include <stdint.h>
+
+/* Pseudo-random generator owned by each object drawing random numbers.
+ *
+ * The scalar generator is xoshiro128++. The block generator runs
+ * PYORAND_LANES independent xoshiro128++ side by side, one per vector lane,
+ * so PyoRand_fill compiles to vector integer code. Both are seeded from the
+ * value returned by Server_generateSeed, so a global seed gives the same
+ * sequences from one run to the next.
+ *
+ * Objects declare a `PyoRand rng` member, used by RANDOM_UNIFORM and
+ * RANDOM_INT (see pyomodule.h).
+ */
+#define PYORAND_LANES 8
+
+typedef struct {
+    uint32_t s[4];
+    uint32_t lanes[4][PYORAND_LANES];
+} PyoRand;
+
+/* Uniform in [0, 1) from the upper bits, converted from a signed int. */
+#ifdef USE_DOUBLE
+#define PYORAND_TO_UNIFORM(x) ((MYFLT)(int32_t)((x) >> 1) * 4.656612873077392578125e-10)
+#else
+#define PYORAND_TO_UNIFORM(x) ((MYFLT)(int32_t)((x) >> 8) * 5.9604644775390625e-08f)
+#endif
+
+#define PYORAND_ROTL(x, k) (((x) << (k)) | ((x) >> (32 - (k))))
+
+static inline uint32_t
+PyoRand_next(PyoRand *r)
+{
+    uint32_t *s = r->s;
+    uint32_t result = PYORAND_ROTL(s[0] + s[3], 7) + s[0];
+    uint32_t t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = PYORAND_ROTL(s[3], 11);
+    return result;
+}
+
+static inline MYFLT
+PyoRand_uniform(PyoRand *r)
+{
+    return PYORAND_TO_UNIFORM(PyoRand_next(r));
+}
+
+void PyoRand_seed(PyoRand *r, unsigned int seed);
+/* data[i] = uniform * mul + add, drawn from the block generator. */
+void PyoRand_fill(PyoRand *r, MYFLT *data, MYFLT mul, MYFLT add, int size);
+
+/* Distributions of the Xnoise family, between 0 and 1. The ones up to
+ * PYORAND_GAUSSIAN need no state and are drawn by blocks. */
+#define PYORAND_UNIFORM 0
+#define PYORAND_LINEAR_MIN 1
+#define PYORAND_LINEAR_MAX 2
+#define PYORAND_TRIANGLE 3
+#define PYORAND_EXPON_MIN 4 /* x1 = slope */
+#define PYORAND_EXPON_MAX 5 /* x1 = slope */
+#define PYORAND_BIEXPON 6 /* x1 = bandwidth */
+#define PYORAND_CAUCHY 7 /* x1 = bandwidth */
+#define PYORAND_WEIBULL 8 /* x1 = mean, x2 = shape */
+#define PYORAND_GAUSSIAN 9 /* x1 = mean, x2 = bandwidth */
+
+/* out[i] drawn from the distribution `type` with the parameters x1[i] and
+ * x2[i]. The uniform numbers come from the block generator and the
+ * transforms are vectorized. */
+void PyoRand_distribution(PyoRand *r, int type, MYFLT *x1, MYFLT *x2, MYFLT *out, int num);
+
+#endif
@@ -0,0 +1,90 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_PYOUNIT_H
+#define Py_PYOUNIT_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "pyomodule.h"
+
+/* Block processing units.
+ *
+ * A unit is a DSP routine described by a PyoUnit struct, hosted by the Unit
+ * object: no python object, stream or mul/add code to write. Its process
+ * function computes `nframes` samples of every output from the inputs and
+ * the parameters, all planar buffers of MYFLT. A control rate parameter is
+ * a single value per buffer, an audio rate one a vector of `nframes`
+ * samples. The outputs are the channels of a packed stream, mul and add are
+ * applied by the objects reading them, with the vector kernels.
+ *
+ * Units are computed by the worker threads of the server like any stream,
+ * process must not call into python nor keep pointers to its buffers from
+ * one call to the next. The state is `size` bytes owned by the host, zeroed
+ * before init.
+ *
+ * A unit is registered with PyoUnit_register from the pyo sources (see the
+ * EXTERNAL_UNITS macro of the externals), or exported by any extension
+ * module as a PyCapsule named PYO_UNIT_CAPSULE, given to Unit in place of a
+ * name. MYFLT being a double in pyo64, such a module is compiled once for
+ * each precision, the host checks `floatsize`. */
+#define PYO_UNIT_VERSION 1
+#define PYO_UNIT_CAPSULE "pyo.unit"
+#define PYO_UNIT_KRATE 0
+#define PYO_UNIT_ARATE 1
+
+typedef struct {
+    const char *name;
+    MYFLT value; /* initial value */
+    int rate; /* PYO_UNIT_KRATE or PYO_UNIT_ARATE */
+} PyoUnitParam;
+
+typedef struct PyoUnit {
+    int version; /* PYO_UNIT_VERSION */
+    int floatsize; /* sizeof(MYFLT) */
+    const char *name;
+    int ninputs;
+    int noutputs; /* at least 1 */
+    int nparams;
+    const PyoUnitParam *params;
+    size_t size; /* bytes of state */
+    /* Called at creation, may be NULL. */
+    void (*init)(void *state, double sr, int bufsize);
+    /* Frees what init allocated, may be NULL. */
+    void (*release)(void *state);
+    void (*process)(void *state, const MYFLT **in, MYFLT **out, const MYFLT **params, int nframes);
+} PyoUnit;
+
+#define PYO_UNIT_HEADER PYO_UNIT_VERSION, sizeof(MYFLT)
+
+/* Makes the unit available by its name. Returns -1 if the name is taken or
+ * the table is full. */
+extern int PyoUnit_register(const PyoUnit *unit);
+/* The registered unit named `name`, NULL if there is none. */
+extern const PyoUnit * PyoUnit_find(const char *name);
+/* The unitInfo function of the module. */
+extern PyObject * PyoUnit_info(PyObject *self, PyObject *arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_PYOUNIT_H) */
@@ -0,0 +1,71 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _RESAMPLER_
+#define _RESAMPLER_
+
+#include "pyomodule.h"
+
+/* Sample rate conversion with a windowed-sinc polyphase filter.
+ *
+ * The filter is tabulated for RESAMPLER_PHASES fractional positions between
+ * two input samples, an output sample is interpolated between the two
+ * nearest phases. Each phase holds the taps contiguously, the inner loops
+ * are vectorized dot products (see simd.h). When the rate is lowered, the
+ * cutoff follows the new Nyquist frequency.
+ *
+ * The quality selects the length of the filter, from 0 (4 zero crossings on
+ * each side, for previews) to 3 (32 zero crossings, for mastering).
+ */
+#define RESAMPLER_PHASES 256
+#define RESAMPLER_QUALITIES 4
+#define RESAMPLER_DEFAULT_QUALITY 2
+
+typedef struct {
+    double insr;
+    double outsr;
+    double step;    /* input samples per output sample */
+    int taps;       /* per phase */
+    MYFLT *coeffs;  /* (RESAMPLER_PHASES + 1) * taps */
+} Resampler;
+
+extern Resampler * Resampler_new(double insr, double outsr, int quality);
+/* A filter with `zeros` zero crossings on each side of the sinc, a Kaiser
+ * window of parameter `beta` and a cutoff at `rolloff` times the lowest
+ * Nyquist frequency. */
+extern Resampler * Resampler_newFilter(double insr, double outsr, int zeros, double beta, double rolloff);
+extern void Resampler_free(Resampler *self);
+/* Number of output samples for `insize` input samples. */
+extern long Resampler_getOutputSize(Resampler *self, long insize);
+/* Input samples [first, last) needed by the output samples [start, start+num). */
+extern void Resampler_getInputRange(Resampler *self, long start, long num, long *first, long *last);
+/* Converts a whole signal, samples outside `in` are zeros. */
+extern void Resampler_process(Resampler *self, MYFLT *in, long insize, MYFLT *out, long outsize);
+/* Computes the output samples [start, start+num) from `insize` input samples
+ * starting at input sample `inoffset`, the other input samples are zeros. */
+extern void Resampler_processBlock(Resampler *self, MYFLT *in, long inoffset, long insize, MYFLT *out, long start, long num);
+/* Same as Resampler_processBlock, the output range is split between
+ * `threads` threads (0 means one per processor). */
+extern void Resampler_processThreaded(Resampler *self, MYFLT *in, long inoffset, long insize, MYFLT *out, long start, long num, int threads);
+/* The signal at `index + frac` (0 <= frac < 1). The input samples
+ * [index - taps/2 + 1, index + taps/2] must be readable. */
+extern MYFLT Resampler_interpolate(Resampler *self, MYFLT *in, long index, MYFLT frac);
+
+#endif
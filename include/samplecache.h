@@ -0,0 +1,62 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _SAMPLECACHE_
+#define _SAMPLECACHE_
+
+#include "pyomodule.h"
+
+/* Decoded sounds shared between tables.
+ *
+ * An entry holds one channel of a region of a sound file, keyed by the path,
+ * the channel, the region and the rate of the samples (a sound converted to
+ * another rate is kept apart from the original one). Tables loading the same region share the
+ * samples of the entry, which must then be read only: a table about to
+ * modify its samples makes its own copy and releases the entry. An entry is
+ * freed when its last table releases it, and is not reused once the file
+ * changed on the disk.
+ */
+typedef struct SampleCache SampleCache;
+
+struct SampleCache {
+    MYFLT *data;        /* size + 1 samples */
+    long size;
+    int sndSr;
+    /* Private */
+    char *path;
+    int chnl;
+    long start;
+    long frames;        /* length of the region in the file */
+    long mtime;
+    long length;
+    int refcount;
+    SampleCache *next;
+};
+
+/* Returns the entry of a region, at the rate `sndSr`, with a new reference,
+ * or NULL. `start` and `frames` are in frames of the file. */
+extern SampleCache * SampleCache_find(const char *path, int chnl, long start, long frames, int sndSr);
+/* Moves `data` (size + 1 samples at the rate `sndSr`, from malloc) in a new
+ * entry and returns it, with one reference. */
+extern SampleCache * SampleCache_insert(const char *path, int chnl, long start, long frames, int sndSr,
+                                        MYFLT *data, long size);
+extern void SampleCache_release(SampleCache *self);
+
+#endif
@@ -32,6 +32,15 @@ extern "C" {
 #include "portmidi.h"
 #include "sndfile.h"
 #include "pyomodule.h"
+#include "dspthread.h"
+#include "paramqueue.h"
+#include "timerwheel.h"
+#include "midiring.h"
+#include "oscsender.h"
+#include "diskwriter.h"
+#include "shmaudio.h"
+#include "callbackstats.h"
+#include "streamlist.h"
 
 #ifdef USE_JACK
 #include <jack/jack.h>
@@ -41,13 +50,33 @@ extern "C" {
 # include <CoreAudio/AudioHardware.h>
 #endif
 
+#define MAX_NBR_BUSES 256
+#define MAX_NBR_SHM_WORKERS 32
+
+/* MIDI input events kept between the MIDI thread and the audio thread. */
+#define MIDI_RING_SIZE 4096
+
+/* OSC messages kept between the audio thread and the OSC send thread. */
+#define OSC_SEND_QUEUE_SIZE 2048
+
+/* Kinds of messages of Server_getMidiEvents. */
+#define PYO_MIDI_NOTE 0 /* note off and note on */
+#define PYO_MIDI_POLYTOUCH 1
+#define PYO_MIDI_CTL 2
+#define PYO_MIDI_PROGRAM 3
+#define PYO_MIDI_TOUCH 4
+#define PYO_MIDI_BEND 5
+#define PYO_MIDI_SYSTEM 6
+#define PYO_MIDI_KINDS 7
+
 typedef enum {
     PyoPortaudio = 0,
     PyoCoreaudio = 1,
     PyoJack,
     PyoOffline,
     PyoOfflineNB,
-    PyoEmbedded
+    PyoEmbedded,
+    PyoShm
 } PyoAudioBackendType;
 
 typedef struct {
@@ -59,12 +88,28 @@ typedef struct {
     jack_client_t *jack_client;
     jack_port_t **jack_in_ports;
     jack_port_t **jack_out_ports;
+    jack_nframes_t transport_frame; /* transport frame expected at the next callback */
+    int freewheel; /* set by jack while the graph renders faster than realtime */
 #endif
 } PyoJackBackendData;
 
+typedef struct {
+    ShmAudio *shm; /* blocks computed for the host process */
+    pthread_t thread;
+} PyoShmBackendData;
+
+/* A worker process computing blocks for this server. It gets the bus
+   channels `send` and its answer is summed in the bus channels `receive`
+   (-1 for none), read by the objects at the next block. */
+typedef struct {
+    ShmAudio *shm;
+    int send;
+    int receive;
+} PyoShmWorker;
+
 typedef struct {
     PyObject_HEAD
-    PyObject *streams;
+    StreamList *streams; /* in processing order */
     PyoAudioBackendType audio_be_type;
     void *audio_be_data;
     char *serverName; /* Only used for jack client name */
@@ -72,16 +117,33 @@ typedef struct {
     int jackautoout; /* jack port auto-connection (on by default) */
     PyObject *jackAutoConnectInputPorts; /* list of regex to match for jack auto-connection */
     PyObject *jackAutoConnectOutputPorts; /* list of regex to match for jack auto-connection */
+    int jackTransport; /* processing follows the jack transport (off by default) */
+    PyObject *jackLocateCallable; /* called with the transport position, in seconds, after a locate */
     PmStream *midiin[64];
     PmStream *midiout[64];
     int midiin_count;
     int midiout_count;
-    PmEvent midiEvents[200];
-    int midi_count;
+    MidiRing *midiring; /* events read by the MIDI thread */
+    OscSender *oscsender; /* OSC messages sent by the objects, created on demand */
+    double oscSendRate;
+    MidiRingEvent *midiReceived; /* events taken from the ring for the host buffer */
+    PmEvent *midiEvents; /* the same, timestamps are frame offsets in the host buffer */
+    int midiEventCount;
+    int midiEventPos; /* first event of the current block in midiEvents */
+    PmEvent *midiBlock; /* events of the current block, timestamps are frame offsets in the block */
+    int midi_count; /* events in midiBlock */
+    PmEvent *midiSorted; /* midiBlock by kind, then by kind and channel, each in time order */
+    int midiKindIndex[PYO_MIDI_KINDS+1];
+    int midiChannelIndex[PYO_MIDI_KINDS*16+1];
     double samplingRate;
     int nchnls;
     int ichnls;
-    int bufferSize;
+    int bufferSize; /* Block size computed by the objects */
+    int hostBufferSize; /* Buffer size of the audio backend */
+    int blockSize; /* Requested block size, 0 means bufferSize */
+    int blockOffset; /* Current frame offset in the host buffer */
+    unsigned long long hostClock; /* Stream_clock of the host buffer's first frame, one buffer late */
+    CallbackStats *cbstats; /* timing and xruns of the audio callbacks */
     int duplex;
     int input;
     int output;
@@ -94,7 +156,6 @@ typedef struct {
     int server_started;
     int server_stopped; /* for fadeout */
     int server_booted;
-    int stream_count;
     int record;
     int thisServerID;       /* To keep the reference index in the array of servers */
 
@@ -107,8 +168,13 @@ typedef struct {
     int timeStep;
     int timeCount;
 
-    MYFLT *input_buffer;
+    MYFLT *input_buffer; /* Interleaved input written by the embedding hosts */
+    MYFLT *input_planar; /* Planar input read by the Input objects, dacFrames per channel */
     float *output_buffer; /* Has to be float since audio callbacks must use floats */
+    MYFLT *dac_buffer; /* Planar sum of the streams sent to the dac, dacFrames per channel */
+    MYFLT *gain_buffer; /* Server amplitude of each frame of dac_buffer */
+    int dacFrames;
+    int planarOutput; /* The backend reads dac_buffer, output_buffer is only filled when needed */
 
     /* rendering offline of the first "startoffset" seconds */
     double startoffset;
@@ -118,35 +184,96 @@ typedef struct {
     char *recpath;
     int recformat;
     int rectype;
+    int recsync; /* periodically commits the recorded file to the disk */
     SNDFILE *recfile;
     SF_INFO recinfo;
+    DiskWriter *recwriter; /* the recorded file is written by this writer's thread */
 
     /* GUI VUMETER */
     int withGUI;
-    int numPass;
-    int gcount;
-    float *lastRms;
+    float *lastRms; /* smoothed squared peak of each channel */
+    float *lastPower; /* smoothed mean square of each channel */
     PyObject *GUI;
 
     /* Current time */
     unsigned long elapsedSamples; /* time since the server was started */
     int withTIME;
-    int timePass;
-    int tcount;
     PyObject *TIME;
 
+    /* Meters and time published by the audio thread after each block and
+       polled by the GUI. meterSeq is odd while they are written. */
+    volatile unsigned int meterSeq;
+    unsigned int meterPolled; /* meterSeq at the last pollCallables */
+    float *meterPeak;
+    float *meterRms;
+    unsigned long meterSamples;
+
     /* Properties */
     int verbosity; /* a sum of values to display different levels: 1 = error */
                    /* 2 = message, 4 = warning , 8 = debug. Default 7.*/
     int globalSeed; /* initial seed for random objects. If -1, objects are seeded with the clock. */
+
+    /* Parallel processing of the stream list */
+    int numThreads; /* number of worker threads, 0 means serial processing */
+    int pullMode; /* if 1, only streams reachable from the dac or a sink are computed */
+    int flushDenormals; /* if 1, denormals are flushed to zero while computing the streams */
+    struct StreamGraph *graph;
+
+    /* Processing without the GIL */
+    int withoutGIL; /* requested by the user, only used by real-time and embedded backends */
+    CallbackQueue *callbacks; /* deferred python calls, not NULL if the server runs without the GIL */
+    DspLock *dsplock; /* held by the audio thread during a buffer, without the GIL */
+    PyInterpreterState *interp; /* interpreter which created the server */
+    PyoThreadState audiostate; /* GIL of the thread computing the buffers */
+
+    /* Timestamped parameter changes */
+    ParamQueue *params;
+
+    /* Deadlines of the objects calling python functions at given times */
+    TimerWheel *timers;
+
+    int profiling; /* if 1, streams accumulate their processing time */
+
+    /* Internal buses. Streams are summed in one half of a bus channel while
+       the other half, summed during the previous block, is read. */
+    MYFLT *buses[MAX_NBR_BUSES]; /* two halves of bufferSize samples per channel */
+    int bus_count;
+    int bus_front; /* half read during the current block */
+    PyObject *bus_names; /* name -> (first channel, number of channels) */
+
+    /* Worker processes computing blocks of the buses */
+    PyoShmWorker shmworkers[MAX_NBR_SHM_WORKERS];
+    int shmworker_count;
 } Server;
 
 PyObject * PyServer_get_server();
-extern PyObject * Server_removeStream(Server *self, int sid);
-extern MYFLT * Server_getInputBuffer(Server *self);
+extern void Server_removeStream(Server *self, struct Stream *stream);
+/* Input channel `chnl` for the current block, NULL if the server has no such channel. */
+extern MYFLT * Server_getInputChannel(Server *self, int chnl);
+extern MYFLT * Server_getBusBuffer(Server *self, int chnl);
 extern PmEvent * Server_getMidiEventBuffer(Server *self);
 extern int Server_getMidiEventCount(Server *self);
+/* Events of the current block of the `kind` PYO_MIDI_*, on `channel` (1 to
+ * 16, 0 for all), in time order. Their timestamps hold their frame offsets
+ * in the block. */
+extern PmEvent * Server_getMidiEvents(Server *self, int kind, int channel, int *count);
 extern int Server_generateSeed(Server *self, int oid);
+extern int Server_isGILFree(Server *self);
+/* Computes `frames` frames, a multiple of the buffer size, of an embedded
+ * server from and to planar buffers of `ichnls` and `nchnls` channels. The
+ * host calls it from its own threads, with no python state, without holding
+ * the GIL. Returns -1 if `frames` is not a multiple of the buffer size. */
+extern int Server_embedded_p_start(void *server, float **ins, float **outs, int frames);
+extern void Server_postCallback(Server *self, PyObject *obj, PyoCallbackFunc func, double value);
+extern unsigned long long Server_getCurrentSample(Server *self);
+/* Frame offset in the current block of an event due at `time`, in
+ * Stream_clock nanoseconds. 0 for late events, the buffer size or more for
+ * events due in a later block. */
+extern int Server_getClockFrame(Server *self, unsigned long long time);
+/* The server's OSC sender, created the first time, NULL if its thread
+ * can't be started. */
+extern OscSender * Server_getOscSender(Server *self);
+extern int Server_scheduleTimer(Server *self, TimerEvent *ev, unsigned long long time);
 extern PyTypeObject ServerType;
 
 #ifdef __cplusplus
@@ -0,0 +1,93 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _SHMAUDIO_
+#define _SHMAUDIO_
+
+/* Audio blocks exchanged with another process through shared memory.
+ *
+ * A worker process creates a named segment holding two rings of blocks:
+ * the blocks to compute, written by the host process, and the computed
+ * blocks, written back by the worker. Each ring has one producer and one
+ * consumer and no lock, the counters of blocks written and read live in the
+ * segment. A consumer waiting for a block sleeps on the producer's counter
+ * with a futex on linux, and polls it elsewhere. The blocks are planar
+ * 32-bit floats, whatever the sample resolution of the processes.
+ *
+ * The n-th block computed by the worker answers the n-th block written by
+ * the host. A host which doesn't get an answer in time skips it, the worker
+ * stays in step since the host always reads the answer of its last block.
+ *
+ * Not available on Windows.
+ */
+#define SHMAUDIO_DEPTH 4
+
+typedef struct {
+    unsigned int magic;
+    int bufsize;
+    int ichnls; /* channels of the blocks to compute */
+    int nchnls; /* channels of the computed blocks */
+    double sr;
+    volatile unsigned int in_written;
+    volatile unsigned int in_read;
+    volatile unsigned int out_written;
+    volatile unsigned int out_read;
+    volatile int closed; /* the worker is gone */
+} ShmAudioHeader;
+
+typedef struct {
+    ShmAudioHeader *header;
+    float *in; /* SHMAUDIO_DEPTH blocks of ichnls * bufsize samples */
+    float *out; /* SHMAUDIO_DEPTH blocks of nchnls * bufsize samples */
+    size_t size;
+    char name[64];
+    int owner; /* the worker, which unlinks the segment */
+    int sent; /* the host wrote a block during the current buffer */
+    unsigned long dropped; /* blocks not written by the host, the ring was full */
+    unsigned long late; /* answers not received in time by the host */
+} ShmAudio;
+
+/* Worker side. Creates the segment `name`, replacing a stale one. Returns
+ * NULL on error. */
+extern ShmAudio * ShmAudio_create(const char *name, double sr, int bufsize, int ichnls, int nchnls);
+/* Host side. Opens the segment of a running worker, NULL if there is none. */
+extern ShmAudio * ShmAudio_open(const char *name);
+extern void ShmAudio_close(ShmAudio *self);
+
+/* From the worker thread. The next block to compute, or NULL if none came
+ * in `timeout` microseconds. ShmAudio_doneInput frees its slot. */
+extern float * ShmAudio_waitInput(ShmAudio *self, long timeout);
+extern void ShmAudio_doneInput(ShmAudio *self);
+/* From the worker thread. The slot of the next computed block, or NULL if
+ * the host didn't free one in `timeout` microseconds. */
+extern float * ShmAudio_waitOutput(ShmAudio *self, long timeout);
+extern void ShmAudio_commitOutput(ShmAudio *self);
+
+/* From the host's audio thread. The slot of the next block to compute, or
+ * NULL when the ring is full (the block is dropped and counted). */
+extern float * ShmAudio_reserveInput(ShmAudio *self);
+extern void ShmAudio_commitInput(ShmAudio *self);
+/* From the host's audio thread. The answer to the block written in the
+ * current buffer, waited for at most `timeout` microseconds, or NULL (late
+ * and counted). ShmAudio_doneOutput frees its slot. */
+extern float * ShmAudio_receive(ShmAudio *self, long timeout);
+extern void ShmAudio_doneOutput(ShmAudio *self);
+
+#endif
@@ -0,0 +1,188 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _SIMD_
+#define _SIMD_
+
+#include "pyomodule.h"
+
+/* Vector macros over MYFLT, for the kernels with a scalar tail.
+ *
+ * VSIZE is the number of MYFLT per vector, it is left undefined when the
+ * compiler targets none of AVX, SSE, SSE2 (double) or aarch64 NEON. Loads and
+ * stores are unaligned. VFLOOR rounds toward minus infinity, it needs SSE2 on
+ * x86 without AVX and is exact there for |x| < 2^31. VWRAP(x, size) adds
+ * size to the lanes of x below 0, as the ring readers do. VMASKGT(a, b, val)
+ * keeps the lanes of val where a > b and zeroes the others.
+ *
+ * In single precision, with SSE2, AVX2 or NEON, VEXPONENT(x) and VMANTISSA(x)
+ * split the positive lanes of x into their exponent and their mantissa in
+ * [1, 2), and VEXP2I(e) is 2^e for the integral lanes of e in [-126, 127].
+ *
+ * With AVX2, VGATHER(base, idx) loads the VSIZE MYFLT base[idx[k]], the
+ * indices being VSIZE ints loaded with VLOADI.
+ */
+#if defined(USE_DOUBLE)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VSIZE 4
+#define VTYPE __m256d
+#define VLOAD _mm256_loadu_pd
+#define VSTORE _mm256_storeu_pd
+#define VSET1 _mm256_set1_pd
+#define VADD _mm256_add_pd
+#define VSUB _mm256_sub_pd
+#define VMUL _mm256_mul_pd
+#define VDIV _mm256_div_pd
+#define VSQRT _mm256_sqrt_pd
+#define VMIN _mm256_min_pd
+#define VMAX _mm256_max_pd
+#define VFLOOR _mm256_floor_pd
+#define VCLAMP(x, lo, hi, val) _mm256_blendv_pd(x, val, _mm256_and_pd(_mm256_cmp_pd(x, hi, _CMP_LE_OQ), _mm256_cmp_pd(x, lo, _CMP_GE_OQ)))
+#define VWRAP(x, size) _mm256_add_pd(x, _mm256_and_pd(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_LT_OQ), size))
+#define VMASKGT(a, b, val) _mm256_and_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ), val)
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VSIZE 2
+#define VTYPE __m128d
+#define VLOAD _mm_loadu_pd
+#define VSTORE _mm_storeu_pd
+#define VSET1 _mm_set1_pd
+#define VADD _mm_add_pd
+#define VSUB _mm_sub_pd
+#define VMUL _mm_mul_pd
+#define VDIV _mm_div_pd
+#define VSQRT _mm_sqrt_pd
+#define VMIN _mm_min_pd
+#define VMAX _mm_max_pd
+#define VFLOOR _mm_pyo_floor_pd
+#define VCLAMP(x, lo, hi, val) _mm_pyo_select_pd(_mm_and_pd(_mm_cmple_pd(x, hi), _mm_cmpge_pd(x, lo)), val, x)
+#define VWRAP(x, size) _mm_add_pd(x, _mm_and_pd(_mm_cmplt_pd(x, _mm_setzero_pd()), size))
+#define VMASKGT(a, b, val) _mm_and_pd(_mm_cmpgt_pd(a, b), val)
+#define _mm_pyo_select_pd(m, a, b) _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b))
+static inline __m128d _mm_pyo_floor_pd(__m128d x) {
+    __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+    return _mm_sub_pd(t, _mm_and_pd(_mm_cmpgt_pd(t, x), _mm_set1_pd(1.0)));
+}
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define VSIZE 2
+#define VTYPE float64x2_t
+#define VLOAD vld1q_f64
+#define VSTORE vst1q_f64
+#define VSET1 vdupq_n_f64
+#define VADD vaddq_f64
+#define VSUB vsubq_f64
+#define VMUL vmulq_f64
+#define VDIV vdivq_f64
+#define VSQRT vsqrtq_f64
+#define VMIN vminq_f64
+#define VMAX vmaxq_f64
+#define VFLOOR vrndmq_f64
+#define VCLAMP(x, lo, hi, val) vbslq_f64(vandq_u64(vcleq_f64(x, hi), vcgeq_f64(x, lo)), val, x)
+#define VWRAP(x, size) vaddq_f64(x, vbslq_f64(vcltq_f64(x, vdupq_n_f64(0.0)), size, vdupq_n_f64(0.0)))
+#define VMASKGT(a, b, val) vbslq_f64(vcgtq_f64(a, b), val, vdupq_n_f64(0.0))
+#endif
+#else
+#if defined(__AVX__)
+#include <immintrin.h>
+#define VSIZE 8
+#define VTYPE __m256
+#define VLOAD _mm256_loadu_ps
+#define VSTORE _mm256_storeu_ps
+#define VSET1 _mm256_set1_ps
+#define VADD _mm256_add_ps
+#define VSUB _mm256_sub_ps
+#define VMUL _mm256_mul_ps
+#define VDIV _mm256_div_ps
+#define VSQRT _mm256_sqrt_ps
+#define VMIN _mm256_min_ps
+#define VMAX _mm256_max_ps
+#define VFLOOR _mm256_floor_ps
+#define VCLAMP(x, lo, hi, val) _mm256_blendv_ps(x, val, _mm256_and_ps(_mm256_cmp_ps(x, hi, _CMP_LE_OQ), _mm256_cmp_ps(x, lo, _CMP_GE_OQ)))
+#define VWRAP(x, size) _mm256_add_ps(x, _mm256_and_ps(_mm256_cmp_ps(x, _mm256_setzero_ps(), _CMP_LT_OQ), size))
+#define VMASKGT(a, b, val) _mm256_and_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ), val)
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#define VSIZE 4
+#define VTYPE __m128
+#define VLOAD _mm_loadu_ps
+#define VSTORE _mm_storeu_ps
+#define VSET1 _mm_set1_ps
+#define VADD _mm_add_ps
+#define VSUB _mm_sub_ps
+#define VMUL _mm_mul_ps
+#define VDIV _mm_div_ps
+#define VSQRT _mm_sqrt_ps
+#define VMIN _mm_min_ps
+#define VMAX _mm_max_ps
+#define VCLAMP(x, lo, hi, val) _mm_pyo_select_ps(_mm_and_ps(_mm_cmple_ps(x, hi), _mm_cmpge_ps(x, lo)), val, x)
+#define VWRAP(x, size) _mm_add_ps(x, _mm_and_ps(_mm_cmplt_ps(x, _mm_setzero_ps()), size))
+#define VMASKGT(a, b, val) _mm_and_ps(_mm_cmpgt_ps(a, b), val)
+#define _mm_pyo_select_ps(m, a, b) _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define VFLOOR _mm_pyo_floor_ps
+#define VEXPONENT(x) _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(_mm_castps_si128(x), 23), _mm_set1_epi32(127)))
+#define VMANTISSA(x) _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000)))
+#define VEXP2I(e) _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(_mm_cvtps_epi32(e), _mm_set1_epi32(127)), 23))
+static inline __m128 _mm_pyo_floor_ps(__m128 x) {
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(x));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, x), _mm_set1_ps(1.0f)));
+}
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define VSIZE 4
+#define VTYPE float32x4_t
+#define VLOAD vld1q_f32
+#define VSTORE vst1q_f32
+#define VSET1 vdupq_n_f32
+#define VADD vaddq_f32
+#define VSUB vsubq_f32
+#define VMUL vmulq_f32
+#define VDIV vdivq_f32
+#define VSQRT vsqrtq_f32
+#define VMIN vminq_f32
+#define VMAX vmaxq_f32
+#define VFLOOR vrndmq_f32
+#define VCLAMP(x, lo, hi, val) vbslq_f32(vandq_u32(vcleq_f32(x, hi), vcgeq_f32(x, lo)), val, x)
+#define VWRAP(x, size) vaddq_f32(x, vbslq_f32(vcltq_f32(x, vdupq_n_f32(0.0f)), size, vdupq_n_f32(0.0f)))
+#define VMASKGT(a, b, val) vbslq_f32(vcgtq_f32(a, b), val, vdupq_n_f32(0.0f))
+#define VEXPONENT(x) vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_f32(x), 23)), vdupq_n_s32(127)))
+#define VMANTISSA(x) vreinterpretq_f32_u32(vorrq_u32(vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000)))
+#define VEXP2I(e) vreinterpretq_f32_s32(vshlq_n_s32(vaddq_s32(vcvtq_s32_f32(e), vdupq_n_s32(127)), 23))
+#endif
+#endif
+
+#if defined(__AVX2__)
+#if defined(USE_DOUBLE)
+#define VLOADI(p) _mm_loadu_si128((__m128i *)(p))
+#define VGATHER(base, idx) _mm256_i32gather_pd(base, idx, 8)
+#else
+#define VLOADI(p) _mm256_loadu_si256((__m256i *)(p))
+#define VGATHER(base, idx) _mm256_i32gather_ps(base, idx, 4)
+#define VEXPONENT(x) _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(_mm256_castps_si256(x), 23), _mm256_set1_epi32(127)))
+#define VMANTISSA(x) _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(_mm256_castps_si256(x), _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000)))
+#define VEXP2I(e) _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(e), _mm256_set1_epi32(127)), 23))
+#endif
+#endif
+
+#endif
@@ -0,0 +1,55 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _SINEKERNEL_
+#define _SINEKERNEL_
+
+#include "pyomodule.h"
+
+/* Oscillator kernels working in cycles (one period = 1.0).
+ *
+ * The sine is a minimax polynomial over a quarter of a period, the phase is
+ * folded there first, so any phase value is accepted. The accuracy selects
+ * the polynomial, SINE_ACCURACY_TABLE means the objects keep their
+ * wavetable lookup and never call these functions. The inner loops are
+ * vectorized (see simd.h).
+ */
+#define SINE_ACCURACY_TABLE 0
+#define SINE_ACCURACY_FAST 1  /* 5th order, error below 7e-5 */
+#define SINE_ACCURACY_HIGH 2  /* 9th order, error below 4e-9 */
+#define SINE_ACCURACIES 3
+
+/* sin(2 * pi * x). */
+extern MYFLT SineKernel_sample(MYFLT x, int accuracy);
+/* out[i] = sin(2 * pi * x[i]), `out` may be `x`. */
+extern void SineKernel_process(MYFLT *x, MYFLT *out, int num, int accuracy);
+/* Phase ramp, out[i] holds the fractional part of pos + offset + i * inc.
+ * Returns the phase following the last sample, between 0 and 1. The phase
+ * is kept in double and restarted for each vector, so the error does not
+ * grow with the buffer size. */
+extern double SineKernel_ramp(MYFLT *out, double pos, double inc, MYFLT offset, int num);
+/* Same as SineKernel_ramp followed by SineKernel_process, in one pass. */
+extern double SineKernel_oscillate(MYFLT *out, double pos, double inc, MYFLT offset, int num, int accuracy);
+/* Band-limited impulses of Blit, out[i] = sin(m * x[i]) / (m * sin(x[i]))
+ * for 0 < x[i] < pi, in radians, and 1 for x[i] <= 0. `m` holds `num`
+ * values, or is NULL for the constant `cm`. Uses SINE_ACCURACY_HIGH. */
+extern void SineKernel_blit(MYFLT *x, MYFLT *m, MYFLT cm, MYFLT *out, int num);
+
+#endif
@@ -0,0 +1,50 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _SNDMAP_
+#define _SNDMAP_
+
+#include "pyomodule.h"
+#include "sndfile.h"
+
+/* One channel of a sound, memory-mapped from a raw copy kept in a cache
+ * directory.
+ *
+ * The first load of a sound decodes the requested channel and region, by
+ * chunks, in a raw file of MYFLT samples (followed by the guard point of the
+ * tables). Later loads only check that the source didn't change and map the
+ * raw file, the system then pages the samples in when they are read. The
+ * mapping is private: tables can modify their samples, the modified pages
+ * are copied in memory and the cache file is left untouched.
+ */
+typedef struct {
+    MYFLT *data;        /* size + 1 samples */
+    long size;
+    void *map;
+    size_t maplength;
+} SndMap;
+
+/* `sf` is open on `path`, `start` and `size` are in frames. Returns NULL if
+ * the cache can't be used, the caller should then read the sound itself. */
+extern SndMap * SndMap_open(const char *cachedir, const char *path, SNDFILE *sf, SF_INFO *info,
+                            int chnl, long start, long size);
+extern void SndMap_close(SndMap *self);
+
+#endif
@@ -0,0 +1,55 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_STREAMGRAPH_H
+#define Py_STREAMGRAPH_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <Python.h>
+
+/* Parallel scheduler for the server's stream list.
+ *
+ * Dependencies between streams are discovered with each object's
+ * tp_traverse slot. Every edge goes from a lower to a higher position in
+ * the stream list, so running the graph gives exactly the same results as
+ * the serial loop. The calling thread takes part in the processing.
+ */
+struct Stream;
+
+typedef struct StreamGraph StreamGraph;
+
+/* Creates the graph and `nthreads` worker threads (none for serial processing in pull mode). */
+extern StreamGraph * StreamGraph_new(int nthreads);
+/* Stops and joins the worker threads, then frees the graph. */
+extern void StreamGraph_free(StreamGraph *self);
+/* Indexes the first `count` streams of the server's array, which holds no hole. Must be called once per buffer. */
+extern void StreamGraph_prepare(StreamGraph *self, struct Stream **streams, int count);
+/* Suspends the prepared streams which no dac-bound or sink stream depends on. */
+extern void StreamGraph_pull(StreamGraph *self, int count);
+/* Computes the active streams between `start` and `stop` (exclusive). None of them may call into Python. */
+extern void StreamGraph_run(StreamGraph *self, int start, int stop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_STREAMGRAPH_H) */
@@ -0,0 +1,69 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_STREAMLIST_H
+#define Py_STREAMLIST_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <Python.h>
+
+struct Stream;
+
+/* The server's streams, in processing order.
+ *
+ * Every stream keeps its slot in the array, adding a stream appends it and
+ * removing one leaves a hole, both in constant time. The holes are squeezed
+ * out by StreamList_compact, in one pass which keeps the order. Slots are
+ * never reused: a stream is always computed after the streams added before
+ * it, the ones it may read.
+ *
+ * All the functions must be called with the lock protecting the streams (the
+ * GIL, or the dsp lock when the server runs without the GIL). */
+typedef struct {
+    struct Stream **items; /* NULL in the holes */
+    int count; /* slots used, holes included */
+    int size;
+    int holes;
+    int iterating; /* set while the server computes the streams, the array is not compacted */
+} StreamList;
+
+extern StreamList * StreamList_new(void);
+/* Releases the streams. */
+extern void StreamList_clear(StreamList *self);
+extern void StreamList_free(StreamList *self);
+/* Takes a new reference to the stream. */
+extern void StreamList_append(StreamList *self, struct Stream *stream);
+/* Releases the stream, does nothing if it isn't in the list. The array is
+ * compacted once half of its slots are holes. */
+extern void StreamList_remove(StreamList *self, struct Stream *stream);
+/* Moves `stream` just before `ref`, or at the end if `ref` isn't in the list. */
+extern void StreamList_moveBefore(StreamList *self, struct Stream *stream, struct Stream *ref);
+/* After it, items holds count streams and no hole. Cheap if there is no hole. */
+extern void StreamList_compact(StreamList *self);
+/* A new python list of the streams. */
+extern PyObject * StreamList_toList(StreamList *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_STREAMLIST_H) */
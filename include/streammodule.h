@@ -21,11 +21,19 @@
 #include <Python.h>
 #include "pyomodule.h"
 
+/* Per-stream processing time, accumulated while the server is profiling. */
 typedef struct {
+    unsigned long long total; /* nanoseconds */
+    unsigned long long max;
+    unsigned long count;
+} StreamProfile;
+
+typedef struct Stream {
     PyObject_HEAD
     PyObject *streamobject;
     void (*funcptr)();
     int sid;
+    int slot; /* position in the server's stream list */
     int chnl;
     int bufsize;
     int active;
@@ -33,6 +41,26 @@ typedef struct {
     int duration;
     int bufferCountWait;
     int bufferCount;
+    int pycall; /* process function calls into the interpreter, never computed in parallel */
+    int shared; /* process function writes in objects it doesn't own (tables, matrices) */
+    int sink; /* has side effects (recording, python callbacks, ...), always computed in pull mode */
+    int suspended; /* not computed, nothing reachable from the dac or a sink depends on it */
+    int keep; /* fills trigger streams, never skipped by the voice suspension */
+    int silent; /* skipped by the voice suspension, data holds zeros */
+    long tail; /* samples the output rings once the input is quiet, -1 if it doesn't follow its input */
+    long quiet; /* samples the input and the output have been quiet */
+    struct Stream *input; /* main audio input, borrowed from the object */
+    int krate; /* data is a linear ramp from the last sample of the previous buffer to its own last sample */
+    int constant; /* every sample of data equals data[0], cleared before each computation */
+    int *trigs; /* offsets of the triggers (samples equal to 1) in data, in order, owned by the producer */
+    int numtrigs; /* entries of trigs, -1 if the producer doesn't list its triggers */
+    int timed; /* waits for a deadline of the server's timing wheel, not computed meanwhile */
+    int bus; /* server bus channel the stream is sent to, -1 if none */
+    int packed; /* channels in data, one buffer after the other, 1 for a regular stream */
+    MYFLT busGain;
+    struct ParamEvent *params; /* parameter changes due in the current buffer */
+    StreamProfile *profile; /* NULL if not profiled */
+    size_t memory; /* heap bytes owned by the object besides data (delay lines, grains, analysis frames, ...) */
     MYFLT *data;
 } Stream;
 
@@ -44,19 +72,51 @@ extern int Stream_getBufferCountWait(Stream *self);
 extern int Stream_getDuration(Stream *self);
 extern int Stream_getStreamChnl(Stream *self);
 extern int Stream_getStreamToDac(Stream *self);
+extern int Stream_getPackedChannels(Stream *self);
 extern MYFLT * Stream_getData(Stream *self);
+/* Heap footprint of the object, data included, in bytes. */
+extern size_t Stream_getMemory(Stream *self);
 extern void Stream_setData(Stream * self, MYFLT *data);
 extern void Stream_setFunctionPtr(Stream *self, void *ptr);
 extern void Stream_callFunction(Stream *self);
+extern void Stream_callProfiled(Stream *self);
+extern void Stream_setProfiling(Stream *self, int on);
+/* Monotonic clock, in nanoseconds. */
+extern unsigned long long Stream_clock();
 extern void Stream_IncrementBufferCount(Stream *self);
 extern void Stream_IncrementDurationCount(Stream *self);
+extern void Stream_setSuspension(int on);
+extern int Stream_isSilent(Stream *self);
+extern int Stream_suspension;
 extern PyTypeObject StreamType;
 
+#define Stream_isControlRate(op) (((Stream *)(op))->krate)
+#define Stream_isConstant(op) (((Stream *)(op))->constant)
+#define Stream_getTriggers(op) (((Stream *)(op))->trigs)
+#define Stream_getNumTriggers(op) (((Stream *)(op))->numtrigs)
+#define Stream_isTimed(op) (((Stream *)(op))->timed)
+
 #define MAKE_NEW_STREAM(self, type, rt_error) \
   (self) = (Stream *)(type)->tp_alloc((type), 0); \
   if ((self) == rt_error) { return rt_error; } \
  \
   (self)->sid = (self)->chnl = (self)->todac = (self)->bufferCountWait = (self)->bufferCount = (self)->bufsize = (self)->duration = 0; \
+  (self)->pycall = (self)->shared = (self)->sink = (self)->suspended = 0; \
+  (self)->keep = (self)->silent = 0; \
+  (self)->tail = -1; \
+  (self)->quiet = 0; \
+  (self)->input = NULL; \
+  (self)->krate = 0; \
+  (self)->constant = 0; \
+  (self)->trigs = NULL; \
+  (self)->numtrigs = -1; \
+  (self)->timed = 0; \
+  (self)->bus = -1; \
+  (self)->packed = 1; \
+  (self)->busGain = 1.0; \
+  (self)->params = NULL; \
+  (self)->profile = NULL; \
+  (self)->memory = 0; \
   (self)->active = 1;
 
 
@@ -87,6 +147,18 @@ extern PyTypeObject TriggerStreamType;
 #define Stream_setBufferCountWait(op, v) (((Stream *)(op))->bufferCountWait = (v))
 #define Stream_setDuration(op, v) (((Stream *)(op))->duration = (v))
 #define Stream_setBufferSize(op, v) (((Stream *)(op))->bufsize = (v))
+#define Stream_setStreamPyCall(op, v) (((Stream *)(op))->pycall = (v))
+#define Stream_setStreamShared(op, v) (((Stream *)(op))->shared = (v))
+#define Stream_setStreamSink(op, v) (((Stream *)(op))->sink = (v))
+#define Stream_setPackedChannels(op, v) (((Stream *)(op))->packed = (v))
+#define Stream_setStreamKeep(op, v) (((Stream *)(op))->keep = (v))
+#define Stream_setTail(op, v) (((Stream *)(op))->tail = (v))
+#define Stream_setControlRate(op, v) (((Stream *)(op))->krate = (v))
+#define Stream_setConstant(op, v) (((Stream *)(op))->constant = (v))
+#define Stream_setTriggers(op, t, n) (((Stream *)(op))->trigs = (t), ((Stream *)(op))->numtrigs = (n))
+#define Stream_setTimed(op, v) (((Stream *)(op))->timed = (v))
+/* Objects owning buffers call it after each (re)allocation. */
+#define Stream_setMemory(op, v) (((Stream *)(op))->memory = (v))
 
 #endif
 /* __STREAMMODULE */
\ No newline at end of file
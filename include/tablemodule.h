@@ -21,6 +21,21 @@
 #include "Python.h"
 #include "pyomodule.h"
 
+/* Storage formats of the table samples. A table stored in a compact or paged
+ * format is read through TableStream_getSamples and TableInterp_get. For the
+ * other readers, TableStream_getData converts the samples to MYFLT, in a
+ * buffer kept by the TableStream and refreshed when the table grows. */
+#define TABLE_NATIVE 0  /* MYFLT */
+#define TABLE_FLOAT32 1 /* float, the native format of the single precision build */
+#define TABLE_INT16 2   /* short, full scale is 32768 */
+#define TABLE_PAGED 3   /* MYFLT **, directory of pages of TABLE_PAGE_SIZE samples */
+
+/* Pages of the growable tables. */
+#define TABLE_PAGE_BITS 16
+#define TABLE_PAGE_SIZE (1 << TABLE_PAGE_BITS)
+#define TABLE_PAGE_MASK (TABLE_PAGE_SIZE - 1)
+#define TABLE_PAGE_SAMPLE(pages, i) ((pages)[(i) >> TABLE_PAGE_BITS][(i) & TABLE_PAGE_MASK])
+
 #ifdef __TABLE_MODULE
 
 typedef struct {
@@ -28,6 +43,10 @@ typedef struct {
     int size;
     double samplingRate;
     MYFLT *data;
+    void *samples;      /* compact samples, owned by the table, NULL when `data` holds them */
+    int format;
+    MYFLT *expanded;    /* `samples` converted for TableStream_getData */
+    int expsize;        /* size of the table when `expanded` was made */
 } TableStream;
 
 
@@ -42,6 +61,9 @@ if ((self) == rt_error) { return rt_error; }	\
 int TableStream_getSize(PyObject *self);
 double TableStream_getSamplingRate(PyObject *self);
 MYFLT * TableStream_getData(PyObject *self);
+void * TableStream_getSamples(PyObject *self);
+int TableStream_getFormat(PyObject *self);
+void TableStream_readSamples(PyObject *self, long start, long num, MYFLT *out);
 extern PyTypeObject TableStreamType;
 
 #endif
\ No newline at end of file
@@ -0,0 +1,71 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef Py_TIMERWHEEL_H
+#define Py_TIMERWHEEL_H
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <Python.h>
+
+/* Hierarchical timing wheel.
+ *
+ * Objects waiting for a deadline (Pattern, CallAfter) register an event,
+ * embedded in the object, with the sample at which it is due. The wheel
+ * counts buffers: the first level holds the next 256 buffers, one slot each,
+ * and three coarser levels of 64 slots, cascaded in the first one as time
+ * goes by, hold the farther deadlines. Scheduling and cancelling are O(1),
+ * advancing costs one slot per buffer plus the due events.
+ *
+ * All the functions must be called with the lock protecting the streams (the
+ * GIL, or the dsp lock when the server runs without the GIL). */
+typedef void (*PyoTimerFunc)(PyObject *obj, unsigned long long time);
+
+typedef struct TimerEvent {
+    struct TimerEvent *next;
+    struct TimerEvent **pprev; /* NULL if the event is not scheduled */
+    unsigned long long time;   /* sample at which the event is due */
+    PyObject *obj;             /* borrowed, the object owns the event */
+    PyoTimerFunc func;
+} TimerEvent;
+
+typedef struct TimerWheel TimerWheel;
+
+#define TimerEvent_init(ev, o, f) \
+    ((ev)->next = NULL, (ev)->pprev = NULL, (ev)->time = 0, (ev)->obj = (PyObject *)(o), (ev)->func = (f))
+#define TimerEvent_isPending(ev) ((ev)->pprev != NULL)
+
+extern TimerWheel * TimerWheel_new(int bufsize);
+/* Pending events are unscheduled. */
+extern void TimerWheel_free(TimerWheel *self);
+/* Moves the event if it is already scheduled. An event due in a past buffer
+ * runs at the end of the current one. */
+extern void TimerWheel_schedule(TimerWheel *self, TimerEvent *ev, unsigned long long time);
+extern void TimerWheel_cancel(TimerEvent *ev);
+/* Called once at the end of each buffer, runs the events due in the buffer,
+ * in time order. Events may be scheduled or cancelled from their function. */
+extern void TimerWheel_advance(TimerWheel *self);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* !defined(Py_TIMERWHEEL_H) */
@@ -0,0 +1,48 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _VOICEPOOL_
+#define _VOICEPOOL_
+
+/* Pool of fixed-size records (grains, voices) shared by the objects of a
+ * kind.
+ *
+ * Records live in slabs that are never moved nor freed, so the audio threads
+ * take and give back records without any allocation: VoicePool_get and
+ * VoicePool_put are a lock-free stack, safe from concurrent worker threads.
+ * The objects reserve their share of records when they are created, on the
+ * python thread, and the pool grows there to cover the reservations. A
+ * record an object takes may come from the share of another one, idle
+ * objects lend their records to busy ones.
+ */
+typedef struct VoicePool VoicePool;
+
+/* Records of `size` bytes, at least `minimum` of them are always available. */
+extern VoicePool * VoicePool_new(int size, int minimum);
+/* Reserves `count` more records, allocating slabs if needed. Not from the
+ * audio thread. Returns -1 if the memory can't be allocated. */
+extern int VoicePool_reserve(VoicePool *self, int count);
+/* Gives back a reservation, the memory is kept for the next reservations. */
+extern void VoicePool_release(VoicePool *self, int count);
+/* From any thread. Returns NULL when all the records are in use. */
+extern void * VoicePool_get(VoicePool *self);
+extern void VoicePool_put(VoicePool *self, void *record);
+
+#endif
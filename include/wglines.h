@@ -0,0 +1,58 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#ifndef _WGLINES_
+#define _WGLINES_
+
+#include "pyomodule.h"
+
+/* The 8 delay lines of a waveguide network, as in WGVerb and STRev, one
+ * array per field. Each line reads at a jittered position and feeds a
+ * lowpass, the sum of the lowpasses comes back in every line (the
+ * junction) at the next sample. The lines of a network are processed
+ * together, one per lane of the vectors (see simd.h). */
+typedef struct {
+    MYFLT total_signal;
+    MYFLT delays[8];
+    long size[8];
+    int in_count[8];
+    MYFLT *buffer[8]; /* size + 1 samples, the last one repeats the first */
+    // sample memories
+    MYFLT lastSamples[8];
+    // jitters
+    MYFLT rnd[8];
+    MYFLT rnd_value[8];
+    MYFLT rnd_oldValue[8];
+    MYFLT rnd_diff[8];
+    MYFLT rnd_time[8];
+    MYFLT rnd_timeInc[8];
+    MYFLT rnd_range[8];
+    MYFLT rnd_halfRange[8];
+    PyoRand rng;
+} WGLines;
+
+/* Runs `nets` networks side by side, drawing their jitters in the same
+ * order as sample by sample. For each one, `inval`, `feed` and `damp` hold
+ * `num` values, `start` the values the sum of the lines starts from (NULL
+ * for 0) and `out` receives the sum scaled by 0.25. */
+extern void WGLines_process(WGLines *lines, int nets, MYFLT **inval, MYFLT **start, MYFLT **feed,
+                            MYFLT **damp, MYFLT **out, int num);
+
+#endif
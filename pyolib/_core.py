@@ -51,9 +51,9 @@ FUNCTIONS_INIT_LINES = {"pa_count_host_apis": "pa_count_host_apis()", "pa_list_h
                         "pm_get_default_output": "pm_get_default_output()", "pm_get_default_input": "pm_get_default_input()",
                         "pm_get_output_devices": "pm_get_output_devices()", "pm_get_input_devices": "pm_get_input_devices()",
                         "pm_list_devices": "pm_list_devices()", "pm_count_devices": "pm_count_devices()",
-                        "sndinfo": "sndinfo(path, print=False)", "savefile": "savefile(samples, path, sr=44100, channels=1, fileformat=0, sampletype=0)",
-                        "savefileFromTable": "savefileFromTable(table, path, fileformat=0, sampletype=0)",
-                        "upsamp": "upsamp(path, outfile, up=4, order=128)", "downsamp": "downsamp(path, outfile, down=4, order=128)",
+                        "sndinfo": "sndinfo(path, print=False)", "savefile": "savefile(samples, path, sr=44100, channels=1, fileformat=0, sampletype=0, background=False)",
+                        "savefileFromTable": "savefileFromTable(table, path, fileformat=0, sampletype=0, background=False)",
+                        "upsamp": "upsamp(path, outfile, up=4, order=128, quality=-1, threads=0)", "downsamp": "downsamp(path, outfile, down=4, order=128, quality=-1, threads=0)",
                         "midiToHz": "midiToHz(x)", "hzToMidi": "hzToMidi(x)", "midiToTranspo": "midiToTranspo(x)", "sampsToSec": "sampsToSec(x)",
                         "secToSamps": "secToSamps(x)", "linToCosCurve": "linToCosCurve(data, yrange=[0, 1], totaldur=1, points=1024, log=False)",
                         "rescale": "rescale(data, xmin=0.0, xmax=1.0, ymin=0.0, ymax=1.0, xlog=False, ylog=False)",
@@ -259,6 +259,17 @@ class PyoError(Exception):
 class PyoServerStateException(PyoError):
     """Error raised when an operation requires the server to be booted."""
 
+# Heap memory of a C object, whatever its kind.
+def _getBaseMemory(obj):
+    if hasattr(obj, "getTableStream"):
+        return obj.getTableStream().getMemory()
+    elif hasattr(obj, "getMatrixStream"):
+        return obj.getMatrixStream().getMemory()
+    elif hasattr(obj, "_getStream"):
+        return obj._getStream().getMemory()
+    return 0
+
+
 ######################################################################
 ### PyoObjectBase -> abstract class for pyo objects
 ######################################################################
@@ -316,6 +327,19 @@ class PyoObjectBase(object):
         """
         return self._base_objs
 
+    def getMemory(self):
+        """
+        Return the heap memory used by the object, in bytes.
+
+        Counts the audio buffers, delay lines, analysis frames, table
+        samples and matrix points owned by the streams of the object.
+
+        """
+        objs = list(self._base_objs)
+        if hasattr(self, "_base_players"):
+            objs.extend(self._base_players)
+        return sum([_getBaseMemory(obj) for obj in objs])
+
     def getServer(self):
         """
         Return a reference to the current Server object.
@@ -630,6 +654,55 @@ class PyoObject(PyoObjectBase):
         else:
             return self._base_objs[0]._getStream().isOutputting()
 
+    def setSink(self, x=True):
+        """
+        Keep the object computed when the server runs in pull mode.
+
+        In pull mode (see Server.setPullMode), objects that nothing sent to
+        the dac depends on are suspended. Objects with side effects (recorders,
+        callbacks) and objects read with the `get` method are always computed,
+        this method marks any other object whose output is used from python.
+
+        :Args:
+
+            x : boolean, optional
+                True to always compute the object. Defaults to True.
+
+        """
+        [obj._getStream().setSink(x) for obj in self._base_objs]
+
+    def send(self, bus, gain=1.0):
+        """
+        Send the signal to an internal bus of the server.
+
+        Streams are summed into the bus channels (stream `i` goes to the
+        channel `i % number of channels`), scaled by `gain`. BusIn objects
+        read the bus one buffer later, wherever they are created in the
+        processing chain. Sending to a bus doesn't stop the object from
+        being sent to the audio output with `out`.
+
+        This method returns `self`, allowing it to be applied at the object
+        creation.
+
+        :Args:
+
+            bus : string
+                Name of a bus created with Server.addBus. None stops sending.
+            gain : float or list of floats, optional
+                Amplitude of the signal sent to the bus. Defaults to 1.
+
+        """
+        if bus is None:
+            [obj._getStream().setBus(-1) for obj in self._base_objs]
+            return self
+        info = self.getServer().getBus(bus)
+        if info is None:
+            raise ValueError("Server has no bus named '%s'." % bus)
+        first, chnls = info
+        gain, lmax = convertArgsToLists(gain)
+        [obj._getStream().setBus(first + i % chnls, wrap(gain,i)) for i, obj in enumerate(self._base_objs)]
+        return self
+
     def get(self, all=False):
         """
         Return the first sample of the current buffer as a float.
@@ -845,6 +918,38 @@ class PyoObject(PyoObjectBase):
         x, lmax = convertArgsToLists(x)
         [obj.setDiv(wrap(x,i/self._op_duplicate)) for i, obj in enumerate(self._base_objs)]
 
+    def setAt(self, attr, value, time=None):
+        """
+        Replace any attribute at a given sample time.
+
+        The change is posted to the audio thread without waiting for the
+        current buffer to be computed. Float values given to `mul` and `add`
+        take effect at the exact sample, other changes take effect at the
+        beginning of the buffer containing `time`.
+
+        :Args:
+
+            attr : string
+                Name of the attribute as a string.
+            value : float or PyoObject
+                New value.
+            time : int, optional
+                Sample time, as returned by Server.getElapsedSamples(), of the
+                change. If None, or already elapsed, the change takes effect at
+                the beginning of the next buffer. Defaults to None.
+
+        """
+        if hasattr(self, "_" + attr):
+            setattr(self, "_" + attr, value)
+        if time == None:
+            time = 0
+        server = self.getServer()
+        value, lmax = convertArgsToLists(value)
+        if attr in ["mul", "add"]:
+            [server.setParamAt(obj, attr, wrap(value,i/self._op_duplicate), time) for i, obj in enumerate(self._base_objs)]
+        else:
+            [server.setParamAt(obj, attr, wrap(value,i), time) for i, obj in enumerate(self._base_objs)]
+
     def set(self, attr, value, port=0.025):
         """
         Replace any attribute with portamento.
@@ -952,7 +1057,7 @@ class PyoTableObject(PyoObjectBase):
         self.viewFrame = None
         self.graphFrame = None
 
-    def save(self, path, format=0, sampletype=0):
+    def save(self, path, format=0, sampletype=0, background=False):
         """
         Writes the content of the table in an audio file.
 
@@ -985,6 +1090,10 @@ class PyoTableObject(PyoObjectBase):
                     4. 64 bit float
                     5. U-Law encoded
                     6. A-Law encoded
+            background : boolean, optional
+                If True, the file is written by a background thread and
+                the method returns an export job at once. See
+                :py:func:`savefileFromTable`. Defaults to False.
 
         """
         ext = path.rsplit('.')
@@ -992,7 +1101,7 @@ class PyoTableObject(PyoObjectBase):
             ext = ext[-1].lower()
             if FILE_FORMATS.has_key(ext):
                 format = FILE_FORMATS[ext]
-        savefileFromTable(self, path, format, sampletype)
+        return savefileFromTable(self, path, format, sampletype, int(background))
 
     def write(self, path, oneline=True):
         """
@@ -1945,6 +2054,24 @@ class Sig(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setValue(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The value is read once per buffer, on its last sample when it is a
+        PyoObject, and reached by a linear ramp over the buffer. Biquad,
+        Biquadx and EQ controlled this way compute their coefficients once
+        per buffer, with mul and add left as floats.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0, 1, "lin", "value", self._value)]
         PyoObject.ctrl(self, map_list, title, wxnoserver)
@@ -2153,6 +2280,12 @@ class Wrap(PyoObject):
             Minimum possible value. Defaults to 0.
         max : float or PyoObject, optional
             Maximum possible value. Defaults to 1.
+        oversample : int, optional
+            Oversampling factor, 1, 2, 4 or 8. Above 1, the process runs
+            at this multiple of the sampling rate, between half-band
+            filters, which removes most of the aliasing of the harmonics
+            it creates. The filters delay the signal by about 32 samples.
+            Defaults to 1.
 
     .. note::
 
@@ -2171,14 +2304,15 @@ class Wrap(PyoObject):
     >>> b = SineLoop(300, feedback=.1, mul=amp2).out(1)
 
     """
-    def __init__(self, input, min=0.0, max=1.0, mul=1, add=0):
+    def __init__(self, input, min=0.0, max=1.0, oversample=1, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._min = min
         self._max = max
+        self._oversample = oversample
         self._in_fader = InputFader(input)
         in_fader, min, max, mul, add, lmax = convertArgsToLists(self._in_fader, min, max, mul, add)
-        self._base_objs = [Wrap_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Wrap_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), oversample, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -2223,6 +2357,19 @@ class Wrap(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setMax(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setOversample(self, x):
+        """
+        Replace the `oversample` attribute.
+
+        :Args:
+
+            x : int
+                New oversampling factor, 1, 2, 4 or 8.
+
+        """
+        self._oversample = x
+        [obj.setOversample(x) for obj in self._base_objs]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0., 1., 'lin', 'min', self._min),
                           SLMap(0., 1., 'lin', 'max', self._max),
@@ -2250,6 +2397,13 @@ class Wrap(PyoObject):
     @max.setter
     def max(self, x): self.setMax(x)
 
+    @property
+    def oversample(self):
+        """int. Oversampling factor."""
+        return self._oversample
+    @oversample.setter
+    def oversample(self, x): self.setOversample(x)
+
 class Compare(PyoObject):
     """
     Comparison object.
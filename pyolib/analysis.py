@@ -1458,4 +1458,284 @@ class PeakAmp(PyoObject):
         """PyoObject. function signal to process."""
         return self._function
     @function.setter
-    def function(self, x): self.setFunction(x)
\ No newline at end of file
+    def function(self, x): self.setFunction(x)
+class Features(PyoObject):
+    """
+    Multi-feature analysis of an input signal.
+
+    Features computes, in a single pass over the input, the same analysis
+    as Follower-like rms, PeakAmp, Centroid, ZCross and AttackDetector
+    objects attached to that input, with one FFT per input stream. Each
+    feature is published as its own set of streams:
+
+    - 'rms' : root-mean-square amplitude of each buffer.
+    - 'peak' : peak amplitude of each buffer.
+    - 'centroid' : spectral centroid, in Hz.
+    - 'zcross' : zero-crossings of each buffer, normalized between 0 and 1.
+    - 'onset' : a trigger on each detected onset.
+
+    rms, peak and zcross are held during the buffer following the one they
+    were computed on. The centroid is updated every half `size` samples.
+
+    :Parent: :py:class:`PyoObject`
+
+    :Args:
+
+        input : PyoObject
+            Input signal to process.
+        size : int, optional
+            Size, as a power-of-two, of the FFT used to compute the centroid.
+
+            Available at initialization time only.  Defaults to 1024.
+        thresh : float, optional
+            Minimum amplitude difference allowed between adjacent samples
+            to be included in the zeros count. Defaults to 0.
+        deltime : float, optional
+            Delay time, in seconds, between previous and current rms analysis
+            compared by the onset detector. Defaults to 0.005.
+        cutoff : float, optional
+            Cutoff frequency, in Hz, of the onset detector's amplitude follower.
+            Defaults to 10.
+        maxthresh : float, optional
+            Attack threshold in positive dB. Defaults to 3.0.
+        minthresh : float, optional
+            Minimum threshold in dB (signal must fall below this threshold to
+            allow a new onset to be detected). Defaults to -30.0.
+        reltime : float, optional
+            Time, in seconds, to wait before reporting a new onset. Defaults to 0.1.
+
+    .. note::
+
+        The out() method is bypassed. Features's signal can not be sent to
+        audio outs.
+
+        The user should call Features['rms'], Features['peak'],
+        Features['centroid'], Features['zcross'] or Features['onset']
+        to retrieve a feature.
+
+    >>> s = Server().boot()
+    >>> s.start()
+    >>> a = SfPlayer(SNDS_PATH + "/transparent.aif", loop=True, mul=.4).out()
+    >>> f = Features(a)
+    >>> c = Port(f['centroid'], 0.05, 0.05)
+    >>> n = ButBP(Noise(Port(f['rms'])), freq=c, q=5).out(1)
+
+    """
+    _features = ['rms', 'peak', 'centroid', 'zcross', 'onset']
+
+    def __init__(self, input, size=1024, thresh=0., deltime=0.005, cutoff=10, maxthresh=3, minthresh=-30,
+                 reltime=0.1, mul=1, add=0):
+        PyoObject.__init__(self, mul, add)
+        self._dummy = []
+        self._input = input
+        self._size = size
+        self._thresh = thresh
+        self._deltime = deltime
+        self._cutoff = cutoff
+        self._maxthresh = maxthresh
+        self._minthresh = minthresh
+        self._reltime = reltime
+        self._in_fader = InputFader(input)
+        in_fader, size, thresh, deltime, cutoff, maxthresh, minthresh, reltime, lmax = convertArgsToLists(self._in_fader,
+                                                            size, thresh, deltime, cutoff, maxthresh, minthresh, reltime)
+        mul, add, lmax2 = convertArgsToLists(mul, add)
+        self._base_players = [FeaturesMain_base(wrap(in_fader,i), wrap(size,i), wrap(thresh,i), wrap(deltime,i), wrap(cutoff,i),
+                                                wrap(maxthresh,i), wrap(minthresh,i), wrap(reltime,i)) for i in range(lmax)]
+        self._base_objs = []
+        for i in range(lmax):
+            for j in range(len(self._features)):
+                self._base_objs.append(Features_base(self._base_players[i], j, wrap(mul,i), wrap(add,i)))
+
+    def __getitem__(self, str):
+        if str in self._features:
+            index = self._features.index(str)
+            num = len(self._features)
+            self._dummy.append(Dummy([obj for i, obj in enumerate(self._base_objs) if (i % num) == index]))
+            return self._dummy[-1]
+        return PyoObject.__getitem__(self, str)
+
+    def get(self, identifier="rms", all=False):
+        """
+        Return the first sample of the current buffer as a float.
+
+        Can be used to convert audio stream to usable Python data.
+
+        "rms", "peak", "centroid", "zcross" or "onset" must be given to
+        `identifier` to specify which stream to get value from.
+
+        :Args:
+
+            identifier : string {"rms", "peak", "centroid", "zcross", "onset"}
+                Address string parameter identifying audio stream.
+                Defaults to "rms".
+            all : boolean, optional
+                If True, the first value of each object's stream
+                will be returned as a list. Otherwise, only the value
+                of the first object's stream will be returned as a float.
+                Defaults to False.
+
+        """
+        if not all:
+            return self.__getitem__(identifier)[0]._getStream().getValue()
+        else:
+            return [obj._getStream().getValue() for obj in self.__getitem__(identifier).getBaseObjects()]
+
+    def setInput(self, x, fadetime=0.05):
+        """
+        Replace the `input` attribute.
+
+        :Args:
+
+            x : PyoObject
+                New signal to process.
+            fadetime : float, optional
+                Crossfade time between old and new input. Default to 0.05.
+
+        """
+        self._input = x
+        self._in_fader.setInput(x, fadetime)
+
+    def setThresh(self, x):
+        """
+        Replace the `thresh` attribute.
+
+        :Args:
+
+            x : float
+                New amplitude difference threshold of the zeros count.
+
+        """
+        self._thresh = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setThresh(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def setDeltime(self, x):
+        """
+        Replace the `deltime` attribute.
+
+        :Args:
+
+            x : float
+                New delay between rms analysis.
+
+        """
+        self._deltime = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setDeltime(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def setCutoff(self, x):
+        """
+        Replace the `cutoff` attribute.
+
+        :Args:
+
+            x : float
+                New cutoff for the follower lowpass filter.
+
+        """
+        self._cutoff = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setCutoff(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def setMaxthresh(self, x):
+        """
+        Replace the `maxthresh` attribute.
+
+        :Args:
+
+            x : float
+                New attack threshold in dB.
+
+        """
+        self._maxthresh = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setMaxthresh(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def setMinthresh(self, x):
+        """
+        Replace the `minthresh` attribute.
+
+        :Args:
+
+            x : float
+                New minimum threshold in dB.
+
+        """
+        self._minthresh = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setMinthresh(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def setReltime(self, x):
+        """
+        Replace the `reltime` attribute.
+
+        :Args:
+
+            x : float
+                Time, in seconds, to wait before reporting a new onset.
+
+        """
+        self._reltime = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setReltime(wrap(x,i)) for i, obj in enumerate(self._base_players)]
+
+    def out(self, chnl=0, inc=1, dur=0, delay=0):
+        return self.play(dur, delay)
+
+    def ctrl(self, map_list=None, title=None, wxnoserver=False):
+        self._map_list = [SLMap(0., 0.5, 'lin', 'thresh', self._thresh, dataOnly=True),
+                          SLMap(0.001, 0.05, 'lin', 'deltime', self._deltime, dataOnly=True),
+                          SLMap(1.0, 1000.0, 'log', 'cutoff', self._cutoff, dataOnly=True),
+                          SLMap(0.0, 18.0, 'lin', 'maxthresh', self._maxthresh, dataOnly=True),
+                          SLMap(-90.0, 0.0, 'lin', 'minthresh', self._minthresh, dataOnly=True),
+                          SLMap(0.001, 1.0, 'log', 'reltime', self._reltime, dataOnly=True)]
+        PyoObject.ctrl(self, map_list, title, wxnoserver)
+
+    @property
+    def input(self):
+        """PyoObject. Input signal to process."""
+        return self._input
+    @input.setter
+    def input(self, x): self.setInput(x)
+
+    @property
+    def thresh(self):
+        """float. Amplitude difference threshold of the zeros count."""
+        return self._thresh
+    @thresh.setter
+    def thresh(self, x): self.setThresh(x)
+
+    @property
+    def deltime(self):
+        """float. Delay between rms analysis."""
+        return self._deltime
+    @deltime.setter
+    def deltime(self, x): self.setDeltime(x)
+
+    @property
+    def cutoff(self):
+        """float. Cutoff for the follower lowpass filter."""
+        return self._cutoff
+    @cutoff.setter
+    def cutoff(self, x): self.setCutoff(x)
+
+    @property
+    def maxthresh(self):
+        """float. Attack threshold in dB."""
+        return self._maxthresh
+    @maxthresh.setter
+    def maxthresh(self, x): self.setMaxthresh(x)
+
+    @property
+    def minthresh(self):
+        """float. Minimum threshold in dB."""
+        return self._minthresh
+    @minthresh.setter
+    def minthresh(self, x): self.setMinthresh(x)
+
+    @property
+    def reltime(self):
+        """float. Time to wait before reporting a new onset."""
+        return self._reltime
+    @reltime.setter
+    def reltime(self, x): self.setReltime(x)
@@ -761,6 +761,23 @@ class SigTo(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setTime(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The ramp advances one buffer at a time, interpolated linearly over
+        the buffer, which lets the filters it controls compute their
+        coefficients once per buffer.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0, 10, 'lin', 'time', self._time, dataOnly=True)]
         PyoObject.ctrl(self, map_list, title, wxnoserver)
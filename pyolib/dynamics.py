@@ -25,6 +25,20 @@ License along with pyo.  If not, see <http://www.gnu.org/licenses/>.
 from _core import *
 from _maps import *
 
+def _detector(input, sidechain, link):
+    """
+    Signal followed by the envelope detectors of Compress and Gate: the
+    sidechain, or the input, averaged over its channels when linked. None
+    when the detectors follow their own channel of the input.
+
+    """
+    if sidechain is None and not link:
+        return None
+    src = input if sidechain is None else sidechain
+    if link:
+        src = Mix(src, voices=1, mul=1.0/len(src))
+    return src
+
 class Clip(PyoObject):
     """
     Clips a signal to a predefined limit.
@@ -39,6 +53,12 @@ class Clip(PyoObject):
             Minimum possible value. Defaults to -1.
         max : float or PyoObject, optional
             Maximum possible value. Defaults to 1.
+        oversample : int, optional
+            Oversampling factor, 1, 2, 4 or 8. Above 1, the process runs
+            at this multiple of the sampling rate, between half-band
+            filters, which removes most of the aliasing of the harmonics
+            it creates. The filters delay the signal by about 32 samples.
+            Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -48,14 +68,15 @@ class Clip(PyoObject):
     >>> c = Clip(a, min=lfodown, max=lfoup, mul=.4).mix(2).out()
 
     """
-    def __init__(self, input, min=-1.0, max=1.0, mul=1, add=0):
+    def __init__(self, input, min=-1.0, max=1.0, oversample=1, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._min = min
         self._max = max
+        self._oversample = oversample
         self._in_fader = InputFader(input)
         in_fader, min, max, mul, add, lmax = convertArgsToLists(self._in_fader, min, max, mul, add)
-        self._base_objs = [Clip_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Clip_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), oversample, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -100,6 +121,19 @@ class Clip(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setMax(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setOversample(self, x):
+        """
+        Replace the `oversample` attribute.
+
+        :Args:
+
+            x : int
+                New oversampling factor, 1, 2, 4 or 8.
+
+        """
+        self._oversample = x
+        [obj.setOversample(x) for obj in self._base_objs]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(-1., 0., 'lin', 'min', self._min),
                           SLMap(0., 1., 'lin', 'max', self._max),
@@ -127,6 +161,13 @@ class Clip(PyoObject):
     @max.setter
     def max(self, x): self.setMax(x)
 
+    @property
+    def oversample(self):
+        """int. Oversampling factor."""
+        return self._oversample
+    @oversample.setter
+    def oversample(self, x): self.setOversample(x)
+
 class Mirror(PyoObject):
     """
     Reflects the signal that exceeds the `min` and `max` thresholds.
@@ -144,6 +185,12 @@ class Mirror(PyoObject):
             Minimum possible value. Defaults to 0.
         max : float or PyoObject, optional
             Maximum possible value. Defaults to 1.
+        oversample : int, optional
+            Oversampling factor, 1, 2, 4 or 8. Above 1, the process runs
+            at this multiple of the sampling rate, between half-band
+            filters, which removes most of the aliasing of the harmonics
+            it creates. The filters delay the signal by about 32 samples.
+            Defaults to 1.
 
     .. note::
 
@@ -158,14 +205,15 @@ class Mirror(PyoObject):
     >>> c = Tone(b, freq=2500, mul=.15).out()
 
     """
-    def __init__(self, input, min=0.0, max=1.0, mul=1, add=0):
+    def __init__(self, input, min=0.0, max=1.0, oversample=1, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._min = min
         self._max = max
+        self._oversample = oversample
         self._in_fader = InputFader(input)
         in_fader, min, max, mul, add, lmax = convertArgsToLists(self._in_fader, min, max, mul, add)
-        self._base_objs = [Mirror_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Mirror_base(wrap(in_fader,i), wrap(min,i), wrap(max,i), oversample, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -210,6 +258,19 @@ class Mirror(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setMax(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setOversample(self, x):
+        """
+        Replace the `oversample` attribute.
+
+        :Args:
+
+            x : int
+                New oversampling factor, 1, 2, 4 or 8.
+
+        """
+        self._oversample = x
+        [obj.setOversample(x) for obj in self._base_objs]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0., 1., 'lin', 'min', self._min),
                           SLMap(0., 1., 'lin', 'max', self._max),
@@ -237,6 +298,13 @@ class Mirror(PyoObject):
     @max.setter
     def max(self, x): self.setMax(x)
 
+    @property
+    def oversample(self):
+        """int. Oversampling factor."""
+        return self._oversample
+    @oversample.setter
+    def oversample(self, x): self.setOversample(x)
+
 class Degrade(PyoObject):
     """
     Signal quality reducer.
@@ -256,6 +324,12 @@ class Degrade(PyoObject):
         srscale : float or PyoObject, optional
             Sampling rate multiplier. Must be in range 0.0009765625 -> 1.
             Defaults to 1.
+        oversample : int, optional
+            Oversampling factor, 1, 2, 4 or 8. Above 1, the samples are
+            held and quantized at this multiple of the sampling rate,
+            between half-band filters, so that the steps of the output
+            are band-limited. The filters delay the signal by about 32
+            samples. Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -266,14 +340,15 @@ class Degrade(PyoObject):
     >>> b = Degrade(a, bitdepth=lfo, srscale=lfo2, mul=.3).out()
 
     """
-    def __init__(self, input, bitdepth=16, srscale=1.0, mul=1, add=0):
+    def __init__(self, input, bitdepth=16, srscale=1.0, oversample=1, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._bitdepth = bitdepth
         self._srscale = srscale
+        self._oversample = oversample
         self._in_fader = InputFader(input)
         in_fader, bitdepth, srscale, mul, add, lmax = convertArgsToLists(self._in_fader, bitdepth, srscale, mul, add)
-        self._base_objs = [Degrade_base(wrap(in_fader,i), wrap(bitdepth,i), wrap(srscale,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Degrade_base(wrap(in_fader,i), wrap(bitdepth,i), wrap(srscale,i), oversample, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -318,6 +393,19 @@ class Degrade(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setSrscale(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setOversample(self, x):
+        """
+        Replace the `oversample` attribute.
+
+        :Args:
+
+            x : int
+                New oversampling factor, 1, 2, 4 or 8.
+
+        """
+        self._oversample = x
+        [obj.setOversample(x) for obj in self._base_objs]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(1., 32., 'log', 'bitdepth', self._bitdepth),
                           SLMap(0.0009765625, 1., 'log', 'srscale', self._srscale),
@@ -345,6 +433,13 @@ class Degrade(PyoObject):
     @srscale.setter
     def srscale(self, x): self.setSrscale(x)
 
+    @property
+    def oversample(self):
+        """int. Oversampling factor."""
+        return self._oversample
+    @oversample.setter
+    def oversample(self, x): self.setOversample(x)
+
 class Compress(PyoObject):
     """
     Reduces the dynamic range of an audio signal.
@@ -387,6 +482,14 @@ class Compress(PyoObject):
             compression slope. Defaults to False.
 
             Available at initialization only.
+        sidechain : PyoObject, optional
+            Signal followed by the envelope detector instead of the input.
+            Its channels are wrapped over the channels of the input.
+            Defaults to None.
+        link : boolean, optional
+            If True, all channels follow the average of the channels of
+            the sidechain (or of the input without sidechain), so they
+            share the same compression slope. Defaults to False.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -394,7 +497,8 @@ class Compress(PyoObject):
     >>> b = Compress(a, thresh=-24, ratio=6, risetime=.01, falltime=.2, knee=0.5).mix(2).out()
 
     """
-    def __init__(self, input, thresh=-20, ratio=2, risetime=0.01, falltime=0.1, lookahead=5.0, knee=0, outputAmp=False, mul=1, add=0):
+    def __init__(self, input, thresh=-20, ratio=2, risetime=0.01, falltime=0.1, lookahead=5.0, knee=0, outputAmp=False,
+                 sidechain=None, link=False, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._thresh = thresh
@@ -403,9 +507,12 @@ class Compress(PyoObject):
         self._falltime = falltime
         self._lookahead = lookahead
         self._knee = knee
+        self._sidechain = sidechain
+        self._link = link
         self._in_fader = InputFader(input)
         in_fader, thresh, ratio, risetime, falltime, lookahead, knee, outputAmp, mul, add, lmax = convertArgsToLists(self._in_fader, thresh, ratio, risetime, falltime, lookahead, knee, outputAmp, mul, add)
-        self._base_objs = [Compress_base(wrap(in_fader,i), wrap(thresh,i), wrap(ratio,i), wrap(risetime,i), wrap(falltime,i), wrap(lookahead,i), wrap(knee,i), wrap(outputAmp,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Compress_base(wrap(in_fader,i), wrap(thresh,i), wrap(ratio,i), wrap(risetime,i), wrap(falltime,i), wrap(lookahead,i), wrap(knee,i), wrap(outputAmp,i), None, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._setDetector()
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -492,6 +599,40 @@ class Compress(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setLookAhead(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def _setDetector(self):
+        self._detector = _detector(self._in_fader, self._sidechain, self._link)
+        if self._detector is None:
+            [obj.setSidechain(None) for obj in self._base_objs]
+        else:
+            [obj.setSidechain(wrap(self._detector,i)) for i, obj in enumerate(self._base_objs)]
+
+    def setSidechain(self, x):
+        """
+        Replace the `sidechain` attribute.
+
+        :Args:
+
+            x : PyoObject
+                New signal followed by the envelope detector, None
+                to follow the input.
+
+        """
+        self._sidechain = x
+        self._setDetector()
+
+    def setLink(self, x):
+        """
+        Replace the `link` attribute.
+
+        :Args:
+
+            x : boolean
+                If True, all channels follow the average of the channels.
+
+        """
+        self._link = x
+        self._setDetector()
+
     def setKnee(self, x):
         """
         Replace the `knee` attribute.
@@ -565,6 +706,20 @@ class Compress(PyoObject):
     @knee.setter
     def knee(self, x): self.setKnee(x)
 
+    @property
+    def sidechain(self):
+        """PyoObject. Signal followed by the envelope detector."""
+        return self._sidechain
+    @sidechain.setter
+    def sidechain(self, x): self.setSidechain(x)
+
+    @property
+    def link(self):
+        """boolean. Channels follow the average of the channels."""
+        return self._link
+    @link.setter
+    def link(self, x): self.setLink(x)
+
 class Gate(PyoObject):
     """
     Allows a signal to pass only when its amplitude is above a set threshold.
@@ -599,6 +754,14 @@ class Gate(PyoObject):
             same gating slope. Defaults to False.
 
             Available at initialization only.
+        sidechain : PyoObject, optional
+            Signal followed by the envelope detector instead of the input.
+            Its channels are wrapped over the channels of the input.
+            Defaults to None.
+        link : boolean, optional
+            If True, all channels follow the average of the channels of
+            the sidechain (or of the input without sidechain), so they
+            share the same gating slope. Defaults to False.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -606,16 +769,20 @@ class Gate(PyoObject):
     >>> gt = Gate(sf, thresh=-24, risetime=0.005, falltime=0.01, lookahead=5, mul=.4).out()
 
     """
-    def __init__(self, input, thresh=-70, risetime=0.01, falltime=0.05, lookahead=5.0, outputAmp=False, mul=1, add=0):
+    def __init__(self, input, thresh=-70, risetime=0.01, falltime=0.05, lookahead=5.0, outputAmp=False, sidechain=None,
+                 link=False, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._thresh = thresh
         self._risetime = risetime
         self._falltime = falltime
         self._lookahead = lookahead
+        self._sidechain = sidechain
+        self._link = link
         self._in_fader = InputFader(input)
         in_fader, thresh, risetime, falltime, lookahead, outputAmp, mul, add, lmax = convertArgsToLists(self._in_fader, thresh, risetime, falltime, lookahead, outputAmp, mul, add)
-        self._base_objs = [Gate_base(wrap(in_fader,i), wrap(thresh,i), wrap(risetime,i), wrap(falltime,i), wrap(lookahead,i), wrap(outputAmp,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Gate_base(wrap(in_fader,i), wrap(thresh,i), wrap(risetime,i), wrap(falltime,i), wrap(lookahead,i), wrap(outputAmp,i), None, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._setDetector()
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -688,6 +855,40 @@ class Gate(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setLookAhead(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def _setDetector(self):
+        self._detector = _detector(self._in_fader, self._sidechain, self._link)
+        if self._detector is None:
+            [obj.setSidechain(None) for obj in self._base_objs]
+        else:
+            [obj.setSidechain(wrap(self._detector,i)) for i, obj in enumerate(self._base_objs)]
+
+    def setSidechain(self, x):
+        """
+        Replace the `sidechain` attribute.
+
+        :Args:
+
+            x : PyoObject
+                New signal followed by the envelope detector, None
+                to follow the input.
+
+        """
+        self._sidechain = x
+        self._setDetector()
+
+    def setLink(self, x):
+        """
+        Replace the `link` attribute.
+
+        :Args:
+
+            x : boolean
+                If True, all channels follow the average of the channels.
+
+        """
+        self._link = x
+        self._setDetector()
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(-100., 0., 'lin', 'thresh',  self._thresh),
                           SLMap(0.0001, .3, 'lin', 'risetime',  self._risetime),
@@ -731,6 +932,20 @@ class Gate(PyoObject):
     @lookahead.setter
     def lookahead(self, x): self.setLookAhead(x)
 
+    @property
+    def sidechain(self):
+        """PyoObject. Signal followed by the envelope detector."""
+        return self._sidechain
+    @sidechain.setter
+    def sidechain(self, x): self.setSidechain(x)
+
+    @property
+    def link(self):
+        """boolean. Channels follow the average of the channels."""
+        return self._link
+    @link.setter
+    def link(self, x): self.setLink(x)
+
 class Balance(PyoObject):
     """
     Adjust rms power of an audio signal according to the rms power of another.
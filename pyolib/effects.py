@@ -46,6 +46,12 @@ class Disto(PyoObject):
         slope : float or PyoObject, optional
             Slope of the lowpass filter applied after distortion,
             between 0 and 1. Defaults to 0.5.
+        oversample : int, optional
+            Oversampling factor, 1, 2, 4 or 8. Above 1, the process runs
+            at this multiple of the sampling rate, between half-band
+            filters, which removes most of the aliasing of the harmonics
+            it creates. The filters delay the signal by about 32 samples.
+            Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -54,14 +60,15 @@ class Disto(PyoObject):
     >>> d = Disto(a, drive=lfo, slope=.8, mul=.15).out()
 
     """
-    def __init__(self, input, drive=.75, slope=.5, mul=1, add=0):
+    def __init__(self, input, drive=.75, slope=.5, oversample=1, mul=1, add=0):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._drive = drive
         self._slope = slope
+        self._oversample = oversample
         self._in_fader = InputFader(input)
         in_fader, drive, slope, mul, add, lmax = convertArgsToLists(self._in_fader, drive, slope, mul, add)
-        self._base_objs = [Disto_base(wrap(in_fader,i), wrap(drive,i), wrap(slope,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        self._base_objs = [Disto_base(wrap(in_fader,i), wrap(drive,i), wrap(slope,i), oversample, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -106,6 +113,19 @@ class Disto(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setSlope(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setOversample(self, x):
+        """
+        Replace the `oversample` attribute.
+
+        :Args:
+
+            x : int
+                New oversampling factor, 1, 2, 4 or 8.
+
+        """
+        self._oversample = x
+        [obj.setOversample(x) for obj in self._base_objs]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0., 1., 'lin', 'drive', self._drive),
                           SLMap(0., 0.999, 'lin', 'slope', self._slope),
@@ -133,6 +153,13 @@ class Disto(PyoObject):
     @slope.setter
     def slope(self, x): self.setSlope(x)
 
+    @property
+    def oversample(self):
+        """int. Oversampling factor."""
+        return self._oversample
+    @oversample.setter
+    def oversample(self, x): self.setOversample(x)
+
 class Delay(PyoObject):
     """
     Sweepable recursive delay.
@@ -151,6 +178,13 @@ class Delay(PyoObject):
         maxdelay : float, optional
             Maximum delay length in seconds. Available only at initialization.
             Defaults to 1.
+        multi : boolean, optional
+            If True, a single object delays all the streams, with one
+            memory for all the delay lines, read with SIMD instructions when
+            they share the same constant delay time. Faster when there are
+            many streams. The streams can't be controlled individually with
+            `play`, `stop` or `out` delays. Available at initialization time
+            only. Defaults to False.
 
     .. note::
 
@@ -169,15 +203,21 @@ class Delay(PyoObject):
     >>> d = Delay(a, delay=[.15,.2], feedback=.5, mul=.4).out()
 
     """
-    def __init__(self, input, delay=0.25, feedback=0, maxdelay=1, mul=1, add=0):
+    def __init__(self, input, delay=0.25, feedback=0, maxdelay=1, mul=1, add=0, multi=False):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._delay = delay
         self._feedback = feedback
         self._maxdelay = maxdelay
+        self._multi = multi
         self._in_fader = InputFader(input)
         in_fader, delay, feedback, maxdelay, mul, add, lmax = convertArgsToLists(self._in_fader, delay, feedback, maxdelay, mul, add)
-        self._base_objs = [Delay_base(wrap(in_fader,i), wrap(delay,i), wrap(feedback,i), wrap(maxdelay,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        if multi:
+            self._base_players = [MultiDelayMain_base(lmax, [wrap(in_fader,i) for i in range(lmax)], [wrap(delay,i) for i in range(lmax)],
+                                                      [wrap(feedback,i) for i in range(lmax)], max(maxdelay))]
+            self._base_objs = [PackedChannel_base(self._base_players[0], i, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        else:
+            self._base_objs = [Delay_base(wrap(in_fader,i), wrap(delay,i), wrap(feedback,i), wrap(maxdelay,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -206,7 +246,10 @@ class Delay(PyoObject):
         """
         self._delay = x
         x, lmax = convertArgsToLists(x)
-        [obj.setDelay(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setDelay([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setDelay(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setFeedback(self, x):
         """
@@ -220,14 +263,20 @@ class Delay(PyoObject):
         """
         self._feedback = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFeedback(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setFeedback([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFeedback(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def reset(self):
         """
         Reset the memory buffer to zeros.
 
         """
-        [obj.reset() for obj in self._base_objs]
+        if self._multi:
+            self._base_players[0].reset()
+        else:
+            [obj.reset() for obj in self._base_objs]
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0.001, self._maxdelay, 'log', 'delay',  self._delay),
@@ -754,8 +803,13 @@ class Convolve(PyoObject):
 
     .. note::
 
-        Convolution is very expensive to compute, so the impulse response must
-        be kept very short to run in real time.
+        With a power-of-two buffer size and a `size` of 128 or more, the
+        convolution is computed by blocks in the frequency domain, which allows
+        much longer impulse responses. When the samples of the table change,
+        the spectra of the impulse response are computed again, at the cost of
+        one fft per buffer size of impulse. Otherwise, convolution is very
+        expensive to compute and the impulse response must be kept very short
+        to run in real time.
 
         Usually convolution generates a high amplitude level, take care of the
         `mul` parameter!
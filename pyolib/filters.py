@@ -60,6 +60,18 @@ class Biquad(PyoObject):
                 2. bandpass
                 3. bandstop
                 4. allpass
+        decimation : int, optional
+            Coefficients update period, in samples, used when freq or q are
+            audio signals. Above 1, the coefficients are computed with a
+            fast sine approximation and linearly interpolated in between,
+            8 or 16 make a slowly modulated filter much cheaper. 1 computes
+            them exactly at every sample. Defaults to 1.
+        multi : boolean, optional
+            If True, a single object filters all the streams, running
+            several filters at once with SIMD instructions, which is faster
+            when there are many of them. The streams can't be controlled
+            individually with `play`, `stop` or `out` delays. Available at
+            initialization time only. Defaults to False.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -68,15 +80,22 @@ class Biquad(PyoObject):
     >>> f = Biquad(a, freq=lfo, q=5, type=2).out()
 
     """
-    def __init__(self, input, freq=1000, q=1, type=0, mul=1, add=0):
+    def __init__(self, input, freq=1000, q=1, type=0, mul=1, add=0, decimation=1, multi=False):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._freq = freq
         self._q = q
         self._type = type
+        self._decimation = decimation
+        self._multi = multi
         self._in_fader = InputFader(input)
-        in_fader, freq, q, type, mul, add, lmax = convertArgsToLists(self._in_fader, freq, q, type, mul, add)
-        self._base_objs = [Biquad_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        in_fader, freq, q, type, mul, add, decimation, lmax = convertArgsToLists(self._in_fader, freq, q, type, mul, add, decimation)
+        if multi:
+            self._base_players = [MultiBiquadMain_base(lmax, [wrap(in_fader,i) for i in range(lmax)], [wrap(freq,i) for i in range(lmax)],
+                                                       [wrap(q,i) for i in range(lmax)], [wrap(type,i) for i in range(lmax)], wrap(decimation,0))]
+            self._base_objs = [PackedChannel_base(self._base_players[0], i, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        else:
+            self._base_objs = [Biquad_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(mul,i), wrap(add,i), wrap(decimation,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -105,7 +124,10 @@ class Biquad(PyoObject):
         """
         self._freq = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setFreq([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setQ(self, x):
         """
@@ -119,7 +141,10 @@ class Biquad(PyoObject):
         """
         self._q = x
         x, lmax = convertArgsToLists(x)
-        [obj.setQ(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setQ([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setQ(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setType(self, x):
         """
@@ -138,7 +163,27 @@ class Biquad(PyoObject):
         """
         self._type = x
         x, lmax = convertArgsToLists(x)
-        [obj.setType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setType([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
+    def setDecimation(self, x):
+        """
+        Replace the `decimation` attribute.
+
+        :Args:
+
+            x : int
+                New `decimation` attribute.
+
+        """
+        self._decimation = x
+        x, lmax = convertArgsToLists(x)
+        if self._multi:
+            self._base_players[0].setDecimation(wrap(x,0))
+        else:
+            [obj.setDecimation(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapFreq(self._freq), SLMapQ(self._q),
@@ -174,6 +219,13 @@ class Biquad(PyoObject):
     @type.setter
     def type(self, x): self.setType(x)
 
+    @property
+    def decimation(self):
+        """int. Coefficients update period for audio rate parameters."""
+        return self._decimation
+    @decimation.setter
+    def decimation(self, x): self.setDecimation(x)
+
 class Biquadx(PyoObject):
     """
     A multi-stages sweepable general purpose biquadratic digital filter.
@@ -203,6 +255,12 @@ class Biquadx(PyoObject):
                 4. allpass
         stages : int, optional
             The number of filtering stages in the filter stack. Defaults to 4.
+        decimation : int, optional
+            Coefficients update period, in samples, used when freq or q are
+            audio signals. Above 1, the coefficients are computed with a
+            fast sine approximation and linearly interpolated in between,
+            8 or 16 make a slowly modulated filter much cheaper. 1 computes
+            them exactly at every sample. Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -211,16 +269,17 @@ class Biquadx(PyoObject):
     >>> f = Biquadx(a, freq=lfo, q=5, type=2).out()
 
     """
-    def __init__(self, input, freq=1000, q=1, type=0, stages=4, mul=1, add=0):
+    def __init__(self, input, freq=1000, q=1, type=0, stages=4, mul=1, add=0, decimation=1):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._freq = freq
         self._q = q
         self._type = type
         self._stages = stages
+        self._decimation = decimation
         self._in_fader = InputFader(input)
-        in_fader, freq, q, type, stages, mul, add, lmax = convertArgsToLists(self._in_fader, freq, q, type, stages, mul, add)
-        self._base_objs = [Biquadx_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(stages,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        in_fader, freq, q, type, stages, mul, add, decimation, lmax = convertArgsToLists(self._in_fader, freq, q, type, stages, mul, add, decimation)
+        self._base_objs = [Biquadx_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(stages,i), wrap(mul,i), wrap(add,i), wrap(decimation,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -298,6 +357,20 @@ class Biquadx(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setStages(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setDecimation(self, x):
+        """
+        Replace the `decimation` attribute.
+
+        :Args:
+
+            x : int
+                New `decimation` attribute.
+
+        """
+        self._decimation = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setDecimation(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapFreq(self._freq), SLMapQ(self._q),
                           SLMap(0, 4, 'lin', 'type', self._type, res="int", dataOnly=True),
@@ -339,6 +412,13 @@ class Biquadx(PyoObject):
     @stages.setter
     def stages(self, x): self.setStages(x)
 
+    @property
+    def decimation(self):
+        """int. Coefficients update period for audio rate parameters."""
+        return self._decimation
+    @decimation.setter
+    def decimation(self, x): self.setDecimation(x)
+
 class Biquada(PyoObject):
     """
     A general purpose biquadratic digital filter (floating-point arguments).
@@ -590,6 +670,12 @@ class EQ(PyoObject):
                 0. peak/notch (default)
                 1. lowshelf
                 2. highshelf
+        decimation : int, optional
+            Coefficients update period, in samples, used when freq, q or
+            boost are audio signals. Above 1, the coefficients are computed with a
+            fast sine approximation and linearly interpolated in between,
+            8 or 16 make a slowly modulated filter much cheaper. 1 computes
+            them exactly at every sample. Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -600,16 +686,17 @@ class EQ(PyoObject):
     >>> out = EQ(src, freq=fr, q=1, boost=boo, type=0).out()
 
     """
-    def __init__(self, input, freq=1000, q=1, boost=-3.0, type=0, mul=1, add=0):
+    def __init__(self, input, freq=1000, q=1, boost=-3.0, type=0, mul=1, add=0, decimation=1):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._freq = freq
         self._q = q
         self._boost = boost
         self._type = type
+        self._decimation = decimation
         self._in_fader = InputFader(input)
-        in_fader, freq, q, boost, type, mul, add, lmax = convertArgsToLists(self._in_fader, freq, q, boost, type, mul, add)
-        self._base_objs = [EQ_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(boost,i), wrap(type,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        in_fader, freq, q, boost, type, mul, add, decimation, lmax = convertArgsToLists(self._in_fader, freq, q, boost, type, mul, add, decimation)
+        self._base_objs = [EQ_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(boost,i), wrap(type,i), wrap(mul,i), wrap(add,i), wrap(decimation,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -685,6 +772,20 @@ class EQ(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setDecimation(self, x):
+        """
+        Replace the `decimation` attribute.
+
+        :Args:
+
+            x : int
+                New `decimation` attribute.
+
+        """
+        self._decimation = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setDecimation(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapFreq(self._freq), SLMapQ(self._q),
                           SLMap(-40.0, 40.0, "lin", "boost", self._boost),
@@ -727,6 +828,13 @@ class EQ(PyoObject):
     @type.setter
     def type(self, x): self.setType(x)
 
+    @property
+    def decimation(self):
+        """int. Coefficients update period for audio rate parameters."""
+        return self._decimation
+    @decimation.setter
+    def decimation(self, x): self.setDecimation(x)
+
 class Tone(PyoObject):
     """
     A first-order recursive low-pass filter with variable frequency response.
@@ -961,6 +1069,23 @@ class Port(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setFallTime(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The portamento follows the last sample of each input buffer and is
+        computed once per buffer, then interpolated linearly. Meant for
+        control signals, not for smoothing audio.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0.001, 10., 'lin', 'risetime', self._risetime),
                           SLMap(0.001, 10., 'lin', 'falltime', self._falltime)]
@@ -2040,8 +2165,11 @@ class IRWinSinc(PyoObject):
 
     .. note::
 
-        Convolution is very expensive to compute, so the length of the impulse
-        response (the `order` parameter) must be kept very short to run in real time.
+        With a power-of-two buffer size and an `order` of 128 or more, the
+        convolution is computed by blocks in the frequency domain, which allows
+        much longer impulse responses. Otherwise, convolution is very expensive
+        to compute and the length of the impulse response (the `order` parameter)
+        must be kept very short to run in real time.
 
         Note that although `freq` and `bw` can be PyoObjects, the impulse response of
         the filter is only updated once per buffer size.
@@ -2190,8 +2318,11 @@ class IRAverage(PyoObject):
 
     .. note::
 
-        Convolution is very expensive to compute, so the length of the impulse
-        response (the `order` parameter) must be kept very short to run in real time.
+        With a power-of-two buffer size and an `order` of 128 or more, the
+        convolution is computed by blocks in the frequency domain, which allows
+        much longer impulse responses. Otherwise, convolution is very expensive
+        to compute and the length of the impulse response (the `order` parameter)
+        must be kept very short to run in real time.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -2270,8 +2401,11 @@ class IRPulse(PyoObject):
 
     .. note::
 
-        Convolution is very expensive to compute, so the length of the impulse
-        response (the `order` parameter) must be kept very short to run in real time.
+        With a power-of-two buffer size and an `order` of 128 or more, the
+        convolution is computed by blocks in the frequency domain, which allows
+        much longer impulse responses. Otherwise, convolution is very expensive
+        to compute and the length of the impulse response (the `order` parameter)
+        must be kept very short to run in real time.
 
         Note that although `freq` and `bw` can be PyoObjects, the impulse response of
         the filter is only updated once per buffer size.
@@ -2423,8 +2557,11 @@ class IRFM(PyoObject):
 
     .. note::
 
-        Convolution is very expensive to compute, so the length of the impulse
-        response (the `order` parameter) must be kept very short to run in real time.
+        With a power-of-two buffer size and an `order` of 128 or more, the
+        convolution is computed by blocks in the frequency domain, which allows
+        much longer impulse responses. Otherwise, convolution is very expensive
+        to compute and the length of the impulse response (the `order` parameter)
+        must be kept very short to run in real time.
 
         Note that although `carrier`, `ratio` and `index` can be PyoObjects, the
         impulse response of the filter is only updated once per buffer size.
@@ -2566,6 +2703,12 @@ class SVF(PyoObject):
             - 0.0 = lowpass (default)
             - 0.5 = bandpass
             - 1.0 = highpass
+        decimation : int, optional
+            Coefficients update period, in samples, used when freq is an
+            audio signal. Above 1, the coefficients are computed with a
+            fast sine approximation and linearly interpolated in between,
+            8 or 16 make a slowly modulated filter much cheaper. 1 computes
+            them exactly at every sample. Defaults to 1.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -2576,15 +2719,16 @@ class SVF(PyoObject):
     >>> b = SVF(a, freq=lf1, q=lf2, type=lf3).out()
 
     """
-    def __init__(self, input, freq=1000, q=1, type=0, mul=1, add=0):
+    def __init__(self, input, freq=1000, q=1, type=0, mul=1, add=0, decimation=1):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._freq = freq
         self._q = q
         self._type = type
+        self._decimation = decimation
         self._in_fader = InputFader(input)
-        in_fader, freq, q, type, mul, add, lmax = convertArgsToLists(self._in_fader, freq, q, type, mul, add)
-        self._base_objs = [SVF_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        in_fader, freq, q, type, mul, add, decimation, lmax = convertArgsToLists(self._in_fader, freq, q, type, mul, add, decimation)
+        self._base_objs = [SVF_base(wrap(in_fader,i), wrap(freq,i), wrap(q,i), wrap(type,i), wrap(mul,i), wrap(add,i), wrap(decimation,i)) for i in range(lmax)]
 
     def setInput(self, x, fadetime=0.05):
         """
@@ -2647,6 +2791,20 @@ class SVF(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setDecimation(self, x):
+        """
+        Replace the `decimation` attribute.
+
+        :Args:
+
+            x : int
+                New `decimation` attribute.
+
+        """
+        self._decimation = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setDecimation(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(20, 7350, "log", "freq", self._freq),
                           SLMap(0.5, 10, "log", "q", self._q),
@@ -2682,6 +2840,13 @@ class SVF(PyoObject):
     @type.setter
     def type(self, x): self.setType(x)
 
+    @property
+    def decimation(self):
+        """int. Coefficients update period for audio rate parameters."""
+        return self._decimation
+    @decimation.setter
+    def decimation(self, x): self.setDecimation(x)
+
 class Average(PyoObject):
     """
     Moving average filter.
@@ -1142,9 +1142,14 @@ class CvlVerb(PyoObject):
     """
     Convolution based reverb.
 
-    CvlVerb implements convolution based on a uniformly partitioned overlap-save
-    algorithm. This object can be used to convolve an input signal with an
-    impulse response soundfile to simulate real acoustic spaces.
+    CvlVerb implements convolution based on a non-uniformly partitioned
+    overlap-save algorithm. This object can be used to convolve an input
+    signal with an impulse response soundfile to simulate real acoustic spaces.
+
+    The head of the impulse is convolved with partitions of `size` samples
+    in the audio thread while the tail, with much larger partitions, is
+    computed ahead of time by a helper thread. Long impulses can thus be
+    used with a small `size`, ie. a small latency.
 
     :Parent: :py:class:`PyoObject`
 
@@ -1158,11 +1163,12 @@ class CvlVerb(PyoObject):
             initialization time only. Defaults to 'IRMediumHallStereo.wav', located
             in pyolib SNDS_PATH folder.
         size : int {pow-of-two}, optional
-            The size in samples of each partition of the impulse file. Small size means
-            smaller latency but more computation time. If not a power-of-2, the object
-            will find the next power-of-2 greater and use that as the actual partition size.
-            This value must also be greater or equal than the server's buffer size.
-            Available at initialization time only. Defaults to 1024.
+            The size in samples of the partitions of the head of the impulse file,
+            which is also the latency of the reverb. Small size means smaller latency
+            but more computation time. If not a power-of-2, the object will find the
+            next power-of-2 greater and use that as the actual partition size. This
+            value must also be greater or equal than the server's buffer size and
+            16. Available at initialization time only. Defaults to 1024.
         bal : float or PyoObject, optional
             Balance between wet and dry signal, between 0 and 1. 0 means no
             reverb. Defaults to 0.25.
@@ -44,6 +44,16 @@ class Sine(PyoObject):
         phase : float or PyoObject, optional
             Phase of sampling, expressed as a fraction of a cycle (0 to 1).
             Defaults to 0.
+        accuracy : int, optional
+            How the sine is computed. Defaults to 0.
+                0. wavetable lookup with linear interpolation
+                1. polynomial, error below 1e-4, the fastest
+                2. polynomial, error below 1e-8 with pyo64
+        multi : boolean, optional
+            If True, a single object computes all the streams, which is
+            faster when there are many of them. The streams can't be
+            controlled individually with `play`, `stop` or `out` delays.
+            Available at initialization time only. Defaults to False.
 
     .. seealso::
 
@@ -54,12 +64,19 @@ class Sine(PyoObject):
     >>> sine = Sine(freq=[400,500], mul=.2).out()
 
     """
-    def __init__(self, freq=1000, phase=0, mul=1, add=0):
+    def __init__(self, freq=1000, phase=0, mul=1, add=0, accuracy=0, multi=False):
         PyoObject.__init__(self, mul, add)
         self._freq = freq
         self._phase = phase
+        self._accuracy = accuracy
+        self._multi = multi
         freq, phase, mul, add, lmax = convertArgsToLists(freq, phase, mul, add)
-        self._base_objs = [Sine_base(wrap(freq,i), wrap(phase,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        if multi:
+            self._base_players = [MultiOscMain_base(0, lmax, [wrap(freq,i) for i in range(lmax)],
+                                                    [wrap(phase,i) for i in range(lmax)], accuracy)]
+            self._base_objs = [PackedChannel_base(self._base_players[0], i, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        else:
+            self._base_objs = [Sine_base(wrap(freq,i), wrap(phase,i), wrap(mul,i), wrap(add,i), accuracy) for i in range(lmax)]
 
     def setFreq(self, x):
         """
@@ -73,7 +90,10 @@ class Sine(PyoObject):
         """
         self._freq = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setFreq([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setPhase(self, x):
         """
@@ -87,14 +107,37 @@ class Sine(PyoObject):
         """
         self._phase = x
         x, lmax = convertArgsToLists(x)
-        [obj.setPhase(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setPhase([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setPhase(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
+    def setAccuracy(self, x):
+        """
+        Replace the `accuracy` attribute.
+
+        :Args:
+
+            x : int {0, 1, 2}
+                new `accuracy` attribute.
+
+        """
+        self._accuracy = x
+        if self._multi:
+            self._base_players[0].setAccuracy(x)
+        else:
+            x, lmax = convertArgsToLists(x)
+            [obj.setAccuracy(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def reset(self):
         """
         Resets current phase to 0.
 
         """
-        [obj.reset() for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].reset()
+        else:
+            [obj.reset() for i, obj in enumerate(self._base_objs)]
 
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
@@ -115,6 +158,13 @@ class Sine(PyoObject):
     @phase.setter
     def phase(self, x): self.setPhase(x)
 
+    @property
+    def accuracy(self):
+        """int. How the sine is computed."""
+        return self._accuracy
+    @accuracy.setter
+    def accuracy(self, x): self.setAccuracy(x)
+
 class SineLoop(PyoObject):
     """
     A simple sine wave oscillator with feedback.
@@ -131,6 +181,16 @@ class SineLoop(PyoObject):
         feedback : float or PyoObject, optional
             Amount of the output signal added to position increment, between 0 and 1.
             Controls the brightness. Defaults to 0.
+        accuracy : int, optional
+            How the sine is computed. Defaults to 0.
+                0. wavetable lookup with linear interpolation
+                1. polynomial, error below 1e-4, the fastest
+                2. polynomial, error below 1e-8 with pyo64
+        multi : boolean, optional
+            If True, a single object computes all the streams, which is
+            faster when there are many of them. The streams can't be
+            controlled individually with `play`, `stop` or `out` delays.
+            Available at initialization time only. Defaults to False.
 
     .. seealso::
 
@@ -142,12 +202,19 @@ class SineLoop(PyoObject):
     >>> a = SineLoop(freq=[400,500], feedback=lfo, mul=.2).out()
 
     """
-    def __init__(self, freq=1000, feedback=0, mul=1, add=0):
+    def __init__(self, freq=1000, feedback=0, mul=1, add=0, accuracy=0, multi=False):
         PyoObject.__init__(self, mul, add)
         self._freq = freq
         self._feedback = feedback
+        self._accuracy = accuracy
+        self._multi = multi
         freq, feedback, mul, add, lmax = convertArgsToLists(freq, feedback, mul, add)
-        self._base_objs = [SineLoop_base(wrap(freq,i), wrap(feedback,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        if multi:
+            self._base_players = [MultiOscMain_base(1, lmax, [wrap(freq,i) for i in range(lmax)],
+                                                    [wrap(feedback,i) for i in range(lmax)], accuracy)]
+            self._base_objs = [PackedChannel_base(self._base_players[0], i, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        else:
+            self._base_objs = [SineLoop_base(wrap(freq,i), wrap(feedback,i), wrap(mul,i), wrap(add,i), accuracy) for i in range(lmax)]
 
     def setFreq(self, x):
         """
@@ -161,7 +228,10 @@ class SineLoop(PyoObject):
         """
         self._freq = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setFreq([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setFeedback(self, x):
         """
@@ -175,7 +245,27 @@ class SineLoop(PyoObject):
         """
         self._feedback = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFeedback(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setPhase([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFeedback(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
+    def setAccuracy(self, x):
+        """
+        Replace the `accuracy` attribute.
+
+        :Args:
+
+            x : int {0, 1, 2}
+                new `accuracy` attribute.
+
+        """
+        self._accuracy = x
+        if self._multi:
+            self._base_players[0].setAccuracy(x)
+        else:
+            x, lmax = convertArgsToLists(x)
+            [obj.setAccuracy(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapFreq(self._freq), SLMap(0, 1, "lin", "feedback", self._feedback), SLMapMul(self._mul)]
@@ -195,6 +285,13 @@ class SineLoop(PyoObject):
     @feedback.setter
     def feedback(self, x): self.setFeedback(x)
 
+    @property
+    def accuracy(self):
+        """int. How the sine is computed."""
+        return self._accuracy
+    @accuracy.setter
+    def accuracy(self, x): self.setAccuracy(x)
+
 class Phasor(PyoObject):
     """
     A simple phase incrementor.
@@ -210,6 +307,11 @@ class Phasor(PyoObject):
         phase : float or PyoObject, optional
             Phase of sampling, expressed as a fraction of a cycle (0 to 1).
             Defaults to 0.
+        multi : boolean, optional
+            If True, a single object computes all the streams, which is
+            faster when there are many of them. The streams can't be
+            controlled individually with `play`, `stop` or `out` delays.
+            Available at initialization time only. Defaults to False.
 
     .. seealso::
 
@@ -221,12 +323,18 @@ class Phasor(PyoObject):
     >>> sine = Sine(freq=f, mul=.2).out()
 
     """
-    def __init__(self, freq=100, phase=0, mul=1, add=0):
+    def __init__(self, freq=100, phase=0, mul=1, add=0, multi=False):
         PyoObject.__init__(self, mul, add)
         self._freq = freq
         self._phase = phase
+        self._multi = multi
         freq, phase, mul, add, lmax = convertArgsToLists(freq, phase, mul, add)
-        self._base_objs = [Phasor_base(wrap(freq,i), wrap(phase,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        if multi:
+            self._base_players = [MultiOscMain_base(2, lmax, [wrap(freq,i) for i in range(lmax)],
+                                                    [wrap(phase,i) for i in range(lmax)])]
+            self._base_objs = [PackedChannel_base(self._base_players[0], i, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+        else:
+            self._base_objs = [Phasor_base(wrap(freq,i), wrap(phase,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
     def setFreq(self, x):
         """
@@ -240,7 +348,10 @@ class Phasor(PyoObject):
         """
         self._freq = x
         x, lmax = convertArgsToLists(x)
-        [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setFreq([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setFreq(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def setPhase(self, x):
         """
@@ -254,14 +365,20 @@ class Phasor(PyoObject):
         """
         self._phase = x
         x, lmax = convertArgsToLists(x)
-        [obj.setPhase(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].setPhase([wrap(x,i) for i in range(len(self._base_objs))])
+        else:
+            [obj.setPhase(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
     def reset(self):
         """
         Resets current phase to 0.
 
         """
-        [obj.reset() for i, obj in enumerate(self._base_objs)]
+        if self._multi:
+            self._base_players[0].reset()
+        else:
+            [obj.reset() for i, obj in enumerate(self._base_objs)]
 
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
@@ -313,6 +430,71 @@ class Input(PyoObject):
         self._map_list = [SLMapMul(self._mul)]
         PyoObject.ctrl(self, map_list, title, wxnoserver)
 
+class BusIn(PyoObject):
+    """
+    Read an internal bus of the server.
+
+    Returns one stream per channel of the bus, playing the sum of the
+    objects sent to the bus (see PyoObject.send) during the previous
+    buffer.
+
+    :Parent: :py:class:`PyoObject`
+
+    :Args:
+
+        bus : string
+            Name of a bus created with Server.addBus.
+
+    >>> s = Server().boot()
+    >>> s.start()
+    >>> s.addBus("reverb", chnls=2)
+    >>> a = Sine([300, 400], mul=.2).out().send("reverb", gain=.5)
+    >>> b = Noise(.05).send("reverb", gain=.2)
+    >>> c = Freeverb(BusIn("reverb"), size=.9, bal=1).out()
+
+    """
+    def __init__(self, bus, mul=1, add=0):
+        PyoObject.__init__(self, mul, add)
+        self._bus = bus
+        first = BusIn_base(0)
+        info = first.getServer().getBus(bus)
+        if info is None:
+            raise ValueError("Server has no bus named '%s'." % bus)
+        start, chnls = info
+        mul, add, lmax = convertArgsToLists(mul, add)
+        lmax = max(lmax, chnls)
+        self._base_objs = [BusIn_base(start + i % chnls, wrap(mul,i), wrap(add,i)) for i in range(lmax)]
+
+    def setBus(self, x):
+        """
+        Replace the `bus` attribute.
+
+        The new bus should have the same number of channels.
+
+        :Args:
+
+            x : string
+                Name of the new bus.
+
+        """
+        info = self.getServer().getBus(x)
+        if info is None:
+            raise ValueError("Server has no bus named '%s'." % x)
+        self._bus = x
+        start, chnls = info
+        [obj.setChnl(start + i % chnls) for i, obj in enumerate(self._base_objs)]
+
+    def ctrl(self, map_list=None, title=None, wxnoserver=False):
+        self._map_list = [SLMapMul(self._mul)]
+        PyoObject.ctrl(self, map_list, title, wxnoserver)
+
+    @property
+    def bus(self):
+        """string. Name of the bus."""
+        return self._bus
+    @bus.setter
+    def bus(self, x): self.setBus(x)
+
 class Noise(PyoObject):
     """
     A white noise generator.
@@ -1031,6 +1213,23 @@ class LFO(PyoObject):
         [obj.reset() for i, obj in enumerate(self._base_objs)]
 
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The waveform is computed once per buffer, with freq and sharp read
+        on their last sample, and interpolated linearly. Meant for slow
+        modulations.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapFreq(self._freq),
                           SLMap(0., 1., "lin", "sharp", self._sharp),
@@ -407,6 +407,7 @@ class MatrixMorph(PyoObject):
         self._sources = sources
         self._in_fader = InputFader(input)
         in_fader, matrix, lmax = convertArgsToLists(self._in_fader, matrix)
+        self._threaded = False
         self._base_sources = [source[0] for source in sources]
         self._base_objs = [MatrixMorph_base(wrap(in_fader,i), wrap(matrix,i), self._base_sources) for i in range(len(matrix))]
 
@@ -462,6 +463,25 @@ class MatrixMorph(PyoObject):
         self._base_sources = [source[0] for source in x]
         [obj.setSources(self._base_sources) for i, obj in enumerate(self._base_objs)]
 
+    def setThreaded(self, x):
+        """
+        Morphs half of the rows on a helper thread.
+
+        The audio thread morphs the first half of the rows while a
+        helper thread morphs the second half, which shortens the
+        block for large matrices.
+
+        :Args:
+
+            x : boolean
+                True to use a helper thread, False to morph the whole
+                matrix in the audio thread (the default).
+
+        """
+        self._threaded = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setThreaded(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     @property
     def input(self):
         """PyoObject. Morphing index between 0 and 1."""
@@ -481,4 +501,11 @@ class MatrixMorph(PyoObject):
         """list of PyoMatrixObject. List of matrices to interpolate from."""
         return self._sources
     @sources.setter
-    def sources(self, x): self.setSources(x)
\ No newline at end of file
+    def sources(self, x): self.setSources(x)
+
+    @property
+    def threaded(self):
+        """boolean. Morphs half of the rows on a helper thread."""
+        return self._threaded
+    @threaded.setter
+    def threaded(self, x): self.setThreaded(x)
\ No newline at end of file
@@ -164,6 +164,22 @@ class Midictl(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setInterpolation(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The output moves linearly over one buffer toward the last value
+        received, whatever the interpolation setting.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     @property
     def ctlnumber(self):
         """int. Controller number."""
@@ -694,6 +710,22 @@ class Bendin(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setChannel(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The output moves linearly over one buffer toward the last value
+        received.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     @property
     def brange(self):
         """float. Bipolar range of the pitch bend in semitones."""
@@ -803,6 +835,22 @@ class Touchin(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setChannel(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setControlRate(self, x):
+        """
+        Activate/Deactivate the control-rate mode. Deactivated by default.
+
+        The output moves linearly over one buffer toward the last value
+        received.
+
+        :Args:
+
+            x : boolean
+                True activates the control-rate mode, False deactivates it.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.setControlRate(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     @property
     def minscale(self):
         """float. Minimum value for scaling."""
@@ -47,6 +47,9 @@ class OscSend(PyoObject):
     computers. Only the first value of each input buffersize will be
     sent on the OSC port.
 
+    The values of a buffer are sent by a network thread, in a bundle
+    per destination. See Server.setOscSendRate to limit their rate.
+
     :Parent: :py:class:`PyoObject`
 
     :Args:
@@ -120,6 +123,19 @@ class OscSend(PyoObject):
         """
         [obj.setBufferRate(x) for obj in self._base_objs]
 
+    def setChangeOnly(self, x):
+        """
+        Sends a value only when it differs from the last one sent.
+
+        :Args:
+
+            x : boolean
+                True to skip the values equal to the last one sent.
+                Defaults to False.
+
+        """
+        [obj.setChangeOnly(x) for obj in self._base_objs]
+
     @property
     def input(self):
         """PyoObject. Input signal."""
@@ -87,6 +87,7 @@ class PVAnal(PyoPVObject):
         self._size = size
         self._overlaps = overlaps
         self._wintype = wintype
+        self._threaded = False
         self._in_fader = InputFader(input)
         in_fader, size, overlaps, wintype, lmax = convertArgsToLists(self._in_fader, size, overlaps, wintype)
         self._base_objs = [PVAnal_base(wrap(in_fader,i), wrap(size,i), wrap(overlaps,i), wrap(wintype,i)) for i in range(lmax)]
@@ -148,6 +149,28 @@ class PVAnal(PyoPVObject):
         x, lmax = convertArgsToLists(x)
         [obj.setWinType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setThreaded(self, x):
+        """
+        Computes the analysis frames on a helper thread.
+
+        The frame due at each hop is handed to a helper thread and
+        its result is used one hop later. This adds one hop of
+        latency but spreads the cost of the large FFT sizes over
+        the hop, instead of computing the whole frame in the audio
+        block where it falls due, and lets several chains use
+        several cores.
+
+        :Args:
+
+            x : boolean
+                True to use a helper thread, False to compute the
+                frames in the audio thread (the default).
+
+        """
+        self._threaded = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setThreaded(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     @property
     def input(self):
         """PyoObject. Input signal to process."""
@@ -176,6 +199,13 @@ class PVAnal(PyoPVObject):
     @wintype.setter
     def wintype(self, x): self.setWinType(x)
 
+    @property
+    def threaded(self):
+        """boolean. Computes the frames on a helper thread."""
+        return self._threaded
+    @threaded.setter
+    def threaded(self, x): self.setThreaded(x)
+
 class PVSynth(PyoObject):
     """
     Phase Vocoder synthesis object.
@@ -215,6 +245,7 @@ class PVSynth(PyoObject):
         PyoObject.__init__(self, mul, add)
         self._input = input
         self._wintype = wintype
+        self._threaded = False
         input, wintype, mul, add, lmax = convertArgsToLists(self._input, wintype, mul, add)
         self._base_objs = [PVSynth_base(wrap(input,i), wrap(wintype,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
@@ -246,6 +277,28 @@ class PVSynth(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setWinType(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setThreaded(self, x):
+        """
+        Computes the synthesis frames on a helper thread.
+
+        The frame due at each hop is handed to a helper thread and
+        its result is used one hop later. This adds one hop of
+        latency but spreads the cost of the large FFT sizes over
+        the hop, instead of computing the whole frame in the audio
+        block where it falls due, and lets several chains use
+        several cores.
+
+        :Args:
+
+            x : boolean
+                True to use a helper thread, False to compute the
+                frames in the audio thread (the default).
+
+        """
+        self._threaded = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setThreaded(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMapMul(self._mul)]
         PyoObject.ctrl(self, map_list, title, wxnoserver)
@@ -264,6 +317,13 @@ class PVSynth(PyoObject):
     @wintype.setter
     def wintype(self, x): self.setWinType(x)
 
+    @property
+    def threaded(self):
+        """boolean. Computes the frames on a helper thread."""
+        return self._threaded
+    @threaded.setter
+    def threaded(self, x): self.setThreaded(x)
+
 class PVAddSynth(PyoObject):
     """
     Phase Vocoder additive synthesis object.
@@ -306,6 +366,7 @@ class PVAddSynth(PyoObject):
         self._num = num
         self._first = first
         self._inc = inc
+        self._quadrature = False
         input, pitch, num, first, inc, mul, add, lmax = convertArgsToLists(self._input, pitch, num, first, inc, mul, add)
         self._base_objs = [PVAddSynth_base(wrap(input,i), wrap(pitch,i), wrap(num,i), wrap(first,i), wrap(inc,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
 
@@ -379,6 +440,27 @@ class PVAddSynth(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setInc(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setQuadrature(self, x):
+        """
+        Switches the oscillators between table lookup and quadrature.
+
+        In quadrature mode, each oscillator is a phasor rotated
+        at every sample, which gives a pure sine without any table
+        read. It is cheaper with many oscillators but the
+        phases of a long note may drift slightly in single
+        precision.
+
+        :Args:
+
+            x : boolean
+                True to use quadrature oscillators, False to read
+                the internal sine table.
+
+        """
+        self._quadrature = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setQuadrature(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0.25, 4, "lin", "pitch", self._pitch),
                           SLMapMul(self._mul)]
@@ -419,6 +501,13 @@ class PVAddSynth(PyoObject):
     @inc.setter
     def inc(self, x): self.setInc(x)
 
+    @property
+    def quadrature(self):
+        """boolean. Uses quadrature oscillators instead of the table."""
+        return self._quadrature
+    @quadrature.setter
+    def quadrature(self, x): self.setQuadrature(x)
+
 class PVTranspose(PyoPVObject):
     """
     Transpose the frequency components of a pv stream.
@@ -1335,6 +1424,9 @@ class PVBuffer(PyoPVObject):
         The play() method can be called to start a new recording of
         the current pv input.
 
+        The recorded frames can be written in an analysis file with
+        the `save` method and read back, memory-mapped, with `load`.
+
     >>> s = Server().boot()
     >>> s.start()
     >>> f = SNDS_PATH+'/transparent.aif'
@@ -1397,6 +1489,47 @@ class PVBuffer(PyoPVObject):
         x, lmax = convertArgsToLists(x)
         [obj.setPitch(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def save(self, path):
+        """
+        Write the recorded analysis frames in a file.
+
+        The file can later be given to the `load` method of a PVBuffer
+        or a PVBufLoops, which will read its frames without analysing
+        the sound again.
+
+        :Args:
+
+            path : string or list of strings
+                Path of the file to write. If the object holds more
+                than one stream, a list gives one file per stream.
+
+        """
+        path, lmax = convertArgsToLists(path)
+        [obj.save(wrap(path,i)) for i, obj in enumerate(self._base_objs)]
+
+    def load(self, path):
+        """
+        Read the analysis frames from a file written by `save`.
+
+        The file is memory-mapped, frames are loaded by the system only
+        when they are played, so very long analyses can be scrubbed
+        without holding them in memory. While a file is loaded, the
+        frames of the input are not recorded anymore, but the input
+        still clocks the playback and must use the same size and
+        overlaps as the analysis file.
+
+        :Args:
+
+            path : string, list of strings or None
+                Path of the analysis file. If the object holds more
+                than one stream, a list gives one file per stream.
+                None unloads the file and returns to the recorded
+                frames.
+
+        """
+        path, lmax = convertArgsToLists(path)
+        [obj.load(wrap(path,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0.25, 4, "lin", "pitch", self._pitch)]
         PyoPVObject.ctrl(self, map_list, title, wxnoserver)
@@ -1802,6 +1935,9 @@ class PVBufLoops(PyoPVObject):
         The play() method can be called to start a new recording of
         the current pv input.
 
+        The recorded frames can be written in an analysis file with
+        the `save` method and read back, memory-mapped, with `load`.
+
     >>> s = Server().boot()
     >>> s.start()
     >>> f = SNDS_PATH+'/transparent.aif'
@@ -1885,6 +2021,47 @@ class PVBufLoops(PyoPVObject):
         """
         [obj.reset() for obj in self._base_objs]
 
+    def save(self, path):
+        """
+        Write the recorded analysis frames in a file.
+
+        The file can later be given to the `load` method of a PVBuffer
+        or a PVBufLoops, which will read its frames without analysing
+        the sound again.
+
+        :Args:
+
+            path : string or list of strings
+                Path of the file to write. If the object holds more
+                than one stream, a list gives one file per stream.
+
+        """
+        path, lmax = convertArgsToLists(path)
+        [obj.save(wrap(path,i)) for i, obj in enumerate(self._base_objs)]
+
+    def load(self, path):
+        """
+        Read the analysis frames from a file written by `save`.
+
+        The file is memory-mapped, frames are loaded by the system only
+        when they are played, so very long analyses can be scrubbed
+        without holding them in memory. While a file is loaded, the
+        frames of the input are not recorded anymore, but the input
+        still clocks the playback and must use the same size and
+        overlaps as the analysis file.
+
+        :Args:
+
+            path : string, list of strings or None
+                Path of the analysis file. If the object holds more
+                than one stream, a list gives one file per stream.
+                None unloads the file and returns to the recorded
+                frames.
+
+        """
+        path, lmax = convertArgsToLists(path)
+        [obj.load(wrap(path,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(-4, 4, "lin", "low", self._low),
                           SLMap(-4, 4, "lin", "high", self._high)]
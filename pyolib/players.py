@@ -66,6 +66,8 @@ class SfPlayer(PyoObject):
                 2. linear
                 3. cosinus
                 4. cubic
+                5. windowed sinc, best quality when the sampling rate of
+                   the file differs from the one of the server
 
     .. note::
 
@@ -199,7 +201,7 @@ class SfPlayer(PyoObject):
 
         :Args:
 
-            x : int {1, 2, 3, 4}
+            x : int {1, 2, 3, 4, 5}
                 new `interp` attribute.
 
         """
@@ -209,7 +211,7 @@ class SfPlayer(PyoObject):
 
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(-2., 2., 'lin', 'speed', self._speed),
-                          SLMap(1, 4, 'lin', 'interp', self._interp, res="int", dataOnly=True),
+                          SLMap(1, 5, 'lin', 'interp', self._interp, res="int", dataOnly=True),
                           SLMapMul(self._mul)]
         PyoObject.ctrl(self, map_list, title, wxnoserver)
 
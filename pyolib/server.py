@@ -18,10 +18,31 @@ GNU Lesser General Public License for more details.
 You should have received a copy of the GNU Lesser General Public
 License along with pyo.  If not, see <http://www.gnu.org/licenses/>.
 """
-import os, time
+import os, gc, time, traceback, threading
 from _core import *
 from _widgets import createServerGUI
 
+class _CallablePoller(threading.Thread):
+    """
+    Sends the meters and the time published by the audio thread to the
+    registered objects, every `interval` seconds. The audio callback never
+    calls python code for the GUI.
+
+    """
+    def __init__(self, server, interval=0.05):
+        threading.Thread.__init__(self)
+        self.daemon = True
+        self._server = server
+        self._interval = interval
+        self._terminated = threading.Event()
+
+    def run(self):
+        while not self._terminated.wait(self._interval):
+            self._server.pollCallables()
+
+    def stop(self):
+        self._terminated.set()
+
 ######################################################################
 ### Proxy of Server object
 ######################################################################
@@ -55,7 +76,7 @@ class Server(object):
         duplex : int {0, 1}, optional
             Input - output mode. 0 is output only and 1 is both ways.
             Defaults to 1.
-        audio : string {'portaudio', 'pa', 'jack', 'coreaudio', 'offline', 'offline_nb}, optional
+        audio : string {'portaudio', 'pa', 'jack', 'coreaudio', 'offline', 'offline_nb', 'shm'}, optional
             Audio backend to use. 'pa' is equivalent to 'portaudio'. Default is 'portaudio'.
 
             'offline' save the audio output in a soundfile as fast as possible in blocking mode,
@@ -70,8 +91,12 @@ class Server(object):
 
             It is the responsibility of the user to make sure that the program doesn't exit before
             the computation is done.
+
+            'shm' computes blocks for another pyo process, through shared memory named after
+            `jackname`. The other process adds this server as a worker with `addShmWorker`.
+            Not available on Windows.
         jackname : string, optional
-            Name of jack client. Defaults to 'pyo'
+            Name of jack client, or of the shared memory with the 'shm' backend. Defaults to 'pyo'
         ichnls : int, optional
             Number of input channels if different of output channels. If None (default), ichnls = nchnls.
 
@@ -93,6 +118,10 @@ class Server(object):
         - setIchnls(x) : Set the number of input channels (if different of output channels) used by the server.
         - setDuplex(x) : Set the duplex mode used by the server.
         - setVerbosity(x) : Set the server's verbosity.
+        - setNumThreads(x) : Set the number of worker threads used to compute the audio streams.
+        - setGILFree(x) : Compute the audio streams without holding the python interpreter lock.
+        - setPullMode(x) : Compute only the audio streams the output depends on.
+        - setBlockSize(x) : Set the number of samples computed at once by the objects.
         - reinit(sr, nchnls, buffersize, duplex, audio, jackname) : Reinit the server's settings.
 
     >>> # For an 8 channels server in duplex mode with
@@ -103,7 +132,7 @@ class Server(object):
     """
     def __init__(self, sr=44100, nchnls=2, buffersize=256, duplex=1,
                  audio='portaudio', jackname='pyo', ichnls=None):
-        if os.environ.has_key("PYO_SERVER_AUDIO") and "offline" not in audio and "embedded" not in audio:
+        if os.environ.has_key("PYO_SERVER_AUDIO") and "offline" not in audio and "embedded" not in audio and audio != "shm":
             audio = os.environ["PYO_SERVER_AUDIO"]
         self._time = time
         self._nchnls = nchnls
@@ -118,10 +147,14 @@ class Server(object):
         self._filename = None
         self._fileformat = 0
         self._sampletype = 0
+        self._sync = False
+        self._poller = None
         self._server = Server_base(sr, nchnls, buffersize, duplex, audio, jackname, self._ichnls)
         self._server._setDefaultRecPath(os.path.join(os.path.expanduser("~"), "pyo_rec.wav"))
 
     def __del__(self):
+        if self._poller != None:
+            self._poller.stop()
         self.setTime = None
         self.setRms = None
         if self.getIsBooted():
@@ -153,6 +186,7 @@ class Server(object):
         self._filename = None
         self._fileformat = 0
         self._sampletype = 0
+        self._sync = False
         self._globalseed = 0
         self._server.__init__(sr, nchnls, buffersize, duplex, audio, jackname, self._ichnls)
 
@@ -183,6 +217,8 @@ class Server(object):
             self._server.setAmpCallable(f)
         if timer:
             self._server.setTimeCallable(f)
+        if meter or timer:
+            self._startPoller()
         try:
             win.mainloop()
         except:
@@ -204,12 +240,14 @@ class Server(object):
         """
         self.setTime = func
         self._server.setTimeCallable(self)
+        self._startPoller()
 
     def setMeterCallable(self, func):
         """
         Set a function callback that will receive the current rms values as argument.
         
-        The function will receive a list containing the rms value for each audio channel.
+        The function will receive the rms value of each audio channel as
+        arguments, whatever the number of channels.
 
         :Args:
             
@@ -219,6 +257,7 @@ class Server(object):
         """
         self.setRms = func
         self._server.setAmpCallable(self)
+        self._startPoller()
 
     def setMeter(self, meter):
         """
@@ -234,6 +273,24 @@ class Server(object):
 
         """
         self._server.setAmpCallable(meter)
+        self._startPoller()
+
+    def getMeters(self):
+        """
+        Returns the current levels of the output channels.
+
+        Returns two lists, the smoothed squared peaks (the values received
+        by `setRms`) and the smoothed rms amplitudes of the channels. They
+        are updated after each buffer while a meter is registered.
+
+        """
+        return self._server.getMeters()
+
+    def _startPoller(self):
+        # The meters and the time are polled by a thread, at about 20 Hz.
+        if self._poller == None:
+            self._poller = _CallablePoller(self._server)
+            self._poller.start()
 
     def setInOutDevice(self, x):
         """
@@ -465,6 +522,46 @@ class Server(object):
         ports, lmax = convertArgsToLists(ports)
         self._server.setJackAutoConnectOutputPorts(ports)
 
+    def setJackTransport(self, x):
+        """
+        Tells the server to follow (or not) the Jack transport.
+
+        When enabled, the server computes its buffers only while the Jack
+        transport is rolling. A stopped transport pauses the server, its
+        outputs are silent and its time doesn't advance.
+
+        In Jack freewheel mode, the server renders as fast as the Jack graph
+        allows. The recording started with `recstart` then waits for the
+        disk instead of dropping frames, and midi input is ignored.
+
+        Can be called at any time.
+
+        :Args:
+
+            x : boolean
+                True to follow the transport, False (default) to run freely.
+
+        """
+        self._server.setJackTransport(x)
+
+    def setJackLocateCallable(self, func):
+        """
+        Set a function callback that will receive the Jack transport position after a locate.
+
+        While the server follows the Jack transport (see `setJackTransport`),
+        the function is called with the transport position, in seconds, when
+        the server starts and every time the transport is moved elsewhere
+        than where it was playing.
+
+        :Args:
+
+            func : python callable
+                Python function or method to call with the position as argument.
+                None removes the callback.
+
+        """
+        self._server.setJackLocateCallable(func)
+
     def setGlobalSeed(self, x):
         """
         Set the server's global seed used by random objects.
@@ -476,10 +573,271 @@ class Server(object):
 
                 If zero, randoms will be seeded with the system clock current value.
 
+        Each random object owns its generator, seeded from this value, its
+        type and the number of objects of this type created before it.
+
         """
         self._globalseed = x
         self._server.setGlobalSeed(x)
 
+    def setNumThreads(self, x):
+        """
+        Set the number of worker threads used to compute the audio streams.
+
+        When greater than 0, independent branches of the processing chain
+        are computed in parallel by `x` worker threads plus the audio thread.
+        Objects are still computed in the order they were created, so the
+        output is identical to the serial processing. Objects calling python
+        functions (Pattern, TrigFunc, OSC objects, etc.) are always computed
+        alone on the audio thread.
+
+        Must be called before booting the server.
+
+        :Args:
+
+            x : int
+                Number of worker threads. 0 (the default) means serial processing.
+
+        """
+        self._server.setNumThreads(x)
+
+    def setPullMode(self, x):
+        """
+        Compute only the audio streams the output depends on.
+
+        In pull mode, the server computes, at every buffer, the streams sent
+        to the dac, the sinks (recorders, tables and matrices recorders, objects
+        calling python functions, objects read with the `get` method) and all
+        the streams they depend on. Any other stream is suspended until an
+        object that is computed uses it again. Suspended objects keep their
+        internal state (phase, envelope position, etc.) frozen.
+
+        Must be called before booting the server.
+
+        :Args:
+
+            x : boolean
+                True to enable the pull mode. Defaults to False.
+
+        """
+        self._server.setPullMode(x)
+
+    def setFlushDenormals(self, x):
+        """
+        Flush denormal numbers to zero while computing the audio streams.
+
+        The tail of a feedback structure (reverbs, waveguides, recursive
+        filters) decays towards the denormal range, where floating-point
+        operations are many times slower. When enabled, the server sets the
+        flush-to-zero and denormals-are-zero modes of the processor on every
+        thread computing streams, for all audio backends, and restores the
+        mode of the host thread after each buffer. This makes the Denorm
+        object unnecessary on x86 and arm64 processors.
+
+        Can be called at any time.
+
+        :Args:
+
+            x : boolean
+                True to flush denormals to zero. Defaults to True.
+
+        """
+        self._server.setFlushDenormals(x)
+
+    def setVoiceSuspension(self, x):
+        """
+        Skip the computation of the voices whose output is silent.
+
+        When enabled, an audio object is not computed while its `mul`
+        attribute is an audio object whose last buffer was all zeros (an
+        envelope like Adsr, MidiAdsr, Linseg, TrigEnv or Fader at rest)
+        and its `add` attribute is 0. Objects declaring a tail, as the
+        filters, delays and reverbs, are skipped only once their input and
+        their own output have stayed under -120 dB longer than their tail,
+        whatever their `mul`, so their lines keep the input of a gated
+        period.
+        A skipped object outputs zeros and is computed again as soon as its
+        envelope is retriggered or its input comes back, so the idle voices
+        of a polyphonic instrument cost almost nothing.
+
+        The phase and state of a skipped object don't advance, so a voice
+        woken up may not be sample-identical to one computed all along.
+        Objects feeding trigger streams are never skipped.
+
+        Can be called at any time.
+
+        :Args:
+
+            x : boolean
+                True to skip the silent voices. Defaults to False.
+
+        """
+        self._server.setVoiceSuspension(x)
+
+    def setOscSendRate(self, x):
+        """
+        Limit the rate of the OSC bundles sent to each destination.
+
+        The values of OscSend and OscDataSend objects are collected at every
+        buffer and sent, grouped in bundles by destination, by a network
+        thread. With a limit, a destination receives at most `x` bundles per
+        second and, between two bundles, only the latest value of each
+        address is kept.
+
+        Can be called at any time.
+
+        :Args:
+
+            x : float
+                Maximum number of bundles per second sent to a destination.
+                0 means no limit, a bundle per buffer. Defaults to 0.
+
+        """
+        self._server.setOscSendRate(x)
+
+    def setBlockSize(self, x):
+        """
+        Set the number of samples computed at once by the objects.
+
+        By default, the objects compute the whole buffer requested by the
+        audio backend. With a real-time backend, a smaller block size, which
+        must divide the buffer size, processes the buffer in several blocks
+        and lowers the control latency (the resolution of time-triggered
+        events, the feedback delay of Sig loops, etc.) without raising the
+        number of audio callbacks. With the offline backends, any block size
+        can be used, as there is no device constraint, and a larger block
+        reduces the per-buffer overhead.
+
+        Must be called before booting the server.
+
+        :Args:
+
+            x : int
+                Number of samples per block. 0 means the buffer size of
+                the backend. Defaults to 0.
+
+        """
+        self._server.setBlockSize(x)
+
+    def setGILFree(self, x):
+        """
+        Compute the audio streams without holding the python interpreter lock.
+
+        In this mode, python threads (garbage collection, control logic, etc.)
+        can't delay the audio callback anymore. Calls to python made by
+        Pattern, CallAfter, TrigFunc, Print and the server's GUI meters and
+        clock are deferred to a dispatcher thread. Other objects that need the
+        interpreter (Mix, TableRead, SfPlayer, OSC objects, etc.) still take
+        the GIL for their own processing.
+
+        Only used by real-time audio backends (portaudio, coreaudio and jack)
+        and by the embedded backend. Each interpreter has its own lock, so
+        servers embedded in different sub-interpreters compute their buffers
+        concurrently. Must be called before booting the server.
+
+        :Args:
+
+            x : boolean
+                True to compute the streams without the GIL. Defaults to False.
+
+        """
+        self._server.setGILFree(x)
+
+    def setProfiling(self, x):
+        """
+        Start or stop the per-stream profiler.
+
+        While profiling, the server measures the time spent in every audio
+        stream. Starting the profiler resets the measurements. When stopped,
+        the profiler doesn't add any cost to the processing.
+
+        :Args:
+
+            x : boolean
+                True to start profiling, False to stop.
+
+        """
+        self._server.setProfiling(x)
+
+    def getProfile(self):
+        """
+        Return the processing time of the audio streams since profiling started.
+
+        The result is a dictionary keyed by stream id. Each value is a dictionary
+        with the following keys:
+
+        - type : name of the object's type.
+        - count : number of buffers computed.
+        - total : total time, in seconds.
+        - max : longest buffer, in seconds.
+
+        """
+        return self._server.getProfile()
+
+    def getMemory(self):
+        """
+        Return the heap memory used by the audio objects, summed by type.
+
+        The result is a dictionary keyed by type name. Each value is a list
+        [count, bytes], the number of streams of this type and the memory
+        they own (audio buffers, delay lines, analysis frames, grains, ...).
+        The tables and matrices still referenced are included, under the
+        name of their class.
+
+        """
+        memory = self._server.getMemory()
+        for obj in gc.get_objects():
+            if isinstance(obj, (PyoTableObject, PyoMatrixObject)):
+                entry = memory.setdefault(obj.__class__.__name__, [0, 0])
+                entry[0] += len(obj)
+                entry[1] += obj.getMemory()
+        return memory
+
+    def getCallbackStats(self):
+        """
+        Return the timing of the audio callbacks since the server started.
+
+        Each callback is timed against its deadline, the duration of the
+        host buffer. The result is a dictionary with the following keys:
+
+        - deadline : duration of the host buffer, in seconds.
+        - count : number of callbacks.
+        - late : callbacks longer than the deadline.
+        - underflows, overflows : reported by the audio driver (portaudio).
+        - xruns : reported by the audio server (jack, coreaudio).
+        - mean, max : callback time, in seconds.
+        - binwidth : width of a bin of the histogram, in percent of the deadline.
+        - histogram : count of callbacks per bin of load, the last bin holds
+          all the longer callbacks.
+        - worst : list of (server time, callback time) of the longest
+          callbacks, in seconds, longest first.
+
+        """
+        return self._server.getCallbackStats()
+
+    def resetCallbackStats(self):
+        """
+        Clear the timing of the audio callbacks.
+
+        """
+        self._server.resetCallbackStats()
+
+    def setCallbackLog(self, path=True):
+        """
+        Log the late callbacks and the xruns.
+
+        A thread writes one line per event: the server time, the callback
+        time, the load and the kind of event.
+
+        :Args:
+
+            path : string, boolean or None, optional
+                File where the events are appended. True logs to stderr,
+                None or False stops logging. Defaults to True.
+
+        """
+        self._server.setCallbackLog(path)
+
     def setStartOffset(self, x):
         """
         Set the server's starting time offset. First `x` seconds will be rendered
@@ -507,6 +865,101 @@ class Server(object):
         self._amp = x
         self._server.setAmp(x)
 
+    def addBus(self, name, chnls=1):
+        """
+        Add a named internal bus to the server.
+
+        Objects send their signal to the bus with their `send` method and
+        BusIn objects read it. The server owns the bus buffers, they are
+        freed when the server shuts down. Returns a tuple (first channel,
+        number of channels); adding a bus that exists returns the existing
+        bus.
+
+        Must be called after booting the server.
+
+        :Args:
+
+            name : string
+                Name of the bus.
+            chnls : int, optional
+                Number of channels of the bus. Defaults to 1.
+
+        """
+        return self._server.addBus(name, chnls)
+
+    def addShmWorker(self, name, send=None, receive=None):
+        """
+        Add a worker process computing blocks of the buses of this server.
+
+        The worker is a pyo server booted and started, in another process,
+        with the 'shm' audio backend and the same buffer size as this server
+        (`jackname` gives its name). At every block, the worker gets the
+        channels of the bus `send`, as its inputs, and its outputs are summed
+        in the bus `receive`, read by the objects of this server at the next
+        block, as with any bus. The worker computes its block while this
+        server computes its own objects.
+
+        The blocks go through lock-free rings in shared memory, without any
+        audio server between the processes. An answer which doesn't come
+        within a block is skipped. Returns True if the worker is added.
+
+        Must be called after booting the server and adding the buses.
+        Not available on Windows.
+
+        :Args:
+
+            name : string
+                Name of the worker server.
+            send : string, optional
+                Bus whose channels are the inputs of the worker, it must have
+                as many channels. Defaults to None, the worker gets silence.
+            receive : string, optional
+                Bus where the outputs of the worker are summed, it must have
+                as many channels. Defaults to None, the outputs are ignored.
+
+        >>> # worker process
+        >>> s = Server(nchnls=2, ichnls=2, audio='shm', jackname='reverb').boot().start()
+        >>> rev = WGVerb(Input([0,1]), feedback=0.8).out()
+        >>> # main process
+        >>> s = Server().boot()
+        >>> s.addBus("dry", 2)
+        >>> s.addBus("wet", 2)
+        >>> s.addShmWorker("reverb", send="dry", receive="wet")
+
+        """
+        if not hasattr(self._server, "addShmWorker"):
+            print "Server error: shared memory workers are not available on Windows."
+            return False
+        sendargs = self._busChannels(send)
+        receiveargs = self._busChannels(receive)
+        if sendargs is None or receiveargs is None:
+            return False
+        return self._server.addShmWorker(name, sendargs[0], sendargs[1], receiveargs[0], receiveargs[1])
+
+    def _busChannels(self, name):
+        if name is None:
+            return (-1, 0)
+        bus = self._server.getBus(name)
+        if bus is None:
+            print "Server error: no bus named %s." % name
+        return bus
+
+    def getBus(self, name):
+        """
+        Return a tuple (first channel, number of channels) for the bus
+        `name`, or None if the server has no bus with that name.
+
+        """
+        return self._server.getBus(name)
+
+    def getBuses(self):
+        """
+        Return a dictionary of the server's buses, with their names as keys
+        and tuples (first channel, number of channels) as values.
+
+        """
+        return self._server.getBuses()
+
     def shutdown(self):
         """
         Shut down and clear the server. This method will erase all objects
@@ -553,7 +1006,7 @@ class Server(object):
         """
         self._server.stop()
 
-    def recordOptions(self, dur=-1, filename=None, fileformat=0, sampletype=0):
+    def recordOptions(self, dur=-1, filename=None, fileformat=0, sampletype=0, sync=False):
         """
         Sets options for soundfile created by offline rendering or global recording.
 
@@ -590,6 +1043,17 @@ class Server(object):
                     4. 64 bits float
                     5. U-Law encoded
                     6. A-Law encoded
+            sync : boolean, optional
+                If True, the recorded data is periodically committed to the
+                disk and dropped from the system's file cache, so that a long
+                recording doesn't evict the sounds read by the players.
+                Has no effect on Windows. Defaults to False.
+
+        .. note::
+
+            The file is written by a separated thread, the audio callback
+            never waits for the disk. Offline, the rendering waits for the
+            thread when it gets too far ahead.
 
         """
 
@@ -608,7 +1072,8 @@ class Server(object):
             print 'Warning: Filename has no extension. Using fileformat value.'
         self._fileformat = fileformat
         self._sampletype = sampletype
-        self._server.recordOptions(dur, filename, fileformat, sampletype)
+        self._sync = sync
+        self._server.recordOptions(dur, filename, fileformat, sampletype, sync)
 
     def recstart(self, filename=None):
         """
@@ -636,7 +1101,7 @@ class Server(object):
                 fileformat = FILE_FORMATS[ext]
                 if fileformat != self._fileformat:
                     self._fileformat = fileformat
-                    self._server.recordOptions(self._dur, filename, self._fileformat, self._sampletype)
+                    self._server.recordOptions(self._dur, filename, self._fileformat, self._sampletype, self._sync)
 
         self._server.recstart(filename)
 
@@ -821,6 +1286,15 @@ class Server(object):
         """
         return self._server.getBufferSize()
 
+    def getElapsedSamples(self):
+        """
+        Return the number of samples computed since the server was started.
+
+        This is the time base of the PyoObject.setAt method.
+
+        """
+        return self._server.getElapsedSamples()
+
     def getGlobalSeed(self):
         """
         Return the current global seed.
@@ -905,6 +1379,16 @@ class Server(object):
         """
         return self._server.getEmbedICallbackAddr()
 
+    def getEmbedPCallback(self):
+        """
+        Return the addresses, as integers, of the server and of the planar embedded callback
+
+        The callback computes the host buffers without holding the GIL, its prototype is:
+        int (*callback)(void *server, float **ins, float **outs, int frames)
+
+        """
+        return self._server.getEmbedPCallback()
+
     @property
     def amp(self):
         """float. Overall amplitude."""
@@ -939,4 +1423,158 @@ class Server(object):
         if (type(x) == int):
             self.setGlobalSeed(x)
         else:
-            raise Exception("global seed must be an integer")
\ No newline at end of file
+            raise Exception("global seed must be an integer")
+######################################################################
+### Parallel offline rendering
+######################################################################
+def _render_offline_job(job):
+    """
+    Renders one OfflineBatch job. Called in a fresh child process.
+
+    """
+    result = {"filename": job["filename"], "dur": job["dur"], "time": 0.0, "speed": 0.0, "error": None}
+    try:
+        s = Server(sr=job["sr"], nchnls=job["nchnls"], buffersize=job["buffersize"], duplex=0, audio="offline")
+        s.setVerbosity(job["verbosity"])
+        s.boot()
+        s.recordOptions(dur=job["dur"], filename=job["filename"], fileformat=job["fileformat"], sampletype=job["sampletype"])
+        if isinstance(job["target"], basestring):
+            env = dict(vars(current_pyo))
+            env.update({"__name__": "__main__", "__file__": job["target"], "s": s, "args": job["args"]})
+            execfile(job["target"], env)
+            graph = env
+        else:
+            graph = job["target"](s, *job["args"])
+        t = time.time()
+        s.start()
+        result["time"] = time.time() - t
+        if result["time"] > 0:
+            result["speed"] = job["dur"] / result["time"]
+        del graph
+        s.shutdown()
+    except:
+        result["error"] = traceback.format_exc()
+    return result
+
+class OfflineBatch(object):
+    """
+    Renders several offline jobs in parallel, faster than realtime.
+
+    Every job is rendered in its own process, with its own offline Server
+    and its own output soundfile, so the jobs never compete for the python
+    interpreter lock or for the current server. Jobs are distributed on
+    `processes` processes, and each process renders only one job before
+    being replaced.
+
+    A job is either a function or the path of a python script:
+
+    - A function is called as `function(server, *args)` with the booted
+      offline server. It must build the processing chain and return the
+      objects that must be kept alive during the rendering (the returned
+      value is discarded after the rendering). The function must be
+      defined at the top level of a module (it is sent to the child
+      process by pickling).
+    - A script is executed in a namespace containing the pyo objects, the
+      booted offline server as `s` and the job arguments as `args`. It must
+      not create its own server nor call `s.start()`.
+
+    :Args:
+
+        processes : int, optional
+            Number of jobs rendered at the same time. None means the number
+            of cores of the machine. Defaults to None.
+        sr : int, optional
+            Default sampling rate of the jobs. Defaults to 44100.
+        nchnls : int, optional
+            Default number of output channels of the jobs. Defaults to 2.
+        buffersize : int, optional
+            Default buffer size of the jobs. Defaults to 256.
+        fileformat : int, optional
+            Default format of the output soundfiles (see Server.recordOptions).
+            Defaults to 0.
+        sampletype : int, optional
+            Default bit depth of the output soundfiles (see Server.recordOptions).
+            Defaults to 0.
+
+    >>> def stem(s, freq):
+    ...     return Sine(freq, mul=0.3).out()
+    >>> batch = OfflineBatch()
+    >>> for i in range(8):
+    ...     batch.add(stem, "stem_%d.wav" % i, dur=10, args=(100*(i+1),))
+    >>> for res in batch.run():
+    ...     print res["filename"], res["speed"]
+
+    """
+    def __init__(self, processes=None, sr=44100, nchnls=2, buffersize=256, fileformat=0, sampletype=0):
+        self._processes = processes
+        self._defaults = {"sr": sr, "nchnls": nchnls, "buffersize": buffersize, "fileformat": fileformat,
+                          "sampletype": sampletype, "verbosity": 1}
+        self._jobs = []
+        self._results = []
+
+    def add(self, job, filename, dur, args=(), **kwargs):
+        """
+        Adds a job to the batch. Returns the index of the job.
+
+        :Args:
+
+            job : function or string
+                Function building the processing chain or path of a script.
+            filename : string
+                Path of the output soundfile.
+            dur : float
+                Duration, in seconds, of the rendering.
+            args : tuple, optional
+                Arguments given to the function, or to the script as `args`.
+                Defaults to ().
+
+        Keyword arguments `sr`, `nchnls`, `buffersize`, `fileformat`,
+        `sampletype` and `verbosity` override the batch defaults for this job.
+
+        """
+        d = dict(self._defaults)
+        for key in kwargs:
+            if key not in d:
+                raise TypeError("OfflineBatch.add() got an unexpected keyword argument '%s'" % key)
+        d.update(kwargs)
+        d.update({"target": job, "filename": filename, "dur": float(dur), "args": tuple(args)})
+        self._jobs.append(d)
+        return len(self._jobs) - 1
+
+    def clear(self):
+        """
+        Removes all jobs and results from the batch.
+
+        """
+        self._jobs = []
+        self._results = []
+
+    def run(self):
+        """
+        Renders all the jobs and waits until they are done.
+
+        Returns a list, in the order the jobs were added, of dictionaries
+        with the following keys:
+
+        - filename : path of the output soundfile.
+        - dur : rendered duration, in seconds.
+        - time : time spent rendering the job, in seconds.
+        - speed : throughput of the job, as a multiple of realtime.
+        - error : traceback of the exception raised by the job, or None.
+
+        """
+        import multiprocessing
+        pool = multiprocessing.Pool(self._processes, maxtasksperchild=1)
+        try:
+            self._results = pool.map(_render_offline_job, self._jobs, chunksize=1)
+        finally:
+            pool.close()
+            pool.join()
+        return self._results
+
+    def getResults(self):
+        """
+        Returns the results of the last call to `run`.
+
+        """
+        return self._results
@@ -530,6 +530,7 @@ class OscBank(PyoObject):
         self._arndf = arndf
         self._arnda = arnda
         self._fjit = fjit
+        self._quadrature = False
         self._num = num
         table, freq, spread, slope, frndf, frnda, arndf, arnda, num, fjit, mul, add, lmax = convertArgsToLists(table, freq, spread, slope, frndf, frnda, arndf, arnda, num, fjit, mul, add)
         self._base_objs = [OscBank_base(wrap(table,i), wrap(freq,i), wrap(spread,i), wrap(slope,i), wrap(frndf,i), wrap(frnda,i), wrap(arndf,i), wrap(arnda,i), wrap(num,i), wrap(fjit,i), wrap(mul,i), wrap(add,i)) for i in range(lmax)]
@@ -660,6 +661,25 @@ class OscBank(PyoObject):
         x, lmax = convertArgsToLists(x)
         [obj.setFjit(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
 
+    def setQuadrature(self, x):
+        """
+        Switches the oscillators between table lookup and quadrature.
+
+        In quadrature mode, each oscillator is a phasor rotated
+        at every sample, which gives a pure sine without any table
+        read. The waveform of `table` is then ignored.
+
+        :Args:
+
+            x : boolean
+                True to use quadrature oscillators, False to read
+                `table`.
+
+        """
+        self._quadrature = x
+        x, lmax = convertArgsToLists(x)
+        [obj.setQuadrature(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def ctrl(self, map_list=None, title=None, wxnoserver=False):
         self._map_list = [SLMap(0.001, 15000, "log", "freq", self._freq),
                           SLMap(0.001, 2, "log", "spread", self._spread),
@@ -734,6 +754,13 @@ class OscBank(PyoObject):
     @fjit.setter
     def fjit(self, x): self.setFjit(x)
 
+    @property
+    def quadrature(self):
+        """boolean. Uses quadrature oscillators instead of the table."""
+        return self._quadrature
+    @quadrature.setter
+    def quadrature(self, x): self.setQuadrature(x)
+
 class TableRead(PyoObject):
     """
     Simple waveform table reader.
@@ -1497,6 +1524,10 @@ class TableRec(PyoObject):
         obj['time'] outputs an audio stream of the current recording time,
         in samples.
 
+        With a NewTable created with `chunked` set to True, the recording
+        goes on past the end of the table, which grows, until the stop
+        method is called. No trigger is sent and there is no fade out.
+
     .. seealso::
 
         :py:class:`NewTable`, :py:class:`TrigTableRec`
@@ -22,7 +22,7 @@ from _maps import *
 from _widgets import createGraphWindow, createDataGraphWindow, createSndViewTableWindow
 from types import ListType
 from math import pi
-import copy
+import copy, os
 
 ######################################################################
 ### Tables
@@ -1343,6 +1343,38 @@ class SndTable(PyoTableObject):
             Stops reading at `stop` seconds into the file. Available at
             initialization time only. The default (None) means the end of
             the file.
+        initchnls : int, optional
+            Number of channels of an empty table. Defaults to 1.
+        cache : string, optional
+            Directory where raw copies of the sounds are kept. When given,
+            the table samples are memory-mapped from these copies instead
+            of being read in memory. The first load of a sound writes its
+            copy, the next ones only map it, whatever the size of the sound,
+            and the samples are paged in when they are read. Available at
+            initialization time only. Defaults to None.
+        storage : int, optional
+            Format of the samples kept in memory. Available at initialization
+            time only. Ignored for memory-mapped tables. Defaults to 0.
+                0. native float (64 bits with pyo64)
+                1. 32 bits float, halves the memory used with pyo64
+                2. 16 bits int, quantizes the samples
+
+    .. note::
+
+        Methods modifying the samples of a memory-mapped table work on
+        private copies of the modified pages, the cache files are never
+        altered. Appending or inserting a sound loads the table in memory.
+
+        SndTables loaded in memory from the same channel and region of a
+        file share their samples, the sound is decoded only once. A table
+        gets its own copy of the samples when one of its methods modifies
+        them, the other tables are left untouched.
+
+        Osc, OscTrig, Pointer2, Pulsar, TableRead, TrigEnv and Looper read
+        the compact storage formats directly. The other objects, and the
+        methods reading the samples, work on a native copy made at their
+        first access. A method modifying the samples converts the table
+        back to the native format.
 
     >>> s = Server().boot()
     >>> s.start()
@@ -1352,12 +1384,13 @@ class SndTable(PyoTableObject):
     >>> a = Osc(table=t, freq=[freq, freq*.995], mul=.3).out()
 
     """
-    def __init__(self, path=None, chnl=None, start=0, stop=None, initchnls=1):
+    def __init__(self, path=None, chnl=None, start=0, stop=None, initchnls=1, cache=None, storage=0):
         PyoTableObject.__init__(self)
         self._path = path
         self._chnl = chnl
         self._start = start
         self._stop = stop
+        self._cache = cache
         self._size = []
         self._dur = []
         self._base_objs = []
@@ -1365,18 +1398,23 @@ class SndTable(PyoTableObject):
         if self._path == None:
             self._base_objs = [SndTable_base("", 0, 0) for i in range(initchnls)]
         else:
+            kwargs = {"storage": storage}
+            if cache != None:
+                if not os.path.isdir(cache):
+                    os.makedirs(cache)
+                kwargs["cache"] = cache
             for p in path:
                 _size, _dur, _snd_sr, _snd_chnls, _format, _type = sndinfo(p)
                 if chnl == None:
                     if stop == None:
-                        self._base_objs.extend([SndTable_base(p, i, start) for i in range(_snd_chnls)])
+                        self._base_objs.extend([SndTable_base(p, i, start, **kwargs) for i in range(_snd_chnls)])
                     else:
-                        self._base_objs.extend([SndTable_base(p, i, start, stop) for i in range(_snd_chnls)])
+                        self._base_objs.extend([SndTable_base(p, i, start, stop, **kwargs) for i in range(_snd_chnls)])
                 else:
                     if stop == None:
-                        self._base_objs.append(SndTable_base(p, chnl, start))
+                        self._base_objs.append(SndTable_base(p, chnl, start, **kwargs))
                     else:
-                        self._base_objs.append(SndTable_base(p, chnl, start, stop))
+                        self._base_objs.append(SndTable_base(p, chnl, start, stop, **kwargs))
                 self._size.append(self._base_objs[-1].getSize())
                 self._dur.append(self._size[-1] / float(_snd_sr))
             if lmax == 1:
@@ -1697,6 +1735,85 @@ class SndTable(PyoTableObject):
     @size.setter
     def size(self, x): print "SndTable 'size' attribute is read-only."
 
+def loadSndTables(paths, chnl=None, start=0, stop=None, resample=False, threads=0, lazy=False):
+    """
+    Loads many sounds in SndTables, decoding them with a pool of threads.
+
+    Returns the list of SndTables, in the order of `paths`, once every
+    sound is loaded. With `lazy` set to True, returns a generator giving
+    each SndTable as soon as its sound is loaded.
+
+    :Args:
+
+        paths : list of strings
+            Full paths of the sounds to load, one SndTable per sound.
+        chnl : int, optional
+            Channel number to read in. Available at initialization
+            time only. None means all channels. Defaults to None.
+        start : float, optional
+            Begins reading at `start` seconds into the files. Defaults to 0.
+        stop : float, optional
+            Stops reading at `stop` seconds into the files. None means the
+            end of the files. Defaults to None.
+        resample : boolean, optional
+            If True, the sounds whose sampling rate differs from the server's
+            one are converted to the server's sampling rate (windowed-sinc
+            polyphase filter). getRate() then reflects the server's rate.
+            Sounds later loaded in the tables with setSound are converted
+            too, appended or inserted sounds are not. Defaults to False.
+        threads : int, optional
+            Number of loading threads. 0 means one thread per processor.
+            Defaults to 0.
+        lazy : boolean, optional
+            If True, returns a generator of the SndTables, in the order
+            they are loaded. Defaults to False.
+
+    >>> s = Server().boot()
+    >>> s.start()
+    >>> paths = [SNDS_PATH + '/transparent.aif', SNDS_PATH + '/accord.aif']
+    >>> tables = loadSndTables(paths, resample=True)
+    >>> a = Osc(tables[0], freq=tables[0].getRate(), mul=.3).out()
+
+    """
+    tables = []
+    jobs = []
+    owners = []
+    for p in paths:
+        _size, _dur, _snd_sr, _snd_chnls, _format, _type = sndinfo(p)
+        if chnl == None:
+            chnls = range(_snd_chnls)
+        else:
+            chnls = [chnl]
+        t = SndTable(initchnls=len(chnls))
+        t._path, t._chnl, t._start, t._stop = p, chnl, start, stop
+        for obj, c in zip(t._base_objs, chnls):
+            jobs.append((obj, p, c, start, -1 if stop == None else stop))
+            owners.append(len(tables))
+        tables.append(t)
+    loader = SndTableLoader_base(jobs, threads, int(resample))
+
+    def loaded(t):
+        t._size = t._base_objs[0].getSize()
+        t._dur = 1. / t._base_objs[0].getRate()
+        return t
+
+    if not lazy:
+        while loader.wait() != None:
+            pass
+        return [loaded(t) for t in tables]
+
+    def generator():
+        remaining = [len(t._base_objs) for t in tables]
+        while True:
+            index = loader.wait()
+            if index == None:
+                break
+            owner = owners[index]
+            remaining[owner] -= 1
+            if remaining[owner] == 0:
+                yield loaded(tables[owner])
+    return generator()
+
 class NewTable(PyoTableObject):
     """
     Create an empty table ready for recording.
@@ -1718,6 +1835,19 @@ class NewTable(PyoTableObject):
             Defaults to None.
         feedback : float, optional
             Amount of old data to mix with a new recording. Defaults to 0.0.
+        chunked : boolean, optional
+            If True, the table grows, by pages of 65536 samples, when a
+            TableRec records past its end. The samples already recorded are
+            never moved or copied by the audio thread. Available at
+            initialization time only. Defaults to False.
+
+    .. note::
+
+        A chunked table that has grown is read in place by Osc, OscTrig,
+        Pointer2, Pulsar, TableRead, TrigEnv and Looper, and written in
+        place by TableWrite. The other objects work on a copy refreshed
+        each time the table grows. The methods of the table first gather
+        the pages in a single block.
 
     .. seealso::
 
@@ -1735,20 +1865,38 @@ class NewTable(PyoTableObject):
     >>> # b.play()
 
     """
-    def __init__(self, length, chnls=1, init=None, feedback=0.0):
+    def __init__(self, length, chnls=1, init=None, feedback=0.0, chunked=False):
         PyoTableObject.__init__(self)
         self._length = length
         self._chnls = chnls
         self._init = init
         self._feedback = feedback
+        self._chunked = chunked
         if init == None:
-            self._base_objs = [NewTable_base(length, None, feedback) for i in range(chnls)]
+            self._base_objs = [NewTable_base(length, None, feedback, int(chunked)) for i in range(chnls)]
         else:
             if type(init[0]) != ListType:
                 init = [init]
-            self._base_objs = [NewTable_base(length, wrap(init,i), feedback) for i in range(chnls)]
+            self._base_objs = [NewTable_base(length, wrap(init,i), feedback, int(chunked)) for i in range(chnls)]
         self._size = self._base_objs[0].getSize()
 
+    def getSize(self, all=False):
+        """
+        Return table size in samples. The size of a chunked table grows
+        with the recording.
+
+        :Args:
+
+            all : boolean
+                If the table contains more than one stream and `all` is True,
+                returns a list of all sizes. Otherwise, returns only the
+                first size as an int. Defaults to False.
+
+        """
+        if self._chunked:
+            self._size = self._base_objs[0].getSize()
+        return PyoTableObject.getSize(self, all)
+
     def replace(self, x):
         """
         Replaces the actual table.
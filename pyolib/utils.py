@@ -573,11 +573,19 @@ class Record(PyoObject):
 
             High buffering uses more memory but improves performance.
             Defaults to 4.
+        ringdur : float, optional
+            Duration, in seconds, of the ring buffer between the audio
+            thread and the disk writer thread. Blocks that don't fit in
+            the ring when the disk is too slow are dropped, see
+            getOverflows(). Defaults to 2.
 
     .. note::
 
         All parameters can only be set at intialization time.
 
+        The file is written by a separated thread, the audio thread never
+        waits for the disk.
+
         The stop() method must be called on the object to close the file
         properly.
 
@@ -600,7 +608,7 @@ class Record(PyoObject):
     >>> clean.start()
 
     """
-    def __init__(self, input, filename, chnls=2, fileformat=0, sampletype=0, buffering=4):
+    def __init__(self, input, filename, chnls=2, fileformat=0, sampletype=0, buffering=4, ringdur=2.0):
         PyoObject.__init__(self)
         self._input = input
         self._in_fader = InputFader(input)
@@ -613,11 +621,19 @@ class Record(PyoObject):
                 print 'Warning: Unknown file extension. Using fileformat value.'
         else:
             print 'Warning: Filename has no extension. Using fileformat value.'
-        self._base_objs = [Record_base(self._in_fader.getBaseObjects(), filename, chnls, fileformat, sampletype, buffering)]
+        self._base_objs = [Record_base(self._in_fader.getBaseObjects(), filename, chnls, fileformat, sampletype, buffering, ringdur)]
 
     def out(self, chnl=0, inc=1, dur=0, delay=0):
         return self.play(dur, delay)
 
+    def getOverflows(self):
+        """
+        Returns the number of blocks and the number of frames dropped
+        because the ring buffer was full, as a tuple (blocks, frames).
+
+        """
+        return self._base_objs[0].getOverflows()
+
     def setInput(self, x, fadetime=0.05):
         """
         Replace the `input` attribute.
@@ -648,6 +664,12 @@ class Denorm(PyoObject):
     Can be used before IIR filters and reverbs to avoid denormalized numbers which may
     otherwise result in significantly increased CPU usage.
 
+    .. note::
+
+        By default, the server already flushes denormals to zero on x86 and arm64
+        processors (see Server.setFlushDenormals), Denorm is only useful when this
+        mode is disabled or not supported.
+
     :Parent: :py:class:`PyoObject`
 
     :Args:
@@ -692,6 +714,12 @@ class Denorm(PyoObject):
     @input.setter
     def input(self, x): self.setInput(x)
 
+def _isEventFile(path):
+    f = open(path, "rb")
+    magic = f.read(4)
+    f.close()
+    return magic == "PYEV"
+
 class ControlRec(PyoObject):
     """
     Records control values and writes them in a text file.
@@ -703,6 +731,12 @@ class ControlRec(PyoObject):
     Each line in the text files contains two values, the absolute time
     in seconds and the sampled value.
 
+    In binary mode, the values are written in event files while they are
+    recorded, by a background thread, instead of being kept in memory.
+    Each event holds the time in samples and the sampled value. This is
+    the format to use for long recordings, ControlRead maps the files
+    instead of loading them.
+
     The play() method starts the recording and is not called at the
     object creation time.
 
@@ -728,13 +762,17 @@ class ControlRec(PyoObject):
 
             If greater than 0.0, the `stop` method is automatically called
             at the end of the recording.
+        binary : boolean, optional
+            If True, the values are written in binary event files during
+            the recording. Defaults to False.
 
     .. note::
 
         All parameters can only be set at intialization time.
 
         The write() method must be called on the object to write the files
-        on the disk.
+        on the disk. In binary mode, it writes the pending events and
+        completes the files. Calling play() again starts new files.
 
         The out() method is bypassed. ControlRec's signal can not be sent to
         audio outs.
@@ -758,16 +796,20 @@ class ControlRec(PyoObject):
     >>> call = CallAfter(function=write_files, time=4.5)
 
     """
-    def __init__(self, input, filename, rate=1000, dur=0.0):
+    def __init__(self, input, filename, rate=1000, dur=0.0, binary=False):
         PyoObject.__init__(self)
         self._input = input
         self._filename = filename
         self._path, self._name = os.path.split(filename)
         self._rate = rate
         self._dur = dur
+        self._binary = binary
         self._in_fader = InputFader(input)
         in_fader, lmax = convertArgsToLists(self._in_fader)
-        self._base_objs = [ControlRec_base(wrap(in_fader,i), rate, dur) for i in range(lmax)]
+        if binary:
+            self._base_objs = [ControlRec_base(wrap(in_fader,i), rate, dur, os.path.join(self._path, "%s_%03d" % (self._name, i))) for i in range(lmax)]
+        else:
+            self._base_objs = [ControlRec_base(wrap(in_fader,i), rate, dur) for i in range(lmax)]
 
     def out(self, chnl=0, inc=1, dur=0, delay=0):
         return self.play(dur, delay)
@@ -776,18 +818,35 @@ class ControlRec(PyoObject):
         """
         Writes recorded values in text files on the disk.
 
+        In binary mode, completes the event files.
+
         """
+        if self._binary:
+            [obj.close() for obj in self._base_objs]
+            return
         for i, obj in enumerate(self._base_objs):
             f = open(os.path.join(self._path, "%s_%03d" % (self._name, i)), "w")
             [f.write("%f %f\n" % p) for p in obj.getData()]
             f.close()
 
+    def getDropped(self):
+        """
+        Returns the number of values dropped, for each stream, because
+        the disk was too slow in binary mode.
+
+        """
+        return [obj.getDropped() for obj in self._base_objs]
+
 class ControlRead(PyoObject):
     """
     Reads control values previously stored in text files.
 
     Read sampled sound from a table, with optional looping mode.
 
+    The binary event files written by a ControlRec in binary mode are
+    mapped in memory instead of being loaded, their values are read at
+    their recorded times.
+
     :Parent: :py:class:`PyoObject`
 
     :Args:
@@ -802,6 +861,9 @@ class ControlRead(PyoObject):
             named "filename_xxx" will add a new stream in the object.
         rate : int, optional
             Rate at which the values are sampled. Defaults to 1000.
+
+            Not used by the binary event files, which hold the time
+            of each value.
         loop : boolean, optional
             Looping mode, False means off, True means on.
             Defaults to False.
@@ -850,6 +912,9 @@ class ControlRead(PyoObject):
         self._base_objs = []
         for i in range(len(files)):
             path = os.path.join(self._path, files[i])
+            if _isEventFile(path):
+                self._base_objs.append(ControlRead_base(path, rate, loop, interp, wrap(mul,i), wrap(add,i)))
+                continue
             f = open(path, "r")
             values = [float(l.split()[1]) for l in f.readlines()]
             f.close()
@@ -859,6 +924,22 @@ class ControlRead(PyoObject):
     def out(self, chnl=0, inc=1, dur=0, delay=0):
         return self.play(dur, delay)
 
+    def seek(self, x):
+        """
+        Moves the reading position.
+
+        The position in a binary event file is found with a binary
+        search, a seek doesn't depend on the length of the recording.
+
+        :Args:
+
+            x : float
+                New position, in seconds.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.seek(wrap(x,i)) for i, obj in enumerate(self._base_objs)]
+
     def setRate(self, x):
         """
         Replace the `rate` attribute.
@@ -933,6 +1014,12 @@ class NoteinRec(PyoObject):
     Each line in the text files contains three values, the absolute time
     in seconds, the Midi pitch and the normalized velocity.
 
+    In binary mode, the notes are written in event files while they are
+    recorded, by a background thread, instead of being kept in memory.
+    Each event holds the time in samples, the Midi pitch and the
+    normalized velocity. NoteinRead maps the files instead of loading
+    them.
+
     The play() method starts the recording and is not called at the
     object creation time.
 
@@ -950,13 +1037,17 @@ class NoteinRec(PyoObject):
 
             The same filename can be passed to a NoteinRead object to read
             all related files.
+        binary : boolean, optional
+            If True, the notes are written in binary event files during
+            the recording. Defaults to False.
 
     .. note::
 
         All parameters can only be set at intialization time.
 
         The `write` method must be called on the object to write the files
-        on the disk.
+        on the disk. In binary mode, it writes the pending events and
+        completes the files. Calling play() again starts new files.
 
         The out() method is bypassed. NoteinRec's signal can not be sent to
         audio outs.
@@ -975,15 +1066,19 @@ class NoteinRec(PyoObject):
     >>> # call rec.write() to save "test_000" and "test_001" in the home directory.
 
     """
-    def __init__(self, input, filename):
+    def __init__(self, input, filename, binary=False):
         PyoObject.__init__(self)
         self._input = input
         self._filename = filename
         self._path, self._name = os.path.split(filename)
+        self._binary = binary
         self._in_pitch = self._input["pitch"]
         self.in_velocity = self._input["velocity"]
         in_pitch, in_velocity, lmax = convertArgsToLists(self._in_pitch, self.in_velocity)
-        self._base_objs = [NoteinRec_base(wrap(in_pitch,i), wrap(in_velocity,i)) for i in range(lmax)]
+        if binary:
+            self._base_objs = [NoteinRec_base(wrap(in_pitch,i), wrap(in_velocity,i), os.path.join(self._path, "%s_%03d" % (self._name, i))) for i in range(lmax)]
+        else:
+            self._base_objs = [NoteinRec_base(wrap(in_pitch,i), wrap(in_velocity,i)) for i in range(lmax)]
 
     def out(self, chnl=0, inc=1, dur=0, delay=0):
         return self.play(dur, delay)
@@ -992,16 +1087,32 @@ class NoteinRec(PyoObject):
         """
         Writes recorded values in text files on the disk.
 
+        In binary mode, completes the event files.
+
         """
+        if self._binary:
+            [obj.close() for obj in self._base_objs]
+            return
         for i, obj in enumerate(self._base_objs):
             f = open(os.path.join(self._path, "%s_%03d" % (self._name, i)), "w")
             [f.write("%f %f %f\n" % p) for p in obj.getData()]
             f.close()
 
+    def getDropped(self):
+        """
+        Returns the number of notes dropped, for each stream, because
+        the disk was too slow in binary mode.
+
+        """
+        return [obj.getDropped() for obj in self._base_objs]
+
 class NoteinRead(PyoObject):
     """
     Reads Notein values previously stored in text files.
 
+    The binary event files written by a NoteinRec in binary mode are
+    mapped in memory instead of being loaded.
+
     :Parent: :py:class:`PyoObject`
 
     :Args:
@@ -1058,6 +1169,11 @@ class NoteinRead(PyoObject):
         self._poly = len(files)
         for i in range(self._poly):
             path = os.path.join(self._path, files[i])
+            if _isEventFile(path):
+                self._base_objs.append(NoteinRead_base(path, 0, loop))
+                self._base_objs.append(NoteinRead_base(path, 1, loop, wrap(mul,i), wrap(add,i)))
+                _trig_objs_tmp.append(TriggerDummy_base(self._base_objs[-1]))
+                continue
             f = open(path, "r")
             vals = [l.split() for l in f.readlines()]
             timestamps = [float(v[0]) for v in vals]
@@ -1109,6 +1225,22 @@ class NoteinRead(PyoObject):
     def out(self, chnl=0, inc=1, dur=0, delay=0):
         return self.play(dur, delay)
 
+    def seek(self, x):
+        """
+        Moves the reading position.
+
+        The next note is found with a binary search, a seek doesn't
+        depend on the length of the recording.
+
+        :Args:
+
+            x : float
+                New position, in seconds.
+
+        """
+        x, lmax = convertArgsToLists(x)
+        [obj.seek(wrap(x,i//2)) for i, obj in enumerate(self._base_objs)]
+
     def setLoop(self, x):
         """
         Replace the `loop` attribute.
@@ -1915,4 +2047,134 @@ class TrackHold(PyoObject):
         """float or PyoObject. Target value."""
         return self._value
     @value.setter
-    def value(self, x): self.setValue(x)
\ No newline at end of file
+    def value(self, x): self.setValue(x)
+
+
+class Unit(PyoObject):
+    """
+    Hosts a block processing unit written in C.
+
+    A unit is a DSP routine described by a PyoUnit struct (see
+    include/pyounit.h): its process function computes a block of samples
+    of each of its outputs from its inputs and parameters. Units are
+    registered in pyo by name, with the externals, or exported by another
+    extension module as a capsule.
+
+    The streams of the object are the outputs of the unit, all the outputs
+    of the first channel, then all the outputs of the second, and so on.
+
+    :Parent: :py:class:`PyoObject`
+
+    :Args:
+
+        unit : string or capsule
+            Name of a registered unit, or capsule exported by an extension
+            module.
+        input : PyoObject or list of PyoObjects, optional
+            Input signal of each input of the unit. Defaults to None, for
+            a unit without input.
+        params : dict, optional
+            Initial values of the parameters, floats or PyoObjects, by name.
+            Missing parameters keep the initial value of the unit.
+
+    .. note::
+
+        The function unitInfo(unit) gives the inputs, outputs and parameters
+        of a unit.
+
+    >>> s = Server().boot()
+    >>> s.start()
+    >>> a = SineLoop([249,250], feedback=0.07)
+    >>> b = Unit("gain", a, params={"db": Sine(1, mul=10, add=-20)}).out()
+
+    """
+    def __init__(self, unit, input=None, params={}, mul=1, add=0):
+        PyoObject.__init__(self, mul, add)
+        self._unit = unit
+        self._info = unitInfo(unit)
+        self._names = [p[0] for p in self._info["params"]]
+        self._params = dict([(p[0], p[1]) for p in self._info["params"]])
+        for name, x in params.items():
+            self._checkParam(name)
+            self._params[name] = x
+        self._input = input
+        if self._info["inputs"] > 0:
+            if type(input) != ListType:
+                input = [input]
+            self._in_faders = [InputFader(wrap(input,i)) for i in range(self._info["inputs"])]
+        else:
+            self._in_faders = []
+        ninputs = len(self._in_faders)
+        args = convertArgsToLists(*(self._in_faders + [self._params[name] for name in self._names] + [mul, add]))
+        lists, lmax = args[:-1], args[-1]
+        inputs, values, mul, add = lists[:ninputs], list(lists[ninputs:-2]), lists[-2], lists[-1]
+        self._values = values
+        self._base_players = [UnitMain_base(unit, [wrap(x,i) for x in inputs], [wrap(x,i) for x in values])
+                              for i in range(lmax)]
+        nout = self._info["outputs"]
+        self._base_objs = [PackedChannel_base(self._base_players[i], j, wrap(mul,i*nout+j), wrap(add,i*nout+j))
+                           for i in range(lmax) for j in range(nout)]
+
+    def _checkParam(self, name):
+        if name not in self._names:
+            raise ValueError("unit \"%s\" has no parameter \"%s\"." % (self._info["name"], name))
+
+    def setInput(self, x, fadetime=0.05):
+        """
+        Replace the `input` attribute.
+
+        :Args:
+
+            x : PyoObject or list of PyoObjects
+                New signal of each input of the unit.
+            fadetime : float, optional
+                Crossfade time between old and new input. Default to 0.05.
+
+        """
+        self._input = x
+        if type(x) != ListType:
+            x = [x]
+        [fader.setInput(wrap(x,i), fadetime) for i, fader in enumerate(self._in_faders)]
+
+    def setParam(self, name, x):
+        """
+        Replace the value of a parameter.
+
+        :Args:
+
+            name : string
+                Name of the parameter.
+            x : float or PyoObject
+                New value of the parameter.
+
+        """
+        self._checkParam(name)
+        self._params[name] = x
+        x, lmax = convertArgsToLists(x)
+        self._values[self._names.index(name)] = x
+        [obj.setParams([wrap(v,i) for v in self._values]) for i, obj in enumerate(self._base_players)]
+
+    def getParam(self, name):
+        """
+        Returns the value of a parameter.
+
+        :Args:
+
+            name : string
+                Name of the parameter.
+
+        """
+        self._checkParam(name)
+        return self._params[name]
+
+    @property
+    def unit(self):
+        """string or capsule. Unit hosted by the object."""
+        return self._unit
+
+    @property
+    def input(self):
+        """PyoObject or list of PyoObjects. Input signals."""
+        return self._input
+    @input.setter
+    def input(self, x): self.setInput(x)
@@ -0,0 +1,62 @@
+#! /usr/bin/env python
+# encoding: utf-8
+"""
+CPU cost of the decaying tails of feedback structures, with and without the
+denormal flushing of the server.
+
+Every structure gets a short burst of noise, then `dur` seconds of silence
+are rendered with the offline server. Without flushing, the tails fall into
+the denormal range and the render slows down.
+
+usage: python denormbench.py [--double] [dur] [voices]
+
+"""
+import os, sys, time, tempfile
+
+args = [a for a in sys.argv[1:] if not a.startswith("--")]
+if "--double" in sys.argv:
+    from pyo64 import *
+    precision = "double"
+else:
+    from pyo import *
+    precision = "single"
+
+DUR = float(args[0]) if len(args) > 0 else 30.0
+VOICES = int(args[1]) if len(args) > 1 else 8
+
+def freeverb(src):
+    return Freeverb(src, size=0.9, damp=0.5, bal=1)
+
+def wgverb(src):
+    return WGVerb(src, feedback=0.9, cutoff=5000, bal=1)
+
+def waveguide(src):
+    return Waveguide(src, freq=[100 + i * 37 for i in range(VOICES)], dur=30)
+
+def biquad(src):
+    return Biquad(src, freq=1000, q=50)
+
+STRUCTURES = [("Freeverb", freeverb), ("WGVerb", wgverb), ("Waveguide", waveguide), ("Biquad", biquad)]
+OUTFILE = os.path.join(tempfile.gettempdir(), "pyo_denormbench.wav")
+
+def render(structure, flush):
+    s = Server(sr=44100, nchnls=1, buffersize=256, duplex=0, audio="offline").boot()
+    s.setFlushDenormals(flush)
+    s.recordOptions(dur=DUR, filename=OUTFILE, fileformat=0, sampletype=3)
+    env = Linseg([(0, 1), (0.1, 1), (0.11, 0)]).play()
+    src = Noise(mul=[0.3 * env] * VOICES)
+    out = structure(src)
+    mix = Mix(out, voices=1).out()
+    start = time.time()
+    s.start()
+    elapsed = time.time() - start
+    s.shutdown()
+    return elapsed
+
+print "denormal tails benchmark, %s precision, %d voices, %.1f s" % (precision, VOICES, DUR)
+print "%-10s %12s %12s %8s" % ("structure", "flush (s)", "no flush (s)", "ratio")
+for name, structure in STRUCTURES:
+    on = render(structure, True)
+    off = render(structure, False)
+    print "%-10s %12.3f %12.3f %8.1f" % (name, on, off, off / on)
+os.remove(OUTFILE)
@@ -0,0 +1,222 @@
+#! /usr/bin/env python
+# encoding: utf-8
+"""
+Throughput of every object type and of a few representative graphs,
+rendered with the offline server.
+
+Each case is rendered for `dur` seconds at every buffer size and channel
+count. Objects taking an input process `nchnls` streams of white noise, one
+per output channel. The render time of an empty server with the same
+settings is subtracted to give the cost of the case in nanoseconds per
+sample frame, `x realtime` is computed from the whole render time.
+
+Results are printed as a table, or as one json object per line with
+--json. A previous json output given with --compare=FILE turns the run
+into a regression check: the cases slower by more than --tolerance (a
+ratio, 0.15 by default) are listed and the exit status is 1.
+
+usage: python enginebench.py [--double] [--json] [--compare=FILE]
+                             [--tolerance=X] [--only=NAME,...] [dur]
+
+"""
+import os, sys, time, tempfile, inspect, json
+
+args = [a for a in sys.argv[1:] if not a.startswith("--")]
+options = dict([(a[2:].split("=") + [""])[:2] for a in sys.argv[1:] if a.startswith("--")])
+if "double" in options:
+    from pyo64 import *
+    import pyo64 as pyomodule
+    precision = "double"
+else:
+    from pyo import *
+    import pyo as pyomodule
+    precision = "single"
+
+DUR = float(args[0]) if len(args) > 0 else 5.0
+SR = 44100
+BUFFERSIZES = [64, 256, 1024]
+CHANNELS = [1, 2, 8]
+OUTFILE = os.path.join(tempfile.gettempdir(), "pyo_enginebench.wav")
+SOUND = os.path.join(SNDS_PATH, "transparent.aif")
+
+# Need devices, the network, a user callable or a file to write.
+EXCLUDED = ["Input", "Midictl", "CtlScan", "CtlScan2", "Notein", "MidiAdsr", "MidiDelAdsr", "Bendin",
+            "Touchin", "Programin", "OscReceive", "OscSend", "OscDataSend", "OscDataReceive",
+            "OscListReceive", "Print", "Record", "Clean_objects", "Scope", "Spectrum", "Pattern",
+            "Score", "CallAfter", "TrigFunc", "ControlRec", "ControlRead", "NoteinRec", "NoteinRead",
+            "Dummy", "InputFader", "VarPort", "BusIn"]
+
+# Values given to the required arguments of the constructors, by name.
+def fixtures(nchnls):
+    noise = Noise(mul=[0.3] * nchnls)
+    table = HarmTable([1, 0.5, 0.33, 0.25])
+    matrix = NewMatrix(256, 256)
+    matrix.genSineTerrain()
+    return {"input": lambda: noise,
+            "input2": lambda: Noise(mul=[0.3] * nchnls),
+            "sidechain": lambda: Noise(mul=0.3),
+            "comparator": lambda: Sig(0.5),
+            "table": lambda: table,
+            "env": lambda: HannTable(),
+            "matrix": lambda: matrix,
+            "sources": lambda: [matrix, matrix],
+            "x": lambda: Sine(0.1, mul=0.5, add=0.5),
+            "y": lambda: Sine(0.13, mul=0.5, add=0.5),
+            "index": lambda: Phasor(100),
+            "pitch": lambda: Sig(1),
+            "pos": lambda: Sig(0.5),
+            "dur": lambda: Sig(0.1),
+            "path": lambda: SOUND,
+            "list": lambda: [0.1, 0.2, 0.3],
+            "choice": lambda: [0.1, 0.2, 0.3],
+            "choices": lambda: [[0.1, 0.2, 0.3]],
+            "values": lambda: [0.1, 0.2, 0.3],
+            "seq": lambda: [1, 2, 1],
+            "inputs": lambda: [Noise(mul=0.3), Noise(mul=0.3)],
+            "voices": lambda: 2,
+            "chnls": lambda: nchnls,
+            "impulse": lambda: table,
+            "buffer": lambda: table}
+
+def build(name, fix):
+    cls = getattr(pyomodule, name)
+    spec = inspect.getargspec(cls.__init__)
+    required = spec.args[1:len(spec.args) - len(spec.defaults or ())]
+    kwargs = {}
+    for arg in required:
+        if arg not in fix:
+            raise ValueError("no value for argument '%s'" % arg)
+        kwargs[arg] = fix[arg]()
+    # Spectral objects process the analysis of the noise.
+    if "input" in kwargs and name.startswith("PV") and name != "PVAnal":
+        kwargs["input"] = PVAnal(kwargs["input"])
+        if "input2" in kwargs:
+            kwargs["input2"] = PVAnal(kwargs["input2"])
+    obj = cls(**kwargs)
+    if isinstance(obj, PyoPVObject):
+        obj = PVSynth(obj)
+    return obj
+
+def objectCase(name):
+    def case(nchnls):
+        obj = build(name, fixtures(nchnls))
+        if isinstance(obj, PyoObject):
+            obj.out()
+        return obj
+    return case
+
+def sines(nchnls):
+    return Sine(freq=[100 + i * 7 for i in range(64)], mul=0.01).mix(nchnls).out()
+
+def freeverb(nchnls):
+    src = Noise(mul=[0.3] * nchnls)
+    return Freeverb(ButLP(Delay(src, delay=0.1, feedback=0.5), 4000), size=0.8, bal=0.5).out()
+
+def pvchain(nchnls):
+    return PVSynth(PVAnal(Noise(mul=[0.3] * nchnls), size=1024, overlaps=4)).out()
+
+def granulator(nchnls):
+    snd = SndTable(SOUND)
+    env = HannTable()
+    return Granulator(snd, env, pitch=[1] * nchnls, pos=Phasor(0.1, mul=snd.getSize()),
+                      dur=0.1, grains=256, mul=0.05).out()
+
+GRAPHS = [("graph:64 Sine", sines), ("graph:Freeverb chain", freeverb),
+          ("graph:PVAnal->PVSynth", pvchain), ("graph:Granulator 256", granulator)]
+
+def objectNames():
+    names = []
+    tree = OBJECTS_TREE["PyoObjectBase"]
+    for category in sorted(tree["PyoObject"].keys()):
+        names.extend(tree["PyoObject"][category])
+    names.extend(tree["PyoPVObject"])
+    return [name for name in names if name not in EXCLUDED and hasattr(pyomodule, name)]
+
+def render(case, buffersize, nchnls):
+    s = Server(sr=SR, nchnls=nchnls, buffersize=buffersize, duplex=0, audio="offline").boot()
+    s.setVerbosity(1)
+    s.recordOptions(dur=DUR, filename=OUTFILE, fileformat=0, sampletype=3)
+    try:
+        objs = case(nchnls) if case != None else None
+        start = time.time()
+        s.start()
+        elapsed = time.time() - start
+    finally:
+        s.shutdown()
+    return elapsed
+
+def measure(name, case, baselines):
+    results = []
+    for buffersize in BUFFERSIZES:
+        for nchnls in CHANNELS:
+            result = {"name": name, "precision": precision, "buffersize": buffersize, "nchnls": nchnls, "dur": DUR}
+            try:
+                elapsed = render(case, buffersize, nchnls)
+            except Exception, e:
+                result["skipped"] = str(e)
+                return [result]
+            net = max(elapsed - baselines[(buffersize, nchnls)], 0.0)
+            result["seconds"] = elapsed
+            result["ns_per_sample"] = net * 1e9 / (DUR * SR)
+            result["x_realtime"] = DUR / elapsed
+            results.append(result)
+    return results
+
+def report(result):
+    if "json" in options:
+        print json.dumps(result, sort_keys=True)
+    elif "skipped" in result:
+        print "%-24s skipped: %s" % (result["name"], result["skipped"])
+    else:
+        print "%-24s %6d %6d %10.3f %12.1f %10.1f" % (result["name"], result["buffersize"], result["nchnls"],
+                                                  result["seconds"], result["ns_per_sample"], result["x_realtime"])
+
+def key(result):
+    return (result["name"], result["precision"], result["buffersize"], result["nchnls"])
+
+def compare(results, path, tolerance):
+    previous = {}
+    for line in open(path):
+        if line.strip():
+            result = json.loads(line)
+            if "ns_per_sample" in result:
+                previous[key(result)] = result
+    slower = []
+    for result in results:
+        old = previous.get(key(result))
+        if old == None or "ns_per_sample" not in result or old["ns_per_sample"] <= 0:
+            continue
+        ratio = result["ns_per_sample"] / old["ns_per_sample"]
+        if ratio > 1.0 + tolerance:
+            slower.append((result, old, ratio))
+    for result, old, ratio in slower:
+        print >> sys.stderr, "slower: %s (buffersize %d, nchnls %d) %.1f -> %.1f ns/sample (x%.2f)" % \
+            (result["name"], result["buffersize"], result["nchnls"], old["ns_per_sample"], result["ns_per_sample"], ratio)
+    return len(slower)
+
+cases = [(name, objectCase(name)) for name in objectNames()] + GRAPHS
+if options.get("only"):
+    only = options["only"].split(",")
+    cases = [(name, case) for name, case in cases if name in only or name.split(":")[-1] in only]
+
+baselines = {}
+for buffersize in BUFFERSIZES:
+    for nchnls in CHANNELS:
+        baselines[(buffersize, nchnls)] = render(None, buffersize, nchnls)
+
+if "json" not in options:
+    print "engine benchmark, %s precision, %.1f s per render" % (precision, DUR)
+    print "%-24s %6s %6s %10s %12s %10s" % ("case", "buffer", "chnls", "seconds", "ns/sample", "x realtime")
+results = []
+for name, case in cases:
+    for result in measure(name, case, baselines):
+        report(result)
+        results.append(result)
+        sys.stdout.flush()
+if os.path.exists(OUTFILE):
+    os.remove(OUTFILE)
+
+if options.get("compare"):
+    tolerance = float(options.get("tolerance") or 0.15)
+    if compare(results, options["compare"], tolerance) > 0:
+        sys.exit(1)
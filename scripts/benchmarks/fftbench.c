@@ -0,0 +1,199 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+/* Micro-benchmark of the real fft routines of src/engine/fft.c.
+ *
+ * Built by run_benchmarks.sh, once in single and once in double precision.
+ * For every size, prints the time per transform, how many times faster than
+ * realtime a stream of transforms of `size` new samples runs (at 44100 Hz)
+ * and, on linux when the kernel allows it, the cache misses per transform.
+ */
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "pyomodule.h"
+#include "fft.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+#define BENCH_SR 44100.0
+#define BENCH_MIN_TIME 0.2
+
+typedef void (*split_func)(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle);
+typedef void (*packed_func)(MYFLT *data, MYFLT *outdata, int size, MYFLT *twiddle);
+
+static int perf_fd = -1;
+
+static void
+perf_open(void) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    perf_fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+static void
+perf_start(void) {
+#ifdef __linux__
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(perf_fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+static long long
+perf_stop(void) {
+    long long count = -1;
+#ifdef __linux__
+    if (perf_fd >= 0) {
+        ioctl(perf_fd, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(perf_fd, &count, sizeof(count)) != sizeof(count))
+            count = -1;
+    }
+#endif
+    return count;
+}
+
+static double
+now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/* The transforms work in place: every run starts from a fresh copy of the
+ * input, whose cost is measured alone and subtracted. */
+static void
+report(const char *name, int size, double elapsed, double copy, long iters, long long misses) {
+    double ns = (elapsed - copy) / iters * 1e9;
+    double xrt = (size / BENCH_SR) / (ns * 1e-9);
+    if (misses >= 0)
+        printf("%-16s %6d %12.1f %10.0f %10.2f\n", name, size, ns, xrt, (double)misses / iters);
+    else
+        printf("%-16s %6d %12.1f %10.0f %10s\n", name, size, ns, xrt, "n/a");
+}
+
+static double
+time_copy(MYFLT *dst, MYFLT *src, int size, long iters) {
+    long i;
+    double start = now();
+    for (i=0; i<iters; i++) {
+        memcpy(dst, src, size * sizeof(MYFLT));
+        __asm__ __volatile__("" : : "r"(dst) : "memory");
+    }
+    return now() - start;
+}
+
+static void
+bench_split(const char *name, split_func func, int size, MYFLT *src, MYFLT *data, MYFLT *out) {
+    long i, iters = 1;
+    double elapsed;
+    long long misses;
+    MYFLT **twiddle = fft_acquire_split_twiddle(size);
+
+    for (;;) {
+        perf_start();
+        elapsed = now();
+        for (i=0; i<iters; i++) {
+            memcpy(data, src, size * sizeof(MYFLT));
+            (*func)(data, out, size, twiddle);
+        }
+        elapsed = now() - elapsed;
+        misses = perf_stop();
+        if (elapsed >= BENCH_MIN_TIME)
+            break;
+        iters *= 2;
+    }
+    report(name, size, elapsed, time_copy(data, src, size, iters), iters, misses);
+    fft_release_table(twiddle);
+}
+
+static void
+bench_packed(const char *name, packed_func func, int size, MYFLT *src, MYFLT *data, MYFLT *out) {
+    long i, iters = 1;
+    double elapsed;
+    long long misses;
+    MYFLT *twiddle = fft_acquire_radix2_twiddle(size);
+
+    for (;;) {
+        perf_start();
+        elapsed = now();
+        for (i=0; i<iters; i++) {
+            memcpy(data, src, size * sizeof(MYFLT));
+            (*func)(data, out, size, twiddle);
+        }
+        elapsed = now() - elapsed;
+        misses = perf_stop();
+        if (elapsed >= BENCH_MIN_TIME)
+            break;
+        iters *= 2;
+    }
+    report(name, size, elapsed, time_copy(data, src, size, iters), iters, misses);
+    fft_release_table(twiddle);
+}
+
+int
+main(int argc, char **argv) {
+    int i, size, minsize = 64, maxsize = 65536;
+    MYFLT *src, *data, *out;
+
+    if (argc > 1)
+        minsize = atoi(argv[1]);
+    if (argc > 2)
+        maxsize = atoi(argv[2]);
+
+    src = (MYFLT *)malloc(maxsize * sizeof(MYFLT));
+    data = (MYFLT *)malloc(maxsize * sizeof(MYFLT));
+    out = (MYFLT *)malloc(maxsize * sizeof(MYFLT));
+    srand(1);
+    for (i=0; i<maxsize; i++)
+        src[i] = (MYFLT)(rand() / (double)RAND_MAX * 2.0 - 1.0);
+
+    perf_open();
+    printf("fft benchmark, %s precision\n", sizeof(MYFLT) == sizeof(double) ? "double" : "single");
+    printf("%-16s %6s %12s %10s %10s\n", "transform", "size", "ns/fft", "x realtime", "misses/fft");
+    for (size=minsize; size<=maxsize; size*=2) {
+        bench_split("realfft_split", realfft_split, size, src, data, out);
+        bench_split("irealfft_split", irealfft_split, size, src, data, out);
+        bench_packed("realfft_packed", realfft_packed, size, src, data, out);
+        bench_packed("irealfft_packed", irealfft_packed, size, src, data, out);
+    }
+
+    free(src);
+    free(data);
+    free(out);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#! /usr/bin/env python
+# encoding: utf-8
+"""
+End-to-end benchmark of the spectral chains, rendered with the offline server.
+
+Every chain processes `voices` streams of white noise for `dur` seconds and
+the render time gives how many times faster than realtime it runs.
+
+usage: python pvbench.py [--double] [dur] [voices]
+
+"""
+import os, sys, time, tempfile
+
+args = [a for a in sys.argv[1:] if not a.startswith("--")]
+if "--double" in sys.argv:
+    from pyo64 import *
+    precision = "double"
+else:
+    from pyo import *
+    precision = "single"
+
+DUR = float(args[0]) if len(args) > 0 else 10.0
+VOICES = int(args[1]) if len(args) > 1 else 4
+
+def pvchain(src, size):
+    return PVSynth(PVAnal(src, size=size, overlaps=4))
+
+def fftchain(src, size):
+    fin = FFT(src, size=size, overlaps=4)
+    return IFFT(fin["real"], fin["imag"], size=size, overlaps=4)
+
+CHAINS = [("PVAnal->PVSynth", pvchain), ("FFT->IFFT", fftchain)]
+SIZES = [256, 1024, 4096]
+OUTFILE = os.path.join(tempfile.gettempdir(), "pyo_pvbench.wav")
+
+def render(chain, size):
+    s = Server(sr=44100, nchnls=1, buffersize=256, duplex=0, audio="offline").boot()
+    s.recordOptions(dur=DUR, filename=OUTFILE, fileformat=0, sampletype=3)
+    src = Noise(mul=[0.1] * VOICES)
+    out = chain(src, size)
+    mix = Mix(out, voices=1).out()
+    start = time.time()
+    s.start()
+    elapsed = time.time() - start
+    s.shutdown()
+    return elapsed
+
+print "spectral chains benchmark, %s precision, %d voices, %.1f s" % (precision, VOICES, DUR)
+print "%-16s %6s %10s %10s" % ("chain", "size", "seconds", "x realtime")
+for name, chain in CHAINS:
+    for size in SIZES:
+        elapsed = render(chain, size)
+        print "%-16s %6d %10.3f %10.1f" % (name, size, elapsed, DUR / elapsed)
+os.remove(OUTFILE)
@@ -0,0 +1,44 @@
+#! /bin/sh
+
+# Builds and runs the fft micro-benchmark in single and double precision,
+# then renders the spectral chains and the engine benchmark with the
+# installed pyo and pyo64.
+#
+# usage: sh scripts/benchmarks/run_benchmarks.sh [minsize maxsize]
+#
+# Cache misses are counted with the perf events of the linux kernel, they
+# are reported as n/a when unavailable (see /proc/sys/kernel/perf_event_paranoid).
+
+cd "$(dirname "$0")/../.."
+
+PYTHON=${PYTHON:-python}
+CC=${CC:-gcc}
+PYINC=$($PYTHON -c "from distutils import sysconfig; print(sysconfig.get_python_inc())")
+BUILD=${TMPDIR:-/tmp}/pyo_benchmarks
+SRCS="scripts/benchmarks/fftbench.c src/engine/fft.c src/engine/fftcache.c src/engine/wind.c"
+
+mkdir -p $BUILD
+$CC -O3 -std=gnu99 -Iinclude -I$PYINC $SRCS -lm -lpthread -o $BUILD/fftbench || exit 1
+$CC -O3 -std=gnu99 -DUSE_DOUBLE -Iinclude -I$PYINC $SRCS -lm -lpthread -o $BUILD/fftbench64 || exit 1
+
+echo
+$BUILD/fftbench "$@"
+echo
+$BUILD/fftbench64 "$@"
+
+if command -v perf > /dev/null 2>&1; then
+    PERF="perf stat -e cache-misses,instructions"
+fi
+
+echo
+$PERF $PYTHON scripts/benchmarks/pvbench.py
+echo
+$PERF $PYTHON scripts/benchmarks/pvbench.py --double
+echo
+$PYTHON scripts/benchmarks/denormbench.py
+echo
+$PYTHON scripts/benchmarks/denormbench.py --double
+echo
+$PYTHON scripts/benchmarks/enginebench.py
+echo
+$PYTHON scripts/benchmarks/enginebench.py --double
@@ -67,7 +67,7 @@ if sys.platform == "darwin":
 
 path = 'src/engine/'
 files = ['pyomodule.c', 'servermodule.c', 'pvstreammodule.c', 'streammodule.c', 'dummymodule.c', 
-        'mixmodule.c', 'inputfadermodule.c', 'interpolation.c', 'fft.c', "wind.c"]
+        'mixmodule.c', 'inputfadermodule.c', 'interpolation.c', 'fft.c', "wind.c", "streamgraph.c", "dspthread.c", "paramqueue.c", "muladd.c", "partconv.c", "fftcache.c", "oscarray.c", "capturering.c", "pvfile.c", "sndmap.c", "diskstream.c", "diskwriter.c", "samplecache.c", "resampler.c", "sinekernel.c", "packed.c", "wglines.c", "powkernel.c", "voicepool.c", "timerwheel.c", "pyorand.c", "midiring.c", "oscqueue.c", "oscsender.c", "shmaudio.c", "callbackstats.c", "streamlist.c", "oversampler.c", "eventfile.c"]
 source_files = [path + f for f in files]
 
 path = 'src/objects/'
@@ -79,7 +79,7 @@ files = ['granulatormodule.c', 'tablemodule.c', 'wgverbmodule.c', 'freeverbmodul
         'metromodule.c', 'trigmodule.c', 'patternmodule.c', 'bandsplitmodule.c', 'hilbertmodule.c', 'panmodule.c',
         'selectmodule.c', 'compressmodule.c', 'utilsmodule.c',
         'convolvemodule.c', 'arithmeticmodule.c', 'sigmodule.c',
-        'matrixprocessmodule.c', 'harmonizermodule.c', 'chorusmodule.c']
+        'matrixprocessmodule.c', 'harmonizermodule.c', 'chorusmodule.c', 'packedmodule.c', 'unitmodule.c']
 
 if compile_externals:
     source_files = source_files + ["externals/externalmodule.c"] + [path + f for f in files]
@@ -101,6 +101,8 @@ else:
         include_dirs.append('/opt/local/include')
     library_dirs = []
     libraries = ['portaudio', 'portmidi', 'sndfile', 'lo']
+    if sys.platform.startswith("linux"):
+        libraries.append('rt')
     if build_osx_with_jack_support:
         libraries.append('jack')
 
@@ -0,0 +1,236 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include "streammodule.h"
+#include "callbackstats.h"
+
+CallbackStats *
+CallbackStats_new(void)
+{
+    CallbackStats *self = (CallbackStats *)calloc(1, sizeof(CallbackStats));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    return self;
+}
+
+void
+CallbackStats_free(CallbackStats *self)
+{
+    if (self == NULL)
+        return;
+    CallbackStats_stopLog(self);
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+    free(self);
+}
+
+void
+CallbackStats_setDeadline(CallbackStats *self, int bufsize, double sr)
+{
+    self->counters.deadline = sr > 0 ? bufsize / sr * 1e9 : 0.0;
+}
+
+unsigned long long
+CallbackStats_begin(CallbackStats *self)
+{
+    return Stream_clock();
+}
+
+static void
+CallbackStats_push(CallbackStats *self, CallbackEvent *ev)
+{
+    if (self->written - self->read >= CBSTATS_EVENTS) {
+        self->dropped++;
+        return;
+    }
+    self->events[self->written % CBSTATS_EVENTS] = *ev;
+    /* The event must be visible before the new count. */
+    __sync_synchronize();
+    self->written++;
+}
+
+void
+CallbackStats_end(CallbackStats *self, unsigned long long start, int flags, double time)
+{
+    int i, bin;
+    double deadline;
+    unsigned long signaled = self->signaled;
+    CallbackCounters *c = &self->counters;
+    CallbackEvent ev;
+
+    ev.elapsed = Stream_clock() - start;
+    ev.time = time;
+    if (signaled != self->reported)
+        flags |= CBSTATS_XRUN;
+    if (c->deadline > 0 && ev.elapsed > c->deadline)
+        flags |= CBSTATS_LATE;
+    ev.flags = flags;
+
+    self->seq++;
+    __sync_synchronize();
+    if (self->reset) {
+        deadline = c->deadline;
+        memset(c, 0, sizeof(CallbackCounters));
+        c->deadline = deadline;
+        self->reset = 0;
+    }
+    c->count++;
+    c->total += ev.elapsed;
+    if (ev.elapsed > c->max)
+        c->max = ev.elapsed;
+    bin = c->deadline > 0 ? (int)(ev.elapsed * (100.0 / CBSTATS_BIN_WIDTH) / c->deadline) : 0;
+    c->bins[bin < CBSTATS_BINS ? bin : CBSTATS_BINS - 1]++;
+    if (flags & CBSTATS_LATE)
+        c->late++;
+    if (flags & CBSTATS_UNDERFLOW)
+        c->underflows++;
+    if (flags & CBSTATS_OVERFLOW)
+        c->overflows++;
+    c->xruns += signaled - self->reported;
+    self->reported = signaled;
+    if (ev.elapsed > c->worst[CBSTATS_WORST-1].elapsed) {
+        for (i=CBSTATS_WORST-1; i>0 && ev.elapsed > c->worst[i-1].elapsed; i--)
+            c->worst[i] = c->worst[i-1];
+        c->worst[i] = ev;
+    }
+    __sync_synchronize();
+    self->seq++;
+
+    if (flags != 0 && self->logging)
+        CallbackStats_push(self, &ev);
+}
+
+void
+CallbackStats_xrun(CallbackStats *self)
+{
+    __sync_fetch_and_add(&self->signaled, 1);
+}
+
+void
+CallbackStats_read(CallbackStats *self, CallbackCounters *out)
+{
+    unsigned int seq;
+
+    do {
+        while ((seq = self->seq) & 1);
+        __sync_synchronize();
+        memcpy(out, &self->counters, sizeof(CallbackCounters));
+        __sync_synchronize();
+    } while (seq != self->seq);
+}
+
+void
+CallbackStats_reset(CallbackStats *self)
+{
+    self->reset = 1;
+}
+
+static void
+CallbackStats_drain(CallbackStats *self)
+{
+    CallbackEvent *ev;
+    double deadline = self->counters.deadline;
+
+    while (self->read != self->written) {
+        __sync_synchronize();
+        ev = &self->events[self->read % CBSTATS_EVENTS];
+        fprintf(self->log, "%.6f %.3f ms %.0f%%%s%s%s%s\n", ev->time, ev->elapsed * 1e-6,
+                deadline > 0 ? ev->elapsed * 100.0 / deadline : 0.0,
+                ev->flags & CBSTATS_LATE ? " late" : "",
+                ev->flags & CBSTATS_UNDERFLOW ? " underflow" : "",
+                ev->flags & CBSTATS_OVERFLOW ? " overflow" : "",
+                ev->flags & CBSTATS_XRUN ? " xrun" : "");
+        /* The slot is read before it is given back. */
+        __sync_synchronize();
+        self->read++;
+    }
+    fflush(self->log);
+}
+
+static void *
+CallbackStats_run(void *arg)
+{
+    CallbackStats *self = (CallbackStats *)arg;
+    struct timeval now;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&self->mutex);
+    while (self->logging) {
+        gettimeofday(&now, NULL);
+        timeout.tv_sec = now.tv_sec;
+        timeout.tv_nsec = now.tv_usec * 1000 + 100000000;
+        if (timeout.tv_nsec >= 1000000000) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&self->cond, &self->mutex, &timeout);
+        pthread_mutex_unlock(&self->mutex);
+        CallbackStats_drain(self);
+        pthread_mutex_lock(&self->mutex);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+int
+CallbackStats_startLog(CallbackStats *self, const char *path)
+{
+    CallbackStats_stopLog(self);
+    self->log = path != NULL ? fopen(path, "a") : stderr;
+    if (self->log == NULL)
+        return -1;
+    /* Events pushed before the previous log stopped are dropped. */
+    self->read = self->written;
+    self->dropped = 0;
+    self->logging = 1;
+    if (pthread_create(&self->thread, NULL, CallbackStats_run, self) != 0) {
+        self->logging = 0;
+        if (self->log != stderr)
+            fclose(self->log);
+        self->log = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+void
+CallbackStats_stopLog(CallbackStats *self)
+{
+    if (self->log == NULL)
+        return;
+    pthread_mutex_lock(&self->mutex);
+    self->logging = 0;
+    pthread_cond_signal(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+    pthread_join(self->thread, NULL);
+    /* The audio thread may have pushed after the last pass. */
+    CallbackStats_drain(self);
+    if (self->dropped > 0)
+        fprintf(self->log, "%lu events not logged\n", self->dropped);
+    if (self->log != stderr)
+        fclose(self->log);
+    else
+        fflush(self->log);
+    self->log = NULL;
+}
@@ -0,0 +1,101 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include "capturering.h"
+
+CaptureRing *
+CaptureRing_new(int length, int blocksize)
+{
+    CaptureRing *self = (CaptureRing *)calloc(1, sizeof(CaptureRing));
+
+    if (length < 1)
+        length = 1;
+    /* Leaves room for the writer to go on while a snapshot is copied. */
+    self->size = 1;
+    while (self->size < (length + blocksize) * 2)
+        self->size <<= 1;
+    self->length = length;
+    self->written = 0;
+    self->data = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    return self;
+}
+
+void
+CaptureRing_free(CaptureRing *self)
+{
+    if (self == NULL)
+        return;
+    free(self->data);
+    free(self);
+}
+
+void
+CaptureRing_write(CaptureRing *self, MYFLT *in, int num)
+{
+    int pos, first;
+
+    if (num > self->size)
+        num = self->size;
+    pos = (int)(self->written & (self->size - 1));
+    first = self->size - pos;
+    if (first >= num)
+        memcpy(self->data + pos, in, num * sizeof(MYFLT));
+    else {
+        memcpy(self->data + pos, in, first * sizeof(MYFLT));
+        memcpy(self->data, in + first, (num - first) * sizeof(MYFLT));
+    }
+    __sync_synchronize();
+    self->written += num;
+}
+
+unsigned long
+CaptureRing_read(CaptureRing *self, MYFLT *out, int num)
+{
+    int i, tries, pos, first, missing;
+    unsigned long end, after;
+
+    if (num > self->length)
+        num = self->length;
+
+    for (tries=0; tries<8; tries++) {
+        end = self->written;
+        __sync_synchronize();
+        missing = end < (unsigned long)num ? num - (int)end : 0;
+        for (i=0; i<missing; i++)
+            out[i] = 0.0;
+        pos = (int)((end - (num - missing)) & (self->size - 1));
+        first = self->size - pos;
+        if (first >= (num - missing))
+            memcpy(out + missing, self->data + pos, (num - missing) * sizeof(MYFLT));
+        else {
+            memcpy(out + missing, self->data + pos, first * sizeof(MYFLT));
+            memcpy(out + missing + first, self->data, (num - missing - first) * sizeof(MYFLT));
+        }
+        __sync_synchronize();
+        after = self->written;
+        /* The oldest sample copied is still in the ring. */
+        if ((after - end) <= (unsigned long)(self->size - num))
+            break;
+    }
+    return end;
+}
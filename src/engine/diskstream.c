@@ -0,0 +1,299 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "diskstream.h"
+
+struct DiskStream {
+    SNDFILE *sf;        /* player's handle, audio thread only */
+    SNDFILE *iosf;      /* I/O thread only, NULL if it couldn't be opened */
+    int chnls;
+    long size;
+    MYFLT *blocks;      /* DISKSTREAM_SLOTS blocks of interleaved frames */
+    volatile long tags[DISKSTREAM_SLOTS]; /* block held by each slot, -1 if none */
+    volatile long hint[4]; /* pos, dir, end, next */
+    volatile unsigned long hintcount;
+    unsigned long donecount;
+    long lastblock;
+    DiskStream *next;
+};
+
+static pthread_mutex_t diskstream_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t diskstream_cond = PTHREAD_COND_INITIALIZER;
+static DiskStream *diskstream_list = NULL;
+static int diskstream_running = 0;
+static pthread_t diskstream_thread;
+
+static void
+DiskStream_loadBlock(DiskStream *self, int slot, long block)
+{
+    long num, items = DISKSTREAM_BLOCK * self->chnls;
+    MYFLT *data = self->blocks + slot * items;
+
+    self->tags[slot] = -1;
+    __sync_synchronize();
+    sf_seek(self->iosf, block * DISKSTREAM_BLOCK, SEEK_SET);
+    num = SF_READ(self->iosf, data, items);
+    if (num < 0)
+        num = 0;
+    if (num < items)
+        memset(data + num, 0, (items - num) * sizeof(MYFLT));
+    __sync_synchronize();
+    self->tags[slot] = block;
+}
+
+/* Reads the blocks on the way of the play head, nearest first. */
+static void
+DiskStream_fill(DiskStream *self)
+{
+    int n, slot, wrapped = 0;
+    int claimed[DISKSTREAM_SLOTS];
+    long pos, dir, end, next, block;
+
+    self->donecount = self->hintcount;
+    __sync_synchronize();
+    pos = self->hint[0];
+    dir = self->hint[1];
+    end = self->hint[2];
+    next = self->hint[3];
+
+    memset(claimed, 0, sizeof(claimed));
+    if (dir >= 0)
+        block = pos / DISKSTREAM_BLOCK;
+    else
+        block = (pos + 1) / DISKSTREAM_BLOCK;
+
+    for (n=0; n<DISKSTREAM_AHEAD; n++) {
+        if (dir >= 0) {
+            if (block * DISKSTREAM_BLOCK >= end || block * DISKSTREAM_BLOCK >= self->size) {
+                if (next < 0 || wrapped)
+                    break;
+                block = next / DISKSTREAM_BLOCK;
+                end = self->size;
+                wrapped = 1;
+            }
+        }
+        else {
+            if ((block + 1) * DISKSTREAM_BLOCK <= end || block < 0) {
+                if (next <= 0 || wrapped)
+                    break;
+                block = (next - 1) / DISKSTREAM_BLOCK;
+                end = 0;
+                wrapped = 1;
+            }
+        }
+        if (block < 0 || block * DISKSTREAM_BLOCK >= self->size)
+            break;
+        slot = (int)(block % DISKSTREAM_SLOTS);
+        if (!claimed[slot]) {
+            claimed[slot] = 1;
+            if (self->tags[slot] != block)
+                DiskStream_loadBlock(self, slot, block);
+        }
+        block += dir >= 0 ? 1 : -1;
+    }
+}
+
+static void *
+DiskStream_run(void *arg)
+{
+    int worked;
+    DiskStream *ds;
+    struct timeval now;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&diskstream_mutex);
+    while (diskstream_running) {
+        worked = 0;
+        for (ds=diskstream_list; ds!=NULL; ds=ds->next) {
+            if (ds->iosf != NULL && ds->hintcount != ds->donecount) {
+                DiskStream_fill(ds);
+                worked = 1;
+            }
+        }
+        if (!worked) {
+            /* A wake-up missed by the audio thread costs at most the timeout. */
+            gettimeofday(&now, NULL);
+            timeout.tv_sec = now.tv_sec;
+            timeout.tv_nsec = now.tv_usec * 1000 + 10000000;
+            if (timeout.tv_nsec >= 1000000000) {
+                timeout.tv_sec++;
+                timeout.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&diskstream_cond, &diskstream_mutex, &timeout);
+        }
+    }
+    pthread_mutex_unlock(&diskstream_mutex);
+    return NULL;
+}
+
+DiskStream *
+DiskStream_new(const char *path, SNDFILE *sf, SF_INFO *info)
+{
+    int i;
+    SF_INFO ioinfo;
+    DiskStream *self;
+
+    if (sf == NULL || info->channels < 1)
+        return NULL;
+
+    self = (DiskStream *)calloc(1, sizeof(DiskStream));
+    self->sf = sf;
+    self->chnls = info->channels;
+    self->size = (long)info->frames;
+    self->lastblock = -1;
+    self->blocks = (MYFLT *)malloc(DISKSTREAM_SLOTS * DISKSTREAM_BLOCK * self->chnls * sizeof(MYFLT));
+    for (i=0; i<DISKSTREAM_SLOTS; i++)
+        self->tags[i] = -1;
+
+    ioinfo.format = 0;
+    self->iosf = sf_open(path, SFM_READ, &ioinfo);
+    if (self->iosf != NULL && (ioinfo.channels != info->channels || ioinfo.frames != info->frames)) {
+        sf_close(self->iosf);
+        self->iosf = NULL;
+    }
+
+    pthread_mutex_lock(&diskstream_mutex);
+    self->next = diskstream_list;
+    diskstream_list = self;
+    if (!diskstream_running) {
+        diskstream_running = 1;
+        if (pthread_create(&diskstream_thread, NULL, DiskStream_run, NULL) != 0) {
+            printf("DiskStream warning : can't start the I/O thread, sounds are read by the audio thread.\n");
+            diskstream_running = 0;
+        }
+    }
+    pthread_mutex_unlock(&diskstream_mutex);
+
+    return self;
+}
+
+void
+DiskStream_free(DiskStream *self)
+{
+    int stop = 0;
+    DiskStream **ds;
+
+    if (self == NULL)
+        return;
+
+    pthread_mutex_lock(&diskstream_mutex);
+    for (ds=&diskstream_list; *ds!=NULL; ds=&(*ds)->next) {
+        if (*ds == self) {
+            *ds = self->next;
+            break;
+        }
+    }
+    if (diskstream_list == NULL && diskstream_running) {
+        diskstream_running = 0;
+        pthread_cond_signal(&diskstream_cond);
+        stop = 1;
+    }
+    pthread_mutex_unlock(&diskstream_mutex);
+    if (stop)
+        pthread_join(diskstream_thread, NULL);
+
+    if (self->iosf != NULL)
+        sf_close(self->iosf);
+    free(self->blocks);
+    free(self);
+}
+
+void
+DiskStream_read(DiskStream *self, long pos, MYFLT *buf, long items)
+{
+    int slot;
+    long frames, num, got, block, offset;
+
+    if (self == NULL) {
+        memset(buf, 0, items * sizeof(MYFLT));
+        return;
+    }
+
+    frames = items / self->chnls;
+    while (frames > 0) {
+        if (pos < 0) {
+            num = -pos < frames ? -pos : frames;
+            memset(buf, 0, num * self->chnls * sizeof(MYFLT));
+        }
+        else if (pos >= self->size) {
+            num = frames;
+            memset(buf, 0, num * self->chnls * sizeof(MYFLT));
+        }
+        else {
+            block = pos / DISKSTREAM_BLOCK;
+            offset = pos - block * DISKSTREAM_BLOCK;
+            num = DISKSTREAM_BLOCK - offset;
+            if (num > frames)
+                num = frames;
+            if (num > self->size - pos)
+                num = self->size - pos;
+            slot = (int)(block % DISKSTREAM_SLOTS);
+            got = 0;
+            if (self->tags[slot] == block) {
+                memcpy(buf, self->blocks + (slot * DISKSTREAM_BLOCK + offset) * self->chnls,
+                       num * self->chnls * sizeof(MYFLT));
+                __sync_synchronize();
+                got = self->tags[slot] == block;
+            }
+            if (!got) {
+                sf_seek(self->sf, pos, SEEK_SET);
+                got = SF_READ(self->sf, buf, num * self->chnls);
+                if (got < 0)
+                    got = 0;
+                if (got < num * self->chnls)
+                    memset(buf + got, 0, (num * self->chnls - got) * sizeof(MYFLT));
+            }
+        }
+        buf += num * self->chnls;
+        pos += num;
+        frames -= num;
+    }
+}
+
+void
+DiskStream_hint(DiskStream *self, long pos, int dir, long end, long next)
+{
+    long block;
+
+    if (self == NULL)
+        return;
+
+    /* The I/O thread only needs to know about block changes. */
+    block = pos / DISKSTREAM_BLOCK;
+    if (block == self->lastblock && dir == self->hint[1] && end == self->hint[2] && next == self->hint[3])
+        return;
+    self->lastblock = block;
+    self->hint[0] = pos;
+    self->hint[1] = dir;
+    self->hint[2] = end;
+    self->hint[3] = next;
+    __sync_synchronize();
+    self->hintcount++;
+    if (pthread_mutex_trylock(&diskstream_mutex) == 0) {
+        pthread_cond_signal(&diskstream_cond);
+        pthread_mutex_unlock(&diskstream_mutex);
+    }
+}
@@ -0,0 +1,303 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+#include "diskwriter.h"
+
+#define DISKWRITER_CHUNK 16384 /* frames written per call, so that every file gets its turn */
+#define DISKWRITER_SYNC 262144 /* frames between two syncs of a synced file */
+
+struct DiskWriter {
+    SNDFILE *sf;
+    int chnls;
+    long size;          /* frames, a power of two */
+    MYFLT *ring;
+    volatile unsigned long written; /* frames, by the audio thread */
+    volatile unsigned long flushed; /* frames, by the writer thread */
+    volatile unsigned long overflows;
+    volatile unsigned long dropped;
+    int blocking;
+    int fd;             /* -1 if not synced */
+    unsigned long synced;
+    int closing;
+    int closed;
+    DiskWriter *next;
+};
+
+static pthread_mutex_t diskwriter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t diskwriter_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t diskwriter_closed_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t diskwriter_space_cond = PTHREAD_COND_INITIALIZER;
+static DiskWriter *diskwriter_list = NULL;
+static int diskwriter_running = 0;
+static pthread_t diskwriter_thread;
+
+/* Commits the written data to the disk and drops it from the page cache,
+ * a long recording doesn't evict the sounds used by the players. */
+static void
+DiskWriter_sync(DiskWriter *self)
+{
+    sf_write_sync(self->sf);
+#if defined(POSIX_FADV_DONTNEED)
+    posix_fadvise(self->fd, 0, 0, POSIX_FADV_DONTNEED);
+#endif
+    self->synced = self->flushed;
+}
+
+/* Returns 1 if frames were written. */
+static int
+DiskWriter_flush(DiskWriter *self)
+{
+    long pos, num;
+    unsigned long written = self->written;
+
+    __sync_synchronize();
+    if (written == self->flushed)
+        return 0;
+    pos = (long)(self->flushed & (self->size - 1));
+    num = (long)(written - self->flushed);
+    if (num > self->size - pos)
+        num = self->size - pos;
+    if (num > DISKWRITER_CHUNK)
+        num = DISKWRITER_CHUNK;
+    SF_WRITE(self->sf, self->ring + pos * self->chnls, num * self->chnls);
+    __sync_synchronize();
+    self->flushed += num;
+    if (self->blocking)
+        pthread_cond_broadcast(&diskwriter_space_cond);
+    if (self->fd >= 0 && (self->flushed - self->synced) >= DISKWRITER_SYNC)
+        DiskWriter_sync(self);
+    return 1;
+}
+
+static void *
+DiskWriter_run(void *arg)
+{
+    int worked;
+    DiskWriter *dw;
+    struct timeval now;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&diskwriter_mutex);
+    while (diskwriter_running) {
+        worked = 0;
+        for (dw=diskwriter_list; dw!=NULL; dw=dw->next) {
+            if (dw->closed)
+                continue;
+            worked |= DiskWriter_flush(dw);
+            if (dw->closing && dw->flushed == dw->written) {
+                if (dw->fd >= 0)
+                    DiskWriter_sync(dw);
+                sf_close(dw->sf);
+                dw->closed = 1;
+                pthread_cond_broadcast(&diskwriter_closed_cond);
+            }
+        }
+        if (!worked) {
+            gettimeofday(&now, NULL);
+            timeout.tv_sec = now.tv_sec;
+            timeout.tv_nsec = now.tv_usec * 1000 + 20000000;
+            if (timeout.tv_nsec >= 1000000000) {
+                timeout.tv_sec++;
+                timeout.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&diskwriter_cond, &diskwriter_mutex, &timeout);
+        }
+    }
+    pthread_mutex_unlock(&diskwriter_mutex);
+    return NULL;
+}
+
+DiskWriter *
+DiskWriter_new(SNDFILE *sf, int chnls, long frames)
+{
+    DiskWriter *self;
+
+    if (sf == NULL || chnls < 1)
+        return NULL;
+
+    self = (DiskWriter *)calloc(1, sizeof(DiskWriter));
+    self->sf = sf;
+    self->chnls = chnls;
+    self->fd = -1;
+    self->size = 1;
+    while (self->size < frames)
+        self->size <<= 1;
+    self->ring = (MYFLT *)malloc(self->size * chnls * sizeof(MYFLT));
+
+    pthread_mutex_lock(&diskwriter_mutex);
+    if (!diskwriter_running) {
+        if (pthread_create(&diskwriter_thread, NULL, DiskWriter_run, NULL) != 0) {
+            pthread_mutex_unlock(&diskwriter_mutex);
+            free(self->ring);
+            free(self);
+            return NULL;
+        }
+        diskwriter_running = 1;
+    }
+    self->next = diskwriter_list;
+    diskwriter_list = self;
+    pthread_mutex_unlock(&diskwriter_mutex);
+
+    return self;
+}
+
+void
+DiskWriter_close(DiskWriter *self)
+{
+    int stop = 0;
+    DiskWriter **dw;
+
+    if (self == NULL)
+        return;
+
+    pthread_mutex_lock(&diskwriter_mutex);
+    self->closing = 1;
+    pthread_cond_signal(&diskwriter_cond);
+    while (!self->closed)
+        pthread_cond_wait(&diskwriter_closed_cond, &diskwriter_mutex);
+    for (dw=&diskwriter_list; *dw!=NULL; dw=&(*dw)->next) {
+        if (*dw == self) {
+            *dw = self->next;
+            break;
+        }
+    }
+    if (diskwriter_list == NULL) {
+        diskwriter_running = 0;
+        pthread_cond_signal(&diskwriter_cond);
+        stop = 1;
+    }
+    pthread_mutex_unlock(&diskwriter_mutex);
+    if (stop)
+        pthread_join(diskwriter_thread, NULL);
+
+    free(self->ring);
+    free(self);
+}
+
+void
+DiskWriter_setBlocking(DiskWriter *self, int blocking)
+{
+    pthread_mutex_lock(&diskwriter_mutex);
+    self->blocking = blocking;
+    pthread_mutex_unlock(&diskwriter_mutex);
+}
+
+void
+DiskWriter_setSync(DiskWriter *self, int fd)
+{
+    pthread_mutex_lock(&diskwriter_mutex);
+    self->fd = fd;
+    pthread_mutex_unlock(&diskwriter_mutex);
+}
+
+/* Room for `frames` frames, or -1 after counting the overflow. */
+static long
+DiskWriter_reserve(DiskWriter *self, long frames)
+{
+    if (self->blocking && frames <= self->size &&
+        frames > (long)(self->size - (self->written - self->flushed))) {
+        pthread_mutex_lock(&diskwriter_mutex);
+        while (frames > (long)(self->size - (self->written - self->flushed))) {
+            pthread_cond_signal(&diskwriter_cond);
+            pthread_cond_wait(&diskwriter_space_cond, &diskwriter_mutex);
+        }
+        pthread_mutex_unlock(&diskwriter_mutex);
+    }
+    if (frames > (long)(self->size - (self->written - self->flushed))) {
+        self->overflows++;
+        self->dropped += frames;
+        return -1;
+    }
+    return (long)(self->written & (self->size - 1));
+}
+
+static void
+DiskWriter_commit(DiskWriter *self, long frames)
+{
+    __sync_synchronize();
+    self->written += frames;
+    /* The writer thread wakes up by itself, only hurry it when the ring fills. */
+    if ((self->written - self->flushed) > (unsigned long)(self->size / 4) &&
+        pthread_mutex_trylock(&diskwriter_mutex) == 0) {
+        pthread_cond_signal(&diskwriter_cond);
+        pthread_mutex_unlock(&diskwriter_mutex);
+    }
+}
+
+long
+DiskWriter_write(DiskWriter *self, MYFLT *buf, long frames)
+{
+    long pos, first;
+
+    if (self == NULL)
+        return frames;
+    if ((pos = DiskWriter_reserve(self, frames)) < 0)
+        return frames;
+    first = self->size - pos;
+    if (first >= frames)
+        memcpy(self->ring + pos * self->chnls, buf, frames * self->chnls * sizeof(MYFLT));
+    else {
+        memcpy(self->ring + pos * self->chnls, buf, first * self->chnls * sizeof(MYFLT));
+        memcpy(self->ring, buf + first * self->chnls, (frames - first) * self->chnls * sizeof(MYFLT));
+    }
+    DiskWriter_commit(self, frames);
+    return 0;
+}
+
+long
+DiskWriter_writeFloat(DiskWriter *self, float *buf, long frames)
+{
+    long i, pos, items, end;
+
+    if (self == NULL)
+        return frames;
+    if ((pos = DiskWriter_reserve(self, frames)) < 0)
+        return frames;
+    items = frames * self->chnls;
+    end = self->size * self->chnls;
+    pos *= self->chnls;
+    for (i=0; i<items; i++) {
+        self->ring[pos++] = (MYFLT)buf[i];
+        if (pos == end)
+            pos = 0;
+    }
+    DiskWriter_commit(self, frames);
+    return 0;
+}
+
+unsigned long
+DiskWriter_getOverflows(DiskWriter *self)
+{
+    return self == NULL ? 0 : self->overflows;
+}
+
+unsigned long
+DiskWriter_getDropped(DiskWriter *self)
+{
+    return self == NULL ? 0 : self->dropped;
+}
@@ -0,0 +1,724 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "dspthread.h"
+
+/*****************/
+/*** DSP lock ***/
+/*****************/
+
+#define DSPLOCK_TABLE_SIZE 2048
+#define DSPLOCK_NUM_BINARY 8
+
+typedef struct {
+    PyTypeObject *type;
+    newfunc tp_new;
+    initproc tp_init;
+    destructor tp_dealloc;
+    inquiry tp_clear;
+    getattrofunc tp_getattro;
+    setattrofunc tp_setattro;
+    binaryfunc nb[DSPLOCK_NUM_BINARY];
+} DspLockedType;
+
+/* Interpreters whose servers run without the GIL. */
+#define DSPLOCK_MAX_INTERPRETERS 64
+
+struct DspLock {
+    PyInterpreterState *interp;
+    pthread_mutex_t mutex;
+};
+
+static int dsp_installed = 0;
+static DspLockedType dsp_types[DSPLOCK_TABLE_SIZE];
+/* Never removed, an interpreter created at the address of an ended one gets its lock. */
+static DspLock dsp_locks[DSPLOCK_MAX_INTERPRETERS];
+static int dsp_num_locks = 0;
+
+static CallbackQueue *callback_queues = NULL;
+static void CallbackQueue_forget(PyObject *obj);
+
+/* Lock of the current interpreter, NULL if none of its servers runs without the GIL. */
+static DspLock *
+DspLock_current(void)
+{
+    int i;
+    PyInterpreterState *interp = PyThreadState_GET()->interp;
+
+    for (i=0; i<dsp_num_locks; i++) {
+        if (dsp_locks[i].interp == interp)
+            return &dsp_locks[i];
+    }
+    return NULL;
+}
+
+DspLock *
+DspLock_get(void)
+{
+    DspLock *lock;
+    pthread_mutexattr_t attr;
+
+    lock = DspLock_current();
+    if (lock != NULL || dsp_num_locks == DSPLOCK_MAX_INTERPRETERS)
+        return lock;
+
+    lock = &dsp_locks[dsp_num_locks];
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(&lock->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    lock->interp = PyThreadState_GET()->interp;
+    dsp_num_locks++;
+    return lock;
+}
+
+void
+DspLock_enter(void)
+{
+    DspLock *lock;
+
+    if (dsp_installed == 0 || (lock = DspLock_current()) == NULL)
+        return;
+    /* Never wait for the lock with the GIL, the audio thread may need it for
+       objects that can't run without the interpreter. */
+    while (pthread_mutex_trylock(&lock->mutex) != 0) {
+        Py_BEGIN_ALLOW_THREADS
+        pthread_mutex_lock(&lock->mutex);
+        pthread_mutex_unlock(&lock->mutex);
+        Py_END_ALLOW_THREADS
+    }
+}
+
+void
+DspLock_leave(void)
+{
+    DspLock *lock;
+
+    if (dsp_installed == 0 || (lock = DspLock_current()) == NULL)
+        return;
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+void
+DspLock_lock(DspLock *lock)
+{
+    pthread_mutex_lock(&lock->mutex);
+}
+
+void
+DspLock_unlock(DspLock *lock)
+{
+    pthread_mutex_unlock(&lock->mutex);
+}
+
+/**********************/
+/*** GIL acquisition ***/
+/**********************/
+
+void
+PyoThreadState_init(PyoThreadState *self)
+{
+    PyInterpreterState *interp = PyThreadState_GET()->interp;
+    PyInterpreterState *main = PyInterpreterState_Head();
+
+    /* New interpreters are inserted at the head, the main one is the last. */
+    while (PyInterpreterState_Next(main) != NULL)
+        main = PyInterpreterState_Next(main);
+    self->interp = interp == main ? NULL : interp;
+    self->tstate = NULL;
+}
+
+void
+PyoThreadState_acquire(PyoThreadState *self)
+{
+    if (self->interp == NULL)
+        self->gstate = PyGILState_Ensure();
+    else {
+        if (self->tstate == NULL)
+            self->tstate = PyThreadState_New(self->interp);
+        PyEval_AcquireThread(self->tstate);
+    }
+}
+
+void
+PyoThreadState_release(PyoThreadState *self)
+{
+    if (self->interp == NULL)
+        PyGILState_Release(self->gstate);
+    else
+        PyEval_ReleaseThread(self->tstate);
+}
+
+void
+PyoThreadState_clear(PyoThreadState *self)
+{
+    if (self->tstate != NULL) {
+        PyThreadState_Clear(self->tstate);
+        PyThreadState_Delete(self->tstate);
+        self->tstate = NULL;
+    }
+}
+
+static DspLockedType *
+DspLock_slot(PyTypeObject *type)
+{
+    int i = (int)((((size_t)type >> 4) * 2654435761u) & (DSPLOCK_TABLE_SIZE - 1));
+    while (dsp_types[i].type != NULL && dsp_types[i].type != type)
+        i = (i + 1) & (DSPLOCK_TABLE_SIZE - 1);
+    return &dsp_types[i];
+}
+
+/* Original slots of `type`, or of its nearest wrapped base (python subclasses). */
+static DspLockedType *
+DspLock_find(PyTypeObject *type)
+{
+    DspLockedType *t;
+    while (type != NULL) {
+        t = DspLock_slot(type);
+        if (t->type == type)
+            return t;
+        type = type->tp_base;
+    }
+    return NULL;
+}
+
+static PyObject *
+DspLock_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    PyObject *obj;
+    DspLockedType *t = DspLock_find(type);
+    DspLock_enter();
+    obj = t->tp_new(type, args, kwds);
+    DspLock_leave();
+    return obj;
+}
+
+static int
+DspLock_init(PyObject *obj, PyObject *args, PyObject *kwds)
+{
+    int ret;
+    DspLockedType *t = DspLock_find(Py_TYPE(obj));
+    DspLock_enter();
+    ret = t->tp_init(obj, args, kwds);
+    DspLock_leave();
+    return ret;
+}
+
+static void
+DspLock_dealloc(PyObject *obj)
+{
+    DspLockedType *t = DspLock_find(Py_TYPE(obj));
+    DspLock_enter();
+    CallbackQueue_forget(obj);
+    t->tp_dealloc(obj);
+    DspLock_leave();
+}
+
+static int
+DspLock_clear(PyObject *obj)
+{
+    int ret;
+    DspLockedType *t = DspLock_find(Py_TYPE(obj));
+    DspLock_enter();
+    ret = t->tp_clear(obj);
+    DspLock_leave();
+    return ret;
+}
+
+static PyObject *
+DspLock_call(PyObject *method, PyObject *args, PyObject *kwds)
+{
+    PyObject *ret;
+    DspLock_enter();
+    ret = PyObject_Call(method, args, kwds);
+    DspLock_leave();
+    return ret;
+}
+
+#define DSPLOCK_MAX_EXEMPT 32
+static PyCFunction dsp_exempt[DSPLOCK_MAX_EXEMPT];
+static int dsp_num_exempt = 0;
+
+void
+DspLock_exempt(PyCFunction func)
+{
+    int i;
+    for (i=0; i<dsp_num_exempt; i++) {
+        if (dsp_exempt[i] == func)
+            return;
+    }
+    if (dsp_num_exempt < DSPLOCK_MAX_EXEMPT)
+        dsp_exempt[dsp_num_exempt++] = func;
+}
+
+static int
+DspLock_is_exempt(PyObject *method)
+{
+    int i;
+    PyCFunction func = PyCFunction_GET_FUNCTION(method);
+    for (i=0; i<dsp_num_exempt; i++) {
+        if (dsp_exempt[i] == func)
+            return 1;
+    }
+    return 0;
+}
+
+static PyMethodDef DspLock_call_def = {"locked_method", (PyCFunction)DspLock_call, METH_VARARGS | METH_KEYWORDS, NULL};
+
+/* Bound methods are returned wrapped in a function taking the lock around the call. */
+static PyObject *
+DspLock_getattro(PyObject *obj, PyObject *name)
+{
+    PyObject *ret, *method;
+    DspLockedType *t = DspLock_find(Py_TYPE(obj));
+    ret = t->tp_getattro(obj, name);
+    if (ret != NULL && PyCFunction_Check(ret) && PyCFunction_GET_SELF(ret) == obj && !DspLock_is_exempt(ret)) {
+        method = PyCFunction_New(&DspLock_call_def, ret);
+        Py_DECREF(ret);
+        return method;
+    }
+    return ret;
+}
+
+static int
+DspLock_setattro(PyObject *obj, PyObject *name, PyObject *value)
+{
+    int ret;
+    DspLockedType *t = DspLock_find(Py_TYPE(obj));
+    DspLock_enter();
+    ret = t->tp_setattro(obj, name, value);
+    DspLock_leave();
+    return ret;
+}
+
+/* Arithmetic slots receive the pyo object as left or right operand. */
+#define DSPLOCK_BINARY(name, index) \
+static PyObject * \
+DspLock_##name(PyObject *a, PyObject *b) \
+{ \
+    PyObject *ret; \
+    DspLockedType *t = DspLock_find(Py_TYPE(a)); \
+    if (t == NULL || t->nb[index] == NULL) \
+        t = DspLock_find(Py_TYPE(b)); \
+    DspLock_enter(); \
+    ret = t->nb[index](a, b); \
+    DspLock_leave(); \
+    return ret; \
+}
+
+DSPLOCK_BINARY(nb_add, 0)
+DSPLOCK_BINARY(nb_subtract, 1)
+DSPLOCK_BINARY(nb_multiply, 2)
+DSPLOCK_BINARY(nb_divide, 3)
+DSPLOCK_BINARY(nb_inplace_add, 4)
+DSPLOCK_BINARY(nb_inplace_subtract, 5)
+DSPLOCK_BINARY(nb_inplace_multiply, 6)
+DSPLOCK_BINARY(nb_inplace_divide, 7)
+
+#define DSPLOCK_WRAP(field, func) \
+    if (type->field != NULL) { \
+        t->field = type->field; \
+        type->field = func; \
+    }
+
+#define DSPLOCK_WRAP_NB(field, index) \
+    if (nb->field != NULL && nb->field != DspLock_##field) { \
+        t->nb[index] = nb->field; \
+        nb->field = DspLock_##field; \
+    }
+
+void
+DspLock_install(PyObject *module, PyTypeObject *skip)
+{
+    Py_ssize_t pos = 0;
+    PyObject *key, *value;
+    PyTypeObject *type;
+    PyNumberMethods *nb;
+    DspLockedType *t;
+
+    if (dsp_installed == 1)
+        return;
+
+    while (PyDict_Next(PyModule_GetDict(module), &pos, &key, &value)) {
+        if (!PyType_Check(value) || (PyTypeObject *)value == skip)
+            continue;
+        type = (PyTypeObject *)value;
+        t = DspLock_slot(type);
+        if (t->type == type)
+            continue;
+        t->type = type;
+        DSPLOCK_WRAP(tp_new, DspLock_new);
+        DSPLOCK_WRAP(tp_init, DspLock_init);
+        DSPLOCK_WRAP(tp_dealloc, DspLock_dealloc);
+        DSPLOCK_WRAP(tp_clear, DspLock_clear);
+        DSPLOCK_WRAP(tp_getattro, DspLock_getattro);
+        DSPLOCK_WRAP(tp_setattro, DspLock_setattro);
+        nb = type->tp_as_number;
+        if (nb != NULL) {
+            DSPLOCK_WRAP_NB(nb_add, 0);
+            DSPLOCK_WRAP_NB(nb_subtract, 1);
+            DSPLOCK_WRAP_NB(nb_multiply, 2);
+            DSPLOCK_WRAP_NB(nb_divide, 3);
+            DSPLOCK_WRAP_NB(nb_inplace_add, 4);
+            DSPLOCK_WRAP_NB(nb_inplace_subtract, 5);
+            DSPLOCK_WRAP_NB(nb_inplace_multiply, 6);
+            DSPLOCK_WRAP_NB(nb_inplace_divide, 7);
+        }
+    }
+
+    dsp_installed = 1;
+}
+
+/**********************/
+/*** Callback queue ***/
+/**********************/
+
+#define CALLBACK_BATCH_SIZE 64
+
+typedef struct {
+    PyObject *obj;
+    PyoCallbackFunc func;
+    double value;
+} PyoCallback;
+
+struct CallbackQueue {
+    PyoCallback *calls;
+    int size;
+    int head;
+    int tail;
+    int dropped;
+    int quit;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    PyoThreadState gil; /* of the interpreter which created the queue */
+    CallbackQueue *next;
+};
+
+static void *
+CallbackQueue_run(void *arg)
+{
+    int i, count, dropped;
+    PyoCallback batch[CALLBACK_BATCH_SIZE];
+    CallbackQueue *self = (CallbackQueue *)arg;
+
+    pthread_mutex_lock(&self->mutex);
+    while (1) {
+        while (self->head == self->tail && self->dropped == 0 && self->quit == 0)
+            pthread_cond_wait(&self->cond, &self->mutex);
+        if (self->quit == 1)
+            break;
+        pthread_mutex_unlock(&self->mutex);
+
+        PyoThreadState_acquire(&self->gil);
+        /* Objects are referenced while the GIL is held, they can't be destroyed
+           between here and CallbackQueue_forget. */
+        pthread_mutex_lock(&self->mutex);
+        count = 0;
+        while (self->head != self->tail && count < CALLBACK_BATCH_SIZE) {
+            batch[count] = self->calls[self->head];
+            self->head = (self->head + 1) % self->size;
+            if (batch[count].obj != NULL) {
+                Py_INCREF(batch[count].obj);
+                count++;
+            }
+        }
+        dropped = self->dropped;
+        self->dropped = 0;
+        pthread_mutex_unlock(&self->mutex);
+
+        for (i=0; i<count; i++) {
+            (*batch[i].func)(batch[i].obj, batch[i].value);
+            Py_DECREF(batch[i].obj);
+        }
+        if (dropped > 0)
+            printf("Pyo warning: %d deferred python calls dropped, the callback queue is full.\n", dropped);
+        PyoThreadState_release(&self->gil);
+
+        pthread_mutex_lock(&self->mutex);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+CallbackQueue *
+CallbackQueue_new(int size)
+{
+    CallbackQueue *self = (CallbackQueue *)calloc(1, sizeof(CallbackQueue));
+
+    self->size = size;
+    self->calls = (PyoCallback *)calloc(size, sizeof(PyoCallback));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    PyEval_InitThreads();
+    PyoThreadState_init(&self->gil);
+    pthread_create(&self->thread, NULL, CallbackQueue_run, (void *)self);
+
+    self->next = callback_queues;
+    callback_queues = self;
+
+    return self;
+}
+
+void
+CallbackQueue_free(CallbackQueue *self)
+{
+    CallbackQueue **q;
+
+    for (q=&callback_queues; *q!=NULL; q=&(*q)->next) {
+        if (*q == self) {
+            *q = self->next;
+            break;
+        }
+    }
+
+    pthread_mutex_lock(&self->mutex);
+    self->quit = 1;
+    pthread_cond_signal(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+    Py_BEGIN_ALLOW_THREADS
+    pthread_join(self->thread, NULL);
+    Py_END_ALLOW_THREADS
+    PyoThreadState_clear(&self->gil);
+
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+    free(self->calls);
+    free(self);
+}
+
+void
+CallbackQueue_post(CallbackQueue *self, PyObject *obj, PyoCallbackFunc func, double value)
+{
+    int next;
+
+    pthread_mutex_lock(&self->mutex);
+    next = (self->tail + 1) % self->size;
+    if (next == self->head)
+        self->dropped++;
+    else {
+        self->calls[self->tail].obj = obj;
+        self->calls[self->tail].func = func;
+        self->calls[self->tail].value = value;
+        self->tail = next;
+    }
+    pthread_mutex_unlock(&self->mutex);
+}
+
+void
+CallbackQueue_flush(CallbackQueue *self)
+{
+    pthread_mutex_lock(&self->mutex);
+    if (self->head != self->tail || self->dropped > 0)
+        pthread_cond_signal(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+}
+
+/* Called, with the GIL, when an object is destroyed: its pending calls are cancelled. */
+static void
+CallbackQueue_forget(PyObject *obj)
+{
+    int i;
+    CallbackQueue *q;
+
+    for (q=callback_queues; q!=NULL; q=q->next) {
+        pthread_mutex_lock(&q->mutex);
+        for (i=q->head; i!=q->tail; i=(i+1)%q->size) {
+            if (q->calls[i].obj == obj)
+                q->calls[i].obj = NULL;
+        }
+        pthread_mutex_unlock(&q->mutex);
+    }
+}
+
+/*********************/
+/*** Helper thread ***/
+/*********************/
+
+struct HelperThread {
+    PyoJobFunc func;
+    void *data;
+    int pending;
+    int quit;
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+static void *
+HelperThread_run(void *arg)
+{
+    HelperThread *self = (HelperThread *)arg;
+
+    pthread_mutex_lock(&self->mutex);
+    while (1) {
+        while (self->pending == 0 && self->quit == 0)
+            pthread_cond_wait(&self->cond, &self->mutex);
+        if (self->quit == 1)
+            break;
+        pthread_mutex_unlock(&self->mutex);
+
+        DenormalMode_set(DenormalMode_getDefault());
+        (*self->func)(self->data);
+
+        pthread_mutex_lock(&self->mutex);
+        self->pending = 0;
+        pthread_cond_broadcast(&self->cond);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+HelperThread *
+HelperThread_new(PyoJobFunc func, void *data)
+{
+    HelperThread *self = (HelperThread *)calloc(1, sizeof(HelperThread));
+
+    self->func = func;
+    self->data = data;
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    if (pthread_create(&self->thread, NULL, HelperThread_run, (void *)self) != 0) {
+        pthread_mutex_destroy(&self->mutex);
+        pthread_cond_destroy(&self->cond);
+        free(self);
+        return NULL;
+    }
+
+    return self;
+}
+
+void
+HelperThread_free(HelperThread *self)
+{
+    if (self == NULL)
+        return;
+
+    HelperThread_wait(self);
+    pthread_mutex_lock(&self->mutex);
+    self->quit = 1;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+    pthread_join(self->thread, NULL);
+
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+    free(self);
+}
+
+void
+HelperThread_post(HelperThread *self)
+{
+    pthread_mutex_lock(&self->mutex);
+    self->pending = 1;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+}
+
+void
+HelperThread_wait(HelperThread *self)
+{
+    pthread_mutex_lock(&self->mutex);
+    while (self->pending == 1)
+        pthread_cond_wait(&self->cond, &self->mutex);
+    pthread_mutex_unlock(&self->mutex);
+}
+
+/*********************/
+/*** Denormal mode ***/
+/*********************/
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#define DENORMAL_BITS 0x8040 /* FTZ and DAZ of the MXCSR register */
+
+unsigned int
+DenormalMode_set(int flush)
+{
+    unsigned int state = _mm_getcsr();
+    unsigned int mode = flush ? (state | DENORMAL_BITS) : (state & ~DENORMAL_BITS);
+
+    if (mode != state)
+        _mm_setcsr(mode);
+    return state;
+}
+
+void
+DenormalMode_restore(unsigned int state)
+{
+    if (_mm_getcsr() != state)
+        _mm_setcsr(state);
+}
+
+#elif defined(__aarch64__)
+#define DENORMAL_BITS (1 << 24) /* FZ of the FPCR register */
+
+unsigned int
+DenormalMode_set(int flush)
+{
+    unsigned long state, mode;
+
+    __asm__ __volatile__ ("mrs %0, fpcr" : "=r" (state));
+    mode = flush ? (state | DENORMAL_BITS) : (state & ~DENORMAL_BITS);
+    if (mode != state)
+        __asm__ __volatile__ ("msr fpcr, %0" : : "r" (mode));
+    return (unsigned int)state;
+}
+
+void
+DenormalMode_restore(unsigned int state)
+{
+    unsigned long mode = state;
+
+    __asm__ __volatile__ ("msr fpcr, %0" : : "r" (mode));
+}
+
+#else
+
+unsigned int
+DenormalMode_set(int flush)
+{
+    return 0;
+}
+
+void
+DenormalMode_restore(unsigned int state)
+{
+}
+
+#endif
+
+static volatile int denormal_default = 1;
+
+void
+DenormalMode_setDefault(int flush)
+{
+    denormal_default = flush;
+}
+
+int
+DenormalMode_getDefault(void)
+{
+    return denormal_default;
+}
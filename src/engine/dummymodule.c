@@ -73,14 +73,91 @@ Dummy_setProcMode(Dummy *self)
     }
 }
 
+/* Applies the mul and add of `dummy` on `data`, a buffer of the Dummy
+ * computing the chain. */
+static void
+Dummy_apply(Dummy *dummy, MYFLT *data, int size)
+{
+    MYFLT *mul = dummy->modebuffer[0] ? Stream_getData((Stream *)dummy->mul_stream) : NULL;
+    MYFLT *add = dummy->modebuffer[1] ? Stream_getData((Stream *)dummy->add_stream) : NULL;
+
+    switch (dummy->modebuffer[0] + dummy->modebuffer[1] * 10) {
+        case 0:
+            pyo_muladd_ii(data, PyFloat_AS_DOUBLE(dummy->mul), PyFloat_AS_DOUBLE(dummy->add), size);
+            break;
+        case 1:
+            pyo_muladd_ai(data, mul, PyFloat_AS_DOUBLE(dummy->add), size);
+            break;
+        case 2:
+            pyo_muladd_revai(data, mul, PyFloat_AS_DOUBLE(dummy->add), size);
+            break;
+        case 10:
+            pyo_muladd_ia(data, PyFloat_AS_DOUBLE(dummy->mul), add, size);
+            break;
+        case 11:
+            pyo_muladd_aa(data, mul, add, size);
+            break;
+        case 12:
+            pyo_muladd_revaa(data, mul, add, size);
+            break;
+        case 20:
+            pyo_muladd_ireva(data, PyFloat_AS_DOUBLE(dummy->mul), add, size);
+            break;
+        case 21:
+            pyo_muladd_areva(data, mul, add, size);
+            break;
+        case 22:
+            pyo_muladd_revareva(data, mul, add, size);
+            break;
+    }
+}
+
+/* A Dummy reading another Dummy computes the whole chain of operators in its
+ * own buffer, the intermediate Dummies are not computed by the server. Their
+ * mul and add are read at every buffer, so changing them still changes the
+ * result. The scalar ones following each other fold into a single pass. A
+ * stopped Dummy ends the chain, its buffer is read as for any other stream. */
 static void
 Dummy_compute_next_data_frame(Dummy *self)
 {
-    int i;
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = in[i];
+    int i, n = 0, constant;
+    MYFLT m, mul = 1.0, add = 0.0;
+    MYFLT *in;
+    Dummy *chain[DUMMY_MAX_FUSED];
+    Dummy *dummy = self;
+
+    while (dummy->fused && n < DUMMY_MAX_FUSED && Stream_getStreamActive(((Dummy *)dummy->input)->stream)) {
+        dummy = (Dummy *)dummy->input;
+        chain[n++] = dummy;
+    }
+
+    in = Stream_getData((Stream *)dummy->input_stream);
+    constant = Stream_isConstant(dummy->input_stream);
+    if (constant)
+        pyo_fill(self->data, in[0], self->bufsize);
+    else
+        memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+
+    for (i=n-1; i>=0; i--) {
+        dummy = chain[i];
+        if (dummy->modebuffer[0] == 0 && dummy->modebuffer[1] == 0) {
+            m = PyFloat_AS_DOUBLE(dummy->mul);
+            mul *= m;
+            add = add * m + PyFloat_AS_DOUBLE(dummy->add);
+        }
+        else {
+            if (mul != 1 || add != 0)
+                pyo_muladd_ii(self->data, mul, add, self->bufsize);
+            mul = 1.0;
+            add = 0.0;
+            Dummy_apply(dummy, self->data, self->bufsize);
+            constant = 0;
+        }
     }
+    if (mul != 1 || add != 0)
+        pyo_muladd_ii(self->data, mul, add, self->bufsize);
+
+    Stream_setConstant(self->stream, constant);
     (*self->muladd_func_ptr)(self);
 }
 
@@ -117,18 +194,35 @@ Dummy_initialize(Dummy *self)
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 
+    self->registered = 0;
+    self->fused = 0;
+    self->depth = 0;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Dummy_compute_next_data_frame);
     self->mode_func_ptr = Dummy_setProcMode;
 
-    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
-
     Stream_setStreamActive(self->stream, 1);
 
     Py_INCREF(Py_None);
     return Py_None;
 }
 
+/* A Dummy is added to the server once something reads its stream, or once
+ * it is played, so the intermediate terms of a chain are never added. Its
+ * inputs are read when it is set up, so they are added to the server before
+ * it is. Its buffer is brought up to date when it is added, the first read
+ * gets the current value. */
+static void
+Dummy_register(Dummy *self)
+{
+    if (self->registered == 0) {
+        PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+        self->registered = 1;
+        Dummy_compute_next_data_frame(self);
+    }
+}
+
 static PyObject *
 Dummy_setInput(Dummy *self, PyObject *arg)
 {
@@ -138,7 +232,17 @@ Dummy_setInput(Dummy *self, PyObject *arg)
     Py_INCREF(tmp);
     Py_XDECREF(self->input);
     self->input = tmp;
-    streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getStream", NULL);
+    if (PyObject_TypeCheck(arg, &DummyType) && ((Dummy *)arg)->depth < DUMMY_MAX_FUSED) {
+        /* Computed in the chain, without adding the input to the server. */
+        self->fused = 1;
+        self->depth = ((Dummy *)arg)->depth + 1;
+        streamtmp = (PyObject *)((Dummy *)arg)->stream;
+    }
+    else {
+        self->fused = 0;
+        self->depth = 0;
+        streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getStream", NULL);
+    }
     Py_INCREF(streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (Stream *)streamtmp;
@@ -152,14 +256,14 @@ Dummy_setInput(Dummy *self, PyObject *arg)
 }
 
 static PyObject * Dummy_getServer(Dummy* self) { GET_SERVER };
-static PyObject * Dummy_getStream(Dummy* self) { GET_STREAM };
+static PyObject * Dummy_getStream(Dummy* self) { Dummy_register(self); GET_STREAM };
 static PyObject * Dummy_setMul(Dummy *self, PyObject *arg) { SET_MUL };
 static PyObject * Dummy_setAdd(Dummy *self, PyObject *arg) { SET_ADD };
 static PyObject * Dummy_setSub(Dummy *self, PyObject *arg) { SET_SUB };
 static PyObject * Dummy_setDiv(Dummy *self, PyObject *arg) { SET_DIV };
 
-static PyObject * Dummy_play(Dummy *self, PyObject *args, PyObject *kwds) { PLAY };
-static PyObject * Dummy_out(Dummy *self, PyObject *args, PyObject *kwds) { OUT };
+static PyObject * Dummy_play(Dummy *self, PyObject *args, PyObject *kwds) { Dummy_register(self); PLAY };
+static PyObject * Dummy_out(Dummy *self, PyObject *args, PyObject *kwds) { Dummy_register(self); OUT };
 static PyObject * Dummy_stop(Dummy *self) { STOP };
 
 static PyObject * Dummy_multiply(Dummy *self, PyObject *arg) { MULTIPLY };
@@ -0,0 +1,381 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "eventfile.h"
+
+#define EVENTFILE_NUMEVENTS_OFFSET 24
+#define EVENTWRITER_CHUNK 4096 /* events written per call, so that every file gets its turn */
+
+static long
+EventFile_stride(int nfields)
+{
+    return (long)((sizeof(int64_t) + nfields * sizeof(float) + 7) & ~(size_t)7);
+}
+
+static int
+EventFile_parseHeader(EventFile *self, unsigned char *header, size_t length)
+{
+    int32_t fields[3];
+    int64_t numEvents;
+    long available;
+
+    if (length < EVENTFILE_HEADER_SIZE || memcmp(header, "PYEV", 4) != 0)
+        return -1;
+    memcpy(fields, header + 4, sizeof(fields));
+    memcpy(&self->sr, header + 16, sizeof(double));
+    memcpy(&numEvents, header + EVENTFILE_NUMEVENTS_OFFSET, sizeof(int64_t));
+    if (fields[0] != EVENTFILE_VERSION || fields[1] < 1 || fields[1] > EVENTFILE_MAX_FIELDS ||
+        fields[2] != EventFile_stride(fields[1]) || self->sr <= 0.0)
+        return -1;
+    self->nfields = fields[1];
+    self->stride = fields[2];
+
+    /* A file still recorded, or whose writer didn't complete, keeps the events written. */
+    available = (long)((length - EVENTFILE_HEADER_SIZE) / self->stride);
+    if (numEvents <= 0 || numEvents > available)
+        numEvents = available;
+    self->numEvents = (long)numEvents;
+    return 0;
+}
+
+EventFile *
+EventFile_open(const char *path)
+{
+    EventFile *self = (EventFile *)calloc(1, sizeof(EventFile));
+#ifndef _WIN32
+    int fd;
+    struct stat st;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(self);
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < EVENTFILE_HEADER_SIZE) {
+        close(fd);
+        free(self);
+        return NULL;
+    }
+    self->maplength = (size_t)st.st_size;
+    self->map = mmap(NULL, self->maplength, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (self->map == MAP_FAILED) {
+        free(self);
+        return NULL;
+    }
+    self->mapped = 1;
+#else
+    FILE *fp;
+    long length;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        free(self);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (length < EVENTFILE_HEADER_SIZE) {
+        fclose(fp);
+        free(self);
+        return NULL;
+    }
+    self->maplength = (size_t)length;
+    self->map = malloc(self->maplength);
+    if (self->map == NULL || fread(self->map, 1, self->maplength, fp) != self->maplength) {
+        fclose(fp);
+        free(self->map);
+        free(self);
+        return NULL;
+    }
+    fclose(fp);
+    self->mapped = 0;
+#endif
+
+    if (EventFile_parseHeader(self, (unsigned char *)self->map, self->maplength) < 0) {
+        EventFile_close(self);
+        return NULL;
+    }
+    self->data = (unsigned char *)self->map + EVENTFILE_HEADER_SIZE;
+    return self;
+}
+
+void
+EventFile_close(EventFile *self)
+{
+    if (self == NULL)
+        return;
+#ifndef _WIN32
+    if (self->mapped)
+        munmap(self->map, self->maplength);
+#else
+    free(self->map);
+#endif
+    free(self);
+}
+
+long
+EventFile_search(EventFile *self, int64_t time)
+{
+    long low = 0, high = self->numEvents, mid;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        if (EventFile_getTime(self, mid) < time)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    return low;
+}
+
+/**************************/
+/*** Writer ***/
+/**************************/
+
+struct EventWriter {
+    FILE *fp;
+    int nfields;
+    long stride;
+    long size;          /* events, a power of two */
+    unsigned char *ring;
+    volatile unsigned long written; /* events, by the audio thread */
+    volatile unsigned long flushed; /* events, by the writer thread */
+    volatile unsigned long dropped;
+    int error;
+    int closing;
+    int closed;
+    EventWriter *next;
+};
+
+static pthread_mutex_t eventwriter_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t eventwriter_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t eventwriter_closed_cond = PTHREAD_COND_INITIALIZER;
+static EventWriter *eventwriter_list = NULL;
+static int eventwriter_running = 0;
+static pthread_t eventwriter_thread;
+
+/* Returns 1 if events were written. */
+static int
+EventWriter_flush(EventWriter *self)
+{
+    long pos, num;
+    unsigned long written = self->written;
+
+    __sync_synchronize();
+    if (written == self->flushed)
+        return 0;
+    pos = (long)(self->flushed & (self->size - 1));
+    num = (long)(written - self->flushed);
+    if (num > self->size - pos)
+        num = self->size - pos;
+    if (num > EVENTWRITER_CHUNK)
+        num = EVENTWRITER_CHUNK;
+    if (fwrite(self->ring + pos * self->stride, self->stride, num, self->fp) != (size_t)num)
+        self->error = 1;
+    __sync_synchronize();
+    self->flushed += num;
+    return 1;
+}
+
+static void *
+EventWriter_run(void *arg)
+{
+    int worked;
+    EventWriter *ew;
+    struct timeval now;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&eventwriter_mutex);
+    while (eventwriter_running) {
+        worked = 0;
+        for (ew=eventwriter_list; ew!=NULL; ew=ew->next) {
+            if (ew->closed)
+                continue;
+            worked |= EventWriter_flush(ew);
+            if (ew->closing && ew->flushed == ew->written) {
+                ew->closed = 1;
+                pthread_cond_broadcast(&eventwriter_closed_cond);
+            }
+        }
+        if (!worked) {
+            /* The events of the last pass become visible to the readers. */
+            for (ew=eventwriter_list; ew!=NULL; ew=ew->next) {
+                if (!ew->closed)
+                    fflush(ew->fp);
+            }
+            gettimeofday(&now, NULL);
+            timeout.tv_sec = now.tv_sec;
+            timeout.tv_nsec = now.tv_usec * 1000 + 50000000;
+            if (timeout.tv_nsec >= 1000000000) {
+                timeout.tv_sec++;
+                timeout.tv_nsec -= 1000000000;
+            }
+            pthread_cond_timedwait(&eventwriter_cond, &eventwriter_mutex, &timeout);
+        }
+    }
+    pthread_mutex_unlock(&eventwriter_mutex);
+    return NULL;
+}
+
+EventWriter *
+EventWriter_new(const char *path, int nfields, double sr, long events)
+{
+    unsigned char header[EVENTFILE_HEADER_SIZE];
+    int32_t fields[3];
+    int64_t numEvents = 0;
+    EventWriter *self;
+
+    if (nfields < 1 || nfields > EVENTFILE_MAX_FIELDS)
+        return NULL;
+    self = (EventWriter *)calloc(1, sizeof(EventWriter));
+    self->fp = fopen(path, "wb");
+    if (self->fp == NULL) {
+        free(self);
+        return NULL;
+    }
+    self->nfields = nfields;
+    self->stride = EventFile_stride(nfields);
+    self->size = 1;
+    while (self->size < events)
+        self->size <<= 1;
+    self->ring = (unsigned char *)calloc(self->size, self->stride);
+
+    fields[0] = EVENTFILE_VERSION;
+    fields[1] = nfields;
+    fields[2] = (int32_t)self->stride;
+    memset(header, 0, EVENTFILE_HEADER_SIZE);
+    memcpy(header, "PYEV", 4);
+    memcpy(header + 4, fields, sizeof(fields));
+    memcpy(header + 16, &sr, sizeof(double));
+    memcpy(header + EVENTFILE_NUMEVENTS_OFFSET, &numEvents, sizeof(int64_t));
+    if (fwrite(header, 1, EVENTFILE_HEADER_SIZE, self->fp) != EVENTFILE_HEADER_SIZE) {
+        fclose(self->fp);
+        free(self->ring);
+        free(self);
+        return NULL;
+    }
+
+    pthread_mutex_lock(&eventwriter_mutex);
+    if (!eventwriter_running) {
+        if (pthread_create(&eventwriter_thread, NULL, EventWriter_run, NULL) != 0) {
+            pthread_mutex_unlock(&eventwriter_mutex);
+            fclose(self->fp);
+            free(self->ring);
+            free(self);
+            return NULL;
+        }
+        eventwriter_running = 1;
+    }
+    self->next = eventwriter_list;
+    eventwriter_list = self;
+    pthread_mutex_unlock(&eventwriter_mutex);
+
+    return self;
+}
+
+int
+EventWriter_write(EventWriter *self, long time, MYFLT *fields)
+{
+    int i;
+    int64_t t = (int64_t)time;
+    unsigned char *event;
+    float *values;
+
+    if (self->written - self->flushed >= (unsigned long)self->size) {
+        self->dropped++;
+        return -1;
+    }
+    event = self->ring + (self->written & (self->size - 1)) * self->stride;
+    memcpy(event, &t, sizeof(int64_t));
+    values = (float *)(event + sizeof(int64_t));
+    for (i=0; i<self->nfields; i++)
+        values[i] = (float)fields[i];
+    __sync_synchronize();
+    self->written++;
+    return 0;
+}
+
+int
+EventWriter_close(EventWriter *self)
+{
+    int err, stop = 0;
+    int64_t numEvents;
+    EventWriter **ew;
+
+    if (self == NULL)
+        return -1;
+
+    pthread_mutex_lock(&eventwriter_mutex);
+    self->closing = 1;
+    pthread_cond_signal(&eventwriter_cond);
+    while (!self->closed)
+        pthread_cond_wait(&eventwriter_closed_cond, &eventwriter_mutex);
+    for (ew=&eventwriter_list; *ew!=NULL; ew=&(*ew)->next) {
+        if (*ew == self) {
+            *ew = self->next;
+            break;
+        }
+    }
+    if (eventwriter_list == NULL) {
+        eventwriter_running = 0;
+        pthread_cond_signal(&eventwriter_cond);
+        stop = 1;
+    }
+    pthread_mutex_unlock(&eventwriter_mutex);
+    if (stop)
+        pthread_join(eventwriter_thread, NULL);
+
+    err = self->error ? -1 : 0;
+    numEvents = (int64_t)self->flushed;
+    if (fseek(self->fp, EVENTFILE_NUMEVENTS_OFFSET, SEEK_SET) != 0 ||
+        fwrite(&numEvents, sizeof(int64_t), 1, self->fp) != 1)
+        err = -1;
+    if (fclose(self->fp) != 0)
+        err = -1;
+    free(self->ring);
+    free(self);
+    return err;
+}
+
+unsigned long
+EventWriter_getDropped(EventWriter *self)
+{
+    return self == NULL ? 0 : self->dropped;
+}
+
+long
+EventWriter_getMemory(EventWriter *self)
+{
+    return self == NULL ? 0 : self->size * self->stride;
+}
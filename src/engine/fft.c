@@ -70,6 +70,273 @@ void fft_compute_radix2_twiddle(MYFLT *twiddle, int size) {
     }
 
 }
+/****************************************************************
+** Vectorized L shaped butterflies of the split-radix routines.
+**
+** For a given stage, the butterflies of twiddle index j and
+** those of the mirrored index n4-j+2 are independent, so the
+** loops are swapped: the twiddle index runs contiguously in the
+** inner loop, with the twiddles of the stage gathered in chunks
+** of FFT_CHUNK values. Mirrored elements are loaded as vectors
+** and reversed in registers. Only separate multiplies, adds and
+** subtracts are used, the results are identical to the scalar
+** code whatever the instruction set.
+**
+** The SSE (SSE2 for doubles) and NEON kernels are used when the
+** compiler targets them, the AVX ones when the processor reports
+** it at run time.
+****************************************************************/
+#define FFT_CHUNK 64
+/* Below this count the scalar kernel is called directly (and inlined). */
+#define FFT_VMIN 4
+
+typedef void (*fft_lbutterfly_func)(MYFLT *d, int n4, int j0, int count, MYFLT *tw);
+
+/* Scalar butterflies from index m to count, also used as tail by the
+   vector kernels so that they run with the same encoding. */
+#define FFT_FWD_LBUTTERFLY_SCALAR \
+    for (; m<count; m++) { \
+        MYFLT t1,t2,t3,t4,t5,t6; \
+        MYFLT cc1 = tw[m], ss1 = tw[FFT_CHUNK+m]; \
+        MYFLT cc3 = tw[FFT_CHUNK*2+m], ss3 = tw[FFT_CHUNK*3+m]; \
+        int i1 = j0 + m - 1, i5 = n4 - j0 - m + 1; \
+        int i2 = i1 + n4, i3 = i2 + n4, i4 = i3 + n4; \
+        int i6 = i5 + n4, i7 = i6 + n4, i8 = i7 + n4; \
+        t1 = d[i3] * cc1 + d[i7] * ss1; \
+        t2 = d[i7] * cc1 - d[i3] * ss1; \
+        t3 = d[i4] * cc3 + d[i8] * ss3; \
+        t4 = d[i8] * cc3 - d[i4] * ss3; \
+        t5 = t1 + t3; \
+        t6 = t2 + t4; \
+        t3 = t1 - t3; \
+        t4 = t2 - t4; \
+        t2 = d[i6] + t6; \
+        d[i3] = t6 - d[i6]; \
+        d[i8] = t2; \
+        t2 = d[i2] - t3; \
+        d[i7] = -d[i2] - t3; \
+        d[i4] = t2; \
+        t1 = d[i1] + t5; \
+        d[i6] = d[i1] - t5; \
+        d[i1] = t1; \
+        t1 = d[i5] + t4; \
+        d[i5] -= t4; \
+        d[i2] = t1; \
+    }
+
+#define FFT_INV_LBUTTERFLY_SCALAR \
+    for (; m<count; m++) { \
+        MYFLT t1,t2,t3,t4,t5; \
+        MYFLT cc1 = tw[m], ss1 = tw[FFT_CHUNK+m]; \
+        MYFLT cc3 = tw[FFT_CHUNK*2+m], ss3 = tw[FFT_CHUNK*3+m]; \
+        int i1 = j0 + m - 1, i5 = n4 - j0 - m + 1; \
+        int i2 = i1 + n4, i3 = i2 + n4, i4 = i3 + n4; \
+        int i6 = i5 + n4, i7 = i6 + n4, i8 = i7 + n4; \
+        t1 = d[i1] - d[i6]; \
+        d[i1] += d[i6]; \
+        t2 = d[i5] - d[i2]; \
+        d[i5] += d[i2]; \
+        t3 = d[i8] + d[i3]; \
+        d[i6] = d[i8] - d[i3]; \
+        t4 = d[i4] + d[i7]; \
+        d[i2] = d[i4] - d[i7]; \
+        t5 = t1 - t4; \
+        t1 += t4; \
+        t4 = t2 - t3; \
+        t2 += t3; \
+        d[i3] = t5 * cc1 + t4 * ss1; \
+        d[i7] = -t4 * cc1 + t5 * ss1; \
+        d[i4] = t1 * cc3 - t2 * ss3; \
+        d[i8] = t2 * cc3 + t1 * ss3; \
+    }
+
+static void
+fft_fwd_lbutterfly_scalar(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    int m = 0;
+    FFT_FWD_LBUTTERFLY_SCALAR
+}
+
+static void
+fft_inv_lbutterfly_scalar(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    int m = 0;
+    FFT_INV_LBUTTERFLY_SCALAR
+}
+
+/* Kernel bodies, expanded for each instruction set. `V` is the number of
+   lanes, p1 points to the i1 elements and p5 to the last lane of the
+   mirrored i5 elements. */
+#define FFT_FWD_LBUTTERFLY_BODY(V, VT, LD, ST, ADD, SUB, MUL, NEG, REV) \
+    int m = 0, n42 = n4 * 2, n43 = n4 * 3; \
+    for (; (m+V)<=count; m+=V) { \
+        MYFLT *p1 = d + j0 + m - 1; \
+        MYFLT *p5 = d + n4 - j0 - m + 2 - V; \
+        VT a1 = LD(p1), a2 = LD(p1+n4), a3 = LD(p1+n42), a4 = LD(p1+n43); \
+        VT b1 = REV(LD(p5)), b2 = REV(LD(p5+n4)), b3 = REV(LD(p5+n42)), b4 = REV(LD(p5+n43)); \
+        VT c1 = LD(tw+m), s1 = LD(tw+FFT_CHUNK+m); \
+        VT c3 = LD(tw+FFT_CHUNK*2+m), s3 = LD(tw+FFT_CHUNK*3+m); \
+        VT t1 = ADD(MUL(a3, c1), MUL(b3, s1)); \
+        VT t2 = SUB(MUL(b3, c1), MUL(a3, s1)); \
+        VT t3 = ADD(MUL(a4, c3), MUL(b4, s3)); \
+        VT t4 = SUB(MUL(b4, c3), MUL(a4, s3)); \
+        VT t5 = ADD(t1, t3); \
+        VT t6 = ADD(t2, t4); \
+        t3 = SUB(t1, t3); \
+        t4 = SUB(t2, t4); \
+        ST(p1+n42, SUB(t6, b2)); \
+        ST(p5+n43, REV(ADD(b2, t6))); \
+        ST(p1+n43, SUB(a2, t3)); \
+        ST(p5+n42, REV(SUB(NEG(a2), t3))); \
+        ST(p1, ADD(a1, t5)); \
+        ST(p5+n4, REV(SUB(a1, t5))); \
+        ST(p1+n4, ADD(b1, t4)); \
+        ST(p5, REV(SUB(b1, t4))); \
+    } \
+    FFT_FWD_LBUTTERFLY_SCALAR
+
+#define FFT_INV_LBUTTERFLY_BODY(V, VT, LD, ST, ADD, SUB, MUL, NEG, REV) \
+    int m = 0, n42 = n4 * 2, n43 = n4 * 3; \
+    for (; (m+V)<=count; m+=V) { \
+        MYFLT *p1 = d + j0 + m - 1; \
+        MYFLT *p5 = d + n4 - j0 - m + 2 - V; \
+        VT a1 = LD(p1), a2 = LD(p1+n4), a3 = LD(p1+n42), a4 = LD(p1+n43); \
+        VT b1 = REV(LD(p5)), b2 = REV(LD(p5+n4)), b3 = REV(LD(p5+n42)), b4 = REV(LD(p5+n43)); \
+        VT c1 = LD(tw+m), s1 = LD(tw+FFT_CHUNK+m); \
+        VT c3 = LD(tw+FFT_CHUNK*2+m), s3 = LD(tw+FFT_CHUNK*3+m); \
+        VT t1 = SUB(a1, b2); \
+        VT t2 = SUB(b1, a2); \
+        VT t3 = ADD(b4, a3); \
+        VT t4 = ADD(a4, b3); \
+        VT t5; \
+        ST(p1, ADD(a1, b2)); \
+        ST(p5, REV(ADD(b1, a2))); \
+        ST(p5+n4, REV(SUB(b4, a3))); \
+        ST(p1+n4, SUB(a4, b3)); \
+        t5 = SUB(t1, t4); \
+        t1 = ADD(t1, t4); \
+        t4 = SUB(t2, t3); \
+        t2 = ADD(t2, t3); \
+        ST(p1+n42, ADD(MUL(t5, c1), MUL(t4, s1))); \
+        ST(p5+n42, REV(ADD(MUL(NEG(t4), c1), MUL(t5, s1)))); \
+        ST(p1+n43, SUB(MUL(t1, c3), MUL(t2, s3))); \
+        ST(p5+n43, REV(ADD(MUL(t2, c3), MUL(t1, s3)))); \
+    } \
+    FFT_INV_LBUTTERFLY_SCALAR
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#if defined(__GNUC__) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define FFT_AVX_TARGET
+#endif
+#ifndef USE_DOUBLE
+#ifdef __SSE__
+#define FFT_HAVE_SSE
+#define FFT_SSE_REV(x) _mm_shuffle_ps(x, x, _MM_SHUFFLE(0,1,2,3))
+#define FFT_SSE_NEG(x) _mm_xor_ps(x, _mm_set1_ps(-0.0f))
+static void fft_fwd_lbutterfly_sse(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, FFT_SSE_NEG, FFT_SSE_REV)
+}
+static void fft_inv_lbutterfly_sse(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(4, __m128, _mm_loadu_ps, _mm_storeu_ps, _mm_add_ps, _mm_sub_ps, _mm_mul_ps, FFT_SSE_NEG, FFT_SSE_REV)
+}
+#endif
+#ifdef FFT_AVX_TARGET
+#define FFT_AVX_REV(x) _mm256_permute_ps(_mm256_permute2f128_ps(x, x, 1), _MM_SHUFFLE(0,1,2,3))
+#define FFT_AVX_NEG(x) _mm256_xor_ps(x, _mm256_set1_ps(-0.0f))
+__attribute__((target("avx")))
+static void fft_fwd_lbutterfly_avx(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, FFT_AVX_NEG, FFT_AVX_REV)
+}
+__attribute__((target("avx")))
+static void fft_inv_lbutterfly_avx(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(8, __m256, _mm256_loadu_ps, _mm256_storeu_ps, _mm256_add_ps, _mm256_sub_ps, _mm256_mul_ps, FFT_AVX_NEG, FFT_AVX_REV)
+}
+#endif
+#else
+#ifdef __SSE2__
+#define FFT_HAVE_SSE
+#define FFT_SSE_REV(x) _mm_shuffle_pd(x, x, 1)
+#define FFT_SSE_NEG(x) _mm_xor_pd(x, _mm_set1_pd(-0.0))
+static void fft_fwd_lbutterfly_sse(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(2, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd, FFT_SSE_NEG, FFT_SSE_REV)
+}
+static void fft_inv_lbutterfly_sse(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(2, __m128d, _mm_loadu_pd, _mm_storeu_pd, _mm_add_pd, _mm_sub_pd, _mm_mul_pd, FFT_SSE_NEG, FFT_SSE_REV)
+}
+#endif
+#ifdef FFT_AVX_TARGET
+#define FFT_AVX_REV(x) _mm256_permute_pd(_mm256_permute2f128_pd(x, x, 1), 5)
+#define FFT_AVX_NEG(x) _mm256_xor_pd(x, _mm256_set1_pd(-0.0))
+__attribute__((target("avx")))
+static void fft_fwd_lbutterfly_avx(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(4, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, FFT_AVX_NEG, FFT_AVX_REV)
+}
+__attribute__((target("avx")))
+static void fft_inv_lbutterfly_avx(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(4, __m256d, _mm256_loadu_pd, _mm256_storeu_pd, _mm256_add_pd, _mm256_sub_pd, _mm256_mul_pd, FFT_AVX_NEG, FFT_AVX_REV)
+}
+#endif
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define FFT_HAVE_NEON
+#ifndef USE_DOUBLE
+#define FFT_NEON_REV(x) vextq_f32(vrev64q_f32(x), vrev64q_f32(x), 2)
+static void fft_fwd_lbutterfly_neon(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(4, float32x4_t, vld1q_f32, vst1q_f32, vaddq_f32, vsubq_f32, vmulq_f32, vnegq_f32, FFT_NEON_REV)
+}
+static void fft_inv_lbutterfly_neon(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(4, float32x4_t, vld1q_f32, vst1q_f32, vaddq_f32, vsubq_f32, vmulq_f32, vnegq_f32, FFT_NEON_REV)
+}
+#else
+#define FFT_NEON_REV(x) vextq_f64(x, x, 1)
+static void fft_fwd_lbutterfly_neon(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_FWD_LBUTTERFLY_BODY(2, float64x2_t, vld1q_f64, vst1q_f64, vaddq_f64, vsubq_f64, vmulq_f64, vnegq_f64, FFT_NEON_REV)
+}
+static void fft_inv_lbutterfly_neon(MYFLT *d, int n4, int j0, int count, MYFLT *tw) {
+    FFT_INV_LBUTTERFLY_BODY(2, float64x2_t, vld1q_f64, vst1q_f64, vaddq_f64, vsubq_f64, vmulq_f64, vnegq_f64, FFT_NEON_REV)
+}
+#endif
+#endif
+
+static fft_lbutterfly_func fft_fwd_lbutterfly = NULL;
+static fft_lbutterfly_func fft_inv_lbutterfly = NULL;
+
+/* Picks the kernels once. Concurrent first calls store the same pointers. */
+static void
+fft_select_kernels(void) {
+    fft_lbutterfly_func fwd = fft_fwd_lbutterfly_scalar;
+    fft_lbutterfly_func inv = fft_inv_lbutterfly_scalar;
+#if defined(FFT_HAVE_SSE)
+    fwd = fft_fwd_lbutterfly_sse;
+    inv = fft_inv_lbutterfly_sse;
+#elif defined(FFT_HAVE_NEON)
+    fwd = fft_fwd_lbutterfly_neon;
+    inv = fft_inv_lbutterfly_neon;
+#endif
+#ifdef FFT_AVX_TARGET
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx")) {
+        fwd = fft_fwd_lbutterfly_avx;
+        inv = fft_inv_lbutterfly_avx;
+    }
+#endif
+    fft_inv_lbutterfly = inv;
+    fft_fwd_lbutterfly = fwd;
+}
+
+/* Copies the twiddles of indices j0 .. j0+count-1 of a stage. */
+static void
+fft_gather_twiddle(MYFLT *tw, MYFLT **twiddle, int j0, int count, int pas) {
+    int m, pos;
+    for (m=0; m<count; m++) {
+        pos = (j0 + m - 1) * pas;
+        tw[m] = twiddle[0][pos];
+        tw[FFT_CHUNK+m] = twiddle[1][pos];
+        tw[FFT_CHUNK*2+m] = twiddle[2][pos];
+        tw[FFT_CHUNK*3+m] = twiddle[3][pos];
+    }
+}
+
 /****************************************************************
 ** Sorensen in-place split-radix FFT for real values
 ** data: array of doubles:
@@ -85,9 +352,13 @@ void fft_compute_radix2_twiddle(MYFLT *twiddle, int size) {
 **************************************************************** */
 void realfft_split(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle) {
 
-    int i,j,k,i5,i6,i7,i8,i0,id,i1,i2,i3,i4,n2,n4,n8;
-    int pas, pos;
-    MYFLT t1,t2,t3,t4,t5,t6,ss1,ss3,cc1,cc3,sqrt2;
+    int i,j,k,i0,id,i1,i2,i3,i4,n2,n4,n8;
+    int pas, count;
+    MYFLT t1,t2,sqrt2;
+    MYFLT tw[FFT_CHUNK*4];
+
+    if (fft_fwd_lbutterfly == NULL)
+        fft_select_kernels();
 
     sqrt2 = 1.4142135623730951; /* sqrt(2.0) */
     n4 = n - 1;
@@ -157,45 +428,20 @@ void realfft_split(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle) {
 	        i1 = id - n2;
 	        id <<= 1;
 	    } while ( i1<n );
-	    for (j=2; j<=n8; j++){
-	        pos = (j-1) * pas;
-	        cc1 = twiddle[0][pos];
-	        ss1 = twiddle[1][pos];
-	        cc3 = twiddle[2][pos];
-	        ss3 = twiddle[3][pos];
+	    for (j=2; j<=n8; j+=FFT_CHUNK){
+	        count = n8 - j + 1;
+	        if (count > FFT_CHUNK)
+	            count = FFT_CHUNK;
+	        fft_gather_twiddle(tw, twiddle, j, count, pas);
 	        i = 0;
 	        id = n2 << 1;
 	        do {
-		        for (; i<n; i+=id){
-			        i1 = i + j - 1;
-			        i2 = i1 + n4;
-			        i3 = i2 + n4;
-			        i4 = i3 + n4;
-			        i5 = i + n4 - j + 1;
-			        i6 = i5 + n4;
-			        i7 = i6 + n4;
-			        i8 = i7 + n4;
-			        t1 = data[i3] * cc1 + data[i7] * ss1;
-			        t2 = data[i7] * cc1 - data[i3] * ss1;
-			        t3 = data[i4] * cc3 + data[i8] * ss3;
-			        t4 = data[i8] * cc3 - data[i4] * ss3;
-			        t5 = t1 + t3;
-			        t6 = t2 + t4;
-			        t3 = t1 - t3;
-			        t4 = t2 - t4;
-			        t2 = data[i6] + t6;
-			        data[i3] = t6 - data[i6];
-			        data[i8] = t2;
-			        t2 = data[i2] - t3;
-			        data[i7] = -data[i2] - t3;
-			        data[i4] = t2;
-			        t1 = data[i1] + t5;
-			        data[i6] = data[i1] - t5;
-			        data[i1] = t1;
-			        t1 = data[i5] + t4;
-			        data[i5] -= t4;
-			        data[i2] = t1;
-	            }
+		        for (; i<n; i+=id) {
+		            if (count < FFT_VMIN)
+		                fft_fwd_lbutterfly_scalar(data + i, n4, j, count, tw);
+		            else
+		                (*fft_fwd_lbutterfly)(data + i, n4, j, count, tw);
+		        }
 		        id <<= 1;
 		        i = id - n2;
 		        id <<= 1;
@@ -224,9 +470,13 @@ void realfft_split(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle) {
 
 void irealfft_split(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle) {
 
-    int i,j,k,i5,i6,i7,i8,i0,id,i1,i2,i3,i4,n2,n4,n8,n1;
-    int pas, pos;
-    MYFLT t1,t2,t3,t4,t5,ss1,ss3,cc1,cc3,sqrt2;
+    int i,j,k,i0,id,i1,i2,i3,i4,n2,n4,n8,n1;
+    int pas, count;
+    MYFLT t1,t2,sqrt2;
+    MYFLT tw[FFT_CHUNK*4];
+
+    if (fft_inv_lbutterfly == NULL)
+        fft_select_kernels();
 
     sqrt2 = 1.4142135623730951; /* sqrt(2.0) */
 
@@ -266,41 +516,20 @@ void irealfft_split(MYFLT *data, MYFLT *outdata, int n, MYFLT **twiddle) {
 	        i1 = id - n2;
 	        id <<= 1;
 	    } while ( i1<n1 );
-	    for (j=2; j<=n8; j++) {
-	        pos = (j-1) * pas;
-	        cc1 = twiddle[0][pos];
-	        ss1 = twiddle[1][pos];
-	        cc3 = twiddle[2][pos];
-	        ss3 = twiddle[3][pos];
+	    for (j=2; j<=n8; j+=FFT_CHUNK) {
+	        count = n8 - j + 1;
+	        if (count > FFT_CHUNK)
+	            count = FFT_CHUNK;
+	        fft_gather_twiddle(tw, twiddle, j, count, pas);
 	        i = 0;
 	        id = n2 << 1;
 	        do {
 		        for (; i<n; i+=id) {
-			        i1 = i + j - 1;
-			        i2 = i1 + n4;
-			        i3 = i2 + n4;
-			        i4 = i3 + n4;
-			        i5 = i + n4 - j + 1;
-			        i6 = i5 + n4;
-			        i7 = i6 + n4;
-			        i8 = i7 + n4;
-			        t1 = data[i1] - data[i6];
-			        data[i1] += data[i6];
-			        t2 = data[i5] - data[i2];
-			        data[i5] += data[i2];
-			        t3 = data[i8] + data[i3];
-			        data[i6] = data[i8] - data[i3];
-			        t4 = data[i4] + data[i7];
-			        data[i2] = data[i4] - data[i7];
-			        t5 = t1 - t4;
-			        t1 += t4;
-			        t4 = t2 - t3;
-			        t2 += t3;
-			        data[i3] = t5 * cc1 + t4 * ss1;
-			        data[i7] = -t4 * cc1 + t5 * ss1;
-			        data[i4] = t1 * cc3 - t2 * ss3;
-			        data[i8] = t2 * cc3 + t1 * ss3;
-			    }
+		            if (count < FFT_VMIN)
+		                fft_inv_lbutterfly_scalar(data + i, n4, j, count, tw);
+		            else
+		                (*fft_inv_lbutterfly)(data + i, n4, j, count, tw);
+		        }
 		        id <<= 1;
 		        i = id - n2;
 		        id <<= 1;
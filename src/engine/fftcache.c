@@ -0,0 +1,161 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "pyomodule.h"
+#include "fft.h"
+#include "wind.h"
+
+#define FFT_CACHE_SPLIT 0
+#define FFT_CACHE_RADIX2 1
+#define FFT_CACHE_WINDOW 2
+
+/* Number of unreferenced tables kept before the oldest one is freed. */
+#define FFT_CACHE_IDLE 16
+
+typedef struct FFTCacheEntry {
+    int kind;
+    int size;
+    int wintype;
+    int refcount;
+    unsigned long stamp;            /* time of the last release */
+    MYFLT **twiddle;                /* rows of the split-radix twiddles */
+    MYFLT *table;                   /* storage of the table */
+    struct FFTCacheEntry *next;
+} FFTCacheEntry;
+
+static FFTCacheEntry *fft_cache = NULL;
+static unsigned long fft_cache_clock = 0;
+static pthread_mutex_t fft_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static FFTCacheEntry *
+fft_cache_create(int kind, int size, int wintype) {
+    int i, n8;
+    FFTCacheEntry *entry = (FFTCacheEntry *)calloc(1, sizeof(FFTCacheEntry));
+
+    entry->kind = kind;
+    entry->size = size;
+    entry->wintype = wintype;
+
+    switch (kind) {
+        case FFT_CACHE_SPLIT:
+            n8 = size >> 3;
+            if (n8 < 1)
+                n8 = 1;
+            entry->table = (MYFLT *)calloc(4 * n8, sizeof(MYFLT));
+            entry->twiddle = (MYFLT **)malloc(4 * sizeof(MYFLT *));
+            for (i=0; i<4; i++)
+                entry->twiddle[i] = entry->table + i * n8;
+            fft_compute_split_twiddle(entry->twiddle, size);
+            break;
+        case FFT_CACHE_RADIX2:
+            entry->table = (MYFLT *)calloc(size, sizeof(MYFLT));
+            fft_compute_radix2_twiddle(entry->table, size);
+            break;
+        case FFT_CACHE_WINDOW:
+            entry->table = (MYFLT *)calloc(size, sizeof(MYFLT));
+            gen_window(entry->table, size, wintype);
+            break;
+    }
+
+    entry->next = fft_cache;
+    fft_cache = entry;
+    return entry;
+}
+
+static FFTCacheEntry *
+fft_cache_acquire(int kind, int size, int wintype) {
+    FFTCacheEntry *entry;
+
+    pthread_mutex_lock(&fft_cache_mutex);
+    for (entry=fft_cache; entry!=NULL; entry=entry->next) {
+        if (entry->kind == kind && entry->size == size && entry->wintype == wintype)
+            break;
+    }
+    if (entry == NULL)
+        entry = fft_cache_create(kind, size, wintype);
+    entry->refcount++;
+    pthread_mutex_unlock(&fft_cache_mutex);
+
+    return entry;
+}
+
+MYFLT **
+fft_acquire_split_twiddle(int size) {
+    return fft_cache_acquire(FFT_CACHE_SPLIT, size, 0)->twiddle;
+}
+
+MYFLT *
+fft_acquire_radix2_twiddle(int size) {
+    return fft_cache_acquire(FFT_CACHE_RADIX2, size, 0)->table;
+}
+
+const MYFLT *
+fft_acquire_window(int size, int wintype) {
+    return fft_cache_acquire(FFT_CACHE_WINDOW, size, wintype)->table;
+}
+
+/* Frees the least recently released table if too many are idle. */
+static void
+fft_cache_trim(void) {
+    int idle = 0;
+    FFTCacheEntry *entry, **link, **oldest = NULL;
+
+    for (link=&fft_cache; *link!=NULL; link=&(*link)->next) {
+        entry = *link;
+        if (entry->refcount > 0)
+            continue;
+        idle++;
+        if (oldest == NULL || entry->stamp < (*oldest)->stamp)
+            oldest = link;
+    }
+
+    if (idle > FFT_CACHE_IDLE) {
+        entry = *oldest;
+        *oldest = entry->next;
+        free(entry->twiddle);
+        free(entry->table);
+        free(entry);
+    }
+}
+
+void
+fft_release_table(const void *table) {
+    FFTCacheEntry *entry;
+
+    if (table == NULL)
+        return;
+
+    pthread_mutex_lock(&fft_cache_mutex);
+    for (entry=fft_cache; entry!=NULL; entry=entry->next) {
+        if ((const void *)entry->twiddle == table || (entry->kind != FFT_CACHE_SPLIT && (const void *)entry->table == table))
+            break;
+    }
+    if (entry != NULL && entry->refcount > 0) {
+        entry->refcount--;
+        if (entry->refcount == 0) {
+            entry->stamp = ++fft_cache_clock;
+            fft_cache_trim();
+        }
+    }
+    pthread_mutex_unlock(&fft_cache_mutex);
+}
@@ -36,15 +36,34 @@ typedef struct {
     int switcher;
     double currentTime;
     double sampleToSec;
+    int *trigs; /* copy of the triggers of the input */
 } InputFader;
 
 static void InputFader_setProcMode(InputFader *self) {};
 
+/* Forwards the trigger list of the input. It is copied, the input may be
+ * computed again before the objects reading the fader. */
+static void InputFader_setTriggers(InputFader *self, Stream *input)
+{
+    int num = Stream_getNumTriggers(input);
+
+    if (num >= 0) {
+        memcpy(self->trigs, Stream_getTriggers(input), num * sizeof(int));
+        Stream_setTriggers(self->stream, self->trigs, num);
+    }
+}
+
 static void InputFader_process_only_first(InputFader *self)
 {
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input1_stream);
 
+    InputFader_setTriggers(self, self->input1_stream);
+    if (Stream_isConstant(self->input1_stream)) {
+        pyo_fill(self->data, in[0], self->bufsize);
+        Stream_setConstant(self->stream, 1);
+        return;
+    }
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = in[i];
     }
@@ -55,6 +74,12 @@ static void InputFader_process_only_second(InputFader *self)
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input2_stream);
 
+    InputFader_setTriggers(self, self->input2_stream);
+    if (Stream_isConstant(self->input2_stream)) {
+        pyo_fill(self->data, in[0], self->bufsize);
+        Stream_setConstant(self->stream, 1);
+        return;
+    }
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = in[i];
     }
@@ -139,6 +164,7 @@ static void
 InputFader_dealloc(InputFader* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     InputFader_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -156,6 +182,7 @@ InputFader_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->currentTime = 0.0;
 
     INIT_OBJECT_COMMON
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
 
     self->sampleToSec = 1. / self->sr;
 
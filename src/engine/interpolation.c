@@ -20,6 +20,8 @@
 
 #include "interpolation.h"
 #include "pyomodule.h"
+#include "tablemodule.h"
+#include "simd.h"
 #include <math.h>
 
 MYFLT nointerp(MYFLT *buf, int index, MYFLT frac, int size) {
@@ -65,4 +67,151 @@ MYFLT cubic(MYFLT *buf, int index, MYFLT frac, int size) {
     a0 *= frac; a1 *= frac; a2 *= frac; a3 *= frac; a1 += 1.0;
 
     return (a0*x0+a1*x1+a2*x2+a3*x3);
-}
\ No newline at end of file
+}
+
+/* The same kernels for every storage format of the tables, SAMPLE_##SUFFIX(i)
+ * reads the sample `i` of `buf` as a MYFLT. */
+#define SAMPLE_native(i) (((MYFLT *)buf)[i])
+#define SAMPLE_float32(i) ((MYFLT)((float *)buf)[i])
+#define SAMPLE_int16(i) (((short *)buf)[i] * (MYFLT)(1.0 / 32768.0))
+#define SAMPLE_paged(i) TABLE_PAGE_SAMPLE((MYFLT **)buf, i)
+
+#define TABLE_INTERP_FUNCS(SUFFIX) \
+static MYFLT nointerp_##SUFFIX(void *buf, int index, MYFLT frac, int size) { \
+    return SAMPLE_##SUFFIX(index); \
+} \
+static MYFLT linear_##SUFFIX(void *buf, int index, MYFLT frac, int size) { \
+    MYFLT x1 = SAMPLE_##SUFFIX(index); \
+    MYFLT x2 = SAMPLE_##SUFFIX(index+1); \
+    return (x1 + (x2 - x1) * frac); \
+} \
+static MYFLT cosine_##SUFFIX(void *buf, int index, MYFLT frac, int size) { \
+    MYFLT x1 = SAMPLE_##SUFFIX(index); \
+    MYFLT x2 = SAMPLE_##SUFFIX(index+1); \
+    MYFLT frac2 = (1.0 - MYCOS(frac * M_PI)) * 0.5; \
+    return (x1 + (x2 - x1) * frac2); \
+} \
+static MYFLT cubic_##SUFFIX(void *buf, int index, MYFLT frac, int size) { \
+    MYFLT x0, x3, a0, a1, a2, a3; \
+    MYFLT x1 = SAMPLE_##SUFFIX(index); \
+    MYFLT x2 = SAMPLE_##SUFFIX(index+1); \
+    if (index == 0) { \
+        x0 = x1 + (x1 - x2); \
+        x3 = SAMPLE_##SUFFIX(index + 2); \
+    } \
+    else if (index >= (size-2)) { \
+        x0 = SAMPLE_##SUFFIX(index - 1); \
+        x3 = x2 + (x2 - x1); \
+    } \
+    else { \
+        x0 = SAMPLE_##SUFFIX(index - 1); \
+        x3 = SAMPLE_##SUFFIX(index + 2); \
+    } \
+    a3 = frac * frac; a3 -= 1.0; a3 *= (1.0 / 6.0); \
+    a2 = (frac + 1.0) * 0.5; a0 = a2 - 1.0; \
+    a1 = a3 * 3.0; a2 -= a1; a0 -= a3; a1 -= frac; \
+    a0 *= frac; a1 *= frac; a2 *= frac; a3 *= frac; a1 += 1.0; \
+    return (a0*x0+a1*x1+a2*x2+a3*x3); \
+}
+
+TABLE_INTERP_FUNCS(native)
+TABLE_INTERP_FUNCS(float32)
+TABLE_INTERP_FUNCS(int16)
+TABLE_INTERP_FUNCS(paged)
+
+/* Block versions, out[i] is the table read at index[i] + frac[i]. nointerp
+ * and linear load the samples with vector gathers when the format and the
+ * compiler allow it, the others are plain loops over the inlined kernels. */
+#if defined(VGATHER)
+#define GATHER_nointerp_native \
+    for (; i<=num-VSIZE; i+=VSIZE) { \
+        VSTORE(out + i, VGATHER((MYFLT *)buf, VLOADI(index + i))); \
+    }
+#define GATHER_linear_native \
+    for (; i<=num-VSIZE; i+=VSIZE) { \
+        VTYPE x1 = VGATHER((MYFLT *)buf, VLOADI(index + i)); \
+        VTYPE x2 = VGATHER((MYFLT *)buf + 1, VLOADI(index + i)); \
+        VSTORE(out + i, VADD(x1, VMUL(VSUB(x2, x1), VLOAD(frac + i)))); \
+    }
+#else
+#define GATHER_nointerp_native
+#define GATHER_linear_native
+#endif
+#if defined(VGATHER) && !defined(USE_DOUBLE)
+#define GATHER_nointerp_float32 GATHER_nointerp_native
+#define GATHER_linear_float32 GATHER_linear_native
+#else
+#define GATHER_nointerp_float32
+#define GATHER_linear_float32
+#endif
+#define GATHER_nointerp_int16
+#define GATHER_linear_int16
+#define GATHER_nointerp_paged
+#define GATHER_linear_paged
+
+#define TABLE_INTERP_BLOCKS(SUFFIX) \
+static void nointerp_block_##SUFFIX(void *buf, int *index, MYFLT *frac, MYFLT *out, int num, int size) { \
+    int i = 0; \
+    GATHER_nointerp_##SUFFIX \
+    for (; i<num; i++) \
+        out[i] = SAMPLE_##SUFFIX(index[i]); \
+} \
+static void linear_block_##SUFFIX(void *buf, int *index, MYFLT *frac, MYFLT *out, int num, int size) { \
+    int i = 0; \
+    MYFLT x1, x2; \
+    GATHER_linear_##SUFFIX \
+    for (; i<num; i++) { \
+        x1 = SAMPLE_##SUFFIX(index[i]); \
+        x2 = SAMPLE_##SUFFIX(index[i]+1); \
+        out[i] = x1 + (x2 - x1) * frac[i]; \
+    } \
+} \
+static void cosine_block_##SUFFIX(void *buf, int *index, MYFLT *frac, MYFLT *out, int num, int size) { \
+    int i; \
+    for (i=0; i<num; i++) \
+        out[i] = cosine_##SUFFIX(buf, index[i], frac[i], size); \
+} \
+static void cubic_block_##SUFFIX(void *buf, int *index, MYFLT *frac, MYFLT *out, int num, int size) { \
+    int i; \
+    for (i=0; i<num; i++) \
+        out[i] = cubic_##SUFFIX(buf, index[i], frac[i], size); \
+}
+
+TABLE_INTERP_BLOCKS(native)
+TABLE_INTERP_BLOCKS(float32)
+TABLE_INTERP_BLOCKS(int16)
+TABLE_INTERP_BLOCKS(paged)
+
+TableInterpFunc
+TableInterp_get(int interp, int format)
+{
+    static TableInterpFunc funcs[4][4] = {
+        {nointerp_native, linear_native, cosine_native, cubic_native},
+        {nointerp_float32, linear_float32, cosine_float32, cubic_float32},
+        {nointerp_int16, linear_int16, cosine_int16, cubic_int16},
+        {nointerp_paged, linear_paged, cosine_paged, cubic_paged}
+    };
+
+    if (interp < 1 || interp > 4)
+        interp = 2;
+    if (format < TABLE_NATIVE || format > TABLE_PAGED)
+        format = TABLE_NATIVE;
+    return funcs[format][interp - 1];
+}
+
+TableInterpBlockFunc
+TableInterp_getBlock(int interp, int format)
+{
+    static TableInterpBlockFunc funcs[4][4] = {
+        {nointerp_block_native, linear_block_native, cosine_block_native, cubic_block_native},
+        {nointerp_block_float32, linear_block_float32, cosine_block_float32, cubic_block_float32},
+        {nointerp_block_int16, linear_block_int16, cosine_block_int16, cubic_block_int16},
+        {nointerp_block_paged, linear_block_paged, cosine_block_paged, cubic_block_paged}
+    };
+
+    if (interp < 1 || interp > 4)
+        interp = 2;
+    if (format < TABLE_NATIVE || format > TABLE_PAGED)
+        format = TABLE_NATIVE;
+    return funcs[format][interp - 1];
+}
@@ -0,0 +1,160 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "midiring.h"
+#include "streammodule.h"
+
+/* Events read from a device at once. */
+#define MIDIRING_READ 64
+
+MidiRing *
+MidiRing_new(int size)
+{
+    MidiRing *self = (MidiRing *)calloc(1, sizeof(MidiRing));
+
+    self->size = 1;
+    while (self->size < size)
+        self->size <<= 1;
+    self->events = (MidiRingEvent *)malloc(self->size * sizeof(MidiRingEvent));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    return self;
+}
+
+void
+MidiRing_free(MidiRing *self)
+{
+    if (self == NULL)
+        return;
+    MidiRing_stop(self);
+    pthread_cond_destroy(&self->cond);
+    pthread_mutex_destroy(&self->mutex);
+    free(self->events);
+    free(self);
+}
+
+int
+MidiRing_push(MidiRing *self, PmMessage message, unsigned long long time)
+{
+    unsigned long written = self->written;
+    MidiRingEvent *ev;
+
+    if (written - self->read >= (unsigned long)self->size) {
+        self->dropped++;
+        return -1;
+    }
+    ev = &self->events[written & (self->size - 1)];
+    ev->message = message;
+    ev->time = time;
+    /* The event must be visible before the new count. */
+    __sync_synchronize();
+    self->written = written + 1;
+    return 0;
+}
+
+int
+MidiRing_pop(MidiRing *self, MidiRingEvent *out, int num)
+{
+    int i, count;
+    unsigned long read = self->read;
+
+    count = (int)(self->written - read);
+    if (count > num)
+        count = num;
+    /* The events are read after the count they were published with. */
+    __sync_synchronize();
+    for (i=0; i<count; i++) {
+        out[i] = self->events[(read + i) & (self->size - 1)];
+    }
+    /* And before the producer may overwrite them. */
+    __sync_synchronize();
+    self->read = read + count;
+    return count;
+}
+
+static void *
+MidiRing_run(void *arg)
+{
+    MidiRing *self = (MidiRing *)arg;
+    PmEvent buffer[MIDIRING_READ];
+    unsigned long long now;
+    int i, j, n;
+    struct timeval tv;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&self->mutex);
+    while (self->running) {
+        pthread_mutex_unlock(&self->mutex);
+        for (i=0; i<self->numinputs; i++) {
+            while (Pm_Poll(self->inputs[i]) == pmGotData) {
+                n = Pm_Read(self->inputs[i], buffer, MIDIRING_READ);
+                if (n <= 0)
+                    break;
+                now = Stream_clock();
+                for (j=0; j<n; j++) {
+                    MidiRing_push(self, buffer[j].message, now);
+                }
+            }
+        }
+        pthread_mutex_lock(&self->mutex);
+        if (!self->running)
+            break;
+        gettimeofday(&tv, NULL);
+        timeout.tv_sec = tv.tv_sec;
+        timeout.tv_nsec = tv.tv_usec * 1000 + 1000000;
+        if (timeout.tv_nsec >= 1000000000) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&self->cond, &self->mutex, &timeout);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+int
+MidiRing_start(MidiRing *self, PmStream **inputs, int num)
+{
+    MidiRing_stop(self);
+    self->inputs = inputs;
+    self->numinputs = num;
+    self->running = 1;
+    if (pthread_create(&self->thread, NULL, MidiRing_run, (void *)self) != 0) {
+        self->running = 0;
+        return -1;
+    }
+    return 0;
+}
+
+void
+MidiRing_stop(MidiRing *self)
+{
+    if (!self->running)
+        return;
+    pthread_mutex_lock(&self->mutex);
+    self->running = 0;
+    pthread_cond_signal(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+    pthread_join(self->thread, NULL);
+}
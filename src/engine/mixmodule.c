@@ -143,6 +143,7 @@ Mix_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Mix_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = Mix_setProcMode;
 
     static char *kwlist[] = {"input", "mul", "add", NULL};
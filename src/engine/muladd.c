@@ -0,0 +1,373 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include "pyomodule.h"
+#include <stdlib.h>
+#include <string.h>
+#include "simd.h"
+
+/* The scalar loops clamp divisors with `tmp < 0.00001 && tmp > -0.00001`,
+ * compared in double precision. DIV_LIMIT is the largest MYFLT that passes
+ * the test, so that vector lanes can use the same inclusive comparisons in
+ * both precisions. */
+#define DIV_GUARD 0.00001
+#define DIV_CLAMP(x) ((x) < DIV_GUARD && (x) > -DIV_GUARD ? (MYFLT)DIV_GUARD : (x))
+
+#ifdef VSIZE
+static MYFLT
+div_limit(void)
+{
+#ifdef USE_DOUBLE
+    return nextafter(DIV_GUARD, 0.0);
+#else
+    MYFLT lim = (MYFLT)DIV_GUARD;
+    if ((double)lim >= DIV_GUARD)
+        lim = nextafterf(lim, 0.0f);
+    return lim;
+#endif
+}
+#endif
+
+void
+pyo_muladd_ii(MYFLT *data, MYFLT mul, MYFLT add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE vmul = VSET1(mul), vadd = VSET1(add);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VMUL(VLOAD(data+i), vmul), vadd));
+#endif
+    for (; i<size; i++)
+        data[i] = mul * data[i] + add;
+}
+
+void
+pyo_muladd_ai(MYFLT *data, MYFLT *mul, MYFLT add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE vadd = VSET1(add);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VMUL(VLOAD(mul+i), VLOAD(data+i)), vadd));
+#endif
+    for (; i<size; i++)
+        data[i] = mul[i] * data[i] + add;
+}
+
+void
+pyo_muladd_ia(MYFLT *data, MYFLT mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE vmul = VSET1(mul);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VMUL(VLOAD(data+i), vmul), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = mul * data[i] + add[i];
+}
+
+void
+pyo_muladd_aa(MYFLT *data, MYFLT *mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VMUL(VLOAD(mul+i), VLOAD(data+i)), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = mul[i] * data[i] + add[i];
+}
+
+void
+pyo_muladd_revai(MYFLT *data, MYFLT *mul, MYFLT add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    MYFLT lim = div_limit();
+    VTYPE vadd = VSET1(add), hi = VSET1(lim), lo = VSET1(-lim), val = VSET1((MYFLT)DIV_GUARD);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VDIV(VLOAD(data+i), VCLAMP(VLOAD(mul+i), lo, hi, val)), vadd));
+#endif
+    for (; i<size; i++)
+        data[i] = data[i] / DIV_CLAMP(mul[i]) + add;
+}
+
+void
+pyo_muladd_revaa(MYFLT *data, MYFLT *mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    MYFLT lim = div_limit();
+    VTYPE hi = VSET1(lim), lo = VSET1(-lim), val = VSET1((MYFLT)DIV_GUARD);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VADD(VDIV(VLOAD(data+i), VCLAMP(VLOAD(mul+i), lo, hi, val)), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = data[i] / DIV_CLAMP(mul[i]) + add[i];
+}
+
+void
+pyo_muladd_ireva(MYFLT *data, MYFLT mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE vmul = VSET1(mul);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VSUB(VMUL(VLOAD(data+i), vmul), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = mul * data[i] - add[i];
+}
+
+void
+pyo_muladd_areva(MYFLT *data, MYFLT *mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VSUB(VMUL(VLOAD(mul+i), VLOAD(data+i)), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = mul[i] * data[i] - add[i];
+}
+
+void
+pyo_muladd_revareva(MYFLT *data, MYFLT *mul, MYFLT *add, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    MYFLT lim = div_limit();
+    VTYPE hi = VSET1(lim), lo = VSET1(-lim), val = VSET1((MYFLT)DIV_GUARD);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, VSUB(VDIV(VLOAD(data+i), VCLAMP(VLOAD(mul+i), lo, hi, val)), VLOAD(add+i)));
+#endif
+    for (; i<size; i++)
+        data[i] = data[i] / DIV_CLAMP(mul[i]) - add[i];
+}
+
+void
+pyo_postprocessing_fused(void *self)
+{
+}
+
+void
+pyo_accumulate(MYFLT *out, MYFLT *in, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(out+i, VADD(VLOAD(out+i), VLOAD(in+i)));
+#endif
+    for (; i<size; i++)
+        out[i] += in[i];
+}
+
+void
+pyo_accumulate_gain(MYFLT *out, MYFLT *in, MYFLT gain, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE vgain = VSET1(gain);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(out+i, VADD(VLOAD(out+i), VMUL(VLOAD(in+i), vgain)));
+#endif
+    for (; i<size; i++)
+        out[i] += in[i] * gain;
+}
+
+void
+pyo_fill_ramp(MYFLT *data, MYFLT from, MYFLT to, int size)
+{
+    int i;
+    MYFLT step = (to - from) / size;
+
+    for (i=0; i<size-1; i++)
+        data[i] = from + step * (MYFLT)(i + 1);
+    data[size-1] = to;
+}
+
+void
+pyo_fill(MYFLT *data, MYFLT value, int size)
+{
+    int i = 0;
+#ifdef VSIZE
+    VTYPE v = VSET1(value);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(data+i, v);
+#endif
+    for (; i<size; i++)
+        data[i] = value;
+}
+
+void
+pyo_gain_to_float(float *out, MYFLT *in, MYFLT *gain, int size)
+{
+    int i = 0;
+#if !defined(USE_DOUBLE) && defined(VSIZE)
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(out+i, VMUL(VLOAD(in+i), VLOAD(gain+i)));
+#elif defined(USE_DOUBLE) && defined(__SSE2__)
+    /* the sample is rounded to float before the gain, as in the scalar loop */
+    for (; i<=size-2; i+=2) {
+        __m128d x = _mm_cvtps_pd(_mm_cvtpd_ps(_mm_loadu_pd(in+i)));
+        _mm_storel_pi((__m64 *)(out+i), _mm_cvtpd_ps(_mm_mul_pd(x, _mm_loadu_pd(gain+i))));
+    }
+#endif
+    for (; i<size; i++)
+        out[i] = (float)in[i] * gain[i];
+}
+
+void
+pyo_interleave_gain(float *out, MYFLT *in, int stride, MYFLT *gain, int nchnls, int size)
+{
+    int i, j;
+    MYFLT *chnl;
+    float *outchnl;
+
+    i = 0;
+    if (nchnls == 2) {
+#if !defined(USE_DOUBLE) && defined(__SSE__)
+        for (; i<=size-4; i+=4) {
+            __m128 g = _mm_loadu_ps(gain+i);
+            __m128 l = _mm_mul_ps(_mm_loadu_ps(in+i), g);
+            __m128 r = _mm_mul_ps(_mm_loadu_ps(in+stride+i), g);
+            _mm_storeu_ps(out+2*i, _mm_unpacklo_ps(l, r));
+            _mm_storeu_ps(out+2*i+4, _mm_unpackhi_ps(l, r));
+        }
+#elif !defined(USE_DOUBLE) && defined(__aarch64__)
+        for (; i<=size-4; i+=4) {
+            float32x4_t g = vld1q_f32(gain+i);
+            float32x4x2_t lr;
+            lr.val[0] = vmulq_f32(vld1q_f32(in+i), g);
+            lr.val[1] = vmulq_f32(vld1q_f32(in+stride+i), g);
+            vst2q_f32(out+2*i, lr);
+        }
+#endif
+        for (; i<size; i++) {
+            out[2*i] = (float)in[i] * gain[i];
+            out[2*i+1] = (float)in[stride+i] * gain[i];
+        }
+        return;
+    }
+    for (j=0; j<nchnls; j++) {
+        chnl = in + j * stride;
+        outchnl = out + j;
+        for (i=0; i<size; i++) {
+            outchnl[i*nchnls] = (float)chnl[i] * gain[i];
+        }
+    }
+}
+
+void
+pyo_deinterleave(MYFLT *out, int stride, MYFLT *in, int nchnls, int size)
+{
+    int i, j;
+    MYFLT *chnl;
+
+    i = 0;
+    if (nchnls == 2) {
+#if !defined(USE_DOUBLE) && defined(__SSE__)
+        for (; i<=size-4; i+=4) {
+            __m128 a = _mm_loadu_ps(in+2*i);
+            __m128 b = _mm_loadu_ps(in+2*i+4);
+            _mm_storeu_ps(out+i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(out+stride+i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+        }
+#elif !defined(USE_DOUBLE) && defined(__aarch64__)
+        for (; i<=size-4; i+=4) {
+            float32x4x2_t lr = vld2q_f32(in+2*i);
+            vst1q_f32(out+i, lr.val[0]);
+            vst1q_f32(out+stride+i, lr.val[1]);
+        }
+#endif
+        for (; i<size; i++) {
+            out[i] = in[2*i];
+            out[stride+i] = in[2*i+1];
+        }
+        return;
+    }
+    for (j=0; j<nchnls; j++) {
+        chnl = out + j * stride;
+        for (i=0; i<size; i++) {
+            chnl[i] = in[i*nchnls+j];
+        }
+    }
+}
+
+void
+pyo_peak_power(MYFLT *in, MYFLT *gain, int size, MYFLT *peak, MYFLT *sum)
+{
+    int i = 0;
+    MYFLT x, pk = 0.0, sm = 0.0;
+#ifdef VSIZE
+    int k;
+    MYFLT lanes[VSIZE];
+    VTYPE v, vpk = VSET1(0.0), vsm = VSET1(0.0);
+    for (; i<=size-VSIZE; i+=VSIZE) {
+        v = VMUL(VLOAD(in+i), VLOAD(gain+i));
+        v = VMUL(v, v);
+        vpk = VMAX(vpk, v);
+        vsm = VADD(vsm, v);
+    }
+    VSTORE(lanes, vpk);
+    for (k=0; k<VSIZE; k++) {
+        if (lanes[k] > pk)
+            pk = lanes[k];
+    }
+    VSTORE(lanes, vsm);
+    for (k=0; k<VSIZE; k++)
+        sm += lanes[k];
+#endif
+    for (; i<size; i++) {
+        x = in[i] * gain[i];
+        x *= x;
+        if (x > pk)
+            pk = x;
+        sm += x;
+    }
+    *peak = pk;
+    *sum = sm;
+}
+
+void *
+pyo_aligned_calloc(size_t size)
+{
+    void *ptr;
+#ifdef _WIN32
+    ptr = _aligned_malloc(size, PYO_ALIGNMENT);
+#else
+    if (posix_memalign(&ptr, PYO_ALIGNMENT, size) != 0)
+        ptr = NULL;
+#endif
+    if (ptr != NULL)
+        memset(ptr, 0, size);
+    return ptr;
+}
+
+void
+pyo_aligned_free(void *ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
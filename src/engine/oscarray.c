@@ -0,0 +1,381 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "oscarray.h"
+
+#define OSCARRAY_FIELDS 10
+#define OSCARRAY_CHUNK 64
+
+OscArray *
+OscArray_new(int num)
+{
+    OscArray *self = (OscArray *)calloc(1, sizeof(OscArray));
+    OscArray_resize(self, num);
+    return self;
+}
+
+void
+OscArray_free(OscArray *self)
+{
+    if (self == NULL)
+        return;
+    pyo_aligned_free(self->block);
+    free(self);
+}
+
+size_t
+OscArray_getMemory(OscArray *self)
+{
+    return (size_t)OSCARRAY_FIELDS * self->capacity * sizeof(MYFLT);
+}
+
+void
+OscArray_resize(OscArray *self, int num)
+{
+    int i, keep, capacity;
+    MYFLT *block, *old[OSCARRAY_FIELDS], **fields[OSCARRAY_FIELDS];
+
+    if (num < 0)
+        num = 0;
+    capacity = (num + OSCARRAY_LANES - 1) / OSCARRAY_LANES * OSCARRAY_LANES;
+    if (capacity == 0)
+        capacity = OSCARRAY_LANES;
+
+    fields[0] = &self->pos; fields[1] = &self->inc; fields[2] = &self->dinc;
+    fields[3] = &self->amp; fields[4] = &self->damp; fields[5] = &self->re;
+    fields[6] = &self->im; fields[7] = &self->rc; fields[8] = &self->rs;
+    fields[9] = &self->rinc;
+
+    if (capacity != self->capacity) {
+        block = (MYFLT *)pyo_aligned_calloc(OSCARRAY_FIELDS * capacity * sizeof(MYFLT));
+        keep = num < self->num ? num : self->num;
+        for (i=0; i<OSCARRAY_FIELDS; i++) {
+            old[i] = *fields[i];
+            *fields[i] = block + i * capacity;
+            if (keep > 0)
+                memcpy(*fields[i], old[i], keep * sizeof(MYFLT));
+        }
+        pyo_aligned_free(self->block);
+        self->block = block;
+        self->capacity = capacity;
+    }
+    /* New oscillators start at phase 0, silent. */
+    for (i=self->num; i<num; i++) {
+        self->pos[i] = self->inc[i] = self->dinc[i] = self->amp[i] = self->damp[i] = 0.0;
+        self->re[i] = 1.0;
+        self->im[i] = self->rs[i] = 0.0;
+        self->rc[i] = 1.0;
+        self->rinc[i] = 0.0;
+    }
+    self->num = num;
+}
+
+void
+OscArray_resetPhases(OscArray *self)
+{
+    int i;
+    for (i=0; i<self->num; i++) {
+        self->pos[i] = self->im[i] = 0.0;
+        self->re[i] = 1.0;
+    }
+}
+
+void
+OscArray_setQuadrature(OscArray *self, int quadrature, int size)
+{
+    int i;
+    MYFLT ph, scl = TWOPI / size;
+
+    quadrature = quadrature != 0;
+    if (quadrature == self->quadrature)
+        return;
+
+    for (i=0; i<self->num; i++) {
+        if (quadrature) {
+            ph = self->pos[i] * scl;
+            self->re[i] = MYCOS(ph);
+            self->im[i] = MYSIN(ph);
+            self->rinc[i] = self->inc[i] + 1.0; /* forces the computation of the rotation */
+        }
+        else {
+            ph = MYATAN2(self->im[i], self->re[i]) / scl;
+            if (ph < 0.0)
+                ph += size;
+            self->pos[i] = ph < size ? ph : 0.0;
+        }
+    }
+    self->quadrature = quadrature;
+}
+
+/* Table kernels: OSCARRAY_LANES oscillators, of which the first `valid`
+ * are used (the others are silent and stay at phase 0), accumulated lane by
+ * lane in `acc` (`len` samples of OSCARRAY_LANES values). */
+typedef void (*oscarray_table_func)(MYFLT *pos, MYFLT *inc, MYFLT *dinc, MYFLT *amp, MYFLT *damp,
+                                    int valid, MYFLT *acc, int len, MYFLT *table, int size);
+
+/* Without gathers, one oscillator at a time keeps its state in registers. */
+static void
+oscarray_table_scalar(MYFLT *pos, MYFLT *inc, MYFLT *dinc, MYFLT *amp, MYFLT *damp,
+                      int valid, MYFLT *acc, int len, MYFLT *table, int size) {
+    int l, n, ipart;
+    MYFLT p, i, di, a, da, fpart, x, fsize = (MYFLT)size;
+
+    for (l=0; l<valid; l++) {
+        p = pos[l]; i = inc[l]; di = dinc[l]; a = amp[l]; da = damp[l];
+        for (n=0; n<len; n++) {
+            ipart = (int)p;
+            fpart = p - ipart;
+            x = table[ipart];
+            acc[n * OSCARRAY_LANES + l] += a * (x + (table[ipart+1] - x) * fpart);
+            a += da;
+            i += di;
+            p += i;
+            while (p >= fsize) p -= fsize;
+            while (p < 0.0) p += fsize;
+        }
+        pos[l] = p; inc[l] = i; amp[l] = a;
+    }
+}
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && (defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#include <immintrin.h>
+#define OSCARRAY_AVX2_TARGET
+/* The interpolated reads use the gathers of AVX2. */
+#ifndef USE_DOUBLE
+__attribute__((target("avx2")))
+static void
+oscarray_table_avx2(MYFLT *pos, MYFLT *inc, MYFLT *dinc, MYFLT *amp, MYFLT *damp,
+                    int valid, MYFLT *acc, int len, MYFLT *table, int size) {
+    int h, n;
+    __m256i ip;
+    __m256 p, i, di, a, da, x, y, fr, vsize = _mm256_set1_ps((float)size), vinv = _mm256_set1_ps(1.0f / size);
+
+    for (h=0; h<OSCARRAY_LANES; h+=8) {
+        p = _mm256_loadu_ps(pos+h); i = _mm256_loadu_ps(inc+h); di = _mm256_loadu_ps(dinc+h);
+        a = _mm256_loadu_ps(amp+h); da = _mm256_loadu_ps(damp+h);
+        for (n=0; n<len; n++) {
+            ip = _mm256_cvttps_epi32(p);
+            fr = _mm256_sub_ps(p, _mm256_cvtepi32_ps(ip));
+            x = _mm256_i32gather_ps(table, ip, 4);
+            y = _mm256_i32gather_ps(table + 1, ip, 4);
+            x = _mm256_mul_ps(a, _mm256_add_ps(x, _mm256_mul_ps(_mm256_sub_ps(y, x), fr)));
+            _mm256_storeu_ps(acc + n * OSCARRAY_LANES + h, _mm256_add_ps(_mm256_loadu_ps(acc + n * OSCARRAY_LANES + h), x));
+            a = _mm256_add_ps(a, da);
+            i = _mm256_add_ps(i, di);
+            p = _mm256_add_ps(p, i);
+            p = _mm256_sub_ps(p, _mm256_mul_ps(_mm256_floor_ps(_mm256_mul_ps(p, vinv)), vsize));
+            p = _mm256_and_ps(p, _mm256_cmp_ps(p, vsize, _CMP_LT_OQ));
+        }
+        _mm256_storeu_ps(pos+h, p); _mm256_storeu_ps(inc+h, i); _mm256_storeu_ps(amp+h, a);
+    }
+}
+#else
+__attribute__((target("avx2")))
+static void
+oscarray_table_avx2(MYFLT *pos, MYFLT *inc, MYFLT *dinc, MYFLT *amp, MYFLT *damp,
+                    int valid, MYFLT *acc, int len, MYFLT *table, int size) {
+    int h, n;
+    __m128i ip;
+    __m256d p, i, di, a, da, x, y, fr, vsize = _mm256_set1_pd((double)size), vinv = _mm256_set1_pd(1.0 / size);
+
+    for (h=0; h<OSCARRAY_LANES; h+=4) {
+        p = _mm256_loadu_pd(pos+h); i = _mm256_loadu_pd(inc+h); di = _mm256_loadu_pd(dinc+h);
+        a = _mm256_loadu_pd(amp+h); da = _mm256_loadu_pd(damp+h);
+        for (n=0; n<len; n++) {
+            ip = _mm256_cvttpd_epi32(p);
+            fr = _mm256_sub_pd(p, _mm256_cvtepi32_pd(ip));
+            x = _mm256_i32gather_pd(table, ip, 8);
+            y = _mm256_i32gather_pd(table + 1, ip, 8);
+            x = _mm256_mul_pd(a, _mm256_add_pd(x, _mm256_mul_pd(_mm256_sub_pd(y, x), fr)));
+            _mm256_storeu_pd(acc + n * OSCARRAY_LANES + h, _mm256_add_pd(_mm256_loadu_pd(acc + n * OSCARRAY_LANES + h), x));
+            a = _mm256_add_pd(a, da);
+            i = _mm256_add_pd(i, di);
+            p = _mm256_add_pd(p, i);
+            p = _mm256_sub_pd(p, _mm256_mul_pd(_mm256_floor_pd(_mm256_mul_pd(p, vinv)), vsize));
+            p = _mm256_and_pd(p, _mm256_cmp_pd(p, vsize, _CMP_LT_OQ));
+        }
+        _mm256_storeu_pd(pos+h, p); _mm256_storeu_pd(inc+h, i); _mm256_storeu_pd(amp+h, a);
+    }
+}
+#endif
+#endif
+
+static oscarray_table_func oscarray_table_kernel = NULL;
+
+static void
+oscarray_select_kernels(void) {
+    oscarray_table_func table = oscarray_table_scalar;
+#ifdef OSCARRAY_AVX2_TARGET
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        table = oscarray_table_avx2;
+#endif
+    oscarray_table_kernel = table;
+}
+
+static void
+OscArray_table_lanes(OscArray *self, int first, int valid, MYFLT *acc, int len, MYFLT *table, int size)
+{
+    int l;
+    MYFLT pos[OSCARRAY_LANES], inc[OSCARRAY_LANES], dinc[OSCARRAY_LANES];
+    MYFLT amp[OSCARRAY_LANES], damp[OSCARRAY_LANES];
+    MYFLT fsize = (MYFLT)size;
+
+    for (l=0; l<OSCARRAY_LANES; l++) {
+        if (l < valid) {
+            /* The table may have been shortened since the last call. */
+            pos[l] = self->pos[first+l];
+            if (pos[l] < 0.0 || pos[l] >= fsize)
+                pos[l] -= MYFLOOR(pos[l] / fsize) * fsize;
+            if (pos[l] >= fsize || pos[l] < 0.0)
+                pos[l] = 0.0;
+            inc[l] = self->inc[first+l];
+            dinc[l] = self->dinc[first+l];
+            amp[l] = self->amp[first+l];
+            damp[l] = self->damp[first+l];
+        }
+        else
+            pos[l] = inc[l] = dinc[l] = amp[l] = damp[l] = 0.0;
+    }
+
+    (*oscarray_table_kernel)(pos, inc, dinc, amp, damp, valid, acc, len, table, size);
+
+    for (l=0; l<valid; l++) {
+        self->pos[first+l] = pos[l];
+        self->inc[first+l] = inc[l];
+        self->amp[first+l] = amp[l];
+    }
+}
+
+static void
+OscArray_quadrature_lanes(OscArray *self, int first, int valid, MYFLT *acc, int len, int size)
+{
+    int l, n, chirp = 0;
+    MYFLT re[OSCARRAY_LANES], im[OSCARRAY_LANES], rc[OSCARRAY_LANES], rs[OSCARRAY_LANES];
+    MYFLT dc[OSCARRAY_LANES], ds[OSCARRAY_LANES], amp[OSCARRAY_LANES], damp[OSCARRAY_LANES];
+    MYFLT tr, ti, g, scl = TWOPI / size;
+    MYFLT *a;
+
+    for (l=0; l<OSCARRAY_LANES; l++) {
+        if (l < valid) {
+            n = first + l;
+            if (self->dinc[n] != 0.0 || self->inc[n] != self->rinc[n]) {
+                self->rc[n] = MYCOS(self->inc[n] * scl);
+                self->rs[n] = MYSIN(self->inc[n] * scl);
+                self->rinc[n] = self->inc[n];
+            }
+            if (self->dinc[n] != 0.0) {
+                dc[l] = MYCOS(self->dinc[n] * scl);
+                ds[l] = MYSIN(self->dinc[n] * scl);
+                chirp = 1;
+            }
+            else {
+                dc[l] = 1.0;
+                ds[l] = 0.0;
+            }
+            /* Keeps the phasor on the unit circle. */
+            g = (MYFLT)1.5 - (self->re[n] * self->re[n] + self->im[n] * self->im[n]) * (MYFLT)0.5;
+            re[l] = self->re[n] * g;
+            im[l] = self->im[n] * g;
+            rc[l] = self->rc[n];
+            rs[l] = self->rs[n];
+            amp[l] = self->amp[n];
+            damp[l] = self->damp[n];
+        }
+        else {
+            re[l] = rc[l] = dc[l] = 1.0;
+            im[l] = rs[l] = ds[l] = amp[l] = damp[l] = 0.0;
+        }
+    }
+
+    for (n=0; n<len; n++) {
+        a = acc + n * OSCARRAY_LANES;
+        for (l=0; l<OSCARRAY_LANES; l++) {
+            a[l] += amp[l] * im[l];
+            amp[l] += damp[l];
+        }
+        if (chirp) {
+            for (l=0; l<OSCARRAY_LANES; l++) {
+                tr = rc[l] * dc[l] - rs[l] * ds[l];
+                ti = rc[l] * ds[l] + rs[l] * dc[l];
+                rc[l] = tr;
+                rs[l] = ti;
+            }
+        }
+        for (l=0; l<OSCARRAY_LANES; l++) {
+            tr = re[l] * rc[l] - im[l] * rs[l];
+            ti = re[l] * rs[l] + im[l] * rc[l];
+            re[l] = tr;
+            im[l] = ti;
+        }
+    }
+
+    for (l=0; l<valid; l++) {
+        n = first + l;
+        self->re[n] = re[l];
+        self->im[n] = im[l];
+        self->amp[n] = amp[l];
+        if (self->dinc[n] != 0.0) {
+            self->inc[n] += self->dinc[n] * len;
+            self->rc[n] = rc[l];
+            self->rs[n] = rs[l];
+            self->rinc[n] = self->inc[n];
+        }
+    }
+}
+
+void
+OscArray_process(OscArray *self, MYFLT *out, int count, int num, MYFLT *table, int size)
+{
+    int j, l, n, start, len;
+    MYFLT sum;
+    MYFLT acc[OSCARRAY_CHUNK * OSCARRAY_LANES];
+
+    if (num > self->num)
+        num = self->num;
+    if (num <= 0 || size <= 0)
+        return;
+    if (oscarray_table_kernel == NULL)
+        oscarray_select_kernels();
+
+    for (start=0; start<count; start+=OSCARRAY_CHUNK) {
+        len = count - start;
+        if (len > OSCARRAY_CHUNK)
+            len = OSCARRAY_CHUNK;
+        memset(acc, 0, len * OSCARRAY_LANES * sizeof(MYFLT));
+        for (j=0; j<num; j+=OSCARRAY_LANES) {
+            l = num - j < OSCARRAY_LANES ? num - j : OSCARRAY_LANES;
+            if (self->quadrature)
+                OscArray_quadrature_lanes(self, j, l, acc, len, size);
+            else
+                OscArray_table_lanes(self, j, l, acc, len, table, size);
+        }
+        for (n=0; n<len; n++) {
+            sum = 0.0;
+            for (l=0; l<OSCARRAY_LANES; l++)
+                sum += acc[n * OSCARRAY_LANES + l];
+            out[start+n] += sum;
+        }
+    }
+}
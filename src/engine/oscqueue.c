@@ -0,0 +1,267 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "oscqueue.h"
+#include "streammodule.h"
+
+/* Longest wait on the socket, in milliseconds, bounding the time to stop. */
+#define OSCQUEUE_WAIT 10
+/* Wait for the audio thread when the ring is full, in microseconds. */
+#define OSCQUEUE_FULL_WAIT 1000
+
+static void
+OscQueue_error(int num, const char *msg, const char *path)
+{
+    printf("liblo server error %d in path %s: %s\n", num, path, msg);
+}
+
+/* Copies a message in the ring, on the network thread. */
+static int
+OscQueue_handler(const char *path, const char *types, lo_arg **argv, int argc,
+                 lo_message msg, void *user_data)
+{
+    OscQueue *self = (OscQueue *)user_data;
+    unsigned long written = self->written;
+    OscQueueEvent *ev;
+    lo_timetag tt, now;
+    double delay;
+    int i, ok;
+
+    /* The audio thread drains the ring every block, the socket holds the
+     * next messages meanwhile. */
+    while (written - self->read >= (unsigned long)self->size) {
+        if (!self->running) {
+            self->dropped++;
+            return 0;
+        }
+        usleep(OSCQUEUE_FULL_WAIT);
+    }
+
+    ev = &self->events[written & (self->size - 1)];
+    OscQueue_setPath(ev, path);
+    for (i=0; i<argc; i++) {
+        switch (types[i]) {
+            case LO_INT32:
+                ok = OscQueue_addInt(ev, types[i], argv[i]->i);
+                break;
+            case LO_INT64:
+                ok = OscQueue_addInt(ev, types[i], argv[i]->h);
+                break;
+            case LO_FLOAT:
+                ok = OscQueue_addDouble(ev, types[i], argv[i]->f);
+                break;
+            case LO_DOUBLE:
+                ok = OscQueue_addDouble(ev, types[i], argv[i]->d);
+                break;
+            case LO_STRING:
+            case LO_SYMBOL:
+                ok = OscQueue_addString(ev, types[i], &argv[i]->s);
+                break;
+            default:
+                ok = OscQueue_addInt(ev, types[i], 0);
+                break;
+        }
+        if (ok < 0)
+            break;
+    }
+
+    /* Messages of a bundle are due at its timetag, even when liblo
+     * dispatches them a bit late, the others now. */
+    ev->time = Stream_clock();
+    tt = lo_message_get_timestamp(msg);
+    if (tt.sec != 0 || tt.frac > 1) {
+        lo_timetag_now(&now);
+        delay = lo_timetag_diff(tt, now) * 1e9;
+        if (delay > 0.0)
+            ev->time += (unsigned long long)delay;
+        else if (-delay < ev->time)
+            ev->time -= (unsigned long long)-delay;
+    }
+
+    /* The message must be visible before the new count. */
+    __sync_synchronize();
+    self->written = written + 1;
+    return 0;
+}
+
+static void *
+OscQueue_run(void *arg)
+{
+    OscQueue *self = (OscQueue *)arg;
+
+    while (self->running) {
+        lo_server_recv_noblock(self->osc_server, OSCQUEUE_WAIT);
+    }
+    return NULL;
+}
+
+OscQueue *
+OscQueue_new(int port, int size)
+{
+    char buf[20];
+    OscQueue *self = (OscQueue *)calloc(1, sizeof(OscQueue));
+
+    sprintf(buf, "%i", port);
+    self->osc_server = lo_server_new(buf, OscQueue_error);
+    if (self->osc_server == NULL) {
+        free(self);
+        return NULL;
+    }
+    lo_server_add_method(self->osc_server, NULL, NULL, OscQueue_handler, self);
+
+    self->port = port;
+    self->size = 1;
+    while (self->size < size)
+        self->size <<= 1;
+    self->events = (OscQueueEvent *)malloc(self->size * sizeof(OscQueueEvent));
+
+    self->running = 1;
+    if (pthread_create(&self->thread, NULL, OscQueue_run, (void *)self) != 0) {
+        printf("OSC warning: could not start the network thread of port %d.\n", port);
+        lo_server_free(self->osc_server);
+        free(self->events);
+        free(self);
+        return NULL;
+    }
+    return self;
+}
+
+void
+OscQueue_free(OscQueue *self)
+{
+    if (self == NULL)
+        return;
+    self->running = 0;
+    pthread_join(self->thread, NULL);
+    lo_server_free(self->osc_server);
+    free(self->events);
+    free(self);
+}
+
+int
+OscQueue_count(OscQueue *self)
+{
+    int count = (int)(self->written - self->read);
+
+    /* The messages are read after the count they were published with. */
+    __sync_synchronize();
+    return count;
+}
+
+OscQueueEvent *
+OscQueue_get(OscQueue *self, int i)
+{
+    return &self->events[(self->read + i) & (self->size - 1)];
+}
+
+void
+OscQueue_release(OscQueue *self, int num)
+{
+    if (num <= 0)
+        return;
+    /* The messages are read before the producer may overwrite them. */
+    __sync_synchronize();
+    self->read += num;
+}
+
+void
+OscQueue_setPath(OscQueueEvent *ev, const char *path)
+{
+    strncpy(ev->path, path, OSC_QUEUE_PATH - 1);
+    ev->path[OSC_QUEUE_PATH - 1] = '\0';
+    ev->argc = 0;
+    ev->types[0] = '\0';
+    ev->textlen = 0;
+}
+
+int
+OscQueue_addInt(OscQueueEvent *ev, char type, long long value)
+{
+    if (ev->argc == OSC_QUEUE_ARGS)
+        return -1;
+    ev->values[ev->argc].h = value;
+    ev->types[ev->argc++] = type;
+    ev->types[ev->argc] = '\0';
+    return 0;
+}
+
+int
+OscQueue_addDouble(OscQueueEvent *ev, char type, double value)
+{
+    if (ev->argc == OSC_QUEUE_ARGS)
+        return -1;
+    ev->values[ev->argc].d = value;
+    ev->types[ev->argc++] = type;
+    ev->types[ev->argc] = '\0';
+    return 0;
+}
+
+int
+OscQueue_addString(OscQueueEvent *ev, char type, const char *value)
+{
+    int len = strlen(value) + 1;
+
+    if (ev->argc == OSC_QUEUE_ARGS || len > OSC_QUEUE_TEXT - ev->textlen)
+        return -1;
+    memcpy(ev->text + ev->textlen, value, len);
+    ev->values[ev->argc].s = ev->textlen;
+    ev->textlen += len;
+    ev->types[ev->argc++] = type;
+    ev->types[ev->argc] = '\0';
+    return 0;
+}
+
+int
+OscQueue_isNumber(OscQueueEvent *ev, int i)
+{
+    if (i >= ev->argc)
+        return 0;
+    switch (ev->types[i]) {
+        case LO_INT32:
+        case LO_INT64:
+        case LO_FLOAT:
+        case LO_DOUBLE:
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+double
+OscQueue_number(OscQueueEvent *ev, int i)
+{
+    if (i >= ev->argc)
+        return 0.0;
+    switch (ev->types[i]) {
+        case LO_INT32:
+        case LO_INT64:
+            return (double)ev->values[i].h;
+        case LO_FLOAT:
+        case LO_DOUBLE:
+            return ev->values[i].d;
+        default:
+            return 0.0;
+    }
+}
@@ -0,0 +1,311 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/time.h>
+#include "oscsender.h"
+#include "streammodule.h"
+
+/* Wait of the network thread between two looks at the ring, in nanoseconds. */
+#define OSCSENDER_WAIT 1000000
+
+static lo_message
+OscSender_message(OscQueueEvent *ev)
+{
+    int i;
+    lo_message msg = lo_message_new();
+
+    for (i=0; i<ev->argc; i++) {
+        switch (ev->types[i]) {
+            case LO_INT32:
+                lo_message_add_int32(msg, (int32_t)ev->values[i].h);
+                break;
+            case LO_INT64:
+                lo_message_add_int64(msg, (int64_t)ev->values[i].h);
+                break;
+            case LO_FLOAT:
+                lo_message_add_float(msg, (float)ev->values[i].d);
+                break;
+            case LO_DOUBLE:
+                lo_message_add_double(msg, ev->values[i].d);
+                break;
+            case LO_STRING:
+                lo_message_add_string(msg, ev->text + ev->values[i].s);
+                break;
+            default:
+                break;
+        }
+    }
+    return msg;
+}
+
+/* Sends `num` messages to `dest`, a single message goes out of a bundle. */
+static void
+OscSender_send(OscSenderDestination *dest, OscQueueEvent **msgs, int num)
+{
+    int i, j, n, err = 0;
+    lo_message msg;
+    lo_bundle bundle;
+
+    if (num == 1) {
+        msg = OscSender_message(msgs[0]);
+        err = lo_send_message(dest->address, msgs[0]->path, msg);
+        lo_message_free(msg);
+    }
+    else {
+        for (i=0; i<num; i+=OSC_SENDER_BUNDLE) {
+            n = num - i < OSC_SENDER_BUNDLE ? num - i : OSC_SENDER_BUNDLE;
+            bundle = lo_bundle_new(LO_TT_IMMEDIATE);
+            for (j=0; j<n; j++) {
+                lo_bundle_add_message(bundle, msgs[i+j]->path, OscSender_message(msgs[i+j]));
+            }
+            if (lo_send_bundle(dest->address, bundle) == -1)
+                err = -1;
+            lo_bundle_free_messages(bundle);
+        }
+    }
+    if (err == -1)
+        printf("OSC error %d: %s\n", lo_address_errno(dest->address), lo_address_errstr(dest->address));
+}
+
+static void
+OscSender_sendPending(OscSenderDestination *dest)
+{
+    int i;
+    OscQueueEvent *msgs[OSC_SENDER_PENDING];
+
+    for (i=0; i<dest->numpending; i++) {
+        msgs[i] = &dest->pending[i];
+    }
+    if (dest->numpending > 0)
+        OscSender_send(dest, msgs, dest->numpending);
+    dest->numpending = 0;
+}
+
+/* Keeps the latest message of each path of a rate limited destination. */
+static void
+OscSender_hold(OscSenderDestination *dest, OscQueueEvent *ev)
+{
+    int i;
+
+    if (dest->pending == NULL)
+        dest->pending = (OscQueueEvent *)malloc(OSC_SENDER_PENDING * sizeof(OscQueueEvent));
+    for (i=0; i<dest->numpending; i++) {
+        if (strcmp(dest->pending[i].path, ev->path) == 0)
+            break;
+    }
+    if (i == OSC_SENDER_PENDING) {
+        /* Too many paths to wait for the limit. */
+        OscSender_sendPending(dest);
+        i = 0;
+    }
+    dest->pending[i] = *ev;
+    if (i == dest->numpending)
+        dest->numpending++;
+}
+
+/* Sends the published messages, `all` ignores the rate limit. */
+static void
+OscSender_flush(OscSender *self, int all)
+{
+    int d, n, numdest, mask = self->size - 1;
+    unsigned long r, end = self->published;
+    double rate = self->rate;
+    unsigned long long now;
+    OscSenderDestination *dest;
+
+    /* The messages are read after the count they were published with. */
+    __sync_synchronize();
+    numdest = self->numdestinations;
+    now = Stream_clock();
+
+    for (d=0; d<numdest; d++) {
+        dest = &self->destinations[d];
+        n = 0;
+        for (r=self->read; r<end; r++) {
+            if (self->targets[r & mask] != d)
+                continue;
+            if (rate > 0.0 || dest->numpending > 0)
+                OscSender_hold(dest, &self->events[r & mask]);
+            else
+                self->scratch[n++] = &self->events[r & mask];
+        }
+        if (n > 0)
+            OscSender_send(dest, self->scratch, n);
+        if (dest->numpending > 0 && (all || rate <= 0.0 || now >= dest->next)) {
+            OscSender_sendPending(dest);
+            if (rate > 0.0)
+                dest->next = now + (unsigned long long)(1e9 / rate);
+        }
+    }
+
+    /* And before the producer may overwrite them. */
+    __sync_synchronize();
+    self->read = end;
+
+    if (self->dropped != self->reported) {
+        printf("OSC warning: %lu messages were dropped, the send queue was full.\n", self->dropped - self->reported);
+        self->reported = self->dropped;
+    }
+}
+
+static void *
+OscSender_run(void *arg)
+{
+    OscSender *self = (OscSender *)arg;
+    struct timeval tv;
+    struct timespec timeout;
+
+    pthread_mutex_lock(&self->mutex);
+    while (self->running) {
+        pthread_mutex_unlock(&self->mutex);
+        OscSender_flush(self, 0);
+        pthread_mutex_lock(&self->mutex);
+        if (!self->running)
+            break;
+        gettimeofday(&tv, NULL);
+        timeout.tv_sec = tv.tv_sec;
+        timeout.tv_nsec = tv.tv_usec * 1000 + OSCSENDER_WAIT;
+        if (timeout.tv_nsec >= 1000000000) {
+            timeout.tv_sec++;
+            timeout.tv_nsec -= 1000000000;
+        }
+        pthread_cond_timedwait(&self->cond, &self->mutex, &timeout);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    OscSender_flush(self, 1);
+    return NULL;
+}
+
+OscSender *
+OscSender_new(int size)
+{
+    OscSender *self = (OscSender *)calloc(1, sizeof(OscSender));
+
+    self->size = 1;
+    while (self->size < size)
+        self->size <<= 1;
+    self->events = (OscQueueEvent *)malloc(self->size * sizeof(OscQueueEvent));
+    self->targets = (int *)malloc(self->size * sizeof(int));
+    self->scratch = (OscQueueEvent **)malloc(self->size * sizeof(OscQueueEvent *));
+    self->destinations = (OscSenderDestination *)calloc(OSC_SENDER_DESTINATIONS, sizeof(OscSenderDestination));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+
+    self->running = 1;
+    if (pthread_create(&self->thread, NULL, OscSender_run, (void *)self) != 0) {
+        self->running = 0;
+        OscSender_free(self);
+        return NULL;
+    }
+    return self;
+}
+
+void
+OscSender_free(OscSender *self)
+{
+    int i;
+
+    if (self == NULL)
+        return;
+    if (self->running) {
+        pthread_mutex_lock(&self->mutex);
+        self->running = 0;
+        pthread_cond_signal(&self->cond);
+        pthread_mutex_unlock(&self->mutex);
+        pthread_join(self->thread, NULL);
+    }
+    for (i=0; i<self->numdestinations; i++) {
+        lo_address_free(self->destinations[i].address);
+        free(self->destinations[i].host);
+        free(self->destinations[i].pending);
+    }
+    pthread_cond_destroy(&self->cond);
+    pthread_mutex_destroy(&self->mutex);
+    free(self->destinations);
+    free(self->scratch);
+    free(self->targets);
+    free(self->events);
+    free(self);
+}
+
+int
+OscSender_getDestination(OscSender *self, const char *host, int port)
+{
+    int i;
+    char buf[20];
+    OscSenderDestination *dest;
+
+    if (host == NULL)
+        host = "";
+    for (i=0; i<self->numdestinations; i++) {
+        if (self->destinations[i].port == port && strcmp(self->destinations[i].host, host) == 0)
+            return i;
+    }
+    if (self->numdestinations == OSC_SENDER_DESTINATIONS)
+        return -1;
+
+    dest = &self->destinations[self->numdestinations];
+    dest->host = strdup(host);
+    dest->port = port;
+    sprintf(buf, "%i", port);
+    dest->address = lo_address_new(host[0] ? host : NULL, buf);
+    /* The destination must be visible before the new count. */
+    __sync_synchronize();
+    self->numdestinations++;
+    return self->numdestinations - 1;
+}
+
+void
+OscSender_setRate(OscSender *self, double rate)
+{
+    self->rate = rate < 0.0 ? 0.0 : rate;
+}
+
+OscQueueEvent *
+OscSender_reserve(OscSender *self, int destination)
+{
+    int i = self->written & (self->size - 1);
+
+    if (self->written - self->read >= (unsigned long)self->size) {
+        self->dropped++;
+        return NULL;
+    }
+    self->targets[i] = destination;
+    return &self->events[i];
+}
+
+void
+OscSender_commit(OscSender *self)
+{
+    self->written++;
+}
+
+void
+OscSender_publish(OscSender *self)
+{
+    /* The messages must be visible before the new count. */
+    __sync_synchronize();
+    self->published = self->written;
+}
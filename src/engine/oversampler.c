@@ -0,0 +1,289 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "oversampler.h"
+#include "muladd.h"
+#include "simd.h"
+
+/* Odd-branch taps on each side and Kaiser window parameter of each stage,
+ * from the base rate up. */
+static const struct {
+    int taps;
+    double beta;
+} Oversampler_designs[OVERSAMPLER_MAX_STAGES] = {
+    {16, 8.0},
+    {6, 7.0},
+    {4, 6.0}
+};
+
+/* Modified Bessel function of the first kind, order 0. */
+static double
+Oversampler_bessel(double x)
+{
+    int k;
+    double term = 1.0, sum = 1.0, y = x * x / 4.0;
+
+    for (k=1; k<64 && term > sum * 1e-12; k++) {
+        term *= y / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+static void
+Oversampler_initStage(OversamplerStage *st, int taps, double beta, int num)
+{
+    int k, m;
+    double x, norm = 1.0 / Oversampler_bessel(beta);
+
+    st->taps = taps;
+    st->coeffs = (MYFLT *)pyo_aligned_calloc(taps * sizeof(MYFLT));
+    for (k=0; k<taps; k++) {
+        /* Odd distance, in samples at the high rate, from the center. */
+        m = 2 * k - 2 * taps + 1;
+        x = m / (2.0 * taps);
+        st->coeffs[k] = (MYFLT)(sin(PI * m / 2.0) / (PI * m) *
+                                Oversampler_bessel(beta * sqrt(1.0 - x * x)) * norm);
+    }
+    /* `num` is the block size at the input of the stage. */
+    st->up = (MYFLT *)pyo_aligned_calloc((2 * taps - 1 + num) * sizeof(MYFLT));
+    st->even = (MYFLT *)pyo_aligned_calloc((2 * taps - 1 + num) * sizeof(MYFLT));
+    st->odd = (MYFLT *)pyo_aligned_calloc((taps + num) * sizeof(MYFLT));
+    st->tmp = (MYFLT *)pyo_aligned_calloc(num * sizeof(MYFLT));
+}
+
+int
+Oversampler_getFactor(int factor)
+{
+    if (factor >= 8)
+        return 8;
+    else if (factor >= 4)
+        return 4;
+    else if (factor >= 2)
+        return 2;
+    else
+        return 1;
+}
+
+Oversampler *
+Oversampler_new(int factor, int bufsize)
+{
+    int s;
+    Oversampler *self;
+
+    factor = Oversampler_getFactor(factor);
+    if (factor == 1)
+        return NULL;
+
+    self = (Oversampler *)calloc(1, sizeof(Oversampler));
+    self->factor = factor;
+    self->bufsize = bufsize;
+    for (s=0; (1 << s) < factor; s++)
+        Oversampler_initStage(&self->stage[s], Oversampler_designs[s].taps, Oversampler_designs[s].beta, bufsize << s);
+    self->stages = s;
+    self->work[0] = (MYFLT *)pyo_aligned_calloc(bufsize * factor * sizeof(MYFLT));
+    self->work[1] = (MYFLT *)pyo_aligned_calloc(bufsize * factor * sizeof(MYFLT));
+    for (s=0; s<OVERSAMPLER_PARAMS; s++)
+        self->hold[s] = (MYFLT *)pyo_aligned_calloc(bufsize * factor * sizeof(MYFLT));
+    return self;
+}
+
+void
+Oversampler_free(Oversampler *self)
+{
+    int s;
+
+    if (self == NULL)
+        return;
+    for (s=0; s<self->stages; s++) {
+        pyo_aligned_free(self->stage[s].coeffs);
+        pyo_aligned_free(self->stage[s].up);
+        pyo_aligned_free(self->stage[s].even);
+        pyo_aligned_free(self->stage[s].odd);
+        pyo_aligned_free(self->stage[s].tmp);
+    }
+    pyo_aligned_free(self->work[0]);
+    pyo_aligned_free(self->work[1]);
+    for (s=0; s<OVERSAMPLER_PARAMS; s++)
+        pyo_aligned_free(self->hold[s]);
+    free(self);
+}
+
+void
+Oversampler_reset(Oversampler *self)
+{
+    int s, taps;
+
+    for (s=0; s<self->stages; s++) {
+        taps = self->stage[s].taps;
+        memset(self->stage[s].up, 0, (2 * taps - 1) * sizeof(MYFLT));
+        memset(self->stage[s].even, 0, (2 * taps - 1) * sizeof(MYFLT));
+        memset(self->stage[s].odd, 0, taps * sizeof(MYFLT));
+    }
+}
+
+double
+Oversampler_getLatency(Oversampler *self)
+{
+    int s, taps;
+    double latency = 0.0;
+
+    if (self == NULL)
+        return 0.0;
+    /* taps input samples up, 2 * taps - 1 output samples down. */
+    for (s=0; s<self->stages; s++) {
+        taps = self->stage[s].taps;
+        latency += (taps + (2 * taps - 1) * 0.5) / (1 << s);
+    }
+    return latency;
+}
+
+long
+Oversampler_getMemory(Oversampler *self)
+{
+    int s, taps, num;
+    long size;
+
+    if (self == NULL)
+        return 0;
+    size = sizeof(Oversampler) + (2 + OVERSAMPLER_PARAMS) * self->bufsize * self->factor * sizeof(MYFLT);
+    for (s=0; s<self->stages; s++) {
+        taps = self->stage[s].taps;
+        num = self->bufsize << s;
+        size += (taps + 2 * (2 * taps - 1 + num) + taps + num + num) * sizeof(MYFLT);
+    }
+    return size;
+}
+
+/* y[n] = sum of c[k] * (x[n + k] + x[n + 2 * taps - 1 - k]), for k < taps.
+   The sums of VSIZE outputs stay in registers over the taps. */
+static void
+Oversampler_fir(const MYFLT *c, int taps, const MYFLT *x, MYFLT *y, int num)
+{
+    int k, n = 0, last = 2 * taps - 1;
+    MYFLT sum;
+
+#ifdef VSIZE
+    VTYPE acc0, acc1, vc;
+    for (; n<=num-2*VSIZE; n+=2*VSIZE) {
+        acc0 = acc1 = VSET1(0.0);
+        for (k=0; k<taps; k++) {
+            vc = VSET1(c[k]);
+            acc0 = VADD(acc0, VMUL(vc, VADD(VLOAD(x + n + k), VLOAD(x + n + last - k))));
+            acc1 = VADD(acc1, VMUL(vc, VADD(VLOAD(x + n + VSIZE + k), VLOAD(x + n + VSIZE + last - k))));
+        }
+        VSTORE(y + n, acc0);
+        VSTORE(y + n + VSIZE, acc1);
+    }
+#endif
+    for (; n<num; n++) {
+        sum = 0.0;
+        for (k=0; k<taps; k++)
+            sum += c[k] * (x[n + k] + x[n + last - k]);
+        y[n] = sum;
+    }
+}
+
+/* `num` input samples, 2 * num output samples. */
+static void
+Oversampler_upStage(OversamplerStage *st, MYFLT *in, MYFLT *out, int num)
+{
+    int i, taps = st->taps, hist = 2 * taps - 1;
+    MYFLT *x = st->up, *center = st->up + taps - 1;
+
+    memcpy(x + hist, in, num * sizeof(MYFLT));
+    Oversampler_fir(st->coeffs, taps, x, st->tmp, num);
+    /* The upsampled block has twice the energy of zero stuffing. */
+    for (i=0; i<num; i++) {
+        out[i * 2] = center[i];
+        out[i * 2 + 1] = st->tmp[i] * 2;
+    }
+    memmove(x, x + num, hist * sizeof(MYFLT));
+}
+
+/* 2 * num input samples, `num` output samples. */
+static void
+Oversampler_downStage(OversamplerStage *st, MYFLT *in, MYFLT *out, int num)
+{
+    int i, taps = st->taps, hist = 2 * taps - 1;
+    MYFLT *even = st->even, *odd = st->odd;
+
+    for (i=0; i<num; i++) {
+        even[hist + i] = in[i * 2];
+        odd[taps + i] = in[i * 2 + 1];
+    }
+    Oversampler_fir(st->coeffs, taps, even, out, num);
+    for (i=0; i<num; i++)
+        out[i] += odd[i] * 0.5;
+    memmove(even, even + num, hist * sizeof(MYFLT));
+    memmove(odd, odd + num, taps * sizeof(MYFLT));
+}
+
+MYFLT *
+Oversampler_up(Oversampler *self, MYFLT *in, int num)
+{
+    int s;
+    MYFLT *src = in, *dst;
+
+    for (s=0; s<self->stages; s++) {
+        dst = self->work[s & 1];
+        Oversampler_upStage(&self->stage[s], src, dst, num << s);
+        src = dst;
+    }
+    return src;
+}
+
+void
+Oversampler_down(Oversampler *self, MYFLT *out, int num)
+{
+    int s;
+    MYFLT *src = self->work[(self->stages - 1) & 1], *dst;
+
+    for (s=self->stages-1; s>=0; s--) {
+        dst = s == 0 ? out : self->work[(s + 1) & 1];
+        Oversampler_downStage(&self->stage[s], src, dst, num << s);
+        src = dst;
+    }
+}
+
+MYFLT *
+Oversampler_hold(Oversampler *self, int slot, MYFLT *in, int num)
+{
+    int i, j, factor = self->factor;
+    MYFLT *out = self->hold[slot];
+
+    for (i=0; i<num; i++) {
+        for (j=0; j<factor; j++)
+            out[i * factor + j] = in[i];
+    }
+    return out;
+}
+
+MYFLT *
+Oversampler_fill(Oversampler *self, int slot, MYFLT value, int num)
+{
+    pyo_fill(self->hold[slot], value, num * self->factor);
+    return self->hold[slot];
+}
@@ -0,0 +1,490 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include "streammodule.h"
+#include "packed.h"
+#include "simd.h"
+
+/* Frames interleaved at once in the scratch buffers. */
+#define PACKED_FRAMES 64
+
+#if defined(VSIZE)
+#define PACKED_LANES VSIZE
+#else
+#define PACKED_LANES 1
+#endif
+
+int
+Packed_setValues(PyObject *arg, int chnls, PyObject **list, MYFLT *values, Stream **streams)
+{
+    int i, size;
+    PyObject *item, *stream, *streamlist;
+
+    if (! PyList_Check(arg) || PyList_Size(arg) == 0) {
+        PyErr_SetString(PyExc_TypeError, "argument must be a non-empty list.");
+        return -1;
+    }
+
+    size = PyList_Size(arg);
+    streamlist = PyList_New(chnls);
+    for (i=0; i<chnls; i++) {
+        item = PyList_GET_ITEM(arg, i % size);
+        if (PyNumber_Check(item) && values != NULL) {
+            Py_INCREF(Py_None);
+            PyList_SET_ITEM(streamlist, i, Py_None);
+        }
+        else {
+            stream = PyObject_CallMethod(item, "_getStream", NULL);
+            if (stream == NULL) {
+                Py_DECREF(streamlist);
+                return -1;
+            }
+            PyList_SET_ITEM(streamlist, i, stream);
+        }
+    }
+
+    for (i=0; i<chnls; i++) {
+        item = PyList_GET_ITEM(arg, i % size);
+        if (PyNumber_Check(item) && values != NULL) {
+            values[i] = PyFloat_AsDouble(item);
+            streams[i] = NULL;
+        }
+        else
+            streams[i] = (Stream *)PyList_GET_ITEM(streamlist, i);
+    }
+    Py_XDECREF(*list);
+    *list = streamlist;
+    return 0;
+}
+
+static int
+packed_round(int chnls)
+{
+    return (chnls + PACKED_LANES - 1) / PACKED_LANES * PACKED_LANES;
+}
+
+PackedBiquad *
+PackedBiquad_new(int chnls)
+{
+    PackedBiquad *self = (PackedBiquad *)malloc(sizeof(PackedBiquad));
+
+    self->chnls = chnls;
+    self->pchnls = packed_round(chnls);
+    self->coeffs = (MYFLT *)calloc(self->pchnls * 5, sizeof(MYFLT));
+    self->incs = (MYFLT *)calloc(self->pchnls * 5, sizeof(MYFLT));
+    self->state = (MYFLT *)calloc(self->pchnls * 4, sizeof(MYFLT));
+    return self;
+}
+
+void
+PackedBiquad_free(PackedBiquad *self)
+{
+    if (self == NULL)
+        return;
+    free(self->coeffs);
+    free(self->incs);
+    free(self->state);
+    free(self);
+}
+
+void
+PackedBiquad_setCoeffs(PackedBiquad *self, int chnl, MYFLT b0, MYFLT b1, MYFLT b2,
+                       MYFLT a0, MYFLT a1, MYFLT a2, int num)
+{
+    int i, p = self->pchnls;
+    MYFLT inv = 1.0 / a0, target[5];
+
+    target[0] = b0 * inv;
+    target[1] = b1 * inv;
+    target[2] = b2 * inv;
+    target[3] = a1 * inv;
+    target[4] = a2 * inv;
+
+    if (num <= 0) {
+        for (i=0; i<5; i++) {
+            self->coeffs[i*p+chnl] = target[i];
+            self->incs[i*p+chnl] = 0.0;
+        }
+    }
+    else {
+        inv = 1.0 / num;
+        for (i=0; i<5; i++) {
+            self->incs[i*p+chnl] = (target[i] - self->coeffs[i*p+chnl]) * inv;
+        }
+    }
+}
+
+void
+PackedBiquad_prime(PackedBiquad *self, MYFLT **in)
+{
+    int i, j, p = self->pchnls;
+
+    for (j=0; j<self->chnls; j++) {
+        for (i=0; i<4; i++) {
+            self->state[i*p+j] = in[j][0];
+        }
+    }
+}
+
+#if defined(VSIZE)
+void
+PackedBiquad_process(PackedBiquad *self, MYFLT **in, MYFLT **out, int num)
+{
+    int g, i, k, n, start, lanes, p = self->pchnls;
+    MYFLT buf[PACKED_FRAMES * VSIZE];
+    MYFLT *c = self->coeffs, *d = self->incs, *s = self->state;
+    VTYPE b0, b1, b2, a1, a2, ib0, ib1, ib2, ia1, ia2, x, x1, x2, y, y1, y2;
+
+    for (g=0; g<self->chnls; g+=VSIZE) {
+        lanes = self->chnls - g < VSIZE ? self->chnls - g : VSIZE;
+        b0 = VLOAD(c+g); b1 = VLOAD(c+p+g); b2 = VLOAD(c+2*p+g); a1 = VLOAD(c+3*p+g); a2 = VLOAD(c+4*p+g);
+        ib0 = VLOAD(d+g); ib1 = VLOAD(d+p+g); ib2 = VLOAD(d+2*p+g); ia1 = VLOAD(d+3*p+g); ia2 = VLOAD(d+4*p+g);
+        x1 = VLOAD(s+g); x2 = VLOAD(s+p+g); y1 = VLOAD(s+2*p+g); y2 = VLOAD(s+3*p+g);
+
+        for (start=0; start<num; start+=PACKED_FRAMES) {
+            n = num - start < PACKED_FRAMES ? num - start : PACKED_FRAMES;
+            memset(buf, 0, n * VSIZE * sizeof(MYFLT));
+            for (k=0; k<lanes; k++) {
+                for (i=0; i<n; i++) {
+                    buf[i*VSIZE+k] = in[g+k][start+i];
+                }
+            }
+            for (i=0; i<n; i++) {
+                b0 = VADD(b0, ib0); b1 = VADD(b1, ib1); b2 = VADD(b2, ib2); a1 = VADD(a1, ia1); a2 = VADD(a2, ia2);
+                x = VLOAD(buf + i * VSIZE);
+                y = VSUB(VSUB(VADD(VADD(VMUL(b0, x), VMUL(b1, x1)), VMUL(b2, x2)), VMUL(a1, y1)), VMUL(a2, y2));
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                VSTORE(buf + i * VSIZE, y);
+            }
+            for (k=0; k<lanes; k++) {
+                for (i=0; i<n; i++) {
+                    out[g+k][start+i] = buf[i*VSIZE+k];
+                }
+            }
+        }
+
+        VSTORE(c+g, b0); VSTORE(c+p+g, b1); VSTORE(c+2*p+g, b2); VSTORE(c+3*p+g, a1); VSTORE(c+4*p+g, a2);
+        VSTORE(s+g, x1); VSTORE(s+p+g, x2); VSTORE(s+2*p+g, y1); VSTORE(s+3*p+g, y2);
+    }
+}
+#else
+void
+PackedBiquad_process(PackedBiquad *self, MYFLT **in, MYFLT **out, int num)
+{
+    int i, j, p = self->pchnls;
+    MYFLT b0, b1, b2, a1, a2, x, x1, x2, y, y1, y2;
+    MYFLT *c = self->coeffs, *d = self->incs, *s = self->state;
+
+    for (j=0; j<self->chnls; j++) {
+        b0 = c[j]; b1 = c[p+j]; b2 = c[2*p+j]; a1 = c[3*p+j]; a2 = c[4*p+j];
+        x1 = s[j]; x2 = s[p+j]; y1 = s[2*p+j]; y2 = s[3*p+j];
+        for (i=0; i<num; i++) {
+            b0 += d[j]; b1 += d[p+j]; b2 += d[2*p+j]; a1 += d[3*p+j]; a2 += d[4*p+j];
+            x = in[j][i];
+            y = (b0 * x) + (b1 * x1) + (b2 * x2) - (a1 * y1) - (a2 * y2);
+            x2 = x1;
+            x1 = x;
+            y2 = y1;
+            y1 = y;
+            out[j][i] = y;
+        }
+        c[j] = b0; c[p+j] = b1; c[2*p+j] = b2; c[3*p+j] = a1; c[4*p+j] = a2;
+        s[j] = x1; s[p+j] = x2; s[2*p+j] = y1; s[3*p+j] = y2;
+    }
+}
+#endif
+
+PackedDelay *
+PackedDelay_new(int chnls, long size)
+{
+    PackedDelay *self = (PackedDelay *)malloc(sizeof(PackedDelay));
+
+    self->chnls = chnls;
+    self->pchnls = packed_round(chnls);
+    self->size = size;
+    self->mask = 1;
+    while (self->mask < size + 1)
+        self->mask <<= 1;
+    self->mask--;
+    self->in_count = 0;
+    self->ring = (MYFLT *)calloc((self->mask + 1) * self->pchnls, sizeof(MYFLT));
+    self->scratch = (MYFLT *)calloc((PACKED_FRAMES + 1) * PACKED_LANES, sizeof(MYFLT));
+    return self;
+}
+
+void
+PackedDelay_free(PackedDelay *self)
+{
+    if (self == NULL)
+        return;
+    free(self->ring);
+    free(self->scratch);
+    free(self);
+}
+
+void
+PackedDelay_reset(PackedDelay *self)
+{
+    memset(self->ring, 0, (self->mask + 1) * self->pchnls * sizeof(MYFLT));
+    self->in_count = 0;
+}
+
+/* First sample of channel `chnl` in the ring, the next ones are
+ * PACKED_LANES apart. */
+static MYFLT *
+PackedDelay_channel(PackedDelay *self, int chnl)
+{
+    return self->ring + (chnl / PACKED_LANES) * (self->mask + 1) * PACKED_LANES + chnl % PACKED_LANES;
+}
+
+/* Same computation as the Delay object, channel by channel. */
+static void
+PackedDelay_processChannels(PackedDelay *self, MYFLT **in, MYFLT **out, MYFLT **delay, MYFLT *cdelay,
+                            MYFLT **feed, MYFLT *cfeed, int num)
+{
+    int i, j;
+    long ind, isamp, count;
+    MYFLT val, frac, sampdel, fb, *ring, *x, *y, *dl, *fd;
+
+    for (j=0; j<self->chnls; j++) {
+        ring = PackedDelay_channel(self, j);
+        x = in[j];
+        y = out[j];
+        dl = delay[j];
+        fd = feed[j];
+        count = self->in_count;
+        sampdel = cdelay[j];
+        fb = cfeed[j];
+        for (i=0; i<num; i++) {
+            if (dl != NULL)
+                sampdel = dl[i];
+            if (fd != NULL)
+                fb = fd[i];
+            isamp = (long)sampdel;
+            if (isamp < sampdel)
+                isamp++;
+            frac = isamp - sampdel;
+            ind = count - isamp;
+            val = ring[(ind & self->mask)*PACKED_LANES] * (1.0 - frac) + ring[((ind+1) & self->mask)*PACKED_LANES] * frac;
+            y[i] = val;
+            ring[count*PACKED_LANES] = x[i] + (val * fb);
+            count = (count + 1) & self->mask;
+        }
+    }
+    self->in_count = (self->in_count + num) & self->mask;
+}
+
+void
+PackedDelay_process(PackedDelay *self, MYFLT **in, MYFLT **out, MYFLT **delay, MYFLT *cdelay,
+                    MYFLT **feed, MYFLT *cfeed, int num)
+{
+#if defined(VSIZE)
+    int g, i, k, n, start, lanes;
+    long ind, isamp, count;
+    MYFLT frac, sampdel, *ring, *buf, *f;
+    VTYPE v, vfeed, vfrac, vifrac;
+
+    /* Vectors need one delay for all the channels. */
+    for (k=0; k<self->chnls; k++) {
+        if (delay[k] != NULL || feed[k] != NULL || cdelay[k] != cdelay[0])
+            break;
+    }
+    if (k < self->chnls || self->chnls < VSIZE) {
+        PackedDelay_processChannels(self, in, out, delay, cdelay, feed, cfeed, num);
+        return;
+    }
+
+    sampdel = cdelay[0];
+    isamp = (long)sampdel;
+    if (isamp < sampdel)
+        isamp++;
+    frac = isamp - sampdel;
+    vfrac = VSET1(frac);
+    vifrac = VSET1(1.0 - frac);
+    buf = self->scratch;
+    f = self->scratch + PACKED_FRAMES * VSIZE; /* the feedbacks, after the frames */
+    for (g=0; g<self->chnls; g+=VSIZE) {
+        lanes = self->chnls - g < VSIZE ? self->chnls - g : VSIZE;
+        ring = PackedDelay_channel(self, g);
+        for (k=0; k<VSIZE; k++) {
+            f[k] = k < lanes ? cfeed[g+k] : 0.0;
+        }
+        vfeed = VLOAD(f);
+        count = self->in_count;
+        for (start=0; start<num; start+=PACKED_FRAMES) {
+            n = num - start < PACKED_FRAMES ? num - start : PACKED_FRAMES;
+            memset(buf, 0, n * VSIZE * sizeof(MYFLT));
+            for (k=0; k<lanes; k++) {
+                for (i=0; i<n; i++) {
+                    buf[i*VSIZE+k] = in[g+k][start+i];
+                }
+            }
+            for (i=0; i<n; i++) {
+                ind = count - isamp;
+                v = VADD(VMUL(VLOAD(ring+(ind & self->mask)*VSIZE), vifrac), VMUL(VLOAD(ring+((ind+1) & self->mask)*VSIZE), vfrac));
+                VSTORE(ring+count*VSIZE, VADD(VLOAD(buf+i*VSIZE), VMUL(v, vfeed)));
+                VSTORE(buf+i*VSIZE, v);
+                count = (count + 1) & self->mask;
+            }
+            for (k=0; k<lanes; k++) {
+                for (i=0; i<n; i++) {
+                    out[g+k][start+i] = buf[i*VSIZE+k];
+                }
+            }
+        }
+    }
+    self->in_count = (self->in_count + num) & self->mask;
+#else
+    PackedDelay_processChannels(self, in, out, delay, cdelay, feed, cfeed, num);
+#endif
+}
+
+PackedComb *
+PackedComb_new(int chnls, long *lengths)
+{
+    int i;
+    PackedComb *self = (PackedComb *)malloc(sizeof(PackedComb));
+
+    self->chnls = chnls;
+    self->pchnls = packed_round(chnls);
+    self->lengths = (long *)malloc(chnls * sizeof(long));
+    self->size = self->minlength = lengths[0];
+    for (i=0; i<chnls; i++) {
+        self->lengths[i] = lengths[i];
+        if (lengths[i] > self->size)
+            self->size = lengths[i];
+        if (lengths[i] < self->minlength)
+            self->minlength = lengths[i];
+    }
+    self->in_count = 0;
+    self->ring = (MYFLT *)calloc(self->size * self->pchnls, sizeof(MYFLT));
+    self->state = (MYFLT *)calloc(self->pchnls, sizeof(MYFLT));
+    /* The lanes after chnls are never read, they stay at zero. */
+    self->scratch = (MYFLT *)calloc(PACKED_FRAMES * self->pchnls, sizeof(MYFLT));
+    return self;
+}
+
+void
+PackedComb_free(PackedComb *self)
+{
+    if (self == NULL)
+        return;
+    free(self->lengths);
+    free(self->ring);
+    free(self->state);
+    free(self->scratch);
+    free(self);
+}
+
+void
+PackedComb_process(PackedComb *self, MYFLT *in, MYFLT *out, MYFLT *feed, MYFLT *damp, int num)
+{
+    int c, i, n, start, p = self->pchnls;
+    long r, count;
+    MYFLT x, sum, *frame, *buf = self->scratch;
+    MYFLT *rd[self->chnls];
+#if defined(VSIZE)
+    int g;
+    VTYPE fs0, fs1, d1, d2, fb, y;
+#else
+    MYFLT fs, d1, d2;
+#endif
+
+    for (start=0; start<num; start+=n) {
+        /* Neither the write nor the reads wrap in a chunk, shorter than the
+         * shortest comb, the frames it writes are read later. */
+        count = self->in_count;
+        n = num - start < PACKED_FRAMES ? num - start : PACKED_FRAMES;
+        if (n > self->minlength)
+            n = self->minlength;
+        if (n > self->size - count)
+            n = self->size - count;
+        for (c=0; c<self->chnls; c++) {
+            r = count - self->lengths[c];
+            if (r < 0)
+                r += self->size;
+            if (n > self->size - r)
+                n = self->size - r;
+            rd[c] = self->ring + r * p + c;
+        }
+
+        for (i=0; i<n; i++) {
+            sum = 0.0;
+            for (c=0; c<self->chnls; c++) {
+                x = rd[c][i*p];
+                buf[i*p+c] = x;
+                sum += x;
+            }
+            out[start+i] = sum;
+        }
+
+        frame = self->ring + count * p;
+#if defined(VSIZE)
+        /* Two vectors at a time, to hide the latency of the lowpass. */
+        for (g=0; g<p; g+=2*VSIZE) {
+            fs0 = VLOAD(self->state+g);
+            if (g + VSIZE < p) {
+                fs1 = VLOAD(self->state+g+VSIZE);
+                for (i=0; i<n; i++) {
+                    x = damp[start+i];
+                    d1 = VSET1(x);
+                    d2 = VSET1(1.0 - x);
+                    fb = VSET1(feed[start+i]);
+                    y = VSET1(in[start+i]);
+                    fs0 = VADD(VMUL(fs0, d1), VMUL(VLOAD(buf+i*p+g), d2));
+                    fs1 = VADD(VMUL(fs1, d1), VMUL(VLOAD(buf+i*p+g+VSIZE), d2));
+                    VSTORE(frame+i*p+g, VADD(VMUL(fs0, fb), y));
+                    VSTORE(frame+i*p+g+VSIZE, VADD(VMUL(fs1, fb), y));
+                }
+                VSTORE(self->state+g+VSIZE, fs1);
+            }
+            else {
+                for (i=0; i<n; i++) {
+                    x = damp[start+i];
+                    fs0 = VADD(VMUL(fs0, VSET1(x)), VMUL(VLOAD(buf+i*p+g), VSET1(1.0 - x)));
+                    VSTORE(frame+i*p+g, VADD(VMUL(fs0, VSET1(feed[start+i])), VSET1(in[start+i])));
+                }
+            }
+            VSTORE(self->state+g, fs0);
+        }
+#else
+        for (c=0; c<self->chnls; c++) {
+            fs = self->state[c];
+            for (i=0; i<n; i++) {
+                d1 = damp[start+i];
+                d2 = 1.0 - d1;
+                fs = (fs * d1) + (buf[i*p+c] * d2);
+                frame[i*p+c] = fs * feed[start+i] + in[start+i];
+            }
+            self->state[c] = fs;
+        }
+#endif
+
+        self->in_count = count + n;
+        if (self->in_count >= self->size)
+            self->in_count = 0;
+    }
+}
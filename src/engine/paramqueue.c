@@ -0,0 +1,317 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pyomodule.h"
+#include "streammodule.h"
+#include "paramqueue.h"
+#include "dspthread.h"
+
+typedef struct {
+    pyo_audio_HEAD
+} PyoAudioObject;
+
+struct ParamQueue {
+    int size;
+    ParamEvent *ring;
+    volatile int head;      /* written by the producer */
+    volatile int tail;      /* written by the consumer */
+    PyObject **trash;
+    int tsize;
+    volatile int thead;     /* written by the consumer */
+    volatile int ttail;     /* written by the producer */
+    ParamEvent *pending;    /* fetched changes, sorted by time, owned by the consumer */
+    int count;
+    int due;                /* number of pending changes applied in the current buffer */
+    PyoThreadState gil;     /* taken by the consumer for python calls */
+};
+
+/* Identity mul and add, swapped in while a split stream is computed. */
+static PyObject *ParamQueue_one = NULL;
+static PyObject *ParamQueue_zero = NULL;
+
+static void
+ParamQueue_empty_trash(ParamQueue *self)
+{
+    int tail = self->ttail;
+
+    while (tail != self->thead) {
+        __sync_synchronize();
+        Py_XDECREF(self->trash[tail]);
+        tail = (tail + 1) % self->tsize;
+    }
+    __sync_synchronize();
+    self->ttail = tail;
+}
+
+static void
+ParamQueue_release(ParamQueue *self, PyObject *obj, int gil)
+{
+    if (obj == NULL)
+        return;
+    if (gil) {
+        Py_DECREF(obj);
+        return;
+    }
+    /* Room is reserved by ParamQueue_begin. */
+    self->trash[self->thead] = obj;
+    __sync_synchronize();
+    self->thead = (self->thead + 1) % self->tsize;
+}
+
+ParamQueue *
+ParamQueue_new(int size)
+{
+    ParamQueue *self = (ParamQueue *)calloc(1, sizeof(ParamQueue));
+    self->size = size;
+    self->ring = (ParamEvent *)calloc(size, sizeof(ParamEvent));
+    self->pending = (ParamEvent *)calloc(size, sizeof(ParamEvent));
+    self->tsize = size * 3 + 1;
+    self->trash = (PyObject **)calloc(self->tsize, sizeof(PyObject *));
+    PyoThreadState_init(&self->gil);
+    if (ParamQueue_one == NULL) {
+        ParamQueue_one = PyFloat_FromDouble(1.0);
+        ParamQueue_zero = PyFloat_FromDouble(0.0);
+    }
+    return self;
+}
+
+void
+ParamQueue_free(ParamQueue *self)
+{
+    int i;
+
+    ParamQueue_empty_trash(self);
+    while (self->tail != self->head) {
+        Py_XDECREF(self->ring[self->tail].obj);
+        Py_XDECREF(self->ring[self->tail].method);
+        Py_XDECREF(self->ring[self->tail].value);
+        self->tail = (self->tail + 1) % self->size;
+    }
+    for (i=0; i<self->count; i++) {
+        Py_XDECREF(self->pending[i].obj);
+        Py_XDECREF(self->pending[i].method);
+        Py_XDECREF(self->pending[i].value);
+    }
+    PyoThreadState_clear(&self->gil);
+    free(self->ring);
+    free(self->pending);
+    free(self->trash);
+    free(self);
+}
+
+int
+ParamQueue_post(ParamQueue *self, PyObject *obj, PyObject *method, PyObject *value,
+                int kind, unsigned long long time)
+{
+    ParamEvent *ev;
+    int next = (self->head + 1) % self->size;
+
+    ParamQueue_empty_trash(self);
+    if (next == self->tail)
+        return -1;
+
+    ev = &self->ring[self->head];
+    Py_INCREF(obj);
+    Py_INCREF(method);
+    Py_INCREF(value);
+    ev->obj = obj;
+    ev->method = method;
+    ev->value = value;
+    ev->kind = kind;
+    ev->time = time;
+    ev->offset = ev->done = 0;
+    ev->next = NULL;
+    __sync_synchronize();
+    self->head = next;
+    return 0;
+}
+
+/* A mul or add change can be applied by the audio thread only if both
+   fields of the target hold floats (the scalar post-processing modes). */
+static int
+ParamQueue_is_scalar(PyObject *obj)
+{
+    PyoAudioObject *o = (PyoAudioObject *)obj;
+    return o->mul != NULL && o->add != NULL && PyFloat_Check(o->mul) && PyFloat_Check(o->add);
+}
+
+static void
+ParamQueue_swap(ParamEvent *ev)
+{
+    PyObject *tmp;
+    PyoAudioObject *o = (PyoAudioObject *)ev->obj;
+
+    if (ev->kind == PARAM_MUL) {
+        tmp = o->mul;
+        o->mul = ev->value;
+    }
+    else {
+        tmp = o->add;
+        o->add = ev->value;
+    }
+    ev->value = tmp;
+    ev->done = 1;
+}
+
+static void
+ParamQueue_call(ParamEvent *ev)
+{
+    PyObject *result = PyObject_CallMethodObjArgs(ev->obj, ev->method, ev->value, NULL);
+    if (result == NULL)
+        PyErr_Print();
+    else
+        Py_DECREF(result);
+    ev->done = 1;
+}
+
+void
+ParamQueue_begin(ParamQueue *self, unsigned long long start, int bufsize, int gil)
+{
+    int i, room, needgil = 0;
+    unsigned long long end = start + bufsize;
+    ParamEvent *ev, *last;
+    Stream *stream;
+
+    /* Fetch the posted changes, keeping the pending list sorted by time. */
+    while (self->count < self->size && self->tail != self->head) {
+        __sync_synchronize();
+        ev = &self->ring[self->tail];
+        for (i=self->count; i>0 && self->pending[i-1].time > ev->time; i--)
+            self->pending[i] = self->pending[i-1];
+        self->pending[i] = *ev;
+        self->count++;
+        __sync_synchronize();
+        self->tail = (self->tail + 1) % self->size;
+    }
+    if (self->count == 0)
+        return;
+
+    /* Every change hands back at most three references. */
+    room = (self->ttail - self->thead - 1 + self->tsize) % self->tsize;
+    for (i=0; i<self->count && i<room/3 && self->pending[i].time < end; i++) {
+        ev = &self->pending[i];
+        if (ev->kind == PARAM_CALL || !ParamQueue_is_scalar(ev->obj))
+            needgil = 1;
+    }
+    self->due = i;
+    if (self->due == 0)
+        return;
+
+    if (needgil && !gil)
+        PyoThreadState_acquire(&self->gil);
+    for (i=0; i<self->due; i++) {
+        ev = &self->pending[i];
+        ev->offset = ev->time > start ? (int)(ev->time - start) : 0;
+        ev->done = 0;
+        ev->next = NULL;
+        if (ev->kind == PARAM_CALL || !ParamQueue_is_scalar(ev->obj)) {
+            /* The GIL is held here, references are released right away. */
+            ParamQueue_call(ev);
+            Py_CLEAR(ev->obj);
+            Py_CLEAR(ev->method);
+            Py_CLEAR(ev->value);
+            continue;
+        }
+        stream = ((PyoAudioObject *)ev->obj)->stream;
+        if (ev->offset == 0 || !Stream_getStreamActive(stream)) {
+            ParamQueue_swap(ev);
+            continue;
+        }
+        if (stream->params == NULL)
+            stream->params = ev;
+        else {
+            for (last=stream->params; last->next != NULL; last=last->next);
+            last->next = ev;
+        }
+    }
+    if (needgil && !gil)
+        PyoThreadState_release(&self->gil);
+}
+
+void
+ParamQueue_end(ParamQueue *self, int gil)
+{
+    int i;
+    ParamEvent *ev;
+
+    if (self->due == 0)
+        return;
+
+    for (i=0; i<self->due; i++) {
+        ev = &self->pending[i];
+        if (ev->obj == NULL)
+            continue;
+        ((PyoAudioObject *)ev->obj)->stream->params = NULL;
+        /* Not computed in this buffer (the stream was stopped). A change
+           whose target was meanwhile given an audio-rate mul or add is
+           dropped, the later assignment wins. */
+        if (!ev->done && ParamQueue_is_scalar(ev->obj))
+            ParamQueue_swap(ev);
+        ParamQueue_release(self, ev->obj, gil);
+        ParamQueue_release(self, ev->method, gil);
+        ParamQueue_release(self, ev->value, gil);
+    }
+    self->count -= self->due;
+    memmove(self->pending, self->pending + self->due, self->count * sizeof(ParamEvent));
+    self->due = 0;
+}
+
+void
+ParamQueue_compute(PyObject *obj)
+{
+    int i, pos = 0;
+    MYFLT mul, add;
+    Stream *stream = (Stream *)obj;
+    ParamEvent *ev = stream->params;
+    PyoAudioObject *o = (PyoAudioObject *)ev->obj;
+    PyObject *oldmul = o->mul, *oldadd = o->add;
+
+    if (!ParamQueue_is_scalar(ev->obj)) {
+        Stream_callFunction(stream);
+        return;
+    }
+
+    /* Computes the raw signal, then post-processes it one segment at a time. */
+    mul = PyFloat_AS_DOUBLE(oldmul);
+    add = PyFloat_AS_DOUBLE(oldadd);
+    o->mul = ParamQueue_one;
+    o->add = ParamQueue_zero;
+    Stream_callFunction(stream);
+    o->mul = oldmul;
+    o->add = oldadd;
+
+    for (; ev != NULL; ev=ev->next) {
+        for (i=pos; i<ev->offset; i++)
+            o->data[i] = mul * o->data[i] + add;
+        pos = ev->offset;
+        ParamQueue_swap(ev);
+        if (ev->kind == PARAM_MUL)
+            mul = PyFloat_AS_DOUBLE(o->mul);
+        else
+            add = PyFloat_AS_DOUBLE(o->add);
+    }
+    for (i=pos; i<o->bufsize; i++)
+        o->data[i] = mul * o->data[i] + add;
+    stream->constant = 0;
+    stream->numtrigs = -1;
+}
@@ -0,0 +1,312 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pyomodule.h"
+#include "fft.h"
+#include "partconv.h"
+
+/* Spectra are kept as size/2+1 real parts followed by size/2+1 imaginary parts
+ * (null at dc and nyquist), so the complex products run as plain loops. */
+static void
+PartConv_unpack(MYFLT *split, MYFLT *spec, int size2)
+{
+    int k, hsize = size2 / 2;
+    MYFLT *im = spec + hsize + 1;
+
+    for (k=0; k<=hsize; k++)
+        spec[k] = split[k];
+    im[0] = im[hsize] = 0.0;
+    for (k=1; k<hsize; k++)
+        im[k] = split[size2-k];
+}
+
+static void
+PartConv_pack(MYFLT *spec, MYFLT *split, int size2)
+{
+    int k, hsize = size2 / 2;
+    MYFLT *im = spec + hsize + 1;
+
+    for (k=0; k<=hsize; k++)
+        split[k] = spec[k];
+    for (k=1; k<hsize; k++)
+        split[size2-k] = im[k];
+}
+
+PartConv *
+PartConv_new(int blocksize, int length, int delay)
+{
+    PartConv *self;
+
+    if (blocksize < 16 || (blocksize & (blocksize - 1)) != 0)
+        return NULL;
+    if ((length + delay) < PARTCONV_MIN_LENGTH)
+        return NULL;
+
+    self = (PartConv *)calloc(1, sizeof(PartConv));
+    self->size = blocksize;
+    self->size2 = blocksize * 2;
+    self->stride = self->size2 + 2;
+    self->delay = delay;
+    self->length = length + delay;
+    self->parts = (self->length + blocksize - 1) / blocksize;
+    self->current = 0;
+    self->impulse_len = 0;
+
+    self->twiddle = fft_acquire_split_twiddle(self->size2);
+
+    self->impulse = (MYFLT *)calloc(length, sizeof(MYFLT));
+    self->spectra = (MYFLT *)calloc(self->parts * self->stride, sizeof(MYFLT));
+    self->inspectra = (MYFLT *)calloc(self->parts * self->stride, sizeof(MYFLT));
+    self->inframe = (MYFLT *)calloc(self->size2, sizeof(MYFLT));
+    self->frame = (MYFLT *)calloc(self->size2, sizeof(MYFLT));
+    self->accum = (MYFLT *)calloc(self->stride, sizeof(MYFLT));
+    self->outframe = (MYFLT *)calloc(self->size2, sizeof(MYFLT));
+
+    return self;
+}
+
+size_t
+PartConv_getMemory(PartConv *self)
+{
+    if (self == NULL)
+        return 0;
+    return ((size_t)self->length + 2 * (size_t)self->parts * self->stride + 3 * self->size2 + self->stride) * sizeof(MYFLT);
+}
+
+void
+PartConv_free(PartConv *self)
+{
+    if (self == NULL)
+        return;
+    fft_release_table(self->twiddle);
+    free(self->impulse);
+    free(self->spectra);
+    free(self->inspectra);
+    free(self->inframe);
+    free(self->frame);
+    free(self->accum);
+    free(self->outframe);
+    free(self);
+}
+
+void
+PartConv_setImpulse(PartConv *self, MYFLT *impulse, int len)
+{
+    int i, p, index;
+    /* realfft_split scales by 1/size2 and irealfft_split does not scale,
+       the partition spectra carry the compensation. */
+    MYFLT scl = (MYFLT)self->size2;
+
+    if (len > (self->length - self->delay))
+        len = self->length - self->delay;
+    if (len < 0)
+        len = 0;
+
+    memcpy(self->impulse, impulse, len * sizeof(MYFLT));
+    self->impulse_len = len;
+
+    for (p=0; p<self->parts; p++) {
+        for (i=0; i<self->size; i++) {
+            index = p * self->size + i - self->delay;
+            if (index >= 0 && index < len)
+                self->frame[i] = impulse[index] * scl;
+            else
+                self->frame[i] = 0.0;
+        }
+        for (i=self->size; i<self->size2; i++)
+            self->frame[i] = 0.0;
+        realfft_split(self->frame, self->outframe, self->size2, self->twiddle);
+        PartConv_unpack(self->outframe, self->spectra + p * self->stride, self->size2);
+    }
+}
+
+void
+PartConv_checkImpulse(PartConv *self, MYFLT *impulse, int len)
+{
+    if (len > (self->length - self->delay))
+        len = self->length - self->delay;
+
+    if (len != self->impulse_len || memcmp(self->impulse, impulse, len * sizeof(MYFLT)) != 0)
+        PartConv_setImpulse(self, impulse, len);
+}
+
+void
+PartConv_process(PartConv *self, MYFLT *in, MYFLT *out)
+{
+    int i, k, p, slot, nbins;
+    MYFLT *xr, *xi, *hr, *hi, *ar, *ai;
+    int size = self->size;
+    int size2 = self->size2;
+    int hsize1 = size + 1;
+
+    /* Overlap-save frame: previous block followed by the new one. */
+    memcpy(self->inframe, self->inframe + size, size * sizeof(MYFLT));
+    memcpy(self->inframe + size, in, size * sizeof(MYFLT));
+    memcpy(self->frame, self->inframe, size2 * sizeof(MYFLT));
+    realfft_split(self->frame, self->outframe, size2, self->twiddle);
+    PartConv_unpack(self->outframe, self->inspectra + self->current * self->stride, size2);
+
+    ar = self->accum;
+    ai = self->accum + hsize1;
+    nbins = hsize1;
+    memset(self->accum, 0, self->stride * sizeof(MYFLT));
+
+    /* Partition p of the impulse meets the input spectrum of p blocks ago. */
+    slot = self->current;
+    for (p=0; p<self->parts; p++) {
+        xr = self->inspectra + slot * self->stride;
+        xi = xr + hsize1;
+        hr = self->spectra + p * self->stride;
+        hi = hr + hsize1;
+        for (k=0; k<nbins; k++) {
+            ar[k] += xr[k] * hr[k] - xi[k] * hi[k];
+            ai[k] += xr[k] * hi[k] + xi[k] * hr[k];
+        }
+        if (--slot < 0)
+            slot = self->parts - 1;
+    }
+
+    PartConv_pack(self->accum, self->frame, size2);
+    irealfft_split(self->frame, self->outframe, size2, self->twiddle);
+
+    /* The first half wraps around, only the second half is linear. */
+    for (i=0; i<size; i++)
+        out[i] = self->outframe[size + i];
+
+    if (++self->current == self->parts)
+        self->current = 0;
+}
+
+static void
+SplitConv_job(void *data)
+{
+    SplitConv *self = (SplitConv *)data;
+    PartConv_process(self->tail, self->job_in, self->job_out);
+}
+
+SplitConv *
+SplitConv_new(int blocksize, int length)
+{
+    SplitConv *self;
+    int tailsize;
+
+    if (blocksize < 16 || (blocksize & (blocksize - 1)) != 0)
+        return NULL;
+    if (length < PARTCONV_MIN_LENGTH)
+        length = PARTCONV_MIN_LENGTH;
+
+    /* Balances the number of head and tail partitions. */
+    tailsize = blocksize * 2;
+    if (tailsize < (PARTCONV_MIN_LENGTH / 2))
+        tailsize = PARTCONV_MIN_LENGTH / 2;
+    while (tailsize < 65536 && (double)tailsize * tailsize < (double)length * blocksize / 2)
+        tailsize <<= 1;
+
+    self = (SplitConv *)calloc(1, sizeof(SplitConv));
+    self->size = blocksize;
+    self->tailsize = tailsize;
+    self->tailcount = 0;
+
+    if (length > (tailsize * 2 + PARTCONV_MIN_LENGTH)) {
+        self->head = PartConv_new(blocksize, tailsize * 2, 0);
+        self->tail = PartConv_new(tailsize, length - tailsize * 2, 0);
+        self->tail_in = (MYFLT *)calloc(tailsize, sizeof(MYFLT));
+        self->tail_out = (MYFLT *)calloc(tailsize, sizeof(MYFLT));
+        self->job_in = (MYFLT *)calloc(tailsize, sizeof(MYFLT));
+        self->job_out = (MYFLT *)calloc(tailsize, sizeof(MYFLT));
+        self->helper = HelperThread_new(SplitConv_job, (void *)self);
+    }
+    else
+        self->head = PartConv_new(blocksize, length, 0);
+
+    return self;
+}
+
+size_t
+SplitConv_getMemory(SplitConv *self)
+{
+    if (self == NULL)
+        return 0;
+    return PartConv_getMemory(self->head) + PartConv_getMemory(self->tail) +
+           (self->tail != NULL ? 4 * (size_t)self->tailsize * sizeof(MYFLT) : 0);
+}
+
+void
+SplitConv_free(SplitConv *self)
+{
+    if (self == NULL)
+        return;
+    if (self->helper != NULL)
+        HelperThread_free(self->helper);
+    PartConv_free(self->head);
+    PartConv_free(self->tail);
+    free(self->tail_in);
+    free(self->tail_out);
+    free(self->job_in);
+    free(self->job_out);
+    free(self);
+}
+
+void
+SplitConv_setImpulse(SplitConv *self, MYFLT *impulse, int len)
+{
+    int headlen = self->head->length - self->head->delay;
+
+    PartConv_setImpulse(self->head, impulse, len < headlen ? len : headlen);
+    if (self->tail != NULL) {
+        if (self->helper != NULL)
+            HelperThread_wait(self->helper);
+        PartConv_setImpulse(self->tail, impulse + headlen, len > headlen ? len - headlen : 0);
+    }
+}
+
+void
+SplitConv_process(SplitConv *self, MYFLT *in, MYFLT *out)
+{
+    int i;
+    MYFLT *tmp, *tail;
+
+    PartConv_process(self->head, in, out);
+
+    if (self->tail == NULL)
+        return;
+
+    /* The tail block played was computed from the input of two blocks ago. */
+    tail = self->tail_out + self->tailcount;
+    for (i=0; i<self->size; i++)
+        out[i] += tail[i];
+    memcpy(self->tail_in + self->tailcount, in, self->size * sizeof(MYFLT));
+
+    self->tailcount += self->size;
+    if (self->tailcount == self->tailsize) {
+        self->tailcount = 0;
+        if (self->helper != NULL)
+            HelperThread_wait(self->helper);
+        tmp = self->tail_out; self->tail_out = self->job_out; self->job_out = tmp;
+        tmp = self->tail_in; self->tail_in = self->job_in; self->job_in = tmp;
+        if (self->helper != NULL)
+            HelperThread_post(self->helper);
+        else
+            SplitConv_job((void *)self);
+    }
+}
@@ -0,0 +1,170 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdint.h>
+#include <string.h>
+#include "powkernel.h"
+
+/* log2(m) = 2 / ln(2) * atanh(t), t = (m - 1) / (m + 1), is an odd series
+ * in t and 2^f = exp(f * ln(2)) a Taylor series in f. With m between
+ * sqrt(2) / 2 and sqrt(2), and f between -0.5 and 0.5, the terms below
+ * reach the precision of MYFLT. */
+#if defined(USE_DOUBLE)
+typedef uint64_t powbits;
+#define POW_MANTISSA 52
+#define POW_SQRT_HALF 0x3FE6A09E667F3BCDULL
+#define POW_BIAS 1023
+#define POW_MIN_BITS 0x0010000000000000ULL /* smallest normal number */
+#define POW_LOG2(t, t2) ((t) * (2.8853900817779268 + (t2) * (0.9617966939259757 + (t2) * (0.5770780163555853 + \
+    (t2) * (0.41219858311113244 + (t2) * (0.3205988979753252 + (t2) * (0.2623081892525388 + \
+    (t2) * (0.2219530832136867 + (t2) * (0.19235933878519512 + (t2) * (0.16972882833987804 + \
+    (t2) * 0.15186263588304877))))))))))
+#define POW_EXP2(f) (1.0 + (f) * (0.6931471805599453 + (f) * (0.2402265069591007 + (f) * (0.055504108664821576 + \
+    (f) * (0.009618129107628477 + (f) * (0.0013333558146428441 + (f) * (0.00015403530393381606 + \
+    (f) * (1.5252733804059838e-05 + (f) * (1.3215486790144305e-06 + (f) * (1.0178086009239696e-07 + \
+    (f) * (7.054911620801121e-09 + (f) * (4.44553827187081e-10 + (f) * (2.5678435993488196e-11 + \
+    (f) * 1.3691488853904124e-12)))))))))))))
+#else
+typedef uint32_t powbits;
+#define POW_MANTISSA 23
+#define POW_SQRT_HALF 0x3F3504F3U
+#define POW_BIAS 127
+#define POW_MIN_BITS 0x00800000U /* smallest normal number */
+#define POW_LOG2(t, t2) ((t) * (2.8853900817779268f + (t2) * (0.9617966939259757f + (t2) * (0.5770780163555853f + \
+    (t2) * (0.41219858311113244f + (t2) * 0.3205988979753252f)))))
+#define POW_EXP2(f) (1.0f + (f) * (0.6931471805599453f + (f) * (0.2402265069591007f + (f) * (0.055504108664821576f + \
+    (f) * (0.009618129107628477f + (f) * (0.0013333558146428441f + (f) * (0.00015403530393381606f + \
+    (f) * 1.5252733804059838e-05f)))))))
+#endif
+
+#define POW_ONE ((powbits)POW_BIAS << POW_MANTISSA)
+
+/* log2 of a normal positive x. Subtracting the bits of sqrt(2) / 2 before
+ * taking the exponent leaves a mantissa between sqrt(2) / 2 and sqrt(2).
+ * The exponent is biased to stay positive, integers are 32 bits wherever
+ * possible, SSE2 has no 64 bits conversions. */
+static inline MYFLT
+PowKernel_log2(MYFLT x)
+{
+    powbits u, b;
+    int k;
+    MYFLT m, t;
+
+    memcpy(&u, &x, sizeof(MYFLT));
+    b = (u - POW_SQRT_HALF + POW_ONE) >> POW_MANTISSA;
+    k = (int)b - POW_BIAS;
+    u -= (powbits)(POW_BIAS + k) << POW_MANTISSA;
+    u += POW_ONE;
+    memcpy(&m, &u, sizeof(MYFLT));
+    t = (m - 1) / (m + 1);
+    return (MYFLT)k + POW_LOG2(t, t * t);
+}
+
+/* 2^y for y below POW_BIAS, flushed to 0 below the smallest normal number,
+ * or when `zero` is 0. The selections work on the bits, since gcc leaves
+ * the comparisons of floats as branches under the default trapping math. */
+static inline MYFLT
+PowKernel_exp2(MYFLT y, powbits zero)
+{
+    powbits bits;
+    int k;
+    MYFLT f, scale, val;
+
+    /* Rounds y to the nearest integer, the sum is positive when it counts. */
+    k = (int)(y + (MYFLT)(POW_BIAS + 0.5)) - POW_BIAS;
+    zero &= k < 2 - POW_BIAS ? 0 : ~(powbits)0;
+    k = k < 2 - POW_BIAS ? 2 - POW_BIAS : k;
+    f = y - (MYFLT)k;
+    bits = (powbits)(k + POW_BIAS) << POW_MANTISSA;
+    memcpy(&scale, &bits, sizeof(MYFLT));
+    val = POW_EXP2(f) * scale;
+    memcpy(&bits, &val, sizeof(MYFLT));
+    bits &= zero;
+    memcpy(&val, &bits, sizeof(MYFLT));
+    return val;
+}
+
+/* x^e for 0 <= x <= 1. */
+static inline MYFLT
+PowKernel_pow(MYFLT x, MYFLT e)
+{
+    powbits u;
+
+    memcpy(&u, &x, sizeof(MYFLT));
+    return PowKernel_exp2(e * PowKernel_log2(x), u < POW_MIN_BITS ? 0 : ~(powbits)0);
+}
+
+void
+PowKernel_process(MYFLT *x, MYFLT *e, MYFLT ce, MYFLT *out, int num)
+{
+    int i;
+
+#if defined(USE_DOUBLE) && !defined(__AVX2__)
+    /* Without 64 bits integer vectors, the loops stay scalar and libm is
+     * faster. */
+    for (i=0; i<num; i++) {
+        out[i] = MYPOW(x[i], e == NULL ? ce : e[i]);
+    }
+#else
+    if (e == NULL) {
+        for (i=0; i<num; i++) {
+            out[i] = PowKernel_pow(x[i], ce);
+        }
+    }
+    else {
+        for (i=0; i<num; i++) {
+            out[i] = PowKernel_pow(x[i], e[i]);
+        }
+    }
+#endif
+}
+
+void
+PowKernel_log(MYFLT *x, MYFLT *out, int num)
+{
+    int i;
+
+#if defined(USE_DOUBLE) && !defined(__AVX2__)
+    for (i=0; i<num; i++) {
+        out[i] = MYLOG(x[i]);
+    }
+#else
+    for (i=0; i<num; i++) {
+        out[i] = PowKernel_log2(x[i]) * (MYFLT)0.6931471805599453;
+    }
+#endif
+}
+
+void
+PowKernel_exp(MYFLT *x, MYFLT *out, int num)
+{
+    int i;
+
+#if defined(USE_DOUBLE) && !defined(__AVX2__)
+    for (i=0; i<num; i++) {
+        out[i] = MYEXP(x[i]);
+    }
+#else
+    for (i=0; i<num; i++) {
+        out[i] = PowKernel_exp2(x[i] * (MYFLT)1.4426950408889634, ~(powbits)0);
+    }
+#endif
+}
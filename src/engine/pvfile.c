@@ -0,0 +1,212 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "pvfile.h"
+
+#define PVFILE_NUMFRAMES_OFFSET 32
+
+static int
+PVFile_parseHeader(PVFile *self, unsigned char *header, size_t length)
+{
+    int32_t fields[5];
+    int64_t numFrames;
+    long available;
+
+    if (length < PVFILE_HEADER_SIZE || memcmp(header, "PYPV", 4) != 0)
+        return -1;
+    memcpy(fields, header + 4, sizeof(fields));
+    memcpy(&self->sr, header + 24, sizeof(double));
+    memcpy(&numFrames, header + PVFILE_NUMFRAMES_OFFSET, sizeof(int64_t));
+    if (fields[0] != PVFILE_VERSION || fields[3] < 1 || fields[3] != fields[1] / 2)
+        return -1;
+    self->fftsize = fields[1];
+    self->olaps = fields[2];
+    self->hsize = fields[3];
+
+    /* A file whose writer didn't complete keeps the frames written. */
+    available = (long)((length - PVFILE_HEADER_SIZE) / (2 * self->hsize * sizeof(float)));
+    if (numFrames <= 0 || numFrames > available)
+        numFrames = available;
+    self->numFrames = (long)numFrames;
+    return self->numFrames > 0 ? 0 : -1;
+}
+
+PVFile *
+PVFile_open(const char *path)
+{
+    PVFile *self = (PVFile *)calloc(1, sizeof(PVFile));
+#ifndef _WIN32
+    int fd;
+    struct stat st;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        free(self);
+        return NULL;
+    }
+    if (fstat(fd, &st) < 0 || st.st_size < PVFILE_HEADER_SIZE) {
+        close(fd);
+        free(self);
+        return NULL;
+    }
+    self->maplength = (size_t)st.st_size;
+    self->map = mmap(NULL, self->maplength, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (self->map == MAP_FAILED) {
+        free(self);
+        return NULL;
+    }
+    self->mapped = 1;
+    /* Playback jumps anywhere in the file, read-ahead would be wasted. */
+    madvise(self->map, self->maplength, MADV_RANDOM);
+#else
+    FILE *fp;
+    long length;
+
+    fp = fopen(path, "rb");
+    if (fp == NULL) {
+        free(self);
+        return NULL;
+    }
+    fseek(fp, 0, SEEK_END);
+    length = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if (length < PVFILE_HEADER_SIZE) {
+        fclose(fp);
+        free(self);
+        return NULL;
+    }
+    self->maplength = (size_t)length;
+    self->map = malloc(self->maplength);
+    if (self->map == NULL || fread(self->map, 1, self->maplength, fp) != self->maplength) {
+        fclose(fp);
+        free(self->map);
+        free(self);
+        return NULL;
+    }
+    fclose(fp);
+    self->mapped = 0;
+#endif
+
+    if (PVFile_parseHeader(self, (unsigned char *)self->map, self->maplength) < 0) {
+        PVFile_close(self);
+        return NULL;
+    }
+    self->data = (float *)((char *)self->map + PVFILE_HEADER_SIZE);
+    return self;
+}
+
+void
+PVFile_close(PVFile *self)
+{
+    if (self == NULL)
+        return;
+#ifndef _WIN32
+    if (self->mapped)
+        munmap(self->map, self->maplength);
+#else
+    free(self->map);
+#endif
+    free(self);
+}
+
+PVFileWriter *
+PVFileWriter_new(const char *path, int fftsize, int olaps, double sr)
+{
+    unsigned char header[PVFILE_HEADER_SIZE];
+    int32_t fields[5];
+    int64_t numFrames = 0;
+    PVFileWriter *self;
+
+    if (fftsize < 2)
+        return NULL;
+    self = (PVFileWriter *)calloc(1, sizeof(PVFileWriter));
+    self->fp = fopen(path, "wb");
+    if (self->fp == NULL) {
+        free(self);
+        return NULL;
+    }
+    self->hsize = fftsize / 2;
+    self->numFrames = 0;
+    self->frame = (float *)malloc(2 * self->hsize * sizeof(float));
+
+    fields[0] = PVFILE_VERSION;
+    fields[1] = fftsize;
+    fields[2] = olaps;
+    fields[3] = self->hsize;
+    fields[4] = 0;
+    memset(header, 0, PVFILE_HEADER_SIZE);
+    memcpy(header, "PYPV", 4);
+    memcpy(header + 4, fields, sizeof(fields));
+    memcpy(header + 24, &sr, sizeof(double));
+    memcpy(header + PVFILE_NUMFRAMES_OFFSET, &numFrames, sizeof(int64_t));
+    if (fwrite(header, 1, PVFILE_HEADER_SIZE, self->fp) != PVFILE_HEADER_SIZE) {
+        fclose(self->fp);
+        free(self->frame);
+        free(self);
+        return NULL;
+    }
+    return self;
+}
+
+int
+PVFileWriter_write(PVFileWriter *self, MYFLT *magn, MYFLT *freq)
+{
+    int i, hsize = self->hsize;
+
+    for (i=0; i<hsize; i++) {
+        self->frame[i] = (float)magn[i];
+        self->frame[hsize+i] = (float)freq[i];
+    }
+    if (fwrite(self->frame, sizeof(float), 2 * hsize, self->fp) != (size_t)(2 * hsize))
+        return -1;
+    self->numFrames++;
+    return 0;
+}
+
+int
+PVFileWriter_close(PVFileWriter *self)
+{
+    int err = 0;
+    int64_t numFrames;
+
+    if (self == NULL)
+        return -1;
+    numFrames = self->numFrames;
+    if (fseek(self->fp, PVFILE_NUMFRAMES_OFFSET, SEEK_SET) != 0 ||
+        fwrite(&numFrames, sizeof(int64_t), 1, self->fp) != 1)
+        err = -1;
+    if (fclose(self->fp) != 0)
+        err = -1;
+    free(self->frame);
+    free(self);
+    return err;
+}
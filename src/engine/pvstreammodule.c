@@ -34,30 +34,41 @@ PVStream_dealloc(PVStream* self)
 {
     self->magn = NULL;
     self->freq = NULL;
+    self->shared = NULL;
+    pyo_aligned_free(self->frames);
+    free(self->rows);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 int
 PVStream_getFFTsize(PVStream *self)
 {
+    if (self->shared != NULL)
+        return PVStream_getFFTsize(self->shared);
     return self->fftsize;
 }
 
 int
 PVStream_getOlaps(PVStream *self)
 {
+    if (self->shared != NULL)
+        return PVStream_getOlaps(self->shared);
     return self->olaps;
 }
 
 MYFLT **
 PVStream_getMagn(PVStream *self)
 {
+    if (self->shared != NULL)
+        return PVStream_getMagn(self->shared);
     return (MYFLT **)self->magn;
 }
 
 MYFLT **
 PVStream_getFreq(PVStream *self)
 {
+    if (self->shared != NULL)
+        return PVStream_getFreq(self->shared);
     return (MYFLT **)self->freq;
 }
 
@@ -97,6 +108,56 @@ PVStream_setCount(PVStream *self, int *data)
     self->count = data;
 }
 
+void
+PVStream_beginFrame(PVStream *self, int overcount, unsigned long stamp)
+{
+    self->overcount = overcount;
+    self->stamp = stamp;
+}
+
+void
+PVStream_allocFrames(PVStream *self, int fftsize, int olaps)
+{
+    int i, hsize = fftsize / 2;
+    int stride = PYO_ALIGN_FRAMES(hsize);
+
+    pyo_aligned_free(self->frames);
+    self->frames = (MYFLT *)pyo_aligned_calloc(2 * olaps * stride * sizeof(MYFLT));
+    self->rows = (MYFLT **)realloc(self->rows, 2 * olaps * sizeof(MYFLT *));
+    for (i=0; i<(2*olaps); i++)
+        self->rows[i] = self->frames + i * stride;
+
+    self->shared = NULL;
+    self->fftsize = fftsize;
+    self->olaps = olaps;
+    self->magn = self->rows;
+    self->freq = self->rows + olaps;
+}
+
+size_t
+PVStream_getMemory(PVStream *self)
+{
+    if (self->frames == NULL)
+        return 0;
+    return 2 * (size_t)self->olaps * (PYO_ALIGN_FRAMES(self->fftsize / 2) * sizeof(MYFLT) + sizeof(MYFLT *));
+}
+
+int
+PVStream_shareFrames(PVStream *self, PVStream *input)
+{
+    /* Only the producer and the caller hold a reference on `input`. */
+    if (input != NULL && Py_REFCNT(input) == 2 && PVStream_getFFTsize(input) == self->fftsize &&
+        PVStream_getOlaps(input) == self->olaps && input->stamp == self->stamp &&
+        input->overcount == self->overcount) {
+        self->shared = input;
+        return 1;
+    }
+    else {
+        self->shared = NULL;
+        return 0;
+    }
+}
+
 PyTypeObject PVStreamType = {
     PyObject_HEAD_INIT(NULL)
     0, /*ob_size*/
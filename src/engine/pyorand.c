@@ -0,0 +1,221 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include "pyomodule.h"
+#include "powkernel.h"
+#include "sinekernel.h"
+
+/* splitmix64, spreads a small seed over the states. */
+static uint64_t
+PyoRand_mix(uint64_t *x)
+{
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void
+PyoRand_seed(PyoRand *r, unsigned int seed)
+{
+    int i, j;
+    uint64_t z, x = seed;
+
+    for (i=0; i<4; i+=2) {
+        z = PyoRand_mix(&x);
+        r->s[i] = (uint32_t)z;
+        r->s[i+1] = (uint32_t)(z >> 32);
+    }
+    for (j=0; j<PYORAND_LANES; j++) {
+        for (i=0; i<4; i+=2) {
+            z = PyoRand_mix(&x);
+            r->lanes[i][j] = (uint32_t)z;
+            r->lanes[i+1][j] = (uint32_t)(z >> 32);
+        }
+    }
+}
+
+/* One step of every lane, the results go in `out`. */
+static inline void
+PyoRand_step(PyoRand *r, uint32_t *out)
+{
+    int j;
+    uint32_t t;
+    uint32_t *s0 = r->lanes[0], *s1 = r->lanes[1], *s2 = r->lanes[2], *s3 = r->lanes[3];
+
+    for (j=0; j<PYORAND_LANES; j++) {
+        out[j] = PYORAND_ROTL(s0[j] + s3[j], 7) + s0[j];
+        t = s1[j] << 9;
+        s2[j] ^= s0[j];
+        s3[j] ^= s1[j];
+        s1[j] ^= s2[j];
+        s0[j] ^= s3[j];
+        s2[j] ^= t;
+        s3[j] = PYORAND_ROTL(s3[j], 11);
+    }
+}
+
+void
+PyoRand_fill(PyoRand *r, MYFLT *data, MYFLT mul, MYFLT add, int size)
+{
+    int i, j;
+    uint32_t out[PYORAND_LANES];
+
+    for (i=0; i<=size-PYORAND_LANES; i+=PYORAND_LANES) {
+        PyoRand_step(r, out);
+        for (j=0; j<PYORAND_LANES; j++) {
+            data[i+j] = PYORAND_TO_UNIFORM(out[j]) * mul + add;
+        }
+    }
+    if (i < size) {
+        PyoRand_step(r, out);
+        for (j=0; i<size; i++, j++) {
+            data[i] = PYORAND_TO_UNIFORM(out[j]) * mul + add;
+        }
+    }
+}
+
+/* Values per pass of PyoRand_distribution, held on the stack. */
+#define PYORAND_CHUNK 64
+/* Lower bound of the logarithms, the uniform numbers may be 0. */
+#define PYORAND_TINY 1e-30
+
+static void
+PyoRand_distributionChunk(PyoRand *r, int type, MYFLT *x1, MYFLT *x2, MYFLT *out, int num)
+{
+    int i, k;
+    MYFLT a[PYORAND_CHUNK], b[PYORAND_CHUNK], p, val;
+
+    switch (type) {
+        case PYORAND_LINEAR_MIN:
+            PyoRand_fill(r, a, 1.0, 0.0, num);
+            PyoRand_fill(r, b, 1.0, 0.0, num);
+            for (i=0; i<num; i++) {
+                out[i] = a[i] < b[i] ? a[i] : b[i];
+            }
+            break;
+        case PYORAND_LINEAR_MAX:
+            PyoRand_fill(r, a, 1.0, 0.0, num);
+            PyoRand_fill(r, b, 1.0, 0.0, num);
+            for (i=0; i<num; i++) {
+                out[i] = a[i] > b[i] ? a[i] : b[i];
+            }
+            break;
+        case PYORAND_TRIANGLE:
+            PyoRand_fill(r, a, 0.5, 0.0, num);
+            PyoRand_fill(r, b, 0.5, 0.0, num);
+            for (i=0; i<num; i++) {
+                out[i] = a[i] + b[i];
+            }
+            break;
+        case PYORAND_EXPON_MIN:
+        case PYORAND_EXPON_MAX:
+            PyoRand_fill(r, a, 1.0, 0.0, num);
+            for (i=0; i<num; i++) {
+                a[i] = a[i] < PYORAND_TINY ? PYORAND_TINY : a[i];
+            }
+            PowKernel_log(a, a, num);
+            for (i=0; i<num; i++) {
+                p = x1[i] <= 0.0 ? 0.00001 : x1[i];
+                val = -a[i] / p;
+                out[i] = type == PYORAND_EXPON_MIN ? val : 1.0 - val;
+            }
+            break;
+        case PYORAND_BIEXPON:
+            /* The sign is drawn with the magnitude, a uniform number over
+             * [0, 2) folded over [0, 1]. */
+            PyoRand_fill(r, a, 2.0, 0.0, num);
+            for (i=0; i<num; i++) {
+                val = 2.0 - a[i];
+                b[i] = val < a[i] ? -1.0 : 1.0;
+                val = val < a[i] ? val : a[i];
+                a[i] = val < PYORAND_TINY ? PYORAND_TINY : val;
+            }
+            PowKernel_log(a, a, num);
+            for (i=0; i<num; i++) {
+                p = x1[i] <= 0.0 ? 0.00001 : x1[i];
+                out[i] = 0.5 * (b[i] * a[i] / p) + 0.5;
+            }
+            break;
+        case PYORAND_CAUCHY:
+            /* tan(x) = sin(x) / cos(x), the kernel works in cycles. */
+            PyoRand_fill(r, a, 1.0 / TWOPI, 0.0, num);
+            PyoRand_fill(r, out, 1.0, 0.0, num);
+            for (i=0; i<num; i++) {
+                b[i] = a[i] + 0.25;
+            }
+            SineKernel_process(a, a, num, SINE_ACCURACY_HIGH);
+            SineKernel_process(b, b, num, SINE_ACCURACY_HIGH);
+            for (i=0; i<num; i++) {
+                p = out[i] < 0.5 ? -x1[i] : x1[i];
+                out[i] = 0.5 * (a[i] / b[i] * p) + 0.5;
+            }
+            break;
+        case PYORAND_WEIBULL:
+            /* x1 * log(1 / (1 - u))^(1 / x2) as exp(log(-log(1 - u)) / x2). */
+            PyoRand_fill(r, a, -1.0, 1.0, num);
+            PowKernel_log(a, a, num);
+            for (i=0; i<num; i++) {
+                a[i] = a[i] > -PYORAND_TINY ? PYORAND_TINY : -a[i];
+            }
+            PowKernel_log(a, a, num);
+            for (i=0; i<num; i++) {
+                p = x2[i] <= 0.0 ? 0.00001 : x2[i];
+                val = a[i] / p;
+                a[i] = val > 80.0 ? 80.0 : val;
+            }
+            PowKernel_exp(a, a, num);
+            for (i=0; i<num; i++) {
+                out[i] = x1[i] * a[i];
+            }
+            break;
+        case PYORAND_GAUSSIAN:
+            PyoRand_fill(r, a, 1.0, 0.0, num);
+            for (k=1; k<6; k++) {
+                PyoRand_fill(r, b, 1.0, 0.0, num);
+                for (i=0; i<num; i++) {
+                    a[i] += b[i];
+                }
+            }
+            for (i=0; i<num; i++) {
+                out[i] = x2[i] * (a[i] - 3.0) * 0.33 + x1[i];
+            }
+            break;
+        default:
+            PyoRand_fill(r, out, 1.0, 0.0, num);
+            break;
+    }
+
+    for (i=0; i<num; i++) {
+        val = out[i];
+        out[i] = val < 0.0 ? 0.0 : (val > 1.0 ? 1.0 : val);
+    }
+}
+
+void
+PyoRand_distribution(PyoRand *r, int type, MYFLT *x1, MYFLT *x2, MYFLT *out, int num)
+{
+    int i, n;
+
+    for (i=0; i<num; i+=n) {
+        n = num - i < PYORAND_CHUNK ? num - i : PYORAND_CHUNK;
+        PyoRand_distributionChunk(r, type, x1 + i, x2 + i, out + i, n);
+    }
+}
@@ -0,0 +1,296 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <math.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "resampler.h"
+#include "simd.h"
+
+/* Zero crossings of the sinc on each side, Kaiser window parameter and
+ * cutoff, for each quality. Quality 2 gives about 80 dB of stopband
+ * attenuation. */
+static const struct {
+    int zeros;
+    double beta;
+    double rolloff;
+} Resampler_qualities[RESAMPLER_QUALITIES] = {
+    {4, 5.0, 0.85},
+    {8, 6.5, 0.9},
+    {16, 8.0, 0.95},
+    {32, 10.0, 0.97}
+};
+
+/* Output samples computed by each thread at least. */
+#define RESAMPLER_MIN_SLICE 4096
+
+/* Modified Bessel function of the first kind, order 0. */
+static double
+Resampler_bessel(double x)
+{
+    int k;
+    double term = 1.0, sum = 1.0, y = x * x / 4.0;
+
+    for (k=1; k<64 && term > sum * 1e-12; k++) {
+        term *= y / ((double)k * k);
+        sum += term;
+    }
+    return sum;
+}
+
+Resampler *
+Resampler_newFilter(double insr, double outsr, int zeros, double beta, double rolloff)
+{
+    int p, k, half;
+    double cutoff, width, x, w, norm;
+    MYFLT *phase;
+    Resampler *self;
+
+    if (insr <= 0 || outsr <= 0 || zeros < 1)
+        return NULL;
+
+    self = (Resampler *)malloc(sizeof(Resampler));
+    self->insr = insr;
+    self->outsr = outsr;
+    self->step = insr / outsr;
+    /* Cutoff, relative to the input Nyquist frequency. */
+    cutoff = (outsr < insr ? outsr / insr : 1.0) * rolloff;
+    half = (int)ceil(zeros / cutoff);
+    self->taps = 2 * half;
+    width = half;
+    self->coeffs = (MYFLT *)malloc((RESAMPLER_PHASES + 1) * self->taps * sizeof(MYFLT));
+
+    norm = 1.0 / Resampler_bessel(beta);
+    for (p=0; p<=RESAMPLER_PHASES; p++) {
+        phase = self->coeffs + p * self->taps;
+        for (k=0; k<self->taps; k++) {
+            /* Distance, in input samples, between tap k and the output position. */
+            x = (k - half + 1) - (double)p / RESAMPLER_PHASES;
+            if (fabs(x) >= width)
+                w = 0.0;
+            else
+                w = Resampler_bessel(beta * sqrt(1.0 - (x / width) * (x / width))) * norm;
+            if (x == 0.0)
+                phase[k] = (MYFLT)(cutoff * w);
+            else
+                phase[k] = (MYFLT)(sin(PI * cutoff * x) / (PI * x) * w);
+        }
+    }
+
+    return self;
+}
+
+Resampler *
+Resampler_new(double insr, double outsr, int quality)
+{
+    if (quality < 0)
+        quality = 0;
+    else if (quality >= RESAMPLER_QUALITIES)
+        quality = RESAMPLER_QUALITIES - 1;
+
+    return Resampler_newFilter(insr, outsr, Resampler_qualities[quality].zeros,
+                               Resampler_qualities[quality].beta,
+                               Resampler_qualities[quality].rolloff);
+}
+
+void
+Resampler_free(Resampler *self)
+{
+    if (self == NULL)
+        return;
+    free(self->coeffs);
+    free(self);
+}
+
+long
+Resampler_getOutputSize(Resampler *self, long insize)
+{
+    return (long)ceil(insize / self->step);
+}
+
+void
+Resampler_getInputRange(Resampler *self, long start, long num, long *first, long *last)
+{
+    int half = self->taps / 2;
+
+    *first = (long)(start * self->step) - half + 1;
+    *last = (long)((start + num - 1) * self->step) + half + 1;
+}
+
+/* Dot products of the input with two adjacent phases. */
+static inline void
+Resampler_dot(MYFLT *c0, MYFLT *c1, MYFLT *x, int taps, MYFLT *a, MYFLT *b)
+{
+    int k = 0;
+    MYFLT sa = 0.0, sb = 0.0;
+#ifdef VSIZE
+    int j;
+    MYFLT ta[VSIZE], tb[VSIZE];
+    VTYPE va = VSET1(0.0), vb = VSET1(0.0), vx;
+
+    for (; k<=taps-VSIZE; k+=VSIZE) {
+        vx = VLOAD(x + k);
+        va = VADD(va, VMUL(VLOAD(c0 + k), vx));
+        vb = VADD(vb, VMUL(VLOAD(c1 + k), vx));
+    }
+    VSTORE(ta, va);
+    VSTORE(tb, vb);
+    for (j=0; j<VSIZE; j++) {
+        sa += ta[j];
+        sb += tb[j];
+    }
+#endif
+    for (; k<taps; k++) {
+        sa += c0[k] * x[k];
+        sb += c1[k] * x[k];
+    }
+    *a = sa;
+    *b = sb;
+}
+
+MYFLT
+Resampler_interpolate(Resampler *self, MYFLT *in, long index, MYFLT frac)
+{
+    int p;
+    MYFLT a, b, f, *c0;
+
+    f = frac * RESAMPLER_PHASES;
+    p = (int)f;
+    if (p >= RESAMPLER_PHASES)
+        p = RESAMPLER_PHASES - 1;
+    f -= p;
+    c0 = self->coeffs + p * self->taps;
+    Resampler_dot(c0, c0 + self->taps, in + index - self->taps / 2 + 1, self->taps, &a, &b);
+    return a + (b - a) * f;
+}
+
+void
+Resampler_processBlock(Resampler *self, MYFLT *in, long inoffset, long insize, MYFLT *out, long start, long num)
+{
+    int k, p, taps = self->taps, half = self->taps / 2;
+    long n, i, first;
+    double pos, frac;
+    MYFLT a, b, f, *c0, *c1;
+
+    for (n=0; n<num; n++) {
+        pos = (start + n) * self->step;
+        i = (long)pos;
+        frac = (pos - i) * RESAMPLER_PHASES;
+        p = (int)frac;
+        f = (MYFLT)(frac - p);
+        c0 = self->coeffs + p * taps;
+        c1 = c0 + taps;
+        /* First tap, relative to `in`. */
+        first = i - half + 1 - inoffset;
+        if (first >= 0 && first + taps <= insize) {
+            Resampler_dot(c0, c1, in + first, taps, &a, &b);
+        }
+        else {
+            a = b = 0.0;
+            for (k=0; k<taps; k++) {
+                if ((first + k) >= 0 && (first + k) < insize) {
+                    a += c0[k] * in[first + k];
+                    b += c1[k] * in[first + k];
+                }
+            }
+        }
+        out[n] = a + (b - a) * f;
+    }
+}
+
+void
+Resampler_process(Resampler *self, MYFLT *in, long insize, MYFLT *out, long outsize)
+{
+    Resampler_processBlock(self, in, 0, insize, out, 0, outsize);
+}
+
+typedef struct {
+    Resampler *resampler;
+    MYFLT *in;
+    long inoffset;
+    long insize;
+    MYFLT *out;
+    long start;
+    long num;
+} ResamplerSlice;
+
+static void *
+Resampler_runSlice(void *arg)
+{
+    ResamplerSlice *slice = (ResamplerSlice *)arg;
+
+    Resampler_processBlock(slice->resampler, slice->in, slice->inoffset, slice->insize,
+                           slice->out, slice->start, slice->num);
+    return NULL;
+}
+
+void
+Resampler_processThreaded(Resampler *self, MYFLT *in, long inoffset, long insize, MYFLT *out, long start, long num, int threads)
+{
+    int i, numThreads = 0;
+    long len, pos = 0;
+    pthread_t *handles;
+    ResamplerSlice *slices;
+
+    if (threads <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (threads <= 0)
+            threads = 4;
+    }
+    if (threads > num / RESAMPLER_MIN_SLICE)
+        threads = (int)(num / RESAMPLER_MIN_SLICE);
+    if (threads <= 1) {
+        Resampler_processBlock(self, in, inoffset, insize, out, start, num);
+        return;
+    }
+
+    handles = (pthread_t *)malloc(threads * sizeof(pthread_t));
+    slices = (ResamplerSlice *)malloc(threads * sizeof(ResamplerSlice));
+    len = (num + threads - 1) / threads;
+    /* The last slice is computed on the calling thread. */
+    for (i=0; i<threads; i++) {
+        slices[i].resampler = self;
+        slices[i].in = in;
+        slices[i].inoffset = inoffset;
+        slices[i].insize = insize;
+        slices[i].out = out + pos;
+        slices[i].start = start + pos;
+        slices[i].num = len < (num - pos) ? len : (num - pos);
+        pos += slices[i].num;
+        if (i == (threads - 1) || pthread_create(&handles[i], NULL, Resampler_runSlice, &slices[i]) != 0) {
+            /* Computes the rest here. */
+            slices[i].num += num - pos;
+            Resampler_runSlice(&slices[i]);
+            break;
+        }
+        numThreads++;
+    }
+    for (i=0; i<numThreads; i++) {
+        pthread_join(handles[i], NULL);
+    }
+    free(handles);
+    free(slices);
+}
@@ -0,0 +1,118 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include "samplecache.h"
+
+static pthread_mutex_t samplecache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static SampleCache *samplecache_list = NULL;
+
+/* Modification time and length of the file, the entries of an older
+ * version are not reused. */
+static int
+SampleCache_stat(const char *path, long *mtime, long *length)
+{
+    struct stat st;
+
+    if (stat(path, &st) < 0)
+        return -1;
+    *mtime = (long)st.st_mtime;
+    *length = (long)st.st_size;
+    return 0;
+}
+
+SampleCache *
+SampleCache_find(const char *path, int chnl, long start, long frames, int sndSr)
+{
+    long mtime, length;
+    SampleCache *entry;
+
+    if (SampleCache_stat(path, &mtime, &length) < 0)
+        return NULL;
+
+    pthread_mutex_lock(&samplecache_mutex);
+    for (entry=samplecache_list; entry!=NULL; entry=entry->next) {
+        if (entry->chnl == chnl && entry->start == start && entry->frames == frames && entry->sndSr == sndSr &&
+            entry->mtime == mtime && entry->length == length && strcmp(entry->path, path) == 0) {
+            entry->refcount++;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&samplecache_mutex);
+
+    return entry;
+}
+
+SampleCache *
+SampleCache_insert(const char *path, int chnl, long start, long frames, int sndSr,
+                   MYFLT *data, long size)
+{
+    SampleCache *entry;
+
+    entry = (SampleCache *)malloc(sizeof(SampleCache));
+    entry->data = data;
+    entry->size = size;
+    entry->sndSr = sndSr;
+    entry->path = strdup(path);
+    entry->chnl = chnl;
+    entry->start = start;
+    entry->frames = frames;
+    entry->refcount = 1;
+    /* An entry that can't be checked against the file is never found. */
+    if (SampleCache_stat(path, &entry->mtime, &entry->length) < 0)
+        entry->length = -1;
+
+    pthread_mutex_lock(&samplecache_mutex);
+    entry->next = samplecache_list;
+    samplecache_list = entry;
+    pthread_mutex_unlock(&samplecache_mutex);
+
+    return entry;
+}
+
+void
+SampleCache_release(SampleCache *self)
+{
+    SampleCache **entry;
+
+    if (self == NULL)
+        return;
+
+    pthread_mutex_lock(&samplecache_mutex);
+    if (--self->refcount > 0) {
+        pthread_mutex_unlock(&samplecache_mutex);
+        return;
+    }
+    for (entry=&samplecache_list; *entry!=NULL; entry=&(*entry)->next) {
+        if (*entry == self) {
+            *entry = self->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&samplecache_mutex);
+
+    free(self->data);
+    free(self->path);
+    free(self);
+}
@@ -25,6 +25,11 @@
 #include <time.h>
 #include <stdlib.h>
 #include <pthread.h>
+#include <ctype.h>
+#include <string.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
 
 #include "structmember.h"
 #include "portaudio.h"
@@ -34,6 +39,8 @@
 #include "streammodule.h"
 #include "pyomodule.h"
 #include "servermodule.h"
+#include "streamgraph.h"
+#include "dspthread.h"
 
 
 #define MAX_NBR_SERVER 256
@@ -43,17 +50,19 @@ static int serverID = 0;
 
 static PyObject *Server_shut_down(Server *self);
 static PyObject *Server_stop(Server *self);
-static void Server_process_gui(Server *server);
-static void Server_process_time(Server *server);
+static void Server_publish_meters(Server *server, MYFLT *buffer, MYFLT *gain);
 static inline void Server_process_buffers(Server *server);
+static void Server_process_host_buffers(Server *server);
 static int Server_start_rec_internal(Server *self, char *filename);
+static void Server_close_rec(Server *self);
 
 /* random objects count and multiplier to assign different seed to each instance. */
-#define num_rnd_objs 29
+#define num_rnd_objs 32
 
-int rnd_objs_count[num_rnd_objs] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
+int rnd_objs_count[num_rnd_objs] = {0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0};
 int rnd_objs_mult[num_rnd_objs] = {1993,1997,1999,2003,2011,2017,2027,2029,2039,2053,2063,2069,
-                         2081,2083,2087,2089,2099,2111,2113,2129,2131,2137,2141,2143,2153,2161,2179,2203,2207};
+                         2081,2083,2087,2089,2099,2111,2113,2129,2131,2137,2141,2143,2153,2161,2179,2203,2207,
+                         2213,2221,2237};
 
 #ifdef USE_COREAUDIO
 static int coreaudio_stop_callback(Server *self);
@@ -121,21 +130,91 @@ Server_debug(Server *self, char * format, ...)
 }
 
 /* Portmidi get input events */
+
+/* Takes the events received since the last host buffer from the MIDI ring. */
 static void portmidiGetEvents(Server *self)
+{
+    self->midiEventCount = MidiRing_pop(self->midiring, self->midiReceived, MIDI_RING_SIZE);
+}
+
+/* Events are spread over the host buffer from their arrival times, one host
+ * buffer late, so that their spacing is kept. */
+static double
+Server_clock_offset(Server *self, unsigned long long time)
+{
+    if (time <= self->hostClock)
+        return 0.0;
+    return (time - self->hostClock) * 1e-9 * self->samplingRate;
+}
+
+static void
+Server_midi_offsets(Server *self)
 {
     int i;
-    PmError result;
-    PmEvent buffer;
-
-    for (i=0; i<self->midiin_count; i++) {
-        do {
-            result = Pm_Poll(self->midiin[i]);
-            if (result) {
-                if (Pm_Read(self->midiin[i], &buffer, 1) == pmBufferOverflow)
-                    continue;
-                self->midiEvents[self->midi_count++] = buffer;
-            }
-        } while (result);
+    double offset;
+
+    for (i=0; i<self->midiEventCount; i++) {
+        offset = Server_clock_offset(self, self->midiReceived[i].time);
+        if (offset > self->hostBufferSize - 1)
+            offset = self->hostBufferSize - 1;
+        self->midiEvents[i].message = self->midiReceived[i].message;
+        self->midiEvents[i].timestamp = (PmTimestamp)offset;
+    }
+}
+
+static int
+Server_midi_kind(int status)
+{
+    if (status < 0x80)
+        return PYO_MIDI_SYSTEM;
+    else if (status < 0xA0)
+        return PYO_MIDI_NOTE;
+    else
+        return (status >> 4) - 9;
+}
+
+/* Gives the events of the host buffer falling in the current block to the
+ * objects, and sorts them by kind and by kind and channel. */
+static void
+Server_midi_block(Server *self)
+{
+    int i, k, c, count, end = self->midiEventPos;
+    int kindpos[PYO_MIDI_KINDS], channelpos[PYO_MIDI_KINDS*16];
+    PmEvent *ev;
+
+    while (end < self->midiEventCount && self->midiEvents[end].timestamp < self->blockOffset + self->bufferSize)
+        end++;
+    count = end - self->midiEventPos;
+    self->midiBlock = self->midiEvents + self->midiEventPos;
+    self->midi_count = count;
+    self->midiEventPos = end;
+    if (count == 0)
+        return;
+
+    memset(self->midiKindIndex, 0, sizeof(self->midiKindIndex));
+    memset(self->midiChannelIndex, 0, sizeof(self->midiChannelIndex));
+    for (i=0; i<count; i++) {
+        ev = &self->midiBlock[i];
+        ev->timestamp -= self->blockOffset;
+        k = Server_midi_kind(Pm_MessageStatus(ev->message));
+        c = Pm_MessageStatus(ev->message) & 0x0F;
+        self->midiKindIndex[k+1]++;
+        self->midiChannelIndex[k*16+c+1]++;
+    }
+    for (i=0; i<PYO_MIDI_KINDS; i++) {
+        self->midiKindIndex[i+1] += self->midiKindIndex[i];
+        kindpos[i] = self->midiKindIndex[i];
+    }
+    for (i=0; i<PYO_MIDI_KINDS*16; i++) {
+        self->midiChannelIndex[i+1] += self->midiChannelIndex[i];
+        channelpos[i] = self->midiChannelIndex[i];
+    }
+    for (i=0; i<count; i++) {
+        ev = &self->midiBlock[i];
+        k = Server_midi_kind(Pm_MessageStatus(ev->message));
+        c = Pm_MessageStatus(ev->message) & 0x0F;
+        self->midiSorted[kindpos[k]++] = *ev;
+        self->midiSorted[count+channelpos[k*16+c]++] = *ev;
     }
 }
 
@@ -151,6 +230,17 @@ static void portaudio_assert(PaError ecode, const char* cmdName) {
     }
 }
 
+static int
+pa_callback_flags(PaStreamCallbackFlags statusFlags)
+{
+    int flags = 0;
+    if (statusFlags & (paInputUnderflow | paOutputUnderflow))
+        flags |= CBSTATS_UNDERFLOW;
+    if (statusFlags & (paInputOverflow | paOutputOverflow))
+        flags |= CBSTATS_OVERFLOW;
+    return flags;
+}
+
 /* Portaudio callback function */
 static int
 pa_callback_interleaved( const void *inputBuffer, void *outputBuffer,
@@ -161,40 +251,43 @@ pa_callback_interleaved( const void *inputBuffer, void *outputBuffer,
 {
     float *out = (float *)outputBuffer;
     Server *server = (Server *) arg;
+    unsigned long long start = CallbackStats_begin(server->cbstats);
+    double time = server->elapsedSamples / server->samplingRate;
 
-    assert(framesPerBuffer == server->bufferSize);
+    assert(framesPerBuffer == server->hostBufferSize);
     int i, j, bufchnls, index1, index2;
 
     /* avoid unused variable warnings */
     (void) timeInfo;
-    (void) statusFlags;
 
     if (server->withPortMidi == 1) {
         portmidiGetEvents(server);
     }
 
     if (server->duplex == 1) {
-        float *in = (float *)inputBuffer;
+        float *in = (float *)inputBuffer + server->input_offset;
+        MYFLT *chnl;
         bufchnls = server->ichnls + server->input_offset;
-        for (i=0; i<server->bufferSize; i++) {
-            index1 = i * server->ichnls;
-            index2 = i * bufchnls + server->input_offset;
-            for (j=0; j<server->ichnls; j++) {
-                server->input_buffer[index1+j] = (MYFLT)in[index2+j];
+        /* deinterleaved once, the Input objects read their own channel */
+        for (j=0; j<server->ichnls; j++) {
+            chnl = server->input_planar + j * server->dacFrames;
+            for (i=0; i<server->hostBufferSize; i++) {
+                chnl[i] = (MYFLT)in[i*bufchnls+j];
             }
         }
     }
 
-    Server_process_buffers(server);
+    Server_process_host_buffers(server);
     bufchnls = server->nchnls + server->output_offset;
-    for (i=0; i<server->bufferSize; i++) {
+    for (i=0; i<server->hostBufferSize; i++) {
         index1 = i * server->nchnls;
         index2 = i * bufchnls + server->output_offset;
         for (j=0; j<server->nchnls; j++) {
             out[index2+j] = (float) server->output_buffer[index1+j];
         }
     }
-    server->midi_count = 0;
+
+    CallbackStats_end(server->cbstats, start, pa_callback_flags(statusFlags), time);
 
 #ifdef _OSX_
     if (server->server_stopped == 1)
@@ -213,13 +306,14 @@ pa_callback_nonInterleaved( const void *inputBuffer, void *outputBuffer,
 {
     float **out = (float **)outputBuffer;
     Server *server = (Server *) arg;
+    unsigned long long start = CallbackStats_begin(server->cbstats);
+    double time = server->elapsedSamples / server->samplingRate;
 
-    assert(framesPerBuffer == server->bufferSize);
+    assert(framesPerBuffer == server->hostBufferSize);
     int i, j;
 
     /* avoid unused variable warnings */
     (void) timeInfo;
-    (void) statusFlags;
 
     if (server->withPortMidi == 1) {
         portmidiGetEvents(server);
@@ -227,20 +321,22 @@ pa_callback_nonInterleaved( const void *inputBuffer, void *outputBuffer,
 
     if (server->duplex == 1) {
         float **in = (float **)inputBuffer;
-        for (i=0; i<server->bufferSize; i++) {
-            for (j=0; j<server->ichnls; j++) {
-                server->input_buffer[(i*server->ichnls)+j] = (MYFLT)in[j+server->input_offset][i];
+        MYFLT *chnl;
+        for (j=0; j<server->ichnls; j++) {
+            chnl = server->input_planar + j * server->dacFrames;
+            for (i=0; i<server->hostBufferSize; i++) {
+                chnl[i] = (MYFLT)in[j+server->input_offset][i];
             }
         }
     }
 
-    Server_process_buffers(server);
-    for (i=0; i<server->bufferSize; i++) {
-        for (j=0; j<server->nchnls; j++) {
-            out[j+server->output_offset][i] = (float) server->output_buffer[(i*server->nchnls)+j];
-        }
+    Server_process_host_buffers(server);
+    for (j=0; j<server->nchnls; j++) {
+        pyo_gain_to_float(out[j+server->output_offset], server->dac_buffer + j * server->dacFrames,
+                          server->gain_buffer, server->hostBufferSize);
     }
-    server->midi_count = 0;
+
+    CallbackStats_end(server->cbstats, start, pa_callback_flags(statusFlags), time);
 
 #ifdef _OSX_
     if (server->server_stopped == 1)
@@ -253,40 +349,88 @@ pa_callback_nonInterleaved( const void *inputBuffer, void *outputBuffer,
 #ifdef USE_JACK
 /* Jack callbacks */
 
+static void
+jack_locate_call(PyObject *obj, double value)
+{
+    PyObject *result;
+    Server *server = (Server *) obj;
+
+    if (server->jackLocateCallable == NULL)
+        return;
+    result = PyObject_CallFunction(server->jackLocateCallable, "d", value);
+    if (result == NULL)
+        PyErr_Print();
+    Py_XDECREF(result);
+}
+
+/* Returns 1 if the transport rolls. A position other than the one following
+   the previous callback is a locate, reported to the python callable. */
+static int
+jack_follow_transport(Server *server, PyoJackBackendData *be_data, jack_nframes_t nframes)
+{
+    jack_position_t pos;
+    jack_transport_state_t state = jack_transport_query(be_data->jack_client, &pos);
+    int rolling = state == JackTransportRolling;
+
+    if (pos.frame != be_data->transport_frame && server->jackLocateCallable != NULL) {
+        if (server->callbacks != NULL)
+            CallbackQueue_post(server->callbacks, (PyObject *)server, jack_locate_call, pos.frame / (double)pos.frame_rate);
+        else {
+            PyoThreadState_acquire(&server->audiostate);
+            jack_locate_call((PyObject *)server, pos.frame / (double)pos.frame_rate);
+            PyoThreadState_release(&server->audiostate);
+        }
+    }
+    be_data->transport_frame = rolling ? pos.frame + nframes : pos.frame;
+    return rolling;
+}
+
 static int
 jack_callback (jack_nframes_t nframes, void *arg)
 {
     int i, j;
     Server *server = (Server *) arg;
-    assert(nframes == server->bufferSize);
+    unsigned long long start = CallbackStats_begin(server->cbstats);
+    double time = server->elapsedSamples / server->samplingRate;
+    assert(nframes == server->hostBufferSize);
     jack_default_audio_sample_t *in_buffers[server->ichnls], *out_buffers[server->nchnls];
 
-    if (server->withPortMidi == 1) {
+    PyoJackBackendData *be_data = (PyoJackBackendData *) server->audio_be_data;
+    /* Midi timestamps are wall-clock times, meaningless faster than realtime. */
+    if (server->withPortMidi == 1 && be_data->freewheel == 0) {
         portmidiGetEvents(server);
     }
-    PyoJackBackendData *be_data = (PyoJackBackendData *) server->audio_be_data;
     for (i = 0; i < server->ichnls; i++) {
-        in_buffers[i] = jack_port_get_buffer (be_data->jack_in_ports[i+server->input_offset], server->bufferSize);
+        in_buffers[i] = jack_port_get_buffer (be_data->jack_in_ports[i+server->input_offset], server->hostBufferSize);
     }
     for (i = 0; i < server->nchnls; i++) {
-        out_buffers[i] = jack_port_get_buffer (be_data->jack_out_ports[i+server->output_offset], server->bufferSize);
+        out_buffers[i] = jack_port_get_buffer (be_data->jack_out_ports[i+server->output_offset], server->hostBufferSize);
 
     }
+    /* A stopped transport pauses the server, its time doesn't advance. */
+    if (server->jackTransport == 1 && !jack_follow_transport(server, be_data, nframes)) {
+        for (j=0; j<server->nchnls; j++) {
+            memset(out_buffers[j], 0, nframes * sizeof(jack_default_audio_sample_t));
+        }
+        CallbackStats_end(server->cbstats, start, 0, time);
+        return 0;
+    }
     /* jack audio data is not interleaved */
     if (server->duplex == 1) {
-        for (i=0; i<server->bufferSize; i++) {
-            for (j=0; j<server->ichnls; j++) {
-                server->input_buffer[(i*server->ichnls)+j] = (MYFLT) in_buffers[j][i];
+        for (j=0; j<server->ichnls; j++) {
+            MYFLT *chnl = server->input_planar + j * server->dacFrames;
+            for (i=0; i<server->hostBufferSize; i++) {
+                chnl[i] = (MYFLT) in_buffers[j][i];
             }
         }
     }
-    Server_process_buffers(server);
-    for (i=0; i<server->bufferSize; i++) {
-        for (j=0; j<server->nchnls; j++) {
-            out_buffers[j][i] = (jack_default_audio_sample_t) server->output_buffer[(i*server->nchnls)+j];
-        }
+    Server_process_host_buffers(server);
+    /* jack ports are planar, like dac_buffer */
+    for (j=0; j<server->nchnls; j++) {
+        pyo_gain_to_float(out_buffers[j], server->dac_buffer + j * server->dacFrames,
+                          server->gain_buffer, server->hostBufferSize);
     }
-    server->midi_count = 0;
+    CallbackStats_end(server->cbstats, start, 0, time);
     return 0;
 }
 
@@ -295,6 +439,7 @@ jack_srate_cb (jack_nframes_t nframes, void *arg)
 {
     Server *s = (Server *) arg;
     s->samplingRate = (double) nframes;
+    CallbackStats_setDeadline(s->cbstats, s->hostBufferSize, s->samplingRate);
     Server_debug(s, "The sample rate is now %lu/sec\n", (unsigned long) nframes);
     return 0;
 }
@@ -303,11 +448,35 @@ static int
 jack_bufsize_cb (jack_nframes_t nframes, void *arg)
 {
     Server *s = (Server *) arg;
-    s->bufferSize = (int) nframes;
+    s->hostBufferSize = (int) nframes;
+    CallbackStats_setDeadline(s->cbstats, s->hostBufferSize, s->samplingRate);
     Server_debug(s, "The buffer size is now %lu/sec\n", (unsigned long) nframes);
     return 0;
 }
 
+/* Called by jack, outside of the process callback, when freewheeling starts
+   or stops. While the graph renders as fast as it can, the recording waits
+   for the disk instead of dropping frames, like an offline server. */
+static void
+jack_freewheel_cb (int starting, void *arg)
+{
+    Server *s = (Server *) arg;
+    PyoJackBackendData *be_data = (PyoJackBackendData *) s->audio_be_data;
+    be_data->freewheel = starting;
+    if (s->recwriter != NULL)
+        DiskWriter_setBlocking(s->recwriter, starting);
+    Server_debug(s, "Jack freewheel mode %s.\n", starting ? "started" : "stopped");
+}
+
+/* Called by jack, from its own thread, after an xrun of the graph. */
+static int
+jack_xrun_cb (void *arg)
+{
+    Server *s = (Server *) arg;
+    CallbackStats_xrun(s->cbstats);
+    return 0;
+}
+
 static void
 jack_error_cb (const char *desc)
 {
@@ -334,18 +503,18 @@ OSStatus coreaudio_input_callback(AudioDeviceID device, const AudioTimeStamp* in
                                    const AudioTimeStamp* inOutputTime,
                                    void* defptr)
 {
-    int i, j, bufchnls, servchnls, off1chnls, off2chnls;
+    int i, j, bufchnls, servchnls, off1chnls;
     Server *server = (Server *) defptr;
     (void) outOutputData;
     const AudioBuffer* inputBuf = inInputData->mBuffers;
     float *bufdata = (float*)inputBuf->mData;
     bufchnls = inputBuf->mNumberChannels;
     servchnls = server->ichnls < bufchnls ? server->ichnls : bufchnls;
-    for (i=0; i<server->bufferSize; i++) {
-        off1chnls = i*bufchnls+server->input_offset;
-        off2chnls = i*servchnls;
-        for (j=0; j<servchnls; j++) {
-            server->input_buffer[off2chnls+j] = (MYFLT)bufdata[off1chnls+j];
+    for (j=0; j<servchnls; j++) {
+        MYFLT *chnl = server->input_planar + j * server->dacFrames;
+        for (i=0; i<server->hostBufferSize; i++) {
+            off1chnls = i*bufchnls+server->input_offset;
+            chnl[i] = (MYFLT)bufdata[off1chnls+j];
         }
     }
     return kAudioHardwareNoError;
@@ -360,6 +529,8 @@ OSStatus coreaudio_output_callback(AudioDeviceID device, const AudioTimeStamp* i
 {
     int i, j, bufchnls, servchnls, off1chnls, off2chnls;
     Server *server = (Server *) defptr;
+    unsigned long long start = CallbackStats_begin(server->cbstats);
+    double time = server->elapsedSamples / server->samplingRate;
 
     (void) inInputData;
 
@@ -367,20 +538,29 @@ OSStatus coreaudio_output_callback(AudioDeviceID device, const AudioTimeStamp* i
         portmidiGetEvents(server);
     }
 
-    Server_process_buffers(server);
+    Server_process_host_buffers(server);
     AudioBuffer* outputBuf = outOutputData->mBuffers;
     bufchnls = outputBuf->mNumberChannels;
     servchnls = server->nchnls < bufchnls ? server->nchnls : bufchnls;
     float *bufdata = (float*)outputBuf->mData;
-    for (i=0; i<server->bufferSize; i++) {
+    for (i=0; i<server->hostBufferSize; i++) {
         off1chnls = i*bufchnls+server->output_offset;
         off2chnls = i*servchnls;
         for(j=0; j<servchnls; j++) {
             bufdata[off1chnls+j] = server->output_buffer[off2chnls+j];
         }
     }
-    server->midi_count = 0;
 
+    CallbackStats_end(server->cbstats, start, 0, time);
+    return kAudioHardwareNoError;
+}
+
+/* Called by the HAL when the device missed a buffer. */
+OSStatus coreaudio_overload_listener(AudioDeviceID device, UInt32 channel, Boolean isInput,
+                                     AudioDevicePropertyID property, void* defptr)
+{
+    Server *server = (Server *) defptr;
+    CallbackStats_xrun(server->cbstats);
     return kAudioHardwareNoError;
 }
 
@@ -461,6 +641,7 @@ Server_pa_init(Server *self)
         Server_debug(self, "Portaudio uses non-interleaved callback.\n");
         sampleFormat = paFloat32 | paNonInterleaved;
         streamCallback = pa_callback_nonInterleaved;
+        self->planarOutput = 1;
     }
     else if (hostId == paALSA) {
         Server_debug(self, "Portaudio uses interleaved callback.\n");
@@ -503,7 +684,7 @@ Server_pa_init(Server *self)
                                        self->nchnls + self->output_offset,
                                        sampleFormat,
                                        self->samplingRate,
-                                       self->bufferSize,
+                                       self->hostBufferSize,
                                        streamCallback,
                                        (void *) self);
         else
@@ -512,7 +693,7 @@ Server_pa_init(Server *self)
                                        self->nchnls + self->output_offset,
                                        sampleFormat,
                                        self->samplingRate,
-                                       self->bufferSize,
+                                       self->hostBufferSize,
                                        streamCallback,
                                        (void *) self);
     }
@@ -522,7 +703,7 @@ Server_pa_init(Server *self)
                                 &inputParameters,
                                 &outputParameters,
                                 self->samplingRate,
-                                self->bufferSize,
+                                self->hostBufferSize,
                                 paNoFlag,
                                 streamCallback,
                                 (void *) self);
@@ -531,7 +712,7 @@ Server_pa_init(Server *self)
                                 (PaStreamParameters *) NULL,
                                 &outputParameters,
                                 self->samplingRate,
-                                self->bufferSize,
+                                self->hostBufferSize,
                                 paNoFlag,
                                 streamCallback,
                                 (void *) self);
@@ -698,8 +879,9 @@ Server_jack_init (Server *self)
     int index = 0;
     int ret = 0;
     assert(self->audio_be_data == NULL);
-    PyoJackBackendData *be_data = (PyoJackBackendData *) malloc(sizeof(PyoJackBackendData *));
+    PyoJackBackendData *be_data = (PyoJackBackendData *) calloc(1, sizeof(PyoJackBackendData));
     self->audio_be_data = (void *) be_data;
+    self->planarOutput = 1;
     be_data->jack_in_ports = (jack_port_t **) calloc(self->ichnls + self->input_offset, sizeof(jack_port_t *));
     be_data->jack_out_ports = (jack_port_t **) calloc(self->nchnls + self->output_offset, sizeof(jack_port_t *));
     strncpy(client_name,self->serverName, 32);
@@ -734,8 +916,8 @@ Server_jack_init (Server *self)
         return -1;
     }
     bufferSize = jack_get_buffer_size(be_data->jack_client);
-    if (bufferSize != self->bufferSize) {
-        self->bufferSize = bufferSize;
+    if (bufferSize != self->hostBufferSize) {
+        self->hostBufferSize = bufferSize;
         Server_warning(self, "Buffer size set to Jack engine buffer size: %" PRIu32 "\n", bufferSize);
     }
     else {
@@ -776,6 +958,10 @@ Server_jack_init (Server *self)
     jack_set_sample_rate_callback(be_data->jack_client, jack_srate_cb, (void *) self);
     jack_on_shutdown (be_data->jack_client, jack_shutdown_cb, (void *) self);
     jack_set_buffer_size_callback (be_data->jack_client, jack_bufsize_cb, (void *) self);
+    jack_set_freewheel_callback (be_data->jack_client, jack_freewheel_cb, (void *) self);
+    jack_set_xrun_callback (be_data->jack_client, jack_xrun_cb, (void *) self);
+    /* The first callback reports the transport position. */
+    be_data->transport_frame = (jack_nframes_t) -1;
     return 0;
 }
 
@@ -977,21 +1163,21 @@ Server_coreaudio_init(Server *self)
     /****************************************/
     /* set/get the buffersize for the devices */
     count = sizeof(UInt32);
-    err = AudioDeviceSetProperty(mOutputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->bufferSize);
+    err = AudioDeviceSetProperty(mOutputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->hostBufferSize);
     if (err != kAudioHardwareNoError) {
         Server_error(self, "set kAudioDevicePropertyBufferFrameSize error %4.4s\n", (char*)&err);
-        self->bufferSize = bufferSize;
-        err = AudioDeviceSetProperty(mOutputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->bufferSize);
+        self->hostBufferSize = bufferSize;
+        err = AudioDeviceSetProperty(mOutputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->hostBufferSize);
         if (err != kAudioHardwareNoError)
             Server_error(self, "set kAudioDevicePropertyBufferFrameSize error %4.4s\n", (char*)&err);
         else
-            Server_debug(self, "pyo buffer size set to output device buffer size : %i\n", self->bufferSize);
+            Server_debug(self, "pyo buffer size set to output device buffer size : %i\n", self->hostBufferSize);
     }
     else
-        Server_debug(self, "Coreaudio : Changed output device buffer size successfully: %i\n", self->bufferSize);
+        Server_debug(self, "Coreaudio : Changed output device buffer size successfully: %i\n", self->hostBufferSize);
 
     if (self->duplex == 1) {
-        err = AudioDeviceSetProperty(mInputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->bufferSize);
+        err = AudioDeviceSetProperty(mInputDevice, &now, 0, false, kAudioDevicePropertyBufferFrameSize, count, &self->hostBufferSize);
         if (err != kAudioHardwareNoError) {
             Server_error(self, "set kAudioDevicePropertyBufferFrameSize error %4.4s\n", (char*)&err);
         }
@@ -1099,6 +1285,7 @@ Server_coreaudio_init(Server *self)
         Server_error(self, "Output AudioDeviceAddIOProc failed %d\n", (int)err);
         return -1;
     }
+    AudioDeviceAddPropertyListener(self->output, 0, false, kAudioDeviceProcessorOverload, coreaudio_overload_listener, (void *) self);
     err = AudioDeviceGetPropertyInfo(self->output, 0, false, kAudioDevicePropertyIOProcStreamUsage, &propertySize, &writable);
     AudioHardwareIOProcStreamUsage *output_su = (AudioHardwareIOProcStreamUsage*)malloc(propertySize);
     output_su->mIOProc = (void*)coreaudio_output_callback;
@@ -1124,6 +1311,7 @@ Server_coreaudio_deinit(Server *self)
         }
     }
 
+    AudioDeviceRemovePropertyListener(self->output, 0, false, kAudioDeviceProcessorOverload, coreaudio_overload_listener);
     err = AudioDeviceRemoveIOProc(self->output, coreaudio_output_callback);
     if (err != kAudioHardwareNoError) {
         Server_error(self, "Output AudioDeviceRemoveIOProc failed %d\n", (int)err);
@@ -1195,8 +1383,7 @@ void
             offline_process_block((Server *) self);
         }
         self->server_started = 0;
-        self->record = 0;
-        sf_close(self->recfile);
+        Server_close_rec(self);
         Server_message(self,"Offline Server rendering finished.\n");
     }
     return NULL;
@@ -1227,8 +1414,7 @@ Server_offline_start(Server *self)
         offline_process_block((Server *) self);
     }
     self->server_started = 0;
-    self->record = 0;
-    sf_close(self->recfile);
+    Server_close_rec(self);
     Server_message(self,"Offline Server rendering finished.\n");
     return 0;
 }
@@ -1257,7 +1443,9 @@ Server_embedded_deinit(Server *self)
 int
 Server_embedded_i_start(Server *self)
 {
-    Server_process_buffers(self);
+    self->planarOutput = 0;
+    pyo_deinterleave(self->input_planar, self->dacFrames, self->input_buffer, self->ichnls, self->hostBufferSize);
+    Server_process_host_buffers(self);
     return 0;
 }
 
@@ -1273,19 +1461,14 @@ Server_embedded_i_startIdx(int idx)
 int
 Server_embedded_ni_start(Server *self)
 {
-    int i, j;
-    Server_process_buffers(self);
-    float *out = (float *)calloc(self->bufferSize * self->nchnls, sizeof(float));
-    for (i=0; i<(self->bufferSize*self->nchnls); i++){
-        out[i] = self->output_buffer[i];
-    }
+    int j;
+    pyo_deinterleave(self->input_planar, self->dacFrames, self->input_buffer, self->ichnls, self->hostBufferSize);
+    Server_process_host_buffers(self);
 
     /* Non-Interleaved */
-    for (i=0; i<self->bufferSize; i++) {
-        for (j=0; j<=self->nchnls; j++) {
-            /* TODO: This could probably be more efficient (ob) */
-            self->output_buffer[i+(self->bufferSize*(j+1))-self->bufferSize] = out[(i*self->nchnls)+j];
-        }
+    for (j=0; j<self->nchnls; j++) {
+        pyo_gain_to_float(self->output_buffer + j * self->hostBufferSize, self->dac_buffer + j * self->dacFrames,
+                          self->gain_buffer, self->hostBufferSize);
     }
 
     return 0;
@@ -1298,13 +1481,48 @@ Server_embedded_ni_startIdx(int idx)
     return 0;
 }
 
+/* planar embedded callback, the host's buffers are read and written directly */
+int
+Server_embedded_p_start(void *server, float **ins, float **outs, int frames)
+{
+    int i, j, pos;
+    Server *self = (Server *)server;
+    int bufsize = self->hostBufferSize;
+    int ichnls = self->ichnls;
+
+    if (frames % bufsize != 0)
+        return -1;
+
+    /* Only dac_buffer is read, the interleaved output is left out. */
+    self->planarOutput = 1;
+    if (ins == NULL)
+        memset(self->input_planar, 0, self->dacFrames * ichnls * sizeof(MYFLT));
+    for (pos=0; pos<frames; pos+=bufsize) {
+        if (ins != NULL) {
+            for (j=0; j<ichnls; j++) {
+                MYFLT *chnl = self->input_planar + j * self->dacFrames;
+                for (i=0; i<bufsize; i++) {
+                    chnl[i] = (MYFLT)ins[j][pos + i];
+                }
+            }
+        }
+        Server_process_host_buffers(self);
+        for (j=0; j<self->nchnls; j++) {
+            pyo_gain_to_float(outs[j] + pos, self->dac_buffer + j * self->dacFrames,
+                              self->gain_buffer, bufsize);
+        }
+    }
+
+    return 0;
+}
+
 void
 *Server_embedded_thread(void *arg)
 {
     Server *self;
     self = (Server *)arg;
 
-    Server_process_buffers(self);
+    Server_process_host_buffers(self);
 
     return NULL;
 }
@@ -1327,183 +1545,568 @@ Server_embedded_stop(Server *self)
     return 0;
 }
 
-/***************************************************/
-/*  Main Processing functions                      */
+/******* Shared memory Server *******/
+#ifndef _WIN32
 
-static inline void
-Server_process_buffers(Server *server)
+/* The thread waiting for the host's blocks wakes up regularly to see if the
+   server is stopped, in microseconds. */
+#define SHM_WAIT_TIMEOUT 100000
+
+int
+Server_shm_init(Server *self)
 {
-    float *out = server->output_buffer;
-    MYFLT buffer[server->nchnls][server->bufferSize];
-    int i, j, chnl;
-    int nchnls = server->nchnls;
-    MYFLT amp = server->amp;
-    Stream *stream_tmp;
-    MYFLT *data;
-
-    memset(&buffer, 0, sizeof(buffer));
-    PyGILState_STATE s = PyGILState_Ensure();
-    for (i=0; i<server->stream_count; i++) {
-        stream_tmp = (Stream *)PyList_GET_ITEM(server->streams, i);
-        if (Stream_getStreamActive(stream_tmp) == 1) {
-            Stream_callFunction(stream_tmp);
-            if (Stream_getStreamToDac(stream_tmp) != 0) {
-                data = Stream_getData(stream_tmp);
-                chnl = Stream_getStreamChnl(stream_tmp);
-                for (j=0; j < server->bufferSize; j++) {
-                    buffer[chnl][j] += *data++;
+    PyoShmBackendData *be_data = (PyoShmBackendData *) calloc(1, sizeof(PyoShmBackendData));
+    self->audio_be_data = (void *) be_data;
+    self->planarOutput = 1;
+    be_data->shm = ShmAudio_create(self->serverName, self->samplingRate, self->hostBufferSize,
+                                   self->ichnls, self->nchnls);
+    if (be_data->shm == NULL) {
+        Server_error(self, "Shm error: unable to create the shared memory segment `%s'.\n", self->serverName);
+        return -1;
+    }
+    return 0;
+}
+
+int
+Server_shm_deinit(Server *self)
+{
+    PyoShmBackendData *be_data = (PyoShmBackendData *) self->audio_be_data;
+    if (be_data == NULL)
+        return 0;
+    ShmAudio_close(be_data->shm);
+    free(self->audio_be_data);
+    self->audio_be_data = NULL;
+    return 0;
+}
+
+static void *
+Server_shm_thread(void *arg)
+{
+    int i, j;
+    float *in, *out;
+    Server *self = (Server *)arg;
+    PyoShmBackendData *be_data = (PyoShmBackendData *) self->audio_be_data;
+    int bufsize = self->hostBufferSize;
+    int ichnls = self->ichnls;
+
+    while (self->server_stopped == 0) {
+        if ((in = ShmAudio_waitInput(be_data->shm, SHM_WAIT_TIMEOUT)) == NULL)
+            continue;
+        if (self->withPortMidi == 1) {
+            portmidiGetEvents(self);
+        }
+        /* shared blocks are planar */
+        if (self->duplex == 1) {
+            for (j=0; j<ichnls; j++) {
+                MYFLT *chnl = self->input_planar + j * self->dacFrames;
+                for (i=0; i<bufsize; i++) {
+                    chnl[i] = (MYFLT)in[j * bufsize + i];
                 }
             }
-            if (Stream_getDuration(stream_tmp) != 0) {
-                Stream_IncrementDurationCount(stream_tmp);
-            }
         }
-        else if (Stream_getBufferCountWait(stream_tmp) != 0)
-            Stream_IncrementBufferCount(stream_tmp);
-    }
-    if (server->withGUI == 1 && nchnls <= 8) {
-        Server_process_gui(server);
-    }
-    if (server->withTIME == 1) {
-        Server_process_time(server);
-    }
-    server->elapsedSamples += server->bufferSize;
-    PyGILState_Release(s);
-    if (amp != server->lastAmp) {
-        server->timeCount = 0;
-        server->stepVal = (amp - server->currentAmp) / server->timeStep;
-        server->lastAmp = amp;
-    }
-
-    for (i=0; i < server->bufferSize; i++){
-        if (server->timeCount < server->timeStep) {
-            server->currentAmp += server->stepVal;
-            server->timeCount++;
+        ShmAudio_doneInput(be_data->shm);
+        Server_process_host_buffers(self);
+        while ((out = ShmAudio_waitOutput(be_data->shm, SHM_WAIT_TIMEOUT)) == NULL) {
+            if (self->server_stopped == 1)
+                return NULL;
         }
-        for (j=0; j<server->nchnls; j++) {
-            out[(i*server->nchnls)+j] = (float)buffer[j][i] * server->currentAmp;
+        for (j=0; j<self->nchnls; j++) {
+            pyo_gain_to_float(out + j * bufsize, self->dac_buffer + j * self->dacFrames,
+                              self->gain_buffer, bufsize);
         }
+        ShmAudio_commitOutput(be_data->shm);
     }
-    if (server->record == 1)
-        sf_write_float(server->recfile, out, server->bufferSize * server->nchnls);
+    return NULL;
+}
+
+int
+Server_shm_start(Server *self)
+{
+    PyoShmBackendData *be_data = (PyoShmBackendData *) self->audio_be_data;
+    if (pthread_create(&be_data->thread, NULL, Server_shm_thread, self) != 0) {
+        Server_error(self, "Shm error: unable to start the processing thread.\n");
+        return -1;
+    }
+    return 0;
+}
 
+/* Called without the GIL, the thread may be waiting for it. */
+int
+Server_shm_stop(Server *self)
+{
+    PyoShmBackendData *be_data = (PyoShmBackendData *) self->audio_be_data;
+    self->server_stopped = 1;
+    pthread_join(be_data->thread, NULL);
+    self->server_started = 0;
+    return 0;
 }
 
+/* Sends the bus channels read during this block to the worker processes,
+   which compute them while the objects of this server are computed. */
 static void
-Server_process_gui(Server *server)
+Server_shm_send(Server *server)
 {
-    float rms[server->nchnls];
-    float *out = server->output_buffer;
-    float outAmp;
-    int i,j;
-    for (j=0; j<server->nchnls; j++) {
-        rms[j] = 0.0;
-        for (i=0; i<server->bufferSize; i++) {
-            outAmp = out[(i*server->nchnls)+j];
-            outAmp *= outAmp;
-            if (outAmp > rms[j])
-                rms[j] = outAmp;
+    int i, j, k, chnls;
+    int bufsize = server->bufferSize;
+    float *in;
+    MYFLT *bus;
+    PyoShmWorker *w;
+
+    for (i=0; i<server->shmworker_count; i++) {
+        w = &server->shmworkers[i];
+        if ((in = ShmAudio_reserveInput(w->shm)) == NULL)
+            continue;
+        chnls = w->shm->header->ichnls;
+        if (w->send < 0)
+            memset(in, 0, chnls * bufsize * sizeof(float));
+        else {
+            for (j=0; j<chnls; j++) {
+                bus = server->buses[w->send + j] + server->bus_front * bufsize;
+                for (k=0; k<bufsize; k++) {
+                    in[j * bufsize + k] = (float)bus[k];
+                }
+            }
         }
+        ShmAudio_commitInput(w->shm);
     }
-    if (server->gcount <= server->numPass) {
-        for (j=0; j<server->nchnls; j++) {
-            server->lastRms[j] = (rms[j] + server->lastRms[j]) * 0.5;
+}
+
+/* Sums the answers of the workers in the bus channels written during this
+   block. An answer which doesn't come within a block is skipped. */
+static void
+Server_shm_receive(Server *server)
+{
+    int i, j, k, chnls;
+    int bufsize = server->bufferSize;
+    long timeout = (long)(bufsize / server->samplingRate * 1e6);
+    float *out;
+    MYFLT *bus;
+    PyoShmWorker *w;
+
+    for (i=0; i<server->shmworker_count; i++) {
+        w = &server->shmworkers[i];
+        if ((out = ShmAudio_receive(w->shm, timeout)) == NULL)
+            continue;
+        if (w->receive >= 0) {
+            chnls = w->shm->header->nchnls;
+            for (j=0; j<chnls; j++) {
+                bus = server->buses[w->receive + j] + (!server->bus_front) * bufsize;
+                for (k=0; k<bufsize; k++) {
+                    bus[k] += (MYFLT)out[j * bufsize + k];
+                }
+            }
         }
-        server->gcount++;
+        ShmAudio_doneOutput(w->shm);
     }
-    else {
-        for (j=0; j<server->nchnls; j++) {
-            server->lastRms[j] = (rms[j] + server->lastRms[j]) * 0.5;
-        }
-        switch (server->nchnls) {
-            case 1:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "f", server->lastRms[0]);
-                break;
-            case 2:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "ff", server->lastRms[0], server->lastRms[1]);
-                break;
-            case 3:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "fff", server->lastRms[0], server->lastRms[1], server->lastRms[2]);
-                break;
-            case 4:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "ffff", server->lastRms[0], server->lastRms[1], server->lastRms[2], server->lastRms[3]);
-                break;
-            case 5:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "fffff", server->lastRms[0], server->lastRms[1], server->lastRms[2], server->lastRms[3], server->lastRms[4]);
-                break;
-            case 6:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "ffffff", server->lastRms[0], server->lastRms[1], server->lastRms[2], server->lastRms[3], server->lastRms[4], server->lastRms[5]);
-                break;
-            case 7:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "fffffff", server->lastRms[0], server->lastRms[1], server->lastRms[2], server->lastRms[3], server->lastRms[4], server->lastRms[5], server->lastRms[6]);
-                break;
-            case 8:
-                PyObject_CallMethod((PyObject *)server->GUI, "setRms", "ffffffff", server->lastRms[0], server->lastRms[1], server->lastRms[2], server->lastRms[3], server->lastRms[4], server->lastRms[5], server->lastRms[6], server->lastRms[7]);
-                break;
-        }
-        server->gcount = 0;
+}
+#endif
+
+/***************************************************/
+/*  Main Processing functions                      */
+
+/* Calls the process function of a stream. Without the GIL, it is acquired
+   only for streams that can't run without the interpreter. */
+static inline void
+Server_compute_stream(Server *server, Stream *stream_tmp)
+{
+    if (server->callbacks != NULL && stream_tmp->pycall) {
+        PyoThreadState_acquire(&server->audiostate);
+        Stream_compute(stream_tmp);
+        PyoThreadState_release(&server->audiostate);
     }
+    else
+        Stream_compute(stream_tmp);
 }
 
 static void
-Server_process_time(Server *server)
+Server_stop_stream(PyObject *obj, double value)
 {
-    int hours, minutes, seconds, milliseconds;
-    float sr = server->samplingRate;
-    double sampsToSecs;
+    PyObject *result = PyObject_CallMethod(obj, "stop", NULL);
+    if (result == NULL)
+        PyErr_Print();
+    else
+        Py_DECREF(result);
+}
 
-    if (server->tcount <= server->timePass) {
-        server->tcount++;
-    }
-    else {
-        sampsToSecs = (double)(server->elapsedSamples / sr);
-        seconds = (int)sampsToSecs;
-        milliseconds = (int)((sampsToSecs - seconds) * 1000);
-        minutes = seconds / 60;
-        hours = minutes / 60;
-        minutes = minutes % 60;
-        seconds = seconds % 60;
-        PyObject_CallMethod((PyObject *)server->TIME, "setTime", "iiii", hours, minutes, seconds, milliseconds);
-        server->tcount = 0;
+/* Duration count without the GIL: the stream is silenced right away and
+   its stop method is deferred to the dispatcher thread. */
+static inline void
+Server_increment_duration(Server *server, Stream *stream_tmp)
+{
+    int j;
+
+    if (server->callbacks == NULL) {
+        Stream_IncrementDurationCount(stream_tmp);
+        return;
+    }
+    stream_tmp->bufferCount++;
+    if (stream_tmp->bufferCount >= stream_tmp->duration) {
+        Stream_setStreamActive(stream_tmp, 0);
+        Stream_setStreamChnl(stream_tmp, 0);
+        Stream_setStreamToDac(stream_tmp, 0);
+        for (j=0; j<stream_tmp->bufsize; j++) {
+            stream_tmp->data[j] = 0;
+        }
+        stream_tmp->duration = stream_tmp->bufferCount = 0;
+        CallbackQueue_post(server->callbacks, Stream_getStreamObject(stream_tmp), Server_stop_stream, 0);
     }
 }
 
-/***************************************************/
+static void
+Server_free_buses(Server *self)
+{
+    int i;
+    DspLock_enter();
+    for (i=0; i<self->bus_count; i++) {
+        pyo_aligned_free(self->buses[i]);
+        self->buses[i] = NULL;
+    }
+    self->bus_count = 0;
+    DspLock_leave();
+    if (self->bus_names != NULL)
+        PyDict_Clear(self->bus_names);
+}
 
-/* Global function called by any new audio object to
- get a pointer to the server */
-PyObject *
-PyServer_get_server()
+#ifndef _WIN32
+static void
+Server_free_shm_workers(Server *self)
 {
-    return (PyObject *)my_server[serverID];
+    int i, count;
+    PyoShmWorker *w;
+    DspLock_enter();
+    count = self->shmworker_count;
+    self->shmworker_count = 0;
+    DspLock_leave();
+    for (i=0; i<count; i++) {
+        w = &self->shmworkers[i];
+        if (w->shm->dropped > 0 || w->shm->late > 0)
+            Server_warning(self, "Shm warning: worker %s missed %lu blocks and answered %lu blocks late.\n",
+                           w->shm->name, w->shm->dropped, w->shm->late);
+        ShmAudio_close(w->shm);
+        w->shm = NULL;
+    }
 }
+#endif
 
-static PyObject *
-Server_shut_down(Server *self)
+/* Swaps the halves of the buses at the start of a block and clears the half summed into. */
+static inline void
+Server_swap_buses(Server *server)
 {
     int i;
-    int ret = -1;
-    if (self->server_booted == 0) {
-        Server_error(self, "The Server must be booted!\n");
-        Py_INCREF(Py_None);
-        return Py_None;
+    server->bus_front = !server->bus_front;
+    for (i=0; i<server->bus_count; i++) {
+        memset(server->buses[i] + (!server->bus_front) * server->bufferSize, 0, server->bufferSize * sizeof(MYFLT));
     }
-    if (self->server_started == 1) {
-        Server_stop((Server *)self);
+}
+
+/* Adds a computed stream to the output buffer and updates its counters.
+   `active` is the state of the stream before its process function was called. */
+static inline void
+Server_postprocess_stream(Server *server, Stream *stream_tmp, MYFLT *buffer, int active)
+{
+    MYFLT *data, *out;
+
+    if (active == 1) {
+        if (Stream_getStreamToDac(stream_tmp) != 0) {
+            data = Stream_getData(stream_tmp);
+            out = buffer + Stream_getStreamChnl(stream_tmp) * server->dacFrames;
+            pyo_accumulate(out, data, server->bufferSize);
+        }
+        if (stream_tmp->bus >= 0 && stream_tmp->bus < server->bus_count) {
+            out = server->buses[stream_tmp->bus] + (!server->bus_front) * server->bufferSize;
+            pyo_accumulate_gain(out, Stream_getData(stream_tmp), stream_tmp->busGain, server->bufferSize);
+        }
+        if (Stream_getDuration(stream_tmp) != 0) {
+            Server_increment_duration(server, stream_tmp);
+        }
     }
+    else if (Stream_getBufferCountWait(stream_tmp) != 0)
+        Stream_IncrementBufferCount(stream_tmp);
+}
 
-    for (i=0; i<num_rnd_objs; i++) {
-        rnd_objs_count[i] = 0;
+/* Computes the stream list with the worker pool. The list is cut in segments
+   which never contain a stream calling into the interpreter (processed alone,
+   in order) nor a stream reaching its duration, as stopping it clears its data. */
+static inline void
+Server_process_streams_parallel(Server *server, MYFLT *buffer)
+{
+    int i, start, active, count = server->streams->count;
+    Stream *stream_tmp;
+
+    /* Streams added by a python call during the buffer are not in the graph,
+       they are computed from the next buffer on. */
+    StreamGraph_prepare(server->graph, server->streams->items, count);
+    if (server->pullMode)
+        StreamGraph_pull(server->graph, count);
+    i = 0;
+    while (i < count) {
+        stream_tmp = server->streams->items[i];
+        if (stream_tmp == NULL) {
+            i++;
+            continue;
+        }
+        if (stream_tmp->pycall) {
+            active = Stream_getStreamActive(stream_tmp);
+            if (active == 1 && stream_tmp->suspended == 0)
+                Server_compute_stream(server, stream_tmp);
+            Server_postprocess_stream(server, stream_tmp, buffer, active);
+            i++;
+            continue;
+        }
+        start = i;
+        while (i < count) {
+            stream_tmp = server->streams->items[i];
+            if (stream_tmp == NULL || stream_tmp->pycall)
+                break;
+            i++;
+            if (Stream_getStreamActive(stream_tmp) == 1 && Stream_getDuration(stream_tmp) != 0 &&
+                (stream_tmp->bufferCount + 1) >= Stream_getDuration(stream_tmp))
+                break;
+        }
+        StreamGraph_run(server->graph, start, i);
+        for (; start<i; start++) {
+            stream_tmp = server->streams->items[start];
+            if (stream_tmp != NULL)
+                Server_postprocess_stream(server, stream_tmp, buffer, Stream_getStreamActive(stream_tmp));
+        }
     }
+}
 
-    switch (self->audio_be_type) {
-        case PyoPortaudio:
-            ret = Server_pa_deinit(self);
-            break;
-        case PyoCoreaudio:
-#ifdef USE_COREAUDIO
-            ret = Server_coreaudio_deinit(self);
-#endif
+static inline void
+Server_process_buffers(Server *server)
+{
+    float *out = server->output_buffer + server->blockOffset * server->nchnls;
+    MYFLT *buffer = server->dac_buffer + server->blockOffset;
+    MYFLT *gain = server->gain_buffer + server->blockOffset;
+    int i, active;
+    int nchnls = server->nchnls;
+    MYFLT amp = server->amp;
+    unsigned int fpstate;
+    Stream *stream_tmp;
+
+    /* The host thread gets its own mode back after the buffer. */
+    fpstate = DenormalMode_set(server->flushDenormals);
+
+    for (i=0; i<nchnls; i++) {
+        memset(buffer + i * server->dacFrames, 0, server->bufferSize * sizeof(MYFLT));
+    }
+    if (server->callbacks != NULL)
+        DspLock_lock(server->dsplock);
+    else
+        PyoThreadState_acquire(&server->audiostate);
+    ParamQueue_begin(server->params, server->elapsedSamples, server->bufferSize, server->callbacks == NULL);
+    Server_swap_buses(server);
+#ifndef _WIN32
+    if (server->shmworker_count > 0)
+        Server_shm_send(server);
+#endif
+    /* Streams removed from a python call during the buffer leave holes. */
+    StreamList_compact(server->streams);
+    server->streams->iterating = 1;
+    if (server->graph != NULL) {
+        Server_process_streams_parallel(server, buffer);
+    }
+    else {
+        for (i=0; i<server->streams->count; i++) {
+            stream_tmp = server->streams->items[i];
+            if (stream_tmp == NULL)
+                continue;
+            active = Stream_getStreamActive(stream_tmp);
+            if (active == 1)
+                Server_compute_stream(server, stream_tmp);
+            Server_postprocess_stream(server, stream_tmp, buffer, active);
+        }
+    }
+    server->streams->iterating = 0;
+#ifndef _WIN32
+    if (server->shmworker_count > 0)
+        Server_shm_receive(server);
+#endif
+    ParamQueue_end(server->params, server->callbacks == NULL);
+    server->elapsedSamples += server->bufferSize;
+    /* Deadlines are met after the buffer, like the python calls between two buffers. */
+    TimerWheel_advance(server->timers);
+    if (amp != server->lastAmp) {
+        server->timeCount = 0;
+        server->stepVal = (amp - server->currentAmp) / server->timeStep;
+        server->lastAmp = amp;
+    }
+
+    for (i=0; i < server->bufferSize; i++){
+        if (server->timeCount < server->timeStep) {
+            server->currentAmp += server->stepVal;
+            server->timeCount++;
+        }
+        gain[i] = server->currentAmp;
+    }
+    if (server->withGUI == 1 || server->withTIME == 1)
+        Server_publish_meters(server, buffer, gain);
+    if (server->planarOutput == 0 || server->record == 1)
+        pyo_interleave_gain(out, buffer, server->dacFrames, gain, nchnls, server->bufferSize);
+    /* Still under the lock, recstop can't close the writer between the test and the write. */
+    if (server->record == 1)
+        DiskWriter_writeFloat(server->recwriter, out, server->bufferSize);
+
+    if (server->callbacks != NULL) {
+        CallbackQueue_flush(server->callbacks);
+        DspLock_unlock(server->dsplock);
+    }
+    else
+        PyoThreadState_release(&server->audiostate);
+
+    DenormalMode_restore(fpstate);
+}
+
+/* Computes a device buffer, in blocks of bufferSize frames. Each block gets
+   the MIDI events received for its frames. */
+static void
+Server_process_host_buffers(Server *server)
+{
+    server->hostClock = Stream_clock() - (unsigned long long)(server->hostBufferSize / server->samplingRate * 1e9);
+    Server_midi_offsets(server);
+    server->midiEventPos = 0;
+    for (server->blockOffset=0; server->blockOffset<server->hostBufferSize; server->blockOffset+=server->bufferSize) {
+        Server_midi_block(server);
+        Server_process_buffers(server);
+    }
+    server->blockOffset = 0;
+    server->midiEventCount = 0;
+    server->midi_count = 0;
+    if (server->oscsender != NULL)
+        OscSender_publish(server->oscsender);
+}
+
+/* Meters and time for the GUI. The audio thread only publishes them, the
+   GUI objects are called by pollCallables, from a thread of the interpreter. */
+static void
+Server_publish_meters(Server *server, MYFLT *buffer, MYFLT *gain)
+{
+    int j;
+    MYFLT peak, sum;
+
+    server->meterSeq++;
+    __sync_synchronize();
+    if (server->withGUI == 1) {
+        for (j=0; j<server->nchnls; j++) {
+            pyo_peak_power(buffer + j * server->dacFrames, gain, server->bufferSize, &peak, &sum);
+            server->lastRms[j] = ((float)peak + server->lastRms[j]) * 0.5;
+            server->lastPower[j] = ((float)(sum / server->bufferSize) + server->lastPower[j]) * 0.5;
+            server->meterPeak[j] = server->lastRms[j];
+            server->meterRms[j] = sqrtf(server->lastPower[j]);
+        }
+    }
+    server->meterSamples = server->elapsedSamples;
+    __sync_synchronize();
+    server->meterSeq++;
+}
+
+/* Copies the values published by Server_publish_meters. Returns the
+   sequence number of the copied values. */
+static unsigned int
+Server_read_meters(Server *server, float *peaks, float *rms, unsigned long *samples)
+{
+    unsigned int seq;
+
+    do {
+        while ((seq = server->meterSeq) & 1);
+        __sync_synchronize();
+        memcpy(peaks, server->meterPeak, server->nchnls * sizeof(float));
+        memcpy(rms, server->meterRms, server->nchnls * sizeof(float));
+        *samples = server->meterSamples;
+        __sync_synchronize();
+    } while (seq != server->meterSeq);
+
+    return seq;
+}
+
+static void
+Server_set_time(Server *server, unsigned long samples)
+{
+    int hours, minutes, seconds, milliseconds;
+    double sampsToSecs;
+    PyObject *ret;
+
+    sampsToSecs = (double)samples / server->samplingRate;
+    seconds = (int)sampsToSecs;
+    milliseconds = (int)((sampsToSecs - seconds) * 1000);
+    minutes = seconds / 60;
+    hours = minutes / 60;
+    minutes = minutes % 60;
+    seconds = seconds % 60;
+    ret = PyObject_CallMethod((PyObject *)server->TIME, "setTime", "iiii", hours, minutes, seconds, milliseconds);
+    if (ret == NULL)
+        PyErr_Print();
+    Py_XDECREF(ret);
+}
+
+static void
+Server_set_rms(Server *server, float *peaks)
+{
+    int j;
+    PyObject *args, *func, *ret;
+
+    func = PyObject_GetAttrString((PyObject *)server->GUI, "setRms");
+    if (func == NULL) {
+        PyErr_Print();
+        return;
+    }
+    args = PyTuple_New(server->nchnls);
+    for (j=0; j<server->nchnls; j++)
+        PyTuple_SET_ITEM(args, j, PyFloat_FromDouble(peaks[j]));
+    ret = PyObject_Call(func, args, NULL);
+    if (ret == NULL)
+        PyErr_Print();
+    Py_XDECREF(ret);
+    Py_DECREF(args);
+    Py_DECREF(func);
+}
+
+/***************************************************/
+
+/* Global function called by any new audio object to
+ get a pointer to the server */
+PyObject *
+PyServer_get_server()
+{
+    int i;
+    PyInterpreterState *interp = PyThreadState_GET()->interp;
+
+    /* Servers embedded in sub-interpreters are found without setServer. */
+    if (my_server[serverID] == NULL || my_server[serverID]->interp != interp) {
+        for (i=0; i<MAX_NBR_SERVER; i++) {
+            if (my_server[i] != NULL && my_server[i]->interp == interp)
+                return (PyObject *)my_server[i];
+        }
+    }
+    return (PyObject *)my_server[serverID];
+}
+
+static PyObject *
+Server_shut_down(Server *self)
+{
+    int i;
+    int ret = -1;
+    if (self->server_booted == 0) {
+        Server_error(self, "The Server must be booted!\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (self->server_started == 1) {
+        Server_stop((Server *)self);
+    }
+
+    for (i=0; i<num_rnd_objs; i++) {
+        rnd_objs_count[i] = 0;
+    }
+
+    switch (self->audio_be_type) {
+        case PyoPortaudio:
+            ret = Server_pa_deinit(self);
+            break;
+        case PyoCoreaudio:
+#ifdef USE_COREAUDIO
+            ret = Server_coreaudio_deinit(self);
+#endif
             break;
         case PyoJack:
 #ifdef USE_JACK
@@ -1519,12 +2122,45 @@ Server_shut_down(Server *self)
         case PyoEmbedded:
             ret = Server_embedded_deinit(self);
             break;
+        case PyoShm:
+#ifndef _WIN32
+            ret = Server_shm_deinit(self);
+#endif
+            break;
     }
     self->server_booted = 0;
+    self->bufferSize = self->hostBufferSize;
     if (ret < 0) {
         Server_error(self, "Error closing audio backend.\n");
     }
 
+    /* A recording still running when the audio backend is closed. */
+    if (self->recwriter != NULL && self->audio_be_type != PyoOfflineNB)
+        Server_close_rec(self);
+
+    if (self->graph != NULL) {
+        StreamGraph_free(self->graph);
+        self->graph = NULL;
+    }
+    if (self->callbacks != NULL) {
+        CallbackQueue_free(self->callbacks);
+        self->callbacks = NULL;
+    }
+    PyoThreadState_clear(&self->audiostate);
+    if (self->params != NULL) {
+        ParamQueue_free(self->params);
+        self->params = NULL;
+    }
+    if (self->timers != NULL) {
+        TimerWheel_free(self->timers);
+        self->timers = NULL;
+    }
+    self->profiling = 0;
+#ifndef _WIN32
+    Server_free_shm_workers(self);
+#endif
+    Server_free_buses(self);
+
     Py_INCREF(Py_None);
     return Py_None;
 }
@@ -1534,18 +2170,23 @@ static int
 Server_traverse(Server *self, visitproc visit, void *arg)
 {
     /* GUI and TIME ? */
-    Py_VISIT(self->streams);
+    int i;
+    for (i=0; i<self->streams->count; i++) {
+        Py_VISIT(self->streams->items[i]);
+    }
     Py_VISIT(self->jackAutoConnectInputPorts);
     Py_VISIT(self->jackAutoConnectOutputPorts);
+    Py_VISIT(self->jackLocateCallable);
     return 0;
 }
 
 static int
 Server_clear(Server *self)
 {
-    Py_CLEAR(self->streams);
+    StreamList_clear(self->streams);
     Py_CLEAR(self->jackAutoConnectInputPorts);
     Py_CLEAR(self->jackAutoConnectOutputPorts);
+    Py_CLEAR(self->jackLocateCallable);
     return 0;
 }
 
@@ -1555,8 +2196,23 @@ Server_dealloc(Server* self)
     if (self->server_booted == 1)
         Server_shut_down(self);
     Server_clear(self);
+    StreamList_free(self->streams);
     free(self->input_buffer);
     free(self->output_buffer);
+    pyo_aligned_free(self->dac_buffer);
+    pyo_aligned_free(self->gain_buffer);
+    pyo_aligned_free(self->input_planar);
+    free(self->lastRms);
+    free(self->lastPower);
+    free(self->meterPeak);
+    free(self->meterRms);
+    MidiRing_free(self->midiring);
+    CallbackStats_free(self->cbstats);
+    OscSender_free(self->oscsender);
+    free(self->midiReceived);
+    free(self->midiEvents);
+    free(self->midiSorted);
+    Py_XDECREF(self->bus_names);
     free(self->serverName);
     my_server[self->thisServerID] = NULL;
     self->ob_type->tp_free((PyObject*)self);
@@ -1609,6 +2265,8 @@ Server_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->jackautoout = 1;
     self->jackAutoConnectInputPorts = PyList_New(0);
     self->jackAutoConnectOutputPorts = PyList_New(0);
+    self->jackTransport = 0;
+    self->jackLocateCallable = NULL;
     self->samplingRate = 44100.0;
     self->nchnls = 2;
     self->ichnls = 2;
@@ -1631,8 +2289,31 @@ Server_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->recdur = -1;
     self->recformat = 0;
     self->rectype = 0;
+    self->recsync = 0;
+    self->recwriter = NULL;
     self->startoffset = 0.0;
     self->globalSeed = 0;
+    self->numThreads = 0;
+    self->pullMode = 0;
+    self->flushDenormals = 1;
+    DenormalMode_setDefault(1);
+    self->blockSize = 0;
+    self->hostBufferSize = self->bufferSize;
+    self->blockOffset = 0;
+    self->graph = NULL;
+    self->withoutGIL = 0;
+    self->dsplock = NULL;
+    self->interp = PyThreadState_GET()->interp;
+    self->callbacks = NULL;
+    self->timers = NULL;
+    self->midiring = NULL;
+    self->cbstats = CallbackStats_new();
+    self->streams = StreamList_new();
+    self->oscsender = NULL;
+    self->oscSendRate = 0.0;
+    self->midiReceived = NULL;
+    self->midiEvents = self->midiBlock = self->midiSorted = NULL;
+    self->midiEventCount = self->midiEventPos = self->midi_count = 0;
     self->thisServerID = serverID;
     Py_XDECREF(my_server[serverID]);
     my_server[serverID] = (Server *)self;
@@ -1668,6 +2349,9 @@ Server_init(Server *self, PyObject *args, PyObject *kwds)
     else if (strcmp(audioType, "embedded") == 0) {
         self->audio_be_type = PyoEmbedded;
     }
+    else if (strcmp(audioType, "shm") == 0) {
+        self->audio_be_type = PyoShm;
+    }
     else {
         Server_warning(self, "Unknown audio type. Using Portaudio\n");
         self->audio_be_type = PyoPortaudio;
@@ -1921,6 +2605,43 @@ Server_setJackAutoConnectOutputPorts(Server *self, PyObject *arg)
     return Py_None;
 }
 
+static PyObject *
+Server_setJackTransport(Server *self, PyObject *arg)
+{
+    if (arg != NULL && PyInt_Check(arg)) {
+        self->jackTransport = PyInt_AsLong(arg);
+    }
+    else {
+        Server_error(self, "Jack transport mode must be an integer.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setJackLocateCallable(Server *self, PyObject *arg)
+{
+    PyObject *tmp;
+
+    if (arg == NULL || (arg != Py_None && !PyCallable_Check(arg))) {
+        Server_error(self, "The jack locate callable attribute must be callable.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    tmp = self->jackLocateCallable;
+    if (arg == Py_None)
+        self->jackLocateCallable = NULL;
+    else {
+        Py_INCREF(arg);
+        self->jackLocateCallable = arg;
+    }
+    Py_XDECREF(tmp);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject *
 Server_setGlobalSeed(Server *self, PyObject *arg)
 {
@@ -1944,6 +2665,462 @@ Server_setGlobalSeed(Server *self, PyObject *arg)
     return Py_None;
 }
 
+static PyObject *
+Server_setNumThreads(Server *self, PyObject *arg)
+{
+    if (self->server_booted) {
+        Server_warning(self, "Can't change the number of threads for booted server.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (arg != NULL && PyInt_Check(arg)) {
+        self->numThreads = PyInt_AsLong(arg);
+        if (self->numThreads < 0)
+            self->numThreads = 0;
+    }
+    else {
+        Server_error(self, "Number of threads must be an integer.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setFlushDenormals(Server *self, PyObject *arg)
+{
+    if (arg != NULL && PyInt_Check(arg)) {
+        self->flushDenormals = PyInt_AsLong(arg) != 0;
+        DenormalMode_setDefault(self->flushDenormals);
+    }
+    else {
+        Server_error(self, "Flush denormals mode must be an integer.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setVoiceSuspension(Server *self, PyObject *arg)
+{
+    if (arg != NULL && PyInt_Check(arg)) {
+        Stream_setSuspension(PyInt_AsLong(arg) != 0);
+    }
+    else {
+        Server_error(self, "Voice suspension mode must be an integer.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setOscSendRate(Server *self, PyObject *arg)
+{
+    if (arg != NULL && PyNumber_Check(arg)) {
+        self->oscSendRate = PyFloat_AsDouble(arg);
+        if (self->oscsender != NULL)
+            OscSender_setRate(self->oscsender, self->oscSendRate);
+    }
+    else {
+        Server_error(self, "OSC send rate must be a number.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_addBus(Server *self, PyObject *args)
+{
+    int i, first, chnls = 1;
+    char *name;
+    PyObject *entry;
+
+    if (! PyArg_ParseTuple(args, "s|i", &name, &chnls))
+        return NULL;
+    if (self->server_booted == 0) {
+        Server_error(self, "The Server must be booted before adding a bus.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (self->bus_names == NULL)
+        self->bus_names = PyDict_New();
+    entry = PyDict_GetItemString(self->bus_names, name);
+    if (entry != NULL) {
+        Py_INCREF(entry);
+        return entry;
+    }
+    if (chnls < 1 || (self->bus_count + chnls) > MAX_NBR_BUSES) {
+        Server_error(self, "Can't add bus %s, the server has room for %d bus channels.\n", name, MAX_NBR_BUSES - self->bus_count);
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    DspLock_enter();
+    first = self->bus_count;
+    for (i=0; i<chnls; i++) {
+        self->buses[first+i] = (MYFLT *)pyo_aligned_calloc(2 * self->bufferSize * sizeof(MYFLT));
+    }
+    self->bus_count += chnls;
+    DspLock_leave();
+
+    entry = Py_BuildValue("(ii)", first, chnls);
+    PyDict_SetItemString(self->bus_names, name, entry);
+    return entry;
+}
+
+#ifndef _WIN32
+static PyObject *
+Server_addShmWorker(Server *self, PyObject *args)
+{
+    int send = -1, sendchnls = 0, receive = -1, receivechnls = 0;
+    char *name;
+    ShmAudio *shm;
+
+    if (! PyArg_ParseTuple(args, "s|iiii", &name, &send, &sendchnls, &receive, &receivechnls))
+        return NULL;
+    if (self->server_booted == 0) {
+        Server_error(self, "The Server must be booted before adding a worker.\n");
+        Py_INCREF(Py_False);
+        return Py_False;
+    }
+    if (self->shmworker_count >= MAX_NBR_SHM_WORKERS) {
+        Server_error(self, "Can't add worker %s, the server has room for %d workers.\n", name, MAX_NBR_SHM_WORKERS);
+        Py_INCREF(Py_False);
+        return Py_False;
+    }
+    if ((shm = ShmAudio_open(name)) == NULL) {
+        Server_error(self, "Can't add worker %s, no worker server runs with this name.\n", name);
+        Py_INCREF(Py_False);
+        return Py_False;
+    }
+    /* The blocks of the worker are the blocks of the buses. */
+    if (shm->header->bufsize != self->bufferSize ||
+        (send >= 0 && shm->header->ichnls != sendchnls) ||
+        (receive >= 0 && shm->header->nchnls != receivechnls)) {
+        Server_error(self, "Can't add worker %s, it computes %d in and %d out channels of %d samples.\n",
+                     name, shm->header->ichnls, shm->header->nchnls, shm->header->bufsize);
+        ShmAudio_close(shm);
+        Py_INCREF(Py_False);
+        return Py_False;
+    }
+    if (shm->header->sr != self->samplingRate)
+        Server_warning(self, "Worker %s runs at %f Hz.\n", name, shm->header->sr);
+
+    DspLock_enter();
+    self->shmworkers[self->shmworker_count].shm = shm;
+    self->shmworkers[self->shmworker_count].send = send;
+    self->shmworkers[self->shmworker_count].receive = receive;
+    self->shmworker_count++;
+    DspLock_leave();
+
+    Py_INCREF(Py_True);
+    return Py_True;
+}
+#endif
+
+static PyObject *
+Server_getBus(Server *self, PyObject *arg)
+{
+    PyObject *entry = NULL;
+
+    if (self->bus_names != NULL && PyString_Check(arg))
+        entry = PyDict_GetItem(self->bus_names, arg);
+    if (entry == NULL)
+        entry = Py_None;
+    Py_INCREF(entry);
+    return entry;
+}
+
+static PyObject *
+Server_getBuses(Server *self)
+{
+    if (self->bus_names == NULL)
+        return PyDict_New();
+    return PyDict_Copy(self->bus_names);
+}
+
+static PyObject *
+Server_setBlockSize(Server *self, PyObject *arg)
+{
+    if (self->server_booted) {
+        Server_warning(self, "Can't change block size for booted server.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (arg != NULL && PyInt_Check(arg)) {
+        self->blockSize = PyInt_AsLong(arg);
+    }
+    else {
+        Server_error(self, "Block size must be an integer.\n");
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setPullMode(Server *self, PyObject *arg)
+{
+    if (self->server_booted) {
+        Server_warning(self, "Can't change the pull mode for booted server.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (arg != NULL) {
+        self->pullMode = PyObject_IsTrue(arg);
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setGILFree(Server *self, PyObject *arg)
+{
+    if (self->server_booted) {
+        Server_warning(self, "Can't change the GIL mode for booted server.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    if (arg != NULL) {
+        self->withoutGIL = PyObject_IsTrue(arg);
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setParamAt(Server *self, PyObject *args)
+{
+    PyObject *obj, *value, *method, *tmp;
+    char *attr;
+    int kind = PARAM_CALL;
+    unsigned long long time = 0;
+
+    if (! PyArg_ParseTuple(args, "OsO|K", &obj, &attr, &value, &time))
+        return NULL;
+
+    if (self->params == NULL) {
+        Server_error(self, "The Server must be booted before scheduling parameter changes.\n");
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    method = PyString_FromFormat("set%c%s", toupper(attr[0]), attr+1);
+    /* Looked up on the type, an instance lookup would wait for the DSP lock. */
+    if (attr[0] == '\0' || ! PyObject_HasAttr((PyObject *)Py_TYPE(obj), method)) {
+        Server_error(self, "%s object has no attribute \"%s\".\n", Py_TYPE(obj)->tp_name, attr);
+        Py_DECREF(method);
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    if (PyNumber_Check(value) && (strcmp(attr, "mul") == 0 || strcmp(attr, "add") == 0)) {
+        kind = attr[0] == 'm' ? PARAM_MUL : PARAM_ADD;
+        tmp = PyNumber_Float(value);
+    }
+    else {
+        tmp = value;
+        Py_INCREF(tmp);
+    }
+
+    if (ParamQueue_post(self->params, obj, method, tmp, kind, time) < 0)
+        Server_warning(self, "Parameter queue is full, change of \"%s\" dropped.\n", attr);
+    Py_DECREF(tmp);
+    Py_DECREF(method);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setProfiling(Server *self, PyObject *arg)
+{
+    int i;
+
+    if (arg != NULL) {
+        DspLock_enter();
+        self->profiling = PyObject_IsTrue(arg);
+        for (i=0; i<self->streams->count; i++) {
+            if (self->streams->items[i] != NULL)
+                Stream_setProfiling(self->streams->items[i], self->profiling);
+        }
+        DspLock_leave();
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_getProfile(Server *self)
+{
+    int i;
+    Stream *stream_tmp;
+    StreamProfile *profile;
+    PyObject *dict, *key, *entry;
+
+    dict = PyDict_New();
+    DspLock_enter();
+    for (i=0; i<self->streams->count; i++) {
+        stream_tmp = self->streams->items[i];
+        if (stream_tmp == NULL)
+            continue;
+        profile = stream_tmp->profile;
+        if (profile == NULL)
+            continue;
+        entry = Py_BuildValue("{s:s,s:k,s:d,s:d}",
+                              "type", Py_TYPE(stream_tmp->streamobject)->tp_name,
+                              "count", profile->count,
+                              "total", profile->total * 1e-9,
+                              "max", profile->max * 1e-9);
+        key = PyInt_FromLong(Stream_getStreamId(stream_tmp));
+        PyDict_SetItem(dict, key, entry);
+        Py_DECREF(key);
+        Py_DECREF(entry);
+    }
+    DspLock_leave();
+
+    return dict;
+}
+
+/* Heap footprint of the streams, summed by type. */
+static PyObject *
+Server_getMemory(Server *self)
+{
+    int i;
+    size_t bytes;
+    Stream *stream_tmp;
+    PyObject *dict, *entry;
+    const char *name;
+
+    dict = PyDict_New();
+    DspLock_enter();
+    for (i=0; i<self->streams->count; i++) {
+        stream_tmp = self->streams->items[i];
+        if (stream_tmp == NULL)
+            continue;
+        name = Py_TYPE(stream_tmp->streamobject)->tp_name;
+        bytes = Stream_getMemory(stream_tmp);
+        entry = PyDict_GetItemString(dict, name);
+        if (entry == NULL) {
+            entry = Py_BuildValue("[i,n]", 1, (Py_ssize_t)bytes);
+            PyDict_SetItemString(dict, name, entry);
+            Py_DECREF(entry);
+        }
+        else {
+            PyList_SetItem(entry, 0, PyInt_FromLong(PyInt_AsLong(PyList_GET_ITEM(entry, 0)) + 1));
+            PyList_SetItem(entry, 1, PyInt_FromSsize_t(PyInt_AsSsize_t(PyList_GET_ITEM(entry, 1)) + bytes));
+        }
+    }
+    DspLock_leave();
+
+    return dict;
+}
+
+static PyObject *
+Server_getCallbackStats(Server *self)
+{
+    int i;
+    CallbackCounters c;
+    PyObject *bins, *worst, *dict;
+
+    CallbackStats_read(self->cbstats, &c);
+    bins = PyList_New(CBSTATS_BINS);
+    for (i=0; i<CBSTATS_BINS; i++) {
+        PyList_SET_ITEM(bins, i, PyInt_FromLong(c.bins[i]));
+    }
+    worst = PyList_New(0);
+    for (i=0; i<CBSTATS_WORST && c.worst[i].elapsed > 0; i++) {
+        PyObject *entry = Py_BuildValue("(dd)", c.worst[i].time, c.worst[i].elapsed * 1e-9);
+        PyList_Append(worst, entry);
+        Py_DECREF(entry);
+    }
+    dict = Py_BuildValue("{s:d,s:k,s:k,s:k,s:k,s:k,s:d,s:d,s:i,s:N,s:N}",
+                         "deadline", c.deadline * 1e-9,
+                         "count", c.count,
+                         "late", c.late,
+                         "underflows", c.underflows,
+                         "overflows", c.overflows,
+                         "xruns", c.xruns,
+                         "mean", c.count > 0 ? c.total * 1e-9 / c.count : 0.0,
+                         "max", c.max * 1e-9,
+                         "binwidth", CBSTATS_BIN_WIDTH,
+                         "histogram", bins,
+                         "worst", worst);
+    return dict;
+}
+
+static PyObject *
+Server_resetCallbackStats(Server *self)
+{
+    CallbackStats_reset(self->cbstats);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Server_setCallbackLog(Server *self, PyObject *arg)
+{
+    if (arg == Py_None || !PyObject_IsTrue(arg))
+        CallbackStats_stopLog(self->cbstats);
+    else if (CallbackStats_startLog(self->cbstats, PyString_Check(arg) ? PyString_AsString(arg) : NULL) < 0)
+        Server_error(self, "Could not start the log of the audio callbacks.\n");
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+int
+Server_isGILFree(Server *self)
+{
+    return self->callbacks != NULL;
+}
+
+void
+Server_postCallback(Server *self, PyObject *obj, PyoCallbackFunc func, double value)
+{
+    CallbackQueue_post(self->callbacks, obj, func, value);
+}
+
+unsigned long long
+Server_getCurrentSample(Server *self)
+{
+    return self->elapsedSamples;
+}
+
+OscSender *
+Server_getOscSender(Server *self)
+{
+    if (self->oscsender == NULL) {
+        self->oscsender = OscSender_new(OSC_SEND_QUEUE_SIZE);
+        if (self->oscsender == NULL)
+            Server_warning(self, "OSC warning: could not start the network thread sending the messages.\n");
+        else
+            OscSender_setRate(self->oscsender, self->oscSendRate);
+    }
+    return self->oscsender;
+}
+
+int
+Server_getClockFrame(Server *self, unsigned long long time)
+{
+    double frame = Server_clock_offset(self, time) - self->blockOffset;
+
+    if (frame < 0.0)
+        return 0;
+    else if (frame > 1e9)
+        return 1000000000;
+    return (int)frame;
+}
+
+/* Returns -1 if the server isn't booted, the caller keeps counting samples. */
+int
+Server_scheduleTimer(Server *self, TimerEvent *ev, unsigned long long time)
+{
+    if (self->timers == NULL)
+        return -1;
+    TimerWheel_schedule(self->timers, ev, time);
+    return 0;
+}
+
+/* Seed of the next random object of kind `oid`, for its PyoRand. */
 int
 Server_generateSeed(Server *self, int oid)
 {
@@ -1961,9 +3138,8 @@ Server_generateSeed(Server *self, int oid)
         seed = (unsigned) (ltime / 2) % 32768;
         curseed = seed + ((count * mult) % 32768);
     }
-    srand(curseed);
 
-    return 0;
+    return curseed;
 }
 
 static PyObject *
@@ -1985,7 +3161,6 @@ Server_setAmp(Server *self, PyObject *arg)
 static PyObject *
 Server_setAmpCallable(Server *self, PyObject *arg)
 {
-    int i;
     PyObject *tmp;
 
     if (arg == NULL) {
@@ -1998,19 +3173,6 @@ Server_setAmpCallable(Server *self, PyObject *arg)
     Py_XDECREF(self->GUI);
     Py_INCREF(tmp);
     self->GUI = tmp;
-
-    self->lastRms = (float *)realloc(self->lastRms, self->nchnls * sizeof(float));
-    for (i=0; i<self->nchnls; i++) {
-        self->lastRms[i] = 0.0;
-    }
-
-    for (i=1; i<100; i++) {
-        if ((self->bufferSize * i / self->samplingRate) > 0.045) {
-            self->numPass = i;
-            break;
-        }
-    }
-    self->gcount = 0;
     self->withGUI = 1;
 
     Py_INCREF(Py_None);
@@ -2020,7 +3182,6 @@ Server_setAmpCallable(Server *self, PyObject *arg)
 static PyObject *
 Server_setTimeCallable(Server *self, PyObject *arg)
 {
-    int i;
     PyObject *tmp;
 
     if (arg == NULL) {
@@ -2033,20 +3194,64 @@ Server_setTimeCallable(Server *self, PyObject *arg)
     Py_XDECREF(self->TIME);
     Py_INCREF(tmp);
     self->TIME = tmp;
+    self->withTIME = 1;
 
-    for (i=1; i<100; i++) {
-        if ((self->bufferSize * i / self->samplingRate) > 0.06) {
-            self->timePass = i;
-            break;
-        }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+/* Called periodically by the python side, at the refresh rate of the GUI. */
+static PyObject *
+Server_pollCallables(Server *self)
+{
+    unsigned int seq;
+    unsigned long samples;
+    float peaks[self->nchnls], rms[self->nchnls];
+
+    if (self->server_booted == 0 || self->meterPeak == NULL) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    seq = Server_read_meters(self, peaks, rms, &samples);
+    /* Nothing new while the server is stopped. */
+    if (seq != self->meterPolled) {
+        self->meterPolled = seq;
+        if (self->withGUI == 1)
+            Server_set_rms(self, peaks);
+        if (self->withTIME == 1)
+            Server_set_time(self, samples);
     }
-    self->tcount = 0;
-    self->withTIME = 1;
 
     Py_INCREF(Py_None);
     return Py_None;
 }
 
+static PyObject *
+Server_getMeters(Server *self)
+{
+    int j;
+    unsigned long samples;
+    float peaks[self->nchnls], rms[self->nchnls];
+    PyObject *lpeaks, *lrms;
+
+    lpeaks = PyList_New(self->nchnls);
+    lrms = PyList_New(self->nchnls);
+    if (self->server_booted == 0 || self->meterPeak == NULL) {
+        for (j=0; j<self->nchnls; j++) {
+            PyList_SET_ITEM(lpeaks, j, PyFloat_FromDouble(0.0));
+            PyList_SET_ITEM(lrms, j, PyFloat_FromDouble(0.0));
+        }
+    }
+    else {
+        Server_read_meters(self, peaks, rms, &samples);
+        for (j=0; j<self->nchnls; j++) {
+            PyList_SET_ITEM(lpeaks, j, PyFloat_FromDouble(peaks[j]));
+            PyList_SET_ITEM(lrms, j, PyFloat_FromDouble(rms[j]));
+        }
+    }
+    return Py_BuildValue("NN", lpeaks, lrms);
+}
+
 static PyObject *
 Server_setVerbosity(Server *self, PyObject *arg)
 {
@@ -2228,27 +3433,55 @@ Server_pm_init(Server *self)
         }
     }
     if (self->withPortMidi == 1) {
-        self->midi_count = 0;
+        self->midi_count = self->midiEventCount = 0;
         for (i=0; i<self->midiin_count; i++) {
             Pm_SetFilter(self->midiin[i], PM_FILT_ACTIVE | PM_FILT_CLOCK);
         }
+        if (self->midiring == NULL) {
+            self->midiring = MidiRing_new(MIDI_RING_SIZE);
+            self->midiReceived = (MidiRingEvent *)malloc(MIDI_RING_SIZE * sizeof(MidiRingEvent));
+            self->midiEvents = (PmEvent *)malloc(MIDI_RING_SIZE * sizeof(PmEvent));
+            self->midiSorted = (PmEvent *)malloc(2 * MIDI_RING_SIZE * sizeof(PmEvent));
+        }
+        if (MidiRing_start(self->midiring, self->midiin, self->midiin_count) < 0) {
+            Server_warning(self, "Portmidi warning: could not start the midi input thread.\n");
+            for (i=0; i<self->midiin_count; i++) {
+                Pm_Close(self->midiin[i]);
+            }
+            self->withPortMidi = 0;
+        }
     }
     return 0;
 }
 
 
+/* Chooses the block size computed by the objects, once the backend has set hostBufferSize. */
+static void
+Server_set_block_size(Server *self)
+{
+    self->bufferSize = self->hostBufferSize;
+    if (self->blockSize <= 0 || self->blockSize == self->hostBufferSize)
+        return;
+    if (self->audio_be_type == PyoOffline || self->audio_be_type == PyoOfflineNB)
+        self->bufferSize = self->blockSize;
+    else if (self->blockSize < self->hostBufferSize && (self->hostBufferSize % self->blockSize) == 0)
+        self->bufferSize = self->blockSize;
+    else
+        Server_warning(self, "Block size must divide the buffer size (%d) with a real-time backend, using %d.\n",
+                       self->hostBufferSize, self->hostBufferSize);
+}
+
 static PyObject *
 Server_boot(Server *self, PyObject *arg)
 {
     int audioerr = 0;
-    int i;
+    int i, frames;
     if (self->server_booted == 1) {
         Server_error(self, "Server already booted!\n");
         Py_INCREF(Py_None);
         return Py_None;
     }
     self->server_started = 0;
-    self->stream_count = 0;
     self->elapsedSamples = 0;
 
     int needNewBuffer = 0;
@@ -2259,7 +3492,10 @@ Server_boot(Server *self, PyObject *arg)
         Server_error(self, "The argument to set for a new buffer must be a boolean.\n");
     }
 
-    self->streams = PyList_New(0);
+    StreamList_clear(self->streams);
+    /* The backends exchange hostBufferSize frames, the objects compute bufferSize frames. */
+    self->hostBufferSize = self->bufferSize;
+    self->planarOutput = 0;
     switch (self->audio_be_type) {
         case PyoPortaudio:
             audioerr = Server_pa_init(self);
@@ -2304,26 +3540,83 @@ Server_boot(Server *self, PyObject *arg)
                 Server_embedded_deinit(self);
             }
             break;
+        case PyoShm:
+#ifndef _WIN32
+            audioerr = Server_shm_init(self);
+            if (audioerr < 0) {
+                Server_shm_deinit(self);
+            }
+#else
+            audioerr = -1;
+            Server_error(self, "Shared memory backend not available on Windows\n");
+#endif
+            break;
     }
+    Server_set_block_size(self);
+    frames = self->hostBufferSize > self->bufferSize ? self->hostBufferSize : self->bufferSize;
     if (needNewBuffer == 1){
         /* Must allocate buffer after initializing the audio backend in case parameters change there */
         if (self->input_buffer) {
             free(self->input_buffer);
         }
-        self->input_buffer = (MYFLT *)calloc(self->bufferSize * self->ichnls, sizeof(MYFLT));
+        self->input_buffer = (MYFLT *)calloc(frames * self->ichnls, sizeof(MYFLT));
         if (self->output_buffer) {
             free(self->output_buffer);
         }
-        self->output_buffer = (float *)calloc(self->bufferSize * self->nchnls, sizeof(float));
+        self->output_buffer = (float *)calloc(frames * self->nchnls, sizeof(float));
+    }
+    if (needNewBuffer == 1 || self->dac_buffer == NULL) {
+        /* Channels are aligned for the vectorized mixing */
+        pyo_aligned_free(self->dac_buffer);
+        pyo_aligned_free(self->gain_buffer);
+        pyo_aligned_free(self->input_planar);
+        self->dacFrames = PYO_ALIGN_FRAMES(frames);
+        self->dac_buffer = (MYFLT *)pyo_aligned_calloc(self->dacFrames * self->nchnls * sizeof(MYFLT));
+        self->gain_buffer = (MYFLT *)pyo_aligned_calloc(self->dacFrames * sizeof(MYFLT));
+        self->input_planar = (MYFLT *)pyo_aligned_calloc(self->dacFrames * self->ichnls * sizeof(MYFLT));
+        /* The meters are written by the audio thread, never reallocated while it runs. */
+        self->lastRms = (float *)realloc(self->lastRms, self->nchnls * sizeof(float));
+        self->lastPower = (float *)realloc(self->lastPower, self->nchnls * sizeof(float));
+        self->meterPeak = (float *)realloc(self->meterPeak, self->nchnls * sizeof(float));
+        self->meterRms = (float *)realloc(self->meterRms, self->nchnls * sizeof(float));
+    }
+    for (i=0; i<self->nchnls; i++) {
+        self->lastRms[i] = self->lastPower[i] = 0.0;
+        self->meterPeak[i] = self->meterRms[i] = 0.0;
     }
-    for (i=0; i<self->bufferSize*self->ichnls; i++) {
+    for (i=0; i<frames*self->ichnls; i++) {
         self->input_buffer[i] = 0.0;
     }
-    for (i=0; i<self->bufferSize*self->nchnls; i++) {
+    memset(self->input_planar, 0, self->dacFrames * self->ichnls * sizeof(MYFLT));
+    for (i=0; i<frames*self->nchnls; i++) {
         self->output_buffer[i] = 0.0;
     }
     if (audioerr == 0) {
         self->server_booted = 1;
+        if (self->numThreads > 0 || self->pullMode)
+            self->graph = StreamGraph_new(self->numThreads);
+        self->params = ParamQueue_new(1024);
+        self->timers = TimerWheel_new(self->bufferSize);
+        /* Offline servers compute in the thread holding the GIL, PyGILState
+           finds it. Embedded servers are called by threads of the host. */
+        PyoThreadState_init(&self->audiostate);
+        if (self->audio_be_type != PyoEmbedded)
+            self->audiostate.interp = NULL;
+        if (self->withoutGIL == 1) {
+            if (self->audio_be_type == PyoPortaudio || self->audio_be_type == PyoCoreaudio ||
+                self->audio_be_type == PyoJack || self->audio_be_type == PyoEmbedded ||
+                self->audio_be_type == PyoShm) {
+                self->dsplock = DspLock_get();
+                if (self->dsplock != NULL) {
+                    DspLock_install(PyImport_AddModule(LIB_BASE_NAME), &ServerType);
+                    self->callbacks = CallbackQueue_new(4096);
+                }
+                else
+                    Server_warning(self, "Too many interpreters run servers without the GIL.\n");
+            }
+            else
+                Server_warning(self, "Only real-time and embedded audio backends can run without the GIL.\n");
+        }
     }
     else {
         self->server_booted = 0;
@@ -2350,7 +3643,7 @@ Server_start(Server *self)
         return Py_None;
     }
 
-    Server_debug(self, "Server_start: number of streams %d\n", self->stream_count);
+    Server_debug(self, "Server_start: number of streams %d\n", self->streams->count - self->streams->holes);
 
     /* Ensure Python is set up for threading */
     PyEval_InitThreads();
@@ -2376,6 +3669,7 @@ Server_start(Server *self)
     }
 
     self->amp = self->resetAmp;
+    CallbackStats_setDeadline(self->cbstats, self->hostBufferSize, self->samplingRate);
 
     switch (self->audio_be_type) {
         case PyoPortaudio:
@@ -2400,6 +3694,11 @@ Server_start(Server *self)
         case PyoEmbedded:
             err = Server_embedded_nb_start(self);
             break;
+        case PyoShm:
+#ifndef _WIN32
+            err = Server_shm_start(self);
+#endif
+            break;
     }
     if (err) {
         Server_error(self, "Error starting server.\n");
@@ -2414,11 +3713,15 @@ Server_stop(Server *self)
 {
     int i;
     int err = -1;
+    PyThreadState *_save = NULL;
     if (self->server_started == 0) {
         Server_warning(self, "The Server must be started!\n");
         Py_INCREF(Py_None);
         return Py_None;
     }
+    /* Without the GIL, the audio thread may be waiting for it. */
+    if (self->callbacks != NULL || self->audio_be_type == PyoShm)
+        _save = PyEval_SaveThread();
     switch (self->audio_be_type) {
         case PyoPortaudio:
             err = Server_pa_stop(self);
@@ -2442,7 +3745,14 @@ Server_stop(Server *self)
         case PyoEmbedded:
             err = Server_embedded_stop(self);
             break;
+        case PyoShm:
+#ifndef _WIN32
+            err = Server_shm_stop(self);
+#endif
+            break;
     }
+    if (_save != NULL)
+        PyEval_RestoreThread(_save);
 
     if (err < 0) {
         Server_error(self, "Error stopping server.\n");
@@ -2450,6 +3760,12 @@ Server_stop(Server *self)
     else {
         self->server_stopped = 1;
         if (self->withPortMidi == 1) {
+            MidiRing_stop(self->midiring);
+            if (self->midiring->dropped > 0) {
+                Server_warning(self, "Portmidi warning: %lu midi input events were dropped, the midi input ring was full.\n",
+                               self->midiring->dropped);
+                self->midiring->dropped = 0;
+            }
             for (i=0; i<self->midiin_count; i++) {
                 Pm_Close(self->midiin[i]);
             }
@@ -2474,9 +3790,9 @@ Server_stop(Server *self)
 static PyObject *
 Server_recordOptions(Server *self, PyObject *args, PyObject *kwds)
 {
-    static char *kwlist[] = {"dur", "filename", "fileformat", "sampletype", NULL};
+    static char *kwlist[] = {"dur", "filename", "fileformat", "sampletype", "sync", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "d|sii", kwlist, &self->recdur, &self->recpath, &self->recformat, &self->rectype)) {
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "d|siii", kwlist, &self->recdur, &self->recpath, &self->recformat, &self->rectype, &self->recsync)) {
         return PyInt_FromLong(-1);
     }
 
@@ -2500,9 +3816,30 @@ Server_start_rec(Server *self, PyObject *args, PyObject *kwds)
     return Py_None;
 }
 
+/* Opens the file, through a descriptor we keep when the file is synced. */
+static SNDFILE *
+Server_open_rec(Server *self, char *path, int *fd)
+{
+    *fd = -1;
+#ifndef _WIN32
+    if (self->recsync) {
+        if ((*fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0)
+            return NULL;
+        return sf_open_fd(*fd, SFM_WRITE, &self->recinfo, 1);
+    }
+#endif
+    return sf_open(path, SFM_WRITE, &self->recinfo);
+}
+
 static int
 Server_start_rec_internal(Server *self, char *filename)
 {
+    int fd;
+
+    /* A new recording closes the previous one. */
+    if (self->recwriter != NULL)
+        Server_close_rec(self);
+
     /* Prepare sfinfo */
     self->recinfo.samplerate = (int)self->samplingRate;
     self->recinfo.channels = self->nchnls;
@@ -2566,7 +3903,7 @@ Server_start_rec_internal(Server *self, char *filename)
     /* Open the output file. */
     if (filename == NULL) {
         Server_debug(self, "recpath : %s\n", self->recpath);
-        if (! (self->recfile = sf_open(self->recpath, SFM_WRITE, &self->recinfo))) {
+        if (! (self->recfile = Server_open_rec(self, self->recpath, &fd))) {
             Server_error(self, "Not able to open output file %s.\n", self->recpath);
             Server_debug(self, "%s\n", sf_strerror(self->recfile));
             return -1;
@@ -2574,22 +3911,77 @@ Server_start_rec_internal(Server *self, char *filename)
     }
     else {
         Server_debug(self, "filename : %s\n", filename);
-        if (! (self->recfile = sf_open(filename, SFM_WRITE, &self->recinfo))) {
+        if (! (self->recfile = Server_open_rec(self, filename, &fd))) {
             Server_error(self, "Not able to open output file %s.\n", filename);
             Server_debug(self, "%s\n", sf_strerror(self->recfile));
             return -1;
         }
     }
 
+    /* Two seconds of ring between the audio callback and the disk. Offline, the
+       rendering waits for the disk instead of dropping frames. */
+    if (! (self->recwriter = DiskWriter_new(self->recfile, self->nchnls, (long)(self->samplingRate * 2)))) {
+        Server_error(self, "Not able to start the disk writer thread.\n");
+        sf_close(self->recfile);
+        self->recfile = NULL;
+        return -1;
+    }
+    if (self->audio_be_type == PyoOffline || self->audio_be_type == PyoOfflineNB)
+        DiskWriter_setBlocking(self->recwriter, 1);
+#ifdef USE_JACK
+    if (self->audio_be_type == PyoJack && ((PyoJackBackendData *) self->audio_be_data)->freewheel)
+        DiskWriter_setBlocking(self->recwriter, 1);
+#endif
+    if (fd >= 0)
+        DiskWriter_setSync(self->recwriter, fd);
+
     self->record = 1;
     return 0;
 }
 
+/* Stops the recording, the audio thread doesn't see the writer anymore. From
+   python, the DSP lock or the GIL must be held. */
+static DiskWriter *
+Server_detach_rec(Server *self)
+{
+    DiskWriter *writer = self->recwriter;
+
+    self->record = 0;
+    self->recwriter = NULL;
+    self->recfile = NULL;
+    return writer;
+}
+
+/* Drains the ring and closes the recorded file. */
+static void
+Server_finish_rec(Server *self, DiskWriter *writer)
+{
+    if (writer == NULL)
+        return;
+    if (DiskWriter_getDropped(writer) > 0)
+        Server_warning(self, "%lu frames dropped while recording, the disk was too slow.\n", DiskWriter_getDropped(writer));
+    DiskWriter_close(writer);
+}
+
+static void
+Server_close_rec(Server *self)
+{
+    Server_finish_rec(self, Server_detach_rec(self));
+}
+
 static PyObject *
 Server_stop_rec(Server *self, PyObject *args)
 {
-    self->record = 0;
-    sf_close(self->recfile);
+    DiskWriter *writer;
+
+    DspLock_enter();
+    writer = Server_detach_rec(self);
+    DspLock_leave();
+
+    /* The audio callback may need the GIL while the ring is drained. */
+    Py_BEGIN_ALLOW_THREADS
+    Server_finish_rec(self, writer);
+    Py_END_ALLOW_THREADS
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2608,30 +4000,34 @@ Server_addStream(Server *self, PyObject *args)
         return PyInt_FromLong(-1);
     }
 
-    PyList_Append(self->streams, tmp);
-
-    self->stream_count++;
+    DspLock_enter();
+    StreamList_append(self->streams, (Stream *)tmp);
+    if (self->profiling)
+        Stream_setProfiling((Stream *)tmp, 1);
+    DspLock_leave();
 
     Py_INCREF(Py_None);
     return Py_None;
 }
 
-PyObject *
-Server_removeStream(Server *self, int id)
+void
+Server_removeStream(Server *self, Stream *stream)
 {
-    int i, sid;
-    Stream *stream_tmp;
+    DspLock_enter();
+    Server_debug(self, "Removed stream id %d\n", Stream_getStreamId(stream));
+    StreamList_remove(self->streams, stream);
+    DspLock_leave();
+}
 
-    for (i=0; i<self->stream_count; i++) {
-        stream_tmp = (Stream *)PyList_GET_ITEM(self->streams, i);
-        sid = Stream_getStreamId(stream_tmp);
-        if (sid == id) {
-            Server_debug(self, "Removed stream id %d\n", id);
-            PySequence_DelItem(self->streams, i);
-            self->stream_count--;
-            break;
-        }
-    }
+static PyObject *
+Server_removeStreamFromPython(Server *self, PyObject *args)
+{
+    PyObject *tmp;
+
+    if (! PyArg_ParseTuple(args, "O!", &StreamType, &tmp))
+        return PyInt_FromLong(-1);
+
+    Server_removeStream(self, (Stream *)tmp);
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2640,36 +4036,14 @@ Server_removeStream(Server *self, int id)
 PyObject *
 Server_changeStreamPosition(Server *self, PyObject *args)
 {
-    int i, rsid, csid, sid;
-    Stream *ref_stream_tmp, *cur_stream_tmp, *stream_tmp;
+    Stream *ref_stream_tmp, *cur_stream_tmp;
 
     if (! PyArg_ParseTuple(args, "OO", &ref_stream_tmp, &cur_stream_tmp))
         return PyInt_FromLong(-1);
 
-    rsid = Stream_getStreamId(ref_stream_tmp);
-    csid = Stream_getStreamId(cur_stream_tmp);
-
-    for (i=0; i<self->stream_count; i++) {
-        stream_tmp = (Stream *)PyList_GET_ITEM(self->streams, i);
-        sid = Stream_getStreamId(stream_tmp);
-        if (sid == csid) {
-            PySequence_DelItem(self->streams, i);
-            self->stream_count--;
-            break;
-        }
-    }
-
-    for (i=0; i<self->stream_count; i++) {
-        stream_tmp = (Stream *)PyList_GET_ITEM(self->streams, i);
-        sid = Stream_getStreamId(stream_tmp);
-        if (sid == rsid) {
-            break;
-        }
-    }
-
-    Py_INCREF(cur_stream_tmp);
-    PyList_Insert(self->streams, i, (PyObject *)cur_stream_tmp);
-    self->stream_count++;
+    DspLock_enter();
+    StreamList_moveBefore(self->streams, cur_stream_tmp, ref_stream_tmp);
+    DspLock_leave();
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2827,14 +4201,24 @@ Server_bendout(Server *self, PyObject *args)
     return Py_None;
 }
 
+/* Half of a bus channel summed during the previous block, NULL if the channel doesn't exist. */
 MYFLT *
-Server_getInputBuffer(Server *self) {
-    return (MYFLT *)self->input_buffer;
+Server_getBusBuffer(Server *self, int chnl) {
+    if (chnl < 0 || chnl >= self->bus_count)
+        return NULL;
+    return self->buses[chnl] + self->bus_front * self->bufferSize;
+}
+
+MYFLT *
+Server_getInputChannel(Server *self, int chnl) {
+    if (chnl < 0 || chnl >= self->ichnls)
+        return NULL;
+    return self->input_planar + chnl * self->dacFrames + self->blockOffset;
 }
 
 PmEvent *
 Server_getMidiEventBuffer(Server *self) {
-    return (PmEvent *)self->midiEvents;
+    return self->midiBlock;
 }
 
 int
@@ -2842,6 +4226,23 @@ Server_getMidiEventCount(Server *self) {
     return self->midi_count;
 }
 
+PmEvent *
+Server_getMidiEvents(Server *self, int kind, int channel, int *count) {
+    int index;
+
+    if (self->midi_count == 0 || kind < 0 || kind >= PYO_MIDI_KINDS) {
+        *count = 0;
+        return self->midiSorted;
+    }
+    if (channel < 1 || channel > 16) {
+        *count = self->midiKindIndex[kind+1] - self->midiKindIndex[kind];
+        return self->midiSorted + self->midiKindIndex[kind];
+    }
+    index = kind * 16 + channel - 1;
+    *count = self->midiChannelIndex[index+1] - self->midiChannelIndex[index];
+    return self->midiSorted + self->midi_count + self->midiChannelIndex[index];
+}
+
 static PyObject *
 Server_getSamplingRate(Server *self)
 {
@@ -2872,6 +4273,12 @@ Server_getBufferSize(Server *self)
     return PyInt_FromLong(self->bufferSize);
 }
 
+static PyObject *
+Server_getElapsedSamples(Server *self)
+{
+    return PyLong_FromUnsignedLong(self->elapsedSamples);
+}
+
 static PyObject *
 Server_getIsStarted(Server *self)
 {
@@ -2893,8 +4300,12 @@ Server_getMidiActive(Server *self)
 static PyObject *
 Server_getStreams(Server *self)
 {
-    Py_INCREF(self->streams);
-    return self->streams;
+    PyObject *list;
+
+    DspLock_enter();
+    list = StreamList_toList(self->streams);
+    DspLock_leave();
+    return list;
 }
 
 static PyObject *
@@ -2961,6 +4372,13 @@ Server_getEmbedICallbackAddr(Server *self)
     return PyString_FromString(address);
 }
 
+/* Integer addresses, read back with PyLong_AsVoidPtr by m_pyo.h. */
+static PyObject *
+Server_getEmbedPCallback(Server *self)
+{
+    return Py_BuildValue("(NN)", PyLong_FromVoidPtr(self), PyLong_FromVoidPtr((void *)&Server_embedded_p_start));
+}
+
 static PyMethodDef Server_methods[] = {
     {"setInputDevice", (PyCFunction)Server_setInputDevice, METH_O, "Sets audio input device."},
     {"setOutputDevice", (PyCFunction)Server_setOutputDevice, METH_O, "Sets audio output device."},
@@ -2977,10 +4395,29 @@ static PyMethodDef Server_methods[] = {
     {"setJackAuto", (PyCFunction)Server_setJackAuto, METH_VARARGS, "Tells the server to auto-connect Jack ports (0 = disable, 1 = enable)."},
     {"setJackAutoConnectInputPorts", (PyCFunction)Server_setJackAutoConnectInputPorts, METH_O, "Sets a list of ports to auto-connect inputs when using Jack."},
     {"setJackAutoConnectOutputPorts", (PyCFunction)Server_setJackAutoConnectOutputPorts, METH_O, "Sets a list of ports to auto-connect outputs when using Jack."},
+    {"setJackTransport", (PyCFunction)Server_setJackTransport, METH_O, "Tells the server to follow the Jack transport (0 = disable, 1 = enable)."},
+    {"setJackLocateCallable", (PyCFunction)Server_setJackLocateCallable, METH_O, "Sets the callable receiving the Jack transport position after a locate."},
     {"setGlobalSeed", (PyCFunction)Server_setGlobalSeed, METH_O, "Sets the server's global seed for random objects."},
+    {"setNumThreads", (PyCFunction)Server_setNumThreads, METH_O, "Sets the number of worker threads used to compute the streams."},
+    {"setFlushDenormals", (PyCFunction)Server_setFlushDenormals, METH_O, "Flushes denormals to zero on the threads computing the streams."},
+    {"setVoiceSuspension", (PyCFunction)Server_setVoiceSuspension, METH_O, "Skips the streams whose output is known to be silent."},
+    {"setOscSendRate", (PyCFunction)Server_setOscSendRate, METH_O, "Sets the maximum number of OSC bundles per second sent to a destination."},
+    {"addBus", (PyCFunction)Server_addBus, METH_VARARGS, "Adds a named internal bus of one or more channels."},
+    {"getBus", (PyCFunction)Server_getBus, METH_O, "Returns the first channel and the number of channels of a bus."},
+#ifndef _WIN32
+    {"addShmWorker", (PyCFunction)Server_addShmWorker, METH_VARARGS, "Adds a worker process computing blocks of the buses."},
+#endif
+    {"getBuses", (PyCFunction)Server_getBuses, METH_NOARGS, "Returns a dictionary of the server's buses."},
+    {"setBlockSize", (PyCFunction)Server_setBlockSize, METH_O, "Sets the number of samples computed at once by the objects."},
+    {"setPullMode", (PyCFunction)Server_setPullMode, METH_O, "Computes only the streams reachable from the dac or a sink."},
+    {"setGILFree", (PyCFunction)Server_setGILFree, METH_O, "Computes the streams without holding the GIL."},
+    {"setParamAt", (PyCFunction)Server_setParamAt, METH_VARARGS, "Schedules a parameter change of an audio object at a given sample time."},
+    {"setProfiling", (PyCFunction)Server_setProfiling, METH_O, "Starts or stops the per-stream profiler."},
     {"setAmp", (PyCFunction)Server_setAmp, METH_O, "Sets the overall amplitude."},
     {"setAmpCallable", (PyCFunction)Server_setAmpCallable, METH_O, "Sets the Server's GUI callable object."},
     {"setTimeCallable", (PyCFunction)Server_setTimeCallable, METH_O, "Sets the Server's TIME callable object."},
+    {"pollCallables", (PyCFunction)Server_pollCallables, METH_NOARGS, "Sends the last meters and time to the GUI and TIME objects."},
+    {"getMeters", (PyCFunction)Server_getMeters, METH_NOARGS, "Returns the last squared peaks and rms values of the output channels."},
     {"setVerbosity", (PyCFunction)Server_setVerbosity, METH_O, "Sets the verbosity."},
     {"setStartOffset", (PyCFunction)Server_setStartOffset, METH_O, "Sets starting time offset."},
     {"boot", (PyCFunction)Server_boot, METH_O, "Setup and boot the server."},
@@ -2992,7 +4429,7 @@ static PyMethodDef Server_methods[] = {
     {"recstop", (PyCFunction)Server_stop_rec, METH_NOARGS, "Stop automatic output recording."},
     {"addStream", (PyCFunction)Server_addStream, METH_VARARGS, "Adds an audio stream to the server. \
                                                                 This is for internal use and must never be called by the user."},
-    {"removeStream", (PyCFunction)Server_removeStream, METH_VARARGS, "Adds an audio stream to the server. \
+    {"removeStream", (PyCFunction)Server_removeStreamFromPython, METH_VARARGS, "Adds an audio stream to the server. \
                                                                 This is for internal use and must never be called by the user."},
     {"changeStreamPosition", (PyCFunction)Server_changeStreamPosition, METH_VARARGS, "Puts an audio stream before another in the stack. \
                                                                 This is for internal use and must never be called by the user."},
@@ -3008,6 +4445,12 @@ static PyMethodDef Server_methods[] = {
     {"getIchnls", (PyCFunction)Server_getIchnls, METH_NOARGS, "Returns the server's current number of input channels."},
     {"getGlobalSeed", (PyCFunction)Server_getGlobalSeed, METH_NOARGS, "Returns the server's global seed."},
     {"getBufferSize", (PyCFunction)Server_getBufferSize, METH_NOARGS, "Returns the server's buffer size."},
+    {"getProfile", (PyCFunction)Server_getProfile, METH_NOARGS, "Returns the processing time of every profiled stream."},
+    {"getMemory", (PyCFunction)Server_getMemory, METH_NOARGS, "Returns the count and the heap memory of the streams, by type."},
+    {"getCallbackStats", (PyCFunction)Server_getCallbackStats, METH_NOARGS, "Returns the timing and the xruns of the audio callbacks."},
+    {"resetCallbackStats", (PyCFunction)Server_resetCallbackStats, METH_NOARGS, "Clears the timing and the xruns of the audio callbacks."},
+    {"setCallbackLog", (PyCFunction)Server_setCallbackLog, METH_O, "Logs the late callbacks and the xruns to a file, to stderr if True, stops if None."},
+    {"getElapsedSamples", (PyCFunction)Server_getElapsedSamples, METH_NOARGS, "Returns the number of samples computed since the server was started."},
     {"getIsBooted", (PyCFunction)Server_getIsBooted, METH_NOARGS, "Returns 1 if the server is booted, otherwise returns 0."},
     {"getIsStarted", (PyCFunction)Server_getIsStarted, METH_NOARGS, "Returns 1 if the server is started, otherwise returns 0."},
     {"getMidiActive", (PyCFunction)Server_getMidiActive, METH_NOARGS, "Returns 1 if midi callback is active, otherwise returns 0."},
@@ -3018,11 +4461,11 @@ static PyMethodDef Server_methods[] = {
     {"getServerID", (PyCFunction)Server_getServerID, METH_NOARGS, "Get the embedded device server memory address"},
     {"getServerAddr", (PyCFunction)Server_getServerAddr, METH_NOARGS, "Get the embedded device server memory address"},
     {"getEmbedICallbackAddr", (PyCFunction)Server_getEmbedICallbackAddr, METH_NOARGS, "Get the embedded device interleaved callback method memory address"},
+    {"getEmbedPCallback", (PyCFunction)Server_getEmbedPCallback, METH_NOARGS, "Get the addresses of the server and of the embedded device planar callback"},
     {NULL}  /* Sentinel */
 };
 
 static PyMemberDef Server_members[] = {
-    {"streams", T_OBJECT_EX, offsetof(Server, streams), 0, "Server's streams list."},
     {NULL}  /* Sentinel */
 };
 
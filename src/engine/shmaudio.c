@@ -0,0 +1,322 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+/* POSIX shared memory, not built on Windows. */
+#ifndef _WIN32
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "shmaudio.h"
+
+#define SHMAUDIO_MAGIC 0x70796f73
+/* Without futex, a waiting side checks the counter every 100 microseconds. */
+#define SHMAUDIO_POLL 100
+
+static unsigned long long
+ShmAudio_now(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (unsigned long long)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+/* Sleeps until the counter at `addr` changes from `value`, or until
+   `deadline`. Returns 0 once the deadline is passed. */
+static int
+ShmAudio_sleep(volatile unsigned int *addr, unsigned int value, unsigned long long deadline)
+{
+    struct timespec ts;
+    unsigned long long now = ShmAudio_now();
+    long timeout;
+
+    if (now >= deadline)
+        return 0;
+    timeout = (long)(deadline - now);
+#ifdef __linux__
+    ts.tv_sec = timeout / 1000000;
+    ts.tv_nsec = (timeout % 1000000) * 1000;
+    /* Not private, the counter is shared with another process. */
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAIT, value, &ts, NULL, 0);
+#else
+    ts.tv_sec = 0;
+    ts.tv_nsec = (timeout < SHMAUDIO_POLL ? timeout : SHMAUDIO_POLL) * 1000;
+    nanosleep(&ts, NULL);
+#endif
+    return 1;
+}
+
+static void
+ShmAudio_wake(volatile unsigned int *addr)
+{
+#ifdef __linux__
+    syscall(SYS_futex, (unsigned int *)addr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+#endif
+}
+
+static ShmAudio *
+ShmAudio_map(const char *name, int fd, size_t size, int owner)
+{
+    void *mem;
+    ShmAudio *self;
+
+    mem = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (mem == MAP_FAILED)
+        return NULL;
+
+    self = (ShmAudio *)calloc(1, sizeof(ShmAudio));
+    self->header = (ShmAudioHeader *)mem;
+    self->size = size;
+    self->owner = owner;
+    strncpy(self->name, name, 63);
+    return self;
+}
+
+/* Blocks follow the header, aligned on 64 bytes. */
+static void
+ShmAudio_layout(ShmAudio *self)
+{
+    ShmAudioHeader *h = self->header;
+    size_t offset = (sizeof(ShmAudioHeader) + 63) & ~(size_t)63;
+
+    self->in = (float *)((char *)h + offset);
+    self->out = self->in + SHMAUDIO_DEPTH * h->ichnls * h->bufsize;
+}
+
+static size_t
+ShmAudio_size(int bufsize, int ichnls, int nchnls)
+{
+    size_t offset = (sizeof(ShmAudioHeader) + 63) & ~(size_t)63;
+    return offset + SHMAUDIO_DEPTH * (size_t)(ichnls + nchnls) * bufsize * sizeof(float);
+}
+
+ShmAudio *
+ShmAudio_create(const char *name, double sr, int bufsize, int ichnls, int nchnls)
+{
+    int fd;
+    char path[64];
+    size_t size = ShmAudio_size(bufsize, ichnls, nchnls);
+    ShmAudio *self;
+    ShmAudioHeader *h;
+
+    snprintf(path, 64, "/pyo-%s", name);
+    /* A segment left by a worker which didn't shut down. */
+    shm_unlink(path);
+    fd = shm_open(path, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0)
+        return NULL;
+    if (ftruncate(fd, size) != 0) {
+        close(fd);
+        shm_unlink(path);
+        return NULL;
+    }
+    if ((self = ShmAudio_map(path, fd, size, 1)) == NULL) {
+        shm_unlink(path);
+        return NULL;
+    }
+
+    h = self->header;
+    memset(h, 0, size);
+    h->bufsize = bufsize;
+    h->ichnls = ichnls;
+    h->nchnls = nchnls;
+    h->sr = sr;
+    ShmAudio_layout(self);
+    /* The host checks the magic, the header must be complete before. */
+    __sync_synchronize();
+    h->magic = SHMAUDIO_MAGIC;
+    return self;
+}
+
+ShmAudio *
+ShmAudio_open(const char *name)
+{
+    int fd;
+    char path[64];
+    struct stat st;
+    ShmAudio *self;
+    ShmAudioHeader *h;
+
+    snprintf(path, 64, "/pyo-%s", name);
+    fd = shm_open(path, O_RDWR, 0600);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(ShmAudioHeader)) {
+        close(fd);
+        return NULL;
+    }
+    if ((self = ShmAudio_map(path, fd, (size_t)st.st_size, 0)) == NULL)
+        return NULL;
+
+    h = self->header;
+    if (h->magic != SHMAUDIO_MAGIC || h->closed ||
+        self->size < ShmAudio_size(h->bufsize, h->ichnls, h->nchnls)) {
+        ShmAudio_close(self);
+        return NULL;
+    }
+    ShmAudio_layout(self);
+    /* Blocks written before a previous host went away are never answered. */
+    h->out_read = h->out_written;
+    return self;
+}
+
+void
+ShmAudio_close(ShmAudio *self)
+{
+    if (self == NULL)
+        return;
+    if (self->owner) {
+        self->header->closed = 1;
+        __sync_synchronize();
+        ShmAudio_wake(&self->header->out_written);
+        shm_unlink(self->name);
+    }
+    munmap((void *)self->header, self->size);
+    free(self);
+}
+
+/**************************/
+/*** Worker side ***/
+/**************************/
+
+float *
+ShmAudio_waitInput(ShmAudio *self, long timeout)
+{
+    unsigned int written;
+    ShmAudioHeader *h = self->header;
+    unsigned long long deadline = ShmAudio_now() + timeout;
+
+    while ((written = h->in_written) == h->in_read) {
+        if (!ShmAudio_sleep(&h->in_written, written, deadline))
+            return NULL;
+    }
+    __sync_synchronize();
+    return self->in + (h->in_read % SHMAUDIO_DEPTH) * h->ichnls * h->bufsize;
+}
+
+void
+ShmAudio_doneInput(ShmAudio *self)
+{
+    __sync_synchronize();
+    self->header->in_read++;
+}
+
+float *
+ShmAudio_waitOutput(ShmAudio *self, long timeout)
+{
+    unsigned int read;
+    ShmAudioHeader *h = self->header;
+    unsigned long long deadline = ShmAudio_now() + timeout;
+
+    while (h->out_written - (read = h->out_read) >= SHMAUDIO_DEPTH) {
+        if (!ShmAudio_sleep(&h->out_read, read, deadline))
+            return NULL;
+    }
+    __sync_synchronize();
+    return self->out + (h->out_written % SHMAUDIO_DEPTH) * h->nchnls * h->bufsize;
+}
+
+void
+ShmAudio_commitOutput(ShmAudio *self)
+{
+    /* The block must be visible before the new count. */
+    __sync_synchronize();
+    self->header->out_written++;
+    ShmAudio_wake(&self->header->out_written);
+}
+
+/**************************/
+/*** Host side ***/
+/**************************/
+
+float *
+ShmAudio_reserveInput(ShmAudio *self)
+{
+    ShmAudioHeader *h = self->header;
+
+    self->sent = 0;
+    if (h->closed || h->in_written - h->in_read >= SHMAUDIO_DEPTH) {
+        self->dropped++;
+        return NULL;
+    }
+    __sync_synchronize();
+    return self->in + (h->in_written % SHMAUDIO_DEPTH) * h->ichnls * h->bufsize;
+}
+
+void
+ShmAudio_commitInput(ShmAudio *self)
+{
+    __sync_synchronize();
+    self->header->in_written++;
+    self->sent = 1;
+    ShmAudio_wake(&self->header->in_written);
+}
+
+float *
+ShmAudio_receive(ShmAudio *self, long timeout)
+{
+    unsigned int written;
+    ShmAudioHeader *h = self->header;
+    unsigned int block = h->in_written - 1;
+    unsigned long long deadline = ShmAudio_now() + timeout;
+
+    if (!self->sent)
+        return NULL;
+    /* Late answers are never read, the worker can reuse their slots. */
+    if ((int)(block - h->out_read) > 0) {
+        h->out_read = block;
+        ShmAudio_wake(&h->out_read);
+    }
+    while ((int)((written = h->out_written) - block) <= 0) {
+        if (h->closed || !ShmAudio_sleep(&h->out_written, written, deadline)) {
+            self->late++;
+            self->sent = 0;
+            return NULL;
+        }
+    }
+    __sync_synchronize();
+    return self->out + (block % SHMAUDIO_DEPTH) * h->nchnls * h->bufsize;
+}
+
+void
+ShmAudio_doneOutput(ShmAudio *self)
+{
+    ShmAudioHeader *h = self->header;
+
+    __sync_synchronize();
+    /* The answers skipped as late are freed with this one. */
+    h->out_read = h->in_written;
+    self->sent = 0;
+    ShmAudio_wake(&h->out_read);
+}
+
+#endif
@@ -0,0 +1,204 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <math.h>
+#include "sinekernel.h"
+#include "simd.h"
+
+/* Odd coefficients of the minimax fits of sin(2 * pi * y) for
+ * -0.25 <= y <= 0.25. */
+#define SINE_FAST_C1 6.2812800766225845
+#define SINE_FAST_C3 -41.095242687125875
+#define SINE_FAST_C5 73.585514734654865
+
+#define SINE_HIGH_C1 6.283185160089479
+#define SINE_HIGH_C3 -41.341655031416508
+#define SINE_HIGH_C5 81.601004073273572
+#define SINE_HIGH_C7 -76.549782293829054
+#define SINE_HIGH_C9 39.536706067302177
+
+MYFLT
+SineKernel_sample(MYFLT x, int accuracy)
+{
+    MYFLT t, y, y2;
+
+    /* Folds the phase to [-0.25, 0.25], where the sine is odd. */
+    t = x - MYFLOOR(x + (MYFLT)0.5);
+    y = t;
+    if (y > (MYFLT)0.25)
+        y = (MYFLT)0.5 - t;
+    else if (y < (MYFLT)-0.25)
+        y = (MYFLT)-0.5 - t;
+    y2 = y * y;
+
+    if (accuracy == SINE_ACCURACY_FAST)
+        return y * ((MYFLT)SINE_FAST_C1 + y2 * ((MYFLT)SINE_FAST_C3 + y2 * (MYFLT)SINE_FAST_C5));
+    else
+        return y * ((MYFLT)SINE_HIGH_C1 + y2 * ((MYFLT)SINE_HIGH_C3 + y2 * ((MYFLT)SINE_HIGH_C5 +
+               y2 * ((MYFLT)SINE_HIGH_C7 + y2 * (MYFLT)SINE_HIGH_C9))));
+}
+
+#if defined(VSIZE) && defined(VFLOOR)
+/* Adding and removing SINE_ROUND rounds to the nearest integer, below 2^22
+ * cycles in single precision. */
+#if defined(USE_DOUBLE)
+#define SINE_ROUND 6755399441055744.0
+#else
+#define SINE_ROUND 12582912.0f
+#endif
+
+static inline VTYPE
+SineKernel_vector(VTYPE v, int accuracy)
+{
+    VTYPE y, y2, half = VSET1(0.5), mhalf = VSET1(-0.5), round = VSET1(SINE_ROUND);
+
+    v = VSUB(v, VSUB(VADD(v, round), round));
+    y = VMAX(VMIN(v, VSUB(half, v)), VSUB(mhalf, v));
+    y2 = VMUL(y, y);
+    if (accuracy == SINE_ACCURACY_FAST) {
+        v = VADD(VSET1(SINE_FAST_C3), VMUL(y2, VSET1(SINE_FAST_C5)));
+        v = VADD(VSET1(SINE_FAST_C1), VMUL(y2, v));
+    }
+    else {
+        v = VADD(VSET1(SINE_HIGH_C7), VMUL(y2, VSET1(SINE_HIGH_C9)));
+        v = VADD(VSET1(SINE_HIGH_C5), VMUL(y2, v));
+        v = VADD(VSET1(SINE_HIGH_C3), VMUL(y2, v));
+        v = VADD(VSET1(SINE_HIGH_C1), VMUL(y2, v));
+    }
+    return VMUL(y, v);
+}
+#endif
+
+void
+SineKernel_process(MYFLT *x, MYFLT *out, int num, int accuracy)
+{
+    int i = 0;
+
+#if defined(VSIZE) && defined(VFLOOR)
+    if (accuracy == SINE_ACCURACY_FAST) {
+        for (; i <= num - VSIZE; i += VSIZE) {
+            VSTORE(out + i, SineKernel_vector(VLOAD(x + i), SINE_ACCURACY_FAST));
+        }
+    }
+    else {
+        for (; i <= num - VSIZE; i += VSIZE) {
+            VSTORE(out + i, SineKernel_vector(VLOAD(x + i), SINE_ACCURACY_HIGH));
+        }
+    }
+#endif
+
+    for (; i<num; i++) {
+        out[i] = SineKernel_sample(x[i], accuracy);
+    }
+}
+
+/* Ramp kernels, VECTOR and SAMPLE compute the output from the phase (`vv`
+ * or `v`), so that the sine is evaluated in the same loop. */
+#define SINEKERNEL_RAMP(NAME, VECTOR, SAMPLE) \
+static double \
+NAME(MYFLT *out, double pos, double inc, MYFLT offset, int num, int accuracy) \
+{ \
+    int i = 0, j; \
+    MYFLT v; \
+    SINEKERNEL_RAMP_VECTOR(VECTOR) \
+    for (; i<num; i++) { \
+        v = (MYFLT)pos + offset; \
+        out[i] = SAMPLE; \
+        pos += inc; \
+        if (pos >= 1.0 || pos < 0.0) \
+            pos -= floor(pos); \
+    } \
+    return pos; \
+}
+
+/* Each vector restarts from the double phase. */
+#if defined(VSIZE) && defined(VFLOOR)
+#define SINEKERNEL_RAMP_VECTOR(VECTOR) \
+    MYFLT lanes[VSIZE]; \
+    VTYPE vv, vlanes; \
+    double step = inc * VSIZE; \
+    for (j=0; j<VSIZE; j++) { \
+        lanes[j] = (MYFLT)(inc * j); \
+    } \
+    vlanes = VLOAD(lanes); \
+    for (; i <= num - VSIZE; i += VSIZE) { \
+        vv = VADD(VSET1((MYFLT)pos + offset), vlanes); \
+        VSTORE(out + i, VECTOR); \
+        pos += step; \
+        if (pos >= 1.0 || pos < 0.0) \
+            pos -= floor(pos); \
+    }
+#else
+#define SINEKERNEL_RAMP_VECTOR(VECTOR)
+#endif
+
+SINEKERNEL_RAMP(SineKernel_rampOnly, VSUB(vv, VFLOOR(vv)), v - MYFLOOR(v))
+SINEKERNEL_RAMP(SineKernel_rampFast, SineKernel_vector(vv, SINE_ACCURACY_FAST), SineKernel_sample(v, accuracy))
+SINEKERNEL_RAMP(SineKernel_rampHigh, SineKernel_vector(vv, SINE_ACCURACY_HIGH), SineKernel_sample(v, accuracy))
+
+double
+SineKernel_ramp(MYFLT *out, double pos, double inc, MYFLT offset, int num)
+{
+    return SineKernel_rampOnly(out, pos, inc, offset, num, 0);
+}
+
+double
+SineKernel_oscillate(MYFLT *out, double pos, double inc, MYFLT offset, int num, int accuracy)
+{
+    if (accuracy == SINE_ACCURACY_FAST)
+        return SineKernel_rampFast(out, pos, inc, offset, num, accuracy);
+    else
+        return SineKernel_rampHigh(out, pos, inc, offset, num, accuracy);
+}
+
+void
+SineKernel_blit(MYFLT *x, MYFLT *m, MYFLT cm, MYFLT *out, int num)
+{
+    int i = 0, j;
+    MYFLT mm, xx, scale = (MYFLT)(1.0 / TWOPI);
+
+#if defined(VSIZE) && defined(VFLOOR)
+    VTYPE vx, vm = VSET1(cm), vscale = VSET1(scale);
+
+    for (; i <= num - VSIZE; i += VSIZE) {
+        vx = VMUL(VLOAD(x + i), vscale);
+        if (m != NULL)
+            vm = VLOAD(m + i);
+        VSTORE(out + i, VDIV(SineKernel_vector(VMUL(vm, vx), SINE_ACCURACY_HIGH),
+                             VMUL(vm, SineKernel_vector(vx, SINE_ACCURACY_HIGH))));
+    }
+    /* The vectors divide 0 by 0 there. */
+    for (j=0; j<i; j++) {
+        if (x[j] <= 0.0)
+            out[j] = 1.0;
+    }
+#endif
+
+    for (; i<num; i++) {
+        if (x[i] <= 0.0)
+            out[i] = 1.0;
+        else {
+            mm = m == NULL ? cm : m[i];
+            xx = x[i] * scale;
+            out[i] = SineKernel_sample(mm * xx, SINE_ACCURACY_HIGH) / (mm * SineKernel_sample(xx, SINE_ACCURACY_HIGH));
+        }
+    }
+}
@@ -0,0 +1,215 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+#include "sndmap.h"
+
+#ifndef _WIN32
+
+#define SNDMAP_VERSION 1
+#define SNDMAP_CHUNK 65536
+
+/* 64 bytes, the samples start right after. */
+typedef struct {
+    char magic[4];
+    int32_t version;
+    int32_t bits;
+    int32_t chnl;
+    int64_t sndSr;
+    int64_t start;
+    int64_t size;
+    int64_t srcsize;
+    int64_t srcmtime;
+    int64_t unused;
+} SndMapHeader;
+
+static void
+SndMap_fillHeader(SndMapHeader *header, struct stat *src, SF_INFO *info, int chnl, long start, long size)
+{
+    memset(header, 0, sizeof(SndMapHeader));
+    memcpy(header->magic, "PYSM", 4);
+    header->version = SNDMAP_VERSION;
+    header->bits = (int32_t)(sizeof(MYFLT) * 8);
+    header->chnl = chnl;
+    header->sndSr = info->samplerate;
+    header->start = start;
+    header->size = size;
+    header->srcsize = (int64_t)src->st_size;
+    header->srcmtime = (int64_t)src->st_mtime;
+}
+
+/* Decodes the channel in a temporary file renamed once complete, so that a
+ * cache file is never seen half written. */
+static int
+SndMap_write(const char *cachepath, SndMapHeader *header, SNDFILE *sf, int num_chnls, int chnl)
+{
+    int i, num;
+    long written = 0, frames;
+    MYFLT first = 0.0;
+    MYFLT *tmp, *out;
+    FILE *fp;
+    char *tmppath;
+
+    tmppath = (char *)malloc(strlen(cachepath) + 32);
+    sprintf(tmppath, "%s.%d.tmp", cachepath, (int)getpid());
+    fp = fopen(tmppath, "wb");
+    if (fp == NULL) {
+        free(tmppath);
+        return -1;
+    }
+    fwrite(header, sizeof(SndMapHeader), 1, fp);
+
+    tmp = (MYFLT *)malloc(SNDMAP_CHUNK * num_chnls * sizeof(MYFLT));
+    out = (MYFLT *)malloc(SNDMAP_CHUNK * sizeof(MYFLT));
+    sf_seek(sf, header->start, SEEK_SET);
+    while (written < header->size) {
+        frames = header->size - written;
+        if (frames > SNDMAP_CHUNK)
+            frames = SNDMAP_CHUNK;
+        num = (int)(SF_READ(sf, tmp, frames * num_chnls) / num_chnls);
+        for (i=0; i<num; i++)
+            out[i] = tmp[i*num_chnls+chnl];
+        /* A truncated file ends with silence, as in memory. */
+        for (i=num; i<frames; i++)
+            out[i] = 0.0;
+        if (written == 0)
+            first = out[0];
+        if (fwrite(out, sizeof(MYFLT), frames, fp) != (size_t)frames)
+            break;
+        written += frames;
+    }
+    free(tmp);
+    free(out);
+
+    if (written < header->size || fwrite(&first, sizeof(MYFLT), 1, fp) != 1) {
+        fclose(fp);
+        remove(tmppath);
+        free(tmppath);
+        return -1;
+    }
+    if (fclose(fp) != 0 || rename(tmppath, cachepath) != 0) {
+        remove(tmppath);
+        free(tmppath);
+        return -1;
+    }
+    free(tmppath);
+    return 0;
+}
+
+static SndMap *
+SndMap_map(const char *cachepath, SndMapHeader *expected)
+{
+    int fd;
+    struct stat st;
+    void *map;
+    size_t length = sizeof(SndMapHeader) + (expected->size + 1) * sizeof(MYFLT);
+    SndMap *self;
+
+    fd = open(cachepath, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size != length) {
+        close(fd);
+        return NULL;
+    }
+    map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return NULL;
+    if (memcmp(map, expected, sizeof(SndMapHeader)) != 0) {
+        munmap(map, length);
+        return NULL;
+    }
+
+    self = (SndMap *)malloc(sizeof(SndMap));
+    self->map = map;
+    self->maplength = length;
+    self->size = (long)expected->size;
+    self->data = (MYFLT *)((char *)map + sizeof(SndMapHeader));
+    return self;
+}
+
+SndMap *
+SndMap_open(const char *cachedir, const char *path, SNDFILE *sf, SF_INFO *info, int chnl, long start, long size)
+{
+    const char *base;
+    char *cachepath;
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char *c;
+    struct stat src;
+    SndMapHeader header;
+    SndMap *self;
+
+    if (size <= 0 || chnl < 0 || chnl >= info->channels || stat(path, &src) < 0)
+        return NULL;
+
+    /* The full path names the cache file, the region and the precision
+     * make different files. */
+    for (c=(const unsigned char *)path; *c; c++) {
+        hash ^= *c;
+        hash *= 1099511628211ULL;
+    }
+    base = strrchr(path, '/');
+    base = base == NULL ? path : base + 1;
+    cachepath = (char *)malloc(strlen(cachedir) + strlen(base) + 96);
+    sprintf(cachepath, "%s/%s-%016llx-c%d-%ld-%ld-%d.raw", cachedir, base,
+            (unsigned long long)hash, chnl, start, size, (int)(sizeof(MYFLT) * 8));
+
+    SndMap_fillHeader(&header, &src, info, chnl, start, size);
+    self = SndMap_map(cachepath, &header);
+    if (self == NULL) {
+        if (SndMap_write(cachepath, &header, sf, info->channels, chnl) == 0)
+            self = SndMap_map(cachepath, &header);
+    }
+    free(cachepath);
+    return self;
+}
+
+void
+SndMap_close(SndMap *self)
+{
+    if (self == NULL)
+        return;
+    munmap(self->map, self->maplength);
+    free(self);
+}
+
+#else
+
+SndMap *
+SndMap_open(const char *cachedir, const char *path, SNDFILE *sf, SF_INFO *info, int chnl, long start, long size)
+{
+    return NULL;
+}
+
+void
+SndMap_close(SndMap *self) {}
+
+#endif
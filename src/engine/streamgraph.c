@@ -0,0 +1,537 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pyomodule.h"
+#include "streammodule.h"
+#include "pvstreammodule.h"
+#include "servermodule.h"
+#include "streamgraph.h"
+
+/* How deep references are followed inside objects which are not streams (lists, tables, ...).
+   The Dummies computed in the chain of another one are always followed. */
+#define GRAPH_MAX_DEPTH 2
+#define GRAPH_FOLLOW(obj, depth) ((depth) < GRAPH_MAX_DEPTH || PyObject_TypeCheck(obj, &DummyType))
+/* Objects process their buffers in variable length arrays, give the workers room for them. */
+#define GRAPH_STACK_SIZE (8 * 1024 * 1024)
+
+#define GRAPH_RESERVE(ptr, size, need, type) \
+    if ((need) > (size)) { \
+        while ((need) > (size)) (size) = (size) ? (size) * 2 : 64; \
+        (ptr) = (type *)realloc((ptr), (size) * sizeof(type)); \
+    }
+
+typedef struct {
+    void *key;
+    int stamp;      /* buffer stamp, the entry is empty if it doesn't match */
+    int segment;    /* segment stamp, writer, readers and seen are reset if it doesn't match */
+    int sidx;       /* position in the stream list, -1 for any other object */
+    int writer;     /* last node which wrote this object */
+    int readers;    /* nodes which read it since the last write (index in rpool) */
+    int seen;       /* last node which referenced it */
+} GraphEntry;
+
+typedef struct {
+    int node;
+    int next;
+} GraphReader;
+
+struct StreamGraph {
+    /* pointer -> entry hash table, rebuilt every buffer */
+    GraphEntry *table;
+    int tsize;
+    int tcount;
+    int stamp;
+    int segment;
+
+    /* streams of the server's list */
+    Stream **list;
+    int *nodeof;    /* node of each stream, -1 if inactive or outside the current segment */
+    int lsize;
+
+    /* nodes of the current segment */
+    int *nodes;     /* position in the stream list */
+    int *pending;   /* predecessors not yet computed */
+    int *sstart;    /* successors of node k are succ[sstart[k]] to succ[sstart[k+1]-1] */
+    int *succ;
+    int ssize;
+    int *markin;
+    int *markout;
+    int *ready;
+    int nsize;
+    int nnodes;
+    int head;
+    int tail;
+    int remaining;
+    int gwriter;    /* last node flagged as writing shared state */
+
+    int *efrom;
+    int *eto;
+    int ecount;
+    int esize;
+
+    GraphReader *rpool;
+    int rcount;
+    int rsize;
+
+    /* streams reached by the pull pass, not traversed yet */
+    int *stack;
+    int stsize;
+
+    /* references collected by tp_traverse */
+    PyObject **refs;
+    int *rdepth;
+    int rfill;
+    int refsize;
+    int depth;
+
+    /* worker pool */
+    pthread_t *threads;
+    int nthreads;
+    int quit;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+};
+
+static GraphEntry *
+StreamGraph_lookup(StreamGraph *self, void *key)
+{
+    int i, mask;
+    GraphEntry *entry;
+
+    if ((self->tcount * 2) >= self->tsize) {
+        GraphEntry *old = self->table;
+        int oldsize = self->tsize;
+        self->tsize *= 2;
+        self->table = (GraphEntry *)calloc(self->tsize, sizeof(GraphEntry));
+        mask = self->tsize - 1;
+        for (i=0; i<oldsize; i++) {
+            if (old[i].stamp == self->stamp) {
+                int j = (int)((((size_t)old[i].key >> 4) * 2654435761u) & mask);
+                while (self->table[j].stamp == self->stamp)
+                    j = (j + 1) & mask;
+                self->table[j] = old[i];
+            }
+        }
+        free(old);
+    }
+
+    mask = self->tsize - 1;
+    i = (int)((((size_t)key >> 4) * 2654435761u) & mask);
+    while (self->table[i].stamp == self->stamp) {
+        if (self->table[i].key == key)
+            break;
+        i = (i + 1) & mask;
+    }
+    entry = &self->table[i];
+    if (entry->stamp != self->stamp) {
+        entry->key = key;
+        entry->stamp = self->stamp;
+        entry->segment = 0;
+        entry->sidx = -1;
+        self->tcount++;
+    }
+    if (entry->segment != self->segment) {
+        entry->segment = self->segment;
+        entry->writer = entry->readers = entry->seen = -1;
+    }
+    return entry;
+}
+
+static int
+StreamGraph_visit(PyObject *obj, void *arg)
+{
+    StreamGraph *self = (StreamGraph *)arg;
+    GRAPH_RESERVE(self->refs, self->refsize, self->rfill + 1, PyObject *);
+    self->rdepth = (int *)realloc(self->rdepth, self->refsize * sizeof(int));
+    self->refs[self->rfill] = obj;
+    self->rdepth[self->rfill++] = self->depth;
+    return 0;
+}
+
+static void
+StreamGraph_traverse(StreamGraph *self, PyObject *obj, int depth)
+{
+    traverseproc traverse = Py_TYPE(obj)->tp_traverse;
+    if (traverse != NULL && PyType_IS_GC(Py_TYPE(obj))) {
+        self->depth = depth;
+        traverse(obj, StreamGraph_visit, (void *)self);
+    }
+}
+
+static int
+StreamGraph_isConstant(PyObject *obj)
+{
+    return (obj == Py_None || PyFloat_Check(obj) || PyInt_Check(obj) || PyLong_Check(obj) ||
+            PyString_Check(obj) || PyUnicode_Check(obj) || PyType_Check(obj) || PyModule_Check(obj) ||
+            PyCFunction_Check(obj) || PyObject_TypeCheck(obj, &ServerType));
+}
+
+static void
+StreamGraph_addEdge(StreamGraph *self, int from, int to, int node)
+{
+    /* `node` is the node being collected, one of `from` or `to`. */
+    if (from == to)
+        return;
+    if (to == node) {
+        if (self->markin[from] == node)
+            return;
+        self->markin[from] = node;
+    }
+    else {
+        if (self->markout[to] == node)
+            return;
+        self->markout[to] = node;
+    }
+    GRAPH_RESERVE(self->efrom, self->esize, self->ecount + 1, int);
+    self->eto = (int *)realloc(self->eto, self->esize * sizeof(int));
+    self->efrom[self->ecount] = from;
+    self->eto[self->ecount++] = to;
+}
+
+static void
+StreamGraph_reference(StreamGraph *self, int node, PyObject *obj, int depth, int shared)
+{
+    int other, r, write;
+    GraphEntry *entry;
+
+    if (StreamGraph_isConstant(obj))
+        return;
+
+    entry = StreamGraph_lookup(self, (void *)obj);
+    if (entry->seen == node)
+        return;
+    entry->seen = node;
+
+    if (entry->sidx >= 0) {
+        /* Another stream: it must be computed before this node if it comes first
+           in the list, after (stale values) if it comes later. */
+        other = self->nodeof[entry->sidx];
+        if (other >= 0) {
+            if (other < node)
+                StreamGraph_addEdge(self, other, node, node);
+            else
+                StreamGraph_addEdge(self, node, other, node);
+        }
+        return;
+    }
+
+    /* Any other object. Trigger and pv streams are filled by their owner and
+       shared streams may write in everything they hold. */
+    write = shared || PyObject_TypeCheck(obj, &TriggerStreamType) || PyObject_TypeCheck(obj, &PVStreamType);
+    if (entry->writer >= 0)
+        StreamGraph_addEdge(self, entry->writer, node, node);
+    if (write) {
+        for (r=entry->readers; r>=0; r=self->rpool[r].next) {
+            StreamGraph_addEdge(self, self->rpool[r].node, node, node);
+        }
+        entry->readers = -1;
+        entry->writer = node;
+    }
+    else {
+        GRAPH_RESERVE(self->rpool, self->rsize, self->rcount + 1, GraphReader);
+        self->rpool[self->rcount].node = node;
+        self->rpool[self->rcount].next = entry->readers;
+        entry->readers = self->rcount++;
+    }
+
+    if (GRAPH_FOLLOW(obj, depth))
+        StreamGraph_traverse(self, obj, depth + 1);
+}
+
+static void
+StreamGraph_collect(StreamGraph *self, int node)
+{
+    int i;
+    Stream *stream = self->list[self->nodes[node]];
+    PyObject *obj = stream->streamobject;
+
+    StreamGraph_lookup(self, (void *)stream)->seen = node;
+    StreamGraph_lookup(self, (void *)obj)->seen = node;
+
+    self->rfill = 0;
+    StreamGraph_traverse(self, obj, 1);
+    for (i=0; i<self->rfill; i++) {
+        StreamGraph_reference(self, node, self->refs[i], self->rdepth[i], stream->shared);
+    }
+
+    if (stream->shared) {
+        if (self->gwriter >= 0)
+            StreamGraph_addEdge(self, self->gwriter, node, node);
+        self->gwriter = node;
+    }
+}
+
+/* Called with the mutex locked. */
+static void
+StreamGraph_release(StreamGraph *self, int node)
+{
+    int i, next;
+    for (i=self->sstart[node]; i<self->sstart[node+1]; i++) {
+        next = self->succ[i];
+        if (--self->pending[next] == 0) {
+            self->ready[self->tail++] = next;
+            pthread_cond_signal(&self->cond);
+        }
+    }
+    if (--self->remaining == 0)
+        pthread_cond_broadcast(&self->cond);
+}
+
+static void *
+StreamGraph_worker(void *arg)
+{
+    int node;
+    StreamGraph *self = (StreamGraph *)arg;
+
+    pthread_mutex_lock(&self->mutex);
+    while (self->quit == 0) {
+        if (self->head == self->tail) {
+            pthread_cond_wait(&self->cond, &self->mutex);
+            continue;
+        }
+        node = self->ready[self->head++];
+        pthread_mutex_unlock(&self->mutex);
+        DenormalMode_set(DenormalMode_getDefault());
+        Stream_compute(self->list[self->nodes[node]]);
+        pthread_mutex_lock(&self->mutex);
+        StreamGraph_release(self, node);
+    }
+    pthread_mutex_unlock(&self->mutex);
+    return NULL;
+}
+
+StreamGraph *
+StreamGraph_new(int nthreads)
+{
+    int i;
+    pthread_attr_t attr;
+    StreamGraph *self = (StreamGraph *)calloc(1, sizeof(StreamGraph));
+
+    self->tsize = 1024;
+    self->table = (GraphEntry *)calloc(self->tsize, sizeof(GraphEntry));
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setstacksize(&attr, GRAPH_STACK_SIZE);
+    self->threads = (pthread_t *)malloc(nthreads * sizeof(pthread_t));
+    for (i=0; i<nthreads; i++) {
+        if (pthread_create(&self->threads[i], &attr, StreamGraph_worker, (void *)self) != 0)
+            break;
+    }
+    self->nthreads = i;
+    pthread_attr_destroy(&attr);
+
+    return self;
+}
+
+void
+StreamGraph_free(StreamGraph *self)
+{
+    int i;
+
+    pthread_mutex_lock(&self->mutex);
+    self->quit = 1;
+    pthread_cond_broadcast(&self->cond);
+    pthread_mutex_unlock(&self->mutex);
+    for (i=0; i<self->nthreads; i++) {
+        pthread_join(self->threads[i], NULL);
+    }
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+
+    free(self->threads);
+    free(self->table);
+    free(self->list);
+    free(self->nodeof);
+    free(self->nodes);
+    free(self->pending);
+    free(self->sstart);
+    free(self->succ);
+    free(self->markin);
+    free(self->markout);
+    free(self->ready);
+    free(self->efrom);
+    free(self->eto);
+    free(self->rpool);
+    free(self->refs);
+    free(self->rdepth);
+    free(self->stack);
+    free(self);
+}
+
+void
+StreamGraph_prepare(StreamGraph *self, Stream **streams, int count)
+{
+    int i, size;
+    Stream *stream;
+
+    self->stamp++;
+    self->tcount = 0;
+
+    size = self->lsize;
+    GRAPH_RESERVE(self->list, self->lsize, count, Stream *);
+    if (size != self->lsize)
+        self->nodeof = (int *)realloc(self->nodeof, self->lsize * sizeof(int));
+
+    for (i=0; i<count; i++) {
+        stream = streams[i];
+        self->list[i] = stream;
+        self->nodeof[i] = -1;
+        StreamGraph_lookup(self, (void *)stream)->sidx = i;
+        if (stream->streamobject != NULL)
+            StreamGraph_lookup(self, (void *)stream->streamobject)->sidx = i;
+    }
+}
+
+void
+StreamGraph_pull(StreamGraph *self, int count)
+{
+    int i, r, top = 0;
+    Stream *stream;
+    GraphEntry *entry;
+
+    GRAPH_RESERVE(self->stack, self->stsize, count, int);
+    for (i=0; i<count; i++) {
+        stream = self->list[i];
+        if (stream->active == 1 && (stream->todac || stream->sink || stream->bus >= 0)) {
+            stream->suspended = 0;
+            self->stack[top++] = i;
+        }
+        else
+            stream->suspended = 1;
+    }
+
+    /* `seen` marks the objects already followed, reset by the next segment. */
+    self->segment++;
+    while (top > 0) {
+        stream = self->list[self->stack[--top]];
+        self->rfill = 0;
+        StreamGraph_traverse(self, stream->streamobject, 1);
+        for (r=0; r<self->rfill; r++) {
+            if (StreamGraph_isConstant(self->refs[r]))
+                continue;
+            entry = StreamGraph_lookup(self, (void *)self->refs[r]);
+            if (entry->seen == 0)
+                continue;
+            entry->seen = 0;
+            if (entry->sidx >= 0) {
+                if (self->list[entry->sidx]->suspended == 1) {
+                    self->list[entry->sidx]->suspended = 0;
+                    self->stack[top++] = entry->sidx;
+                }
+            }
+            else if (GRAPH_FOLLOW(self->refs[r], self->rdepth[r]))
+                StreamGraph_traverse(self, self->refs[r], self->rdepth[r] + 1);
+        }
+    }
+}
+
+void
+StreamGraph_run(StreamGraph *self, int start, int stop)
+{
+    int i, k, n = 0;
+
+    GRAPH_RESERVE(self->nodes, self->nsize, stop - start + 1, int);
+    if (self->nsize > 0) {
+        self->pending = (int *)realloc(self->pending, self->nsize * sizeof(int));
+        self->sstart = (int *)realloc(self->sstart, self->nsize * sizeof(int));
+        self->markin = (int *)realloc(self->markin, self->nsize * sizeof(int));
+        self->markout = (int *)realloc(self->markout, self->nsize * sizeof(int));
+        self->ready = (int *)realloc(self->ready, self->nsize * sizeof(int));
+    }
+
+    for (i=start; i<stop; i++) {
+        if (self->list[i]->active == 1 && self->list[i]->suspended == 0) {
+            self->nodeof[i] = n;
+            self->nodes[n++] = i;
+        }
+    }
+    if (n == 0)
+        return;
+
+    if (n == 1 || self->nthreads == 0) {
+        for (k=0; k<n; k++) {
+            Stream_compute(self->list[self->nodes[k]]);
+            self->nodeof[self->nodes[k]] = -1;
+        }
+        return;
+    }
+
+    self->segment++;
+    self->nnodes = n;
+    self->ecount = self->rcount = 0;
+    self->gwriter = -1;
+    for (k=0; k<n; k++) {
+        self->markin[k] = self->markout[k] = -1;
+        self->pending[k] = 0;
+    }
+    for (k=0; k<n; k++) {
+        StreamGraph_collect(self, k);
+    }
+
+    /* successors lists */
+    for (k=0; k<=n; k++) {
+        self->sstart[k] = 0;
+    }
+    for (i=0; i<self->ecount; i++) {
+        self->sstart[self->efrom[i]+1]++;
+        self->pending[self->eto[i]]++;
+    }
+    for (k=0; k<n; k++) {
+        self->sstart[k+1] += self->sstart[k];
+    }
+    GRAPH_RESERVE(self->succ, self->ssize, self->ecount, int);
+    for (k=0; k<n; k++) {
+        self->markin[k] = self->sstart[k];
+    }
+    for (i=0; i<self->ecount; i++) {
+        self->succ[self->markin[self->efrom[i]]++] = self->eto[i];
+    }
+
+    pthread_mutex_lock(&self->mutex);
+    self->head = self->tail = 0;
+    for (k=0; k<n; k++) {
+        if (self->pending[k] == 0)
+            self->ready[self->tail++] = k;
+    }
+    self->remaining = n;
+    pthread_cond_broadcast(&self->cond);
+    while (self->remaining > 0) {
+        if (self->head == self->tail) {
+            pthread_cond_wait(&self->cond, &self->mutex);
+            continue;
+        }
+        k = self->ready[self->head++];
+        pthread_mutex_unlock(&self->mutex);
+        Stream_compute(self->list[self->nodes[k]]);
+        pthread_mutex_lock(&self->mutex);
+        StreamGraph_release(self, k);
+    }
+    pthread_mutex_unlock(&self->mutex);
+
+    for (k=0; k<n; k++) {
+        self->nodeof[self->nodes[k]] = -1;
+    }
+}
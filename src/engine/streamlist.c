@@ -0,0 +1,145 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include "streammodule.h"
+#include "streamlist.h"
+
+StreamList *
+StreamList_new(void)
+{
+    StreamList *self = (StreamList *)calloc(1, sizeof(StreamList));
+    self->size = 64;
+    self->items = (Stream **)malloc(self->size * sizeof(Stream *));
+    return self;
+}
+
+void
+StreamList_clear(StreamList *self)
+{
+    int i, count = self->count;
+    Stream **items = self->items;
+
+    /* Releasing a stream may remove others, the list is emptied first. */
+    self->items = (Stream **)malloc(self->size * sizeof(Stream *));
+    self->count = self->holes = 0;
+    for (i=0; i<count; i++) {
+        Py_XDECREF(items[i]);
+    }
+    free(items);
+}
+
+void
+StreamList_free(StreamList *self)
+{
+    StreamList_clear(self);
+    free(self->items);
+    free(self);
+}
+
+void
+StreamList_compact(StreamList *self)
+{
+    int i, w = 0;
+
+    if (self->holes == 0 || self->iterating)
+        return;
+    for (i=0; i<self->count; i++) {
+        if (self->items[i] != NULL) {
+            self->items[i]->slot = w;
+            self->items[w++] = self->items[i];
+        }
+    }
+    self->count = w;
+    self->holes = 0;
+}
+
+void
+StreamList_append(StreamList *self, Stream *stream)
+{
+    if (self->holes * 2 > self->count)
+        StreamList_compact(self);
+    if (self->count == self->size) {
+        self->size *= 2;
+        self->items = (Stream **)realloc(self->items, self->size * sizeof(Stream *));
+    }
+    Py_INCREF(stream);
+    stream->slot = self->count;
+    self->items[self->count++] = stream;
+}
+
+static int
+StreamList_contains(StreamList *self, Stream *stream)
+{
+    return stream->slot >= 0 && stream->slot < self->count && self->items[stream->slot] == stream;
+}
+
+void
+StreamList_remove(StreamList *self, Stream *stream)
+{
+    if (!StreamList_contains(self, stream))
+        return;
+    self->items[stream->slot] = NULL;
+    self->holes++;
+    if (self->holes * 2 > self->count)
+        StreamList_compact(self);
+    Py_DECREF(stream);
+}
+
+void
+StreamList_moveBefore(StreamList *self, Stream *stream, Stream *ref)
+{
+    int i, pos;
+
+    if (!StreamList_contains(self, stream) || self->iterating)
+        return;
+    StreamList_compact(self);
+    pos = StreamList_contains(self, ref) ? ref->slot : self->count;
+    if (pos > stream->slot) {
+        /* Removing the stream shifts `ref` down by one. */
+        pos--;
+        for (i=stream->slot; i<pos; i++) {
+            self->items[i] = self->items[i+1];
+            self->items[i]->slot = i;
+        }
+    }
+    else {
+        for (i=stream->slot; i>pos; i--) {
+            self->items[i] = self->items[i-1];
+            self->items[i]->slot = i;
+        }
+    }
+    self->items[pos] = stream;
+    stream->slot = pos;
+}
+
+PyObject *
+StreamList_toList(StreamList *self)
+{
+    int i;
+    PyObject *list = PyList_New(0);
+
+    for (i=0; i<self->count; i++) {
+        if (self->items[i] != NULL)
+            PyList_Append(list, (PyObject *)self->items[i]);
+    }
+    return list;
+}
@@ -19,12 +19,22 @@
  *************************************************************************/
 
 #include <Python.h>
+#include <stdlib.h>
 #include "structmember.h"
 #include "pyomodule.h"
 
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
 #define __STREAM_MODULE
 #include "streammodule.h"
 #undef __STREAM_MODULE
+#include "paramqueue.h"
 
 int stream_id = 1;
 
@@ -52,6 +62,8 @@ static void
 Stream_dealloc(Stream* self)
 {
     self->data = NULL;
+    if (self->profile != NULL)
+        free(self->profile);
     Stream_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -80,6 +92,12 @@ Stream_getStreamToDac(Stream *self)
     return self->todac;
 }
 
+int
+Stream_getPackedChannels(Stream *self)
+{
+    return self->packed;
+}
+
 int
 Stream_getBufferCountWait(Stream *self)
 {
@@ -104,6 +122,12 @@ Stream_setData(Stream *self, MYFLT *data)
     self->data = data;
 }
 
+size_t
+Stream_getMemory(Stream *self)
+{
+    return (size_t)self->bufsize * self->packed * sizeof(MYFLT) + self->memory;
+}
+
 void Stream_setFunctionPtr(Stream *self, void *ptr)
 {
     self->funcptr = ptr;
@@ -111,9 +135,71 @@ void Stream_setFunctionPtr(Stream *self, void *ptr)
 
 void Stream_callFunction(Stream *self)
 {
+    self->constant = 0;
+    self->numtrigs = -1;
     (*self->funcptr)(self->streamobject);
 }
 
+/* Monotonic clock, in nanoseconds. */
+unsigned long long
+Stream_clock()
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+    if (freq.QuadPart == 0)
+        QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (unsigned long long)((double)now.QuadPart * 1e9 / freq.QuadPart);
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t info;
+    if (info.denom == 0)
+        mach_timebase_info(&info);
+    return mach_absolute_time() * info.numer / info.denom;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+#endif
+}
+
+void Stream_callProfiled(Stream *self)
+{
+    unsigned long long start, elapsed;
+    StreamProfile *profile = self->profile;
+
+    start = Stream_clock();
+    if (self->params != NULL)
+        ParamQueue_compute((PyObject *)self);
+    else {
+        self->constant = 0;
+        self->numtrigs = -1;
+        (*self->funcptr)(self->streamobject);
+    }
+    elapsed = Stream_clock() - start;
+
+    profile->total += elapsed;
+    if (elapsed > profile->max)
+        profile->max = elapsed;
+    profile->count++;
+}
+
+/* Starts (and resets) or stops the profiling of a stream. The server
+   must not be computing a buffer. */
+void Stream_setProfiling(Stream *self, int on)
+{
+    if (on) {
+        if (self->profile == NULL)
+            self->profile = (StreamProfile *)malloc(sizeof(StreamProfile));
+        self->profile->total = self->profile->max = 0;
+        self->profile->count = 0;
+    }
+    else if (self->profile != NULL) {
+        free(self->profile);
+        self->profile = NULL;
+    }
+}
+
 void Stream_IncrementBufferCount(Stream *self)
 {
     self->bufferCount++;
@@ -132,11 +218,91 @@ void Stream_IncrementDurationCount(Stream *self)
     }
 }
 
+/* Voice suspension.
+ *
+ * When enabled, a stream is skipped while its output is known to be silent:
+ * its `mul` is a stream whose buffer is all zeros (an envelope at rest) and
+ * its `add` is 0, or, for an object declaring a tail, its input and its own
+ * output have stayed under STREAM_QUIET_LEVEL for more than `tail` samples.
+ * The data of a skipped stream is cleared once, so the streams reading it,
+ * and the ones following it, see silence. It is computed again as soon as
+ * its gate or its input wakes up. */
+#define STREAM_QUIET_LEVEL 0.000001
+
+typedef struct {
+    pyo_audio_HEAD
+} PyoAudioObject;
+
+int Stream_suspension = 0;
+
+void
+Stream_setSuspension(int on)
+{
+    Stream_suspension = on;
+}
+
+static int
+Stream_isQuiet(MYFLT *data, int size, MYFLT level)
+{
+    int i;
+
+    for (i=0; i<size; i++) {
+        if (data[i] > level || data[i] < -level)
+            return 0;
+    }
+    return 1;
+}
+
+/* Called before computing the stream, from the thread computing it. */
+int
+Stream_isSilent(Stream *self)
+{
+    int silent = 0;
+    Stream *gate;
+    PyoAudioObject *obj = (PyoAudioObject *)self->streamobject;
+
+    if (self->keep || self->shared || self->sink || self->pycall)
+        return 0;
+
+    /* Objects with a tail keep feeding their lines while the gate is closed,
+       they are skipped only once their input and output are quiet. */
+    gate = obj->mul_stream;
+    if (self->tail < 0 && gate != NULL && !PyFloat_Check(obj->mul) && PyFloat_Check(obj->add) && PyFloat_AS_DOUBLE(obj->add) == 0.0 &&
+        (gate->silent || Stream_isQuiet(gate->data, gate->bufsize, 0.0)))
+        silent = 1;
+    else if (self->tail >= 0 && self->input != NULL) {
+        if ((self->input->silent || Stream_isQuiet(self->input->data, self->input->bufsize, STREAM_QUIET_LEVEL)) &&
+            (self->silent || Stream_isQuiet(self->data, self->bufsize * self->packed, STREAM_QUIET_LEVEL))) {
+            if (self->quiet <= self->tail)
+                self->quiet += self->bufsize;
+            silent = self->quiet > self->tail;
+        }
+        else
+            self->quiet = 0;
+    }
+
+    if (silent && !self->silent)
+        memset(self->data, 0, self->bufsize * self->packed * sizeof(MYFLT));
+    if (silent) {
+        self->constant = 1;
+        self->numtrigs = 0;
+    }
+    self->silent = silent;
+    return silent;
+}
+
 static PyObject *
 Stream_getValue(Stream *self) {
+    /* Read from python, keep it computed in pull mode. */
+    self->sink = 1;
     return Py_BuildValue(TYPE_F, self->data[self->bufsize-1]);
 }
 
+static PyObject *
+Stream_getMemoryUsage(Stream *self) {
+    return PyLong_FromSize_t(Stream_getMemory(self));
+}
+
 static PyObject *
 Stream_getId(Stream *self) {
     return Py_BuildValue("i", self->sid);
@@ -149,6 +315,29 @@ Stream_getStreamObject(Stream *self)
     return self->streamobject;
 }
 
+static PyObject *
+Stream_setSink(Stream *self, PyObject *arg)
+{
+    if (arg != NULL)
+        self->sink = PyObject_IsTrue(arg);
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+Stream_setBus(Stream *self, PyObject *args)
+{
+    int bus;
+    MYFLT gain = 1.0;
+
+    if (! PyArg_ParseTuple(args, TYPE_I_F, &bus, &gain))
+        return NULL;
+    self->bus = bus < 0 ? -1 : bus;
+    self->busGain = gain;
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 PyObject *
 Stream_isPlaying(Stream *self)
 {
@@ -178,9 +367,12 @@ Stream_isOutputting(Stream *self)
 static PyMethodDef Stream_methods[] = {
 {"getValue", (PyCFunction)Stream_getValue, METH_NOARGS, "Returns the first sample of the current buffer."},
 {"getId", (PyCFunction)Stream_getId, METH_NOARGS, "Returns the ID of assigned to this stream."},
+{"getMemory", (PyCFunction)Stream_getMemoryUsage, METH_NOARGS, "Returns the heap memory used by the object, in bytes."},
 {"getStreamObject", (PyCFunction)Stream_getStreamObject, METH_NOARGS, "Returns the object associated with this stream."},
 {"isPlaying", (PyCFunction)Stream_isPlaying, METH_NOARGS, "Returns True if the stream is playing, otherwise, returns False."},
 {"isOutputting", (PyCFunction)Stream_isOutputting, METH_NOARGS, "Returns True if the stream outputs to dac, otherwise, returns False."},
+{"setSink", (PyCFunction)Stream_setSink, METH_O, "If True, the stream is always computed in pull mode."},
+{"setBus", (PyCFunction)Stream_setBus, METH_VARARGS, "Sends the stream to a server bus channel (-1 to stop) with a gain."},
 {NULL}  /* Sentinel */
 };
 
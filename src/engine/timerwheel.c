@@ -0,0 +1,193 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include "timerwheel.h"
+
+#define WHEEL_ROOT_BITS 8
+#define WHEEL_ROOT_SIZE (1 << WHEEL_ROOT_BITS)
+#define WHEEL_ROOT_MASK (WHEEL_ROOT_SIZE - 1)
+#define WHEEL_LEVEL_BITS 6
+#define WHEEL_LEVEL_SIZE (1 << WHEEL_LEVEL_BITS)
+#define WHEEL_LEVEL_MASK (WHEEL_LEVEL_SIZE - 1)
+#define WHEEL_LEVELS 3
+
+/* Buffers covered by the first `n` coarse levels, besides the root. */
+#define WHEEL_SPAN(n) (1ULL << (WHEEL_ROOT_BITS + (n) * WHEEL_LEVEL_BITS))
+/* Slot of `tick` in the coarse level `n`, starting at 0. */
+#define WHEEL_INDEX(tick, n) (((tick) >> (WHEEL_ROOT_BITS + (n) * WHEEL_LEVEL_BITS)) & WHEEL_LEVEL_MASK)
+
+struct TimerWheel {
+    int bufsize;
+    unsigned long long now; /* next buffer to run */
+    TimerEvent *root[WHEEL_ROOT_SIZE];
+    TimerEvent *levels[WHEEL_LEVELS][WHEEL_LEVEL_SIZE];
+    TimerEvent *overflow; /* farther than the last level */
+};
+
+static void
+TimerWheel_link(TimerEvent **head, TimerEvent *ev)
+{
+    ev->next = *head;
+    if (*head != NULL)
+        (*head)->pprev = &ev->next;
+    *head = ev;
+    ev->pprev = head;
+}
+
+static void
+TimerWheel_unlink(TimerEvent *ev)
+{
+    *ev->pprev = ev->next;
+    if (ev->next != NULL)
+        ev->next->pprev = ev->pprev;
+    ev->next = NULL;
+    ev->pprev = NULL;
+}
+
+static void
+TimerWheel_insert(TimerWheel *self, TimerEvent *ev)
+{
+    int n;
+    unsigned long long tick = ev->time / self->bufsize;
+
+    if (tick < self->now)
+        tick = self->now;
+
+    if (tick - self->now < WHEEL_ROOT_SIZE) {
+        TimerWheel_link(&self->root[tick & WHEEL_ROOT_MASK], ev);
+        return;
+    }
+    for (n=0; n<WHEEL_LEVELS; n++) {
+        if (tick - self->now < WHEEL_SPAN(n + 1)) {
+            TimerWheel_link(&self->levels[n][WHEEL_INDEX(tick, n)], ev);
+            return;
+        }
+    }
+    TimerWheel_link(&self->overflow, ev);
+}
+
+/* Spreads a slot over the finer levels. The slot is detached first: events
+   still too far away, in the overflow list, go back into it. */
+static void
+TimerWheel_cascade(TimerWheel *self, TimerEvent **head)
+{
+    TimerEvent *ev, *list = *head;
+
+    *head = NULL;
+    if (list != NULL)
+        list->pprev = &list;
+    while ((ev = list) != NULL) {
+        TimerWheel_unlink(ev);
+        TimerWheel_insert(self, ev);
+    }
+}
+
+TimerWheel *
+TimerWheel_new(int bufsize)
+{
+    TimerWheel *self = (TimerWheel *)calloc(1, sizeof(TimerWheel));
+
+    if (self == NULL)
+        return NULL;
+    self->bufsize = bufsize;
+    return self;
+}
+
+static void
+TimerWheel_clearList(TimerEvent **head)
+{
+    while (*head != NULL)
+        TimerWheel_unlink(*head);
+}
+
+void
+TimerWheel_free(TimerWheel *self)
+{
+    int i, n;
+
+    if (self == NULL)
+        return;
+    for (i=0; i<WHEEL_ROOT_SIZE; i++) {
+        TimerWheel_clearList(&self->root[i]);
+    }
+    for (n=0; n<WHEEL_LEVELS; n++) {
+        for (i=0; i<WHEEL_LEVEL_SIZE; i++) {
+            TimerWheel_clearList(&self->levels[n][i]);
+        }
+    }
+    TimerWheel_clearList(&self->overflow);
+    free(self);
+}
+
+void
+TimerWheel_schedule(TimerWheel *self, TimerEvent *ev, unsigned long long time)
+{
+    if (ev->pprev != NULL)
+        TimerWheel_unlink(ev);
+    ev->time = time;
+    TimerWheel_insert(self, ev);
+}
+
+void
+TimerWheel_cancel(TimerEvent *ev)
+{
+    if (ev->pprev != NULL)
+        TimerWheel_unlink(ev);
+}
+
+void
+TimerWheel_advance(TimerWheel *self)
+{
+    int n;
+    TimerEvent *ev, **pos, *due = NULL;
+    unsigned long long tick = self->now;
+
+    /* Entering a new round of the root, the next slot of each level that
+       wrapped around comes down. */
+    if ((tick & WHEEL_ROOT_MASK) == 0) {
+        for (n=0; n<WHEEL_LEVELS; n++) {
+            TimerWheel_cascade(self, &self->levels[n][WHEEL_INDEX(tick, n)]);
+            if (WHEEL_INDEX(tick, n) != 0)
+                break;
+        }
+        if (n == WHEEL_LEVELS)
+            TimerWheel_cascade(self, &self->overflow);
+    }
+
+    /* Sorts the slot by time. Events due at the same sample keep the order
+       in which they were scheduled (the slot lists the newest first). */
+    while ((ev = self->root[tick & WHEEL_ROOT_MASK]) != NULL) {
+        TimerWheel_unlink(ev);
+        pos = &due;
+        while (*pos != NULL && (*pos)->time < ev->time)
+            pos = &(*pos)->next;
+        TimerWheel_link(pos, ev);
+    }
+
+    /* Events scheduled from now on go to the next buffers. */
+    self->now++;
+
+    while ((ev = due) != NULL) {
+        TimerWheel_unlink(ev);
+        (*ev->func)(ev->obj, ev->time);
+    }
+}
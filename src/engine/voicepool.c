@@ -0,0 +1,144 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include "voicepool.h"
+
+#define VOICEPOOL_SLAB_BITS 8
+#define VOICEPOOL_SLAB_SIZE (1 << VOICEPOOL_SLAB_BITS)
+#define VOICEPOOL_MAX_SLABS 4096
+#define VOICEPOOL_NIL 0xFFFFFFFFu
+
+/* Each record is preceded by its index and the index of the next free record. */
+typedef struct {
+    uint32_t index;
+    volatile uint32_t next;
+} VoiceHeader;
+
+struct VoicePool {
+    int stride; /* header and record, rounded to 16 bytes */
+    int minimum;
+    int reserved;
+    int numslabs;
+    char *slabs[VOICEPOOL_MAX_SLABS];
+    /* Index of the first free record in the low 32 bits, the count of
+     * updates in the high ones, so a record taken and given back between
+     * the read and the swap of another thread can't be mistaken. */
+    volatile uint64_t head;
+};
+
+static VoiceHeader *
+VoicePool_header(VoicePool *self, uint32_t index)
+{
+    return (VoiceHeader *)(self->slabs[index >> VOICEPOOL_SLAB_BITS] +
+                           (index & (VOICEPOOL_SLAB_SIZE - 1)) * self->stride);
+}
+
+/* Pushes the records from `first` to `last`, already linked. */
+static void
+VoicePool_push(VoicePool *self, uint32_t first, VoiceHeader *last)
+{
+    uint64_t old, new;
+
+    do {
+        old = self->head;
+        last->next = (uint32_t)old;
+        new = (uint64_t)first | (((old >> 32) + 1) << 32);
+    } while (!__sync_bool_compare_and_swap(&self->head, old, new));
+}
+
+static int
+VoicePool_grow(VoicePool *self, int count)
+{
+    int i, j;
+    uint32_t first;
+    VoiceHeader *h = NULL;
+
+    while (self->numslabs * VOICEPOOL_SLAB_SIZE < count) {
+        if (self->numslabs == VOICEPOOL_MAX_SLABS)
+            return -1;
+        self->slabs[self->numslabs] = (char *)malloc(VOICEPOOL_SLAB_SIZE * self->stride);
+        if (self->slabs[self->numslabs] == NULL)
+            return -1;
+        i = self->numslabs++;
+        first = (uint32_t)(i << VOICEPOOL_SLAB_BITS);
+        for (j=0; j<VOICEPOOL_SLAB_SIZE; j++) {
+            h = VoicePool_header(self, first + j);
+            h->index = first + j;
+            h->next = first + j + 1;
+        }
+        VoicePool_push(self, first, h);
+    }
+    return 0;
+}
+
+VoicePool *
+VoicePool_new(int size, int minimum)
+{
+    VoicePool *self = (VoicePool *)calloc(1, sizeof(VoicePool));
+
+    self->stride = (sizeof(VoiceHeader) + size + 15) & ~15;
+    self->minimum = minimum;
+    self->head = VOICEPOOL_NIL;
+    VoicePool_grow(self, minimum);
+    return self;
+}
+
+int
+VoicePool_reserve(VoicePool *self, int count)
+{
+    self->reserved += count;
+    return VoicePool_grow(self, self->reserved > self->minimum ? self->reserved : self->minimum);
+}
+
+void
+VoicePool_release(VoicePool *self, int count)
+{
+    self->reserved -= count;
+}
+
+void *
+VoicePool_get(VoicePool *self)
+{
+    uint64_t old, new;
+    uint32_t index;
+    VoiceHeader *h;
+
+    do {
+        old = self->head;
+        index = (uint32_t)old;
+        if (index == VOICEPOOL_NIL)
+            return NULL;
+        h = VoicePool_header(self, index);
+        new = (uint64_t)h->next | (((old >> 32) + 1) << 32);
+    } while (!__sync_bool_compare_and_swap(&self->head, old, new));
+
+    return (char *)h + sizeof(VoiceHeader);
+}
+
+void
+VoicePool_put(VoicePool *self, void *record)
+{
+    VoiceHeader *h = (VoiceHeader *)((char *)record - sizeof(VoiceHeader));
+
+    VoicePool_push(self, h->index, h);
+}
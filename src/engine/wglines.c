@@ -0,0 +1,210 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include <stdlib.h>
+#include <string.h>
+#include "wglines.h"
+#include "simd.h"
+
+/* Frames read at once, a chunk also ends where a line wraps. */
+#define WGLINES_FRAMES 32
+
+/* Reads the jittered positions of the frame, one line after the other. */
+static void
+WGLines_read(WGLines *self, int *count, MYFLT *x0, MYFLT *x1, MYFLT *frac)
+{
+    int j, ind;
+    MYFLT xind;
+
+    for (j=0; j<8; j++) {
+        self->rnd_time[j] += self->rnd_timeInc[j];
+        if (self->rnd_time[j] < 0.0)
+            self->rnd_time[j] += 1.0;
+        else if (self->rnd_time[j] >= 1.0) {
+            self->rnd_time[j] -= 1.0;
+            self->rnd_oldValue[j] = self->rnd_value[j];
+            self->rnd_value[j] = self->rnd_range[j] * RANDOM_UNIFORM - self->rnd_halfRange[j];
+            self->rnd_diff[j] = self->rnd_value[j] - self->rnd_oldValue[j];
+        }
+        self->rnd[j] = self->rnd_oldValue[j] + self->rnd_diff[j] * self->rnd_time[j];
+
+        xind = count[j] - (self->delays[j] + self->rnd[j]);
+        if (xind < 0)
+            xind += self->size[j];
+        ind = (int)xind;
+        frac[j] = xind - ind;
+        x0[j] = self->buffer[j][ind];
+        x1[j] = self->buffer[j][ind+1];
+    }
+}
+
+#if defined(VSIZE)
+/* Same as WGLines_read, when no jitter reaches its next value. `count` and
+ * `size` hold the counters and sizes as MYFLT, `count` is incremented. */
+static void
+WGLines_readVector(WGLines *self, MYFLT *count, MYFLT *size, MYFLT *x0, MYFLT *x1, MYFLT *frac)
+{
+    int j, v;
+    MYFLT ind[8];
+    VTYPE t, xind, fl;
+
+    for (v=0; v<8; v+=VSIZE) {
+        t = VADD(VLOAD(self->rnd_time+v), VLOAD(self->rnd_timeInc+v));
+        VSTORE(self->rnd_time+v, t);
+        t = VADD(VLOAD(self->rnd_oldValue+v), VMUL(VLOAD(self->rnd_diff+v), t));
+        VSTORE(self->rnd+v, t);
+        xind = VWRAP(VSUB(VLOAD(count+v), VADD(VLOAD(self->delays+v), t)), VLOAD(size+v));
+        fl = VFLOOR(xind);
+        VSTORE(frac+v, VSUB(xind, fl));
+        VSTORE(ind+v, fl);
+        VSTORE(count+v, VADD(VLOAD(count+v), VSET1(1.0)));
+    }
+    for (j=0; j<8; j++) {
+        x0[j] = self->buffer[j][(int)ind[j]];
+        x1[j] = self->buffer[j][(int)ind[j]+1];
+    }
+}
+#endif
+
+/* Interpolates the reads, runs the lowpasses and gives in `in` the samples
+ * to write, `inj` being the input plus the junction. */
+static void
+WGLines_filter(WGLines *self, MYFLT *x0, MYFLT *x1, MYFLT *frac, MYFLT feed, MYFLT damp, MYFLT inj, MYFLT *in)
+{
+#if defined(VSIZE)
+    int v;
+    VTYPE x, val, last;
+
+    for (v=0; v<8; v+=VSIZE) {
+        x = VLOAD(x0+v);
+        val = VMUL(VADD(x, VMUL(VSUB(VLOAD(x1+v), x), VLOAD(frac+v))), VSET1(feed));
+        last = VLOAD(self->lastSamples+v);
+        VSTORE(in+v, VSUB(VSET1(inj), last));
+        VSTORE(self->lastSamples+v, VADD(VMUL(VSUB(last, val), VSET1(damp)), val));
+    }
+#else
+    int j;
+    MYFLT val;
+
+    for (j=0; j<8; j++) {
+        val = x0[j] + (x1[j] - x0[j]) * frac[j];
+        val *= feed;
+        in[j] = inj - self->lastSamples[j];
+        self->lastSamples[j] = (self->lastSamples[j] - val) * damp + val;
+    }
+#endif
+}
+
+void
+WGLines_process(WGLines *lines, int nets, MYFLT **inval, MYFLT **start, MYFLT **feed, MYFLT **damp,
+                MYFLT **out, int num)
+{
+    int i, j, k, n, nmax, first, pos, vector, count[nets][8];
+    long len;
+    MYFLT junction, total, inj, in[8];
+    MYFLT fcount[nets][8], fsize[nets][8];
+    MYFLT x0[WGLINES_FRAMES*nets*8], x1[WGLINES_FRAMES*nets*8], frac[WGLINES_FRAMES*nets*8];
+    WGLines ln[nets], *l;
+
+    /* A chunk is shorter than the shortest delay, so all its reads are done
+     * before its frames are written. */
+    nmax = WGLINES_FRAMES;
+    for (k=0; k<nets; k++) {
+        for (j=0; j<8; j++) {
+            len = (long)(lines[k].delays[j] - lines[k].rnd_halfRange[j]) - 1;
+            if (len < nmax)
+                nmax = len < 1 ? 1 : len;
+        }
+    }
+
+    /* Works on a copy, that the buffers can not alias. */
+    memcpy(ln, lines, nets * sizeof(WGLines));
+
+    for (first=0; first<num; first+=n) {
+        n = num - first < nmax ? num - first : nmax;
+        for (k=0; k<nets; k++) {
+            for (j=0; j<8; j++) {
+                if (n > ln[k].size[j] - ln[k].in_count[j])
+                    n = ln[k].size[j] - ln[k].in_count[j];
+            }
+        }
+
+        /* Vectors when no jitter can draw a new value in the chunk. */
+        vector = 1;
+        for (k=0; k<nets; k++) {
+            l = &ln[k];
+            for (j=0; j<8; j++) {
+                count[k][j] = l->in_count[j];
+                fcount[k][j] = l->in_count[j];
+                fsize[k][j] = l->size[j];
+                if (l->rnd_timeInc[j] <= 0.0 || l->rnd_time[j] < 0.0 ||
+                    l->rnd_time[j] + (n + 1) * l->rnd_timeInc[j] >= 0.999)
+                    vector = 0;
+            }
+        }
+
+        for (i=0; i<n; i++) {
+            for (k=0; k<nets; k++) {
+                pos = (i * nets + k) * 8;
+#if defined(VSIZE)
+                if (vector) {
+                    WGLines_readVector(&ln[k], fcount[k], fsize[k], x0+pos, x1+pos, frac+pos);
+                    continue;
+                }
+#endif
+                WGLines_read(&ln[k], count[k], x0+pos, x1+pos, frac+pos);
+                for (j=0; j<8; j++) {
+                    count[k][j]++;
+                }
+            }
+        }
+
+        for (i=0; i<n; i++) {
+            for (k=0; k<nets; k++) {
+                l = &ln[k];
+                pos = (i * nets + k) * 8;
+                junction = l->total_signal * .25;
+                total = start[k] == NULL ? 0.0 : start[k][first+i];
+                inj = inval[k][first+i] + junction;
+                WGLines_filter(l, x0+pos, x1+pos, frac+pos, feed[k][first+i], damp[k][first+i], inj, in);
+                for (j=0; j<8; j++) {
+                    total += l->lastSamples[j];
+                    l->buffer[j][l->in_count[j]+i] = in[j];
+                }
+                l->total_signal = total;
+                out[k][first+i] = total * 0.25;
+            }
+        }
+
+        for (k=0; k<nets; k++) {
+            l = &ln[k];
+            for (j=0; j<8; j++) {
+                if (l->in_count[j] == 0)
+                    l->buffer[j][l->size[j]] = l->buffer[j][0];
+                l->in_count[j] += n;
+                if (l->in_count[j] >= l->size[j])
+                    l->in_count[j] = 0;
+            }
+        }
+    }
+
+    memcpy(lines, ln, nets * sizeof(WGLines));
+}
@@ -27,6 +27,9 @@
 #include "interpolation.h"
 #include "fft.h"
 #include "wind.h"
+#include "capturering.h"
+#include "dspthread.h"
+#include "simd.h"
 
 /************/
 /* Follower */
@@ -894,6 +897,15 @@ PyTypeObject Follower2Type = {
 /************/
 /* ZCross */
 /************/
+/* Is there a zero-crossing, of at least `thresh`, between two adjacent samples. */
+static inline int
+is_zcross(MYFLT last, MYFLT inval, MYFLT thresh) {
+    if (last >= 0.0)
+        return inval < 0.0 && (last - inval) > thresh;
+    else
+        return inval >= 0.0 && (inval - last) > thresh;
+}
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *input;
@@ -914,14 +926,7 @@ ZCross_process(ZCross *self) {
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = self->lastValue;
         inval = in[i];
-        if (self->lastSample >= 0.0) {
-            if (inval < 0.0 && (self->lastSample-inval) > self->thresh)
-                count++;
-        }
-        else {
-            if (inval >= 0.0 && (inval-self->lastSample) > self->thresh)
-                count++;
-        }
+        count += is_zcross(self->lastSample, inval, self->thresh);
         self->lastSample = inval;
     }
     self->lastValue = (MYFLT)count / self->bufsize;
@@ -1233,6 +1238,13 @@ typedef struct {
     int winsize;
     int halfsize;
     int input_count;
+    int size; /* fft size, the power of two from winsize */
+    int stage; /* next step of the analysis of `window`, 0 when done */
+    MYFLT *window; /* last complete window, being analysed */
+    MYFLT *spectrum; /* of the window */
+    MYFLT *corr; /* spectrum of the first half, then autocorrelation */
+    MYFLT *frame;
+    MYFLT **twiddle;
     MYFLT tolerance;
     MYFLT pitch;
     MYFLT minfreq;
@@ -1244,10 +1256,80 @@ typedef struct {
     int modebuffer[2]; // need at least 2 slots for mul & add
 } Yin;
 
+/* The difference function d(tau) = e(0) + e(tau) - 2 r(tau), where e(tau) is
+   the energy of the halfsize samples from tau and r the autocorrelation of
+   the first half against the window, computed with ffts. The analysis of a
+   window is done in four steps, one per buffer, while the next window is
+   gathered. */
+static void
+Yin_step(Yin *self) {
+    int i, k, period, tau;
+    MYFLT candidate, ar, ai, xr, xi, d, e0, e, sum;
+    int size = self->size, hsize = self->size / 2, half = self->halfsize;
+
+    switch (self->stage) {
+        case 1:
+            memcpy(self->frame, self->window, self->winsize * sizeof(MYFLT));
+            memset(self->frame + self->winsize, 0, (size - self->winsize) * sizeof(MYFLT));
+            realfft_split(self->frame, self->spectrum, size, self->twiddle);
+            break;
+        case 2:
+            memcpy(self->frame, self->window, half * sizeof(MYFLT));
+            memset(self->frame + half, 0, (size - half) * sizeof(MYFLT));
+            realfft_split(self->frame, self->corr, size, self->twiddle);
+            break;
+        case 3:
+            /* Cross spectrum, the first half conjugated, in split format. */
+            self->frame[0] = self->corr[0] * self->spectrum[0];
+            self->frame[hsize] = self->corr[hsize] * self->spectrum[hsize];
+            for (k=1; k<hsize; k++) {
+                ar = self->corr[k];
+                ai = self->corr[size-k];
+                xr = self->spectrum[k];
+                xi = self->spectrum[size-k];
+                self->frame[k] = ar * xr + ai * xi;
+                self->frame[size-k] = ar * xi - ai * xr;
+            }
+            irealfft_split(self->frame, self->corr, size, self->twiddle);
+            break;
+        case 4:
+            /* realfft_split scales by 1/size, the product by 1/size^2. */
+            e0 = 0.0;
+            for (i=0; i<half; i++)
+                e0 += self->window[i] * self->window[i];
+            e = e0;
+            sum = 0.0;
+            self->yin_buffer[0] = 1.0;
+            for (tau=1; tau<half; tau++) {
+                e += self->window[tau+half-1] * self->window[tau+half-1] - self->window[tau-1] * self->window[tau-1];
+                d = e0 + e - 2.0 * self->corr[tau] * size;
+                if (d < 0.0)
+                    d = 0.0;
+                sum += d;
+                self->yin_buffer[tau] = sum > 0.0 ? d * tau / sum : 1.0;
+            }
+
+            for (period=2; period<(half-3); period++) {
+                if (self->yin_buffer[period] < self->tolerance && self->yin_buffer[period] < self->yin_buffer[period+1])
+                    break;
+            }
+            if (period < (half-3))
+                candidate = quadraticInterpolation(self->yin_buffer, period, half);
+            else
+                candidate = quadraticInterpolation(self->yin_buffer, min_elem_pos(self->yin_buffer, half), half);
+
+            candidate = self->sr / candidate;
+            if (candidate > self->minfreq && candidate < self->maxfreq)
+                self->pitch = candidate;
+            break;
+    }
+    self->stage = self->stage == 4 ? 0 : self->stage + 1;
+}
+
 static void
 Yin_process(Yin *self) {
-    int i, j, period, tau = 0;
-    MYFLT candidate, tmp = 0.0, tmp2 = 0.0, b = 0.0;
+    int i;
+    MYFLT b = 0.0;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     if (self->cutoff != self->last_cutoff) {
@@ -1260,36 +1342,19 @@ Yin_process(Yin *self) {
         self->c2 = (b - MYSQRT(b * b - 1.0));
     }
 
+    if (self->stage != 0)
+        Yin_step(self);
+
     for (i=0; i<self->bufsize; i++) {
         self->y1 = in[i] + (self->y1 - in[i]) * self->c2;
         self->input_buffer[self->input_count] = self->y1;
-        if (self->input_count++ == self->winsize) {
+        if (++self->input_count == self->winsize) {
             self->input_count = 0;
-
-            self->yin_buffer[0] = 1.0;
-            for (tau = 1; tau < self->halfsize; tau++) {
-                self->yin_buffer[tau] = 0.0;
-                for (j = 0; j < self->halfsize; j++) {
-                    tmp = self->input_buffer[j] - self->input_buffer[j+tau];
-                    self->yin_buffer[tau] += tmp*tmp;
-                }
-                tmp2 += self->yin_buffer[tau];
-                self->yin_buffer[tau] *= tau / tmp2;
-                period = tau - 3;
-                if (tau > 4 && (self->yin_buffer[period] < self->tolerance) &&
-                    (self->yin_buffer[period] < self->yin_buffer[period+1])) {
-                    candidate = quadraticInterpolation(self->yin_buffer, period, self->halfsize);
-                    goto founded;
-                }
-            }
-            candidate = quadraticInterpolation(self->yin_buffer, min_elem_pos(self->yin_buffer, self->halfsize), self->halfsize);
-
-        founded:
-
-            candidate = self->sr / candidate;
-            if (candidate > self->minfreq && candidate < self->maxfreq)
-                self->pitch = candidate;
-
+            /* The previous window is late, windows shorter than four buffers. */
+            while (self->stage != 0)
+                Yin_step(self);
+            memcpy(self->window, self->input_buffer, self->winsize * sizeof(MYFLT));
+            self->stage = 1;
         }
         self->data[i] = self->pitch;
     }
@@ -1375,6 +1440,11 @@ Yin_dealloc(Yin* self)
     pyo_DEALLOC
     free(self->input_buffer);
     free(self->yin_buffer);
+    free(self->window);
+    free(self->spectrum);
+    free(self->corr);
+    free(self->frame);
+    fft_release_table(self->twiddle);
     Yin_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1433,6 +1503,17 @@ Yin_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<self->halfsize; i++)
         self->yin_buffer[i] = 0.0;
 
+    self->size = 16;
+    while (self->size < self->winsize)
+        self->size *= 2;
+    self->stage = 0;
+    self->window = (MYFLT *)calloc(self->winsize, sizeof(MYFLT));
+    self->spectrum = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->corr = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->frame = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    Stream_setMemory(self->stream, (2 * self->winsize + self->halfsize + 3 * self->size) * sizeof(MYFLT));
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -1650,32 +1731,50 @@ typedef struct {
     MYFLT *outframe;
     MYFLT **twiddle;
     MYFLT *input_buffer;
-    MYFLT *window;
+    const MYFLT *window;
     int modebuffer[2];
 } Centroid;
 
 static void
 Centroid_alloc_memories(Centroid *self) {
-    int i, n8;
+    int i;
     self->hsize = self->size / 2;
-    n8 = self->size >> 3;
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
     self->input_buffer = (MYFLT *)realloc(self->input_buffer, self->size * sizeof(MYFLT));
     for (i=0; i<self->size; i++)
         self->inframe[i] = self->outframe[i] = self->input_buffer[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, 2);
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, 2);
+}
+
+/* Windows the last `size` samples of `input_buffer`, transforms them and
+   returns the magnitude weighted mean bin of the spectrum, 0 on silence.
+   Shared by Centroid and FeaturesMain. */
+static MYFLT
+spectral_centroid(const MYFLT *input_buffer, MYFLT *inframe, MYFLT *outframe, int size, const MYFLT *window, MYFLT **twiddle) {
+    int i, hsize = size / 2;
+    MYFLT re, im, tmp, sum1 = 0.0, sum2 = 0.0;
+
+    for (i=0; i<size; i++) {
+        inframe[i] = input_buffer[i] * window[i];
+    }
+    realfft_split(inframe, outframe, size, twiddle);
+    for (i=1; i<hsize; i++) {
+        re = outframe[i];
+        im = outframe[size - i];
+        tmp = MYSQRT(re*re + im*im);
+        sum1 += tmp * i;
+        sum2 += tmp;
+    }
+    return sum2 > 0.0 ? sum1 / sum2 : 0.0;
 }
 
 static void
 Centroid_process_i(Centroid *self) {
     int i;
-    MYFLT re, im, tmp, sum1, sum2;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     for (i=0; i<self->bufsize; i++) {
@@ -1685,25 +1784,9 @@ Centroid_process_i(Centroid *self) {
         self->incount++;
         if (self->incount == self->size) {
             self->incount = self->hsize;
-
-            for (i=0; i<self->size; i++) {
-                self->inframe[i] = self->input_buffer[i] * self->window[i];
-            }
-            realfft_split(self->inframe, self->outframe, self->size, self->twiddle);
-            sum1 = sum2 = 0.0;
-            for (i=1; i<self->hsize; i++) {
-                re = self->outframe[i];
-                im = self->outframe[self->size - i];
-                tmp = MYSQRT(re*re + im*im);
-                sum1 += tmp * i;
-                sum2 += tmp;
-            }
-            tmp = sum1 / sum2;
-            self->centroid += tmp * self->sr / self->size;
+            self->centroid += spectral_centroid(self->input_buffer, self->inframe, self->outframe, self->size, self->window, self->twiddle) * self->sr / self->size;
             self->centroid *= 0.5;
-            for (i=0; i<self->hsize; i++) {
-                self->input_buffer[i] = self->input_buffer[i + self->hsize];
-            }
+            memmove(self->input_buffer, self->input_buffer + self->hsize, self->hsize * sizeof(MYFLT));
         }
     }
 }
@@ -1785,16 +1868,12 @@ Centroid_clear(Centroid *self)
 static void
 Centroid_dealloc(Centroid* self)
 {
-    int i;
     pyo_DEALLOC
     free(self->inframe);
     free(self->outframe);
     free(self->input_buffer);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    free(self->window);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->window);
     Centroid_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1975,22 +2054,15 @@ Centroid_new,                                     /* tp_new */
 };
 
 /************/
-/* AttackDetector */
+/* Onset detection, shared by AttackDetector and FeaturesMain */
 /************/
 typedef struct {
-    pyo_audio_HEAD
-    PyObject *input;
-    Stream *input_stream;
-    MYFLT deltime;
-    MYFLT cutoff;
     MYFLT maxthresh;
     MYFLT minthresh;
-    MYFLT reltime;
     MYFLT folfactor;
     MYFLT follow;
     MYFLT followdb;
     MYFLT *buffer;
-    MYFLT previous;
     int memsize;
     int sampdel;
     int incount;
@@ -1998,53 +2070,130 @@ typedef struct {
     int belowminok;
     long maxtime;
     long timer;
+} Onset;
+
+static void
+Onset_init(Onset *self, MYFLT sr) {
+    self->follow = 0.0;
+    self->followdb = -120.0;
+    self->incount = 0;
+    self->overminok = 0;
+    self->belowminok = 0;
+    self->timer = 0;
+    self->memsize = (int)(0.055 * sr + 0.5);
+    self->buffer = (MYFLT *)calloc(self->memsize + 1, sizeof(MYFLT));
+}
+
+static void
+Onset_free(Onset *self) {
+    free(self->buffer);
+}
+
+/* The setters clip the parameter and return the value in use. */
+static MYFLT
+Onset_setDeltime(Onset *self, MYFLT deltime, MYFLT sr) {
+    if (deltime < 0.001) deltime = 0.001;
+    else if (deltime > 0.05) deltime = 0.05;
+    self->sampdel = (int)(deltime * sr);
+    return deltime;
+}
+
+static MYFLT
+Onset_setCutoff(Onset *self, MYFLT cutoff, MYFLT sr) {
+    if (cutoff < 1.0) cutoff = 1.0;
+    else if (cutoff > 1000.0) cutoff = 1000.0;
+    self->folfactor = MYEXP(-TWOPI * cutoff / sr);
+    return cutoff;
+}
+
+static MYFLT
+Onset_setMaxthresh(Onset *self, MYFLT maxthresh) {
+    if (maxthresh < 0.0) maxthresh = 0.0;
+    else if (maxthresh > 18.0) maxthresh = 18.0;
+    self->maxthresh = maxthresh;
+    return maxthresh;
+}
+
+static MYFLT
+Onset_setMinthresh(Onset *self, MYFLT minthresh) {
+    if (minthresh < -90.0) minthresh = -90.0;
+    else if (minthresh > 0.0) minthresh = 0.0;
+    self->minthresh = minthresh;
+    return minthresh;
+}
+
+static MYFLT
+Onset_setReltime(Onset *self, MYFLT reltime, MYFLT sr) {
+    if (reltime < 0.001) reltime = 0.001;
+    self->maxtime = (long)(reltime * sr + 0.5);
+    return reltime;
+}
+
+/* Takes the absolute value of the next input sample, returns 1.0 on an onset. */
+static inline MYFLT
+Onset_next(Onset *self, MYFLT absin) {
+    int ind;
+    MYFLT previous, trig = 0.0;
+
+    // envelope follower
+    self->follow = absin + self->folfactor * (self->follow - absin);
+    // follower in dB
+    if (self->follow <= 0.000001)
+        self->followdb = -120.0;
+    else
+        self->followdb = 20.0 * MYLOG10(self->follow);
+    // previous analysis
+    ind = self->incount - self->sampdel;
+    if (ind < 0)
+        ind += self->memsize;
+    previous = self->buffer[ind];
+    self->buffer[self->incount] = self->followdb;
+    self->incount++;
+    if (self->incount >= self->memsize)
+        self->incount = 0;
+    // if release time has past
+    if (self->timer >= self->maxtime) {
+        // if rms is over min threshold
+        if (self->overminok) {
+            // if rms is greater than previous + maxthresh
+            if (self->followdb > (previous + self->maxthresh)) {
+                trig = 1.0;
+                self->overminok = self->belowminok = 0;
+                self->timer = 0;
+            }
+        }
+    }
+    if (self->belowminok == 0 && self->followdb < self->minthresh)
+        self->belowminok = 1;
+    else if (self->belowminok == 1 && self->followdb > self->minthresh)
+        self->overminok = 1;
+    self->timer++;
+    return trig;
+}
+
+/************/
+/* AttackDetector */
+/************/
+typedef struct {
+    pyo_audio_HEAD
+    PyObject *input;
+    Stream *input_stream;
+    MYFLT deltime;
+    MYFLT cutoff;
+    MYFLT maxthresh;
+    MYFLT minthresh;
+    MYFLT reltime;
+    Onset onset;
     int modebuffer[2]; // need at least 2 slots for mul & add
 } AttackDetector;
 
 static void
 AttackDetector_process(AttackDetector *self) {
-    int i, ind;
-    MYFLT absin;
+    int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
-        absin = in[i];
-        // envelope follower
-        if (absin < 0.0)
-            absin = -absin;
-        self->follow = absin + self->folfactor * (self->follow - absin);
-        // follower in dB
-        if (self->follow <= 0.000001)
-            self->followdb = -120.0;
-        else
-            self->followdb = 20.0 * MYLOG10(self->follow);
-        // previous analysis
-        ind = self->incount - self->sampdel;
-        if (ind < 0)
-            ind += self->memsize;
-        self->previous = self->buffer[ind];
-        self->buffer[self->incount] = self->followdb;
-        self->incount++;
-        if (self->incount >= self->memsize)
-            self->incount = 0;
-        // if release time has past
-        if (self->timer >= self->maxtime) {
-            // if rms is over min threshold
-            if (self->overminok) {
-                // if rms is greater than previous + maxthresh
-                if (self->followdb > (self->previous + self->maxthresh)) {
-                    self->data[i] = 1.0;
-                    self->overminok = self->belowminok = 0;
-                    self->timer = 0;
-                }
-            }
-        }
-        if (self->belowminok == 0 && self->followdb < self->minthresh)
-            self->belowminok = 1;
-        else if (self->belowminok == 1 && self->followdb > self->minthresh)
-            self->overminok = 1;
-        self->timer++;
+        self->data[i] = Onset_next(&self->onset, MYFABS(in[i]));
     }
 }
 
@@ -2126,7 +2275,7 @@ static void
 AttackDetector_dealloc(AttackDetector* self)
 {
     pyo_DEALLOC
-    free(self->buffer);
+    Onset_free(&self->onset);
     AttackDetector_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -2144,13 +2293,6 @@ AttackDetector_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->maxthresh = 3.0;
     self->minthresh = -30.0;
     self->reltime = 0.1;
-    self->follow = 0.0;
-    self->followdb = -120.0;
-    self->previous = 0.0;
-    self->incount = 0;
-    self->overminok = 0;
-    self->belowminok = 0;
-    self->timer = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 
@@ -2175,31 +2317,13 @@ AttackDetector_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    self->memsize = (int)(0.055 * self->sr + 0.5);
-    self->buffer = (MYFLT *)realloc(self->buffer, (self->memsize+1) * sizeof(MYFLT));
-    for (i=0; i<(self->memsize+1); i++) {
-        self->buffer[i] = 0.0;
-    }
-
-    if (self->deltime < 0.001) self->deltime = 0.001;
-    else if (self->deltime > 0.05) self->deltime = 0.05;
-    self->sampdel = (int)(self->deltime * self->sr);
-
-    if (self->cutoff < 1.0) self->cutoff = 1.0;
-    else if (self->cutoff > 1000.0) self->cutoff = 1000.0;
-    self->folfactor = MYEXP(-TWOPI * self->cutoff / self->sr);
-
-    if (self->cutoff < 1.0) self->cutoff = 1.0;
-    else if (self->cutoff > 1000.0) self->cutoff = 1000.0;
-
-    if (self->maxthresh < 0.0) self->maxthresh = 0.0;
-    else if (self->maxthresh > 18.0) self->maxthresh = 18.0;
-
-    if (self->minthresh < -90.0) self->minthresh = -90.0;
-    else if (self->minthresh > 0.0) self->minthresh = 0.0;
-
-    if (self->reltime < 0.001) self->reltime = 0.001;
-    self->maxtime = (long)(self->reltime * self->sr + 0.5);
+    Onset_init(&self->onset, self->sr);
+    Stream_setMemory(self->stream, (self->onset.memsize + 1) * sizeof(MYFLT));
+    self->deltime = Onset_setDeltime(&self->onset, self->deltime, self->sr);
+    self->cutoff = Onset_setCutoff(&self->onset, self->cutoff, self->sr);
+    self->maxthresh = Onset_setMaxthresh(&self->onset, self->maxthresh);
+    self->minthresh = Onset_setMinthresh(&self->onset, self->minthresh);
+    self->reltime = Onset_setReltime(&self->onset, self->reltime, self->sr);
 
     (*self->mode_func_ptr)(self);
 
@@ -2236,10 +2360,7 @@ AttackDetector_setDeltime(AttackDetector *self, PyObject *arg)
 	int isNumber = PyNumber_Check(arg);
 
 	if (isNumber == 1) {
-		self->deltime = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
-        if (self->deltime < 0.001) self->deltime = 0.001;
-        else if (self->deltime > 0.05) self->deltime = 0.05;
-        self->sampdel = (int)(self->deltime * self->sr);
+		self->deltime = Onset_setDeltime(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
 	}
 
 	Py_RETURN_NONE;
@@ -2256,10 +2377,7 @@ AttackDetector_setCutoff(AttackDetector *self, PyObject *arg)
 	int isNumber = PyNumber_Check(arg);
 
 	if (isNumber == 1) {
-		self->cutoff = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
-        if (self->cutoff < 1.0) self->cutoff = 1.0;
-        else if (self->cutoff > 1000.0) self->cutoff = 1000.0;
-        self->folfactor = MYEXP(-TWOPI * self->cutoff / self->sr);
+		self->cutoff = Onset_setCutoff(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
 	}
 
 	Py_RETURN_NONE;
@@ -2276,9 +2394,7 @@ AttackDetector_setMaxthresh(AttackDetector *self, PyObject *arg)
 	int isNumber = PyNumber_Check(arg);
 
 	if (isNumber == 1) {
-		self->maxthresh = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
-        if (self->maxthresh < 0.0) self->maxthresh = 0.0;
-        else if (self->maxthresh > 18.0) self->maxthresh = 18.0;
+		self->maxthresh = Onset_setMaxthresh(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)));
 	}
 
 	Py_RETURN_NONE;
@@ -2295,9 +2411,7 @@ AttackDetector_setMinthresh(AttackDetector *self, PyObject *arg)
 	int isNumber = PyNumber_Check(arg);
 
 	if (isNumber == 1) {
-		self->minthresh = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
-        if (self->minthresh < -90.0) self->minthresh = -90.0;
-        else if (self->minthresh > 0.0) self->minthresh = 0.0;
+		self->minthresh = Onset_setMinthresh(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)));
 	}
 
 	Py_RETURN_NONE;
@@ -2314,9 +2428,7 @@ AttackDetector_setReltime(AttackDetector *self, PyObject *arg)
 	int isNumber = PyNumber_Check(arg);
 
 	if (isNumber == 1) {
-		self->reltime = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
-        if (self->reltime < 0.001) self->reltime = 0.001;
-        self->maxtime = (long)(self->reltime * self->sr + 0.5);
+		self->reltime = Onset_setReltime(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
 	}
 
 	Py_RETURN_NONE;
@@ -2442,21 +2554,15 @@ typedef struct {
     int size;
     int width;
     int height;
-    int pointer;
     MYFLT gain;
+    CaptureRing *ring;
     MYFLT *buffer;
 } Scope;
 
 static void
 Scope_generate(Scope *self) {
-    int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    for (i=0; i<self->bufsize; i++) {
-        if (self->pointer >= self->size)
-            self->pointer = 0;
-        self->buffer[self->pointer] = in[i];
-        self->pointer++;
-    }
+    CaptureRing_write(self->ring, in, self->bufsize);
 }
 
 static PyObject *
@@ -2468,6 +2574,9 @@ Scope_display(Scope *self) {
     step = self->size / (MYFLT)(self->width);
     h2 = self->height * 0.5;
 
+    /* One more sample for the interpolation of the last point. */
+    CaptureRing_read(self->ring, self->buffer, self->size + 1);
+
     points = PyList_New(self->width);
 
     for (i=0; i<self->width; i++) {
@@ -2510,6 +2619,7 @@ static void
 Scope_dealloc(Scope* self)
 {
     pyo_DEALLOC
+    CaptureRing_free(self->ring);
     free(self->buffer);
     Scope_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -2530,6 +2640,7 @@ Scope_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Scope_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
 
     static char *kwlist[] = {"input", "length", NULL};
 
@@ -2539,14 +2650,16 @@ Scope_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_INPUT_STREAM
 
     maxsize = (int)(self->sr * 0.25);
-    self->buffer = (MYFLT *)realloc(self->buffer, maxsize * sizeof(MYFLT));
+    self->ring = CaptureRing_new(maxsize + 1, self->bufsize);
+    self->buffer = (MYFLT *)realloc(self->buffer, (maxsize + 1) * sizeof(MYFLT));
     self->size = (int)(length * self->sr);
     if (self->size > maxsize)
         self->size = maxsize;
-    self->pointer = 0;
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    DspLock_exempt((PyCFunction)Scope_display);
+
     return (PyObject *)self;
 }
 
@@ -2567,7 +2680,6 @@ Scope_setLength(Scope *self, PyObject *arg)
         self->size = (int)(length * self->sr);
         if (self->size > maxsize)
             self->size = maxsize;
-        self->pointer = 0;
     }
 	Py_INCREF(Py_None);
 	return Py_None;
@@ -2943,4 +3055,671 @@ PeakAmp_members,                                 /* tp_members */
 0,                          /* tp_init */
 0,                                              /* tp_alloc */
 PeakAmp_new,                                     /* tp_new */
-};
\ No newline at end of file
+};
+/************/
+/* FeaturesMain */
+/************/
+/* Analyses one input in a single pass over each buffer and publishes five
+   feature streams, read by the Features objects:
+   0 = rms, 1 = peak amplitude, 2 = spectral centroid (Hz),
+   3 = zero-crossings, 4 = onset triggers.
+   rms, peak and zero-crossings are computed over each buffer and held
+   during the next one, as in PeakAmp and ZCross. */
+#define FEATURES_NUM 5
+
+typedef struct {
+    pyo_audio_HEAD
+    PyObject *input;
+    Stream *input_stream;
+    MYFLT thresh;
+    MYFLT deltime;
+    MYFLT cutoff;
+    MYFLT maxthresh;
+    MYFLT minthresh;
+    MYFLT reltime;
+    MYFLT rms;
+    MYFLT peak;
+    MYFLT zcross;
+    MYFLT lastSample;
+    MYFLT centroid;
+    int size;
+    int hsize;
+    int incount;
+    MYFLT *input_buffer;
+    MYFLT *inframe;
+    MYFLT *outframe;
+    MYFLT **twiddle;
+    const MYFLT *window;
+    Onset onset;
+    MYFLT *buffer_streams;
+} FeaturesMain;
+
+/* rms, peak and zero-crossings of a buffer, the reductions of FeaturesMain. */
+static void
+FeaturesMain_reduce(FeaturesMain *self, MYFLT *in, MYFLT *sum, MYFLT *peak, int *count) {
+    int i = 0, cnt = 0;
+    MYFLT inval, absin, last = self->lastSample, sm = 0.0, pk = 0.0;
+#ifdef VSIZE
+    int k;
+    MYFLT lanes[VSIZE];
+    VTYPE v, vlast, vdiff, vsign, zero = VSET1(0.0), one = VSET1(1.0), thresh = VSET1(self->thresh);
+    VTYPE vsm = zero, vpk = zero, vcnt = zero;
+    if (self->bufsize > VSIZE) {
+        /* The first sample is compared to the last one of the previous buffer. */
+        sm = in[0] * in[0];
+        pk = MYFABS(in[0]);
+        cnt = is_zcross(last, in[0], self->thresh);
+        for (i=1; i<=self->bufsize-VSIZE; i+=VSIZE) {
+            v = VLOAD(in+i);
+            vlast = VLOAD(in+i-1);
+            vsm = VADD(vsm, VMUL(v, v));
+            vpk = VMAX(vpk, VMAX(v, VSUB(zero, v)));
+            /* A crossing, as in is_zcross, is a change of sign by more than thresh. */
+            vsign = VSUB(VMASKGT(zero, vlast, one), VMASKGT(zero, v, one));
+            vdiff = VSUB(v, vlast);
+            vcnt = VADD(vcnt, VMASKGT(VMAX(vdiff, VSUB(zero, vdiff)), thresh, VMUL(vsign, vsign)));
+        }
+        VSTORE(lanes, vsm);
+        for (k=0; k<VSIZE; k++)
+            sm += lanes[k];
+        VSTORE(lanes, vpk);
+        for (k=0; k<VSIZE; k++) {
+            if (lanes[k] > pk)
+                pk = lanes[k];
+        }
+        VSTORE(lanes, vcnt);
+        for (k=0; k<VSIZE; k++)
+            cnt += (int)lanes[k];
+        last = in[i-1];
+    }
+#endif
+    for (; i<self->bufsize; i++) {
+        inval = in[i];
+        absin = MYFABS(inval);
+        sm += inval * inval;
+        if (absin > pk)
+            pk = absin;
+        cnt += is_zcross(last, inval, self->thresh);
+        last = inval;
+    }
+    self->lastSample = last;
+    *sum = sm;
+    *peak = pk;
+    *count = cnt;
+}
+
+static void
+FeaturesMain_process(FeaturesMain *self) {
+    int i, count;
+    MYFLT inval, sum, peak;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *rms = self->buffer_streams;
+    MYFLT *amp = rms + self->bufsize;
+    MYFLT *cent = amp + self->bufsize;
+    MYFLT *zc = cent + self->bufsize;
+    MYFLT *trig = zc + self->bufsize;
+
+    /* The onset follower is recursive and the centroid frames end anywhere
+       in the buffer, they stay sample by sample. */
+    for (i=0; i<self->bufsize; i++) {
+        inval = in[i];
+        rms[i] = self->rms;
+        amp[i] = self->peak;
+        zc[i] = self->zcross;
+        cent[i] = self->centroid;
+        trig[i] = Onset_next(&self->onset, MYFABS(inval));
+
+        self->input_buffer[self->incount++] = inval;
+        if (self->incount == self->size) {
+            self->incount = self->hsize;
+            self->centroid += spectral_centroid(self->input_buffer, self->inframe, self->outframe, self->size, self->window, self->twiddle) * self->sr / self->size;
+            self->centroid *= 0.5;
+            memmove(self->input_buffer, self->input_buffer + self->hsize, self->hsize * sizeof(MYFLT));
+        }
+    }
+
+    FeaturesMain_reduce(self, in, &sum, &peak, &count);
+    self->rms = MYSQRT(sum / self->bufsize);
+    self->peak = peak;
+    self->zcross = (MYFLT)count / self->bufsize;
+}
+
+static MYFLT *
+FeaturesMain_getSamplesBuffer(FeaturesMain *self)
+{
+    return (MYFLT *)self->buffer_streams;
+}
+
+static void
+FeaturesMain_setProcMode(FeaturesMain *self)
+{
+    self->proc_func_ptr = FeaturesMain_process;
+}
+
+static void
+FeaturesMain_compute_next_data_frame(FeaturesMain *self)
+{
+    (*self->proc_func_ptr)(self);
+}
+
+static int
+FeaturesMain_traverse(FeaturesMain *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->input);
+    Py_VISIT(self->input_stream);
+    return 0;
+}
+
+static int
+FeaturesMain_clear(FeaturesMain *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->input);
+    Py_CLEAR(self->input_stream);
+    return 0;
+}
+
+static void
+FeaturesMain_dealloc(FeaturesMain* self)
+{
+    pyo_DEALLOC
+    free(self->input_buffer);
+    free(self->inframe);
+    free(self->outframe);
+    free(self->buffer_streams);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->window);
+    Onset_free(&self->onset);
+    FeaturesMain_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+FeaturesMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i, k;
+    PyObject *inputtmp, *input_streamtmp;
+    FeaturesMain *self;
+    self = (FeaturesMain *)type->tp_alloc(type, 0);
+
+    self->size = 1024;
+    self->thresh = 0.0;
+    self->deltime = 0.005;
+    self->cutoff = 10.0;
+    self->maxthresh = 3.0;
+    self->minthresh = -30.0;
+    self->reltime = 0.1;
+    self->rms = self->peak = self->zcross = self->lastSample = self->centroid = 0.0;
+
+    INIT_OBJECT_COMMON
+    Stream_setFunctionPtr(self->stream, FeaturesMain_compute_next_data_frame);
+    self->mode_func_ptr = FeaturesMain_setProcMode;
+
+    static char *kwlist[] = {"input", "size", "thresh", "deltime", "cutoff", "maxthresh", "minthresh", "reltime", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_O_IFFFFFF, kwlist, &inputtmp, &self->size, &self->thresh, &self->deltime, &self->cutoff, &self->maxthresh, &self->minthresh, &self->reltime))
+        Py_RETURN_NONE;
+
+    if (self->size < self->bufsize) {
+        printf("Warning : Features size less than buffer size!\nFeatures size set to buffersize: %d\n", self->bufsize);
+        self->size = self->bufsize;
+    }
+
+    k = 1;
+    while (k < self->size)
+        k <<= 1;
+    self->size = k;
+    self->hsize = self->size / 2;
+    self->incount = self->hsize;
+
+    INIT_INPUT_STREAM
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    self->input_buffer = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->inframe = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->outframe = (MYFLT *)calloc(self->size, sizeof(MYFLT));
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    self->window = fft_acquire_window(self->size, 2);
+    self->buffer_streams = (MYFLT *)calloc(FEATURES_NUM * self->bufsize, sizeof(MYFLT));
+
+    Onset_init(&self->onset, self->sr);
+    self->deltime = Onset_setDeltime(&self->onset, self->deltime, self->sr);
+    self->cutoff = Onset_setCutoff(&self->onset, self->cutoff, self->sr);
+    self->maxthresh = Onset_setMaxthresh(&self->onset, self->maxthresh);
+    self->minthresh = Onset_setMinthresh(&self->onset, self->minthresh);
+    self->reltime = Onset_setReltime(&self->onset, self->reltime, self->sr);
+
+    Stream_setMemory(self->stream, (3 * self->size + FEATURES_NUM * self->bufsize + self->onset.memsize + 1) * sizeof(MYFLT));
+
+    (*self->mode_func_ptr)(self);
+
+    return (PyObject *)self;
+}
+
+static PyObject *
+FeaturesMain_setThresh(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->thresh = PyFloat_AS_DOUBLE(PyNumber_Float(arg));
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *
+FeaturesMain_setDeltime(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->deltime = Onset_setDeltime(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *
+FeaturesMain_setCutoff(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->cutoff = Onset_setCutoff(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *
+FeaturesMain_setMaxthresh(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->maxthresh = Onset_setMaxthresh(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)));
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *
+FeaturesMain_setMinthresh(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->minthresh = Onset_setMinthresh(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)));
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *
+FeaturesMain_setReltime(FeaturesMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isNumber = PyNumber_Check(arg);
+
+	if (isNumber == 1) {
+		self->reltime = Onset_setReltime(&self->onset, PyFloat_AS_DOUBLE(PyNumber_Float(arg)), self->sr);
+	}
+
+	Py_RETURN_NONE;
+}
+
+static PyObject * FeaturesMain_getServer(FeaturesMain* self) { GET_SERVER };
+static PyObject * FeaturesMain_getStream(FeaturesMain* self) { GET_STREAM };
+
+static PyObject * FeaturesMain_play(FeaturesMain *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * FeaturesMain_stop(FeaturesMain *self) { STOP };
+
+static PyMemberDef FeaturesMain_members[] = {
+{"server", T_OBJECT_EX, offsetof(FeaturesMain, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(FeaturesMain, stream), 0, "Stream object."},
+{"input", T_OBJECT_EX, offsetof(FeaturesMain, input), 0, "Input sound object."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef FeaturesMain_methods[] = {
+{"getServer", (PyCFunction)FeaturesMain_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)FeaturesMain_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)FeaturesMain_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)FeaturesMain_stop, METH_NOARGS, "Stops computing."},
+{"setThresh", (PyCFunction)FeaturesMain_setThresh, METH_O, "Sets the zero-crossing threshold."},
+{"setDeltime", (PyCFunction)FeaturesMain_setDeltime, METH_O, "Sets the delay time between current and previous analysis."},
+{"setCutoff", (PyCFunction)FeaturesMain_setCutoff, METH_O, "Sets the frequency of the internal lowpass filter."},
+{"setMaxthresh", (PyCFunction)FeaturesMain_setMaxthresh, METH_O, "Sets the higher threshold."},
+{"setMinthresh", (PyCFunction)FeaturesMain_setMinthresh, METH_O, "Sets the lower threshold."},
+{"setReltime", (PyCFunction)FeaturesMain_setReltime, METH_O, "Sets the release time."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject FeaturesMainType = {
+PyObject_HEAD_INIT(NULL)
+0,                                              /*ob_size*/
+"_pyo.FeaturesMain_base",                                   /*tp_name*/
+sizeof(FeaturesMain),                                 /*tp_basicsize*/
+0,                                              /*tp_itemsize*/
+(destructor)FeaturesMain_dealloc,                     /*tp_dealloc*/
+0,                                              /*tp_print*/
+0,                                              /*tp_getattr*/
+0,                                              /*tp_setattr*/
+0,                                              /*tp_compare*/
+0,                                              /*tp_repr*/
+0,                                              /*tp_as_number*/
+0,                                              /*tp_as_sequence*/
+0,                                              /*tp_as_mapping*/
+0,                                              /*tp_hash */
+0,                                              /*tp_call*/
+0,                                              /*tp_str*/
+0,                                              /*tp_getattro*/
+0,                                              /*tp_setattro*/
+0,                                              /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+"FeaturesMain objects. Computes rms, peak, centroid, zero-crossings and onsets in one pass.",           /* tp_doc */
+(traverseproc)FeaturesMain_traverse,                  /* tp_traverse */
+(inquiry)FeaturesMain_clear,                          /* tp_clear */
+0,                                              /* tp_richcompare */
+0,                                              /* tp_weaklistoffset */
+0,                                              /* tp_iter */
+0,                                              /* tp_iternext */
+FeaturesMain_methods,                                 /* tp_methods */
+FeaturesMain_members,                                 /* tp_members */
+0,                                              /* tp_getset */
+0,                                              /* tp_base */
+0,                                              /* tp_dict */
+0,                                              /* tp_descr_get */
+0,                                              /* tp_descr_set */
+0,                                              /* tp_dictoffset */
+0,                          /* tp_init */
+0,                                              /* tp_alloc */
+FeaturesMain_new,                                     /* tp_new */
+};
+
+/************/
+/* Features */
+/************/
+typedef struct {
+    pyo_audio_HEAD
+    FeaturesMain *mainAnalyser;
+    int modebuffer[2];
+    int chnl;
+} Features;
+
+static void Features_postprocessing_ii(Features *self) { POST_PROCESSING_II };
+static void Features_postprocessing_ai(Features *self) { POST_PROCESSING_AI };
+static void Features_postprocessing_ia(Features *self) { POST_PROCESSING_IA };
+static void Features_postprocessing_aa(Features *self) { POST_PROCESSING_AA };
+static void Features_postprocessing_ireva(Features *self) { POST_PROCESSING_IREVA };
+static void Features_postprocessing_areva(Features *self) { POST_PROCESSING_AREVA };
+static void Features_postprocessing_revai(Features *self) { POST_PROCESSING_REVAI };
+static void Features_postprocessing_revaa(Features *self) { POST_PROCESSING_REVAA };
+static void Features_postprocessing_revareva(Features *self) { POST_PROCESSING_REVAREVA };
+
+static void
+Features_setProcMode(Features *self)
+{
+    int muladdmode;
+    muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
+
+	switch (muladdmode) {
+        case 0:
+            self->muladd_func_ptr = Features_postprocessing_ii;
+            break;
+        case 1:
+            self->muladd_func_ptr = Features_postprocessing_ai;
+            break;
+        case 2:
+            self->muladd_func_ptr = Features_postprocessing_revai;
+            break;
+        case 10:
+            self->muladd_func_ptr = Features_postprocessing_ia;
+            break;
+        case 11:
+            self->muladd_func_ptr = Features_postprocessing_aa;
+            break;
+        case 12:
+            self->muladd_func_ptr = Features_postprocessing_revaa;
+            break;
+        case 20:
+            self->muladd_func_ptr = Features_postprocessing_ireva;
+            break;
+        case 21:
+            self->muladd_func_ptr = Features_postprocessing_areva;
+            break;
+        case 22:
+            self->muladd_func_ptr = Features_postprocessing_revareva;
+            break;
+    }
+}
+
+static void
+Features_compute_next_data_frame(Features *self)
+{
+    MYFLT *tmp = FeaturesMain_getSamplesBuffer(self->mainAnalyser);
+    memcpy(self->data, tmp + self->chnl * self->bufsize, self->bufsize * sizeof(MYFLT));
+    (*self->muladd_func_ptr)(self);
+}
+
+static int
+Features_traverse(Features *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->mainAnalyser);
+    return 0;
+}
+
+static int
+Features_clear(Features *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->mainAnalyser);
+    return 0;
+}
+
+static void
+Features_dealloc(Features* self)
+{
+    pyo_DEALLOC
+    Features_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+Features_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i;
+    PyObject *maintmp=NULL, *multmp=NULL, *addtmp=NULL;
+    Features *self;
+    self = (Features *)type->tp_alloc(type, 0);
+
+    self->chnl = 0;
+	self->modebuffer[0] = 0;
+	self->modebuffer[1] = 0;
+
+    INIT_OBJECT_COMMON
+    Stream_setFunctionPtr(self->stream, Features_compute_next_data_frame);
+    self->mode_func_ptr = Features_setProcMode;
+
+    static char *kwlist[] = {"mainAnalyser", "chnl", "mul", "add", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|iOO", kwlist, &maintmp, &self->chnl, &multmp, &addtmp))
+        Py_RETURN_NONE;
+
+    if (self->chnl < 0 || self->chnl >= FEATURES_NUM)
+        self->chnl = 0;
+
+    Py_XDECREF(self->mainAnalyser);
+    Py_INCREF(maintmp);
+    self->mainAnalyser = (FeaturesMain *)maintmp;
+
+    if (multmp) {
+        PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
+    }
+
+    if (addtmp) {
+        PyObject_CallMethod((PyObject *)self, "setAdd", "O", addtmp);
+    }
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    (*self->mode_func_ptr)(self);
+
+    return (PyObject *)self;
+}
+
+static PyObject * Features_getServer(Features* self) { GET_SERVER };
+static PyObject * Features_getStream(Features* self) { GET_STREAM };
+static PyObject * Features_setMul(Features *self, PyObject *arg) { SET_MUL };
+static PyObject * Features_setAdd(Features *self, PyObject *arg) { SET_ADD };
+static PyObject * Features_setSub(Features *self, PyObject *arg) { SET_SUB };
+static PyObject * Features_setDiv(Features *self, PyObject *arg) { SET_DIV };
+
+static PyObject * Features_play(Features *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * Features_stop(Features *self) { STOP };
+
+static PyObject * Features_multiply(Features *self, PyObject *arg) { MULTIPLY };
+static PyObject * Features_inplace_multiply(Features *self, PyObject *arg) { INPLACE_MULTIPLY };
+static PyObject * Features_add(Features *self, PyObject *arg) { ADD };
+static PyObject * Features_inplace_add(Features *self, PyObject *arg) { INPLACE_ADD };
+static PyObject * Features_sub(Features *self, PyObject *arg) { SUB };
+static PyObject * Features_inplace_sub(Features *self, PyObject *arg) { INPLACE_SUB };
+static PyObject * Features_div(Features *self, PyObject *arg) { DIV };
+static PyObject * Features_inplace_div(Features *self, PyObject *arg) { INPLACE_DIV };
+
+static PyMemberDef Features_members[] = {
+{"server", T_OBJECT_EX, offsetof(Features, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(Features, stream), 0, "Stream object."},
+{"mul", T_OBJECT_EX, offsetof(Features, mul), 0, "Mul factor."},
+{"add", T_OBJECT_EX, offsetof(Features, add), 0, "Add factor."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef Features_methods[] = {
+{"getServer", (PyCFunction)Features_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)Features_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)Features_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)Features_stop, METH_NOARGS, "Stops computing."},
+{"setMul", (PyCFunction)Features_setMul, METH_O, "Sets Features mul factor."},
+{"setAdd", (PyCFunction)Features_setAdd, METH_O, "Sets Features add factor."},
+{"setSub", (PyCFunction)Features_setSub, METH_O, "Sets inverse add factor."},
+{"setDiv", (PyCFunction)Features_setDiv, METH_O, "Sets inverse mul factor."},
+{NULL}  /* Sentinel */
+};
+
+static PyNumberMethods Features_as_number = {
+(binaryfunc)Features_add,                      /*nb_add*/
+(binaryfunc)Features_sub,                 /*nb_subtract*/
+(binaryfunc)Features_multiply,                 /*nb_multiply*/
+(binaryfunc)Features_div,                   /*nb_divide*/
+0,                /*nb_remainder*/
+0,                   /*nb_divmod*/
+0,                   /*nb_power*/
+0,                  /*nb_neg*/
+0,                /*nb_pos*/
+0,                  /*(unaryfunc)array_abs,*/
+0,                    /*nb_nonzero*/
+0,                    /*nb_invert*/
+0,               /*nb_lshift*/
+0,              /*nb_rshift*/
+0,              /*nb_and*/
+0,              /*nb_xor*/
+0,               /*nb_or*/
+0,                                          /*nb_coerce*/
+0,                       /*nb_int*/
+0,                      /*nb_long*/
+0,                     /*nb_float*/
+0,                       /*nb_oct*/
+0,                       /*nb_hex*/
+(binaryfunc)Features_inplace_add,              /*inplace_add*/
+(binaryfunc)Features_inplace_sub,         /*inplace_subtract*/
+(binaryfunc)Features_inplace_multiply,         /*inplace_multiply*/
+(binaryfunc)Features_inplace_div,           /*inplace_divide*/
+0,        /*inplace_remainder*/
+0,           /*inplace_power*/
+0,       /*inplace_lshift*/
+0,      /*inplace_rshift*/
+0,      /*inplace_and*/
+0,      /*inplace_xor*/
+0,       /*inplace_or*/
+0,             /*nb_floor_divide*/
+0,              /*nb_true_divide*/
+0,     /*nb_inplace_floor_divide*/
+0,      /*nb_inplace_true_divide*/
+0,                     /* nb_index */
+};
+
+PyTypeObject FeaturesType = {
+PyObject_HEAD_INIT(NULL)
+0,                                              /*ob_size*/
+"_pyo.Features_base",                                   /*tp_name*/
+sizeof(Features),                                 /*tp_basicsize*/
+0,                                              /*tp_itemsize*/
+(destructor)Features_dealloc,                     /*tp_dealloc*/
+0,                                              /*tp_print*/
+0,                                              /*tp_getattr*/
+0,                                              /*tp_setattr*/
+0,                                              /*tp_compare*/
+0,                                              /*tp_repr*/
+&Features_as_number,                              /*tp_as_number*/
+0,                                              /*tp_as_sequence*/
+0,                                              /*tp_as_mapping*/
+0,                                              /*tp_hash */
+0,                                              /*tp_call*/
+0,                                              /*tp_str*/
+0,                                              /*tp_getattro*/
+0,                                              /*tp_setattro*/
+0,                                              /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+"Features objects. Reads one feature stream from a FeaturesMain object.",           /* tp_doc */
+(traverseproc)Features_traverse,                  /* tp_traverse */
+(inquiry)Features_clear,                          /* tp_clear */
+0,                                              /* tp_richcompare */
+0,                                              /* tp_weaklistoffset */
+0,                                              /* tp_iter */
+0,                                              /* tp_iternext */
+Features_methods,                                 /* tp_methods */
+Features_members,                                 /* tp_members */
+0,                                              /* tp_getset */
+0,                                              /* tp_base */
+0,                                              /* tp_dict */
+0,                                              /* tp_descr_get */
+0,                                              /* tp_descr_set */
+0,                                              /* tp_dictoffset */
+0,                          /* tp_init */
+0,                                              /* tp_alloc */
+Features_new,                                     /* tp_new */
+};
@@ -38,12 +38,15 @@ typedef struct {
 
 static void
 M_Sin_process(M_Sin *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYSIN(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Sin_postprocessing_ii(M_Sin *self) { POST_PROCESSING_II };
@@ -303,12 +306,15 @@ typedef struct {
 
 static void
 M_Cos_process(M_Cos *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYCOS(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Cos_postprocessing_ii(M_Cos *self) { POST_PROCESSING_II };
@@ -568,12 +574,15 @@ typedef struct {
 
 static void
 M_Tan_process(M_Tan *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYTAN(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Tan_postprocessing_ii(M_Tan *self) { POST_PROCESSING_II };
@@ -833,17 +842,20 @@ typedef struct {
 
 static void
 M_Abs_process(M_Abs *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT inval;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         inval = in[i];
         if (inval < 0.0)
             self->data[i] = -inval;
         else
             self->data[i] = inval;
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Abs_postprocessing_ii(M_Abs *self) { POST_PROCESSING_II };
@@ -1103,17 +1115,20 @@ typedef struct {
 
 static void
 M_Sqrt_process(M_Sqrt *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT inval;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         inval = in[i];
         if (inval < 0.0)
             self->data[i] = 0.0;
         else
             self->data[i] = MYSQRT(inval);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Sqrt_postprocessing_ii(M_Sqrt *self) { POST_PROCESSING_II };
@@ -1373,17 +1388,20 @@ typedef struct {
 
 static void
 M_Log_process(M_Log *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT inval;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         inval = in[i];
         if (inval <= 0.0)
             self->data[i] = 0.0;
         else
             self->data[i] = MYLOG(inval);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Log_postprocessing_ii(M_Log *self) { POST_PROCESSING_II };
@@ -1643,17 +1661,20 @@ typedef struct {
 
 static void
 M_Log10_process(M_Log10 *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT inval;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         inval = in[i];
         if (inval <= 0.0)
             self->data[i] = 0.0;
         else
             self->data[i] = MYLOG10(inval);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Log10_postprocessing_ii(M_Log10 *self) { POST_PROCESSING_II };
@@ -1913,17 +1934,20 @@ typedef struct {
 
 static void
 M_Log2_process(M_Log2 *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT inval;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         inval = in[i];
         if (inval <= 0.0)
             self->data[i] = 0.0;
         else
             self->data[i] = MYLOG2(inval);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Log2_postprocessing_ii(M_Log2 *self) { POST_PROCESSING_II };
@@ -2185,50 +2209,56 @@ typedef struct {
 
 static void
 M_Pow_readframes_ii(M_Pow *self) {
-    int i;
-
     MYFLT base = PyFloat_AS_DOUBLE(self->base);
     MYFLT exp = PyFloat_AS_DOUBLE(self->exponent);
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = MYPOW(base, exp);
-    }
+    self->data[0] = MYPOW(base, exp);
+    CONSTANT_OUTPUT
 }
 
 static void
 M_Pow_readframes_ai(M_Pow *self) {
-    int i;
+    int i, num = Stream_isConstant(self->base_stream) ? 1 : self->bufsize;
 
     MYFLT *base = Stream_getData((Stream *)self->base_stream);
     MYFLT exp = PyFloat_AS_DOUBLE(self->exponent);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYPOW(base[i], exp);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void
 M_Pow_readframes_ia(M_Pow *self) {
-    int i;
+    int i, num = Stream_isConstant(self->exponent_stream) ? 1 : self->bufsize;
 
     MYFLT base = PyFloat_AS_DOUBLE(self->base);
     MYFLT *exp = Stream_getData((Stream *)self->exponent_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYPOW(base, exp[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void
 M_Pow_readframes_aa(M_Pow *self) {
-    int i;
+    int i, num = Stream_isConstant(self->base_stream) && Stream_isConstant(self->exponent_stream) ? 1 : self->bufsize;
 
     MYFLT *base = Stream_getData((Stream *)self->base_stream);
     MYFLT *exp = Stream_getData((Stream *)self->exponent_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYPOW(base[i], exp[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Pow_postprocessing_ii(M_Pow *self) { POST_PROCESSING_II };
@@ -2588,50 +2618,56 @@ typedef struct {
 
 static void
 M_Atan2_readframes_ii(M_Atan2 *self) {
-    int i;
-
     MYFLT b = PyFloat_AS_DOUBLE(self->b);
     MYFLT a = PyFloat_AS_DOUBLE(self->a);
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = MYATAN2(b, a);
-    }
+    self->data[0] = MYATAN2(b, a);
+    CONSTANT_OUTPUT
 }
 
 static void
 M_Atan2_readframes_ai(M_Atan2 *self) {
-    int i;
+    int i, num = Stream_isConstant(self->b_stream) ? 1 : self->bufsize;
 
     MYFLT *b = Stream_getData((Stream *)self->b_stream);
     MYFLT a = PyFloat_AS_DOUBLE(self->a);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYATAN2(b[i], a);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void
 M_Atan2_readframes_ia(M_Atan2 *self) {
-    int i;
+    int i, num = Stream_isConstant(self->a_stream) ? 1 : self->bufsize;
 
     MYFLT b = PyFloat_AS_DOUBLE(self->b);
     MYFLT *a = Stream_getData((Stream *)self->a_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYATAN2(b, a[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void
 M_Atan2_readframes_aa(M_Atan2 *self) {
-    int i;
+    int i, num = Stream_isConstant(self->b_stream) && Stream_isConstant(self->a_stream) ? 1 : self->bufsize;
 
     MYFLT *b = Stream_getData((Stream *)self->b_stream);
     MYFLT *a = Stream_getData((Stream *)self->a_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYATAN2(b[i], a[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Atan2_postprocessing_ii(M_Atan2 *self) { POST_PROCESSING_II };
@@ -2989,12 +3025,15 @@ typedef struct {
 
 static void
 M_Floor_process(M_Floor *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYFLOOR(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Floor_postprocessing_ii(M_Floor *self) { POST_PROCESSING_II };
@@ -3254,12 +3293,15 @@ typedef struct {
 
 static void
 M_Ceil_process(M_Ceil *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYCEIL(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Ceil_postprocessing_ii(M_Ceil *self) { POST_PROCESSING_II };
@@ -3519,12 +3561,15 @@ typedef struct {
 
 static void
 M_Round_process(M_Round *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYROUND(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Round_postprocessing_ii(M_Round *self) { POST_PROCESSING_II };
@@ -3784,12 +3829,15 @@ typedef struct {
 
 static void
 M_Tanh_process(M_Tanh *self) {
-    int i;
+    int i, num = Stream_isConstant(self->input_stream) ? 1 : self->bufsize;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
+    for (i=0; i<num; i++) {
         self->data[i] = MYTANH(in[i]);
     }
+    if (num == 1) {
+        CONSTANT_OUTPUT
+    }
 }
 
 static void M_Tanh_postprocessing_ii(M_Tanh *self) { POST_PROCESSING_II };
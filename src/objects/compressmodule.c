@@ -25,6 +25,106 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "simd.h"
+
+/* Approximations of log2 and exp2 for the gain computers, without calls
+   into libm and without branches in the polynomial, with vector versions for
+   the gain loop of Compress. The error is below 0.0001 dB over the audio
+   range. */
+#define C_LOG2_10_OVER_20 0.16609640474436813
+
+static inline MYFLT
+C_log2(MYFLT x)
+{
+    union { float f; unsigned int i; } u;
+    MYFLT e, m;
+
+    u.f = (float)x;
+    e = (MYFLT)((int)((u.i >> 23) & 255) - 127);
+    u.i = (u.i & 0x007FFFFF) | 0x3F800000;
+    m = u.f - 1.0;
+    return e + 1.6514671e-5 + m * (1.4414924 + m * (-0.70648645 + m * (0.4094703 + m * (-0.1874886 + m * 0.043004958))));
+}
+
+static inline MYFLT
+C_exp2(MYFLT x)
+{
+    union { float f; unsigned int i; } u;
+    int e;
+    MYFLT f;
+
+    if (x < -126.0)
+        x = -126.0;
+    else if (x > 126.0)
+        x = 126.0;
+    e = (int)x;
+    if (x < e)
+        e--;
+    f = x - e;
+    u.i = (unsigned int)(e + 127) << 23;
+    return u.f * (1.0000035 + f * (0.69297292 + f * (0.24160436 + f * (0.051744998 + f * 0.013670309))));
+}
+
+#if defined(VSIZE) && defined(VEXP2I) && defined(VFLOOR)
+static inline VTYPE
+C_log2_v(VTYPE x)
+{
+    VTYPE m = VSUB(VMANTISSA(x), VSET1(1.0));
+    return VADD(VADD(VEXPONENT(x), VSET1(1.6514671e-5)), VMUL(m, VADD(VSET1(1.4414924), VMUL(m, VADD(VSET1(-0.70648645),
+           VMUL(m, VADD(VSET1(0.4094703), VMUL(m, VADD(VSET1(-0.1874886), VMUL(m, VSET1(0.043004958)))))))))));
+}
+
+static inline VTYPE
+C_exp2_v(VTYPE x)
+{
+    VTYPE e, f;
+    x = VMIN(VMAX(x, VSET1(-126.0)), VSET1(126.0));
+    e = VFLOOR(x);
+    f = VSUB(x, e);
+    return VMUL(VEXP2I(e), VADD(VSET1(1.0000035), VMUL(f, VADD(VSET1(0.69297292), VMUL(f, VADD(VSET1(0.24160436),
+           VMUL(f, VADD(VSET1(0.051744998), VMUL(f, VSET1(0.013670309))))))))));
+}
+#endif
+
+/* Amplitudes of the thresholds `thresh` in dB, for the gates with an audio
+   rate threshold. */
+static void
+C_amp_thresholds(MYFLT *thresh, MYFLT *out, int size)
+{
+    int i = 0;
+#if defined(VSIZE) && defined(VEXP2I) && defined(VFLOOR)
+    VTYPE scl = VSET1(C_LOG2_10_OVER_20);
+    for (; i<=size-VSIZE; i+=VSIZE)
+        VSTORE(out + i, C_exp2_v(VMUL(VLOAD(thresh + i), scl)));
+#endif
+    for (; i<size; i++)
+        out[i] = C_exp2(thresh[i] * C_LOG2_10_OVER_20);
+}
+
+/* Sets the optional `sidechain` input, followed instead of the input when
+   given. None removes it. */
+#define SET_SIDECHAIN \
+    PyObject *streamtmp; \
+    if (arg == NULL) { \
+        Py_INCREF(Py_None); \
+        return Py_None; \
+    } \
+    if (arg == Py_None) { \
+        Py_CLEAR(self->sidechain_stream); \
+        Py_CLEAR(self->sidechain); \
+    } \
+    else { \
+        streamtmp = PyObject_CallMethod(arg, "_getStream", NULL); \
+        if (streamtmp == NULL) \
+            return NULL; \
+        Py_INCREF(arg); \
+        Py_XDECREF(self->sidechain); \
+        self->sidechain = arg; \
+        Py_XDECREF(self->sidechain_stream); \
+        self->sidechain_stream = (Stream *)streamtmp; \
+    } \
+    Py_INCREF(Py_None); \
+    return Py_None;
 
 /* Compressor */
 typedef struct {
@@ -39,6 +139,8 @@ typedef struct {
     Stream *falltime_stream;
     Stream *thresh_stream;
     Stream *ratio_stream;
+    PyObject *sidechain;
+    Stream *sidechain_stream;
     int modebuffer[6]; // need at least 2 slots for mul & add
     int outputAmp;
     MYFLT follow;
@@ -47,6 +149,7 @@ typedef struct {
     long lh_size;
     long lh_in_count;
     MYFLT *lh_buffer;
+    MYFLT *envelope;
 } Compress;
 
 static MYFLT
@@ -60,15 +163,20 @@ C_clip(MYFLT x)
         return x;
 }
 
+/* The follower and the look ahead run sample by sample, the gain is then
+   computed over the whole buffer in the log2 domain:
+   gain = 2^((ratio - 1) * (log2(env) - log2(thresh))). */
 static void
 Compress_compress_soft(Compress *self) {
-    MYFLT samp, ampthresh, absin, indb, diff, outdb, outa;
+    MYFLT absin, follow, ampthresh, lthresh, lfollow, gain, risefactor, fallfactor;
     MYFLT kneethresh, kneescl, knee, kneeratio, invKneeRange;
     MYFLT risetime, falltime, thresh, ratio;
     int i;
     long ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
+    MYFLT *env = self->envelope;
 
     if (self->modebuffer[2] == 0)
         risetime = PyFloat_AS_DOUBLE(self->risetime);
@@ -92,58 +200,77 @@ Compress_compress_soft(Compress *self) {
         ratio = Stream_getData((Stream *)self->ratio_stream)[0];
 
     ratio = 1.0 / ratio;
-    risetime = MYEXP(-1.0 / (self->sr * risetime));
-    falltime = MYEXP(-1.0 / (self->sr * falltime));
+    risefactor = MYEXP(-1.0 / (self->sr * risetime));
+    fallfactor = MYEXP(-1.0 / (self->sr * falltime));
     knee = self->knee * 0.999 + 0.001; /* 0 = hard knee, 1 = soft knee */
     thresh += 3.0 * self->knee;
     if (thresh > 0.0)
         thresh = 0.0;
+    lthresh = thresh * C_LOG2_10_OVER_20;
     ampthresh = MYPOW(10.0, thresh * 0.05); /* up to 3 dB above threshold */
     kneethresh = MYPOW(10.0, (thresh - (self->knee * 8.5 + 0.5)) * 0.05); /* up to 6 dB under threshold */
     invKneeRange = 1.0 / (ampthresh - kneethresh);
 
+    /* Envelope follower and look ahead */
+    follow = self->follow;
     for (i=0; i<self->bufsize; i++) {
-        /* Envelope follower */
-        absin = in[i];
-        if (absin < 0.0)
-            absin = -absin;
-        if (self->follow < absin)
-            self->follow = absin + risetime * (self->follow - absin);
+        absin = MYFABS(sc[i]);
+        if (follow < absin)
+            follow = absin + risefactor * (follow - absin);
         else
-            self->follow = absin + falltime * (self->follow - absin);
+            follow = absin + fallfactor * (follow - absin);
+        env[i] = follow;
 
-        /* Look ahead */
         ind = self->lh_in_count - self->lh_delay;
         if (ind < 0)
             ind += self->lh_size;
-        samp = self->lh_buffer[ind];
+        self->data[i] = self->lh_buffer[ind];
 
         self->lh_buffer[self->lh_in_count] = in[i];
         self->lh_in_count++;
         if (self->lh_in_count >= self->lh_size)
             self->lh_in_count = 0;
-
-        /* Compress signal */
-        outa = 1.0;
-        if (self->follow > ampthresh) { /* Above threshold */
-            indb = 20.0 * MYLOG10(C_clip(self->follow));
-            diff = indb - thresh;
-            outdb = diff - diff * ratio;
-            outa = MYPOW(10.0, -outdb * 0.05);
+    }
+    self->follow = follow;
+
+    /* Gain computer. The vector loop has no branch: the knee scale, clipped
+       to [0, 1], gives a ratio of 1 under the knee and `ratio` above it. */
+    i = 0;
+#if defined(VSIZE) && defined(VEXP2I) && defined(VFLOOR)
+    VTYPE vf, vks, vr, zero = VSET1(0.0), one = VSET1(1.0), vmin = VSET1(0.00000001);
+    VTYPE vknee = VSET1(knee), vkneethresh = VSET1(kneethresh), vinvrange = VSET1(invKneeRange);
+    VTYPE vratio = VSET1(ratio - 1.0), vlthresh = VSET1(lthresh);
+    for (; i<=self->bufsize-VSIZE; i+=VSIZE) {
+        vf = VLOAD(env + i);
+        vks = VMIN(VMAX(VMUL(VSUB(vf, vkneethresh), vinvrange), zero), one);
+        vr = VMUL(VDIV(VMUL(VADD(vknee, one), vks), VADD(vknee, vks)), vratio);
+        vf = C_log2_v(VMIN(VMAX(vf, vmin), one));
+        vf = C_exp2_v(VMUL(vr, VSUB(vf, vlthresh)));
+        VSTORE(env + i, VMIN(VMAX(vf, vmin), one));
+    }
+#endif
+    for (; i<self->bufsize; i++) {
+        follow = env[i];
+        gain = 1.0;
+        if (follow > ampthresh) { /* Above threshold */
+            lfollow = C_log2(C_clip(follow));
+            gain = C_exp2((ratio - 1.0) * (lfollow - lthresh));
         }
-        else if (self->follow > kneethresh) { /* Under the knee */
-            kneescl = (self->follow - kneethresh) * invKneeRange;
+        else if (follow > kneethresh) { /* Under the knee */
+            kneescl = (follow - kneethresh) * invKneeRange;
             kneeratio = (((knee + 1.0) * kneescl) / (knee + kneescl)) * (ratio - 1.0) + 1.0;
-            indb = 20.0 * MYLOG10(C_clip(self->follow));
-            diff = indb - thresh;
-            outdb = diff - diff * kneeratio;
-            outa = MYPOW(10.0, -outdb * 0.05);
+            lfollow = C_log2(C_clip(follow));
+            gain = C_exp2((kneeratio - 1.0) * (lfollow - lthresh));
         }
-        if (self->outputAmp == 0)
-            self->data[i] = samp * C_clip(outa);
-        else
-            self->data[i] = C_clip(outa);
+        env[i] = C_clip(gain);
     }
+
+    if (self->outputAmp == 0) {
+        for (i=0; i<self->bufsize; i++)
+            self->data[i] *= env[i];
+    }
+    else
+        memcpy(self->data, env, self->bufsize * sizeof(MYFLT));
 }
 
 static void Compress_postprocessing_ii(Compress *self) { POST_PROCESSING_II };
@@ -214,6 +341,8 @@ Compress_traverse(Compress *self, visitproc visit, void *arg)
     Py_VISIT(self->thresh_stream);
     Py_VISIT(self->ratio);
     Py_VISIT(self->ratio_stream);
+    Py_VISIT(self->sidechain);
+    Py_VISIT(self->sidechain_stream);
     return 0;
 }
 
@@ -231,6 +360,8 @@ Compress_clear(Compress *self)
     Py_CLEAR(self->thresh_stream);
     Py_CLEAR(self->ratio);
     Py_CLEAR(self->ratio_stream);
+    Py_CLEAR(self->sidechain);
+    Py_CLEAR(self->sidechain_stream);
     return 0;
 }
 
@@ -239,6 +370,7 @@ Compress_dealloc(Compress* self)
 {
     pyo_DEALLOC
     free(self->lh_buffer);
+    free(self->envelope);
     Compress_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -248,7 +380,7 @@ Compress_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i;
     PyObject *inputtmp, *input_streamtmp, *threshtmp=NULL, *ratiotmp=NULL, *risetimetmp=NULL, *falltimetmp=NULL, *multmp=NULL, *addtmp=NULL;
-    PyObject *looktmp=NULL, *kneetmp=NULL;
+    PyObject *looktmp=NULL, *kneetmp=NULL, *sidechaintmp=NULL;
     Compress *self;
     self = (Compress *)type->tp_alloc(type, 0);
 
@@ -273,9 +405,9 @@ Compress_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, Compress_compute_next_data_frame);
     self->mode_func_ptr = Compress_setProcMode;
 
-    static char *kwlist[] = {"input", "thresh", "ratio", "risetime", "falltime", "lookahead", "knee", "outputAmp", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "thresh", "ratio", "risetime", "falltime", "lookahead", "knee", "outputAmp", "sidechain", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOOOiOO", kwlist, &inputtmp, &threshtmp, &ratiotmp, &risetimetmp, &falltimetmp, &looktmp, &kneetmp, &self->outputAmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOOOiOOO", kwlist, &inputtmp, &threshtmp, &ratiotmp, &risetimetmp, &falltimetmp, &looktmp, &kneetmp, &self->outputAmp, &sidechaintmp, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -304,6 +436,10 @@ Compress_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setAdd", "O", addtmp);
     }
 
+    if (sidechaintmp) {
+        PyObject_CallMethod((PyObject *)self, "setSidechain", "O", sidechaintmp);
+    }
+
     PyObject_CallMethod((PyObject *)self, "setLookAhead", "O", looktmp);
     PyObject_CallMethod((PyObject *)self, "setKnee", "O", kneetmp);
 
@@ -312,6 +448,8 @@ Compress_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->lh_size+1); i++) {
         self->lh_buffer[i] = 0.;
     }
+    self->envelope = (MYFLT *)calloc(self->bufsize, sizeof(MYFLT));
+    Stream_setMemory(self->stream, (self->lh_size + 1 + self->bufsize) * sizeof(MYFLT));
 
     self->proc_func_ptr = Compress_compress_soft;
 
@@ -470,6 +608,9 @@ Compress_setFallTime(Compress *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Compress_setSidechain(Compress *self, PyObject *arg) { SET_SIDECHAIN };
+
 static PyObject *
 Compress_setLookAhead(Compress *self, PyObject *arg)
 {
@@ -539,6 +680,7 @@ static PyMethodDef Compress_methods[] = {
 {"setFallTime", (PyCFunction)Compress_setFallTime, METH_O, "Sets falling portamento time in seconds."},
 {"setLookAhead", (PyCFunction)Compress_setLookAhead, METH_O, "Sets look ahead time in ms."},
 {"setKnee", (PyCFunction)Compress_setKnee, METH_O, "Sets the knee between 0 (hard) and 1 (soft)."},
+{"setSidechain", (PyCFunction)Compress_setSidechain, METH_O, "Sets the signal followed by the compressor, None for the input."},
 {"setMul", (PyCFunction)Compress_setMul, METH_O, "Sets mul factor."},
 {"setAdd", (PyCFunction)Compress_setAdd, METH_O, "Sets add factor."},
 {"setSub", (PyCFunction)Compress_setSub, METH_O, "Sets inverse add factor."},
@@ -657,6 +799,8 @@ typedef struct {
     long lh_size;
     long lh_in_count;
     MYFLT *lh_buffer;
+    PyObject *sidechain;
+    Stream *sidechain_stream;
 } Gate;
 
 static void
@@ -665,6 +809,7 @@ Gate_filters_iii(Gate *self) {
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     thresh = PyFloat_AS_DOUBLE(self->thresh);
     risetime = PyFloat_AS_DOUBLE(self->risetime);
@@ -687,7 +832,7 @@ Gate_filters_iii(Gate *self) {
     ampthresh = MYPOW(10.0, thresh * 0.05);
     for (i=0; i<self->bufsize; i++) {
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -717,11 +862,14 @@ Gate_filters_iii(Gate *self) {
 
 static void
 Gate_filters_aii(Gate *self) {
-    MYFLT samp, absin, thresh, ampthresh, risetime, falltime;
+    MYFLT samp, absin, ampthresh, risetime, falltime;
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
     MYFLT *tr = Stream_getData((Stream *)self->thresh_stream);
+    /* The thresholds are read in data before each sample is written. */
+    C_amp_thresholds(tr, self->data, self->bufsize);
 
     risetime = PyFloat_AS_DOUBLE(self->risetime);
     if (risetime <= 0.0)
@@ -741,10 +889,9 @@ Gate_filters_aii(Gate *self) {
     }
 
     for (i=0; i<self->bufsize; i++) {
-        thresh = tr[i];
-        ampthresh = MYPOW(10.0, thresh * 0.05);
+        ampthresh = self->data[i];
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -778,6 +925,7 @@ Gate_filters_iai(Gate *self) {
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     thresh = PyFloat_AS_DOUBLE(self->thresh);
     MYFLT *rise = Stream_getData((Stream *)self->risetime_stream);
@@ -802,7 +950,7 @@ Gate_filters_iai(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -832,12 +980,15 @@ Gate_filters_iai(Gate *self) {
 
 static void
 Gate_filters_aai(Gate *self) {
-    MYFLT samp, absin, thresh, ampthresh, risetime, falltime;
+    MYFLT samp, absin, ampthresh, risetime, falltime;
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     MYFLT *tr = Stream_getData((Stream *)self->thresh_stream);
+    /* The thresholds are read in data before each sample is written. */
+    C_amp_thresholds(tr, self->data, self->bufsize);
     MYFLT *rise = Stream_getData((Stream *)self->risetime_stream);
 
     falltime = PyFloat_AS_DOUBLE(self->falltime);
@@ -850,8 +1001,7 @@ Gate_filters_aai(Gate *self) {
     }
 
     for (i=0; i<self->bufsize; i++) {
-        thresh = tr[i];
-        ampthresh = MYPOW(10.0, thresh * 0.05);
+        ampthresh = self->data[i];
         risetime = rise[i];
         if (risetime <= 0.0)
             risetime = GATE_MIN_RAMP_TIME;
@@ -861,7 +1011,7 @@ Gate_filters_aai(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -895,6 +1045,7 @@ Gate_filters_iia(Gate *self) {
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     thresh = PyFloat_AS_DOUBLE(self->thresh);
     risetime = PyFloat_AS_DOUBLE(self->risetime);
@@ -918,7 +1069,7 @@ Gate_filters_iia(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -948,12 +1099,15 @@ Gate_filters_iia(Gate *self) {
 
 static void
 Gate_filters_aia(Gate *self) {
-    MYFLT samp, absin, thresh, ampthresh, risetime, falltime;
+    MYFLT samp, absin, ampthresh, risetime, falltime;
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     MYFLT *tr = Stream_getData((Stream *)self->thresh_stream);
+    /* The thresholds are read in data before each sample is written. */
+    C_amp_thresholds(tr, self->data, self->bufsize);
     risetime = PyFloat_AS_DOUBLE(self->risetime);
     if (risetime <= 0.0)
         risetime = GATE_MIN_RAMP_TIME;
@@ -965,8 +1119,7 @@ Gate_filters_aia(Gate *self) {
     }
 
     for (i=0; i<self->bufsize; i++) {
-        thresh = tr[i];
-        ampthresh = MYPOW(10.0, thresh * 0.05);
+        ampthresh = self->data[i];
         falltime = fall[i];
         if (falltime <= 0.0)
             falltime = GATE_MIN_RAMP_TIME;
@@ -976,7 +1129,7 @@ Gate_filters_aia(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -1010,6 +1163,7 @@ Gate_filters_iaa(Gate *self) {
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     thresh = PyFloat_AS_DOUBLE(self->thresh);
     MYFLT *rise = Stream_getData((Stream *)self->risetime_stream);
@@ -1033,7 +1187,7 @@ Gate_filters_iaa(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -1063,18 +1217,20 @@ Gate_filters_iaa(Gate *self) {
 
 static void
 Gate_filters_aaa(Gate *self) {
-    MYFLT samp, absin, thresh, ampthresh, risetime, falltime;
+    MYFLT samp, absin, ampthresh, risetime, falltime;
     int i, ind;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *sc = self->sidechain_stream != NULL ? Stream_getData((Stream *)self->sidechain_stream) : in;
 
     MYFLT *tr = Stream_getData((Stream *)self->thresh_stream);
+    /* The thresholds are read in data before each sample is written. */
+    C_amp_thresholds(tr, self->data, self->bufsize);
     MYFLT *rise = Stream_getData((Stream *)self->risetime_stream);
     MYFLT *fall = Stream_getData((Stream *)self->falltime_stream);
 
     for (i=0; i<self->bufsize; i++) {
-        thresh = tr[i];
-        ampthresh = MYPOW(10.0, thresh * 0.05);
+        ampthresh = self->data[i];
         risetime = rise[i];
         if (risetime <= 0.0)
             risetime = 0.001;
@@ -1091,7 +1247,7 @@ Gate_filters_aaa(Gate *self) {
         }
 
         /* Follower */
-        absin = in[i] * in[i];
+        absin = sc[i] * sc[i];
         self->lpfollow = absin + self->lpfactor * (self->lpfollow - absin);
 
         /* Gate slope */
@@ -1212,6 +1368,8 @@ Gate_traverse(Gate *self, visitproc visit, void *arg)
     Py_VISIT(self->risetime_stream);
     Py_VISIT(self->falltime);
     Py_VISIT(self->falltime_stream);
+    Py_VISIT(self->sidechain);
+    Py_VISIT(self->sidechain_stream);
     return 0;
 }
 
@@ -1227,6 +1385,8 @@ Gate_clear(Gate *self)
     Py_CLEAR(self->risetime_stream);
     Py_CLEAR(self->falltime);
     Py_CLEAR(self->falltime_stream);
+    Py_CLEAR(self->sidechain);
+    Py_CLEAR(self->sidechain_stream);
     return 0;
 }
 
@@ -1244,7 +1404,7 @@ Gate_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i;
     PyObject *inputtmp, *input_streamtmp, *threshtmp=NULL, *risetimetmp=NULL, *falltimetmp=NULL, *multmp=NULL, *addtmp=NULL;
-    PyObject *looktmp=NULL;
+    PyObject *looktmp=NULL, *sidechaintmp=NULL;
     Gate *self;
     self = (Gate *)type->tp_alloc(type, 0);
 
@@ -1271,9 +1431,9 @@ Gate_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, Gate_compute_next_data_frame);
     self->mode_func_ptr = Gate_setProcMode;
 
-    static char *kwlist[] = {"input", "thresh", "risetime", "falltime", "lookahead", "outputAmp", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "thresh", "risetime", "falltime", "lookahead", "outputAmp", "sidechain", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOiOO", kwlist, &inputtmp, &threshtmp, &risetimetmp, &falltimetmp, &looktmp, &self->outputAmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOiOOO", kwlist, &inputtmp, &threshtmp, &risetimetmp, &falltimetmp, &looktmp, &self->outputAmp, &sidechaintmp, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -1298,6 +1458,10 @@ Gate_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setAdd", "O", addtmp);
     }
 
+    if (sidechaintmp) {
+        PyObject_CallMethod((PyObject *)self, "setSidechain", "O", sidechaintmp);
+    }
+
     PyObject_CallMethod((PyObject *)self, "setLookAhead", "O", looktmp);
 
     self->lh_size = (long)(0.025 * self->sr + 0.5);
@@ -1305,6 +1469,7 @@ Gate_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->lh_size+1); i++) {
         self->lh_buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (self->lh_size + 1) * sizeof(MYFLT));
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
@@ -1435,6 +1600,9 @@ Gate_setFallTime(Gate *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Gate_setSidechain(Gate *self, PyObject *arg) { SET_SIDECHAIN };
+
 static PyObject *
 Gate_setLookAhead(Gate *self, PyObject *arg)
 {
@@ -1479,6 +1647,7 @@ static PyMethodDef Gate_methods[] = {
     {"setRiseTime", (PyCFunction)Gate_setRiseTime, METH_O, "Sets filter risetime in second."},
     {"setFallTime", (PyCFunction)Gate_setFallTime, METH_O, "Sets filter falltime in second."},
     {"setLookAhead", (PyCFunction)Gate_setLookAhead, METH_O, "Sets look ahead time in ms."},
+    {"setSidechain", (PyCFunction)Gate_setSidechain, METH_O, "Sets the signal followed by the gate, None for the input."},
     {"setMul", (PyCFunction)Gate_setMul, METH_O, "Sets oscillator mul factor."},
     {"setAdd", (PyCFunction)Gate_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Gate_setSub, METH_O, "Sets inverse add factor."},
@@ -25,6 +25,75 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "packed.h"
+
+/* Delay, SDelay and SmoothDelay keep their samples in a ring whose length is
+ * a power of two, so that positions wrap with `& mask`. The ring holds at
+ * least `size` samples of history besides the one being written. */
+static long
+DelayRing_length(long size)
+{
+    long length = 1;
+
+    while (length < size + 1)
+        length <<= 1;
+    return length;
+}
+
+/* Copies `num` samples of the ring, from position `start`, to `out`. */
+static void
+DelayRing_get(MYFLT *ring, long mask, long start, MYFLT *out, int num)
+{
+    long first = start & mask;
+    long len = mask + 1 - first;
+
+    if (len >= num)
+        memcpy(out, ring + first, num * sizeof(MYFLT));
+    else {
+        memcpy(out, ring + first, len * sizeof(MYFLT));
+        memcpy(out + len, ring, (num - len) * sizeof(MYFLT));
+    }
+}
+
+/* Writes `num` samples of `in` in the ring, from position `start`, plus the
+ * `out` samples scaled by the feedback. The feedback is `fdb`, clipped
+ * between 0 and 1, or `feed` when `fdb` is NULL. Without `out`, or a null
+ * constant feedback, the input is copied as is. */
+static void
+DelayRing_put(MYFLT *ring, long mask, long start, MYFLT *in, MYFLT *out, MYFLT feed, MYFLT *fdb, int num)
+{
+    int i, j, n;
+    long first;
+    MYFLT fb;
+
+    if (out == NULL || (fdb == NULL && feed == 0.0)) {
+        first = start & mask;
+        n = mask + 1 - first < num ? (int)(mask + 1 - first) : num;
+        memcpy(ring + first, in, n * sizeof(MYFLT));
+        memcpy(ring, in + n, (num - n) * sizeof(MYFLT));
+        return;
+    }
+
+    for (i=0; i<num; i+=n) {
+        first = (start + i) & mask;
+        n = mask + 1 - first < num - i ? (int)(mask + 1 - first) : num - i;
+        if (fdb == NULL) {
+            for (j=0; j<n; j++) {
+                ring[first+j] = in[i+j] + out[i+j] * feed;
+            }
+        }
+        else {
+            for (j=0; j<n; j++) {
+                fb = fdb[i+j];
+                if (fb < 0)
+                    fb = 0;
+                else if (fb > 1)
+                    fb = 1;
+                ring[first+j] = in[i+j] + out[i+j] * fb;
+            }
+        }
+    }
+}
 
 typedef struct {
     pyo_audio_HEAD
@@ -37,16 +106,46 @@ typedef struct {
     MYFLT maxdelay;
     MYFLT oneOverSr;
     long size;
+    long mask; /* ring length - 1 */
     long in_count;
     int modebuffer[4];
     MYFLT *buffer; // samples memory
 } Delay;
 
+/* Reads the ring `sampdel` samples, at least 1, behind the write position. */
+static MYFLT
+Delay_read(Delay *self, MYFLT sampdel)
+{
+    long ind, isamp = (long)sampdel;
+    MYFLT frac;
+
+    if (isamp < sampdel)
+        isamp++;
+    frac = isamp - sampdel;
+    ind = self->in_count - isamp;
+    return self->buffer[ind & self->mask] * (1.0 - frac) + self->buffer[(ind+1) & self->mask] * frac;
+}
+
+/* A constant delay of a whole number of samples is read and written without
+ * interpolation, by blocks of at most `sampdel` samples since a shorter delay
+ * reads what the same block writes. */
+static void
+Delay_processBlock(Delay *self, MYFLT *in, MYFLT feed, MYFLT *fdb, long sampdel)
+{
+    int i, n;
+
+    for (i=0; i<self->bufsize; i+=n) {
+        n = self->bufsize - i < sampdel ? self->bufsize - i : (int)sampdel;
+        DelayRing_get(self->buffer, self->mask, self->in_count - sampdel, self->data + i, n);
+        DelayRing_put(self->buffer, self->mask, self->in_count, in + i, self->data + i, feed, fdb == NULL ? NULL : fdb + i, n);
+        self->in_count = (self->in_count + n) & self->mask;
+    }
+}
+
 static void
 Delay_process_ii(Delay *self) {
-    MYFLT val, xind, frac;
+    MYFLT val;
     int i;
-    long ind;
 
     MYFLT del = PyFloat_AS_DOUBLE(self->delay);
     MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
@@ -64,29 +163,24 @@ Delay_process_ii(Delay *self) {
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
+    if (sampdel == (long)sampdel) {
+        Delay_processBlock(self, in, feed, NULL, (long)sampdel);
+        return;
+    }
+
     for (i=0; i<self->bufsize; i++) {
-        xind = self->in_count - sampdel;
-        if (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] * (1.0 - frac) + self->buffer[ind+1] * frac;
+        val = Delay_read(self, sampdel);
         self->data[i] = val;
 
         self->buffer[self->in_count] = in[i] + (val * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[self->in_count];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
     }
 }
 
 static void
 Delay_process_ai(Delay *self) {
-    MYFLT val, xind, frac, sampdel, del;
+    MYFLT val, sampdel, del;
     int i;
-    long ind;
 
     MYFLT *delobj = Stream_getData((Stream *)self->delay_stream);
     MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
@@ -105,28 +199,18 @@ Delay_process_ai(Delay *self) {
         else if (del > self->maxdelay)
             del = self->maxdelay;
         sampdel = del * self->sr;
-        xind = self->in_count - sampdel;
-        if (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] * (1.0 - frac) + self->buffer[ind+1] * frac;
+        val = Delay_read(self, sampdel);
         self->data[i] = val;
 
         self->buffer[self->in_count] = in[i]  + (val * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[self->in_count];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
     }
 }
 
 static void
 Delay_process_ia(Delay *self) {
-    MYFLT val, xind, frac, feed;
+    MYFLT val, feed;
     int i;
-    long ind;
 
     MYFLT del = PyFloat_AS_DOUBLE(self->delay);
     MYFLT *fdb = Stream_getData((Stream *)self->feedback_stream);
@@ -139,13 +223,13 @@ Delay_process_ia(Delay *self) {
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
+    if (sampdel == (long)sampdel) {
+        Delay_processBlock(self, in, 0.0, fdb, (long)sampdel);
+        return;
+    }
+
     for (i=0; i<self->bufsize; i++) {
-        xind = self->in_count - sampdel;
-        if (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] * (1.0 - frac) + self->buffer[ind+1] * frac;
+        val = Delay_read(self, sampdel);
         self->data[i] = val;
 
         feed = fdb[i];
@@ -155,19 +239,14 @@ Delay_process_ia(Delay *self) {
             feed = 1;
 
         self->buffer[self->in_count] = in[i] + (val * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[self->in_count];
-        self->in_count++;
-        if (self->in_count == self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
     }
 }
 
 static void
 Delay_process_aa(Delay *self) {
-    MYFLT val, xind, frac, sampdel, feed, del;
+    MYFLT val, sampdel, feed, del;
     int i;
-    long ind;
 
     MYFLT *delobj = Stream_getData((Stream *)self->delay_stream);
     MYFLT *fdb = Stream_getData((Stream *)self->feedback_stream);
@@ -181,12 +260,7 @@ Delay_process_aa(Delay *self) {
         else if (del > self->maxdelay)
             del = self->maxdelay;
         sampdel = del * self->sr;
-        xind = self->in_count - sampdel;
-        if (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] * (1.0 - frac) + self->buffer[ind+1] * frac;
+        val = Delay_read(self, sampdel);
         self->data[i] = val;
 
         feed = fdb[i];
@@ -196,11 +270,7 @@ Delay_process_aa(Delay *self) {
             feed = 1;
 
         self->buffer[self->in_count] = in[i] + (val * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[self->in_count];
-        self->in_count++;
-        if (self->in_count == self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
     }
 }
 
@@ -358,11 +428,15 @@ Delay_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
     self->size = (long)(self->maxdelay * self->sr + 0.5);
+    self->mask = DelayRing_length(self->size) - 1;
 
-    self->buffer = (MYFLT *)realloc(self->buffer, (self->size+1) * sizeof(MYFLT));
-    for (i=0; i<(self->size+1); i++) {
+    self->buffer = (MYFLT *)realloc(self->buffer, (self->mask+1) * sizeof(MYFLT));
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (self->mask+1) * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, self->size);
 
     (*self->mode_func_ptr)(self);
 
@@ -461,7 +535,7 @@ static PyObject *
 Delay_reset(Delay *self)
 {
     int i;
-    for (i=0; i<(self->size+1); i++) {
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
 	Py_INCREF(Py_None);
@@ -579,6 +653,302 @@ PyTypeObject DelayType = {
     Delay_new,                 /* tp_new */
 };
 
+/******************************************/
+/* MultiDelayMain, read by PackedChannel  */
+/******************************************/
+/* MultiDelayMain delays all the channels of a Delay in one object, in a
+ * packed stream. The delay lines share one ring, a frame per sample, read
+ * and written with vectors when all the channels have the same constant
+ * delay time. */
+typedef struct {
+    pyo_audio_HEAD
+    int chnls;
+    PyObject *input; /* list of streams, one per channel */
+    PyObject *delay; /* list of streams or None, one per channel */
+    PyObject *feedback;
+    Stream **input_streams; /* borrowed from the lists, NULL for a float */
+    Stream **delay_streams;
+    Stream **feedback_streams;
+    MYFLT *delays; /* delay times in samples */
+    MYFLT *feedbacks;
+    MYFLT maxdelay;
+    MYFLT oneOverSr;
+    PackedDelay *ring;
+    MYFLT *scratch; /* audio rate delays and feedbacks, bufsize per channel */
+    MYFLT **ins;
+    MYFLT **outs;
+    MYFLT **dels;
+    MYFLT **feeds;
+} MultiDelayMain;
+
+static void
+MultiDelayMain_compute_next_data_frame(MultiDelayMain *self)
+{
+    int i, j;
+    MYFLT del, feed, *st;
+
+    for (j=0; j<self->chnls; j++) {
+        self->ins[j] = Stream_getData(self->input_streams[j]);
+        self->outs[j] = self->data + j * self->bufsize;
+        self->dels[j] = self->feeds[j] = NULL;
+        if (self->delay_streams[j] != NULL) {
+            st = Stream_getData(self->delay_streams[j]);
+            self->dels[j] = self->scratch + 2 * j * self->bufsize;
+            for (i=0; i<self->bufsize; i++) {
+                del = st[i];
+                if (del < self->oneOverSr)
+                    del = self->oneOverSr;
+                else if (del > self->maxdelay)
+                    del = self->maxdelay;
+                self->dels[j][i] = del * self->sr;
+            }
+        }
+        if (self->feedback_streams[j] != NULL) {
+            st = Stream_getData(self->feedback_streams[j]);
+            self->feeds[j] = self->scratch + (2 * j + 1) * self->bufsize;
+            for (i=0; i<self->bufsize; i++) {
+                feed = st[i];
+                if (feed < 0)
+                    feed = 0;
+                else if (feed > 1)
+                    feed = 1;
+                self->feeds[j][i] = feed;
+            }
+        }
+    }
+
+    PackedDelay_process(self->ring, self->ins, self->outs, self->dels, self->delays,
+                        self->feeds, self->feedbacks, self->bufsize);
+}
+
+static void
+MultiDelayMain_setProcMode(MultiDelayMain *self) {}
+
+static int
+MultiDelayMain_traverse(MultiDelayMain *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->input);
+    Py_VISIT(self->delay);
+    Py_VISIT(self->feedback);
+    return 0;
+}
+
+static int
+MultiDelayMain_clear(MultiDelayMain *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->input);
+    Py_CLEAR(self->delay);
+    Py_CLEAR(self->feedback);
+    return 0;
+}
+
+static void
+MultiDelayMain_dealloc(MultiDelayMain* self)
+{
+    pyo_DEALLOC
+    free(self->input_streams);
+    free(self->delay_streams);
+    free(self->feedback_streams);
+    free(self->delays);
+    free(self->feedbacks);
+    free(self->scratch);
+    free(self->ins);
+    free(self->outs);
+    free(self->dels);
+    free(self->feeds);
+    PackedDelay_free(self->ring);
+    MultiDelayMain_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+MultiDelayMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i;
+    PyObject *inputtmp=NULL, *delaytmp=NULL, *feedbacktmp=NULL, *res;
+    MultiDelayMain *self;
+    self = (MultiDelayMain *)type->tp_alloc(type, 0);
+
+    self->chnls = 1;
+    self->maxdelay = 1;
+
+    INIT_OBJECT_COMMON
+
+    self->oneOverSr = 1.0 / self->sr;
+
+    Stream_setFunctionPtr(self->stream, MultiDelayMain_compute_next_data_frame);
+    self->mode_func_ptr = MultiDelayMain_setProcMode;
+
+    static char *kwlist[] = {"chnls", "input", "delay", "feedback", "maxdelay", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_IOOO_F, kwlist, &self->chnls, &inputtmp, &delaytmp, &feedbacktmp, &self->maxdelay))
+        Py_RETURN_NONE;
+
+    if (self->chnls < 1)
+        self->chnls = 1;
+
+    self->input_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->delay_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->feedback_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->delays = (MYFLT *)calloc(self->chnls, sizeof(MYFLT));
+    self->feedbacks = (MYFLT *)calloc(self->chnls, sizeof(MYFLT));
+    self->scratch = (MYFLT *)calloc(2 * self->chnls * self->bufsize, sizeof(MYFLT));
+    self->ins = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->outs = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->dels = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->feeds = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->ring = PackedDelay_new(self->chnls, (long)(self->maxdelay * self->sr + 0.5));
+    INIT_PACKED_STREAM(self->chnls)
+    Stream_setMemory(self->stream, ((self->ring->mask + 1) * self->ring->pchnls + 2 * self->chnls * self->bufsize) * sizeof(MYFLT));
+
+    if (Packed_setValues(inputtmp, self->chnls, &self->input, NULL, self->input_streams) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    res = PyObject_CallMethod((PyObject *)self, "setDelay", "O", delaytmp);
+    Py_XDECREF(res);
+    if (res != NULL) {
+        res = PyObject_CallMethod((PyObject *)self, "setFeedback", "O", feedbacktmp);
+        Py_XDECREF(res);
+    }
+    if (res == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    return (PyObject *)self;
+}
+
+static PyObject * MultiDelayMain_getServer(MultiDelayMain* self) { GET_SERVER };
+static PyObject * MultiDelayMain_getStream(MultiDelayMain* self) { GET_STREAM };
+
+static PyObject * MultiDelayMain_play(MultiDelayMain *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * MultiDelayMain_stop(MultiDelayMain *self) { STOP_PACKED(self->chnls) };
+
+static PyObject *
+MultiDelayMain_setInput(MultiDelayMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->chnls, &self->input, NULL, self->input_streams) < 0)
+        return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+MultiDelayMain_setDelay(MultiDelayMain *self, PyObject *arg)
+{
+    int j;
+    MYFLT del;
+
+    if (Packed_setValues(arg, self->chnls, &self->delay, self->delays, self->delay_streams) < 0)
+        return NULL;
+
+    for (j=0; j<self->chnls; j++) {
+        del = self->delays[j];
+        if (del < self->oneOverSr)
+            del = self->oneOverSr;
+        else if (del > self->maxdelay)
+            del = self->maxdelay;
+        self->delays[j] = del * self->sr;
+    }
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+MultiDelayMain_setFeedback(MultiDelayMain *self, PyObject *arg)
+{
+    int j;
+
+    if (Packed_setValues(arg, self->chnls, &self->feedback, self->feedbacks, self->feedback_streams) < 0)
+        return NULL;
+
+    for (j=0; j<self->chnls; j++) {
+        if (self->feedbacks[j] < 0)
+            self->feedbacks[j] = 0;
+        else if (self->feedbacks[j] > 1)
+            self->feedbacks[j] = 1;
+    }
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+MultiDelayMain_reset(MultiDelayMain *self)
+{
+    PackedDelay_reset(self->ring);
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyMemberDef MultiDelayMain_members[] = {
+{"server", T_OBJECT_EX, offsetof(MultiDelayMain, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(MultiDelayMain, stream), 0, "Stream object."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef MultiDelayMain_methods[] = {
+{"getServer", (PyCFunction)MultiDelayMain_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)MultiDelayMain_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)MultiDelayMain_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)MultiDelayMain_stop, METH_NOARGS, "Stops computing."},
+{"setInput", (PyCFunction)MultiDelayMain_setInput, METH_O, "Sets the inputs of the channels, a list of PyoObjects."},
+{"setDelay", (PyCFunction)MultiDelayMain_setDelay, METH_O, "Sets the delay times of the channels, a list of floats or PyoObjects."},
+{"setFeedback", (PyCFunction)MultiDelayMain_setFeedback, METH_O, "Sets the feedbacks of the channels, a list of floats or PyoObjects."},
+{"reset", (PyCFunction)MultiDelayMain_reset, METH_NOARGS, "Resets the memory buffer to zeros."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject MultiDelayMainType = {
+PyObject_HEAD_INIT(NULL)
+0,                         /*ob_size*/
+"_pyo.MultiDelayMain_base",         /*tp_name*/
+sizeof(MultiDelayMain),         /*tp_basicsize*/
+0,                         /*tp_itemsize*/
+(destructor)MultiDelayMain_dealloc, /*tp_dealloc*/
+0,                         /*tp_print*/
+0,                         /*tp_getattr*/
+0,                         /*tp_setattr*/
+0,                         /*tp_compare*/
+0,                         /*tp_repr*/
+0,             /*tp_as_number*/
+0,                         /*tp_as_sequence*/
+0,                         /*tp_as_mapping*/
+0,                         /*tp_hash */
+0,                         /*tp_call*/
+0,                         /*tp_str*/
+0,                         /*tp_getattro*/
+0,                         /*tp_setattro*/
+0,                         /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+"MultiDelayMain objects. Delays the channels of a Delay.",           /* tp_doc */
+(traverseproc)MultiDelayMain_traverse,   /* tp_traverse */
+(inquiry)MultiDelayMain_clear,           /* tp_clear */
+0,		               /* tp_richcompare */
+0,		               /* tp_weaklistoffset */
+0,		               /* tp_iter */
+0,		               /* tp_iternext */
+MultiDelayMain_methods,             /* tp_methods */
+MultiDelayMain_members,             /* tp_members */
+0,                      /* tp_getset */
+0,                         /* tp_base */
+0,                         /* tp_dict */
+0,                         /* tp_descr_get */
+0,                         /* tp_descr_set */
+0,                         /* tp_dictoffset */
+0,      /* tp_init */
+0,                         /* tp_alloc */
+MultiDelayMain_new,                 /* tp_new */
+};
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *input;
@@ -587,6 +957,7 @@ typedef struct {
     Stream *delay_stream;
     MYFLT maxdelay;
     long size;
+    long mask; /* ring length - 1 */
     long in_count;
     int modebuffer[3];
     MYFLT *buffer; // samples memory
@@ -594,8 +965,7 @@ typedef struct {
 
 static void
 SDelay_process_i(SDelay *self) {
-    int i;
-    long ind;
+    int i, n;
 
     MYFLT del = PyFloat_AS_DOUBLE(self->delay);
 
@@ -608,24 +978,16 @@ SDelay_process_i(SDelay *self) {
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     if (sampdel == 0) {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->buffer[self->in_count] = in[i];
-            self->in_count++;
-            if (self->in_count >= self->size)
-                self->in_count = 0;
-        }
+        memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+        DelayRing_put(self->buffer, self->mask, self->in_count, in, NULL, 0.0, NULL, self->bufsize);
+        self->in_count = (self->in_count + self->bufsize) & self->mask;
     }
     else {
-        for (i=0; i<self->bufsize; i++) {
-            ind = self->in_count - sampdel;
-            if (ind < 0)
-                ind += self->size;
-            self->data[i] = self->buffer[ind];
-
-            self->buffer[self->in_count] = in[i];
-            self->in_count++;
-            if (self->in_count >= self->size)
-                self->in_count = 0;
+        for (i=0; i<self->bufsize; i+=n) {
+            n = self->bufsize - i < sampdel ? self->bufsize - i : (int)sampdel;
+            DelayRing_get(self->buffer, self->mask, self->in_count - sampdel, self->data + i, n);
+            DelayRing_put(self->buffer, self->mask, self->in_count, in + i, NULL, 0.0, NULL, n);
+            self->in_count = (self->in_count + n) & self->mask;
         }
     }
 }
@@ -634,7 +996,7 @@ static void
 SDelay_process_a(SDelay *self) {
     MYFLT del;
     int i;
-    long ind, sampdel;
+    long sampdel;
 
     MYFLT *delobj = Stream_getData((Stream *)self->delay_stream);
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
@@ -646,18 +1008,12 @@ SDelay_process_a(SDelay *self) {
         else if (del > self->maxdelay)
             del = self->maxdelay;
         sampdel = (long)(del * self->sr);
-        if (sampdel == 0) {
-            self->data[i] = self->buffer[self->in_count] = in[i];
-        }
-        else {
-            ind = self->in_count - sampdel;
-            if (ind < 0)
-                ind += self->size;
-            self->data[i] = self->buffer[ind];
-        }
-        self->buffer[self->in_count++] = in[i];
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        if (sampdel == 0)
+            self->data[i] = in[i];
+        else
+            self->data[i] = self->buffer[(self->in_count - sampdel) & self->mask];
+        self->buffer[self->in_count] = in[i];
+        self->in_count = (self->in_count + 1) & self->mask;
     }
 }
 
@@ -796,11 +1152,15 @@ SDelay_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
     self->size = (long)(self->maxdelay * self->sr + 0.5);
+    self->mask = DelayRing_length(self->size) - 1;
 
-    self->buffer = (MYFLT *)realloc(self->buffer, (self->size+1) * sizeof(MYFLT));
-    for (i=0; i<(self->size+1); i++) {
+    self->buffer = (MYFLT *)realloc(self->buffer, (self->mask+1) * sizeof(MYFLT));
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (self->mask+1) * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, self->size);
 
     (*self->mode_func_ptr)(self);
 
@@ -865,7 +1225,7 @@ static PyObject *
 SDelay_reset(SDelay *self)
 {
     int i;
-    for (i=0; i<(self->size+1); i++) {
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
 	Py_INCREF(Py_None);
@@ -1507,6 +1867,9 @@ Waveguide_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->size+1); i++) {
         self->buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (self->size+1) * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, self->size);
 
     (*self->mode_func_ptr)(self);
 
@@ -2528,6 +2891,9 @@ AllpassWG_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
             self->alpbuffer[i][j] = 0.;
         }
     }
+    Stream_setMemory(self->stream, (self->size+1 + 3*(self->alpsize+1)) * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, self->size + self->alpsize);
 
     (*self->mode_func_ptr)(self);
 
@@ -3054,6 +3420,7 @@ typedef struct {
     int current;
     long timer;
     long size;
+    long mask; /* ring length - 1 */
     long in_count;
     long sampdel;
     MYFLT sampdel1;
@@ -3062,11 +3429,81 @@ typedef struct {
     MYFLT *buffer; // samples memory
 } SmoothDelay;
 
+#define SMOOTHDELAY_BLOCK 64
+#define SMOOTHDELAY_WHOLE_TAPS(self) \
+    ((self)->sampdel1 == (long)(self)->sampdel1 && (self)->sampdel2 == (long)(self)->sampdel2)
+
+/* Reads the ring `sampdel` samples behind the write position. */
+static MYFLT
+SmoothDelay_read(SmoothDelay *self, MYFLT sampdel)
+{
+    long ind, isamp = (long)sampdel;
+    MYFLT frac, x;
+
+    if (isamp < sampdel)
+        isamp++;
+    frac = isamp - sampdel;
+    ind = self->in_count - isamp;
+    x = self->buffer[ind & self->mask];
+    return x + (self->buffer[(ind+1) & self->mask] - x) * frac;
+}
+
+/* When both taps are whole numbers of samples (SMOOTHDELAY_WHOLE_TAPS), the
+ * ring is read and written by blocks up to the next crossfade. Once a
+ * crossfade is over, only the sounding tap is read. Feedbacks are as in
+ * DelayRing_put. Returns the number of samples computed from `start`. */
+static int
+SmoothDelay_processBlock(SmoothDelay *self, MYFLT *in, MYFLT feed, MYFLT *fdb, int start)
+{
+    int i, j, n, num;
+    long del1 = (long)self->sampdel1, del2 = (long)self->sampdel2;
+    MYFLT sum, *out, tap[SMOOTHDELAY_BLOCK];
+
+    num = self->sampdel - self->timer;
+    if (num > self->bufsize - start)
+        num = self->bufsize - start;
+
+    for (i=0; i<num; i+=n) {
+        n = num - i < SMOOTHDELAY_BLOCK ? num - i : SMOOTHDELAY_BLOCK;
+        if (n > del1)
+            n = (int)del1;
+        if (n > del2)
+            n = (int)del2;
+        out = self->data + start + i;
+        if (self->amp1 == 1.0 && self->inc1 > 0.0 && self->amp2 == 0.0 && self->inc2 < 0.0)
+            DelayRing_get(self->buffer, self->mask, self->in_count - del1, out, n);
+        else if (self->amp2 == 1.0 && self->inc2 > 0.0 && self->amp1 == 0.0 && self->inc1 < 0.0)
+            DelayRing_get(self->buffer, self->mask, self->in_count - del2, out, n);
+        else {
+            DelayRing_get(self->buffer, self->mask, self->in_count - del1, out, n);
+            DelayRing_get(self->buffer, self->mask, self->in_count - del2, tap, n);
+            for (j=0; j<n; j++) {
+                sum = out[j] * self->amp1;
+                self->amp1 += self->inc1;
+                if (self->amp1 < 0) self->amp1 = 0.0;
+                else if (self->amp1 > 1) self->amp1 = 1.0;
+                sum += tap[j] * self->amp2;
+                self->amp2 += self->inc2;
+                if (self->amp2 < 0) self->amp2 = 0.0;
+                else if (self->amp2 > 1) self->amp2 = 1.0;
+                out[j] = sum;
+            }
+        }
+        DelayRing_put(self->buffer, self->mask, self->in_count, in + start + i, out, feed, fdb == NULL ? NULL : fdb + start + i, n);
+        self->in_count = (self->in_count + n) & self->mask;
+    }
+
+    self->timer += num;
+    if (self->timer == self->sampdel)
+        self->timer = 0;
+    return num;
+}
+
 static void
 SmoothDelay_process_ii(SmoothDelay *self) {
-    MYFLT val, xind, frac, sum;
+    MYFLT val, sum;
     int i;
-    long ind, xsamps = 0;
+    long xsamps = 0;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT del = PyFloat_AS_DOUBLE(self->delay);
@@ -3079,6 +3516,11 @@ SmoothDelay_process_ii(SmoothDelay *self) {
     else if (feed > 1) feed = 1.0;
 
     for (i=0; i<self->bufsize; i++) {
+        if (self->timer != 0 && SMOOTHDELAY_WHOLE_TAPS(self)) {
+            i += SmoothDelay_processBlock(self, in, feed, NULL, i);
+            if (i == self->bufsize)
+                break;
+        }
         if (self->timer == 0) {
             self->current = (self->current + 1) % 2;
             self->sampdel = (long)(del * self->sr + 0.5);
@@ -3097,23 +3539,13 @@ SmoothDelay_process_ii(SmoothDelay *self) {
             }
         }
 
-        xind = self->in_count - self->sampdel1;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel1);
         sum = val * self->amp1;
         self->amp1 += self->inc1;
         if (self->amp1 < 0) self->amp1 = 0.0;
         else if (self->amp1 > 1) self->amp1 = 1.0;
 
-        xind = self->in_count - self->sampdel2;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel2);
         sum += val * self->amp2;
         self->amp2 += self->inc2;
         if (self->amp2 < 0) self->amp2 = 0.0;
@@ -3122,11 +3554,7 @@ SmoothDelay_process_ii(SmoothDelay *self) {
         self->data[i] = sum;
 
         self->buffer[self->in_count] = in[i] + (sum * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
 
         self->timer++;
         if (self->timer == self->sampdel)
@@ -3136,9 +3564,9 @@ SmoothDelay_process_ii(SmoothDelay *self) {
 
 static void
 SmoothDelay_process_ai(SmoothDelay *self) {
-    MYFLT val, xind, frac, sum, del;
+    MYFLT val, sum, del;
     int i;
-    long ind, xsamps = 0;
+    long xsamps = 0;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *dl = Stream_getData((Stream *)self->delay_stream);
@@ -3148,6 +3576,11 @@ SmoothDelay_process_ai(SmoothDelay *self) {
     else if (feed > 1) feed = 1.0;
 
     for (i=0; i<self->bufsize; i++) {
+        if (self->timer != 0 && SMOOTHDELAY_WHOLE_TAPS(self)) {
+            i += SmoothDelay_processBlock(self, in, feed, NULL, i);
+            if (i == self->bufsize)
+                break;
+        }
         if (self->timer == 0) {
             del = dl[i];
             if (del < self->oneOverSr) del = self->oneOverSr;
@@ -3169,23 +3602,13 @@ SmoothDelay_process_ai(SmoothDelay *self) {
             }
         }
 
-        xind = self->in_count - self->sampdel1;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel1);
         sum = val * self->amp1;
         self->amp1 += self->inc1;
         if (self->amp1 < 0) self->amp1 = 0.0;
         else if (self->amp1 > 1) self->amp1 = 1.0;
 
-        xind = self->in_count - self->sampdel2;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel2);
         sum += val * self->amp2;
         self->amp2 += self->inc2;
         if (self->amp2 < 0) self->amp2 = 0.0;
@@ -3194,11 +3617,7 @@ SmoothDelay_process_ai(SmoothDelay *self) {
         self->data[i] = sum;
 
         self->buffer[self->in_count] = in[i] + (sum * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
 
         self->timer++;
         if (self->timer == self->sampdel)
@@ -3208,9 +3627,9 @@ SmoothDelay_process_ai(SmoothDelay *self) {
 
 static void
 SmoothDelay_process_ia(SmoothDelay *self) {
-    MYFLT val, xind, frac, sum, feed;
+    MYFLT val, sum, feed;
     int i;
-    long ind, xsamps = 0;
+    long xsamps = 0;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT del = PyFloat_AS_DOUBLE(self->delay);
@@ -3220,6 +3639,11 @@ SmoothDelay_process_ia(SmoothDelay *self) {
     else if (del > self->maxdelay) del = self->maxdelay;
 
     for (i=0; i<self->bufsize; i++) {
+        if (self->timer != 0 && SMOOTHDELAY_WHOLE_TAPS(self)) {
+            i += SmoothDelay_processBlock(self, in, 0.0, fd, i);
+            if (i == self->bufsize)
+                break;
+        }
         feed = fd[i];
         if (feed < 0) feed = 0.0;
         else if (feed > 1) feed = 1.0;
@@ -3241,23 +3665,13 @@ SmoothDelay_process_ia(SmoothDelay *self) {
             }
         }
 
-        xind = self->in_count - self->sampdel1;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel1);
         sum = val * self->amp1;
         self->amp1 += self->inc1;
         if (self->amp1 < 0) self->amp1 = 0.0;
         else if (self->amp1 > 1) self->amp1 = 1.0;
 
-        xind = self->in_count - self->sampdel2;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel2);
         sum += val * self->amp2;
         self->amp2 += self->inc2;
         if (self->amp2 < 0) self->amp2 = 0.0;
@@ -3266,11 +3680,7 @@ SmoothDelay_process_ia(SmoothDelay *self) {
         self->data[i] = sum;
 
         self->buffer[self->in_count] = in[i] + (sum * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
 
         self->timer++;
         if (self->timer == self->sampdel)
@@ -3280,15 +3690,20 @@ SmoothDelay_process_ia(SmoothDelay *self) {
 
 static void
 SmoothDelay_process_aa(SmoothDelay *self) {
-    MYFLT val, xind, frac, sum, del, feed;
+    MYFLT val, sum, del, feed;
     int i;
-    long ind, xsamps = 0;
+    long xsamps = 0;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *dl = Stream_getData((Stream *)self->delay_stream);
     MYFLT *fd = Stream_getData((Stream *)self->feedback_stream);
 
     for (i=0; i<self->bufsize; i++) {
+        if (self->timer != 0 && SMOOTHDELAY_WHOLE_TAPS(self)) {
+            i += SmoothDelay_processBlock(self, in, 0.0, fd, i);
+            if (i == self->bufsize)
+                break;
+        }
         feed = fd[i];
         if (feed < 0) feed = 0.0;
         else if (feed > 1) feed = 1.0;
@@ -3313,23 +3728,13 @@ SmoothDelay_process_aa(SmoothDelay *self) {
             }
         }
 
-        xind = self->in_count - self->sampdel1;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel1);
         sum = val * self->amp1;
         self->amp1 += self->inc1;
         if (self->amp1 < 0) self->amp1 = 0.0;
         else if (self->amp1 > 1) self->amp1 = 1.0;
 
-        xind = self->in_count - self->sampdel2;
-        while (xind < 0)
-            xind += self->size;
-        ind = (long)xind;
-        frac = xind - ind;
-        val = self->buffer[ind] + (self->buffer[ind+1] - self->buffer[ind]) * frac;
+        val = SmoothDelay_read(self, self->sampdel2);
         sum += val * self->amp2;
         self->amp2 += self->inc2;
         if (self->amp2 < 0) self->amp2 = 0.0;
@@ -3338,11 +3743,7 @@ SmoothDelay_process_aa(SmoothDelay *self) {
         self->data[i] = sum;
 
         self->buffer[self->in_count] = in[i] + (sum * feed);
-        if (self->in_count == 0)
-            self->buffer[self->size] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->size)
-            self->in_count = 0;
+        self->in_count = (self->in_count + 1) & self->mask;
 
         self->timer++;
         if (self->timer == self->sampdel)
@@ -3510,11 +3911,15 @@ SmoothDelay_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
     self->size = (long)(self->maxdelay * self->sr + 0.5);
+    self->mask = DelayRing_length(self->size) - 1;
 
-    self->buffer = (MYFLT *)realloc(self->buffer, (self->size+1) * sizeof(MYFLT));
-    for (i=0; i<(self->size+1); i++) {
+    self->buffer = (MYFLT *)realloc(self->buffer, (self->mask+1) * sizeof(MYFLT));
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (self->mask+1) * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, self->size);
 
     (*self->mode_func_ptr)(self);
 
@@ -3630,7 +4035,7 @@ static PyObject *
 SmoothDelay_reset(SmoothDelay *self)
 {
     int i;
-    for (i=0; i<(self->size+1); i++) {
+    for (i=0; i<(self->mask+1); i++) {
         self->buffer[i] = 0.;
     }
 	Py_INCREF(Py_None);
@@ -21,10 +21,28 @@
 #include <Python.h>
 #include "structmember.h"
 #include <math.h>
+#include <string.h>
 #include "pyomodule.h"
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "oversampler.h"
+#include "simd.h"
+
+/* Replaces the oversampler of a distortion object, the filter memories of
+   the new one start from zero. */
+#define SET_OVERSAMPLE \
+    if (arg == NULL || ! PyNumber_Check(arg)) { \
+        Py_INCREF(Py_None); \
+        return Py_None; \
+    } \
+    Oversampler_free(self->os); \
+    self->oversample = Oversampler_getFactor(PyInt_AsLong(arg)); \
+    self->os = Oversampler_new(self->oversample, self->bufsize); \
+    Stream_setMemory(self->stream, Oversampler_getMemory(self->os)); \
+    (*self->mode_func_ptr)(self); \
+    Py_INCREF(Py_None); \
+    return Py_None;
 
 typedef struct {
     pyo_audio_HEAD
@@ -37,6 +55,8 @@ typedef struct {
     int init;
     int modebuffer[4];
     MYFLT y1; // sample memory
+    int oversample;
+    Oversampler *os;
 } Disto;
 
 static MYFLT
@@ -50,19 +70,80 @@ _clip(MYFLT x)
         return x;
 }
 
+/* Arc tangents of Disto, vectorized, within 4e-6 radians. The argument
+   is reduced to u = x / (1 + sqrt(1 + x * x)) in ]-1, 1[, atan(x) being
+   2 * atan(u), and an odd polynomial gives 2 * atan(u). |x| is limited to
+   1e15, its square must not overflow. */
+#define DISTO_ATAN_MAX 1e15
+
+static inline MYFLT
+_fast_atan(MYFLT x)
+{
+    MYFLT u, u2;
+    x = x < -DISTO_ATAN_MAX ? -DISTO_ATAN_MAX : x > DISTO_ATAN_MAX ? DISTO_ATAN_MAX : x;
+    u = x / (1 + MYSQRT(1 + x * x));
+    u2 = u * u;
+    return u * ((MYFLT)1.99995452 + u2 * ((MYFLT)-0.66524694 + u2 * ((MYFLT)0.38708692 +
+           u2 * ((MYFLT)-0.23286574 + u2 * ((MYFLT)0.10530664 + u2 * (MYFLT)-0.02344240)))));
+}
+
+#ifdef VSIZE
+static inline VTYPE
+_fast_atan_v(VTYPE x)
+{
+    VTYPE u, u2, one = VSET1(1.0);
+    x = VMIN(VMAX(x, VSET1(-DISTO_ATAN_MAX)), VSET1(DISTO_ATAN_MAX));
+    u = VDIV(x, VADD(one, VSQRT(VADD(one, VMUL(x, x)))));
+    u2 = VMUL(u, u);
+    return VMUL(u, VADD(VSET1(1.99995452), VMUL(u2, VADD(VSET1(-0.66524694), VMUL(u2, VADD(VSET1(0.38708692),
+           VMUL(u2, VADD(VSET1(-0.23286574), VMUL(u2, VADD(VSET1(0.10530664), VMUL(u2, VSET1(-0.02344240))))))))))));
+}
+#endif
+
+/* data[i] = atan(data[i] / (.4 - drive * .3999)), drive clipped to [0, 1],
+   `drive` holds num values or is NULL for `cdrive`. */
+static void
+_atan_drive(MYFLT *data, MYFLT *drive, MYFLT cdrive, int num)
+{
+    int i = 0;
+    MYFLT drv;
+
+    if (drive == NULL) {
+        MYFLT idrv = 1.0 / (.4 - _clip(cdrive) * .3999);
+#ifdef VSIZE
+        VTYPE vidrv = VSET1(idrv);
+        for (; i<=num-VSIZE; i+=VSIZE)
+            VSTORE(data + i, _fast_atan_v(VMUL(VLOAD(data + i), vidrv)));
+#endif
+        for (; i<num; i++)
+            data[i] = _fast_atan(data[i] * idrv);
+    }
+    else {
+#ifdef VSIZE
+        VTYPE zero = VSET1(0.0), one = VSET1(1.0), vdrv;
+        for (; i<=num-VSIZE; i+=VSIZE) {
+            vdrv = VMIN(VMAX(VLOAD(drive + i), zero), one);
+            vdrv = VSUB(VSET1(.4), VMUL(vdrv, VSET1(.3999)));
+            VSTORE(data + i, _fast_atan_v(VDIV(VLOAD(data + i), vdrv)));
+        }
+#endif
+        for (; i<num; i++) {
+            drv = .4 - _clip(drive[i]) * .3999;
+            data[i] = _fast_atan(data[i] / drv);
+        }
+    }
+}
+
 static void
 Disto_transform_ii(Disto *self) {
     MYFLT val, coeff;
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    MYFLT drv = .4 - _clip(PyFloat_AS_DOUBLE(self->drive)) * .3999;
     MYFLT slp = _clip(PyFloat_AS_DOUBLE(self->slope));
 
-    for (i=0; i<self->bufsize; i++) {
-        val = MYATAN2(in[i], drv);
-        self->data[i] = val;
-    }
+    memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+    _atan_drive(self->data, NULL, PyFloat_AS_DOUBLE(self->drive), self->bufsize);
     coeff = 1.0 - slp;
     for (i=0; i<self->bufsize; i++) {
         val = self->data[i] * coeff + self->y1 * slp;
@@ -73,18 +154,15 @@ Disto_transform_ii(Disto *self) {
 
 static void
 Disto_transform_ai(Disto *self) {
-    MYFLT val, drv, coeff;
+    MYFLT val, coeff;
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     MYFLT *drive = Stream_getData((Stream *)self->drive_stream);
     MYFLT slp = _clip(PyFloat_AS_DOUBLE(self->slope));
 
-    for (i=0; i<self->bufsize; i++) {
-        drv = .4 - _clip(drive[i]) * .3999;
-        val = MYATAN2(in[i], drv);
-        self->data[i] = val;
-    }
+    memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+    _atan_drive(self->data, drive, 0.0, self->bufsize);
 
     coeff = 1.0 - slp;
     for (i=0; i<self->bufsize; i++) {
@@ -100,13 +178,10 @@ Disto_transform_ia(Disto *self) {
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    MYFLT drv = .4 - _clip(PyFloat_AS_DOUBLE(self->drive)) * .3999;
     MYFLT *slope = Stream_getData((Stream *)self->slope_stream);
 
-    for (i=0; i<self->bufsize; i++) {
-        val = MYATAN2(in[i], drv);
-        self->data[i] = val;
-    }
+    memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+    _atan_drive(self->data, NULL, PyFloat_AS_DOUBLE(self->drive), self->bufsize);
     for (i=0; i<self->bufsize; i++) {
         slp = _clip(slope[i]);
         coeff = 1.0 - slp;
@@ -118,18 +193,15 @@ Disto_transform_ia(Disto *self) {
 
 static void
 Disto_transform_aa(Disto *self) {
-    MYFLT val, drv, coeff, slp;
+    MYFLT val, coeff, slp;
     int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     MYFLT *drive = Stream_getData((Stream *)self->drive_stream);
     MYFLT *slope = Stream_getData((Stream *)self->slope_stream);
 
-    for (i=0; i<self->bufsize; i++) {
-        drv = .4 - _clip(drive[i]) * .3999;
-        val = MYATAN2(in[i], drv);
-        self->data[i] = val;
-    }
+    memcpy(self->data, in, self->bufsize * sizeof(MYFLT));
+    _atan_drive(self->data, drive, 0.0, self->bufsize);
     for (i=0; i<self->bufsize; i++) {
         slp = _clip(slope[i]);
         coeff = 1.0 - slp;
@@ -139,6 +211,43 @@ Disto_transform_aa(Disto *self) {
     }
 }
 
+/* The arc tangent runs at the oversampled rate, the lowpass filter at the
+   base rate. */
+static void
+Disto_transform_os(Disto *self) {
+    MYFLT val, coeff, slp;
+    int i, num = self->bufsize * self->os->factor;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *up = Oversampler_up(self->os, in, self->bufsize);
+    MYFLT *slope;
+
+    if (self->modebuffer[2] == 0)
+        _atan_drive(up, NULL, PyFloat_AS_DOUBLE(self->drive), num);
+    else
+        _atan_drive(up, Oversampler_hold(self->os, 0, Stream_getData((Stream *)self->drive_stream), self->bufsize), 0.0, num);
+    Oversampler_down(self->os, self->data, self->bufsize);
+
+    if (self->modebuffer[3] == 0) {
+        slp = _clip(PyFloat_AS_DOUBLE(self->slope));
+        coeff = 1.0 - slp;
+        for (i=0; i<self->bufsize; i++) {
+            val = self->data[i] * coeff + self->y1 * slp;
+            self->y1 = val;
+            self->data[i] = val;
+        }
+    }
+    else {
+        slope = Stream_getData((Stream *)self->slope_stream);
+        for (i=0; i<self->bufsize; i++) {
+            slp = _clip(slope[i]);
+            coeff = 1.0 - slp;
+            val = self->data[i] * coeff + self->y1 * slp;
+            self->y1 = val;
+            self->data[i] = val;
+        }
+    }
+}
+
 static void Disto_postprocessing_ii(Disto *self) { POST_PROCESSING_II };
 static void Disto_postprocessing_ai(Disto *self) { POST_PROCESSING_AI };
 static void Disto_postprocessing_ia(Disto *self) { POST_PROCESSING_IA };
@@ -170,6 +279,10 @@ Disto_setProcMode(Disto *self)
             self->proc_func_ptr = Disto_transform_aa;
             break;
     }
+    if (self->os != NULL) {
+        self->proc_func_ptr = Disto_transform_os;
+    }
+
 	switch (muladdmode) {
         case 0:
             self->muladd_func_ptr = Disto_postprocessing_ii;
@@ -239,13 +352,14 @@ Disto_dealloc(Disto* self)
 {
     pyo_DEALLOC
     Disto_clear(self);
+    Oversampler_free(self->os);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 static PyObject *
 Disto_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, oversample = 1;
     PyObject *inputtmp, *input_streamtmp, *drivetmp=NULL, *slopetmp=NULL, *multmp=NULL, *addtmp=NULL;
     Disto *self;
     self = (Disto *)type->tp_alloc(type, 0);
@@ -258,13 +372,16 @@ Disto_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[3] = 0;
     self->y1 = 0;
 
+    self->oversample = 1;
+    self->os = NULL;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Disto_compute_next_data_frame);
     self->mode_func_ptr = Disto_setProcMode;
 
-    static char *kwlist[] = {"input", "drive", "slope", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "drive", "slope", "oversample", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO", kwlist, &inputtmp, &drivetmp, &slopetmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &drivetmp, &slopetmp, &oversample, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -277,6 +394,10 @@ Disto_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setSlope", "O", slopetmp);
     }
 
+    if (oversample > 1) {
+        PyObject_CallMethod((PyObject *)self, "setOversample", "i", oversample);
+    }
+
     if (multmp) {
         PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
     }
@@ -287,6 +408,8 @@ Disto_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -312,6 +435,8 @@ static PyObject * Disto_inplace_sub(Disto *self, PyObject *arg) { INPLACE_SUB };
 static PyObject * Disto_div(Disto *self, PyObject *arg) { DIV };
 static PyObject * Disto_inplace_div(Disto *self, PyObject *arg) { INPLACE_DIV };
 
+static PyObject * Disto_setOversample(Disto *self, PyObject *arg) { SET_OVERSAMPLE };
+
 static PyObject *
 Disto_setDrive(Disto *self, PyObject *arg)
 {
@@ -399,6 +524,7 @@ static PyMethodDef Disto_methods[] = {
     {"stop", (PyCFunction)Disto_stop, METH_NOARGS, "Stops computing."},
 	{"setDrive", (PyCFunction)Disto_setDrive, METH_O, "Sets distortion drive factor (0 -> 1)."},
     {"setSlope", (PyCFunction)Disto_setSlope, METH_O, "Sets lowpass filter slope factor."},
+	{"setOversample", (PyCFunction)Disto_setOversample, METH_O, "Sets the oversampling factor (1, 2, 4 or 8)."},
 	{"setMul", (PyCFunction)Disto_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Disto_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Disto_setSub, METH_O, "Sets inverse add factor."},
@@ -503,6 +629,8 @@ typedef struct {
     PyObject *max;
     Stream *max_stream;
     int modebuffer[4];
+    int oversample;
+    Oversampler *os;
 } Clip;
 
 static void
@@ -585,6 +713,30 @@ Clip_transform_aa(Clip *self) {
     }
 }
 
+static void
+Clip_transform_os(Clip *self) {
+    MYFLT val;
+    int i, num = self->bufsize * self->os->factor;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *up = Oversampler_up(self->os, in, self->bufsize);
+    MYFLT *mi, *ma;
+
+    if (self->modebuffer[2] == 0)
+        mi = Oversampler_fill(self->os, 0, PyFloat_AS_DOUBLE(self->min), self->bufsize);
+    else
+        mi = Oversampler_hold(self->os, 0, Stream_getData((Stream *)self->min_stream), self->bufsize);
+    if (self->modebuffer[3] == 0)
+        ma = Oversampler_fill(self->os, 1, PyFloat_AS_DOUBLE(self->max), self->bufsize);
+    else
+        ma = Oversampler_hold(self->os, 1, Stream_getData((Stream *)self->max_stream), self->bufsize);
+
+    for (i=0; i<num; i++) {
+        val = up[i];
+        up[i] = val < mi[i] ? mi[i] : val > ma[i] ? ma[i] : val;
+    }
+    Oversampler_down(self->os, self->data, self->bufsize);
+}
+
 static void Clip_postprocessing_ii(Clip *self) { POST_PROCESSING_II };
 static void Clip_postprocessing_ai(Clip *self) { POST_PROCESSING_AI };
 static void Clip_postprocessing_ia(Clip *self) { POST_PROCESSING_IA };
@@ -616,6 +768,10 @@ Clip_setProcMode(Clip *self)
             self->proc_func_ptr = Clip_transform_aa;
             break;
     }
+    if (self->os != NULL) {
+        self->proc_func_ptr = Clip_transform_os;
+    }
+
 	switch (muladdmode) {
         case 0:
             self->muladd_func_ptr = Clip_postprocessing_ii;
@@ -685,13 +841,14 @@ Clip_dealloc(Clip* self)
 {
     pyo_DEALLOC
     Clip_clear(self);
+    Oversampler_free(self->os);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 static PyObject *
 Clip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, oversample = 1;
     PyObject *inputtmp, *input_streamtmp, *mintmp=NULL, *maxtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Clip *self;
     self = (Clip *)type->tp_alloc(type, 0);
@@ -703,13 +860,16 @@ Clip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
 
+    self->oversample = 1;
+    self->os = NULL;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Clip_compute_next_data_frame);
     self->mode_func_ptr = Clip_setProcMode;
 
-    static char *kwlist[] = {"input", "min", "max", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "min", "max", "oversample", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO", kwlist, &inputtmp, &mintmp, &maxtmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &mintmp, &maxtmp, &oversample, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -722,6 +882,10 @@ Clip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setMax", "O", maxtmp);
     }
 
+    if (oversample > 1) {
+        PyObject_CallMethod((PyObject *)self, "setOversample", "i", oversample);
+    }
+
     if (multmp) {
         PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
     }
@@ -732,6 +896,8 @@ Clip_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -757,6 +923,8 @@ static PyObject * Clip_inplace_sub(Clip *self, PyObject *arg) { INPLACE_SUB };
 static PyObject * Clip_div(Clip *self, PyObject *arg) { DIV };
 static PyObject * Clip_inplace_div(Clip *self, PyObject *arg) { INPLACE_DIV };
 
+static PyObject * Clip_setOversample(Clip *self, PyObject *arg) { SET_OVERSAMPLE };
+
 static PyObject *
 Clip_setMin(Clip *self, PyObject *arg)
 {
@@ -844,6 +1012,7 @@ static PyMethodDef Clip_methods[] = {
 {"stop", (PyCFunction)Clip_stop, METH_NOARGS, "Stops computing."},
 {"setMin", (PyCFunction)Clip_setMin, METH_O, "Sets the minimum value."},
 {"setMax", (PyCFunction)Clip_setMax, METH_O, "Sets the maximum value."},
+{"setOversample", (PyCFunction)Clip_setOversample, METH_O, "Sets the oversampling factor (1, 2, 4 or 8)."},
 {"setMul", (PyCFunction)Clip_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)Clip_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)Clip_setSub, METH_O, "Sets inverse add factor."},
@@ -948,6 +1117,8 @@ typedef struct {
     PyObject *max;
     Stream *max_stream;
     int modebuffer[4];
+    int oversample;
+    Oversampler *os;
 } Mirror;
 
 static void
@@ -1060,6 +1231,40 @@ Mirror_transform_aa(Mirror *self) {
     }
 }
 
+static void
+Mirror_transform_os(Mirror *self) {
+    MYFLT val;
+    int i, num = self->bufsize * self->os->factor;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *up = Oversampler_up(self->os, in, self->bufsize);
+    MYFLT *mi, *ma;
+
+    if (self->modebuffer[2] == 0)
+        mi = Oversampler_fill(self->os, 0, PyFloat_AS_DOUBLE(self->min), self->bufsize);
+    else
+        mi = Oversampler_hold(self->os, 0, Stream_getData((Stream *)self->min_stream), self->bufsize);
+    if (self->modebuffer[3] == 0)
+        ma = Oversampler_fill(self->os, 1, PyFloat_AS_DOUBLE(self->max), self->bufsize);
+    else
+        ma = Oversampler_hold(self->os, 1, Stream_getData((Stream *)self->max_stream), self->bufsize);
+
+    for (i=0; i<num; i++) {
+        val = up[i];
+        if (mi[i] >= ma[i])
+            val = (mi[i] + ma[i]) * 0.5;
+        else {
+            while ((val > ma[i]) || (val < mi[i])) {
+                if (val > ma[i])
+                    val = ma[i] + ma[i] - val;
+                else
+                    val = mi[i] + mi[i] - val;
+            }
+        }
+        up[i] = val;
+    }
+    Oversampler_down(self->os, self->data, self->bufsize);
+}
+
 static void Mirror_postprocessing_ii(Mirror *self) { POST_PROCESSING_II };
 static void Mirror_postprocessing_ai(Mirror *self) { POST_PROCESSING_AI };
 static void Mirror_postprocessing_ia(Mirror *self) { POST_PROCESSING_IA };
@@ -1091,6 +1296,10 @@ Mirror_setProcMode(Mirror *self)
             self->proc_func_ptr = Mirror_transform_aa;
             break;
     }
+    if (self->os != NULL) {
+        self->proc_func_ptr = Mirror_transform_os;
+    }
+
 	switch (muladdmode) {
         case 0:
             self->muladd_func_ptr = Mirror_postprocessing_ii;
@@ -1160,13 +1369,14 @@ Mirror_dealloc(Mirror* self)
 {
     pyo_DEALLOC
     Mirror_clear(self);
+    Oversampler_free(self->os);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 static PyObject *
 Mirror_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, oversample = 1;
     PyObject *inputtmp, *input_streamtmp, *mintmp=NULL, *maxtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Mirror *self;
     self = (Mirror *)type->tp_alloc(type, 0);
@@ -1178,13 +1388,16 @@ Mirror_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
 
+    self->oversample = 1;
+    self->os = NULL;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Mirror_compute_next_data_frame);
     self->mode_func_ptr = Mirror_setProcMode;
 
-    static char *kwlist[] = {"input", "min", "max", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "min", "max", "oversample", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO", kwlist, &inputtmp, &mintmp, &maxtmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &mintmp, &maxtmp, &oversample, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -1197,6 +1410,10 @@ Mirror_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setMax", "O", maxtmp);
     }
 
+    if (oversample > 1) {
+        PyObject_CallMethod((PyObject *)self, "setOversample", "i", oversample);
+    }
+
     if (multmp) {
         PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
     }
@@ -1232,6 +1449,8 @@ static PyObject * Mirror_inplace_sub(Mirror *self, PyObject *arg) { INPLACE_SUB
 static PyObject * Mirror_div(Mirror *self, PyObject *arg) { DIV };
 static PyObject * Mirror_inplace_div(Mirror *self, PyObject *arg) { INPLACE_DIV };
 
+static PyObject * Mirror_setOversample(Mirror *self, PyObject *arg) { SET_OVERSAMPLE };
+
 static PyObject *
 Mirror_setMin(Mirror *self, PyObject *arg)
 {
@@ -1319,6 +1538,7 @@ static PyMethodDef Mirror_methods[] = {
     {"stop", (PyCFunction)Mirror_stop, METH_NOARGS, "Stops computing."},
     {"setMin", (PyCFunction)Mirror_setMin, METH_O, "Sets the minimum value."},
     {"setMax", (PyCFunction)Mirror_setMax, METH_O, "Sets the maximum value."},
+    {"setOversample", (PyCFunction)Mirror_setOversample, METH_O, "Sets the oversampling factor (1, 2, 4 or 8)."},
     {"setMul", (PyCFunction)Mirror_setMul, METH_O, "Sets oscillator mul factor."},
     {"setAdd", (PyCFunction)Mirror_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Mirror_setSub, METH_O, "Sets inverse add factor."},
@@ -1423,6 +1643,8 @@ typedef struct {
     PyObject *max;
     Stream *max_stream;
     int modebuffer[4];
+    int oversample;
+    Oversampler *os;
 } Wrap;
 
 static void
@@ -1559,6 +1781,46 @@ Wrap_transform_aa(Wrap *self) {
     }
 }
 
+static void
+Wrap_transform_os(Wrap *self) {
+    MYFLT val, rng, tmp;
+    int i, num = self->bufsize * self->os->factor;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *up = Oversampler_up(self->os, in, self->bufsize);
+    MYFLT *mi, *ma;
+
+    if (self->modebuffer[2] == 0)
+        mi = Oversampler_fill(self->os, 0, PyFloat_AS_DOUBLE(self->min), self->bufsize);
+    else
+        mi = Oversampler_hold(self->os, 0, Stream_getData((Stream *)self->min_stream), self->bufsize);
+    if (self->modebuffer[3] == 0)
+        ma = Oversampler_fill(self->os, 1, PyFloat_AS_DOUBLE(self->max), self->bufsize);
+    else
+        ma = Oversampler_hold(self->os, 1, Stream_getData((Stream *)self->max_stream), self->bufsize);
+
+    for (i=0; i<num; i++) {
+        val = up[i];
+        if (mi[i] >= ma[i])
+            val = (mi[i] + ma[i]) * 0.5;
+        else {
+            rng = ma[i] - mi[i];
+            tmp = (val - mi[i]) / rng;
+            if (tmp >= 1.0) {
+                tmp -= (int)tmp;
+                val = tmp * rng + mi[i];
+            }
+            else if (tmp < 0) {
+                tmp += (int)(-tmp) + 1;
+                val = tmp * rng + mi[i];
+                if (val == ma[i])
+                    val = mi[i];
+            }
+        }
+        up[i] = val;
+    }
+    Oversampler_down(self->os, self->data, self->bufsize);
+}
+
 static void Wrap_postprocessing_ii(Wrap *self) { POST_PROCESSING_II };
 static void Wrap_postprocessing_ai(Wrap *self) { POST_PROCESSING_AI };
 static void Wrap_postprocessing_ia(Wrap *self) { POST_PROCESSING_IA };
@@ -1590,6 +1852,10 @@ Wrap_setProcMode(Wrap *self)
             self->proc_func_ptr = Wrap_transform_aa;
             break;
     }
+    if (self->os != NULL) {
+        self->proc_func_ptr = Wrap_transform_os;
+    }
+
 	switch (muladdmode) {
         case 0:
             self->muladd_func_ptr = Wrap_postprocessing_ii;
@@ -1659,13 +1925,14 @@ Wrap_dealloc(Wrap* self)
 {
     pyo_DEALLOC
     Wrap_clear(self);
+    Oversampler_free(self->os);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 static PyObject *
 Wrap_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, oversample = 1;
     PyObject *inputtmp, *input_streamtmp, *mintmp=NULL, *maxtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Wrap *self;
     self = (Wrap *)type->tp_alloc(type, 0);
@@ -1677,13 +1944,16 @@ Wrap_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
 
+    self->oversample = 1;
+    self->os = NULL;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Wrap_compute_next_data_frame);
     self->mode_func_ptr = Wrap_setProcMode;
 
-    static char *kwlist[] = {"input", "min", "max", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "min", "max", "oversample", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO", kwlist, &inputtmp, &mintmp, &maxtmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &mintmp, &maxtmp, &oversample, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -1696,6 +1966,10 @@ Wrap_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setMax", "O", maxtmp);
     }
 
+    if (oversample > 1) {
+        PyObject_CallMethod((PyObject *)self, "setOversample", "i", oversample);
+    }
+
     if (multmp) {
         PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
     }
@@ -1731,6 +2005,8 @@ static PyObject * Wrap_inplace_sub(Wrap *self, PyObject *arg) { INPLACE_SUB };
 static PyObject * Wrap_div(Wrap *self, PyObject *arg) { DIV };
 static PyObject * Wrap_inplace_div(Wrap *self, PyObject *arg) { INPLACE_DIV };
 
+static PyObject * Wrap_setOversample(Wrap *self, PyObject *arg) { SET_OVERSAMPLE };
+
 static PyObject *
 Wrap_setMin(Wrap *self, PyObject *arg)
 {
@@ -1818,6 +2094,7 @@ static PyMethodDef Wrap_methods[] = {
     {"stop", (PyCFunction)Wrap_stop, METH_NOARGS, "Stops computing."},
     {"setMin", (PyCFunction)Wrap_setMin, METH_O, "Sets the minimum value."},
     {"setMax", (PyCFunction)Wrap_setMax, METH_O, "Sets the maximum value."},
+    {"setOversample", (PyCFunction)Wrap_setOversample, METH_O, "Sets the oversampling factor (1, 2, 4 or 8)."},
     {"setMul", (PyCFunction)Wrap_setMul, METH_O, "Sets oscillator mul factor."},
     {"setAdd", (PyCFunction)Wrap_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Wrap_setSub, METH_O, "Sets inverse add factor."},
@@ -1924,6 +2201,8 @@ typedef struct {
     MYFLT value;
     int sampsCount;
     int modebuffer[4];
+    int oversample;
+    Oversampler *os;
 } Degrade;
 
 static MYFLT
@@ -2047,6 +2326,40 @@ Degrade_transform_aa(Degrade *self) {
     }
 }
 
+/* The samples are held factor times longer at the oversampled rate, the
+   steps are smoothed by the downsampling filters. */
+static void
+Degrade_transform_os(Degrade *self) {
+    MYFLT bitscl, ibitscl;
+    int i, nsamps, tmp, factor = self->os->factor, num = self->bufsize * factor;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *up = Oversampler_up(self->os, in, self->bufsize);
+    MYFLT *bitdepth, *srscale;
+
+    if (self->modebuffer[2] == 0)
+        bitdepth = Oversampler_fill(self->os, 0, PyFloat_AS_DOUBLE(self->bitdepth), self->bufsize);
+    else
+        bitdepth = Oversampler_hold(self->os, 0, Stream_getData((Stream *)self->bitdepth_stream), self->bufsize);
+    if (self->modebuffer[3] == 0)
+        srscale = Oversampler_fill(self->os, 1, PyFloat_AS_DOUBLE(self->srscale), self->bufsize);
+    else
+        srscale = Oversampler_hold(self->os, 1, Stream_getData((Stream *)self->srscale_stream), self->bufsize);
+
+    for (i=0; i<num; i++) {
+        nsamps = (int)(factor / _sr_clip(srscale[i]));
+        self->sampsCount++;
+        if (self->sampsCount >= nsamps) {
+            self->sampsCount = 0;
+            bitscl = MYPOW(2.0, _bit_clip(bitdepth[i])-1);
+            ibitscl = 1.0 / bitscl;
+            tmp = (int)(up[i] * bitscl + 0.5);
+            self->value = tmp * ibitscl;
+        }
+        up[i] = self->value;
+    }
+    Oversampler_down(self->os, self->data, self->bufsize);
+}
+
 static void Degrade_postprocessing_ii(Degrade *self) { POST_PROCESSING_II };
 static void Degrade_postprocessing_ai(Degrade *self) { POST_PROCESSING_AI };
 static void Degrade_postprocessing_ia(Degrade *self) { POST_PROCESSING_IA };
@@ -2078,6 +2391,10 @@ Degrade_setProcMode(Degrade *self)
             self->proc_func_ptr = Degrade_transform_aa;
             break;
     }
+    if (self->os != NULL) {
+        self->proc_func_ptr = Degrade_transform_os;
+    }
+
 	switch (muladdmode) {
         case 0:
             self->muladd_func_ptr = Degrade_postprocessing_ii;
@@ -2147,13 +2464,14 @@ Degrade_dealloc(Degrade* self)
 {
     pyo_DEALLOC
     Degrade_clear(self);
+    Oversampler_free(self->os);
     self->ob_type->tp_free((PyObject*)self);
 }
 
 static PyObject *
 Degrade_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, oversample = 1;
     PyObject *inputtmp, *input_streamtmp, *bitdepthtmp=NULL, *srscaletmp=NULL, *multmp=NULL, *addtmp=NULL;
     Degrade *self;
     self = (Degrade *)type->tp_alloc(type, 0);
@@ -2167,13 +2485,16 @@ Degrade_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
 
+    self->oversample = 1;
+    self->os = NULL;
+
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Degrade_compute_next_data_frame);
     self->mode_func_ptr = Degrade_setProcMode;
 
-    static char *kwlist[] = {"input", "bitdepth", "srscale", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "bitdepth", "srscale", "oversample", "mul", "add", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOO", kwlist, &inputtmp, &bitdepthtmp, &srscaletmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &bitdepthtmp, &srscaletmp, &oversample, &multmp, &addtmp))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
@@ -2186,6 +2507,10 @@ Degrade_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyObject_CallMethod((PyObject *)self, "setSrscale", "O", srscaletmp);
     }
 
+    if (oversample > 1) {
+        PyObject_CallMethod((PyObject *)self, "setOversample", "i", oversample);
+    }
+
     if (multmp) {
         PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
     }
@@ -2196,6 +2521,8 @@ Degrade_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -2221,6 +2548,8 @@ static PyObject * Degrade_inplace_sub(Degrade *self, PyObject *arg) { INPLACE_SU
 static PyObject * Degrade_div(Degrade *self, PyObject *arg) { DIV };
 static PyObject * Degrade_inplace_div(Degrade *self, PyObject *arg) { INPLACE_DIV };
 
+static PyObject * Degrade_setOversample(Degrade *self, PyObject *arg) { SET_OVERSAMPLE };
+
 static PyObject *
 Degrade_setBitdepth(Degrade *self, PyObject *arg)
 {
@@ -2308,6 +2637,7 @@ static PyMethodDef Degrade_methods[] = {
 {"stop", (PyCFunction)Degrade_stop, METH_NOARGS, "Stops computing."},
 {"setBitdepth", (PyCFunction)Degrade_setBitdepth, METH_O, "Sets the bitdepth value."},
 {"setSrscale", (PyCFunction)Degrade_setSrscale, METH_O, "Sets the srscale value."},
+{"setOversample", (PyCFunction)Degrade_setOversample, METH_O, "Sets the oversampling factor (1, 2, 4 or 8)."},
 {"setMul", (PyCFunction)Degrade_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)Degrade_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)Degrade_setSub, METH_O, "Sets inverse add factor."},
@@ -26,6 +26,9 @@
 #include "servermodule.h"
 #include "dummymodule.h"
 #include "fft.h"
+#include "partconv.h"
+#include "capturering.h"
+#include "dspthread.h"
 #include "wind.h"
 #include "sndfile.h"
 
@@ -45,7 +48,7 @@ typedef struct {
     int incount;
     MYFLT *inframe;
     MYFLT *outframe;
-    MYFLT *window;
+    const MYFLT *window;
     MYFLT **twiddle;
     MYFLT *twiddle2;
     MYFLT *buffer_streams;
@@ -53,9 +56,8 @@ typedef struct {
 
 static void
 FFTMain_realloc_memories(FFTMain *self) {
-    int i, n8;
+    int i;
     self->hsize = self->size / 2;
-    n8 = self->size >> 3;
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
     for (i=0; i<self->size; i++)
@@ -63,14 +65,13 @@ FFTMain_realloc_memories(FFTMain *self) {
     self->buffer_streams = (MYFLT *)realloc(self->buffer_streams, 3 * self->bufsize * sizeof(MYFLT));
     for (i=0; i<(self->bufsize*3); i++)
         self->buffer_streams[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->twiddle2 = (MYFLT *)realloc(self->twiddle2, self->size * sizeof(MYFLT));
-    fft_compute_radix2_twiddle(self->twiddle2, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, self->wintype);
+    Stream_setMemory(self->stream, (2 * self->size + 3 * self->bufsize) * sizeof(MYFLT));
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->twiddle2);
+    self->twiddle2 = fft_acquire_radix2_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, self->wintype);
     self->incount = -self->hopsize;
 }
 
@@ -165,17 +166,13 @@ FFTMain_clear(FFTMain *self)
 static void
 FFTMain_dealloc(FFTMain* self)
 {
-    int i;
     pyo_DEALLOC
     free(self->inframe);
     free(self->outframe);
-    free(self->window);
+    fft_release_table(self->window);
     free(self->buffer_streams);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    free(self->twiddle2);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->twiddle2);
     FFTMain_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -244,7 +241,8 @@ FFTMain_setWinType(FFTMain *self, PyObject *arg)
 {
     if (PyLong_Check(arg) || PyInt_Check(arg)) {
         self->wintype = PyLong_AsLong(arg);
-        gen_window(self->window, self->size, self->wintype);
+        fft_release_table(self->window);
+        self->window = fft_acquire_window(self->size, self->wintype);
     }
 
     Py_INCREF(Py_None);
@@ -579,7 +577,7 @@ typedef struct {
     int incount;
     MYFLT *inframe;
     MYFLT *outframe;
-    MYFLT *window;
+    const MYFLT *window;
     MYFLT **twiddle;
     MYFLT *twiddle2;
     int modebuffer[2];
@@ -587,21 +585,19 @@ typedef struct {
 
 static void
 IFFT_realloc_memories(IFFT *self) {
-    int i, n8;
+    int i;
     self->hsize = self->size / 2;
-    n8 = self->size >> 3;
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
     for (i=0; i<self->size; i++)
         self->inframe[i] = self->outframe[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->twiddle2 = (MYFLT *)realloc(self->twiddle2, self->size * sizeof(MYFLT));
-    fft_compute_radix2_twiddle(self->twiddle2, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, self->wintype);
+    Stream_setMemory(self->stream, 2 * self->size * sizeof(MYFLT));
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->twiddle2);
+    self->twiddle2 = fft_acquire_radix2_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, self->wintype);
     self->incount = -self->hopsize;
 }
 
@@ -731,16 +727,12 @@ IFFT_clear(IFFT *self)
 static void
 IFFT_dealloc(IFFT* self)
 {
-    int i;
     pyo_DEALLOC
     free(self->inframe);
     free(self->outframe);
-    free(self->window);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    free(self->twiddle2);
+    fft_release_table(self->window);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->twiddle2);
     IFFT_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -846,7 +838,8 @@ IFFT_setWinType(IFFT *self, PyObject *arg)
 {
     if (PyLong_Check(arg) || PyInt_Check(arg)) {
         self->wintype = PyLong_AsLong(arg);
-        gen_window(self->window, self->size, self->wintype);
+        fft_release_table(self->window);
+        self->window = fft_acquire_window(self->size, self->wintype);
     }
 
     Py_INCREF(Py_None);
@@ -1639,6 +1632,7 @@ FrameDeltaMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, FrameDeltaMain_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = FrameDeltaMain_setProcMode;
 
     static char *kwlist[] = {"input", "frameSize", "overlaps", NULL};
@@ -1664,6 +1658,7 @@ FrameDeltaMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->overlaps*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
     (*self->mode_func_ptr)(self);
 
@@ -1715,6 +1710,7 @@ FrameDeltaMain_setFrameSize(FrameDeltaMain *self, PyObject *arg)
                     self->frameBuffer[i][j] = 0.0;
                 }
             }
+            Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
             self->count = 0;
         }
@@ -2148,6 +2144,7 @@ FrameAccumMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, FrameAccumMain_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = FrameAccumMain_setProcMode;
 
     static char *kwlist[] = {"input", "framesize", "overlaps", NULL};
@@ -2173,6 +2170,7 @@ FrameAccumMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->overlaps*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
     (*self->mode_func_ptr)(self);
 
@@ -2224,6 +2222,7 @@ FrameAccumMain_setFrameSize(FrameAccumMain *self, PyObject *arg)
                     self->frameBuffer[i][j] = 0.0;
                 }
             }
+            Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
             self->count = 0;
         }
@@ -2723,6 +2722,7 @@ VectralMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, VectralMain_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = VectralMain_setProcMode;
 
     static char *kwlist[] = {"input", "frameSize", "overlaps", "up", "down", "damp", NULL};
@@ -2760,6 +2760,7 @@ VectralMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->overlaps*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
     (*self->mode_func_ptr)(self);
 
@@ -2811,6 +2812,7 @@ VectralMain_setFrameSize(VectralMain *self, PyObject *arg)
                     self->frameBuffer[i][j] = 0.0;
                 }
             }
+            Stream_setMemory(self->stream, (size_t)self->overlaps * (self->frameSize + self->bufsize) * sizeof(MYFLT));
 
             self->count = 0;
         }
@@ -3247,56 +3249,29 @@ typedef struct {
     char *impulse_path;
     int chnl;
     int size;
-    int size2;
-    int hsize;
     int incount;
-    int num_iter;
-    int current_iter;
-    int impulse_len;
-    MYFLT *inframe;
-    MYFLT *outframe;
-    MYFLT *last_half_frame;
-    MYFLT **twiddle;
     MYFLT *input_buffer;
     MYFLT *output_buffer;
-    MYFLT **impulse_real;
-    MYFLT **impulse_imag;
-    MYFLT **accum_real;
-    MYFLT **accum_imag;
-    MYFLT *real;
-    MYFLT *imag;
+    SplitConv *conv; /* NULL if the impulse could not be read */
     int modebuffer[3];
 } CvlVerb;
 
 static void
 CvlVerb_alloc_memories(CvlVerb *self) {
-    int i, n8;
-    self->hsize = self->size / 2;
-    self->size2 = self->size * 2;
-    n8 = self->size2 >> 3;
-    self->real = (MYFLT *)realloc(self->real, self->size * sizeof(MYFLT));
-    self->imag = (MYFLT *)realloc(self->imag, self->size * sizeof(MYFLT));
-    self->inframe = (MYFLT *)realloc(self->inframe, self->size2 * sizeof(MYFLT));
-    self->outframe = (MYFLT *)realloc(self->outframe, self->size2 * sizeof(MYFLT));
-    self->last_half_frame = (MYFLT *)realloc(self->last_half_frame, self->size * sizeof(MYFLT));
+    int i;
     self->input_buffer = (MYFLT *)realloc(self->input_buffer, self->size * sizeof(MYFLT));
-    self->output_buffer = (MYFLT *)realloc(self->output_buffer, self->size2 * sizeof(MYFLT));
-    for (i=0; i<self->size2; i++)
-        self->inframe[i] = self->outframe[i] = self->output_buffer[i] = 0.0;
+    self->output_buffer = (MYFLT *)realloc(self->output_buffer, self->size * sizeof(MYFLT));
     for (i=0; i<self->size; i++)
-        self->last_half_frame[i] = self->input_buffer[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size2);
+        self->input_buffer[i] = self->output_buffer[i] = 0.0;
 }
 
 static void
 CvlVerb_analyse_impulse(CvlVerb *self) {
     SNDFILE *sf;
     SF_INFO info;
-    int i, j, snd_size, snd_sr, snd_chnls, num_items, num;
-    MYFLT *tmp, *tmp2, *inframe, *outframe;
+    int i, snd_size, snd_sr, snd_chnls, num_items;
+    MYFLT scl;
+    MYFLT *tmp, *tmp2;
 
     info.format = 0;
     sf = sf_open(self->impulse_path, SFM_READ, &info);
@@ -3313,66 +3288,33 @@ CvlVerb_analyse_impulse(CvlVerb *self) {
         printf("CvlVerb warning : Impulse sampling rate does't match the sampling rate of the server.\n");
     }
 
-    self->num_iter = (int)MYCEIL((MYFLT)snd_size / self->size);
-    self->impulse_len = self->num_iter * self->size;
-
     tmp = (MYFLT *)malloc(num_items * sizeof(MYFLT));
-    tmp2 = (MYFLT *)malloc(self->impulse_len * sizeof(MYFLT));
+    tmp2 = (MYFLT *)malloc(snd_size * sizeof(MYFLT));
 
     sf_seek(sf, 0, SEEK_SET);
-    num = SF_READ(sf, tmp, num_items);
+    SF_READ(sf, tmp, num_items);
     sf_close(sf);
-    for (i=0; i<snd_size; i++) {
-        tmp2[i] = tmp[i*snd_chnls+self->chnl];
-    }
-    for (i=snd_size; i<self->impulse_len; i++) {
-        tmp2[i] = 0.0;
-    }
 
-    self->impulse_real = (MYFLT **)realloc(self->impulse_real, self->num_iter * sizeof(MYFLT *));
-    self->impulse_imag = (MYFLT **)realloc(self->impulse_imag, self->num_iter * sizeof(MYFLT *));
-    self->accum_real = (MYFLT **)realloc(self->accum_real, self->num_iter * sizeof(MYFLT *));
-    self->accum_imag = (MYFLT **)realloc(self->accum_imag, self->num_iter * sizeof(MYFLT *));
-    for(i=0; i<self->num_iter; i++) {
-        self->impulse_real[i] = (MYFLT *)malloc(self->size * sizeof(MYFLT));
-        self->impulse_imag[i] = (MYFLT *)malloc(self->size * sizeof(MYFLT));
-        self->accum_real[i] = (MYFLT *)malloc(self->size * sizeof(MYFLT));
-        self->accum_imag[i] = (MYFLT *)malloc(self->size * sizeof(MYFLT));
-        for (j=0; j<self->size; j++) {
-            self->accum_real[i][j] = 0.0;
-            self->accum_imag[i][j] = 0.0;
-        }
+    /* Keeps the level of the single partition size engine, which
+       did not compensate the scaling of its ffts. */
+    scl = 1.0 / (self->size * 2);
+    for (i=0; i<snd_size; i++) {
+        tmp2[i] = tmp[i*snd_chnls+self->chnl] * scl;
     }
 
-    inframe = (MYFLT *)malloc(self->size2 * sizeof(MYFLT));
-    outframe = (MYFLT *)malloc(self->size2 * sizeof(MYFLT));
-
-    for (j=0; j<self->num_iter; j++) {
-        num = j * self->size;
-        for (i=0; i<self->size; i++) {
-            inframe[i] = tmp2[num+i];
-        }
-        for (i=self->size; i<self->size2; i++) {
-            inframe[i] = 0.0;
-        }
-        realfft_split(inframe, outframe, self->size2, self->twiddle);
-        self->impulse_real[j][0] = outframe[0];
-        self->impulse_imag[j][0] = 0.0;
-        for (i=1; i<self->size; i++) {
-            self->impulse_real[j][i] = outframe[i];
-            self->impulse_imag[j][i] = outframe[self->size2 - i];
-        }
-    }
+    SplitConv_free(self->conv);
+    self->conv = SplitConv_new(self->size, snd_size);
+    Stream_setMemory(self->stream, 2 * self->size * sizeof(MYFLT) + SplitConv_getMemory(self->conv));
+    if (self->conv != NULL)
+        SplitConv_setImpulse(self->conv, tmp2, snd_size);
 
     free(tmp);
     free(tmp2);
-    free(inframe);
-    free(outframe);
 }
 
 static void
 CvlVerb_process_i(CvlVerb *self) {
-    int i, j, k;
+    int i;
     MYFLT gdry;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT bal = PyFloat_AS_DOUBLE(self->bal);
@@ -3389,53 +3331,15 @@ CvlVerb_process_i(CvlVerb *self) {
         self->incount++;
         if (self->incount == self->size) {
             self->incount = 0;
-
-            k = self->current_iter - 1;
-            if (k < 0)
-                k += self->num_iter;
-            for (i=0; i<self->size; i++) {
-                self->accum_real[k][i] = self->accum_imag[k][i] = 0.0;
-                self->inframe[i] = self->last_half_frame[i];
-                self->inframe[i+self->size] = self->last_half_frame[i] = self->input_buffer[i];
-            }
-            realfft_split(self->inframe, self->outframe, self->size2, self->twiddle);
-            self->real[0] = self->outframe[0];
-            self->imag[0] = 0.0;
-            for (i=1; i<self->size; i++) {
-                self->real[i] = self->outframe[i];
-                self->imag[i] = self->outframe[self->size2 - i];
-            }
-            for (j=0; j<self->num_iter; j++) {
-                k = self->current_iter + j;
-                if (k >= self->num_iter)
-                    k -= self->num_iter;
-                for (i=0; i<self->size; i++) {
-                    self->accum_real[k][i] += self->real[i] * self->impulse_real[j][i] - self->imag[i] * self->impulse_imag[j][i];
-                    self->accum_imag[k][i] += self->real[i] * self->impulse_imag[j][i] + self->imag[i] * self->impulse_real[j][i];
-                }
-            }
-            self->inframe[0] = self->accum_real[self->current_iter][0];
-            self->inframe[self->size] = 0.0;
-            for (i=1; i<self->size; i++) {
-                self->inframe[i] = self->accum_real[self->current_iter][i];
-                self->inframe[self->size2 - i] = self->accum_imag[self->current_iter][i];
-            }
-            irealfft_split(self->inframe, self->outframe, self->size2, self->twiddle);
-
-            for (i=0; i<self->size; i++) {
-                self->output_buffer[i] = self->outframe[i+self->size];
-            }
-
-            self->current_iter++;
-            if (self->current_iter == self->num_iter)
-                self->current_iter = 0;
+            if (self->conv != NULL)
+                SplitConv_process(self->conv, self->input_buffer, self->output_buffer);
         }
     }
 }
 
 static void
 CvlVerb_process_a(CvlVerb *self) {
-    int i, j, k;
+    int i;
     MYFLT gwet, gdry;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *bal = Stream_getData((Stream *)self->bal_stream);
@@ -3453,46 +3357,8 @@ CvlVerb_process_a(CvlVerb *self) {
         self->incount++;
         if (self->incount == self->size) {
             self->incount = 0;
-
-            k = self->current_iter - 1;
-            if (k < 0)
-                k += self->num_iter;
-            for (i=0; i<self->size; i++) {
-                self->accum_real[k][i] = self->accum_imag[k][i] = 0.0;
-                self->inframe[i] = self->last_half_frame[i];
-                self->inframe[i+self->size] = self->last_half_frame[i] = self->input_buffer[i];
-            }
-            realfft_split(self->inframe, self->outframe, self->size2, self->twiddle);
-            self->real[0] = self->outframe[0];
-            self->imag[0] = 0.0;
-            for (i=1; i<self->size; i++) {
-                self->real[i] = self->outframe[i];
-                self->imag[i] = self->outframe[self->size2 - i];
-            }
-            for (j=0; j<self->num_iter; j++) {
-                k = self->current_iter + j;
-                if (k >= self->num_iter)
-                    k -= self->num_iter;
-                for (i=0; i<self->size; i++) {
-                    self->accum_real[k][i] += self->real[i] * self->impulse_real[j][i] - self->imag[i] * self->impulse_imag[j][i];
-                    self->accum_imag[k][i] += self->real[i] * self->impulse_imag[j][i] + self->imag[i] * self->impulse_real[j][i];
-                }
-            }
-            self->inframe[0] = self->accum_real[self->current_iter][0];
-            self->inframe[self->size] = 0.0;
-            for (i=1; i<self->size; i++) {
-                self->inframe[i] = self->accum_real[self->current_iter][i];
-                self->inframe[self->size2 - i] = self->accum_imag[self->current_iter][i];
-            }
-            irealfft_split(self->inframe, self->outframe, self->size2, self->twiddle);
-
-            for (i=0; i<self->size; i++) {
-                self->output_buffer[i] = self->outframe[i+self->size];
-            }
-
-            self->current_iter++;
-            if (self->current_iter == self->num_iter)
-                self->current_iter = 0;
+            if (self->conv != NULL)
+                SplitConv_process(self->conv, self->input_buffer, self->output_buffer);
         }
     }
 }
@@ -3586,29 +3452,10 @@ CvlVerb_clear(CvlVerb *self)
 static void
 CvlVerb_dealloc(CvlVerb* self)
 {
-    int i;
     pyo_DEALLOC
-    free(self->inframe);
-    free(self->outframe);
     free(self->input_buffer);
     free(self->output_buffer);
-    free(self->last_half_frame);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    for(i=0; i<self->num_iter; i++) {
-        free(self->impulse_real[i]);
-        free(self->impulse_imag[i]);
-        free(self->accum_real[i]);
-        free(self->accum_imag[i]);
-    }
-    free(self->impulse_real);
-    free(self->impulse_imag);
-    free(self->accum_real);
-    free(self->accum_imag);
-    free(self->real);
-    free(self->imag);
+    SplitConv_free(self->conv);
     CvlVerb_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -3625,7 +3472,6 @@ CvlVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->size = 1024;
     self->chnl = 0;
     self->incount = 0;
-    self->current_iter = 0;
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, CvlVerb_compute_next_data_frame);
     self->mode_func_ptr = CvlVerb_setProcMode;
@@ -3640,7 +3486,7 @@ CvlVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->size = self->bufsize;
     }
 
-    k = 1;
+    k = 16;
     while (k < self->size)
         k <<= 1;
     self->size = k;
@@ -3839,7 +3685,6 @@ typedef struct {
     int size;
     int hsize;
     int wintype;
-    int incount;
     int freqone;
     int freqtwo;
     int width;
@@ -3849,41 +3694,66 @@ typedef struct {
     MYFLT gain;
     MYFLT oneOverSr;
     MYFLT freqPerBin;
-    MYFLT *input_buffer;
+    CaptureRing *ring;
     MYFLT *inframe;
     MYFLT *outframe;
     MYFLT *magnitude;
     MYFLT *last_magnitude;
     MYFLT *tmpmag;
-    MYFLT *window;
+    const MYFLT *window;
     MYFLT **twiddle;
 } Spectrum;
 
 static void
 Spectrum_realloc_memories(Spectrum *self) {
-    int i, n8;
+    int i;
     self->hsize = self->size / 2;
-    n8 = self->size >> 3;
-    self->input_buffer = (MYFLT *)realloc(self->input_buffer, self->size * sizeof(MYFLT));
+    CaptureRing_free(self->ring);
+    self->ring = CaptureRing_new(self->size, self->bufsize);
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
     for (i=0; i<self->size; i++)
-        self->input_buffer[i] = self->inframe[i] = self->outframe[i] = 0.0;
+        self->inframe[i] = self->outframe[i] = 0.0;
     self->magnitude = (MYFLT *)realloc(self->magnitude, self->hsize * sizeof(MYFLT));
     self->last_magnitude = (MYFLT *)realloc(self->last_magnitude, self->hsize * sizeof(MYFLT));
     self->tmpmag = (MYFLT *)realloc(self->tmpmag, (self->hsize+6) * sizeof(MYFLT));
     for (i=0; i<self->hsize; i++)
         self->magnitude[i] = self->last_magnitude[i] = self->tmpmag[i+3] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, self->wintype);
-    self->incount = self->hsize;
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, self->wintype);
     self->freqPerBin = self->sr / self->size;
 }
 
+/* Analyses the last `size` samples captured, from the thread asking for the display. */
+static void
+Spectrum_analyse(Spectrum *self) {
+    int j, impos;
+    MYFLT tmp;
+
+    CaptureRing_read(self->ring, self->inframe, self->size);
+    for (j=0; j<self->size; j++) {
+        self->inframe[j] *= self->window[j];
+    }
+    realfft_split(self->inframe, self->outframe, self->size, self->twiddle);
+    self->tmpmag[0] = self->tmpmag[1] = self->tmpmag[2] = 0.0;
+    self->tmpmag[self->hsize] = self->tmpmag[self->hsize+1] = self->tmpmag[self->hsize+2] = 0.0;
+    self->tmpmag[3] = MYSQRT(self->outframe[0]*self->outframe[0]);
+    for (j=1; j<self->hsize; j++) {
+        impos = self->size - j;
+        tmp = MYSQRT(self->outframe[j]*self->outframe[j] + self->outframe[impos]*self->outframe[impos]) * 2;
+        self->tmpmag[j+3] = self->last_magnitude[j] = tmp + self->last_magnitude[j] * 0.5;
+    }
+    for (j=0; j<self->hsize; j++) {
+        tmp =   (self->tmpmag[j] + self->tmpmag[j+6]) * 0.05 +
+                (self->tmpmag[j+1] + self->tmpmag[j+5]) * 0.15 +
+                (self->tmpmag[j+2] + self->tmpmag[j+4])* 0.3 +
+                self->tmpmag[j+3] * 0.5;
+        self->magnitude[j] = tmp;
+    }
+}
+
 static PyObject *
 Spectrum_display(Spectrum *self) {
     int i, p1, b1, b2, bins;
@@ -3891,6 +3761,8 @@ Spectrum_display(Spectrum *self) {
     MYFLT logmin, logrange;
     PyObject *points, *tuple;
 
+    Spectrum_analyse(self);
+
     b1 = (int)(self->freqone / self->freqPerBin);
     b2 = (int)(self->freqtwo / self->freqPerBin);
     bins = b2 - b1;
@@ -3974,37 +3846,8 @@ Spectrum_display(Spectrum *self) {
 
 static void
 Spectrum_filters(Spectrum *self) {
-    int i, j = 0, impos = 0;
-    MYFLT tmp = 0.0;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-
-    for (i=0; i<self->bufsize; i++) {
-        self->input_buffer[self->incount] = in[i];
-        self->incount++;
-        if (self->incount == self->size) {
-            for (j=0; j<self->size; j++) {
-                self->inframe[j] = self->input_buffer[j] * self->window[j];
-            }
-            self->incount = self->hsize;
-            realfft_split(self->inframe, self->outframe, self->size, self->twiddle);
-            self->tmpmag[0] = self->tmpmag[1] = self->tmpmag[2] = 0.0;
-            self->tmpmag[self->hsize] = self->tmpmag[self->hsize+1] = self->tmpmag[self->hsize+2] = 0.0;
-            self->tmpmag[3] = MYSQRT(self->outframe[0]*self->outframe[0]);
-            for (j=1; j<self->hsize; j++) {
-                impos = self->size - j;
-                tmp = MYSQRT(self->outframe[j]*self->outframe[j] + self->outframe[impos]*self->outframe[impos]) * 2;
-                self->tmpmag[j+3] = self->last_magnitude[j] = tmp + self->last_magnitude[j] * 0.5;
-            }
-            for (j=0; j<self->hsize; j++) {
-                tmp =   (self->tmpmag[j] + self->tmpmag[j+6]) * 0.05 +
-                        (self->tmpmag[j+1] + self->tmpmag[j+5]) * 0.15 +
-                        (self->tmpmag[j+2] + self->tmpmag[j+4])* 0.3 +
-                        self->tmpmag[j+3] * 0.5;
-                self->magnitude[j] = tmp;
-                self->input_buffer[j] = self->input_buffer[j+self->hsize];
-            }
-        }
-    }
+    CaptureRing_write(self->ring, in, self->bufsize);
 }
 
 static void
@@ -4040,19 +3883,15 @@ Spectrum_clear(Spectrum *self)
 static void
 Spectrum_dealloc(Spectrum* self)
 {
-    int i;
     pyo_DEALLOC
-    free(self->input_buffer);
+    CaptureRing_free(self->ring);
     free(self->inframe);
     free(self->outframe);
-    free(self->window);
+    fft_release_table(self->window);
     free(self->magnitude);
     free(self->last_magnitude);
     free(self->tmpmag);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
+    fft_release_table(self->twiddle);
     Spectrum_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -4080,6 +3919,7 @@ Spectrum_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->mscaling = 1;
 
     Stream_setFunctionPtr(self->stream, Spectrum_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
     self->mode_func_ptr = Spectrum_setProcMode;
 
     static char *kwlist[] = {"input", "size", "wintype", NULL};
@@ -4103,6 +3943,8 @@ Spectrum_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
+    DspLock_exempt((PyCFunction)Spectrum_display);
+
     return (PyObject *)self;
 }
 
@@ -4134,7 +3976,8 @@ Spectrum_setWinType(Spectrum *self, PyObject *arg)
 {
     if (PyLong_Check(arg) || PyInt_Check(arg)) {
         self->wintype = PyLong_AsLong(arg);
-        gen_window(self->window, self->size, self->wintype);
+        fft_release_table(self->window);
+        self->window = fft_acquire_window(self->size, self->wintype);
     }
 
     Py_INCREF(Py_None);
@@ -25,9 +25,123 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "sinekernel.h"
+#include "packed.h"
 
 static MYFLT HALF_COS_ARRAY[513] = {1.0, 0.99998110153278696, 0.99992440684545181, 0.99982991808087995, 0.99969763881045715, 0.99952757403393411, 0.99931973017923825, 0.99907411510222999, 0.99879073808640628, 0.99846960984254973, 0.99811074250832332, 0.99771414964781235, 0.99727984625101107, 0.99680784873325645, 0.99629817493460782, 0.99575084411917214, 0.99516587697437664, 0.99454329561018584, 0.99388312355826691, 0.9931853857710996, 0.99245010862103322, 0.99167731989928998, 0.99086704881491472, 0.99001932599367026, 0.98913418347688054, 0.98821165472021921, 0.9872517745924454, 0.98625457937408512, 0.98522010675606064, 0.98414839583826585, 0.98303948712808786, 0.98189342253887657, 0.98071024538836005, 0.97949000039700762, 0.97823273368633901, 0.9769384927771817, 0.97560732658787452, 0.97423928543241856, 0.97283442101857576, 0.97139278644591409, 0.96991443620380113, 0.96839942616934394, 0.96684781360527761, 0.96525965715780015, 0.96363501685435693, 0.96197395410137099, 0.96027653168192206, 0.95854281375337425, 0.95677286584495025, 0.95496675485525528, 0.95312454904974775, 0.95124631805815985, 0.94933213287186513, 0.94738206584119555, 0.94539619067270686, 0.9433745824263926, 0.94131731751284708, 0.9392244736903772, 0.93709613006206383, 0.9349323670727715, 0.93273326650610799, 0.93049891148133324, 0.92822938645021758, 0.92592477719384991, 0.92358517081939495, 0.92121065575680161, 0.91880132175545981, 0.91635725988080907, 0.91387856251089561, 0.91136532333288145, 0.90881763733950294, 0.9062356008254806, 0.90361931138387919, 0.90096886790241915, 0.89828437055973898, 0.89556592082160869, 0.89281362143709486, 0.89002757643467667, 0.88720789111831455, 0.8843546720634694, 0.88146802711307481, 0.87854806537346075, 0.87559489721022943, 0.8726086342440843, 0.86958938934661101, 0.86653727663601088, 0.86345241147278784, 0.86033491045538835, 0.85718489141579368, 0.85400247341506719, 0.8507877767388532, 0.84754092289283123, 0.8442620345981231, 0.84095123578665476, 0.8376086515964718, 0.83423440836700968, 0.83082863363431847, 0.82739145612624232, 0.82392300575755428, 0.82042341362504534, 0.81689281200256991, 0.81333133433604599, 0.80973911523841147, 0.80611629048453592, 0.80246299700608914, 0.79877937288636502, 0.7950655573550629, 0.79132169078302494, 0.78754791467693042, 0.78374437167394739, 0.77991120553634141, 0.77604856114604148, 0.77215658449916424, 0.76823542270049605, 0.76428522395793219, 0.7603061375768756, 0.75629831395459302, 0.75226190457453135, 0.74819706200059122, 0.7441039398713607, 0.73998269289430851, 0.73583347683993672, 0.73165644853589207, 0.72745176586103977, 0.72321958773949491, 0.71896007413461649, 0.71467338604296105, 0.71035968548819706, 0.70601913551498185, 0.70165190018279788, 0.69725814455975277, 0.69283803471633953, 0.68839173771916018, 0.68391942162461061, 0.6794212554725293, 0.67489740927980701, 0.67034805403396192, 0.66577336168667567, 0.66117350514729512, 0.65654865827629605, 0.65189899587871258, 0.64722469369752944, 0.6425259284070397, 0.63780287760616672, 0.63305571981175202, 0.62828463445180749, 0.62348980185873359, 0.61867140326250347, 0.61382962078381298, 0.60896463742719675, 0.60407663707411186, 0.59916580447598711, 0.59423232524724023, 0.58927638585826192, 0.58429817362836856, 0.57929787671872113, 0.57427568412521424, 0.56923178567133192, 0.56416637200097319, 0.55907963457124654, 0.55397176564523298, 0.5488429582847193, 0.5436934063429012, 0.53852330445705543, 0.53333284804118442, 0.52812223327862839, 0.52289165711465235, 0.51764131724900009, 0.51237141212842374, 0.50708214093918114, 0.50177370359950879, 0.49644630075206486, 0.49110013375634509, 0.48573540468107329, 0.48035231629656205, 0.47495107206705045, 0.46953187614301212, 0.46409493335344021, 0.45864044919810504, 0.45316862983978612, 0.44767968209648135, 0.44217381343358825, 0.43665123195606403, 0.43111214640055828, 0.42555676612752463, 0.41998530111330729, 0.41439796194220363, 0.40879495979850627, 0.40317650645851943, 0.39754281428255606, 0.3918940962069094, 0.38623056573580644, 0.38055243693333718, 0.3748599244153632, 0.36915324334140731, 0.36343260940651945, 0.35769823883312568, 0.35195034836285416, 0.34618915524834432, 0.34041487724503472, 0.33462773260293199, 0.32882794005836308, 0.32301571882570607, 0.31719128858910622, 0.31135486949417079, 0.30550668213964982, 0.29964694756909749, 0.29377588726251663, 0.28789372312798917, 0.28200067749328667, 0.27609697309746906, 0.27018283308246382, 0.26425848098463345, 0.25832414072632598, 0.25238003660741054, 0.24642639329680122, 0.24046343582396335, 0.23449138957040974, 0.22851048026118126, 0.22252093395631445, 0.21652297704229864, 0.21051683622351761, 0.20450273851368242, 0.19848091122724945, 0.19245158197082995, 0.18641497863458675, 0.1803713293836198, 0.17432086264934399, 0.16826380712085329, 0.16220039173627876, 0.15613084567413366, 0.1500553983446527, 0.14397427938112045, 0.13788771863119115, 0.13179594614820278, 0.12569919218247999, 0.11959768717263308, 0.11349166173684638, 0.10738134666416307, 0.10126697290576155, 0.095148771566225324, 0.089026973894809708, 0.082901811276699419, 0.076773515224264705, 0.070642317368309157, 0.064508449449316344, 0.058372143308689985, 0.052233630879990445, 0.046093144180169916, 0.039950915300801082, 0.033807176399306589, 0.027662159690182372, 0.021516097436222258, 0.01536922193973846, 0.0092217655337806046, 0.0030739605733557966, -0.0030739605733554522, -0.0092217655337804832, -0.015369221939738116, -0.021516097436222133, -0.027662159690182025, -0.033807176399306464, -0.039950915300800735, -0.046093144180169791, -0.052233630879990098, -0.05837214330868986, -0.064508449449316232, -0.07064231736830906, -0.076773515224264371, -0.082901811276699308, -0.089026973894809375, -0.095148771566225213, -0.10126697290576121, -0.10738134666416296, -0.11349166173684605, -0.11959768717263299, -0.12569919218247966, -0.13179594614820267, -0.13788771863119104, -0.14397427938112034, -0.15005539834465259, -0.15613084567413354, -0.16220039173627843, -0.16826380712085318, -0.17432086264934366, -0.18037132938361969, -0.18641497863458642, -0.19245158197082984, -0.19848091122724912, -0.20450273851368231, -0.21051683622351727, -0.21652297704229853, -0.22252093395631434, -0.22851048026118118, -0.23449138957040966, -0.24046343582396323, -0.24642639329680088, -0.25238003660741043, -0.25832414072632565, -0.26425848098463334, -0.27018283308246349, -0.27609697309746895, -0.28200067749328633, -0.28789372312798905, -0.2937758872625163, -0.29964694756909738, -0.30550668213964971, -0.31135486949417068, -0.31719128858910589, -0.32301571882570601, -0.32882794005836274, -0.33462773260293188, -0.34041487724503444, -0.3461891552483442, -0.35195034836285388, -0.35769823883312557, -0.36343260940651911, -0.3691532433414072, -0.37485992441536287, -0.38055243693333707, -0.38623056573580633, -0.39189409620690935, -0.39754281428255578, -0.40317650645851938, -0.408794959798506, -0.41439796194220352, -0.41998530111330723, -0.42555676612752458, -0.43111214640055795, -0.43665123195606392, -0.44217381343358819, -0.44767968209648107, -0.45316862983978584, -0.45864044919810493, -0.46409493335344015, -0.46953187614301223, -0.47495107206704995, -0.48035231629656183, -0.4857354046810729, -0.49110013375634509, -0.4964463007520647, -0.50177370359950857, -0.5070821409391808, -0.51237141212842352, -0.51764131724899998, -0.52289165711465191, -0.52812223327862795, -0.53333284804118419, -0.53852330445705532, -0.5436934063429012, -0.54884295828471885, -0.55397176564523276, -0.55907963457124621, -0.56416637200097308, -0.5692317856713317, -0.57427568412521401, -0.57929787671872079, -0.58429817362836844, -0.5892763858582617, -0.5942323252472399, -0.59916580447598666, -0.60407663707411174, -0.60896463742719653, -0.61382962078381298, -0.61867140326250303, -0.62348980185873337, -0.62828463445180716, -0.6330557198117519, -0.6378028776061665, -0.64252592840703937, -0.64722469369752911, -0.65189899587871247, -0.65654865827629583, -0.66117350514729478, -0.66577336168667522, -0.67034805403396169, -0.67489740927980679, -0.6794212554725293, -0.68391942162461028, -0.68839173771915996, -0.6928380347163392, -0.69725814455975266, -0.70165190018279777, -0.70601913551498163, -0.71035968548819683, -0.71467338604296105, -0.71896007413461638, -0.72321958773949468, -0.72745176586103955, -0.73165644853589207, -0.73583347683993661, -0.73998269289430874, -0.74410393987136036, -0.74819706200059111, -0.75226190457453113, -0.75629831395459302, -0.76030613757687548, -0.76428522395793208, -0.76823542270049594, -0.77215658449916424, -0.77604856114604126, -0.77991120553634119, -0.78374437167394717, -0.78754791467693031, -0.79132169078302472, -0.7950655573550629, -0.79877937288636469, -0.80246299700608903, -0.80611629048453581, -0.80973911523841147, -0.81333133433604599, -0.8168928120025698, -0.82042341362504512, -0.82392300575755417, -0.82739145612624221, -0.83082863363431825, -0.83423440836700946, -0.8376086515964718, -0.84095123578665465, -0.8442620345981231, -0.84754092289283089, -0.85078777673885309, -0.85400247341506696, -0.85718489141579368, -0.86033491045538824, -0.86345241147278773, -0.86653727663601066, -0.86958938934661101, -0.87260863424408419, -0.87559489721022921, -0.87854806537346053, -0.88146802711307481, -0.88435467206346929, -0.88720789111831455, -0.89002757643467667, -0.89281362143709475, -0.89556592082160857, -0.89828437055973898, -0.90096886790241903, -0.90361931138387908, -0.90623560082548038, -0.90881763733950294, -0.91136532333288134, -0.9138785625108955, -0.91635725988080885, -0.91880132175545981, -0.92121065575680139, -0.92358517081939495, -0.9259247771938498, -0.92822938645021758, -0.93049891148133312, -0.93273326650610799, -0.9349323670727715, -0.93709613006206383, -0.93922447369037709, -0.94131731751284708, -0.9433745824263926, -0.94539619067270697, -0.94738206584119544, -0.94933213287186502, -0.95124631805815973, -0.95312454904974775, -0.95496675485525517, -0.95677286584495025, -0.95854281375337413, -0.96027653168192206, -0.96197395410137099, -0.96363501685435693, -0.96525965715780004, -0.9668478136052775, -0.96839942616934394, -0.96991443620380113, -0.97139278644591398, -0.97283442101857565, -0.97423928543241844, -0.97560732658787452, -0.9769384927771817, -0.9782327336863389, -0.97949000039700751, -0.98071024538836005, -0.98189342253887657, -0.98303948712808775, -0.98414839583826574, -0.98522010675606064, -0.98625457937408501, -0.9872517745924454, -0.98821165472021921, -0.98913418347688054, -0.99001932599367015, -0.99086704881491472, -0.99167731989928998, -0.99245010862103311, -0.99318538577109949, -0.99388312355826691, -0.99454329561018584, -0.99516587697437653, -0.99575084411917214, -0.99629817493460782, -0.99680784873325645, -0.99727984625101107, -0.99771414964781235, -0.99811074250832332, -0.99846960984254973, -0.99879073808640628, -0.99907411510222999, -0.99931973017923825, -0.99952757403393411, -0.99969763881045715, -0.99982991808087995, -0.99992440684545181, -0.99998110153278685, -1.0, -1.0};
 
+/* Normalized biquad coefficients moving linearly, over `decimation` samples,
+ * toward the ones computed at the start of each segment. Used by the filters
+ * whose coefficients follow audio signals, when decimation is above 1, and
+ * over a whole buffer when they follow control-rate streams. */
+typedef struct {
+    int decimation;
+    int count;
+    int primed;
+    MYFLT b0, b1, b2, a1, a2;
+    MYFLT ib0, ib1, ib2, ia1, ia2;
+    MYFLT tb0, tb1, tb2, ta1, ta2; /* targets of the segment */
+} BiquadRamp;
+
+static void
+BiquadRamp_init(BiquadRamp *self, int decimation)
+{
+    self->decimation = decimation < 1 ? 1 : decimation;
+    self->count = self->primed = 0;
+}
+
+static void
+BiquadRamp_setSegment(BiquadRamp *self, int num, MYFLT b0, MYFLT b1, MYFLT b2, MYFLT a0, MYFLT a1, MYFLT a2)
+{
+    MYFLT inv = 1.0 / a0, scl = 1.0 / num;
+
+    b0 *= inv; b1 *= inv; b2 *= inv; a1 *= inv; a2 *= inv;
+    if (self->primed == 0) {
+        self->b0 = b0; self->b1 = b1; self->b2 = b2; self->a1 = a1; self->a2 = a2;
+        self->primed = 1;
+    }
+    self->ib0 = (b0 - self->b0) * scl;
+    self->ib1 = (b1 - self->b1) * scl;
+    self->ib2 = (b2 - self->b2) * scl;
+    self->ia1 = (a1 - self->a1) * scl;
+    self->ia2 = (a2 - self->a2) * scl;
+    self->tb0 = b0; self->tb1 = b1; self->tb2 = b2; self->ta1 = a1; self->ta2 = a2;
+    self->count = num;
+}
+
+static void
+BiquadRamp_setTarget(BiquadRamp *self, MYFLT b0, MYFLT b1, MYFLT b2, MYFLT a0, MYFLT a1, MYFLT a2)
+{
+    BiquadRamp_setSegment(self, self->decimation, b0, b1, b2, a0, a1, a2);
+}
+
+/* The parameters of a filter, `mode` 0 for a float, are floats or
+ * control-rate streams, at least one of them a stream. */
+#define CONTROL_RATE_PARAM(mode, stream) ((mode) == 0 || Stream_isControlRate(stream))
+#define BIQUAD_CONTROL_RATE(self) \
+    (((self)->modebuffer[2] || (self)->modebuffer[3]) && \
+     CONTROL_RATE_PARAM((self)->modebuffer[2], (self)->freq_stream) && \
+     CONTROL_RATE_PARAM((self)->modebuffer[3], (self)->q_stream))
+
+/* The parameters are floats or constant streams, at least one of them a
+ * stream. PARAM_VALUE gives the value of such a parameter. */
+#define CONSTANT_PARAM(mode, stream) ((mode) == 0 || Stream_isConstant(stream))
+#define PARAM_VALUE(mode, obj, stream) ((mode) == 0 ? PyFloat_AS_DOUBLE(obj) : Stream_getData((Stream *)(stream))[0])
+#define BIQUAD_CONSTANT(self) \
+    (((self)->modebuffer[2] || (self)->modebuffer[3]) && \
+     CONSTANT_PARAM((self)->modebuffer[2], (self)->freq_stream) && \
+     CONSTANT_PARAM((self)->modebuffer[3], (self)->q_stream))
+
+/* The input is a constant zero, the filter output is zero as long as its
+ * memories are (or will be set from the input by init). */
+#define ZERO_INPUT(self) \
+    (Stream_isConstant((self)->input_stream) && Stream_getData((Stream *)(self)->input_stream)[0] == 0.0)
+#define BIQUAD_AT_REST(self) \
+    (ZERO_INPUT(self) && ((self)->init == 1 || \
+     ((self)->x1 == 0.0 && (self)->x2 == 0.0 && (self)->y1 == 0.0 && (self)->y2 == 0.0)))
+
+static inline void
+BiquadRamp_step(BiquadRamp *self)
+{
+    self->b0 += self->ib0;
+    self->b1 += self->ib1;
+    self->b2 += self->ib2;
+    self->a1 += self->ia1;
+    self->a2 += self->ia2;
+    self->count--;
+}
+
+/* Over a whole buffer, the rounding errors of the steps pile up enough to
+ * push the poles of low filters out of the unit circle in single precision.
+ * The segment is then read `k` samples from its start, coefficients in the
+ * order b0, b1, b2, a1, a2, and once done the ramp jumps to its targets. */
+static inline void
+BiquadRamp_at(BiquadRamp *self, MYFLT k, MYFLT *c)
+{
+    c[0] = self->b0 + self->ib0 * k;
+    c[1] = self->b1 + self->ib1 * k;
+    c[2] = self->b2 + self->ib2 * k;
+    c[3] = self->a1 + self->ia1 * k;
+    c[4] = self->a2 + self->ia2 * k;
+}
+
+static void
+BiquadRamp_end(BiquadRamp *self)
+{
+    self->b0 = self->tb0; self->b1 = self->tb1; self->b2 = self->tb2; self->a1 = self->ta1; self->a2 = self->ta2;
+    self->count = 0;
+}
+
+/* sin and cos of 2 * pi * x from the polynomial sine kernel. The cosine comes
+ * from the half angle, so 1 - cos keeps its precision at low frequencies. */
+static void
+fast_sincos(MYFLT x, MYFLT *s, MYFLT *c)
+{
+    MYFLT h = SineKernel_sample(x * 0.5, SINE_ACCURACY_HIGH);
+    *s = SineKernel_sample(x, SINE_ACCURACY_HIGH);
+    *c = 1.0 - 2.0 * h * h;
+}
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *input;
@@ -57,6 +171,7 @@ typedef struct {
     MYFLT a0;
     MYFLT a1;
     MYFLT a2;
+    BiquadRamp ramp;
 } Biquad;
 
 static void
@@ -125,6 +240,23 @@ Biquad_compute_variables(Biquad *self, MYFLT freq, MYFLT q)
     (*self->coeffs_func_ptr)(self);
 }
 
+static void
+Biquad_compute_variables_fast(Biquad *self, MYFLT freq, MYFLT q)
+{
+    MYFLT s;
+
+    if (freq <= 1)
+        freq = 1;
+    else if (freq >= self->nyquist)
+        freq = self->nyquist;
+    if (q < 0.1)
+        q = 0.1;
+
+    fast_sincos(freq / self->sr, &s, &self->c);
+    self->alpha = s / (2 * q);
+    (*self->coeffs_func_ptr)(self);
+}
+
 static void
 Biquad_filters_ii(Biquad *self) {
     MYFLT val;
@@ -221,6 +353,81 @@ Biquad_filters_aa(Biquad *self) {
     }
 }
 
+/* freq and/or q are audio signals, with the coefficients computed every
+ * `decimation` samples and interpolated in between. */
+static void
+Biquad_filters_decim(Biquad *self) {
+    MYFLT val, fr = 0.0, q = 0.0;
+    int i;
+    MYFLT *frst = NULL, *qst = NULL;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        self->x1 = self->x2 = self->y1 = self->y2 = in[0];
+        self->init = 0;
+    }
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        frst = Stream_getData((Stream *)self->freq_stream);
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        qst = Stream_getData((Stream *)self->q_stream);
+
+    for (i=0; i<self->bufsize; i++) {
+        if (self->ramp.count == 0) {
+            Biquad_compute_variables_fast(self, frst ? frst[i] : fr, qst ? qst[i] : q);
+            BiquadRamp_setTarget(&self->ramp, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
+        }
+        BiquadRamp_step(&self->ramp);
+        val = (self->ramp.b0 * in[i]) + (self->ramp.b1 * self->x1) + (self->ramp.b2 * self->x2) - (self->ramp.a1 * self->y1) - (self->ramp.a2 * self->y2);
+        self->y2 = self->y1;
+        self->y1 = val;
+        self->x2 = self->x1;
+        self->x1 = in[i];
+        self->data[i] = val;
+    }
+}
+
+/* freq and q are control-rate streams, with the coefficients computed from
+ * their last samples and interpolated over the buffer. */
+static void
+Biquad_filters_krate(Biquad *self) {
+    MYFLT val, fr, q, c[5];
+    int i;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        self->x1 = self->x2 = self->y1 = self->y2 = in[0];
+        self->init = 0;
+    }
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        fr = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        q = Stream_getData((Stream *)self->q_stream)[self->bufsize-1];
+
+    Biquad_compute_variables_fast(self, fr, q);
+    BiquadRamp_setSegment(&self->ramp, self->bufsize, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
+
+    for (i=0; i<self->bufsize; i++) {
+        BiquadRamp_at(&self->ramp, (MYFLT)(i + 1), c);
+        val = (c[0] * in[i]) + (c[1] * self->x1) + (c[2] * self->x2) - (c[3] * self->y1) - (c[4] * self->y2);
+        self->y2 = self->y1;
+        self->y1 = val;
+        self->x2 = self->x1;
+        self->x1 = in[i];
+        self->data[i] = val;
+    }
+    BiquadRamp_end(&self->ramp);
+}
+
 static void Biquad_postprocessing_ii(Biquad *self) { POST_PROCESSING_II };
 static void Biquad_postprocessing_ai(Biquad *self) { POST_PROCESSING_AI };
 static void Biquad_postprocessing_ia(Biquad *self) { POST_PROCESSING_IA };
@@ -270,6 +477,10 @@ Biquad_setProcMode(Biquad *self)
         case 11:
             self->proc_func_ptr = Biquad_filters_aa;
             break;
+    }
+    if (procmode != 0 && self->ramp.decimation > 1) {
+        self->proc_func_ptr = Biquad_filters_decim;
+        self->ramp.count = 0;
     }
 	switch (muladdmode) {
         case 0:
@@ -305,7 +516,27 @@ Biquad_setProcMode(Biquad *self)
 static void
 Biquad_compute_next_data_frame(Biquad *self)
 {
-    (*self->proc_func_ptr)(self);
+    if (BIQUAD_AT_REST(self)) {
+        self->x1 = self->x2 = self->y1 = self->y2 = 0.0;
+        self->init = 0;
+        pyo_fill(self->data, 0.0, self->bufsize);
+        Stream_setConstant(self->stream, 1);
+    }
+    else if (BIQUAD_CONSTANT(self)) {
+        /* Same coefficients as computed per sample by the audio-rate modes. */
+        Biquad_compute_variables(self, PARAM_VALUE(self->modebuffer[2], self->freq, self->freq_stream),
+                                 PARAM_VALUE(self->modebuffer[3], self->q, self->q_stream));
+        self->ramp.primed = 0;
+        Biquad_filters_ii(self);
+    }
+    else if (BIQUAD_CONTROL_RATE(self))
+        Biquad_filters_krate(self);
+    else {
+        /* the ramp starts again from the targets when the streams go back to control-rate */
+        if (self->proc_func_ptr != Biquad_filters_decim)
+            self->ramp.primed = 0;
+        (*self->proc_func_ptr)(self);
+    }
     (*self->muladd_func_ptr)(self);
 }
 
@@ -346,7 +577,7 @@ Biquad_dealloc(Biquad* self)
 static PyObject *
 Biquad_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, decimation = 1;
     PyObject *inputtmp, *input_streamtmp, *freqtmp=NULL, *qtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Biquad *self;
     self = (Biquad *)type->tp_alloc(type, 0);
@@ -359,6 +590,7 @@ Biquad_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
     self->init = 1;
+    BiquadRamp_init(&self->ramp, 1);
 
     INIT_OBJECT_COMMON
 
@@ -367,13 +599,15 @@ Biquad_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, Biquad_compute_next_data_frame);
     self->mode_func_ptr = Biquad_setProcMode;
 
-    static char *kwlist[] = {"input", "freq", "q", "type", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "freq", "q", "type", "mul", "add", "decimation", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOO", kwlist, &inputtmp, &freqtmp, &qtmp, &self->filtertype, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiOOi", kwlist, &inputtmp, &freqtmp, &qtmp, &self->filtertype, &multmp, &addtmp, &decimation))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
 
+    BiquadRamp_init(&self->ramp, decimation);
+
     if (freqtmp) {
         PyObject_CallMethod((PyObject *)self, "setFreq", "O", freqtmp);
     }
@@ -392,6 +626,8 @@ Biquad_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -506,6 +742,27 @@ Biquad_setType(Biquad *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Biquad_setDecimation(Biquad *self, PyObject *arg)
+{
+
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isInt = PyInt_Check(arg);
+
+	if (isInt == 1) {
+		BiquadRamp_init(&self->ramp, PyInt_AsLong(arg));
+	}
+
+    (*self->mode_func_ptr)(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyMemberDef Biquad_members[] = {
     {"server", T_OBJECT_EX, offsetof(Biquad, server), 0, "Pyo server."},
     {"stream", T_OBJECT_EX, offsetof(Biquad, stream), 0, "Stream object."},
@@ -526,6 +783,7 @@ static PyMethodDef Biquad_methods[] = {
 	{"setFreq", (PyCFunction)Biquad_setFreq, METH_O, "Sets filter cutoff frequency in cycle per second."},
     {"setQ", (PyCFunction)Biquad_setQ, METH_O, "Sets filter Q factor."},
     {"setType", (PyCFunction)Biquad_setType, METH_O, "Sets filter type factor."},
+    {"setDecimation", (PyCFunction)Biquad_setDecimation, METH_O, "Sets the coefficients update period for audio rate freq and q."},
 	{"setMul", (PyCFunction)Biquad_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Biquad_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Biquad_setSub, METH_O, "Sets inverse add factor."},
@@ -617,6 +875,445 @@ PyTypeObject BiquadType = {
     Biquad_new,                                     /* tp_new */
 };
 
+/*******************************************/
+/* MultiBiquadMain, read by PackedChannel  */
+/*******************************************/
+/* MultiBiquadMain filters all the channels of a Biquad in one object, in a
+ * packed stream. The filters run side by side in the SIMD lanes. When freq
+ * or q are audio signals, the coefficients of all the channels are updated
+ * every `decimation` samples. */
+typedef struct {
+    pyo_audio_HEAD
+    int chnls;
+    PyObject *input; /* list of streams, one per channel */
+    PyObject *freq; /* list of streams or None, one per channel */
+    PyObject *q;
+    Stream **input_streams; /* borrowed from the lists, NULL for a float */
+    Stream **freq_streams;
+    Stream **q_streams;
+    MYFLT *freqs;
+    MYFLT *qs;
+    int *types;
+    int decimation;
+    int count; /* samples left in the current segment */
+    int primed;
+    int modulated; /* freq or q of a channel is an audio signal */
+    int init;
+    MYFLT nyquist;
+    PackedBiquad *biquad;
+    MYFLT **ins;
+    MYFLT **outs;
+} MultiBiquadMain;
+
+/* Coefficients of channel `chnl` in `co`, b0, b1, b2, a0, a1, a2. */
+static inline void
+MultiBiquadMain_compute_coeffs(MultiBiquadMain *self, int chnl, MYFLT freq, MYFLT q, MYFLT *co)
+{
+    MYFLT w0, c, s, alpha, b0, b1, b2, a0, a1, a2;
+
+    if (freq <= 1)
+        freq = 1;
+    else if (freq >= self->nyquist)
+        freq = self->nyquist;
+    if (q < 0.1)
+        q = 0.1;
+
+    if (self->decimation > 1)
+        fast_sincos(freq / self->sr, &s, &c);
+    else {
+        w0 = TWOPI * freq / self->sr;
+        c = MYCOS(w0);
+        s = MYSIN(w0);
+    }
+    alpha = s / (2 * q);
+
+    a0 = 1 + alpha;
+    a1 = -2 * c;
+    a2 = 1 - alpha;
+    switch (self->types[chnl]) {
+        case 1:
+            b0 = b2 = (1 + c) / 2;
+            b1 = -(1 + c);
+            break;
+        case 2:
+            b0 = alpha;
+            b1 = 0;
+            b2 = -alpha;
+            break;
+        case 3:
+            b0 = b2 = 1;
+            b1 = a1;
+            break;
+        case 4:
+            b0 = a2;
+            b1 = a1;
+            b2 = a0;
+            break;
+        default:
+            b0 = b2 = (1 - c) / 2;
+            b1 = 1 - c;
+            break;
+    }
+    co[0] = b0; co[1] = b1; co[2] = b2; co[3] = a0; co[4] = a1; co[5] = a2;
+}
+
+static void
+MultiBiquadMain_set_coeffs(MultiBiquadMain *self, int chnl, MYFLT freq, MYFLT q, int num)
+{
+    MYFLT co[6];
+
+    MultiBiquadMain_compute_coeffs(self, chnl, freq, q, co);
+    PackedBiquad_setCoeffs(self->biquad, chnl, co[0], co[1], co[2], co[3], co[4], co[5], num);
+}
+
+/* Decimation 1 with audio rate freq or q, one channel after the other. The
+ * modulated channels compute their coefficients at every sample, as Biquad
+ * does. */
+static void
+MultiBiquadMain_filters_exact(MultiBiquadMain *self)
+{
+    int i, j, p = self->biquad->pchnls;
+    MYFLT val, x1, x2, y1, y2, co[6], *fr, *qst, *in, *out;
+    MYFLT *st = self->biquad->state, *cf = self->biquad->coeffs;
+
+    for (j=0; j<self->chnls; j++) {
+        in = self->ins[j];
+        out = self->outs[j];
+        x1 = st[j]; x2 = st[p+j]; y1 = st[2*p+j]; y2 = st[3*p+j];
+        if (self->freq_streams[j] == NULL && self->q_streams[j] == NULL) {
+            for (i=0; i<self->bufsize; i++) {
+                val = (cf[j] * in[i]) + (cf[p+j] * x1) + (cf[2*p+j] * x2) - (cf[3*p+j] * y1) - (cf[4*p+j] * y2);
+                y2 = y1;
+                y1 = val;
+                x2 = x1;
+                x1 = in[i];
+                out[i] = val;
+            }
+        }
+        else {
+            fr = self->freq_streams[j] == NULL ? NULL : Stream_getData(self->freq_streams[j]);
+            qst = self->q_streams[j] == NULL ? NULL : Stream_getData(self->q_streams[j]);
+            for (i=0; i<self->bufsize; i++) {
+                MultiBiquadMain_compute_coeffs(self, j, fr ? fr[i] : self->freqs[j], qst ? qst[i] : self->qs[j], co);
+                val = ( (co[0] * in[i]) + (co[1] * x1) + (co[2] * x2) - (co[4] * y1) - (co[5] * y2) ) / co[3];
+                y2 = y1;
+                y1 = val;
+                x2 = x1;
+                x1 = in[i];
+                out[i] = val;
+            }
+        }
+        st[j] = x1; st[p+j] = x2; st[2*p+j] = y1; st[3*p+j] = y2;
+    }
+}
+
+/* Called by the setters, the channels with constant freq and q get their
+ * coefficients at once. */
+static void
+MultiBiquadMain_update(MultiBiquadMain *self)
+{
+    int j;
+
+    self->modulated = 0;
+    for (j=0; j<self->chnls; j++) {
+        if (self->freq_streams[j] != NULL || self->q_streams[j] != NULL)
+            self->modulated = 1;
+        else
+            MultiBiquadMain_set_coeffs(self, j, self->freqs[j], self->qs[j], 0);
+    }
+    self->count = 0;
+}
+
+static void
+MultiBiquadMain_compute_next_data_frame(MultiBiquadMain *self)
+{
+    int i, j, n, num;
+    MYFLT fr, q;
+
+    for (j=0; j<self->chnls; j++) {
+        self->ins[j] = Stream_getData(self->input_streams[j]);
+        self->outs[j] = self->data + j * self->bufsize;
+    }
+
+    if (self->init == 1) {
+        PackedBiquad_prime(self->biquad, self->ins);
+        self->init = 0;
+    }
+
+    if (self->modulated == 0) {
+        PackedBiquad_process(self->biquad, self->ins, self->outs, self->bufsize);
+        return;
+    }
+    else if (self->decimation == 1) {
+        MultiBiquadMain_filters_exact(self);
+        return;
+    }
+
+    for (i=0; i<self->bufsize; i+=n) {
+        if (self->count == 0) {
+            num = self->primed ? self->decimation : 0;
+            for (j=0; j<self->chnls; j++) {
+                if (self->freq_streams[j] == NULL && self->q_streams[j] == NULL)
+                    continue;
+                fr = self->freq_streams[j] == NULL ? self->freqs[j] : Stream_getData(self->freq_streams[j])[i];
+                q = self->q_streams[j] == NULL ? self->qs[j] : Stream_getData(self->q_streams[j])[i];
+                MultiBiquadMain_set_coeffs(self, j, fr, q, num);
+            }
+            self->primed = 1;
+            self->count = self->decimation;
+        }
+        n = self->bufsize - i < self->count ? self->bufsize - i : self->count;
+        if (i > 0) {
+            for (j=0; j<self->chnls; j++) {
+                self->ins[j] = Stream_getData(self->input_streams[j]) + i;
+                self->outs[j] = self->data + j * self->bufsize + i;
+            }
+        }
+        PackedBiquad_process(self->biquad, self->ins, self->outs, n);
+        self->count -= n;
+    }
+}
+
+static void
+MultiBiquadMain_setProcMode(MultiBiquadMain *self) {}
+
+static int
+MultiBiquadMain_traverse(MultiBiquadMain *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->input);
+    Py_VISIT(self->freq);
+    Py_VISIT(self->q);
+    return 0;
+}
+
+static int
+MultiBiquadMain_clear(MultiBiquadMain *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->input);
+    Py_CLEAR(self->freq);
+    Py_CLEAR(self->q);
+    return 0;
+}
+
+static void
+MultiBiquadMain_dealloc(MultiBiquadMain* self)
+{
+    pyo_DEALLOC
+    free(self->input_streams);
+    free(self->freq_streams);
+    free(self->q_streams);
+    free(self->freqs);
+    free(self->qs);
+    free(self->types);
+    free(self->ins);
+    free(self->outs);
+    PackedBiquad_free(self->biquad);
+    MultiBiquadMain_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+MultiBiquadMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i;
+    PyObject *inputtmp=NULL, *freqtmp=NULL, *qtmp=NULL, *typetmp=NULL, *res;
+    MultiBiquadMain *self;
+    self = (MultiBiquadMain *)type->tp_alloc(type, 0);
+
+    self->chnls = 1;
+    self->decimation = 1;
+    self->init = 1;
+
+    INIT_OBJECT_COMMON
+
+    self->nyquist = (MYFLT)self->sr * 0.49;
+
+    Stream_setFunctionPtr(self->stream, MultiBiquadMain_compute_next_data_frame);
+    self->mode_func_ptr = MultiBiquadMain_setProcMode;
+
+    static char *kwlist[] = {"chnls", "input", "freq", "q", "type", "decimation", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "iOOOO|i", kwlist, &self->chnls, &inputtmp, &freqtmp, &qtmp, &typetmp, &self->decimation))
+        Py_RETURN_NONE;
+
+    if (self->chnls < 1)
+        self->chnls = 1;
+    if (self->decimation < 1)
+        self->decimation = 1;
+
+    self->input_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->freq_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->q_streams = (Stream **)calloc(self->chnls, sizeof(Stream *));
+    self->freqs = (MYFLT *)calloc(self->chnls, sizeof(MYFLT));
+    self->qs = (MYFLT *)calloc(self->chnls, sizeof(MYFLT));
+    self->types = (int *)calloc(self->chnls, sizeof(int));
+    self->ins = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->outs = (MYFLT **)calloc(self->chnls, sizeof(MYFLT *));
+    self->biquad = PackedBiquad_new(self->chnls);
+    INIT_PACKED_STREAM(self->chnls)
+
+    if (Packed_setValues(inputtmp, self->chnls, &self->input, NULL, self->input_streams) < 0 ||
+        Packed_setValues(freqtmp, self->chnls, &self->freq, self->freqs, self->freq_streams) < 0 ||
+        Packed_setValues(qtmp, self->chnls, &self->q, self->qs, self->q_streams) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    res = PyObject_CallMethod((PyObject *)self, "setType", "O", typetmp);
+    if (res == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    Py_DECREF(res);
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    return (PyObject *)self;
+}
+
+static PyObject * MultiBiquadMain_getServer(MultiBiquadMain* self) { GET_SERVER };
+static PyObject * MultiBiquadMain_getStream(MultiBiquadMain* self) { GET_STREAM };
+
+static PyObject * MultiBiquadMain_play(MultiBiquadMain *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * MultiBiquadMain_stop(MultiBiquadMain *self) { STOP_PACKED(self->chnls) };
+
+static PyObject *
+MultiBiquadMain_setInput(MultiBiquadMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->chnls, &self->input, NULL, self->input_streams) < 0)
+        return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+MultiBiquadMain_setFreq(MultiBiquadMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->chnls, &self->freq, self->freqs, self->freq_streams) < 0)
+        return NULL;
+    MultiBiquadMain_update(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+MultiBiquadMain_setQ(MultiBiquadMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->chnls, &self->q, self->qs, self->q_streams) < 0)
+        return NULL;
+    MultiBiquadMain_update(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+MultiBiquadMain_setType(MultiBiquadMain *self, PyObject *arg)
+{
+    int i, size, type;
+
+    if (! PyList_Check(arg) || PyList_Size(arg) == 0) {
+        PyErr_SetString(PyExc_TypeError, "type must be a non-empty list of ints.");
+        return NULL;
+    }
+
+    size = PyList_Size(arg);
+    for (i=0; i<self->chnls; i++) {
+        type = PyInt_AsLong(PyList_GET_ITEM(arg, i % size));
+        self->types[i] = (type < 0 || type > 4) ? 0 : type;
+    }
+    PyErr_Clear();
+    MultiBiquadMain_update(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyObject *
+MultiBiquadMain_setDecimation(MultiBiquadMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	if (PyInt_Check(arg) == 1) {
+        self->decimation = PyInt_AsLong(arg);
+        if (self->decimation < 1)
+            self->decimation = 1;
+        self->primed = 0;
+        MultiBiquadMain_update(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
+static PyMemberDef MultiBiquadMain_members[] = {
+{"server", T_OBJECT_EX, offsetof(MultiBiquadMain, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(MultiBiquadMain, stream), 0, "Stream object."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef MultiBiquadMain_methods[] = {
+{"getServer", (PyCFunction)MultiBiquadMain_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)MultiBiquadMain_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)MultiBiquadMain_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)MultiBiquadMain_stop, METH_NOARGS, "Stops computing."},
+{"setInput", (PyCFunction)MultiBiquadMain_setInput, METH_O, "Sets the inputs of the channels, a list of PyoObjects."},
+{"setFreq", (PyCFunction)MultiBiquadMain_setFreq, METH_O, "Sets the cutoff frequencies of the channels, a list of floats or PyoObjects."},
+{"setQ", (PyCFunction)MultiBiquadMain_setQ, METH_O, "Sets the Q factors of the channels, a list of floats or PyoObjects."},
+{"setType", (PyCFunction)MultiBiquadMain_setType, METH_O, "Sets the filter types of the channels, a list of ints."},
+{"setDecimation", (PyCFunction)MultiBiquadMain_setDecimation, METH_O, "Sets the coefficients update period for audio rate freq and q."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject MultiBiquadMainType = {
+PyObject_HEAD_INIT(NULL)
+0,                         /*ob_size*/
+"_pyo.MultiBiquadMain_base",         /*tp_name*/
+sizeof(MultiBiquadMain),         /*tp_basicsize*/
+0,                         /*tp_itemsize*/
+(destructor)MultiBiquadMain_dealloc, /*tp_dealloc*/
+0,                         /*tp_print*/
+0,                         /*tp_getattr*/
+0,                         /*tp_setattr*/
+0,                         /*tp_compare*/
+0,                         /*tp_repr*/
+0,             /*tp_as_number*/
+0,                         /*tp_as_sequence*/
+0,                         /*tp_as_mapping*/
+0,                         /*tp_hash */
+0,                         /*tp_call*/
+0,                         /*tp_str*/
+0,                         /*tp_getattro*/
+0,                         /*tp_setattro*/
+0,                         /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+"MultiBiquadMain objects. Filters the channels of a Biquad.",           /* tp_doc */
+(traverseproc)MultiBiquadMain_traverse,   /* tp_traverse */
+(inquiry)MultiBiquadMain_clear,           /* tp_clear */
+0,		               /* tp_richcompare */
+0,		               /* tp_weaklistoffset */
+0,		               /* tp_iter */
+0,		               /* tp_iternext */
+MultiBiquadMain_methods,             /* tp_methods */
+MultiBiquadMain_members,             /* tp_members */
+0,                      /* tp_getset */
+0,                         /* tp_base */
+0,                         /* tp_dict */
+0,                         /* tp_descr_get */
+0,                         /* tp_descr_set */
+0,                         /* tp_dictoffset */
+0,      /* tp_init */
+0,                         /* tp_alloc */
+MultiBiquadMain_new,                 /* tp_new */
+};
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *input;
@@ -647,6 +1344,7 @@ typedef struct {
     MYFLT a0;
     MYFLT a1;
     MYFLT a2;
+    BiquadRamp ramp;
 } Biquadx;
 
 static void
@@ -726,8 +1424,83 @@ Biquadx_compute_variables(Biquadx *self, MYFLT freq, MYFLT q)
 }
 
 static void
-Biquadx_filters_ii(Biquadx *self) {
-    MYFLT vin, vout;
+Biquadx_compute_variables_fast(Biquadx *self, MYFLT freq, MYFLT q)
+{
+    MYFLT s;
+
+    if (freq <= 1)
+        freq = 1;
+    else if (freq >= self->nyquist)
+        freq = self->nyquist;
+    if (q < 0.1)
+        q = 0.1;
+
+    fast_sincos(freq / self->sr, &s, &self->c);
+    self->alpha = s / (2 * q);
+    (*self->coeffs_func_ptr)(self);
+}
+
+static void
+Biquadx_filters_ii(Biquadx *self) {
+    MYFLT vin, vout;
+    int i, j;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        for (i=0; i<self->stages; i++) {
+            self->x1[i] = self->x2[i] = self->y1[i] = self->y2[i] = in[0];
+        }
+        self->init = 0;
+    }
+
+    vout = 0.0;
+    for (i=0; i<self->bufsize; i++) {
+        vin = in[i];
+        for (j=0; j<self->stages; j++) {
+            vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
+            self->x2[j] = self->x1[j];
+            self->x1[j] = vin;
+            self->y2[j] = self->y1[j];
+            self->y1[j] = vin = vout;
+        }
+        self->data[i] = vout;
+    }
+}
+
+static void
+Biquadx_filters_ai(Biquadx *self) {
+    MYFLT vin, vout, q;
+    int i, j;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        for (i=0; i<self->stages; i++) {
+            self->x1[i] = self->x2[i] = self->y1[i] = self->y2[i] = in[0];
+        }
+        self->init = 0;
+    }
+
+    MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    q = PyFloat_AS_DOUBLE(self->q);
+
+    vout = 0.0;
+    for (i=0; i<self->bufsize; i++) {
+        Biquadx_compute_variables(self, fr[i], q);
+        vin = in[i];
+        for (j=0; j<self->stages; j++) {
+            vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
+            self->x2[j] = self->x1[j];
+            self->x1[j] = vin;
+            self->y2[j] = self->y1[j];
+            self->y1[j] = vin = vout;
+        }
+        self->data[i] = vout;
+    }
+}
+
+static void
+Biquadx_filters_ia(Biquadx *self) {
+    MYFLT vin, vout, fr;
     int i, j;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
@@ -738,8 +1511,12 @@ Biquadx_filters_ii(Biquadx *self) {
         self->init = 0;
     }
 
+    fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *q = Stream_getData((Stream *)self->q_stream);
+
     vout = 0.0;
     for (i=0; i<self->bufsize; i++) {
+        Biquadx_compute_variables(self, fr, q[i]);
         vin = in[i];
         for (j=0; j<self->stages; j++) {
             vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
@@ -753,8 +1530,8 @@ Biquadx_filters_ii(Biquadx *self) {
 }
 
 static void
-Biquadx_filters_ai(Biquadx *self) {
-    MYFLT vin, vout, q;
+Biquadx_filters_aa(Biquadx *self) {
+    MYFLT vin, vout;
     int i, j;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
@@ -766,11 +1543,11 @@ Biquadx_filters_ai(Biquadx *self) {
     }
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
-    q = PyFloat_AS_DOUBLE(self->q);
+    MYFLT *q = Stream_getData((Stream *)self->q_stream);
 
     vout = 0.0;
     for (i=0; i<self->bufsize; i++) {
-        Biquadx_compute_variables(self, fr[i], q);
+        Biquadx_compute_variables(self, fr[i], q[i]);
         vin = in[i];
         for (j=0; j<self->stages; j++) {
             vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
@@ -783,10 +1560,13 @@ Biquadx_filters_ai(Biquadx *self) {
     }
 }
 
+/* freq and/or q are audio signals, with the coefficients computed every
+ * `decimation` samples and interpolated in between. */
 static void
-Biquadx_filters_ia(Biquadx *self) {
-    MYFLT vin, vout, fr;
+Biquadx_filters_decim(Biquadx *self) {
+    MYFLT vin, vout, fr = 0.0, q = 0.0;
     int i, j;
+    MYFLT *frst = NULL, *qst = NULL;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     if (self->init == 1) {
@@ -796,15 +1576,25 @@ Biquadx_filters_ia(Biquadx *self) {
         self->init = 0;
     }
 
-    fr = PyFloat_AS_DOUBLE(self->freq);
-    MYFLT *q = Stream_getData((Stream *)self->q_stream);
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        frst = Stream_getData((Stream *)self->freq_stream);
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        qst = Stream_getData((Stream *)self->q_stream);
 
     vout = 0.0;
     for (i=0; i<self->bufsize; i++) {
-        Biquadx_compute_variables(self, fr, q[i]);
+        if (self->ramp.count == 0) {
+            Biquadx_compute_variables_fast(self, frst ? frst[i] : fr, qst ? qst[i] : q);
+            BiquadRamp_setTarget(&self->ramp, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
+        }
+        BiquadRamp_step(&self->ramp);
         vin = in[i];
         for (j=0; j<self->stages; j++) {
-            vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
+            vout = (self->ramp.b0 * vin) + (self->ramp.b1 * self->x1[j]) + (self->ramp.b2 * self->x2[j]) - (self->ramp.a1 * self->y1[j]) - (self->ramp.a2 * self->y2[j]);
             self->x2[j] = self->x1[j];
             self->x1[j] = vin;
             self->y2[j] = self->y1[j];
@@ -814,9 +1604,11 @@ Biquadx_filters_ia(Biquadx *self) {
     }
 }
 
+/* freq and q are control-rate streams, with the coefficients computed from
+ * their last samples and interpolated over the buffer. */
 static void
-Biquadx_filters_aa(Biquadx *self) {
-    MYFLT vin, vout;
+Biquadx_filters_krate(Biquadx *self) {
+    MYFLT vin, vout, fr, q, c[5];
     int i, j;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
@@ -827,15 +1619,24 @@ Biquadx_filters_aa(Biquadx *self) {
         self->init = 0;
     }
 
-    MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
-    MYFLT *q = Stream_getData((Stream *)self->q_stream);
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        fr = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        q = Stream_getData((Stream *)self->q_stream)[self->bufsize-1];
+
+    Biquadx_compute_variables_fast(self, fr, q);
+    BiquadRamp_setSegment(&self->ramp, self->bufsize, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
 
     vout = 0.0;
     for (i=0; i<self->bufsize; i++) {
-        Biquadx_compute_variables(self, fr[i], q[i]);
+        BiquadRamp_at(&self->ramp, (MYFLT)(i + 1), c);
         vin = in[i];
         for (j=0; j<self->stages; j++) {
-            vout = ( (self->b0 * vin) + (self->b1 * self->x1[j]) + (self->b2 * self->x2[j]) - (self->a1 * self->y1[j]) - (self->a2 * self->y2[j]) ) / self->a0;
+            vout = (c[0] * vin) + (c[1] * self->x1[j]) + (c[2] * self->x2[j]) - (c[3] * self->y1[j]) - (c[4] * self->y2[j]);
             self->x2[j] = self->x1[j];
             self->x1[j] = vin;
             self->y2[j] = self->y1[j];
@@ -843,6 +1644,7 @@ Biquadx_filters_aa(Biquadx *self) {
         }
         self->data[i] = vout;
     }
+    BiquadRamp_end(&self->ramp);
 }
 
 static void Biquadx_postprocessing_ii(Biquadx *self) { POST_PROCESSING_II };
@@ -894,6 +1696,10 @@ Biquadx_setProcMode(Biquadx *self)
         case 11:
             self->proc_func_ptr = Biquadx_filters_aa;
             break;
+    }
+    if (procmode != 0 && self->ramp.decimation > 1) {
+        self->proc_func_ptr = Biquadx_filters_decim;
+        self->ramp.count = 0;
     }
 	switch (muladdmode) {
         case 0:
@@ -926,10 +1732,48 @@ Biquadx_setProcMode(Biquadx *self)
     }
 }
 
+static int
+Biquadx_isAtRest(Biquadx *self)
+{
+    int j;
+
+    if (!ZERO_INPUT(self))
+        return 0;
+    if (self->init == 1)
+        return 1;
+    for (j=0; j<self->stages; j++) {
+        if (self->x1[j] != 0.0 || self->x2[j] != 0.0 || self->y1[j] != 0.0 || self->y2[j] != 0.0)
+            return 0;
+    }
+    return 1;
+}
+
 static void
 Biquadx_compute_next_data_frame(Biquadx *self)
 {
-    (*self->proc_func_ptr)(self);
+    int j;
+
+    if (Biquadx_isAtRest(self)) {
+        for (j=0; j<self->stages; j++) {
+            self->x1[j] = self->x2[j] = self->y1[j] = self->y2[j] = 0.0;
+        }
+        self->init = 0;
+        pyo_fill(self->data, 0.0, self->bufsize);
+        Stream_setConstant(self->stream, 1);
+    }
+    else if (BIQUAD_CONSTANT(self)) {
+        Biquadx_compute_variables(self, PARAM_VALUE(self->modebuffer[2], self->freq, self->freq_stream),
+                                  PARAM_VALUE(self->modebuffer[3], self->q, self->q_stream));
+        self->ramp.primed = 0;
+        Biquadx_filters_ii(self);
+    }
+    else if (BIQUAD_CONTROL_RATE(self))
+        Biquadx_filters_krate(self);
+    else {
+        if (self->proc_func_ptr != Biquadx_filters_decim)
+            self->ramp.primed = 0;
+        (*self->proc_func_ptr)(self);
+    }
     (*self->muladd_func_ptr)(self);
 }
 
@@ -974,7 +1818,7 @@ Biquadx_dealloc(Biquadx* self)
 static PyObject *
 Biquadx_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, decimation = 1;
     PyObject *inputtmp, *input_streamtmp, *freqtmp=NULL, *qtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Biquadx *self;
     self = (Biquadx *)type->tp_alloc(type, 0);
@@ -988,6 +1832,7 @@ Biquadx_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
     self->init = 1;
+    BiquadRamp_init(&self->ramp, 1);
 
     INIT_OBJECT_COMMON
 
@@ -996,13 +1841,15 @@ Biquadx_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, Biquadx_compute_next_data_frame);
     self->mode_func_ptr = Biquadx_setProcMode;
 
-    static char *kwlist[] = {"input", "freq", "q", "type", "stages", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "freq", "q", "type", "stages", "mul", "add", "decimation", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiiOO", kwlist, &inputtmp, &freqtmp, &qtmp, &self->filtertype, &self->stages, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOiiOOi", kwlist, &inputtmp, &freqtmp, &qtmp, &self->filtertype, &self->stages, &multmp, &addtmp, &decimation))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
 
+    BiquadRamp_init(&self->ramp, decimation);
+
     if (freqtmp) {
         PyObject_CallMethod((PyObject *)self, "setFreq", "O", freqtmp);
     }
@@ -1023,6 +1870,8 @@ Biquadx_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     Biquadx_allocate_memories(self);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -1157,6 +2006,27 @@ Biquadx_setStages(Biquadx *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Biquadx_setDecimation(Biquadx *self, PyObject *arg)
+{
+
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isInt = PyInt_Check(arg);
+
+	if (isInt == 1) {
+		BiquadRamp_init(&self->ramp, PyInt_AsLong(arg));
+	}
+
+    (*self->mode_func_ptr)(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyMemberDef Biquadx_members[] = {
     {"server", T_OBJECT_EX, offsetof(Biquadx, server), 0, "Pyo server."},
     {"stream", T_OBJECT_EX, offsetof(Biquadx, stream), 0, "Stream object."},
@@ -1177,6 +2047,7 @@ static PyMethodDef Biquadx_methods[] = {
 	{"setFreq", (PyCFunction)Biquadx_setFreq, METH_O, "Sets filter cutoff frequency in cycle per second."},
     {"setQ", (PyCFunction)Biquadx_setQ, METH_O, "Sets filter Q factor."},
     {"setType", (PyCFunction)Biquadx_setType, METH_O, "Sets filter type factor."},
+    {"setDecimation", (PyCFunction)Biquadx_setDecimation, METH_O, "Sets the coefficients update period for audio rate freq and q."},
     {"setStages", (PyCFunction)Biquadx_setStages, METH_O, "Sets the number of filtering stages."},
 	{"setMul", (PyCFunction)Biquadx_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Biquadx_setAdd, METH_O, "Sets oscillator add factor."},
@@ -1453,6 +2324,8 @@ Biquada_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -1719,6 +2592,7 @@ typedef struct {
     MYFLT a0;
     MYFLT a1;
     MYFLT a2;
+    BiquadRamp ramp;
 } EQ;
 
 static void
@@ -1779,6 +2653,22 @@ EQ_compute_variables(EQ *self, MYFLT freq, MYFLT q, MYFLT boost)
     (*self->coeffs_func_ptr)(self);
 }
 
+static void
+EQ_compute_variables_fast(EQ *self, MYFLT freq, MYFLT q, MYFLT boost)
+{
+    MYFLT s;
+
+    if (freq <= 1)
+        freq = 1;
+    else if (freq >= self->nyquist)
+        freq = self->nyquist;
+
+    self->A = MYPOW(10.0, boost/40.0);
+    fast_sincos(freq / self->sr, &s, &self->c);
+    self->alpha = s / (2 * q);
+    (*self->coeffs_func_ptr)(self);
+}
+
 static void
 EQ_filters_iii(EQ *self) {
     MYFLT val;
@@ -1982,6 +2872,100 @@ EQ_filters_aaa(EQ *self) {
     }
 }
 
+/* freq, q and/or boost are audio signals, with the coefficients computed
+ * every `decimation` samples and interpolated in between. */
+static void
+EQ_filters_decim(EQ *self) {
+    MYFLT val, fr = 0.0, q = 0.0, boost = 0.0;
+    int i;
+    MYFLT *frst = NULL, *qst = NULL, *boostst = NULL;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        self->x1 = self->x2 = self->y1 = self->y2 = in[0];
+        self->init = 0;
+    }
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        frst = Stream_getData((Stream *)self->freq_stream);
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        qst = Stream_getData((Stream *)self->q_stream);
+    if (self->modebuffer[4] == 0)
+        boost = PyFloat_AS_DOUBLE(self->boost);
+    else
+        boostst = Stream_getData((Stream *)self->boost_stream);
+
+    for (i=0; i<self->bufsize; i++) {
+        if (self->ramp.count == 0) {
+            EQ_compute_variables_fast(self, frst ? frst[i] : fr, qst ? qst[i] : q, boostst ? boostst[i] : boost);
+            BiquadRamp_setTarget(&self->ramp, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
+        }
+        BiquadRamp_step(&self->ramp);
+        val = (self->ramp.b0 * in[i]) + (self->ramp.b1 * self->x1) + (self->ramp.b2 * self->x2) - (self->ramp.a1 * self->y1) - (self->ramp.a2 * self->y2);
+        self->y2 = self->y1;
+        self->y1 = val;
+        self->x2 = self->x1;
+        self->x1 = in[i];
+        self->data[i] = val;
+    }
+}
+
+#define EQ_CONTROL_RATE(self) \
+    (((self)->modebuffer[2] || (self)->modebuffer[3] || (self)->modebuffer[4]) && \
+     CONTROL_RATE_PARAM((self)->modebuffer[2], (self)->freq_stream) && \
+     CONTROL_RATE_PARAM((self)->modebuffer[3], (self)->q_stream) && \
+     CONTROL_RATE_PARAM((self)->modebuffer[4], (self)->boost_stream))
+#define EQ_CONSTANT(self) \
+    (((self)->modebuffer[2] || (self)->modebuffer[3] || (self)->modebuffer[4]) && \
+     CONSTANT_PARAM((self)->modebuffer[2], (self)->freq_stream) && \
+     CONSTANT_PARAM((self)->modebuffer[3], (self)->q_stream) && \
+     CONSTANT_PARAM((self)->modebuffer[4], (self)->boost_stream))
+
+/* freq, q and boost are control-rate streams, with the coefficients computed
+ * from their last samples and interpolated over the buffer. */
+static void
+EQ_filters_krate(EQ *self) {
+    MYFLT val, fr, q, boost, c[5];
+    int i;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+
+    if (self->init == 1) {
+        self->x1 = self->x2 = self->y1 = self->y2 = in[0];
+        self->init = 0;
+    }
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        fr = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        q = Stream_getData((Stream *)self->q_stream)[self->bufsize-1];
+    if (self->modebuffer[4] == 0)
+        boost = PyFloat_AS_DOUBLE(self->boost);
+    else
+        boost = Stream_getData((Stream *)self->boost_stream)[self->bufsize-1];
+
+    EQ_compute_variables_fast(self, fr, q, boost);
+    BiquadRamp_setSegment(&self->ramp, self->bufsize, self->b0, self->b1, self->b2, self->a0, self->a1, self->a2);
+
+    for (i=0; i<self->bufsize; i++) {
+        BiquadRamp_at(&self->ramp, (MYFLT)(i + 1), c);
+        val = (c[0] * in[i]) + (c[1] * self->x1) + (c[2] * self->x2) - (c[3] * self->y1) - (c[4] * self->y2);
+        self->y2 = self->y1;
+        self->y1 = val;
+        self->x2 = self->x1;
+        self->x1 = in[i];
+        self->data[i] = val;
+    }
+    BiquadRamp_end(&self->ramp);
+}
+
 static void EQ_postprocessing_ii(EQ *self) { POST_PROCESSING_II };
 static void EQ_postprocessing_ai(EQ *self) { POST_PROCESSING_AI };
 static void EQ_postprocessing_ia(EQ *self) { POST_PROCESSING_IA };
@@ -2037,6 +3021,10 @@ EQ_setProcMode(EQ *self)
         case 111:
             self->proc_func_ptr = EQ_filters_aaa;
             break;
+    }
+    if (procmode != 0 && self->ramp.decimation > 1) {
+        self->proc_func_ptr = EQ_filters_decim;
+        self->ramp.count = 0;
     }
 	switch (muladdmode) {
         case 0:
@@ -2072,7 +3060,26 @@ EQ_setProcMode(EQ *self)
 static void
 EQ_compute_next_data_frame(EQ *self)
 {
-    (*self->proc_func_ptr)(self);
+    if (BIQUAD_AT_REST(self)) {
+        self->x1 = self->x2 = self->y1 = self->y2 = 0.0;
+        self->init = 0;
+        pyo_fill(self->data, 0.0, self->bufsize);
+        Stream_setConstant(self->stream, 1);
+    }
+    else if (EQ_CONSTANT(self)) {
+        EQ_compute_variables(self, PARAM_VALUE(self->modebuffer[2], self->freq, self->freq_stream),
+                             PARAM_VALUE(self->modebuffer[3], self->q, self->q_stream),
+                             PARAM_VALUE(self->modebuffer[4], self->boost, self->boost_stream));
+        self->ramp.primed = 0;
+        EQ_filters_iii(self);
+    }
+    else if (EQ_CONTROL_RATE(self))
+        EQ_filters_krate(self);
+    else {
+        if (self->proc_func_ptr != EQ_filters_decim)
+            self->ramp.primed = 0;
+        (*self->proc_func_ptr)(self);
+    }
     (*self->muladd_func_ptr)(self);
 }
 
@@ -2117,7 +3124,7 @@ EQ_dealloc(EQ* self)
 static PyObject *
 EQ_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i;
+    int i, decimation = 1;
     PyObject *inputtmp, *input_streamtmp, *freqtmp=NULL, *qtmp=NULL, *boosttmp=NULL, *multmp=NULL, *addtmp=NULL;
     EQ *self;
     self = (EQ *)type->tp_alloc(type, 0);
@@ -2132,6 +3139,7 @@ EQ_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[3] = 0;
 	self->modebuffer[4] = 0;
     self->init = 1;
+    BiquadRamp_init(&self->ramp, 1);
 
     INIT_OBJECT_COMMON
 
@@ -2140,13 +3148,15 @@ EQ_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, EQ_compute_next_data_frame);
     self->mode_func_ptr = EQ_setProcMode;
 
-    static char *kwlist[] = {"input", "freq", "q", "boost", "type", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "freq", "q", "boost", "type", "mul", "add", "decimation", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOiOO", kwlist, &inputtmp, &freqtmp, &qtmp, &boosttmp, &self->filtertype, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOiOOi", kwlist, &inputtmp, &freqtmp, &qtmp, &boosttmp, &self->filtertype, &multmp, &addtmp, &decimation))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
 
+    BiquadRamp_init(&self->ramp, decimation);
+
     if (freqtmp) {
         PyObject_CallMethod((PyObject *)self, "setFreq", "O", freqtmp);
     }
@@ -2169,6 +3179,8 @@ EQ_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -2317,6 +3329,27 @@ EQ_setType(EQ *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+EQ_setDecimation(EQ *self, PyObject *arg)
+{
+
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isInt = PyInt_Check(arg);
+
+	if (isInt == 1) {
+		BiquadRamp_init(&self->ramp, PyInt_AsLong(arg));
+	}
+
+    (*self->mode_func_ptr)(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyMemberDef EQ_members[] = {
 {"server", T_OBJECT_EX, offsetof(EQ, server), 0, "Pyo server."},
 {"stream", T_OBJECT_EX, offsetof(EQ, stream), 0, "Stream object."},
@@ -2339,6 +3372,7 @@ static PyMethodDef EQ_methods[] = {
 {"setQ", (PyCFunction)EQ_setQ, METH_O, "Sets filter Q factor."},
 {"setBoost", (PyCFunction)EQ_setBoost, METH_O, "Sets filter boost factor."},
 {"setType", (PyCFunction)EQ_setType, METH_O, "Sets filter type factor."},
+{"setDecimation", (PyCFunction)EQ_setDecimation, METH_O, "Sets the coefficients update period for audio rate freq, q and boost."},
 {"setMul", (PyCFunction)EQ_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)EQ_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)EQ_setSub, METH_O, "Sets inverse add factor."},
@@ -2443,6 +3477,7 @@ typedef struct {
     MYFLT y1; // sample memory
     MYFLT x1;
     int dir;
+    int krate;
 } Port;
 
 static void
@@ -2539,6 +3574,28 @@ Port_filters_aa(Port *self) {
     }
 }
 
+/* Control-rate mode, the portamento follows the last sample of the input and
+ * is computed once for the buffer. */
+static void
+Port_filters_k(Port *self) {
+    MYFLT risetime, falltime, factor, start = self->y1;
+    MYFLT val = Stream_getData((Stream *)self->input_stream)[self->bufsize-1];
+
+    if (self->modebuffer[2] == 0)
+        risetime = PyFloat_AS_DOUBLE(self->risetime);
+    else
+        risetime = Stream_getData((Stream *)self->risetime_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        falltime = PyFloat_AS_DOUBLE(self->falltime);
+    else
+        falltime = Stream_getData((Stream *)self->falltime_stream)[self->bufsize-1];
+
+    direction(self, val);
+    factor = 1. / (((self->dir == 1 ? risetime : falltime) + 0.001) * self->sr);
+    self->y1 = val + (self->y1 - val) * MYPOW(1. - factor, self->bufsize);
+    pyo_fill_ramp(self->data, start, self->y1, self->bufsize);
+}
+
 static void Port_postprocessing_ii(Port *self) { POST_PROCESSING_II };
 static void Port_postprocessing_ai(Port *self) { POST_PROCESSING_AI };
 static void Port_postprocessing_ia(Port *self) { POST_PROCESSING_IA };
@@ -2569,6 +3626,9 @@ Port_setProcMode(Port *self)
         case 11:
             self->proc_func_ptr = Port_filters_aa;
             break;
+    }
+    if (self->krate) {
+        self->proc_func_ptr = Port_filters_k;
     }
 	switch (muladdmode) {
         case 0:
@@ -2599,6 +3659,7 @@ Port_setProcMode(Port *self)
             self->muladd_func_ptr = Port_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
@@ -2657,6 +3718,7 @@ Port_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
+    self->krate = 0;
     self->y1 = 0.0;
     self->x1 = 0.0;
     self->dir = 1;
@@ -2693,11 +3755,25 @@ Port_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
 }
 
+static PyObject *
+Port_setControlRate(Port *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Port_getServer(Port* self) { GET_SERVER };
 static PyObject * Port_getStream(Port* self) { GET_STREAM };
 static PyObject * Port_setMul(Port *self, PyObject *arg) { SET_MUL };
@@ -2805,6 +3881,7 @@ static PyMethodDef Port_methods[] = {
 {"stop", (PyCFunction)Port_stop, METH_NOARGS, "Stops computing."},
 {"setRiseTime", (PyCFunction)Port_setRiseTime, METH_O, "Sets rising portamento time in seconds."},
 {"setFallTime", (PyCFunction)Port_setFallTime, METH_O, "Sets falling portamento time in seconds."},
+{"setControlRate", (PyCFunction)Port_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
 {"setMul", (PyCFunction)Port_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)Port_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)Port_setSub, METH_O, "Sets inverse add factor."},
@@ -3101,6 +4178,8 @@ Tone_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -3471,6 +4550,8 @@ Atone_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -3780,6 +4861,8 @@ DCBlock_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -4239,6 +5322,8 @@ Allpass_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->buffer[i] = 0.;
     }
 
+    Stream_setTail(self->stream, self->size);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -5494,6 +6579,8 @@ Phaser_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     for (i=0; i<self->stages; i++) {
@@ -7063,6 +8150,10 @@ typedef struct {
     MYFLT y4;
     // variables
     MYFLT w;
+    // audio rate freq, w moves linearly toward its value every `decimation` samples
+    int decimation;
+    int count;
+    MYFLT w_inc;
 } SVF;
 
 static void
@@ -7441,6 +8532,70 @@ SVF_filters_aaa(SVF *self) {
     }
 }
 
+/* freq is an audio signal, with w computed every `decimation` samples and
+ * interpolated in between. */
+static void
+SVF_filters_decim(SVF *self) {
+    int i;
+    MYFLT val, freq, q = 0.0, type = 0.0, q1, low, high, band, lowgain, highgain, bandgain, target;
+    MYFLT *qst = NULL, *tp = NULL;
+    MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+
+    if (self->modebuffer[3] == 0)
+        q = PyFloat_AS_DOUBLE(self->q);
+    else
+        qst = Stream_getData((Stream *)self->q_stream);
+    if (self->modebuffer[4] == 0)
+        type = PyFloat_AS_DOUBLE(self->type);
+    else
+        tp = Stream_getData((Stream *)self->type_stream);
+
+    for (i=0; i<self->bufsize; i++) {
+        if (self->count == 0) {
+            freq = fr[i];
+            if (freq < 0.1)
+                freq = 0.1;
+            else if (freq > self->srOverSix)
+                freq = self->srOverSix;
+            target = 2.0 * SineKernel_sample(freq * 0.5 / self->sr, SINE_ACCURACY_HIGH);
+            if (self->last_freq < 0.0)
+                self->w = target;
+            self->last_freq = freq;
+            self->w_inc = (target - self->w) / self->decimation;
+            self->count = self->decimation;
+        }
+        self->w += self->w_inc;
+        self->count--;
+        if (qst)
+            q = qst[i];
+        if (tp)
+            type = tp[i];
+        if (q < 0.5)
+            q = 0.5;
+        q1 = 1.0 / q;
+        if (type < 0.0)
+            type = 0.0;
+        else if (type > 1.0)
+            type = 1.0;
+        lowgain = (type <= 0.5) ? (0.5 - type) : 0.0;
+        highgain = (type >= 0.5) ? (type - 0.5) : 0.0;
+        bandgain = (type <= 0.5) ? type : (1.0 - type);
+        low = self->y2 + self->w * self->y1;
+        high = in[i] - low - q1 * self->y1;
+        band = self->w * high + self->y1;
+        self->y1 = band;
+        self->y2 = low;
+        val = low * lowgain + high * highgain + band * bandgain;
+        low = self->y4 + self->w * self->y3;
+        high = val - low - q1 * self->y3;
+        band = self->w * high + self->y3;
+        self->y3 = band;
+        self->y4 = low;
+        self->data[i] = low * lowgain + high * highgain + band * bandgain;
+    }
+}
+
 static void SVF_postprocessing_ii(SVF *self) { POST_PROCESSING_II };
 static void SVF_postprocessing_ai(SVF *self) { POST_PROCESSING_AI };
 static void SVF_postprocessing_ia(SVF *self) { POST_PROCESSING_IA };
@@ -7483,6 +8638,10 @@ SVF_setProcMode(SVF *self)
         case 111:
             self->proc_func_ptr = SVF_filters_aaa;
             break;
+    }
+    if (self->modebuffer[2] == 1 && self->decimation > 1) {
+        self->proc_func_ptr = SVF_filters_decim;
+        self->count = 0;
     }
 	switch (muladdmode) {
         case 0:
@@ -7578,6 +8737,9 @@ SVF_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[4] = 0;
     self->y1 = self->y2 = self->y3 = self->y4 = self->w = 0.0;
     self->last_freq = -1.0;
+    self->decimation = 1;
+    self->count = 0;
+    self->w_inc = 0.0;
 
     INIT_OBJECT_COMMON
 
@@ -7587,11 +8749,14 @@ SVF_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Stream_setFunctionPtr(self->stream, SVF_compute_next_data_frame);
     self->mode_func_ptr = SVF_setProcMode;
 
-    static char *kwlist[] = {"input", "freq", "q", "type", "mul", "add", NULL};
+    static char *kwlist[] = {"input", "freq", "q", "type", "mul", "add", "decimation", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOO", kwlist, &inputtmp, &freqtmp, &qtmp, &typetmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OOOOOi", kwlist, &inputtmp, &freqtmp, &qtmp, &typetmp, &multmp, &addtmp, &self->decimation))
         Py_RETURN_NONE;
 
+    if (self->decimation < 1)
+        self->decimation = 1;
+
     INIT_INPUT_STREAM
 
     if (freqtmp) {
@@ -7616,6 +8781,8 @@ SVF_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -7743,6 +8910,29 @@ SVF_setType(SVF *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+SVF_setDecimation(SVF *self, PyObject *arg)
+{
+
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+	int isInt = PyInt_Check(arg);
+
+	if (isInt == 1) {
+		self->decimation = PyInt_AsLong(arg);
+        if (self->decimation < 1)
+            self->decimation = 1;
+	}
+
+    (*self->mode_func_ptr)(self);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyMemberDef SVF_members[] = {
     {"server", T_OBJECT_EX, offsetof(SVF, server), 0, "Pyo server."},
     {"stream", T_OBJECT_EX, offsetof(SVF, stream), 0, "Stream object."},
@@ -7764,6 +8954,7 @@ static PyMethodDef SVF_methods[] = {
 	{"setFreq", (PyCFunction)SVF_setFreq, METH_O, "Sets filter cutoff frequency in cycle per second."},
     {"setQ", (PyCFunction)SVF_setQ, METH_O, "Sets filter Q factor."},
     {"setType", (PyCFunction)SVF_setType, METH_O, "Sets filter type factor."},
+    {"setDecimation", (PyCFunction)SVF_setDecimation, METH_O, "Sets the w update period for audio rate freq."},
 	{"setMul", (PyCFunction)SVF_setMul, METH_O, "Sets mul factor."},
 	{"setAdd", (PyCFunction)SVF_setAdd, METH_O, "Sets add factor."},
     {"setSub", (PyCFunction)SVF_setSub, METH_O, "Sets inverse add factor."},
@@ -8491,6 +9682,8 @@ Reson_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -9024,6 +10217,8 @@ Resonx_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     Resonx_allocate_memories(self);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -9473,6 +10668,8 @@ ButLP_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -9865,6 +11062,8 @@ ButHP_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -10329,6 +11528,8 @@ ButBP_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -10829,6 +12030,8 @@ ButBR_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -11336,6 +12539,8 @@ ComplexRes_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, 0);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
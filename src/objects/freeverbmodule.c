@@ -25,6 +25,7 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "packed.h"
 
 #define DEFAULT_SRATE   44100.0
 #define NUM_COMB         8
@@ -64,15 +65,13 @@ typedef struct {
     Stream *damp_stream;
     PyObject *mix;
     Stream *mix_stream;
-    int comb_nSamples[NUM_COMB];
-    int comb_bufPos[NUM_COMB];
-    MYFLT comb_filterState[NUM_COMB];
-    MYFLT *comb_buf[NUM_COMB];
+    PackedComb *combs;
     int allpass_nSamples[NUM_ALLPASS];
     int allpass_bufPos[NUM_ALLPASS];
     MYFLT *allpass_buf[NUM_ALLPASS];
     int modebuffer[5];
     MYFLT srFactor;
+    PyoRand rng;
 } Freeverb;
 
 static MYFLT
@@ -92,395 +91,102 @@ Freeverb_calc_nsamples(Freeverb *self, MYFLT delTime)
     return (int)(delTime * self->sr + 0.5);
 }
 
+/* Runs one allpass over `tmp`, in runs of samples where its buffer does not
+ * wrap. Each sample of a run is independent of the others. */
 static void
-Freeverb_transform_iii(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT siz = _clip(PyFloat_AS_DOUBLE(self->size));
-    MYFLT dam = _clip(PyFloat_AS_DOUBLE(self->damp));
-    MYFLT mix = _clip(PyFloat_AS_DOUBLE(self->mix));
-
-    feedback = siz * scaleRoom + offsetRoom;
-    damp1 = dam * scaleDamp;
-    damp2 = 1.0 - damp1;
-
-    mix1 = MYSQRT(mix);
-    mix2 = MYSQRT(1.0 - mix);
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
+Freeverb_allpass(MYFLT *buf, int *bufPos, int nSamples, MYFLT *tmp, int num)
+{
+    int j, n, start;
+    MYFLT x, *b, *t;
+
+    for (start=0; start<num; start+=n) {
+        n = nSamples - *bufPos;
+        if (n > num - start)
+            n = num - start;
+        b = buf + *bufPos;
+        t = tmp + start;
+        for (j=0; j<n; j++) {
+            x = b[j] - t[j];
+            b[j] = b[j] * allPassFeedBack + t[j];
+            t[j] = x;
         }
-    }
-
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
+        *bufPos += n;
+        if (*bufPos >= nSamples)
+            *bufPos = 0;
     }
 }
 
+/* The combs and allpasses, from `in` to `tmp`. */
 static void
-Freeverb_transform_aii(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *siz = Stream_getData((Stream *)self->size_stream);
-    MYFLT dam = _clip(PyFloat_AS_DOUBLE(self->damp));
-    MYFLT mix = _clip(PyFloat_AS_DOUBLE(self->mix));
-
-    damp1 = dam * scaleDamp;
-    damp2 = 1.0 - damp1;
-
-    mix1 = MYSQRT(mix);
-    mix2 = MYSQRT(1.0 - mix);
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        feedback = _clip(siz[j]) * scaleRoom + offsetRoom;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
+Freeverb_filters(Freeverb *self, MYFLT *in, MYFLT *tmp)
+{
+    int i;
+    MYFLT feedback, damp1, *siz, *dam;
+    MYFLT feed[self->bufsize];
+    MYFLT damp[self->bufsize];
+
+    if (self->modebuffer[2] == 0) {
+        feedback = _clip(PyFloat_AS_DOUBLE(self->size)) * scaleRoom + offsetRoom;
+        for (i=0; i<self->bufsize; i++) {
+            feed[i] = feedback;
         }
     }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
+    else {
+        siz = Stream_getData((Stream *)self->size_stream);
+        for (i=0; i<self->bufsize; i++) {
+            feed[i] = _clip(siz[i]) * scaleRoom + offsetRoom;
         }
     }
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
-    }
-}
-
-static void
-Freeverb_transform_iai(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT siz = _clip(PyFloat_AS_DOUBLE(self->size));
-    MYFLT *dam = Stream_getData((Stream *)self->damp_stream);
-    MYFLT mix = _clip(PyFloat_AS_DOUBLE(self->mix));
-
-    feedback = siz * scaleRoom + offsetRoom;
-
-    mix1 = MYSQRT(mix);
-    mix2 = MYSQRT(1.0 - mix);
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        damp1 = _clip(dam[j]) * scaleDamp;
-        damp2 = 1.0 - damp1;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
+    if (self->modebuffer[3] == 0) {
+        damp1 = _clip(PyFloat_AS_DOUBLE(self->damp)) * scaleDamp;
+        for (i=0; i<self->bufsize; i++) {
+            damp[i] = damp1;
         }
     }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
+    else {
+        dam = Stream_getData((Stream *)self->damp_stream);
+        for (i=0; i<self->bufsize; i++) {
+            damp[i] = _clip(dam[i]) * scaleDamp;
         }
     }
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
+    PackedComb_process(self->combs, in, tmp, feed, damp, self->bufsize);
+
+    for (i=0; i<NUM_ALLPASS; i++) {
+        Freeverb_allpass(self->allpass_buf[i], &self->allpass_bufPos[i], self->allpass_nSamples[i], tmp, self->bufsize);
     }
 }
 
 static void
-Freeverb_transform_aai(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2;
-    int i, j;
+Freeverb_transform_i(Freeverb *self) {
+    MYFLT mix1, mix2;
+    int i;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *siz = Stream_getData((Stream *)self->size_stream);
-    MYFLT *dam = Stream_getData((Stream *)self->damp_stream);
     MYFLT mix = _clip(PyFloat_AS_DOUBLE(self->mix));
 
     mix1 = MYSQRT(mix);
     mix2 = MYSQRT(1.0 - mix);
 
     MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        feedback = _clip(siz[j]) * scaleRoom + offsetRoom;
-        damp1 = _clip(dam[j]) * scaleDamp;
-        damp2 = 1.0 - damp1;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
-        }
-    }
-
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
-    }
-}
-
-static void
-Freeverb_transform_iia(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2, mixtmp;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT siz = _clip(PyFloat_AS_DOUBLE(self->size));
-    MYFLT dam = _clip(PyFloat_AS_DOUBLE(self->damp));
-    MYFLT *mix = Stream_getData((Stream *)self->mix_stream);
-
-    feedback = siz * scaleRoom + offsetRoom;
-    damp1 = dam * scaleDamp;
-    damp2 = 1.0 - damp1;
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
-        }
-    }
-
-    for (i=0; i<self->bufsize; i++) {
-        mixtmp = _clip(mix[i]);
-        mix1 = MYSQRT(mixtmp);
-        mix2 = MYSQRT(1.0 - mixtmp);
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
-    }
-}
-
-static void
-Freeverb_transform_aia(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2, mixtmp;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *siz = Stream_getData((Stream *)self->size_stream);
-    MYFLT dam = _clip(PyFloat_AS_DOUBLE(self->damp));
-    MYFLT *mix = Stream_getData((Stream *)self->mix_stream);
-
-    damp1 = dam * scaleDamp;
-    damp2 = 1.0 - damp1;
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        feedback = _clip(siz[j]) * scaleRoom + offsetRoom;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
-        }
-    }
-
-    for (i=0; i<self->bufsize; i++) {
-        mixtmp = _clip(mix[i]);
-        mix1 = MYSQRT(mixtmp);
-        mix2 = MYSQRT(1.0 - mixtmp);
-        self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
-    }
-}
-
-static void
-Freeverb_transform_iaa(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2, mixtmp;
-    int i, j;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT siz = _clip(PyFloat_AS_DOUBLE(self->size));
-    MYFLT *dam = Stream_getData((Stream *)self->damp_stream);
-    MYFLT *mix = Stream_getData((Stream *)self->mix_stream);
-
-    feedback = siz * scaleRoom + offsetRoom;
-
-    MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        damp1 = _clip(dam[j]) * scaleDamp;
-        damp2 = 1.0 - damp1;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
-        }
-    }
+    Freeverb_filters(self, in, tmp);
 
     for (i=0; i<self->bufsize; i++) {
-        mixtmp = _clip(mix[i]);
-        mix1 = MYSQRT(mixtmp);
-        mix2 = MYSQRT(1.0 - mixtmp);
         self->data[i] = (tmp[i] * fixedGain * mix1) + (in[i] * mix2);
     }
 }
 
 static void
-Freeverb_transform_aaa(Freeverb *self) {
-    MYFLT x, feedback, damp1, damp2, mix1, mix2, mixtmp;
-    int i, j;
+Freeverb_transform_a(Freeverb *self) {
+    MYFLT mix1, mix2, mixtmp;
+    int i;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *siz = Stream_getData((Stream *)self->size_stream);
-    MYFLT *dam = Stream_getData((Stream *)self->damp_stream);
     MYFLT *mix = Stream_getData((Stream *)self->mix_stream);
 
     MYFLT tmp[self->bufsize];
-    memset(&tmp, 0, sizeof(tmp));
-
-    for (j=0; j<self->bufsize; j++) {
-        feedback = _clip(siz[j]) * scaleRoom + offsetRoom;
-        damp1 = _clip(dam[j]) * scaleDamp;
-        damp2 = 1.0 - damp1;
-        for (i=0; i<NUM_COMB; i++) {
-            x = self->comb_buf[i][self->comb_bufPos[i]];
-            tmp[j] += x;
-            self->comb_filterState[i] = (self->comb_filterState[i] * damp1) + (x * damp2);
-            x = self->comb_filterState[i] * feedback + in[j];
-            self->comb_buf[i][self->comb_bufPos[i]] = x;
-            self->comb_bufPos[i]++;
-            if (self->comb_bufPos[i] >= self->comb_nSamples[i])
-                self->comb_bufPos[i] = 0;
-        }
-    }
-
-    for (i=0; i<NUM_ALLPASS; i++) {
-        for (j=0; j<self->bufsize; j++) {
-            x = self->allpass_buf[i][self->allpass_bufPos[i]] - tmp[j];
-            self->allpass_buf[i][self->allpass_bufPos[i]] *= allPassFeedBack;
-            self->allpass_buf[i][self->allpass_bufPos[i]] += tmp[j];
-            self->allpass_bufPos[i]++;
-            if (self->allpass_bufPos[i] >= self->allpass_nSamples[i])
-                self->allpass_bufPos[i] = 0;
-            tmp[j] = x;
-        }
-    }
+    Freeverb_filters(self, in, tmp);
 
     for (i=0; i<self->bufsize; i++) {
         mixtmp = _clip(mix[i]);
@@ -504,33 +210,16 @@ static void
 Freeverb_setProcMode(Freeverb *self)
 {
     int procmode, muladdmode;
-    procmode = self->modebuffer[2] + self->modebuffer[3] * 10 + self->modebuffer[4] * 100;
+    procmode = self->modebuffer[4];
     muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
 
+    /* size and damp are read by Freeverb_filters. */
 	switch (procmode) {
         case 0:
-            self->proc_func_ptr = Freeverb_transform_iii;
+            self->proc_func_ptr = Freeverb_transform_i;
             break;
         case 1:
-            self->proc_func_ptr = Freeverb_transform_aii;
-            break;
-        case 10:
-            self->proc_func_ptr = Freeverb_transform_iai;
-            break;
-        case 11:
-            self->proc_func_ptr = Freeverb_transform_aai;
-            break;
-        case 100:
-            self->proc_func_ptr = Freeverb_transform_iia;
-            break;
-        case 101:
-            self->proc_func_ptr = Freeverb_transform_aia;
-            break;
-        case 110:
-            self->proc_func_ptr = Freeverb_transform_iaa;
-            break;
-        case 111:
-            self->proc_func_ptr = Freeverb_transform_aaa;
+            self->proc_func_ptr = Freeverb_transform_a;
             break;
     }
 	switch (muladdmode) {
@@ -606,9 +295,7 @@ Freeverb_dealloc(Freeverb* self)
 {
     int i;
     pyo_DEALLOC
-    for(i=0; i<NUM_COMB; i++) {
-        free(self->comb_buf[i]);
-    }
+    PackedComb_free(self->combs);
     for(i=0; i<NUM_ALLPASS; i++) {
         free(self->allpass_buf[i]);
     }
@@ -621,6 +308,8 @@ Freeverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i, j, rndSamps;
     MYFLT nsamps;
+    long lengths[NUM_COMB];
+    size_t memory;
     PyObject *inputtmp, *input_streamtmp, *sizetmp=NULL, *damptmp=NULL, *mixtmp=NULL, *multmp=NULL, *addtmp=NULL;
     Freeverb *self;
     self = (Freeverb *)type->tp_alloc(type, 0);
@@ -669,30 +358,30 @@ Freeverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    Stream_setTail(self->stream, (long)(self->sr * 0.125));
+
     (*self->mode_func_ptr)(self);
 
-    Server_generateSeed((Server *)self->server, FREEVERB_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, FREEVERB_ID));
 
-    rndSamps = (rand()/(MYFLT)(RAND_MAX) * 20 + 10) / DEFAULT_SRATE;
+    rndSamps = (RANDOM_INT/(MYFLT)(RANDOM_MAX) * 20 + 10) / DEFAULT_SRATE;
     for(i=0; i<NUM_COMB; i++) {
         nsamps = Freeverb_calc_nsamples((Freeverb *)self, comb_delays[i] + rndSamps);
-        self->comb_buf[i] = (MYFLT *)realloc(self->comb_buf[i], (nsamps+1) * sizeof(MYFLT));
-        self->comb_nSamples[i] = nsamps;
-        self->comb_bufPos[i] = 0;
-        self->comb_filterState[i] = 0.0;
-        for(j=0; j<nsamps; j++) {
-            self->comb_buf[i][j] = 0.0;
-        }
+        lengths[i] = nsamps;
     }
+    self->combs = PackedComb_new(NUM_COMB, lengths);
+    memory = self->combs->size * self->combs->pchnls;
         for(i=0; i<NUM_ALLPASS; i++) {
             nsamps = Freeverb_calc_nsamples((Freeverb *)self, allpass_delays[i] + rndSamps);
             self->allpass_buf[i] = (MYFLT *)realloc(self->allpass_buf[i], (nsamps+1) * sizeof(MYFLT));
+            memory += (size_t)nsamps + 1;
             self->allpass_nSamples[i] = nsamps;
             self->allpass_bufPos[i] = 0;
             for(j=0; j<nsamps; j++) {
                 self->allpass_buf[i][j] = 0.0;
             }
     }
+    Stream_setMemory(self->stream, memory * sizeof(MYFLT));
 
     return (PyObject *)self;
 }
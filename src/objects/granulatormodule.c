@@ -27,6 +27,7 @@
 #include "dummymodule.h"
 #include "tablemodule.h"
 #include "interpolation.h"
+#include "voicepool.h"
 
 static MYFLT LOOPER_LINEAR_FADE[513] = {0.0, 0.001953125, 0.00390625, 0.005859375, 0.0078125, 0.009765625, 0.01171875, 0.013671875, 0.015625, 0.017578125, 0.01953125, 0.021484375, 0.0234375, 0.025390625, 0.02734375, 0.029296875, 0.03125, 0.033203125, 0.03515625, 0.037109375, 0.0390625, 0.041015625, 0.04296875, 0.044921875, 0.046875, 0.048828125, 0.05078125, 0.052734375, 0.0546875, 0.056640625, 0.05859375, 0.060546875, 0.0625, 0.064453125, 0.06640625, 0.068359375, 0.0703125, 0.072265625, 0.07421875, 0.076171875, 0.078125, 0.080078125, 0.08203125, 0.083984375, 0.0859375, 0.087890625, 0.08984375, 0.091796875, 0.09375, 0.095703125, 0.09765625, 0.099609375, 0.1015625, 0.103515625, 0.10546875, 0.107421875, 0.109375, 0.111328125, 0.11328125, 0.115234375, 0.1171875, 0.119140625, 0.12109375, 0.123046875, 0.125, 0.126953125, 0.12890625, 0.130859375, 0.1328125, 0.134765625, 0.13671875, 0.138671875, 0.140625, 0.142578125, 0.14453125, 0.146484375, 0.1484375, 0.150390625, 0.15234375, 0.154296875, 0.15625, 0.158203125, 0.16015625, 0.162109375, 0.1640625, 0.166015625, 0.16796875, 0.169921875, 0.171875, 0.173828125, 0.17578125, 0.177734375, 0.1796875, 0.181640625, 0.18359375, 0.185546875, 0.1875, 0.189453125, 0.19140625, 0.193359375, 0.1953125, 0.197265625, 0.19921875, 0.201171875, 0.203125, 0.205078125, 0.20703125, 0.208984375, 0.2109375, 0.212890625, 0.21484375, 0.216796875, 0.21875, 0.220703125, 0.22265625, 0.224609375, 0.2265625, 0.228515625, 0.23046875, 0.232421875, 0.234375, 0.236328125, 0.23828125, 0.240234375, 0.2421875, 0.244140625, 0.24609375, 0.248046875, 0.25, 0.251953125, 0.25390625, 0.255859375, 0.2578125, 0.259765625, 0.26171875, 0.263671875, 0.265625, 0.267578125, 0.26953125, 0.271484375, 0.2734375, 0.275390625, 0.27734375, 0.279296875, 0.28125, 0.283203125, 0.28515625, 0.287109375, 0.2890625, 0.291015625, 0.29296875, 0.294921875, 0.296875, 0.298828125, 0.30078125, 0.302734375, 0.3046875, 0.306640625, 0.30859375, 0.310546875, 0.3125, 0.314453125, 0.31640625, 0.318359375, 0.3203125, 0.322265625, 0.32421875, 0.326171875, 0.328125, 0.330078125, 0.33203125, 0.333984375, 0.3359375, 0.337890625, 0.33984375, 0.341796875, 0.34375, 0.345703125, 0.34765625, 0.349609375, 0.3515625, 0.353515625, 0.35546875, 0.357421875, 0.359375, 0.361328125, 0.36328125, 0.365234375, 0.3671875, 0.369140625, 0.37109375, 0.373046875, 0.375, 0.376953125, 0.37890625, 0.380859375, 0.3828125, 0.384765625, 0.38671875, 0.388671875, 0.390625, 0.392578125, 0.39453125, 0.396484375, 0.3984375, 0.400390625, 0.40234375, 0.404296875, 0.40625, 0.408203125, 0.41015625, 0.412109375, 0.4140625, 0.416015625, 0.41796875, 0.419921875, 0.421875, 0.423828125, 0.42578125, 0.427734375, 0.4296875, 0.431640625, 0.43359375, 0.435546875, 0.4375, 0.439453125, 0.44140625, 0.443359375, 0.4453125, 0.447265625, 0.44921875, 0.451171875, 0.453125, 0.455078125, 0.45703125, 0.458984375, 0.4609375, 0.462890625, 0.46484375, 0.466796875, 0.46875, 0.470703125, 0.47265625, 0.474609375, 0.4765625, 0.478515625, 0.48046875, 0.482421875, 0.484375, 0.486328125, 0.48828125, 0.490234375, 0.4921875, 0.494140625, 0.49609375, 0.498046875, 0.5, 0.501953125, 0.50390625, 0.505859375, 0.5078125, 0.509765625, 0.51171875, 0.513671875, 0.515625, 0.517578125, 0.51953125, 0.521484375, 0.5234375, 0.525390625, 0.52734375, 0.529296875, 0.53125, 0.533203125, 0.53515625, 0.537109375, 0.5390625, 0.541015625, 0.54296875, 0.544921875, 0.546875, 0.548828125, 0.55078125, 0.552734375, 0.5546875, 0.556640625, 0.55859375, 0.560546875, 0.5625, 0.564453125, 0.56640625, 0.568359375, 0.5703125, 0.572265625, 0.57421875, 0.576171875, 0.578125, 0.580078125, 0.58203125, 0.583984375, 0.5859375, 0.587890625, 0.58984375, 0.591796875, 0.59375, 0.595703125, 0.59765625, 0.599609375, 0.6015625, 0.603515625, 0.60546875, 0.607421875, 0.609375, 0.611328125, 0.61328125, 0.615234375, 0.6171875, 0.619140625, 0.62109375, 0.623046875, 0.625, 0.626953125, 0.62890625, 0.630859375, 0.6328125, 0.634765625, 0.63671875, 0.638671875, 0.640625, 0.642578125, 0.64453125, 0.646484375, 0.6484375, 0.650390625, 0.65234375, 0.654296875, 0.65625, 0.658203125, 0.66015625, 0.662109375, 0.6640625, 0.666015625, 0.66796875, 0.669921875, 0.671875, 0.673828125, 0.67578125, 0.677734375, 0.6796875, 0.681640625, 0.68359375, 0.685546875, 0.6875, 0.689453125, 0.69140625, 0.693359375, 0.6953125, 0.697265625, 0.69921875, 0.701171875, 0.703125, 0.705078125, 0.70703125, 0.708984375, 0.7109375, 0.712890625, 0.71484375, 0.716796875, 0.71875, 0.720703125, 0.72265625, 0.724609375, 0.7265625, 0.728515625, 0.73046875, 0.732421875, 0.734375, 0.736328125, 0.73828125, 0.740234375, 0.7421875, 0.744140625, 0.74609375, 0.748046875, 0.75, 0.751953125, 0.75390625, 0.755859375, 0.7578125, 0.759765625, 0.76171875, 0.763671875, 0.765625, 0.767578125, 0.76953125, 0.771484375, 0.7734375, 0.775390625, 0.77734375, 0.779296875, 0.78125, 0.783203125, 0.78515625, 0.787109375, 0.7890625, 0.791015625, 0.79296875, 0.794921875, 0.796875, 0.798828125, 0.80078125, 0.802734375, 0.8046875, 0.806640625, 0.80859375, 0.810546875, 0.8125, 0.814453125, 0.81640625, 0.818359375, 0.8203125, 0.822265625, 0.82421875, 0.826171875, 0.828125, 0.830078125, 0.83203125, 0.833984375, 0.8359375, 0.837890625, 0.83984375, 0.841796875, 0.84375, 0.845703125, 0.84765625, 0.849609375, 0.8515625, 0.853515625, 0.85546875, 0.857421875, 0.859375, 0.861328125, 0.86328125, 0.865234375, 0.8671875, 0.869140625, 0.87109375, 0.873046875, 0.875, 0.876953125, 0.87890625, 0.880859375, 0.8828125, 0.884765625, 0.88671875, 0.888671875, 0.890625, 0.892578125, 0.89453125, 0.896484375, 0.8984375, 0.900390625, 0.90234375, 0.904296875, 0.90625, 0.908203125, 0.91015625, 0.912109375, 0.9140625, 0.916015625, 0.91796875, 0.919921875, 0.921875, 0.923828125, 0.92578125, 0.927734375, 0.9296875, 0.931640625, 0.93359375, 0.935546875, 0.9375, 0.939453125, 0.94140625, 0.943359375, 0.9453125, 0.947265625, 0.94921875, 0.951171875, 0.953125, 0.955078125, 0.95703125, 0.958984375, 0.9609375, 0.962890625, 0.96484375, 0.966796875, 0.96875, 0.970703125, 0.97265625, 0.974609375, 0.9765625, 0.978515625, 0.98046875, 0.982421875, 0.984375, 0.986328125, 0.98828125, 0.990234375, 0.9921875, 0.994140625, 0.99609375, 0.998046875, 1.0};
 static MYFLT LOOPER_POWER_FADE[513] = {0.0, 0.0030679567629659761, 0.0061358846491544753, 0.0092037547820598194, 0.012271538285719925, 0.0153392062849881, 0.01840672990580482, 0.021474080275469508, 0.024541228522912288, 0.02760814577896574, 0.030674803176636626, 0.03374117185137758, 0.036807222941358832, 0.039872927587739811, 0.04293825693494082, 0.046003182130914623, 0.049067674327418015, 0.052131704680283324, 0.055195244349689941, 0.058258264500435752, 0.061320736302208578, 0.064382630929857465, 0.067443919563664051, 0.070504573389613856, 0.073564563599667426, 0.076623861392031492, 0.079682437971430126, 0.082740264549375692, 0.085797312344439894, 0.0888535525825246, 0.091908956497132724, 0.094963495329638992, 0.098017140329560604, 0.10106986275482782, 0.10412163387205459, 0.10717242495680884, 0.11022220729388306, 0.11327095217756435, 0.11631863091190475, 0.11936521481099135, 0.1224106751992162, 0.12545498341154623, 0.12849811079379317, 0.13154002870288312, 0.13458070850712617, 0.13762012158648604, 0.14065823933284921, 0.14369503315029447, 0.14673047445536175, 0.14976453467732151, 0.15279718525844344, 0.15582839765426523, 0.15885814333386145, 0.16188639378011183, 0.16491312048996992, 0.16793829497473117, 0.17096188876030122, 0.17398387338746382, 0.17700422041214875, 0.18002290140569951, 0.18303988795514095, 0.18605515166344663, 0.18906866414980619, 0.19208039704989244, 0.19509032201612825, 0.19809841071795356, 0.2011046348420919, 0.20410896609281687, 0.20711137619221856, 0.21011183688046961, 0.21311031991609136, 0.21610679707621952, 0.2191012401568698, 0.22209362097320351, 0.22508391135979283, 0.22807208317088573, 0.23105810828067111, 0.23404195858354343, 0.2370236059943672, 0.2400030224487415, 0.24298017990326387, 0.24595505033579459, 0.24892760574572015, 0.25189781815421697, 0.25486565960451457, 0.25783110216215899, 0.26079411791527551, 0.26375467897483135, 0.26671275747489837, 0.26966832557291509, 0.27262135544994898, 0.27557181931095814, 0.27851968938505306, 0.28146493792575794, 0.28440753721127188, 0.28734745954472951, 0.29028467725446233, 0.29321916269425863, 0.29615088824362379, 0.29907982630804048, 0.30200594931922808, 0.30492922973540237, 0.30784964004153487, 0.31076715274961147, 0.31368174039889152, 0.31659337555616585, 0.31950203081601569, 0.32240767880106985, 0.32531029216226293, 0.3282098435790925, 0.33110630575987643, 0.33399965144200938, 0.33688985339222005, 0.33977688440682685, 0.34266071731199438, 0.34554132496398909, 0.34841868024943456, 0.35129275608556709, 0.35416352542049034, 0.35703096123342998, 0.35989503653498811, 0.36275572436739723, 0.36561299780477385, 0.36846682995337232, 0.37131719395183754, 0.37416406297145793, 0.37700741021641826, 0.37984720892405116, 0.38268343236508978, 0.38551605384391885, 0.38834504669882625, 0.39117038430225387, 0.3939920400610481, 0.39680998741671031, 0.39962419984564679, 0.40243465085941843, 0.40524131400498986, 0.40804416286497869, 0.41084317105790391, 0.41363831223843456, 0.41642956009763715, 0.41921688836322391, 0.42200027079979968, 0.42477968120910881, 0.42755509343028208, 0.43032648134008261, 0.43309381885315196, 0.43585707992225547, 0.43861623853852766, 0.44137126873171667, 0.4441221445704292, 0.44686884016237416, 0.44961132965460654, 0.45234958723377089, 0.45508358712634384, 0.45781330359887723, 0.46053871095824001, 0.46325978355186015, 0.46597649576796618, 0.46868882203582796, 0.47139673682599764, 0.47410021465054997, 0.47679923006332209, 0.47949375766015301, 0.48218377207912272, 0.48486924800079106, 0.487550160148436, 0.49022648328829116, 0.49289819222978404, 0.49556526182577254, 0.49822766697278187, 0.50088538261124071, 0.50353838372571758, 0.50618664534515523, 0.50883014254310699, 0.5114688504379703, 0.51410274419322166, 0.51673179901764987, 0.51935599016558964, 0.52197529293715439, 0.52458968267846895, 0.52719913478190139, 0.52980362468629461, 0.5324031278771979, 0.53499761988709715, 0.53758707629564539, 0.54017147272989285, 0.54275078486451589, 0.54532498842204646, 0.54789405917310019, 0.55045797293660481, 0.55301670558002747, 0.55557023301960218, 0.5581185312205561, 0.56066157619733603, 0.56319934401383409, 0.56573181078361312, 0.56825895267013149, 0.57078074588696726, 0.5732971666980422, 0.57580819141784534, 0.57831379641165559, 0.58081395809576453, 0.58330865293769829, 0.58579785745643886, 0.58828154822264522, 0.59075970185887416, 0.5932322950397998, 0.59569930449243336, 0.59816070699634238, 0.60061647938386897, 0.60306659854034816, 0.60551104140432555, 0.60794978496777363, 0.61038280627630948, 0.61281008242940971, 0.61523159058062682, 0.61764730793780387, 0.6200572117632891, 0.62246127937414997, 0.62485948814238634, 0.62725181549514408, 0.62963823891492698, 0.63201873593980906, 0.63439328416364549, 0.6367618612362842, 0.63912444486377573, 0.64148101280858316, 0.64383154288979139, 0.64617601298331628, 0.64851440102211244, 0.65084668499638099, 0.65317284295377676, 0.65549285299961535, 0.65780669329707864, 0.66011434206742048, 0.66241577759017178, 0.66471097820334479, 0.66699992230363747, 0.66928258834663601, 0.67155895484701833, 0.67382900037875604, 0.67609270357531592, 0.67835004312986147, 0.68060099779545302, 0.68284554638524808, 0.68508366777270036, 0.68731534089175905, 0.68954054473706683, 0.69175925836415775, 0.69397146088965389, 0.69617713149146299, 0.69837624940897292, 0.70056879394324834, 0.7027547444572253, 0.70493408037590488, 0.70710678118654746, 0.70927282643886558, 0.71143219574521632, 0.71358486878079352, 0.71573082528381859, 0.7178700450557316, 0.72000250796138165, 0.72212819392921523, 0.72424708295146689, 0.7263591550843459, 0.7284643904482252, 0.73056276922782759, 0.7326542716724127, 0.73473887809596339, 0.73681656887736979, 0.73888732446061511, 0.74095112535495899, 0.74300795213512161, 0.74505778544146595, 0.74710060598018013, 0.74913639452345926, 0.75116513190968637, 0.75318679904361241, 0.75520137689653644, 0.75720884650648446, 0.75920918897838796, 0.76120238548426178, 0.76318841726338127, 0.76516726562245885, 0.76713891193582029, 0.76910333764557959, 0.77106052426181371, 0.77301045336273688, 0.77495310659487382, 0.77688846567323244, 0.77881651238147587, 0.78073722857209438, 0.78265059616657562, 0.78455659715557524, 0.78645521359908577, 0.78834642762660623, 0.79023022143731003, 0.79210657730021228, 0.79397547755433706, 0.79583690460888346, 0.79769084094339104, 0.79953726910790501, 0.80137617172314013, 0.80320753148064483, 0.80503133114296355, 0.80684755354379922, 0.80865618158817498, 0.81045719825259477, 0.81225058658520388, 0.8140363297059483, 0.81581441080673378, 0.81758481315158371, 0.8193475200767969, 0.82110251499110465, 0.82284978137582632, 0.82458930278502529, 0.82632106284566342, 0.82804504525775569, 0.82976123379452305, 0.83146961230254512, 0.83317016470191319, 0.83486287498638001, 0.83654772722351189, 0.83822470555483797, 0.83989379419599941, 0.84155497743689833, 0.84320823964184544, 0.84485356524970701, 0.84649093877405202, 0.84812034480329712, 0.84974176800085244, 0.8513551931052652, 0.85296060493036363, 0.85455798836540053, 0.85614732837519436, 0.85772861000027212, 0.85930181835700825, 0.8608669386377672, 0.8624239561110405, 0.8639728561215867, 0.86551362409056898, 0.86704624551569265, 0.8685707059713409, 0.87008699110871135, 0.87159508665595098, 0.87309497841828998, 0.87458665227817611, 0.87607009419540649, 0.87754529020726124, 0.87901222642863341, 0.88047088905216075, 0.88192126434835494, 0.88336333866573158, 0.88479709843093779, 0.88622253014888064, 0.88763962040285393, 0.88904835585466446, 0.89044872324475788, 0.89184070939234272, 0.89322430119551532, 0.89459948563138258, 0.89596624975618511, 0.89732458070541832, 0.89867446569395382, 0.90001589201616028, 0.90134884704602203, 0.90267331823725883, 0.90398929312344334, 0.90529675931811882, 0.90659570451491533, 0.90788611648766615, 0.90916798309052238, 0.91044129225806714, 0.91170603200542988, 0.9129621904283981, 0.91420975570353069, 0.91544871608826783, 0.9166790599210427, 0.91790077562139039, 0.91911385169005777, 0.92031827670911048, 0.9215140393420419, 0.92270112833387852, 0.92387953251128674, 0.92504924078267758, 0.92621024213831138, 0.92736252565040111, 0.92850608047321548, 0.92964089584318121, 0.93076696107898371, 0.93188426558166815, 0.93299279883473885, 0.93409255040425887, 0.9351835099389475, 0.93626566717027826, 0.93733901191257496, 0.93840353406310806, 0.93945922360218992, 0.9405060705932683, 0.94154406518302081, 0.94257319760144687, 0.94359345816196039, 0.94460483726148026, 0.94560732538052128, 0.94660091308328353, 0.94758559101774109, 0.94856134991573027, 0.94952818059303667, 0.9504860739494817, 0.95143502096900834, 0.95237501271976588, 0.95330604035419375, 0.95422809510910567, 0.95514116830577067, 0.95604525134999641, 0.95694033573220894, 0.95782641302753291, 0.9587034748958716, 0.95957151308198452, 0.96043051941556579, 0.96128048581132064, 0.96212140426904158, 0.96295326687368388, 0.96377606579543984, 0.96458979328981265, 0.9653944416976894, 0.96619000344541262, 0.96697647104485207, 0.96775383709347551, 0.96852209427441727, 0.96928123535654853, 0.97003125319454397, 0.97077214072895035, 0.97150389098625178, 0.97222649707893627, 0.97293995220556007, 0.97364424965081187, 0.97433938278557586, 0.97502534506699412, 0.97570213003852857, 0.97636973133002114, 0.97702814265775439, 0.97767735782450993, 0.97831737071962765, 0.9789481753190622, 0.97956976568544052, 0.98018213596811732, 0.98078528040323043, 0.98137919331375456, 0.98196386910955524, 0.98253930228744124, 0.98310548743121629, 0.98366241921173025, 0.98421009238692903, 0.98474850180190421, 0.98527764238894122, 0.98579750916756737, 0.98630809724459867, 0.98680940181418542, 0.98730141815785843, 0.98778414164457218, 0.98825756773074946, 0.98872169196032378, 0.98917650996478101, 0.98962201746320078, 0.99005821026229712, 0.99048508425645698, 0.99090263542778001, 0.99131085984611544, 0.99170975366909953, 0.9920993131421918, 0.99247953459870997, 0.9928504144598651, 0.9932119492347945, 0.9935641355205953, 0.99390697000235606, 0.9942404494531879, 0.99456457073425542, 0.99487933079480562, 0.99518472667219682, 0.99548075549192694, 0.99576741446765982, 0.99604470090125197, 0.996312612182778, 0.99657114579055484, 0.99682029929116567, 0.99706007033948296, 0.99729045667869021, 0.99751145614030345, 0.99772306664419164, 0.997925286198596, 0.99811811290014918, 0.99830154493389289, 0.99847558057329477, 0.99864021818026527, 0.99879545620517241, 0.99894129318685687, 0.99907772775264536, 0.99920475861836389, 0.99932238458834954, 0.99943060455546173, 0.99952941750109314, 0.99961882249517864, 0.99969881869620425, 0.99976940535121528, 0.9998305817958234, 0.99988234745421256, 0.9999247018391445, 0.9999576445519639, 0.99998117528260111, 0.99999529380957619, 1.0};
@@ -43,6 +44,7 @@ typedef struct {
     PyObject *dur;
     Stream *dur_stream;
     int ngrains;
+    int maxgrains; /* allocated size of the grain arrays */
     MYFLT basedur;
     MYFLT pointerPos;
     MYFLT *startPos;
@@ -50,11 +52,15 @@ typedef struct {
     MYFLT *gphase;
     MYFLT *lastppos;
     int modebuffer[5];
+    PyoRand rng;
 } Granulator;
 
+/* Renders the grains one after the other over the whole buffer. `pointer`
+ * holds the position of the main pointer for each sample. `pos` and `dur`
+ * are NULL when the constants `cpos` and `cdur` are used. */
 static void
-Granulator_transform_iii(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos;
+Granulator_render(Granulator *self, MYFLT *pointer, MYFLT *pos, MYFLT cpos, MYFLT *dur, MYFLT cdur) {
+    MYFLT val, x, x1, index, fpart, amp, ppos, gphase, startPos, gsize, lastppos;
     int i, j, ipart;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -63,18 +69,18 @@ Granulator_transform_iii(Granulator *self) {
     MYFLT *envlist = TableStream_getData(self->env);
     int envsize = TableStream_getSize(self->env);
 
-    MYFLT pit = PyFloat_AS_DOUBLE(self->pitch);
-    MYFLT pos = PyFloat_AS_DOUBLE(self->pos);
-    MYFLT dur = PyFloat_AS_DOUBLE(self->dur);
-
-    inc = pit * (1.0 / self->basedur) / self->sr;
-
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = 0.0;
-        self->pointerPos += inc;
+    }
+
+    for (j=0; j<self->ngrains; j++) {
+        gphase = self->gphase[j];
+        startPos = self->startPos[j];
+        gsize = self->gsize[j];
+        lastppos = self->lastppos[j];
 
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
+        for (i=0; i<self->bufsize; i++) {
+            ppos = pointer[i] + gphase;
             if (ppos >= 1.0) {
                 ppos -= 1.0;
             }
@@ -86,14 +92,14 @@ Granulator_transform_iii(Granulator *self) {
             x1 = envlist[ipart+1];
             amp = x + (x1 - x) * fpart;
 
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos;
-                self->gsize[j] = dur * self->sr;
+            if (ppos < lastppos) {
+                startPos = pos == NULL ? cpos : pos[i];
+                gsize = (dur == NULL ? cdur : dur[i]) * self->sr;
             }
-            self->lastppos[j] = ppos;
+            lastppos = ppos;
 
             // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
+            index = ppos * gsize + startPos;
             if (index >= 0 && index < size) {
                 ipart = (int)index;
                 fpart = index - ipart;
@@ -107,23 +113,41 @@ Granulator_transform_iii(Granulator *self) {
             self->data[i] += (val * amp);
         }
 
+        self->startPos[j] = startPos;
+        self->gsize[j] = gsize;
+        self->lastppos[j] = lastppos;
+    }
+}
+
+static void
+Granulator_transform_iii(Granulator *self) {
+    MYFLT inc;
+    int i;
+    MYFLT pointer[self->bufsize];
+
+    MYFLT pit = PyFloat_AS_DOUBLE(self->pitch);
+    MYFLT pos = PyFloat_AS_DOUBLE(self->pos);
+    MYFLT dur = PyFloat_AS_DOUBLE(self->dur);
+
+    inc = pit * (1.0 / self->basedur) / self->sr;
+
+    for (i=0; i<self->bufsize; i++) {
+        self->pointerPos += inc;
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, NULL, pos, NULL, dur);
 }
 
 static void
 Granulator_transform_aii(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos, frtosamps;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc, frtosamps;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT *pit = Stream_getData((Stream *)self->pitch_stream);
     MYFLT pos = PyFloat_AS_DOUBLE(self->pos);
@@ -132,61 +156,23 @@ Granulator_transform_aii(Granulator *self) {
     frtosamps = (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         inc = pit[i] * frtosamps;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos;
-                self->gsize[j] = dur * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, NULL, pos, NULL, dur);
 }
 
 static void
 Granulator_transform_iai(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT pit = PyFloat_AS_DOUBLE(self->pitch);
     MYFLT *pos = Stream_getData((Stream *)self->pos_stream);
@@ -196,64 +182,27 @@ Granulator_transform_iai(Granulator *self) {
 
     MYFLT gsize = dur * self->sr;
 
-    for (j=0; j<self->ngrains; j++) {
-        self->gsize[j] = gsize;
+    for (i=0; i<self->ngrains; i++) {
+        self->gsize[i] = gsize;
     }
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos[i];
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, pos, 0.0, NULL, dur);
 }
 
 static void
 Granulator_transform_aai(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos, frtosamps;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc, frtosamps;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT *pit = Stream_getData((Stream *)self->pitch_stream);
     MYFLT *pos = Stream_getData((Stream *)self->pos_stream);
@@ -262,61 +211,23 @@ Granulator_transform_aai(Granulator *self) {
     frtosamps = (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         inc = pit[i] * frtosamps;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos[i];
-                self->gsize[j] = dur * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, pos, 0.0, NULL, dur);
 }
 
 static void
 Granulator_transform_iia(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT pit = PyFloat_AS_DOUBLE(self->pitch);
     MYFLT pos = PyFloat_AS_DOUBLE(self->pos);
@@ -325,60 +236,22 @@ Granulator_transform_iia(Granulator *self) {
     inc = pit * (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos;
-                self->gsize[j] = dur[i] * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, NULL, pos, dur, 0.0);
 }
 
 static void
 Granulator_transform_aia(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos, frtosamps;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc, frtosamps;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT *pit = Stream_getData((Stream *)self->pitch_stream);
     MYFLT pos = PyFloat_AS_DOUBLE(self->pos);
@@ -387,61 +260,23 @@ Granulator_transform_aia(Granulator *self) {
     frtosamps = (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         inc = pit[i] * frtosamps;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos;
-                self->gsize[j] = dur[i] * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, NULL, pos, dur, 0.0);
 }
 
 static void
 Granulator_transform_iaa(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT pit = PyFloat_AS_DOUBLE(self->pitch);
     MYFLT *pos = Stream_getData((Stream *)self->pos_stream);
@@ -450,60 +285,22 @@ Granulator_transform_iaa(Granulator *self) {
     inc = pit * (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos[i];
-                self->gsize[j] = dur[i] * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, pos, 0.0, dur, 0.0);
 }
 
 static void
 Granulator_transform_aaa(Granulator *self) {
-    MYFLT val, x, x1, inc, index, fpart, amp, ppos, frtosamps;
-    int i, j, ipart;
-
-    MYFLT *tablelist = TableStream_getData(self->table);
-    int size = TableStream_getSize(self->table);
-
-    MYFLT *envlist = TableStream_getData(self->env);
-    int envsize = TableStream_getSize(self->env);
+    MYFLT inc, frtosamps;
+    int i;
+    MYFLT pointer[self->bufsize];
 
     MYFLT *pit = Stream_getData((Stream *)self->pitch_stream);
     MYFLT *pos = Stream_getData((Stream *)self->pos_stream);
@@ -512,49 +309,16 @@ Granulator_transform_aaa(Granulator *self) {
     frtosamps = (1.0 / self->basedur) / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        self->data[i] = 0.0;
         inc = pit[i] * frtosamps;
         self->pointerPos += inc;
-
-        for (j=0; j<self->ngrains; j++) {
-            ppos = self->pointerPos + self->gphase[j];
-            if (ppos >= 1.0) {
-                ppos -= 1.0;
-            }
-            // compute envelope
-            index = ppos * envsize;
-            ipart = (int)index;
-            fpart = index - ipart;
-            x = envlist[ipart];
-            x1 = envlist[ipart+1];
-            amp = x + (x1 - x) * fpart;
-
-            if (ppos < self->lastppos[j]) {
-                self->startPos[j] = pos[i];
-                self->gsize[j] = dur[i] * self->sr;
-            }
-            self->lastppos[j] = ppos;
-
-            // compute sampling
-            index = ppos * self->gsize[j] + self->startPos[j];
-            if (index >= 0 && index < size) {
-                ipart = (int)index;
-                fpart = index - ipart;
-                x = tablelist[ipart];
-                x1 = tablelist[ipart+1];
-                val = x + (x1 - x) * fpart;
-            }
-            else
-                val = 0.0;
-
-            self->data[i] += (val * amp);
-        }
-
+        pointer[i] = self->pointerPos;
         if (self->pointerPos < 0)
             self->pointerPos += 1.0;
         else if (self->pointerPos >= 1)
             self->pointerPos -= 1.0;
     }
+
+    Granulator_render(self, pointer, pos, 0.0, dur, 0.0);
 }
 
 static void Granulator_postprocessing_ii(Granulator *self) { POST_PROCESSING_II };
@@ -746,15 +510,17 @@ Granulator_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
+    self->maxgrains = self->ngrains;
     self->startPos = (MYFLT *)realloc(self->startPos, self->ngrains * sizeof(MYFLT));
     self->gsize = (MYFLT *)realloc(self->gsize, self->ngrains * sizeof(MYFLT));
     self->gphase = (MYFLT *)realloc(self->gphase, self->ngrains * sizeof(MYFLT));
     self->lastppos = (MYFLT *)realloc(self->lastppos, self->ngrains * sizeof(MYFLT));
+    Stream_setMemory(self->stream, 4 * self->maxgrains * sizeof(MYFLT));
 
-    Server_generateSeed((Server *)self->server, GRANULATOR_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, GRANULATOR_ID));
 
     for (i=0; i<self->ngrains; i++) {
-        phase = ((MYFLT)i/self->ngrains) * (1.0 + ((rand()/((MYFLT)(RAND_MAX)+1)*2.0-1.0) * 0.01));
+        phase = ((MYFLT)i/self->ngrains) * (1.0 + ((RANDOM_UNIFORM*2.0-1.0) * 0.01));
         if (phase < 0.0)
             phase = 0.0;
         else if (phase >= 1.0)
@@ -958,13 +724,18 @@ Granulator_setGrains(Granulator *self, PyObject *arg)
     MYFLT phase;
 	if (PyLong_Check(arg) || PyInt_Check(arg)) {
         self->ngrains = PyLong_AsLong(arg);
-        self->startPos = (MYFLT *)realloc(self->startPos, self->ngrains * sizeof(MYFLT));
-        self->gsize = (MYFLT *)realloc(self->gsize, self->ngrains * sizeof(MYFLT));
-        self->gphase = (MYFLT *)realloc(self->gphase, self->ngrains * sizeof(MYFLT));
-        self->lastppos = (MYFLT *)realloc(self->lastppos, self->ngrains * sizeof(MYFLT));
+        /* The arrays only grow, reducing the number of grains never reallocates. */
+        if (self->ngrains > self->maxgrains) {
+            self->maxgrains = self->ngrains;
+            self->startPos = (MYFLT *)realloc(self->startPos, self->maxgrains * sizeof(MYFLT));
+            self->gsize = (MYFLT *)realloc(self->gsize, self->maxgrains * sizeof(MYFLT));
+            self->gphase = (MYFLT *)realloc(self->gphase, self->maxgrains * sizeof(MYFLT));
+            self->lastppos = (MYFLT *)realloc(self->lastppos, self->maxgrains * sizeof(MYFLT));
+            Stream_setMemory(self->stream, 4 * self->maxgrains * sizeof(MYFLT));
+        }
 
         for (i=0; i<self->ngrains; i++) {
-            phase = ((MYFLT)i/self->ngrains) * (1.0 + ((rand()/((MYFLT)(RAND_MAX)+1)*2.0-1.0) * 0.01));
+            phase = ((MYFLT)i/self->ngrains) * (1.0 + ((RANDOM_UNIFORM*2.0-1.0) * 0.01));
             if (phase < 0.0)
                 phase = 0.0;
             else if (phase >= 1.0)
@@ -1125,7 +896,6 @@ typedef struct {
     long maxfadepoint[2];
     MYFLT *fader;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
     int modebuffer[6];
     int autosmooth;
     MYFLT lastpitch;
@@ -1283,7 +1053,8 @@ Looper_transform_i(Looper *self) {
     double pit;
     int i, j, ipart;
 
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpFunc interp = TableInterp_get(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
     double tableSr = TableStream_getSamplingRate(self->table);
 
@@ -1316,7 +1087,7 @@ Looper_transform_i(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] += pit;
                         if (self->pointerPos[j] < 0.0)
@@ -1340,7 +1111,7 @@ Looper_transform_i(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] += pit;
                         if (self->pointerPos[j] < 0.0)
@@ -1364,7 +1135,7 @@ Looper_transform_i(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] -= pit;
                         if (self->pointerPos[j] >= size)
@@ -1389,7 +1160,7 @@ Looper_transform_i(Looper *self) {
                                     amp = 1.0;
                                 ipart = (int)self->pointerPos[j];
                                 fpart = self->pointerPos[j] - ipart;
-                                self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                                self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                             }
                             self->pointerPos[j] += pit;
                             if (self->pointerPos[j] < 0.0)
@@ -1413,7 +1184,7 @@ Looper_transform_i(Looper *self) {
                                     amp = 1.0;
                                 ipart = (int)self->pointerPos[j];
                                 fpart = self->pointerPos[j] - ipart;
-                                self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                                self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                             }
                             self->pointerPos[j] -= pit;
                             if (self->pointerPos[j] >= size)
@@ -1452,7 +1223,8 @@ Looper_transform_a(Looper *self) {
     double pit, srFactor;
     int i, j, ipart;
 
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpFunc interp = TableInterp_get(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
     double tableSr = TableStream_getSamplingRate(self->table);
 
@@ -1487,7 +1259,7 @@ Looper_transform_a(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] += pit;
                         if (self->pointerPos[j] < 0.0)
@@ -1511,7 +1283,7 @@ Looper_transform_a(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] += pit;
                         if (self->pointerPos[j] < 0.0)
@@ -1535,7 +1307,7 @@ Looper_transform_a(Looper *self) {
                                 amp = 1.0;
                             ipart = (int)self->pointerPos[j];
                             fpart = self->pointerPos[j] - ipart;
-                            self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                            self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                         }
                         self->pointerPos[j] -= pit;
                         if (self->pointerPos[j] >= size)
@@ -1560,7 +1332,7 @@ Looper_transform_a(Looper *self) {
                                     amp = 1.0;
                                 ipart = (int)self->pointerPos[j];
                                 fpart = self->pointerPos[j] - ipart;
-                                self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                                self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                             }
                             self->pointerPos[j] += pit;
                             if (self->pointerPos[j] < 0.0)
@@ -1584,7 +1356,7 @@ Looper_transform_a(Looper *self) {
                                     amp = 1.0;
                                 ipart = (int)self->pointerPos[j];
                                 fpart = self->pointerPos[j] - ipart;
-                                self->data[i] += (*self->interp_func_ptr)(tablelist, ipart, fpart, size) * amp;
+                                self->data[i] += (*interp)(tablelist, ipart, fpart, size) * amp;
                             }
                             self->pointerPos[j] -= pit;
                             if (self->pointerPos[j] >= size)
@@ -1754,6 +1526,7 @@ Looper_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Looper_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = Looper_setProcMode;
 
     static char *kwlist[] = {"table", "pitch", "start", "dur", "xfade", "mode", "xfadeshape", "startfromloop", "interp", "autosmooth", "mul", "add", NULL};
@@ -1801,7 +1574,7 @@ Looper_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     else
         self->mode[0] = self->mode[1] = self->tmpmode = 1;
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -2052,7 +1825,7 @@ Looper_setInterp(Looper *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2206,6 +1979,89 @@ PyTypeObject LooperType = {
     Looper_new,                 /* tp_new */
 };
 
+/* Grains of Granule and Particle.
+ *
+ * Active grains are packed at the beginning of their arrays, a free slot is
+ * always the one following the last active grain and a grain that ends is
+ * replaced by the last one, so the cost follows the number of active grains,
+ * not the size of the pool. A new grain records the sample where it starts
+ * in the buffer; once the grains of a buffer are known, each one is rendered
+ * on its whole span in one pass. */
+
+/* The grains are records drawn from a pool shared by all the Granule and
+ * Particle objects, the audio thread never allocates them. Each object
+ * reserves GRAIN_RESERVE records of the pool when it is created and keeps
+ * one record ready in `next` for the coming grain. */
+typedef struct {
+    MYFLT gpos;
+    MYFLT glen;
+    MYFLT inc;
+    MYFLT phase;
+    MYFLT amp1;
+    MYFLT amp2;
+    int k1; /* offsets of the output channels */
+    int k2;
+    int start; /* first sample of the grain in the current buffer */
+} Grain;
+
+#define GRAIN_RESERVE 1024
+
+static VoicePool *Grain_pool = NULL;
+
+static void
+Grain_reserve() {
+    if (Grain_pool == NULL)
+        Grain_pool = VoicePool_new(sizeof(Grain), 4 * GRAIN_RESERVE);
+    VoicePool_reserve(Grain_pool, GRAIN_RESERVE);
+}
+
+/* Gives back the active grains and the reservation of an object. */
+static void
+Grain_release(Grain **grains, int num, Grain *next) {
+    int j;
+
+    for (j=0; j<num; j++) {
+        VoicePool_put(Grain_pool, grains[j]);
+    }
+    if (next != NULL)
+        VoicePool_put(Grain_pool, next);
+    VoicePool_release(Grain_pool, GRAIN_RESERVE);
+}
+
+/* Adds the grain to `out`, or panned to `out` and `out2` if not NULL, from
+ * its start to `num` or to its end. Returns 1 if the grain is over. */
+static int
+Grain_render(Grain *g, MYFLT *out, MYFLT *out2, int num,
+             MYFLT *tablelist, MYFLT *envlist, int envsize) {
+    MYFLT index, amp, val;
+    MYFLT gpos = g->gpos, glen = g->glen, inc = g->inc, phase = g->phase;
+    MYFLT amp1 = g->amp1, amp2 = g->amp2;
+    int i, ipart;
+
+    for (i=g->start; i<num; i++) {
+        /* compute envelope */
+        index = phase * envsize;
+        ipart = (int)index;
+        amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
+        /* compute sampling */
+        index = phase * glen + gpos;
+        ipart = (int)index;
+        val = (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
+        if (out2 == NULL)
+            out[i] += val;
+        else {
+            out[i] += val * amp1;
+            out2[i] += val * amp2;
+        }
+        phase += inc;
+        if (phase >= 1.0)
+            return 1;
+    }
+    g->phase = phase;
+    g->start = 0;
+    return 0;
+}
+
 static const MYFLT Granule_MAX_GRAINS = 4096;
 typedef struct {
     pyo_audio_HEAD
@@ -2219,23 +2075,37 @@ typedef struct {
     Stream *pos_stream;
     PyObject *dur;
     Stream *dur_stream;
-    MYFLT *gpos;
-    MYFLT *glen;
-    MYFLT *inc;
-    MYFLT *phase;
-    int *flags;
-    int num;
+    Grain **grains;
+    Grain *next; /* record of the coming grain, NULL when the pool is empty */
+    int num; /* number of active grains */
     int sync;
     double timer;
     MYFLT oneOnSr;
     MYFLT srOnRandMax;
     int modebuffer[6];
+    PyoRand rng;
 } Granule;
 
+static void
+Granule_render(Granule *self, MYFLT *tablelist, MYFLT *envlist, int envsize) {
+    int j = 0, last;
+
+    while (j < self->num) {
+        if (Grain_render(self->grains[j], self->data, NULL, self->bufsize, tablelist, envlist, envsize)) {
+            VoicePool_put(Grain_pool, self->grains[j]);
+            last = --self->num;
+            self->grains[j] = self->grains[last];
+        }
+        else
+            j++;
+    }
+}
+
 static void
 Granule_transform_i(Granule *self) {
-    MYFLT dens, inc, index, amp, phase;
-    int i, j, ipart, flag = 0;
+    MYFLT dens, inc;
+    int i, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -2262,75 +2132,55 @@ Granule_transform_i(Granule *self) {
             }
         } else {
             /* asynchronous */
-            if ((rand() * self->srOnRandMax) < dens)
+            if ((RANDOM_INT * self->srOnRandMax) < dens)
                 flag = 1;
         }
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<Granule_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[3] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[5] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    break;
-                }
-            }
-        }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                /* compute envelope */
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                /* compute sampling */
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                self->data[i] += (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
+            if (self->num < Granule_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[3] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
                 else
-                    self->phase[j] = phase;
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[5] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
+                else
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
             }
         }
         flag = 0;
     }
+
+    Granule_render(self, tablelist, envlist, envsize);
 }
 
 static void
 Granule_transform_a(Granule *self) {
-    MYFLT index, amp, phase;
-    int i, j, ipart, flag = 0;
+    int i, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -2353,69 +2203,49 @@ Granule_transform_a(Granule *self) {
             }
         } else {
             /* asynchronous */
-            if ((rand() * self->srOnRandMax) < density[i])
+            if ((RANDOM_INT * self->srOnRandMax) < density[i])
                 flag = 1;
         }
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<Granule_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[3] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[5] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    break;
-                }
-            }
-        }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                // compute envelope
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                // compute sampling
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                self->data[i] += (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
+            if (self->num < Granule_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[3] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
                 else
-                    self->phase[j] = phase;
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[5] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
+                else
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
             }
         }
         flag = 0;
     }
+
+    Granule_render(self, tablelist, envlist, envsize);
 }
 
 static void Granule_postprocessing_ii(Granule *self) { POST_PROCESSING_II };
@@ -2519,11 +2349,9 @@ static void
 Granule_dealloc(Granule* self)
 {
     pyo_DEALLOC
-    free(self->gpos);
-    free(self->glen);
-    free(self->inc);
-    free(self->flags);
-    free(self->phase);
+    if (self->grains != NULL)
+        Grain_release(self->grains, self->num, self->next);
+    free(self->grains);
     Granule_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -2553,7 +2381,7 @@ Granule_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     self->oneOnSr = 1.0 / self->sr;
-    self->srOnRandMax = self->sr / (MYFLT)RAND_MAX;
+    self->srOnRandMax = self->sr / (MYFLT)RANDOM_MAX;
 
     Stream_setFunctionPtr(self->stream, Granule_compute_next_data_frame);
     self->mode_func_ptr = Granule_setProcMode;
@@ -2603,18 +2431,12 @@ Granule_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    self->gpos = (MYFLT *)realloc(self->gpos, Granule_MAX_GRAINS * sizeof(MYFLT));
-    self->glen = (MYFLT *)realloc(self->glen, Granule_MAX_GRAINS * sizeof(MYFLT));
-    self->inc = (MYFLT *)realloc(self->inc, Granule_MAX_GRAINS * sizeof(MYFLT));
-    self->phase = (MYFLT *)realloc(self->phase, Granule_MAX_GRAINS * sizeof(MYFLT));
-    self->flags = (int *)realloc(self->flags, Granule_MAX_GRAINS * sizeof(int));
+    self->grains = (Grain **)realloc(self->grains, (int)Granule_MAX_GRAINS * sizeof(Grain *));
+    Grain_reserve();
+    /* The grains come from the pool shared by every granular object. */
+    Stream_setMemory(self->stream, (int)Granule_MAX_GRAINS * sizeof(Grain *));
 
-    for (i=0; i<Granule_MAX_GRAINS; i++) {
-        self->gpos[i] = self->glen[i] = self->inc[i] = self->phase[i] = 0.0;
-        self->flags[i] = 0;
-    }
-
-    Server_generateSeed((Server *)self->server, GRANULE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, GRANULE_ID));
 
     (*self->mode_func_ptr)(self);
 
@@ -2973,16 +2795,9 @@ typedef struct {
     Stream *dev_stream;
     PyObject *pan;
     Stream *pan_stream;
-    MYFLT *gpos;
-    MYFLT *glen;
-    MYFLT *inc;
-    MYFLT *phase;
-    MYFLT *amp1;
-    MYFLT *amp2;
-    int *flags;
-    int *k1;
-    int *k2;
-    int num;
+    Grain **grains;
+    Grain *next; /* record of the coming grain, NULL when the pool is empty */
+    int num; /* number of active grains */
     int chnls;
     double timer;
     double devFactor;
@@ -2991,12 +2806,47 @@ typedef struct {
     MYFLT srOnRandMax;
     MYFLT *buffer_streams;
     int modebuffer[6];
+    PyoRand rng;
 } MainParticle;
 
+static void
+MainParticle_remove(MainParticle *self, int j) {
+    int last = --self->num;
+
+    VoicePool_put(Grain_pool, self->grains[j]);
+    self->grains[j] = self->grains[last];
+}
+
+static void
+MainParticle_render_mono(MainParticle *self, MYFLT *tablelist, MYFLT *envlist, int envsize) {
+    int j = 0;
+
+    while (j < self->num) {
+        if (Grain_render(self->grains[j], self->buffer_streams, NULL, self->bufsize, tablelist, envlist, envsize))
+            MainParticle_remove(self, j);
+        else
+            j++;
+    }
+}
+
+static void
+MainParticle_render(MainParticle *self, MYFLT *tablelist, MYFLT *envlist, int envsize) {
+    int j = 0;
+
+    while (j < self->num) {
+        if (Grain_render(self->grains[j], self->buffer_streams + self->grains[j]->k1, self->buffer_streams + self->grains[j]->k2,
+                         self->bufsize, tablelist, envlist, envsize))
+            MainParticle_remove(self, j);
+        else
+            j++;
+    }
+}
+
 static void
 MainParticle_transform_mono_i(MainParticle *self) {
-    MYFLT dens, inc, index, amp, phase, val;
-    int i, j, ipart, flag = 0;
+    MYFLT dens, inc;
+    int i, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0, dev = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -3024,79 +2874,59 @@ MainParticle_transform_mono_i(MainParticle *self) {
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<MAINPARTICLE_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[1] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[2] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[3] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        dev = PyFloat_AS_DOUBLE(self->dev);
-                    else
-                        dev = Stream_getData((Stream *)self->dev_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    if (dev < 0.0)
-                        dev = 0.0;
-                    else if (dev > 1.0)
-                        dev = 1.0;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit * self->srScale;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    self->devFactor = (rand() / (MYFLT)RAND_MAX * 2.0 - 1.0) * dev + 1.0;
-                    break;
-                }
-            }
-        }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                /* compute envelope */
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                /* compute sampling */
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                val = (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                self->buffer_streams[i] += val;
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
+            if (self->num < MAINPARTICLE_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[1] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[2] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
+                else
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[3] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
                 else
-                    self->phase[j] = phase;
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    dev = PyFloat_AS_DOUBLE(self->dev);
+                else
+                    dev = Stream_getData((Stream *)self->dev_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                if (dev < 0.0)
+                    dev = 0.0;
+                else if (dev > 1.0)
+                    dev = 1.0;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit * self->srScale;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
+                self->devFactor = (RANDOM_INT / (MYFLT)RANDOM_MAX * 2.0 - 1.0) * dev + 1.0;
             }
         }
         flag = 0;
     }
+
+    MainParticle_render_mono(self, tablelist, envlist, envsize);
 }
 
 static void
 MainParticle_transform_mono_a(MainParticle *self) {
-    MYFLT dens, index, amp, phase, val;
-    int i, j, ipart, flag = 0;
+    MYFLT dens;
+    int i, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0, dev = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -3124,79 +2954,59 @@ MainParticle_transform_mono_a(MainParticle *self) {
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<MAINPARTICLE_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[1] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[2] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[3] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        dev = PyFloat_AS_DOUBLE(self->dev);
-                    else
-                        dev = Stream_getData((Stream *)self->dev_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    if (dev < 0.0)
-                        dev = 0.0;
-                    else if (dev > 1.0)
-                        dev = 1.0;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit * self->srScale;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    self->devFactor = (rand() / (MYFLT)RAND_MAX * 2.0 - 1.0) * dev + 1.0;
-                    break;
-                }
-            }
-        }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                /* compute envelope */
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                /* compute sampling */
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                val = (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                self->buffer_streams[i] += val;
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
+            if (self->num < MAINPARTICLE_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[1] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[2] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
+                else
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[3] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
                 else
-                    self->phase[j] = phase;
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    dev = PyFloat_AS_DOUBLE(self->dev);
+                else
+                    dev = Stream_getData((Stream *)self->dev_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                if (dev < 0.0)
+                    dev = 0.0;
+                else if (dev > 1.0)
+                    dev = 1.0;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit * self->srScale;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
+                self->devFactor = (RANDOM_INT / (MYFLT)RANDOM_MAX * 2.0 - 1.0) * dev + 1.0;
             }
         }
         flag = 0;
     }
+
+    MainParticle_render_mono(self, tablelist, envlist, envsize);
 }
 
 static void
 MainParticle_transform_i(MainParticle *self) {
-    MYFLT dens, inc, index, amp, phase, val, min = 0;
-    int i, j, l, l1, ipart, flag = 0;
+    MYFLT dens, inc, min = 0;
+    int i, l, l1, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0, dev = 0, pan = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -3224,113 +3034,92 @@ MainParticle_transform_i(MainParticle *self) {
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<MAINPARTICLE_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[1] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[2] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[3] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        dev = PyFloat_AS_DOUBLE(self->dev);
-                    else
-                        dev = Stream_getData((Stream *)self->dev_stream)[i];
-                    if (self->modebuffer[5] == 0)
-                        pan = PyFloat_AS_DOUBLE(self->pan);
-                    else
-                        pan = Stream_getData((Stream *)self->pan_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    if (dev < 0.0)
-                        dev = 0.0;
-                    else if (dev > 1.0)
-                        dev = 1.0;
-                    if (pan < 0.0)
-                        pan = 0.0;
-                    else if (pan > 1.0)
-                        pan = 1.0;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit * self->srScale;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    self->devFactor = (rand() / (MYFLT)RAND_MAX * 2.0 - 1.0) * dev + 1.0;
-                    if (self->chnls == 2) {
-                        self->k1[j] = 0;
-                        self->k2[j] = self->bufsize;
-                        self->amp1[j] = MYSQRT(1.0 - pan);
-                        self->amp2[j] = MYSQRT(pan);
-                    }
-                    else {
-                        self->amp1[j] = MYSQRT(1.0 - pan);
-                        self->amp2[j] = MYSQRT(pan);
-                        min = 0;
-                        self->k1[j] = 0;
-                        self->k2[j] = self->bufsize;
-                        for (l=self->chnls; l>0; l--) {
-                            l1 = l - 1;
-                            min = l1 / (MYFLT)self->chnls;
-                            if (pan > min) {
-                                self->k1[j] = l1 * self->bufsize;
-                                if (l == self->chnls)
-                                    self->k2[j] = 0;
-                                else
-                                    self->k2[j] = l * self->bufsize;
-                                break;
-                            }
+            if (self->num < MAINPARTICLE_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[1] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[2] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
+                else
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[3] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
+                else
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    dev = PyFloat_AS_DOUBLE(self->dev);
+                else
+                    dev = Stream_getData((Stream *)self->dev_stream)[i];
+                if (self->modebuffer[5] == 0)
+                    pan = PyFloat_AS_DOUBLE(self->pan);
+                else
+                    pan = Stream_getData((Stream *)self->pan_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                if (dev < 0.0)
+                    dev = 0.0;
+                else if (dev > 1.0)
+                    dev = 1.0;
+                if (pan < 0.0)
+                    pan = 0.0;
+                else if (pan > 1.0)
+                    pan = 1.0;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit * self->srScale;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
+                self->devFactor = (RANDOM_INT / (MYFLT)RANDOM_MAX * 2.0 - 1.0) * dev + 1.0;
+                if (self->chnls == 2) {
+                    g->k1 = 0;
+                    g->k2 = self->bufsize;
+                    g->amp1 = MYSQRT(1.0 - pan);
+                    g->amp2 = MYSQRT(pan);
+                }
+                else {
+                    g->amp1 = MYSQRT(1.0 - pan);
+                    g->amp2 = MYSQRT(pan);
+                    min = 0;
+                    g->k1 = 0;
+                    g->k2 = self->bufsize;
+                    for (l=self->chnls; l>0; l--) {
+                        l1 = l - 1;
+                        min = l1 / (MYFLT)self->chnls;
+                        if (pan > min) {
+                            g->k1 = l1 * self->bufsize;
+                            if (l == self->chnls)
+                                g->k2 = 0;
+                            else
+                                g->k2 = l * self->bufsize;
+                            break;
                         }
                     }
-                    break;
                 }
             }
         }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                /* compute envelope */
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                /* compute sampling */
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                val = (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                self->buffer_streams[i+self->k1[j]] += val * self->amp1[j];
-                self->buffer_streams[i+self->k2[j]] += val * self->amp2[j];
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
-                else
-                    self->phase[j] = phase;
-            }
-        }
         flag = 0;
     }
+
+    MainParticle_render(self, tablelist, envlist, envsize);
 }
 
 static void
 MainParticle_transform_a(MainParticle *self) {
-    MYFLT dens, index, amp, phase, val, min = 0;
-    int i, j, l, l1, ipart, flag = 0;
+    MYFLT dens, min = 0;
+    int i, l, l1, flag = 0;
+    Grain *g;
     MYFLT pit = 0, pos = 0, dur = 0, dev = 0, pan = 0;
 
     MYFLT *tablelist = TableStream_getData(self->table);
@@ -3358,107 +3147,85 @@ MainParticle_transform_a(MainParticle *self) {
 
         /* need to start a new grain */
         if (flag) {
-            for (j=0; j<MAINPARTICLE_MAX_GRAINS; j++) {
-                if (self->flags[j] == 0) {
-                    self->flags[j] = 1;
-                    if (j >= self->num)
-                        self->num = j + 1;
-                    if (self->modebuffer[1] == 0)
-                        pit = PyFloat_AS_DOUBLE(self->pitch);
-                    else
-                        pit = Stream_getData((Stream *)self->pitch_stream)[i];
-                    if (self->modebuffer[2] == 0)
-                        pos = PyFloat_AS_DOUBLE(self->pos);
-                    else
-                        pos = Stream_getData((Stream *)self->pos_stream)[i];
-                    if (self->modebuffer[3] == 0)
-                        dur = PyFloat_AS_DOUBLE(self->dur);
-                    else
-                        dur = Stream_getData((Stream *)self->dur_stream)[i];
-                    if (self->modebuffer[4] == 0)
-                        dev = PyFloat_AS_DOUBLE(self->dev);
-                    else
-                        dev = Stream_getData((Stream *)self->dev_stream)[i];
-                    if (self->modebuffer[5] == 0)
-                        pan = PyFloat_AS_DOUBLE(self->pan);
-                    else
-                        pan = Stream_getData((Stream *)self->pan_stream)[i];
-                    if (pit < 0.0)
-                        pit = -pit;
-                    if (pos < 0.0)
-                        pos = 0.0;
-                    else if (pos >= size)
-                        pos = (MYFLT)size;
-                    if (dur < 0.0001)
-                        dur = 0.0001;
-                    if (dev < 0.0)
-                        dev = 0.0;
-                    else if (dev > 1.0)
-                        dev = 1.0;
-                    if (pan < 0.0)
-                        pan = 0.0;
-                    else if (pan > 1.0)
-                        pan = 1.0;
-                    self->gpos[j] = pos;
-                    self->glen[j] = dur * self->sr * pit * self->srScale;
-                    if ((pos + self->glen[j]) >= size || (pos + self->glen[j]) < 0)
-                        self->flags[j] = 0;
-                    self->phase[j] = 0.0;
-                    self->inc[j] = 1.0 / (dur * self->sr);
-                    self->devFactor = (rand() / (MYFLT)RAND_MAX * 2.0 - 1.0) * dev + 1.0;
-                    if (self->chnls == 2) {
-                        self->k1[j] = 0;
-                        self->k2[j] = self->bufsize;
-                        self->amp1[j] = MYSQRT(1.0 - pan);
-                        self->amp2[j] = MYSQRT(pan);
-                    }
-                    else {
-                        self->amp1[j] = MYSQRT(1.0 - pan);
-                        self->amp2[j] = MYSQRT(pan);
-                        min = 0;
-                        self->k1[j] = 0;
-                        self->k2[j] = self->bufsize;
-                        for (l=self->chnls; l>0; l--) {
-                            l1 = l - 1;
-                            min = l1 / (MYFLT)self->chnls;
-                            if (pan > min) {
-                                self->k1[j] = l1 * self->bufsize;
-                                if (l == self->chnls)
-                                    self->k2[j] = 0;
-                                else
-                                    self->k2[j] = l * self->bufsize;
-                                break;
-                            }
+            if (self->num < MAINPARTICLE_MAX_GRAINS && (self->next != NULL || (self->next = (Grain *)VoicePool_get(Grain_pool)) != NULL)) {
+                g = self->next;
+                if (self->modebuffer[1] == 0)
+                    pit = PyFloat_AS_DOUBLE(self->pitch);
+                else
+                    pit = Stream_getData((Stream *)self->pitch_stream)[i];
+                if (self->modebuffer[2] == 0)
+                    pos = PyFloat_AS_DOUBLE(self->pos);
+                else
+                    pos = Stream_getData((Stream *)self->pos_stream)[i];
+                if (self->modebuffer[3] == 0)
+                    dur = PyFloat_AS_DOUBLE(self->dur);
+                else
+                    dur = Stream_getData((Stream *)self->dur_stream)[i];
+                if (self->modebuffer[4] == 0)
+                    dev = PyFloat_AS_DOUBLE(self->dev);
+                else
+                    dev = Stream_getData((Stream *)self->dev_stream)[i];
+                if (self->modebuffer[5] == 0)
+                    pan = PyFloat_AS_DOUBLE(self->pan);
+                else
+                    pan = Stream_getData((Stream *)self->pan_stream)[i];
+                if (pit < 0.0)
+                    pit = -pit;
+                if (pos < 0.0)
+                    pos = 0.0;
+                else if (pos >= size)
+                    pos = (MYFLT)size;
+                if (dur < 0.0001)
+                    dur = 0.0001;
+                if (dev < 0.0)
+                    dev = 0.0;
+                else if (dev > 1.0)
+                    dev = 1.0;
+                if (pan < 0.0)
+                    pan = 0.0;
+                else if (pan > 1.0)
+                    pan = 1.0;
+                g->gpos = pos;
+                g->glen = dur * self->sr * pit * self->srScale;
+                if ((pos + g->glen) < size && (pos + g->glen) >= 0) {
+                    g->start = i;
+                    self->grains[self->num++] = g;
+                    self->next = NULL;
+                }
+                g->phase = 0.0;
+                g->inc = 1.0 / (dur * self->sr);
+                self->devFactor = (RANDOM_INT / (MYFLT)RANDOM_MAX * 2.0 - 1.0) * dev + 1.0;
+                if (self->chnls == 2) {
+                    g->k1 = 0;
+                    g->k2 = self->bufsize;
+                    g->amp1 = MYSQRT(1.0 - pan);
+                    g->amp2 = MYSQRT(pan);
+                }
+                else {
+                    g->amp1 = MYSQRT(1.0 - pan);
+                    g->amp2 = MYSQRT(pan);
+                    min = 0;
+                    g->k1 = 0;
+                    g->k2 = self->bufsize;
+                    for (l=self->chnls; l>0; l--) {
+                        l1 = l - 1;
+                        min = l1 / (MYFLT)self->chnls;
+                        if (pan > min) {
+                            g->k1 = l1 * self->bufsize;
+                            if (l == self->chnls)
+                                g->k2 = 0;
+                            else
+                                g->k2 = l * self->bufsize;
+                            break;
                         }
                     }
-                    break;
                 }
             }
         }
-
-        /* compute active grains */
-        for (j=0; j<self->num; j++) {
-            if (self->flags[j]) {
-                phase = self->phase[j];
-                /* compute envelope */
-                index = phase * envsize;
-                ipart = (int)index;
-                amp = envlist[ipart] + (envlist[ipart+1] - envlist[ipart]) * (index - ipart);
-                /* compute sampling */
-                index = phase * self->glen[j] + self->gpos[j];
-                ipart = (int)index;
-                val = (tablelist[ipart] + (tablelist[ipart+1] - tablelist[ipart]) * (index - ipart)) * amp;
-                self->buffer_streams[i+self->k1[j]] += val * self->amp1[j];
-                self->buffer_streams[i+self->k2[j]] += val * self->amp2[j];
-                phase += self->inc[j];
-                if (phase >= 1.0)
-                    self->flags[j] = 0;
-                else
-                    self->phase[j] = phase;
-            }
-        }
         flag = 0;
     }
+
+    MainParticle_render(self, tablelist, envlist, envsize);
 }
 
 static void
@@ -3534,15 +3301,9 @@ static void
 MainParticle_dealloc(MainParticle* self)
 {
     pyo_DEALLOC
-    free(self->gpos);
-    free(self->glen);
-    free(self->inc);
-    free(self->flags);
-    free(self->k1);
-    free(self->k2);
-    free(self->phase);
-    free(self->amp1);
-    free(self->amp2);
+    if (self->grains != NULL)
+        Grain_release(self->grains, self->num, self->next);
+    free(self->grains);
     free(self->buffer_streams);
     MainParticle_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -3582,7 +3343,7 @@ MainParticle_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     self->oneOnSr = 1.0 / self->sr;
-    self->srOnRandMax = self->sr / (MYFLT)RAND_MAX;
+    self->srOnRandMax = self->sr / (MYFLT)RANDOM_MAX;
 
     Stream_setFunctionPtr(self->stream, MainParticle_compute_next_data_frame);
     self->mode_func_ptr = MainParticle_setProcMode;
@@ -3636,27 +3397,16 @@ MainParticle_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     if (self->chnls < 1)
         self->chnls = 1;
 
-    self->gpos = (MYFLT *)realloc(self->gpos, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->glen = (MYFLT *)realloc(self->glen, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->inc = (MYFLT *)realloc(self->inc, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->phase = (MYFLT *)realloc(self->phase, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->amp1 = (MYFLT *)realloc(self->amp1, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->amp2 = (MYFLT *)realloc(self->amp2, MAINPARTICLE_MAX_GRAINS * sizeof(MYFLT));
-    self->flags = (int *)realloc(self->flags, MAINPARTICLE_MAX_GRAINS * sizeof(int));
-    self->k1 = (int *)realloc(self->k1, MAINPARTICLE_MAX_GRAINS * sizeof(int));
-    self->k2 = (int *)realloc(self->k2, MAINPARTICLE_MAX_GRAINS * sizeof(int));
-
-    for (i=0; i<MAINPARTICLE_MAX_GRAINS; i++) {
-        self->gpos[i] = self->glen[i] = self->inc[i] = self->phase[i] = self->amp1[i] = self->amp2[i] = 0.0;
-        self->flags[i] = self->k1[i] = self->k2[i] = 0;
-    }
+    self->grains = (Grain **)realloc(self->grains, (int)MAINPARTICLE_MAX_GRAINS * sizeof(Grain *));
+    Grain_reserve();
 
     self->buffer_streams = (MYFLT *)realloc(self->buffer_streams, self->bufsize * self->chnls * sizeof(MYFLT));
     for (i=0; i<self->bufsize*self->chnls; i++) {
         self->buffer_streams[i] = 0.0;
     }
+    Stream_setMemory(self->stream, (int)MAINPARTICLE_MAX_GRAINS * sizeof(Grain *) + self->bufsize * self->chnls * sizeof(MYFLT));
 
-    Server_generateSeed((Server *)self->server, MAINPARTICLE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, MAINPARTICLE_ID));
 
     (*self->mode_func_ptr)(self);
 
@@ -43,12 +43,69 @@ typedef struct {
     int modebuffer[4];
 } Harmonizer;
 
+/* The two overlaps, `incs` and `feeds` are the pointer increment and the
+ * clipped feedback per sample. The state is kept in locals: the writes to the
+ * buffer could otherwise alias it and reload it at every sample. */
 static void
-Harmonizer_transform_ii(Harmonizer *self) {
-    MYFLT val, amp, inc, ratio, rate, del, xind, pos, envpos, fpart;
-    int i, ipart;
+Harmonizer_overlaps(Harmonizer *self, MYFLT *incs, MYFLT *feeds)
+{
+    MYFLT val, amp, del, xind, pos, envpos, fpart;
+    int i, j, ipart;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
+    MYFLT *buf = self->buffer;
+    MYFLT *data = self->data;
+    MYFLT sr = self->sr;
+    MYFLT winsize = self->winsize;
+    MYFLT pointer = self->pointerPos;
+    int count = self->in_count;
+
+    for (i=0; i<self->bufsize; i++) {
+        data[i] = 0.0;
+        for (j=0; j<2; j++) {
+            /* the second overlap is half a window ahead */
+            pos = pointer + j * 0.5;
+            if (pos >= 1)
+                pos -= 1.0;
+            envpos = pos * 8192.0;
+            ipart = (int)envpos;
+            fpart = envpos - ipart;
+            amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
+
+            del = pos * winsize;
+            xind = count - (del * sr);
+            if (xind < 0)
+                xind += sr;
+            ipart = (int)xind;
+            fpart = xind - ipart;
+            val = buf[ipart] + (buf[ipart+1] - buf[ipart]) * fpart;
+            data[i] += (val * amp);
+        }
+
+        pointer += incs[i];
+        if (pointer < 0.0)
+            pointer += 1.0;
+        else if (pointer >= 1.0)
+            pointer -= 1.0;
+
+        buf[count] = in[i]  + (data[i] * feeds[i]);
+        if (count == 0)
+            buf[(int)sr] = buf[0];
+        count++;
+        if (count >= sr)
+            count = 0;
+    }
+    self->pointerPos = pointer;
+    self->in_count = count;
+}
+
+static void
+Harmonizer_transform_ii(Harmonizer *self) {
+    MYFLT inc, ratio, rate;
+    int i;
+    MYFLT incs[self->bufsize];
+    MYFLT feeds[self->bufsize];
+
     MYFLT trans = PyFloat_AS_DOUBLE(self->transpo);
     MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
     if (feed < 0.0)
@@ -61,61 +118,19 @@ Harmonizer_transform_ii(Harmonizer *self) {
     inc = -rate / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-		/* first overlap */
-		pos = self->pointerPos;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] = val * amp;
-
-		/* second overlap */
-		pos = self->pointerPos + 0.5;
-        if (pos >= 1)
-            pos -= 1.0;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] += (val * amp);
-
-        self->pointerPos += inc;
-        if (self->pointerPos < 0.0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1.0)
-            self->pointerPos -= 1.0;
-
-		self->buffer[self->in_count] = in[i]  + (self->data[i] * feed);
-        if (self->in_count == 0)
-            self->buffer[(int)self->sr] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->sr)
-            self->in_count = 0;
+        incs[i] = inc;
+        feeds[i] = feed;
     }
+    Harmonizer_overlaps(self, incs, feeds);
 }
 
 static void
 Harmonizer_transform_ai(Harmonizer *self) {
-    MYFLT val, amp, inc, ratio, rate, del, xind, pos, envpos, fpart;
-    int i, ipart;
+    MYFLT ratio, rate;
+    int i;
+    MYFLT incs[self->bufsize];
+    MYFLT feeds[self->bufsize];
 
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *trans = Stream_getData((Stream *)self->transpo_stream);
     MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
     if (feed < 0.0)
@@ -123,68 +138,24 @@ Harmonizer_transform_ai(Harmonizer *self) {
     else if (feed > 1.0)
         feed = 1.0;
 
-	MYFLT oneOnWinsize = 1.0 / self->winsize;
-	MYFLT oneOnSr = 1.0 / self->sr;
+    MYFLT oneOnWinsize = 1.0 / self->winsize;
+    MYFLT oneOnSr = 1.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
 		ratio = MYPOW(2.0, trans[i]/12.0);
 		rate = (ratio-1.0) * oneOnWinsize;
-		inc = -rate * oneOnSr;;
-
-		/* first overlap */
-		pos = self->pointerPos;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] = val * amp;
-
-		/* second overlap */
-		pos = self->pointerPos + 0.5;
-        if (pos >= 1)
-            pos -= 1.0;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] += (val * amp);
-
-        self->pointerPos += inc;
-        if (self->pointerPos < 0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1)
-            self->pointerPos -= 1.0;
-
-		self->buffer[self->in_count] = in[i]  + (self->data[i] * feed);
-        if (self->in_count == 0)
-            self->buffer[(int)self->sr] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->sr)
-            self->in_count = 0;
+		incs[i] = -rate * oneOnSr;
+        feeds[i] = feed;
     }
+    Harmonizer_overlaps(self, incs, feeds);
 }
 
 static void
 Harmonizer_transform_ia(Harmonizer *self) {
-    MYFLT val, amp, inc, ratio, rate, del, xind, pos, envpos, fpart, feedback;
-    int i, ipart;
+    MYFLT inc, ratio, rate;
+    int i;
+    MYFLT incs[self->bufsize];
+    MYFLT feeds[self->bufsize];
 
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT trans = PyFloat_AS_DOUBLE(self->transpo);
     MYFLT *feed = Stream_getData((Stream *)self->feedback_stream);
 
@@ -193,132 +164,41 @@ Harmonizer_transform_ia(Harmonizer *self) {
     inc = -rate / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
+        incs[i] = inc;
         if (feed[i] < 0.0)
-            feedback = 0.0;
+            feeds[i] = 0.0;
         else if (feed[i] > 1.0)
-            feedback = 1.0;
+            feeds[i] = 1.0;
         else
-            feedback = feed[i];
-
-		/* first overlap */
-		pos = self->pointerPos;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] = val * amp;
-
-		/* second overlap */
-		pos = self->pointerPos + 0.5;
-        if (pos > 1)
-            pos -= 1.0;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] += (val * amp);
-
-        self->pointerPos += inc;
-        if (self->pointerPos < 0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1)
-            self->pointerPos -= 1.0;
-
-		self->buffer[self->in_count] = in[i]  + (self->data[i] * feedback);
-        if (self->in_count == 0)
-            self->buffer[(int)self->sr] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->sr)
-            self->in_count = 0;
+            feeds[i] = feed[i];
     }
+    Harmonizer_overlaps(self, incs, feeds);
 }
 
 static void
 Harmonizer_transform_aa(Harmonizer *self) {
-    MYFLT val, amp, inc, ratio, rate, del, xind, pos, envpos, fpart, feedback;
-    int i, ipart;
+    MYFLT ratio, rate;
+    int i;
+    MYFLT incs[self->bufsize];
+    MYFLT feeds[self->bufsize];
 
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *trans = Stream_getData((Stream *)self->transpo_stream);
     MYFLT *feed = Stream_getData((Stream *)self->feedback_stream);
 
-	MYFLT oneOnWinsize = 1.0 / self->winsize;
-	MYFLT oneOnSr = 1.0 / self->sr;
+    MYFLT oneOnWinsize = 1.0 / self->winsize;
+    MYFLT oneOnSr = 1.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
 		ratio = MYPOW(2.0, trans[i]/12.0);
 		rate = (ratio-1.0) * oneOnWinsize;
-		inc = -rate * oneOnSr;;
-
+		incs[i] = -rate * oneOnSr;
         if (feed[i] < 0.0)
-            feedback = 0.0;
+            feeds[i] = 0.0;
         else if (feed[i] > 1.0)
-            feedback = 1.0;
+            feeds[i] = 1.0;
         else
-            feedback = feed[i];
-
-		/* first overlap */
-		pos = self->pointerPos;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] = val * amp;
-
-		/* second overlap */
-		pos = self->pointerPos + 0.5;
-        if (pos > 1)
-            pos -= 1.0;
-		envpos = pos * 8192.0;
-		ipart = (int)envpos;
-		fpart = envpos - ipart;
-		amp = ENVELOPE[ipart] + (ENVELOPE[ipart+1] - ENVELOPE[ipart]) * fpart;
-
-		del = pos * self->winsize;
-        xind = self->in_count - (del * self->sr);
-        if (xind < 0)
-            xind += self->sr;
-        ipart = (int)xind;
-        fpart = xind - ipart;
-        val = self->buffer[ipart] + (self->buffer[ipart+1] - self->buffer[ipart]) * fpart;
-        self->data[i] += (val * amp);
-
-        self->pointerPos += inc;
-        if (self->pointerPos < 0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1)
-            self->pointerPos -= 1.0;
-
-		self->buffer[self->in_count] = in[i]  + (self->data[i] * feedback);
-        if (self->in_count == 0)
-            self->buffer[(int)self->sr] = self->buffer[0];
-        self->in_count++;
-        if (self->in_count >= self->sr)
-            self->in_count = 0;
+            feeds[i] = feed[i];
     }
+    Harmonizer_overlaps(self, incs, feeds);
 }
 
 static void Harmonizer_feedbacktprocessing_ii(Harmonizer *self) { POST_PROCESSING_II };
@@ -477,12 +357,15 @@ Harmonizer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(self->sr+1); i++) {
         self->buffer[i] = 0.;
     }
+    Stream_setMemory(self->stream, (size_t)(self->sr+1) * sizeof(MYFLT));
 
     if (wintmp > 0.0 && wintmp <= 1.0)
         self->winsize = wintmp;
     else
         printf("Harmonizer : winsize lower than 0.0 or larger than 1.0 second, keeping default value.\n");
 
+    Stream_setTail(self->stream, (long)self->sr);
+
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
@@ -25,6 +25,7 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "simd.h"
 
 typedef struct {
     pyo_audio_HEAD
@@ -57,32 +58,85 @@ HilbertMain_compute_variables(HilbertMain *self)
     }
 }
 
+/* The sections j and j + 6 of the two branches at step t, where section j
+ * processes sample t - j of the block. Its input is the last output of section
+ * j - 1, so the sections go backward. */
+static void
+HilbertMain_step(HilbertMain *self, MYFLT *in, int t)
+{
+    int j, k;
+    MYFLT xn, yn;
+
+    for (j=5; j>=0; j--) {
+        if (t - j < 0 || t - j >= self->bufsize)
+            continue;
+        for (k=j; k<12; k+=6) {
+            xn = j == 0 ? in[t] : self->y1[k-1];
+            yn = self->coefs[k] * (xn - self->y1[k]) + self->x1[k];
+            self->x1[k] = xn;
+            self->y1[k] = yn;
+        }
+        if (j == 5) {
+            self->buffer_streams[t-5] = self->y1[5];
+            self->buffer_streams[t-5+self->bufsize] = self->y1[11];
+        }
+    }
+}
+
 static void
 HilbertMain_filters(HilbertMain *self) {
-    MYFLT xn1, xn2, yn1, yn2;
-    int j, i;
+    int t = 0;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
-        xn1 = in[i];
+#ifdef VSIZE
+    /* A wavefront over the sections: at step t, section j of both branches
+     * processes sample t - j, the two branches in the first two lanes of a
+     * vector per section. The sections of a step don't depend on each other,
+     * only on the previous step, and the first and last five steps are done
+     * by HilbertMain_step. */
+    int j;
+    MYFLT lanes[VSIZE];
+    VTYPE c[6], x1[6], y1[6], xn[6];
+
+    if (self->bufsize > 5) {
+        for (; t<5; t++)
+            HilbertMain_step(self, in, t);
+
+        for (j=0; j<VSIZE; j++)
+            lanes[j] = 0.0;
         for (j=0; j<6; j++) {
-            yn1 = self->coefs[j] * (xn1 - self->y1[j]) + self->x1[j];
-            self->x1[j] = xn1;
-            self->y1[j] = yn1;
-            xn1 = yn1;
+            lanes[0] = self->coefs[j]; lanes[1] = self->coefs[j+6];
+            c[j] = VLOAD(lanes);
+            lanes[0] = self->x1[j]; lanes[1] = self->x1[j+6];
+            x1[j] = VLOAD(lanes);
+            lanes[0] = self->y1[j]; lanes[1] = self->y1[j+6];
+            y1[j] = VLOAD(lanes);
         }
 
-        xn2 = in[i];
-        for (j=6; j<12; j++) {
-            yn2 = self->coefs[j] * (xn2 - self->y1[j]) + self->x1[j];
-            self->x1[j] = xn2;
-            self->y1[j] = yn2;
-            xn2 = yn2;
+        for (; t<self->bufsize; t++) {
+            xn[0] = VSET1(in[t]);
+            for (j=1; j<6; j++)
+                xn[j] = y1[j-1];
+            for (j=0; j<6; j++) {
+                y1[j] = VADD(VMUL(c[j], VSUB(xn[j], y1[j])), x1[j]);
+                x1[j] = xn[j];
+            }
+            VSTORE(lanes, y1[5]);
+            self->buffer_streams[t-5] = lanes[0];
+            self->buffer_streams[t-5+self->bufsize] = lanes[1];
         }
-        self->buffer_streams[i] = yn1;
-        self->buffer_streams[i+self->bufsize] = yn2;
 
+        for (j=0; j<6; j++) {
+            VSTORE(lanes, x1[j]);
+            self->x1[j] = lanes[0]; self->x1[j+6] = lanes[1];
+            VSTORE(lanes, y1[j]);
+            self->y1[j] = lanes[0]; self->y1[j+6] = lanes[1];
+        }
     }
+#endif
+
+    for (; t<self->bufsize+5; t++)
+        HilbertMain_step(self, in, t);
 }
 
 MYFLT *
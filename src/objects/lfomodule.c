@@ -42,8 +42,75 @@ typedef struct {
     MYFLT sahCurrentValue;
     MYFLT sahLastValue;
     MYFLT modPointerPos;
+    int krate;
+    MYFLT lastValue; /* last value computed, in control-rate mode */
+    PyoRand rng;
 } LFO;
 
+/* Value of the waveform at the current position, as in LFO_generates_ii. */
+static MYFLT
+LFO_value(LFO *self, MYFLT freq, MYFLT sharp) {
+    MYFLT val, pointer, numh, v1, v2, fade;
+    int maxHarms;
+
+    if (sharp < 0.0)
+        sharp = 0.0;
+    else if (sharp > 1.0)
+        sharp = 1.0;
+
+    switch (self->wavetype) {
+        case 0: /* Saw up */
+        case 1: /* Saw down */
+            maxHarms = (int)(self->srOverFour/freq);
+            numh = sharp * 46.0 + 4.0;
+            if (numh > maxHarms)
+                numh = maxHarms;
+            pointer = self->pointerPos * 2.0 - 1.0;
+            val = pointer - MYTANH(numh * pointer) / MYTANH(numh);
+            return self->wavetype == 0 ? val : -val;
+        case 2: /* Square */
+            maxHarms = (int)(self->srOverEight/freq);
+            numh = sharp * 46.0 + 4.0;
+            if (numh > maxHarms)
+                numh = maxHarms;
+            return MYATAN(numh * MYSIN(TWOPI*self->pointerPos)) * self->oneOverPiOverTwo;
+        case 3: /* Triangle */
+            maxHarms = (int)(self->srOverFour/freq);
+            if ((sharp * 36.0) > maxHarms)
+                numh = (MYFLT)(maxHarms / 36.0);
+            else
+                numh = sharp;
+            v1 = MYTAN(MYSIN(TWOPI*self->pointerPos));
+            pointer = self->pointerPos + 0.25;
+            if (pointer > 1.0)
+                pointer -= 1.0;
+            v2 = 4.0 * (0.5 - MYFABS(pointer - 0.5)) - 1.0;
+            return v1 * (1 - numh) + v2 * numh;
+        case 4: /* Pulse */
+        case 5: /* Bi-Pulse */
+            maxHarms = (int)(self->srOverEight/freq);
+            numh = MYFLOOR(sharp * 46.0 + 4.0);
+            if (numh > maxHarms)
+                numh = maxHarms;
+            if (MYFMOD(numh, 2.0) == 0.0)
+                numh += 1.0;
+            val = MYSIN(TWOPI*self->pointerPos);
+            if (self->wavetype == 4)
+                val = MYFABS(val);
+            return MYTAN(MYPOW(val, numh)) * self->oneOverPiOverTwo;
+        case 6: /* SAH */
+            if (self->sahPointerPos < 1.0) {
+                fade = 0.5 * MYSIN(PI * (self->sahPointerPos+0.5)) + 0.5;
+                return self->sahCurrentValue * (1.0 - fade) + self->sahLastValue * fade;
+            }
+            return self->sahCurrentValue;
+        case 7: /* Sine-mod */
+            return (0.5 * MYCOS(TWOPI*self->modPointerPos) + 0.5) * MYSIN(TWOPI*self->pointerPos);
+        default:
+            return 0.0;
+    }
+}
+
 static void
 LFO_generates_ii(LFO *self) {
     MYFLT val, inc, freq, sharp, pointer, numh;
@@ -175,7 +242,7 @@ LFO_generates_ii(LFO *self) {
                     self->pointerPos -= 1.0;
                     self->sahPointerPos = 0.0;
                     self->sahLastValue = self->sahCurrentValue;
-                    self->sahCurrentValue = rand()/((MYFLT)(RAND_MAX)*0.5) - 1.0;
+                    self->sahCurrentValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
                 }
                 if (self->sahPointerPos < 1.0) {
                     fade = 0.5 * MYSIN(PI * (self->sahPointerPos+0.5)) + 0.5;
@@ -210,6 +277,57 @@ LFO_generates_ii(LFO *self) {
     }
 }
 
+/* Control-rate mode, freq and sharp are read at the end of the buffer and the
+ * waveform is computed once, for the last sample of the buffer. */
+static void
+LFO_generates_k(LFO *self) {
+    MYFLT val, inc, freq, sharp, numh;
+    int wraps, num;
+
+    if (self->modebuffer[2] == 0)
+        freq = PyFloat_AS_DOUBLE(self->freq);
+    else
+        freq = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+    if (freq <= 0) {
+        return;
+    }
+    if (self->modebuffer[3] == 0)
+        sharp = PyFloat_AS_DOUBLE(self->sharp);
+    else
+        sharp = Stream_getData((Stream *)self->sharp_stream)[self->bufsize-1];
+    inc = freq / self->sr;
+
+    /* the sample and hold moves its pointer before computing the sample, the others after */
+    num = self->wavetype == 6 ? self->bufsize : self->bufsize - 1;
+    self->pointerPos += inc * num;
+    wraps = (int)MYFLOOR(self->pointerPos);
+    self->pointerPos -= wraps;
+    if (self->wavetype == 6) {
+        numh = 1.0 - (sharp < 0.0 ? 0.0 : sharp > 1.0 ? 1.0 : sharp);
+        if (wraps > 0) {
+            self->sahLastValue = self->sahCurrentValue;
+            self->sahCurrentValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
+            /* samples since the wrap */
+            self->sahPointerPos = (self->pointerPos / inc) / (int)(1.0 / inc * numh);
+        }
+        else if (self->sahPointerPos < 1.0)
+            self->sahPointerPos += (MYFLT)self->bufsize / (int)(1.0 / inc * numh);
+    }
+    else if (self->wavetype == 7) {
+        self->modPointerPos += inc * sharp * self->bufsize;
+        self->modPointerPos -= MYFLOOR(self->modPointerPos);
+    }
+
+    val = LFO_value(self, freq, sharp);
+    if (num < self->bufsize) {
+        self->pointerPos += inc;
+        if (self->pointerPos >= 1)
+            self->pointerPos -= 1.0;
+    }
+    pyo_fill_ramp(self->data, self->lastValue, val, self->bufsize);
+    self->lastValue = val;
+}
+
 static void
 LFO_generates_ai(LFO *self) {
     MYFLT val, inc, freq, sharp, pointer, numh;
@@ -354,7 +472,7 @@ LFO_generates_ai(LFO *self) {
                     self->pointerPos -= 1.0;
                     self->sahPointerPos = 0.0;
                     self->sahLastValue = self->sahCurrentValue;
-                    self->sahCurrentValue = rand()/((MYFLT)(RAND_MAX)*0.5) - 1.0;
+                    self->sahCurrentValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
                 }
                 if (self->sahPointerPos < 1.0) {
                     fade = 0.5 * MYSIN(PI * (self->sahPointerPos+0.5)) + 0.5;
@@ -553,7 +671,7 @@ LFO_generates_ia(LFO *self) {
                     self->pointerPos -= 1.0;
                     self->sahPointerPos = 0.0;
                     self->sahLastValue = self->sahCurrentValue;
-                    self->sahCurrentValue = rand()/((MYFLT)(RAND_MAX)*0.5) - 1.0;
+                    self->sahCurrentValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
                 }
                 if (self->sahPointerPos < 1.0) {
                     fade = 0.5 * MYSIN(PI * (self->sahPointerPos+0.5)) + 0.5;
@@ -768,7 +886,7 @@ LFO_generates_aa(LFO *self) {
                     self->pointerPos -= 1.0;
                     self->sahPointerPos = 0.0;
                     self->sahLastValue = self->sahCurrentValue;
-                    self->sahCurrentValue = rand()/((MYFLT)(RAND_MAX)*0.5) - 1.0;
+                    self->sahCurrentValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
                 }
                 if (self->sahPointerPos < 1.0) {
                     fade = 0.5 * MYSIN(PI * (self->sahPointerPos+0.5)) + 0.5;
@@ -840,6 +958,9 @@ LFO_setProcMode(LFO *self)
         case 11:
             self->proc_func_ptr = LFO_generates_aa;
             break;
+    }
+    if (self->krate) {
+        self->proc_func_ptr = LFO_generates_k;
     }
 	switch (muladdmode) {
         case 0:
@@ -870,6 +991,7 @@ LFO_setProcMode(LFO *self)
             self->muladd_func_ptr = LFO_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
@@ -924,6 +1046,8 @@ LFO_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->pointerPos = 0.0;
     self->sahPointerPos = 0.0;
     self->modPointerPos = 0.0;
+    self->krate = 0;
+    self->lastValue = 0.0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -959,15 +1083,38 @@ LFO_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, LFO_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, LFO_ID));
 
-    self->sahCurrentValue = self->sahLastValue = rand()/((MYFLT)(RAND_MAX)*0.5) - 1.0;
+    self->sahCurrentValue = self->sahLastValue = RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5) - 1.0;
 
     (*self->mode_func_ptr)(self);
 
     return (PyObject *)self;
 }
 
+static PyObject *
+LFO_setControlRate(LFO *self, PyObject *arg)
+{
+    MYFLT freq, sharp;
+
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        if (self->modebuffer[2] == 0)
+            freq = PyFloat_AS_DOUBLE(self->freq);
+        else
+            freq = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+        if (self->modebuffer[3] == 0)
+            sharp = PyFloat_AS_DOUBLE(self->sharp);
+        else
+            sharp = Stream_getData((Stream *)self->sharp_stream)[self->bufsize-1];
+        self->lastValue = freq > 0 ? LFO_value(self, freq, sharp) : 0.0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * LFO_getServer(LFO* self) { GET_SERVER };
 static PyObject * LFO_getStream(LFO* self) { GET_STREAM };
 static PyObject * LFO_setMul(LFO *self, PyObject *arg) { SET_MUL };
@@ -1109,6 +1256,7 @@ static PyMethodDef LFO_methods[] = {
 	{"setFreq", (PyCFunction)LFO_setFreq, METH_O, "Sets oscillator frequency in cycle per second."},
     {"setSharp", (PyCFunction)LFO_setSharp, METH_O, "Sets the sharpness factor."},
     {"setType", (PyCFunction)LFO_setType, METH_O, "Sets waveform type."},
+    {"setControlRate", (PyCFunction)LFO_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
     {"reset", (PyCFunction)LFO_reset, METH_NOARGS, "Resets pointer position to 0."},
 	{"setMul", (PyCFunction)LFO_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)LFO_setAdd, METH_O, "Sets oscillator add factor."},
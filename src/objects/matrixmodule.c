@@ -24,6 +24,8 @@
 #include "servermodule.h"
 #include "streammodule.h"
 #include "dummymodule.h"
+#include "dspthread.h"
+#include "simd.h"
 
 #define __MATRIX_MODULE
 #include "matrixmodule.h"
@@ -58,6 +60,16 @@ MatrixStream_getHeight(MatrixStream *self)
     return self->height;
 }
 
+static inline MYFLT
+MatrixStream_wrap(MYFLT pos, int size)
+{
+    while (pos < 0)
+        pos += size;
+    while (pos >= size)
+        pos -= size;
+    return pos;
+}
+
 /* width and height position normalized between 0 and 1 */
 MYFLT
 MatrixStream_getInterpPointFromPos(MatrixStream *self, MYFLT x, MYFLT y)
@@ -65,23 +77,8 @@ MatrixStream_getInterpPointFromPos(MatrixStream *self, MYFLT x, MYFLT y)
     MYFLT xpos, ypos, xfpart, yfpart, x1, x2, x3, x4;
     int xipart, yipart;
 
-    xpos = x * self->width;
-    if (xpos < 0)
-        xpos += self->width;
-    else if (xpos >= self->width) {
-        while (xpos >= self->width) {
-            xpos -= self->width;
-        }
-    }
-
-    ypos = y * self->height;
-    if (ypos < 0)
-        ypos += self->height;
-    else if (ypos >= self->height) {
-        while (ypos >= self->height) {
-            ypos -= self->height;
-        }
-    }
+    xpos = MatrixStream_wrap(x * self->width, self->width);
+    ypos = MatrixStream_wrap(y * self->height, self->height);
 
     xipart = (int)xpos;
     xfpart = xpos - xipart;
@@ -89,26 +86,78 @@ MatrixStream_getInterpPointFromPos(MatrixStream *self, MYFLT x, MYFLT y)
     yipart = (int)ypos;
     yfpart = ypos - yipart;
 
-    x1 = self->data[yipart][xipart]; // (0, 0)
-    x2 = self->data[yipart+1][xipart]; // (0, 1)
-    x3 = self->data[yipart][xipart+1]; // (1, 0)
-    x4 = self->data[yipart+1][xipart+1]; // (1, 1)
+    x1 = MATRIX_POINT(self, xipart, yipart); // (0, 0)
+    x2 = MATRIX_POINT(self, xipart, yipart+1); // (0, 1)
+    x3 = MATRIX_POINT(self, xipart+1, yipart); // (1, 0)
+    x4 = MATRIX_POINT(self, xipart+1, yipart+1); // (1, 1)
 
     return (x1*(1-yfpart)*(1-xfpart) + x2*yfpart*(1-xfpart) + x3*(1-yfpart)*xfpart + x4*yfpart*xfpart);
 }
 
+/* The offsets of the points are computed first, then the four neighbours
+   are loaded with vector gathers when the compiler allows it. */
+void
+MatrixStream_getInterpPointsFromPos(MatrixStream *self, MYFLT *x, MYFLT *y, MYFLT *out, int num)
+{
+    int i, xipart, yipart;
+    int index[num];
+    MYFLT xpos, ypos, xfrac[num], yfrac[num];
+    MYFLT x1, x2, x3, x4, top, bottom;
+    MYFLT *data = self->data;
+    int stride = self->stride;
+
+    for (i=0; i<num; i++) {
+        xpos = MatrixStream_wrap(x[i] * self->width, self->width);
+        ypos = MatrixStream_wrap(y[i] * self->height, self->height);
+        xipart = (int)xpos;
+        yipart = (int)ypos;
+        index[i] = yipart * stride + xipart;
+        xfrac[i] = xpos - xipart;
+        yfrac[i] = ypos - yipart;
+    }
+
+    i = 0;
+#if defined(VGATHER)
+    for (; i<=num-VSIZE; i+=VSIZE) {
+        VTYPE vx1 = VGATHER(data, VLOADI(index + i));
+        VTYPE vx3 = VGATHER(data + 1, VLOADI(index + i));
+        VTYPE vx2 = VGATHER(data + stride, VLOADI(index + i));
+        VTYPE vx4 = VGATHER(data + stride + 1, VLOADI(index + i));
+        VTYPE xf = VLOAD(xfrac + i);
+        VTYPE vtop = VADD(vx1, VMUL(VSUB(vx3, vx1), xf));
+        VTYPE vbottom = VADD(vx2, VMUL(VSUB(vx4, vx2), xf));
+        VSTORE(out + i, VADD(vtop, VMUL(VSUB(vbottom, vtop), VLOAD(yfrac + i))));
+    }
+#endif
+    for (; i<num; i++) {
+        x1 = data[index[i]];
+        x3 = data[index[i] + 1];
+        x2 = data[index[i] + stride];
+        x4 = data[index[i] + stride + 1];
+        top = x1 + (x3 - x1) * xfrac[i];
+        bottom = x2 + (x4 - x2) * xfrac[i];
+        out[i] = top + (bottom - top) * yfrac[i];
+    }
+}
+
 MYFLT
 MatrixStream_getPointFromPos(MatrixStream *self, long x, long y)
 {
-    return self->data[y][x];
+    return MATRIX_POINT(self, x, y);
 }
 
 void
-MatrixStream_setData(MatrixStream *self, MYFLT **data)
+MatrixStream_setData(MatrixStream *self, MYFLT *data)
 {
     self->data = data;
 }
 
+void
+MatrixStream_setStride(MatrixStream *self, int stride)
+{
+    self->stride = stride;
+}
+
 void
 MatrixStream_setWidth(MatrixStream *self, int size)
 {
@@ -121,6 +170,17 @@ MatrixStream_setHeight(MatrixStream *self, int size)
     self->height = size;
 }
 
+static PyObject *
+MatrixStream_getMemory(MatrixStream *self)
+{
+    return PyLong_FromSize_t(((size_t)self->height + 1) * self->stride * sizeof(MYFLT));
+}
+
+static PyMethodDef MatrixStream_methods[] = {
+{"getMemory", (PyCFunction)MatrixStream_getMemory, METH_NOARGS, "Returns the heap memory used by the points, in bytes."},
+{NULL}  /* Sentinel */
+};
+
 PyTypeObject MatrixStreamType = {
 PyObject_HEAD_INIT(NULL)
 0, /*ob_size*/
@@ -150,7 +210,7 @@ Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
 0, /* tp_weaklistoffset */
 0, /* tp_iter */
 0, /* tp_iternext */
-0, /* tp_methods */
+MatrixStream_methods, /* tp_methods */
 0, /* tp_members */
 0, /* tp_getset */
 0, /* tp_base */
@@ -179,13 +239,33 @@ NewMatrix_clip(MYFLT val, MYFLT min, MYFLT max) {
     else return val;
 }
 
+/* Allocates zeroed points for the current width and height. */
+static void
+NewMatrix_allocate(NewMatrix *self)
+{
+    pyo_aligned_free(self->data);
+    self->stride = PYO_ALIGN_FRAMES(self->width + 1);
+    self->data = (MYFLT *)pyo_aligned_calloc((self->height + 1) * self->stride * sizeof(MYFLT));
+    self->x_pointer = self->y_pointer = 0;
+
+    MatrixStream_setWidth(self->matrixstream, self->width);
+    MatrixStream_setHeight(self->matrixstream, self->height);
+    MatrixStream_setStride(self->matrixstream, self->stride);
+    MatrixStream_setData(self->matrixstream, self->data);
+}
+
+/* Rows are contiguous, the samples are copied one row segment at a time. */
 static PyObject *
 NewMatrix_recordChunkAllRow(NewMatrix *self, MYFLT *data, long datasize)
 {
-    long i;
-
-    for (i=0; i<datasize; i++) {
-        self->data[self->y_pointer][self->x_pointer++] = data[i];
+    long i, num;
+
+    for (i=0; i<datasize; i+=num) {
+        num = self->width - self->x_pointer;
+        if (num > (datasize - i))
+            num = datasize - i;
+        memcpy(&MATRIX_POINT(self, self->x_pointer, self->y_pointer), data + i, num * sizeof(MYFLT));
+        self->x_pointer += num;
         if (self->x_pointer >= self->width) {
             self->x_pointer = 0;
             self->y_pointer++;
@@ -214,11 +294,7 @@ NewMatrix_clear(NewMatrix *self)
 static void
 NewMatrix_dealloc(NewMatrix* self)
 {
-    int i;
-    for (i=0; i<(self->height+1); i++) {
-        free(self->data[i]);
-    }
-    free(self->data);
+    pyo_aligned_free(self->data);
     NewMatrix_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -226,7 +302,6 @@ NewMatrix_dealloc(NewMatrix* self)
 static PyObject *
 NewMatrix_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
-    int i, j;
     PyObject *inittmp=NULL;
     NewMatrix *self;
 
@@ -243,27 +318,12 @@ NewMatrix_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     if (! PyArg_ParseTupleAndKeywords(args, kwds, "ii|O", kwlist, &self->width, &self->height, &inittmp))
         Py_RETURN_NONE;
 
-    self->data = (MYFLT **)realloc(self->data, (self->height + 1) * sizeof(MYFLT *));
-
-    for (i=0; i<(self->height+1); i++) {
-        self->data[i] = (MYFLT *)malloc((self->width + 1) * sizeof(MYFLT));
-    }
-
-    for(i=0; i<(self->height+1); i++) {
-        for (j=0; j<(self->width+1); j++) {
-            self->data[i][j] = 0.0;
-        }
-    }
-
-    MatrixStream_setWidth(self->matrixstream, self->width);
-    MatrixStream_setHeight(self->matrixstream, self->height);
+    NewMatrix_allocate(self);
 
     if (inittmp) {
         PyObject_CallMethod((PyObject *)self, "setMatrix", "O", inittmp);
     }
 
-    MatrixStream_setData(self->matrixstream, self->data);
-
     return (PyObject *)self;
 }
 
@@ -311,7 +371,7 @@ NewMatrix_getData(NewMatrix *self)
     for(i=0; i<self->height; i++) {
         samples = PyList_New(self->width);
         for (j=0; j<self->width; j++) {
-            PyList_SetItem(samples, j, PyFloat_FromDouble(self->data[i][j]));
+            PyList_SetItem(samples, j, PyFloat_FromDouble(MATRIX_POINT(self, j, i)));
         }
         PyList_SetItem(matrix, i, samples);
     }
@@ -328,7 +388,7 @@ NewMatrix_getViewData(NewMatrix *self)
     matrix = PyList_New(self->width*self->height);
     for(i=0; i<self->height; i++) {
         for (j=0; j<self->width; j++) {
-            PyList_SET_ITEM(matrix, i*self->width+j, PyFloat_FromDouble(self->data[i][j]*128+128));
+            PyList_SET_ITEM(matrix, i*self->width+j, PyFloat_FromDouble(MATRIX_POINT(self, j, i)*128+128));
         }
     }
 
@@ -361,7 +421,7 @@ NewMatrix_setMatrix(NewMatrix *self, PyObject *value)
     for(i=0; i<self->height; i++) {
         innerlist = PyList_GetItem(value, i);
         for (j=0; j<self->width; j++) {
-            self->data[i][j] = PyFloat_AS_DOUBLE(PyNumber_Float(PyList_GET_ITEM(innerlist, j)));
+            MATRIX_POINT(self, j, i) = PyFloat_AS_DOUBLE(PyNumber_Float(PyList_GET_ITEM(innerlist, j)));
         }
     }
 
@@ -386,7 +446,7 @@ NewMatrix_genSineTerrain(NewMatrix *self, PyObject *args, PyObject *kwds)
     for (i=0; i<self->height; i++) {
         xphase = MYSIN(i * phase);
         for (j=0; j<self->width; j++) {
-            self->data[i][j] = MYSIN(xfreq * j * xsize + xphase);
+            MATRIX_POINT(self, j, i) = MYSIN(xfreq * j * xsize + xphase);
         }
     }
     Py_INCREF(Py_None);
@@ -585,6 +645,8 @@ MatrixRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, MatrixRec_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
     Stream_setStreamActive(self->stream, 0);
 
     static char *kwlist[] = {"input", "matrix", "fadetime", "delay", NULL};
@@ -607,6 +669,7 @@ MatrixRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     int width = NewMatrix_getWidth((NewMatrix *)self->matrix);
@@ -793,6 +856,8 @@ MatrixRecLoop_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, MatrixRecLoop_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
 
     static char *kwlist[] = {"input", "matrix", NULL};
 
@@ -814,6 +879,7 @@ MatrixRecLoop_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     return (PyObject *)self;
@@ -915,7 +981,10 @@ typedef struct {
     Stream *input_stream;
     PyObject *matrix;
     PyObject *sources;
-    MYFLT *buffer;
+    HelperThread *helper; /* morphs the second half of the rows when not NULL */
+    MatrixStream *job_tab1;
+    MatrixStream *job_tab2;
+    MYFLT job_interp;
 } MatrixMorph;
 
 static MYFLT
@@ -928,17 +997,48 @@ MatrixMorph_clip(MYFLT x) {
         return x;
 }
 
+/* Writes rows `start` to `stop` (exclusive) of the morphed matrix. */
+static void
+MatrixMorph_rows(MatrixMorph *self, MatrixStream *tab1, MatrixStream *tab2, MYFLT interp, int start, int stop)
+{
+    int i, j;
+    MYFLT *out, *in1, *in2;
+    MYFLT interp1 = 1. - interp;
+    NewMatrix *matrix = (NewMatrix *)self->matrix;
+    int width = matrix->width;
+
+    for (i=start; i<stop; i++) {
+        out = &MATRIX_POINT(matrix, 0, i);
+        in1 = &MATRIX_POINT(tab1, 0, i);
+        in2 = &MATRIX_POINT(tab2, 0, i);
+        j = 0;
+#ifdef VSIZE
+        VTYPE vinterp = VSET1(interp), vinterp1 = VSET1(interp1);
+        for (; j<=width-VSIZE; j+=VSIZE)
+            VSTORE(out+j, VADD(VMUL(VLOAD(in1+j), vinterp1), VMUL(VLOAD(in2+j), vinterp)));
+#endif
+        for (; j<width; j++)
+            out[j] = in1[j] * interp1 + in2[j] * interp;
+    }
+}
+
+static void
+MatrixMorph_job(void *data)
+{
+    MatrixMorph *self = (MatrixMorph *)data;
+    int height = NewMatrix_getHeight((NewMatrix *)self->matrix);
+
+    MatrixMorph_rows(self, self->job_tab1, self->job_tab2, self->job_interp, height / 2, height);
+}
+
 static void
 MatrixMorph_compute_next_data_frame(MatrixMorph *self)
 {
-    int x, y;
-    long i, j, width, height, numsamps, index;
-    MYFLT input, interp, interp1;
+    int x, y, height;
+    MYFLT input, interp;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    width = NewMatrix_getWidth((NewMatrix *)self->matrix);
     height = NewMatrix_getHeight((NewMatrix *)self->matrix);
-    numsamps = width * height;
     int len = PyList_Size(self->sources);
 
     input = MatrixMorph_clip(in[0]);
@@ -951,16 +1051,22 @@ MatrixMorph_compute_next_data_frame(MatrixMorph *self)
     MatrixStream *tab2 = (MatrixStream *)PyObject_CallMethod((PyObject *)PyList_GET_ITEM(self->sources, y), "getMatrixStream", "");
 
     interp = MYFMOD(interp, 1.0);
-    interp1 = 1. - interp;
 
-    for (i=0; i<height; i++) {
-        for (j=0; j<width; j++) {
-            index = i*width+j;
-            self->buffer[index] = MatrixStream_getPointFromPos(tab1, j, i) * interp1 + MatrixStream_getPointFromPos(tab2, j, i) * interp;
-        }
+    /* The matrices are the same size, each row is written in place. */
+    if (self->helper != NULL && height > 1) {
+        self->job_tab1 = tab1;
+        self->job_tab2 = tab2;
+        self->job_interp = interp;
+        HelperThread_post(self->helper);
+        MatrixMorph_rows(self, tab1, tab2, interp, 0, height / 2);
+        HelperThread_wait(self->helper);
     }
+    else
+        MatrixMorph_rows(self, tab1, tab2, interp, 0, height);
 
-    NewMatrix_recordChunkAllRow((NewMatrix *)self->matrix, self->buffer, numsamps);
+    /* The streams are owned by the source matrices. */
+    Py_DECREF(tab1);
+    Py_DECREF(tab2);
 }
 
 static int
@@ -989,7 +1095,7 @@ static void
 MatrixMorph_dealloc(MatrixMorph* self)
 {
     pyo_DEALLOC
-    free(self->buffer);
+    HelperThread_free(self->helper);
     MatrixMorph_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -998,7 +1104,6 @@ static PyObject *
 MatrixMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i;
-    long width, height, numsamps;
     PyObject *inputtmp, *input_streamtmp, *matrixtmp, *sourcestmp;
     MatrixMorph *self;
     self = (MatrixMorph *)type->tp_alloc(type, 0);
@@ -1006,6 +1111,8 @@ MatrixMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, MatrixMorph_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"input", "matrix", "sources", NULL};
 
@@ -1018,11 +1125,6 @@ MatrixMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_INCREF(matrixtmp);
     self->matrix = (PyObject *)matrixtmp;
 
-    width = NewMatrix_getWidth((NewMatrix *)self->matrix);
-    height = NewMatrix_getHeight((NewMatrix *)self->matrix);
-    numsamps = width * height;
-    self->buffer = (MYFLT *)realloc(self->buffer, (numsamps) * sizeof(MYFLT));
-
     Py_XDECREF(self->sources);
     Py_INCREF(sourcestmp);
     self->sources = (PyObject *)sourcestmp;
@@ -1078,6 +1180,23 @@ MatrixMorph_setSources(MatrixMorph *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+MatrixMorph_setThreaded(MatrixMorph *self, PyObject *arg)
+{
+    if (PyObject_IsTrue(arg) && self->helper == NULL) {
+        self->helper = HelperThread_new(MatrixMorph_job, (void *)self);
+        if (self->helper == NULL)
+            printf("MatrixMorph warning : unable to start the helper thread.\n");
+    }
+    else if (!PyObject_IsTrue(arg) && self->helper != NULL) {
+        HelperThread_free(self->helper);
+        self->helper = NULL;
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyMemberDef MatrixMorph_members[] = {
     {"server", T_OBJECT_EX, offsetof(MatrixMorph, server), 0, "Pyo server."},
     {"stream", T_OBJECT_EX, offsetof(MatrixMorph, stream), 0, "Stream object."},
@@ -1092,6 +1211,7 @@ static PyMethodDef MatrixMorph_methods[] = {
     {"_getStream", (PyCFunction)MatrixMorph_getStream, METH_NOARGS, "Returns stream object."},
     {"setMatrix", (PyCFunction)MatrixMorph_setMatrix, METH_O, "Sets a new matrix."},
     {"setSources", (PyCFunction)MatrixMorph_setSources, METH_O, "Changes the sources matrixs."},
+    {"setThreaded", (PyCFunction)MatrixMorph_setThreaded, METH_O, "Morphs half of the rows on a helper thread."},
     {"play", (PyCFunction)MatrixMorph_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
     {"stop", (PyCFunction)MatrixMorph_stop, METH_NOARGS, "Stops computing."},
     {NULL}  /* Sentinel */
@@ -37,6 +37,8 @@ typedef struct {
     double currentTime;
     double offset;
     int flag;
+    int *trigs;
+    int *numtrigs;
 } Metro;
 
 static void
@@ -48,6 +50,7 @@ Metro_generate_i(Metro *self) {
     tm = PyFloat_AS_DOUBLE(self->time);
     off = tm * self->offset;
 
+    TRIGGER_LIST_CLEAR(self->numtrigs, 1);
     for (i=0; i<self->bufsize; i++) {
         if (self->currentTime >= tm) {
             val = 0;
@@ -57,6 +60,7 @@ Metro_generate_i(Metro *self) {
         else if (self->currentTime >= off && self->flag == 1) {
             val = 1;
             self->flag = 0;
+            TRIGGER_LIST_ADD(self->trigs, self->numtrigs, 0, i);
         }
         else
             val = 0;
@@ -74,6 +78,7 @@ Metro_generate_a(Metro *self) {
 
     MYFLT *tm = Stream_getData((Stream *)self->time_stream);
 
+    TRIGGER_LIST_CLEAR(self->numtrigs, 1);
     for (i=0; i<self->bufsize; i++) {
         tmd = (double)tm[i];
         off = tmd * self->offset;
@@ -85,6 +90,7 @@ Metro_generate_a(Metro *self) {
         else if (self->currentTime >= off && self->flag == 1) {
             val = 1;
             self->flag = 0;
+            TRIGGER_LIST_ADD(self->trigs, self->numtrigs, 0, i);
         }
         else
             val = 0;
@@ -155,6 +161,7 @@ Metro_compute_next_data_frame(Metro *self)
 {
     (*self->proc_func_ptr)(self);
     (*self->muladd_func_ptr)(self);
+    TRIGGER_LIST_SET(self->trigs, self->numtrigs[0]);
 }
 
 static int
@@ -179,6 +186,8 @@ static void
 Metro_dealloc(Metro* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
+    free(self->numtrigs);
     Metro_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -205,6 +214,7 @@ Metro_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     self->sampleToSec = 1.0 / self->sr;
     self->currentTime = 0.;
+    TRIGGER_LIST_ALLOC(self->trigs, self->numtrigs, 1);
 
     static char *kwlist[] = {"time", "offset", NULL};
 
@@ -396,6 +406,8 @@ typedef struct {
     int *seq;
     int count;
     MYFLT *buffer_streams;
+    int *trigs;
+    int *numtrigs;
     int seqsize;
     int poly;
     int flag;
@@ -431,6 +443,7 @@ Seqer_generate_i(Seqer *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         self->currentTime += self->sampleToSec;
@@ -440,6 +453,7 @@ Seqer_generate_i(Seqer *self) {
             if (self->count >= self->seq[self->tap]) {
                 self->count = 0;
                 self->buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
                 self->voiceCount++;
                 if (self->voiceCount >= self->poly)
                     self->voiceCount = 0;
@@ -468,6 +482,7 @@ Seqer_generate_a(Seqer *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         tm = (double)time[i];
@@ -478,6 +493,7 @@ Seqer_generate_a(Seqer *self) {
             if (self->count >= self->seq[self->tap]) {
                 self->count = 0;
                 self->buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
                 self->voiceCount++;
                 if (self->voiceCount >= self->poly)
                     self->voiceCount = 0;
@@ -498,6 +514,13 @@ Seqer_getSamplesBuffer(Seqer *self)
     return (MYFLT *)self->buffer_streams;
 }
 
+int *
+Seqer_getTriggers(Seqer *self, int chnl, int *num)
+{
+    *num = self->numtrigs[chnl];
+    return self->trigs + chnl * self->bufsize;
+}
+
 static void
 Seqer_setProcMode(Seqer *self)
 {
@@ -543,6 +566,8 @@ Seqer_dealloc(Seqer* self)
 {
     pyo_DEALLOC
     free(self->buffer_streams);
+    free(self->trigs);
+    free(self->numtrigs);
     Seqer_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -593,6 +618,7 @@ Seqer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
     self->buffer_streams = (MYFLT *)realloc(self->buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
+    TRIGGER_LIST_ALLOC(self->trigs, self->numtrigs, self->poly);
 
     (*self->mode_func_ptr)(self);
 
@@ -730,6 +756,7 @@ typedef struct {
     Seqer *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } Seq;
 
 static void Seq_postprocessing_ii(Seq *self) { POST_PROCESSING_II };
@@ -781,7 +808,7 @@ Seq_setProcMode(Seq *self) {
 static void
 Seq_compute_next_data_frame(Seq *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = Seqer_getSamplesBuffer((Seqer *)self->mainPlayer);
@@ -789,6 +816,9 @@ Seq_compute_next_data_frame(Seq *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = Seqer_getTriggers((Seqer *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -811,6 +841,7 @@ static void
 Seq_dealloc(Seq* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     Seq_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -829,6 +860,7 @@ Seq_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Seq_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = Seq_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
@@ -983,6 +1015,9 @@ typedef struct {
     int poly;
     int voiceCount;
     MYFLT *buffer_streams;
+    int *trigs;
+    int *numtrigs;
+    PyoRand rng;
 } Clouder;
 
 static void
@@ -998,11 +1033,13 @@ Clouder_generate_i(Clouder *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
 
     dens *= 0.5;
     for (i=0; i<self->bufsize; i++) {
-        rnd = (int)(rand() / (MYFLT)RAND_MAX * self->sr);
+        rnd = (int)(RANDOM_INT / (MYFLT)RANDOM_MAX * self->sr);
         if (rnd < dens) {
+            TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
             self->buffer_streams[i + self->voiceCount++ * self->bufsize] = 1.0;
             if (self->voiceCount == self->poly)
                 self->voiceCount = 0;
@@ -1020,6 +1057,7 @@ Clouder_generate_a(Clouder *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         dens = density[i];
@@ -1029,8 +1067,9 @@ Clouder_generate_a(Clouder *self) {
             dens = self->sr;
 
         dens *= 0.5;
-        rnd = (int)(rand() / (MYFLT)RAND_MAX * self->sr);
+        rnd = (int)(RANDOM_INT / (MYFLT)RANDOM_MAX * self->sr);
         if (rnd < dens) {
+            TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
             self->buffer_streams[i + self->voiceCount++ * self->bufsize] = 1.0;
             if (self->voiceCount == self->poly)
                 self->voiceCount = 0;
@@ -1044,6 +1083,13 @@ Clouder_getSamplesBuffer(Clouder *self)
     return (MYFLT *)self->buffer_streams;
 }
 
+int *
+Clouder_getTriggers(Clouder *self, int chnl, int *num)
+{
+    *num = self->numtrigs[chnl];
+    return self->trigs + chnl * self->bufsize;
+}
+
 static void
 Clouder_setProcMode(Clouder *self)
 {
@@ -1087,6 +1133,8 @@ Clouder_dealloc(Clouder* self)
 {
     pyo_DEALLOC
     free(self->buffer_streams);
+    free(self->trigs);
+    free(self->numtrigs);
     Clouder_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1123,9 +1171,10 @@ Clouder_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    Server_generateSeed((Server *)self->server, CLOUD_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, CLOUD_ID));
 
     self->buffer_streams = (MYFLT *)realloc(self->buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
+    TRIGGER_LIST_ALLOC(self->trigs, self->numtrigs, self->poly);
 
     return (PyObject *)self;
 }
@@ -1236,6 +1285,7 @@ typedef struct {
     Clouder *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } Cloud;
 
 static void Cloud_postprocessing_ii(Cloud *self) { POST_PROCESSING_II };
@@ -1287,7 +1337,7 @@ Cloud_setProcMode(Cloud *self) {
 static void
 Cloud_compute_next_data_frame(Cloud *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = Clouder_getSamplesBuffer((Clouder *)self->mainPlayer);
@@ -1295,6 +1345,9 @@ Cloud_compute_next_data_frame(Cloud *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = Clouder_getTriggers((Clouder *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -1317,6 +1370,7 @@ static void
 Cloud_dealloc(Cloud* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     Cloud_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1335,6 +1389,7 @@ Cloud_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Cloud_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = Cloud_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
@@ -1485,6 +1540,7 @@ typedef struct {
     pyo_audio_HEAD
     int flag;
     int modebuffer[2];
+    int trig; /* offset of its trigger, always 0 */
 } Trig;
 
 static void Trig_postprocessing_ii(Trig *self) { POST_PROCESSING_II };
@@ -1537,6 +1593,8 @@ Trig_setProcMode(Trig *self)
 static void
 Trig_compute_next_data_frame(Trig *self)
 {
+    int num = self->flag;
+
     if (self->flag == 1) {
         self->data[0] = 1.0;
         self->flag = 0;
@@ -1544,6 +1602,7 @@ Trig_compute_next_data_frame(Trig *self)
     else
         self->data[0] = 0.0;
     (*self->muladd_func_ptr)(self);
+    TRIGGER_LIST_SET(&self->trig, num);
 }
 
 static int
@@ -1766,16 +1825,21 @@ typedef struct {
     MYFLT *dur_buffer_streams;
     MYFLT *end_buffer_streams;
     MYFLT *amplitudes;
+    int *trigs;
+    int *numtrigs;
+    int *end_trigs;
+    int *end_numtrigs;
+    PyoRand rng;
 } Beater;
 
 static MYFLT
-Beater_defineAccent(int n) {
+Beater_defineAccent(Beater *self, int n) {
 	if (n == 1)
-		return (MYFLT)((rand() % 15) + 112) / 127.; // 112 -> 127
+		return (MYFLT)((RANDOM_INT % 15) + 112) / 127.; // 112 -> 127
 	else if (n == 2)
-		return (MYFLT)((rand() % 20) + 70) / 127.; // 70 -> 90
+		return (MYFLT)((RANDOM_INT % 20) + 70) / 127.; // 70 -> 90
 	else if (n == 3)
-		return (MYFLT)((rand() % 20) + 40) / 127.; // 40 -> 60
+		return (MYFLT)((RANDOM_INT % 20) + 40) / 127.; // 40 -> 60
     else
         return 0.5;
 }
@@ -1821,15 +1885,15 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 4  || (i % len) == 2) {
                 self->tapProb[i] = w2;
-                self->accentTable[i] = Beater_defineAccent(2);
+                self->accentTable[i] = Beater_defineAccent(self, 2);
             }
             else if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1838,15 +1902,15 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 3) {
                 self->tapProb[i] = w2;
-                self->accentTable[i] = Beater_defineAccent(2);
+                self->accentTable[i] = Beater_defineAccent(self, 2);
             }
             else if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1855,15 +1919,15 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 3) {
                 self->tapProb[i] = w2;
-                self->accentTable[i] = Beater_defineAccent(2);
+                self->accentTable[i] = Beater_defineAccent(self, 2);
             }
             else if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1872,15 +1936,15 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 2) {
                 self->tapProb[i] = w2;
-                self->accentTable[i] = Beater_defineAccent(2);
+                self->accentTable[i] = Beater_defineAccent(self, 2);
             }
             else if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1889,11 +1953,11 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1902,11 +1966,11 @@ Beater_makeTable(Beater *self, int fill) {
 		for (i=0; i < self->taps; i++) {
             if ((i % len) == 0) {
                 self->tapProb[i] = w1;
-                self->accentTable[i] = Beater_defineAccent(1);
+                self->accentTable[i] = Beater_defineAccent(self, 1);
             }
             else {
                 self->tapProb[i] = w3;
-                self->accentTable[i] = Beater_defineAccent(3);
+                self->accentTable[i] = Beater_defineAccent(self, 3);
             }
 		}
 	}
@@ -1918,7 +1982,7 @@ Beater_makeSequence(Beater *self) {
 
 	j = 0;
 	for (i=0; i < self->taps; i++) {
-		if ((rand() % 100) < self->tapProb[i]) {
+		if ((RANDOM_INT % 100) < self->tapProb[i]) {
 			self->sequence[i] = 1;
 			self->tapList[j++] = i;
 		}
@@ -1978,6 +2042,8 @@ Beater_generate_i(Beater *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = self->end_buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
+    TRIGGER_LIST_CLEAR(self->end_numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         self->tap_buffer_streams[i + self->voiceCount * self->bufsize] = (MYFLT)self->currentTap;
@@ -1987,11 +2053,14 @@ Beater_generate_i(Beater *self) {
         self->dur_buffer_streams[i + self->voiceCount * self->bufsize] = self->durations[self->tapCount];
         if (self->currentTime >= tm) {
             self->currentTime -= tm;
-            if (self->tapCount == (self->last_taps-2))
+            if (self->tapCount == (self->last_taps-2)) {
                 self->end_buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                TRIGGER_LIST_ADD(self->end_trigs, self->end_numtrigs, self->voiceCount, i);
+            }
             if (self->sequence[self->tapCount] == 1) {
                 self->currentTap = self->tapCount;
                 self->amplitudes[self->voiceCount] = self->accentTable[self->tapCount];
+                TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
                 self->buffer_streams[i + self->voiceCount++ * self->bufsize] = 1.0;
                 if (self->voiceCount == self->poly)
                     self->voiceCount = 0;
@@ -2047,6 +2116,8 @@ Beater_generate_a(Beater *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = self->end_buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
+    TRIGGER_LIST_CLEAR(self->end_numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         tm = (double)time[i];
@@ -2057,11 +2128,14 @@ Beater_generate_a(Beater *self) {
         self->dur_buffer_streams[i + self->voiceCount * self->bufsize] = self->durations[self->tapCount];
         if (self->currentTime >= tm) {
             self->currentTime -= tm;
-            if (self->tapCount == (self->last_taps-2))
+            if (self->tapCount == (self->last_taps-2)) {
                 self->end_buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                TRIGGER_LIST_ADD(self->end_trigs, self->end_numtrigs, self->voiceCount, i);
+            }
             if (self->sequence[self->tapCount] == 1) {
                 self->currentTap = self->tapCount;
                 self->amplitudes[self->voiceCount] = self->accentTable[self->tapCount];
+                TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
                 self->buffer_streams[i + self->voiceCount++ * self->bufsize] = 1.0;
                 if (self->voiceCount == self->poly)
                     self->voiceCount = 0;
@@ -2107,6 +2181,13 @@ Beater_getSamplesBuffer(Beater *self)
     return (MYFLT *)self->buffer_streams;
 }
 
+int *
+Beater_getTriggers(Beater *self, int chnl, int *num)
+{
+    *num = self->numtrigs[chnl];
+    return self->trigs + chnl * self->bufsize;
+}
+
 MYFLT *
 Beater_getTapBuffer(Beater *self)
 {
@@ -2131,6 +2212,13 @@ Beater_getEndBuffer(Beater *self)
     return (MYFLT *)self->end_buffer_streams;
 }
 
+int *
+Beater_getEndTriggers(Beater *self, int chnl, int *num)
+{
+    *num = self->end_numtrigs[chnl];
+    return self->end_trigs + chnl * self->bufsize;
+}
+
 static void
 Beater_setProcMode(Beater *self)
 {
@@ -2178,6 +2266,10 @@ Beater_dealloc(Beater* self)
     free(self->amp_buffer_streams);
     free(self->dur_buffer_streams);
     free(self->end_buffer_streams);
+    free(self->trigs);
+    free(self->numtrigs);
+    free(self->end_trigs);
+    free(self->end_numtrigs);
     free(self->amplitudes);
     Beater_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -2236,13 +2328,15 @@ Beater_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    Server_generateSeed((Server *)self->server, BEATER_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, BEATER_ID));
 
     self->buffer_streams = (MYFLT *)realloc(self->buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->tap_buffer_streams = (MYFLT *)realloc(self->tap_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->amp_buffer_streams = (MYFLT *)realloc(self->amp_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->dur_buffer_streams = (MYFLT *)realloc(self->dur_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->end_buffer_streams = (MYFLT *)realloc(self->end_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
+    TRIGGER_LIST_ALLOC(self->trigs, self->numtrigs, self->poly);
+    TRIGGER_LIST_ALLOC(self->end_trigs, self->end_numtrigs, self->poly);
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = self->tap_buffer_streams[i] = self->amp_buffer_streams[i] = self->dur_buffer_streams[i] = self->end_buffer_streams[i] = 0.0;
     }
@@ -2514,6 +2608,7 @@ typedef struct {
     Beater *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } Beat;
 
 static void Beat_postprocessing_ii(Beat *self) { POST_PROCESSING_II };
@@ -2565,7 +2660,7 @@ Beat_setProcMode(Beat *self) {
 static void
 Beat_compute_next_data_frame(Beat *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = Beater_getSamplesBuffer((Beater *)self->mainPlayer);
@@ -2573,6 +2668,9 @@ Beat_compute_next_data_frame(Beat *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = Beater_getTriggers((Beater *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -2595,6 +2693,7 @@ static void
 Beat_dealloc(Beat* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     Beat_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -2613,6 +2712,7 @@ Beat_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Beat_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = Beat_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
@@ -3514,6 +3614,7 @@ typedef struct {
     Beater *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } BeatEndStream;
 
 static void BeatEndStream_postprocessing_ii(BeatEndStream *self) { POST_PROCESSING_II };
@@ -3565,7 +3666,7 @@ BeatEndStream_setProcMode(BeatEndStream *self) {
 static void
 BeatEndStream_compute_next_data_frame(BeatEndStream *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = Beater_getEndBuffer((Beater *)self->mainPlayer);
@@ -3573,6 +3674,9 @@ BeatEndStream_compute_next_data_frame(BeatEndStream *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = Beater_getEndTriggers((Beater *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -3595,6 +3699,7 @@ static void
 BeatEndStream_dealloc(BeatEndStream* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     BeatEndStream_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -3613,6 +3718,7 @@ BeatEndStream_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, BeatEndStream_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = BeatEndStream_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
@@ -3787,6 +3893,10 @@ typedef struct {
     MYFLT *amp_buffer_streams;
     MYFLT *dur_buffer_streams;
     MYFLT *end_buffer_streams;
+    int *trigs;
+    int *numtrigs;
+    int *end_trigs;
+    int *end_numtrigs;
 } TrigBurster;
 
 static void
@@ -3798,6 +3908,8 @@ TrigBurster_generate_i(TrigBurster *self) {
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = self->end_buffer_streams[i] = 0.0;
     }
+    TRIGGER_LIST_CLEAR(self->numtrigs, self->poly);
+    TRIGGER_LIST_CLEAR(self->end_numtrigs, self->poly);
 
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1.0) {
@@ -3816,9 +3928,12 @@ TrigBurster_generate_i(TrigBurster *self) {
                 self->currentAmp[self->voiceCount] = MYPOW(self->a_ampfade, self->currentCount);
                 self->currentDur[self->voiceCount] = self->targetTime;
                 self->buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                TRIGGER_LIST_ADD(self->trigs, self->numtrigs, self->voiceCount, i);
                 self->currentCount++;
-                if (self->currentCount == (self->a_count - 1))
+                if (self->currentCount == (self->a_count - 1)) {
                     self->end_buffer_streams[i + self->voiceCount * self->bufsize] = 1.0;
+                    TRIGGER_LIST_ADD(self->end_trigs, self->end_numtrigs, self->voiceCount, i);
+                }
                 if (self->currentCount == self->a_count)
                     self->flag = 0;
                 self->voiceCount++;
@@ -3841,6 +3956,13 @@ TrigBurster_getSamplesBuffer(TrigBurster *self)
     return (MYFLT *)self->buffer_streams;
 }
 
+int *
+TrigBurster_getTriggers(TrigBurster *self, int chnl, int *num)
+{
+    *num = self->numtrigs[chnl];
+    return self->trigs + chnl * self->bufsize;
+}
+
 MYFLT *
 TrigBurster_getTapBuffer(TrigBurster *self)
 {
@@ -3865,6 +3987,13 @@ TrigBurster_getEndBuffer(TrigBurster *self)
     return (MYFLT *)self->end_buffer_streams;
 }
 
+int *
+TrigBurster_getEndTriggers(TrigBurster *self, int chnl, int *num)
+{
+    *num = self->end_numtrigs[chnl];
+    return self->end_trigs + chnl * self->bufsize;
+}
+
 static void
 TrigBurster_setProcMode(TrigBurster *self)
 {
@@ -3904,6 +4033,10 @@ TrigBurster_dealloc(TrigBurster* self)
     free(self->amp_buffer_streams);
     free(self->dur_buffer_streams);
     free(self->end_buffer_streams);
+    free(self->trigs);
+    free(self->numtrigs);
+    free(self->end_trigs);
+    free(self->end_numtrigs);
     free(self->currentTap);
     free(self->currentAmp);
     free(self->currentDur);
@@ -3955,6 +4088,8 @@ TrigBurster_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->amp_buffer_streams = (MYFLT *)realloc(self->amp_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->dur_buffer_streams = (MYFLT *)realloc(self->dur_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
     self->end_buffer_streams = (MYFLT *)realloc(self->end_buffer_streams, self->poly * self->bufsize * sizeof(MYFLT));
+    TRIGGER_LIST_ALLOC(self->trigs, self->numtrigs, self->poly);
+    TRIGGER_LIST_ALLOC(self->end_trigs, self->end_numtrigs, self->poly);
     for (i=0; i<(self->poly*self->bufsize); i++) {
         self->buffer_streams[i] = self->tap_buffer_streams[i] = self->amp_buffer_streams[i] = self->dur_buffer_streams[i] = self->end_buffer_streams[i] = 0.0;
     }
@@ -4093,6 +4228,7 @@ typedef struct {
     TrigBurster *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } TrigBurst;
 
 static void TrigBurst_postprocessing_ii(TrigBurst *self) { POST_PROCESSING_II };
@@ -4144,7 +4280,7 @@ TrigBurst_setProcMode(TrigBurst *self) {
 static void
 TrigBurst_compute_next_data_frame(TrigBurst *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = TrigBurster_getSamplesBuffer((TrigBurster *)self->mainPlayer);
@@ -4152,6 +4288,9 @@ TrigBurst_compute_next_data_frame(TrigBurst *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = TrigBurster_getTriggers((TrigBurster *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -4174,6 +4313,7 @@ static void
 TrigBurst_dealloc(TrigBurst* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     TrigBurst_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -4192,6 +4332,7 @@ TrigBurst_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, TrigBurst_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = TrigBurst_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
@@ -5093,6 +5234,7 @@ typedef struct {
     TrigBurster *mainPlayer;
     int chnl;
     int modebuffer[2];
+    int *trigs; /* copy of the triggers of its voice */
 } TrigBurstEndStream;
 
 static void TrigBurstEndStream_postprocessing_ii(TrigBurstEndStream *self) { POST_PROCESSING_II };
@@ -5144,7 +5286,7 @@ TrigBurstEndStream_setProcMode(TrigBurstEndStream *self) {
 static void
 TrigBurstEndStream_compute_next_data_frame(TrigBurstEndStream *self)
 {
-    int i;
+    int i, num, *trigs;
     MYFLT *tmp;
     int offset = self->chnl * self->bufsize;
     tmp = TrigBurster_getEndBuffer((TrigBurster *)self->mainPlayer);
@@ -5152,6 +5294,9 @@ TrigBurstEndStream_compute_next_data_frame(TrigBurstEndStream *self)
         self->data[i] = tmp[i + offset];
     }
     (*self->muladd_func_ptr)(self);
+    trigs = TrigBurster_getEndTriggers((TrigBurster *)self->mainPlayer, self->chnl, &num);
+    memcpy(self->trigs, trigs, num * sizeof(int));
+    TRIGGER_LIST_SET(self->trigs, num);
 }
 
 static int
@@ -5174,6 +5319,7 @@ static void
 TrigBurstEndStream_dealloc(TrigBurstEndStream* self)
 {
     pyo_DEALLOC
+    free(self->trigs);
     TrigBurstEndStream_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -5192,6 +5338,7 @@ TrigBurstEndStream_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, TrigBurstEndStream_compute_next_data_frame);
+    self->trigs = (int *)malloc(self->bufsize * sizeof(int));
     self->mode_func_ptr = TrigBurstEndStream_setProcMode;
 
     static char *kwlist[] = {"mainPlayer", "chnl", NULL};
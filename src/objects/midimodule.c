@@ -27,6 +27,26 @@
 #include "dummymodule.h"
 #include "portmidi.h"
 
+/* Writes data[start:end] of a controller receiving its events at their
+ * samples. `*current`, the value of the last sample, moves to `target` by
+ * `step` for `*remaining` more samples. Returns `end`. */
+static int
+pyo_midi_ramp(MYFLT *data, int start, int end, MYFLT *current, MYFLT target, MYFLT step, int *remaining)
+{
+    int i;
+
+    for (i=start; i<end; i++) {
+        if (*remaining > 0) {
+            if (--(*remaining) == 0)
+                *current = target;
+            else
+                *current += step;
+        }
+        data[i] = *current;
+    }
+    return end;
+}
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *callable;
@@ -43,8 +63,7 @@ CtlScan_compute_next_data_frame(CtlScan *self)
     PmEvent *buffer;
     int i, count;
 
-    buffer = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_CTL, 0, &count);
 
     if (count > 0) {
         PyObject *tup;
@@ -53,16 +72,14 @@ CtlScan_compute_next_data_frame(CtlScan *self)
             int number = Pm_MessageData1(buffer[i].message);
             int value = Pm_MessageData2(buffer[i].message);
 
-            if ((status & 0xF0) == 0xB0) {
-                if (number != self->ctlnumber) {
-                    self->ctlnumber = number;
-                    tup = PyTuple_New(1);
-                    PyTuple_SetItem(tup, 0, PyInt_FromLong(self->ctlnumber));
-                    PyObject_Call((PyObject *)self->callable, tup, NULL);
-                }
-                if (self->toprint == 1)
-                    printf("ctl number : %i, ctl value : %i, midi channel : %i\n", self->ctlnumber, value, status - 0xB0 + 1);
+            if (number != self->ctlnumber) {
+                self->ctlnumber = number;
+                tup = PyTuple_New(1);
+                PyTuple_SetItem(tup, 0, PyInt_FromLong(self->ctlnumber));
+                PyObject_Call((PyObject *)self->callable, tup, NULL);
             }
+            if (self->toprint == 1)
+                printf("ctl number : %i, ctl value : %i, midi channel : %i\n", self->ctlnumber, value, status - 0xB0 + 1);
         }
     }
 }
@@ -104,6 +121,8 @@ CtlScan_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, CtlScan_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = CtlScan_setProcMode;
 
     static char *kwlist[] = {"callable", "toprint", NULL};
@@ -241,8 +260,7 @@ CtlScan2_compute_next_data_frame(CtlScan2 *self)
     PmEvent *buffer;
     int i, count, midichnl;
 
-    buffer = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_CTL, 0, &count);
 
     if (count > 0) {
         PyObject *tup;
@@ -251,19 +269,17 @@ CtlScan2_compute_next_data_frame(CtlScan2 *self)
             int number = Pm_MessageData1(buffer[i].message);
             int value = Pm_MessageData2(buffer[i].message);
 
-            if ((status & 0xF0) == 0xB0) {
-                midichnl = status - 0xB0 + 1;
-                if (number != self->ctlnumber || midichnl != self->midichnl) {
-                    self->ctlnumber = number;
-                    self->midichnl = midichnl;
-                    tup = PyTuple_New(2);
-                    PyTuple_SetItem(tup, 0, PyInt_FromLong(self->ctlnumber));
-                    PyTuple_SetItem(tup, 1, PyInt_FromLong(self->midichnl));
-                    PyObject_Call((PyObject *)self->callable, tup, NULL);
-                }
-                if (self->toprint == 1)
-                    printf("ctl number : %i, ctl value : %i, midi channel : %i\n", self->ctlnumber, value, midichnl);
+            midichnl = status - 0xB0 + 1;
+            if (number != self->ctlnumber || midichnl != self->midichnl) {
+                self->ctlnumber = number;
+                self->midichnl = midichnl;
+                tup = PyTuple_New(2);
+                PyTuple_SetItem(tup, 0, PyInt_FromLong(self->ctlnumber));
+                PyTuple_SetItem(tup, 1, PyInt_FromLong(self->midichnl));
+                PyObject_Call((PyObject *)self->callable, tup, NULL);
             }
+            if (self->toprint == 1)
+                printf("ctl number : %i, ctl value : %i, midi channel : %i\n", self->ctlnumber, value, midichnl);
         }
     }
 }
@@ -305,6 +321,8 @@ CtlScan2_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, CtlScan2_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = CtlScan2_setProcMode;
 
     static char *kwlist[] = {"callable", "toprint", NULL};
@@ -435,7 +453,10 @@ typedef struct {
     MYFLT maxscale;
     MYFLT value;
     MYFLT oldValue;
+    MYFLT step;
+    int remaining; /* samples left in the ramp from oldValue to value */
     MYFLT sampleToSec;
+    int krate;
     int modebuffer[2];
 } Midictl;
 
@@ -484,61 +505,44 @@ Midictl_setProcMode(Midictl *self)
             self->muladd_func_ptr = Midictl_postprocessing_revareva;
             break;
     }
-}
-
-// Take MIDI events and translate them...
-void translateMidi(Midictl *self, PmEvent *buffer, int count)
-{
-    int i, ok;
-    for (i=count-1; i>=0; i--) {
-        int status = Pm_MessageStatus(buffer[i].message);	// Temp note event holders
-        int number = Pm_MessageData1(buffer[i].message);
-        int value = Pm_MessageData2(buffer[i].message);
-
-        if (self->channel == 0) {
-            if ((status & 0xF0) == 0xB0)
-                ok = 1;
-            else
-                ok = 0;
-        }
-        else {
-            if (status == (0xB0 | (self->channel - 1)))
-                ok = 1;
-            else
-                ok = 0;
-        }
-
-        if (ok == 1 && number == self->ctlnumber) {
-            self->oldValue = self->value;
-            self->value = (value / 127.) * (self->maxscale - self->minscale) + self->minscale;
-            break;
-        }
-    }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
 Midictl_compute_next_data_frame(Midictl *self)
 {
-    PmEvent *tmp;
-    int i, count;
-    MYFLT step;
-
-    tmp = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    PmEvent *buffer;
+    int i, count, pos = 0;
 
-    if (count > 0)
-        translateMidi((Midictl *)self, tmp, count);
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_CTL, self->channel, &count);
 
-    if (self->interp == 0) {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->value;
+    if (self->krate) {
+        for (i=count-1; i>=0; i--) {
+            if (Pm_MessageData1(buffer[i].message) == self->ctlnumber) {
+                self->value = (Pm_MessageData2(buffer[i].message) / 127.) * (self->maxscale - self->minscale) + self->minscale;
+                break;
+            }
         }
+        pyo_fill_ramp(self->data, self->oldValue, self->value, self->bufsize);
+        self->oldValue = self->value;
+        self->remaining = 0;
     }
     else {
-        step = (self->value - self->oldValue) / self->bufsize;
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->oldValue + step;
+        for (i=0; i<count; i++) {
+            if (Pm_MessageData1(buffer[i].message) != self->ctlnumber)
+                continue;
+            pos = pyo_midi_ramp(self->data, pos, buffer[i].timestamp, &self->oldValue, self->value, self->step, &self->remaining);
+            self->value = (Pm_MessageData2(buffer[i].message) / 127.) * (self->maxscale - self->minscale) + self->minscale;
+            if (self->interp == 0) {
+                self->oldValue = self->value;
+                self->remaining = 0;
+            }
+            else {
+                self->step = (self->value - self->oldValue) / self->bufsize;
+                self->remaining = self->bufsize;
+            }
         }
+        pyo_midi_ramp(self->data, pos, self->bufsize, &self->oldValue, self->value, self->step, &self->remaining);
     }
     (*self->muladd_func_ptr)(self);
 }
@@ -576,9 +580,11 @@ Midictl_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->channel = 0;
     self->value = 0.;
     self->oldValue = 0.;
+    self->remaining = 0;
     self->minscale = 0.;
     self->maxscale = 1.;
     self->interp = 1;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 
@@ -608,6 +614,18 @@ Midictl_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+static PyObject *
+Midictl_setControlRate(Midictl *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Midictl_getServer(Midictl* self) { GET_SERVER };
 static PyObject * Midictl_getStream(Midictl* self) { GET_STREAM };
 static PyObject * Midictl_setMul(Midictl *self, PyObject *arg) { SET_MUL };
@@ -666,6 +684,7 @@ Midictl_setValue(Midictl *self, PyObject *arg)
 	if (isNum == 1) {
 		tmp = PyFloat_AsDouble(PyNumber_Float(arg));
         self->oldValue = self->value = tmp;
+        self->remaining = 0;
 	}
 
 	Py_INCREF(Py_None);
@@ -777,6 +796,7 @@ static PyMethodDef Midictl_methods[] = {
 	{"setMaxScale", (PyCFunction)Midictl_setMaxScale, METH_O, "Sets the maximum value of scaling."},
 	{"setCtlNumber", (PyCFunction)Midictl_setCtlNumber, METH_O, "Sets the controller number."},
 	{"setChannel", (PyCFunction)Midictl_setChannel, METH_O, "Sets the midi channel."},
+	{"setControlRate", (PyCFunction)Midictl_setControlRate, METH_O, "Interpolates linearly over the buffer toward the last value received."},
 	{"setMul", (PyCFunction)Midictl_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Midictl_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Midictl_setSub, METH_O, "Sets inverse add factor."},
@@ -875,7 +895,10 @@ typedef struct {
     MYFLT range;
     MYFLT value;
     MYFLT oldValue;
+    MYFLT step;
+    int remaining; /* samples left in the ramp from oldValue to value */
     MYFLT sampleToSec;
+    int krate;
     int modebuffer[2];
 } Bendin;
 
@@ -924,58 +947,43 @@ Bendin_setProcMode(Bendin *self)
             self->muladd_func_ptr = Bendin_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
-// Take MIDI events and translate them...
-void Bendin_translateMidi(Bendin *self, PmEvent *buffer, int count)
+static MYFLT
+Bendin_translate(Bendin *self, PmMessage message)
 {
-    int i, ok;
-    MYFLT val;
-    for (i=count-1; i>=0; i--) {
-        int status = Pm_MessageStatus(buffer[i].message);	// Temp note event holders
-        int number = Pm_MessageData1(buffer[i].message);
-        int value = Pm_MessageData2(buffer[i].message);
-
-        if (self->channel == 0) {
-            if ((status & 0xF0) == 0xe0)
-                ok = 1;
-            else
-                ok = 0;
-        }
-        else {
-            if (status == (0xe0 | (self->channel - 1)))
-                ok = 1;
-            else
-                ok = 0;
-        }
+    MYFLT val = (Pm_MessageData1(message) + (Pm_MessageData2(message) << 7) - 8192) / 8192.0 * self->range;
 
-        if (ok == 1) {
-            self->oldValue = self->value;
-            val = (number + (value << 7) - 8192) / 8192.0 * self->range;
-            if (self->scale == 0)
-                self->value = val;
-            else
-                self->value = MYPOW(1.0594630943593, val);
-            break;
-        }
-    }
+    if (self->scale == 0)
+        return val;
+    else
+        return MYPOW(1.0594630943593, val);
 }
 
 static void
 Bendin_compute_next_data_frame(Bendin *self)
 {
-    PmEvent *tmp;
-    int i, count;
-
-    tmp = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    PmEvent *buffer;
+    int i, count, pos = 0;
 
-    if (count > 0)
-        Bendin_translateMidi((Bendin *)self, tmp, count);
-    MYFLT step = (self->value - self->oldValue) / self->bufsize;
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_BEND, self->channel, &count);
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = self->oldValue + step;
+    if (self->krate) {
+        if (count > 0)
+            self->value = Bendin_translate(self, buffer[count-1].message);
+        pyo_fill_ramp(self->data, self->oldValue, self->value, self->bufsize);
+        self->oldValue = self->value;
+        self->remaining = 0;
+    }
+    else {
+        for (i=0; i<count; i++) {
+            pos = pyo_midi_ramp(self->data, pos, buffer[i].timestamp, &self->oldValue, self->value, self->step, &self->remaining);
+            self->value = Bendin_translate(self, buffer[i].message);
+            self->step = (self->value - self->oldValue) / self->bufsize;
+            self->remaining = self->bufsize;
+        }
+        pyo_midi_ramp(self->data, pos, self->bufsize, &self->oldValue, self->value, self->step, &self->remaining);
     }
 
     (*self->muladd_func_ptr)(self);
@@ -1015,7 +1023,9 @@ Bendin_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->scale = 0;
     self->value = 0.;
     self->oldValue = 0.;
+    self->remaining = 0;
     self->range = 2.;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 
@@ -1048,6 +1058,18 @@ Bendin_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+static PyObject *
+Bendin_setControlRate(Bendin *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Bendin_getServer(Bendin* self) { GET_SERVER };
 static PyObject * Bendin_getStream(Bendin* self) { GET_STREAM };
 static PyObject * Bendin_setMul(Bendin *self, PyObject *arg) { SET_MUL };
@@ -1152,6 +1174,7 @@ static PyMethodDef Bendin_methods[] = {
 	{"setBrange", (PyCFunction)Bendin_setBrange, METH_O, "Sets the bending bipolar range."},
 	{"setScale", (PyCFunction)Bendin_setScale, METH_O, "Sets the output type, midi vs transpo."},
 	{"setChannel", (PyCFunction)Bendin_setChannel, METH_O, "Sets the midi channel."},
+	{"setControlRate", (PyCFunction)Bendin_setControlRate, METH_O, "Interpolates linearly over the buffer toward the last value received."},
 	{"setMul", (PyCFunction)Bendin_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Bendin_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Bendin_setSub, METH_O, "Sets inverse add factor."},
@@ -1250,7 +1273,10 @@ typedef struct {
     MYFLT maxscale;
     MYFLT value;
     MYFLT oldValue;
+    MYFLT step;
+    int remaining; /* samples left in the ramp from oldValue to value */
     MYFLT sampleToSec;
+    int krate;
     int modebuffer[2];
 } Touchin;
 
@@ -1299,53 +1325,32 @@ Touchin_setProcMode(Touchin *self)
             self->muladd_func_ptr = Touchin_postprocessing_revareva;
             break;
     }
-}
-
-// Take MIDI events and translate them...
-void Touchin_translateMidi(Touchin *self, PmEvent *buffer, int count)
-{
-    int i, ok;
-    for (i=count-1; i>=0; i--) {
-        int status = Pm_MessageStatus(buffer[i].message);	// Temp note event holders
-        int number = Pm_MessageData1(buffer[i].message);
-        /* int value = Pm_MessageData2(buffer[i].message); */
-
-        if (self->channel == 0) {
-            if ((status & 0xF0) == 0xd0)
-                ok = 1;
-            else
-                ok = 0;
-        }
-        else {
-            if (status == (0xd0 | (self->channel - 1)))
-                ok = 1;
-            else
-                ok = 0;
-        }
-
-        if (ok == 1) {
-            self->oldValue = self->value;
-            self->value = (number / 127.) * (self->maxscale - self->minscale) + self->minscale;
-            break;
-        }
-    }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
 Touchin_compute_next_data_frame(Touchin *self)
 {
-    PmEvent *tmp;
-    int i, count;
-
-    tmp = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    PmEvent *buffer;
+    int i, count, pos = 0;
 
-    if (count > 0)
-        Touchin_translateMidi((Touchin *)self, tmp, count);
-    MYFLT step = (self->value - self->oldValue) / self->bufsize;
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_TOUCH, self->channel, &count);
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = self->oldValue + step;
+    if (self->krate) {
+        if (count > 0)
+            self->value = (Pm_MessageData1(buffer[count-1].message) / 127.) * (self->maxscale - self->minscale) + self->minscale;
+        pyo_fill_ramp(self->data, self->oldValue, self->value, self->bufsize);
+        self->oldValue = self->value;
+        self->remaining = 0;
+    }
+    else {
+        for (i=0; i<count; i++) {
+            pos = pyo_midi_ramp(self->data, pos, buffer[i].timestamp, &self->oldValue, self->value, self->step, &self->remaining);
+            self->value = (Pm_MessageData1(buffer[i].message) / 127.) * (self->maxscale - self->minscale) + self->minscale;
+            self->step = (self->value - self->oldValue) / self->bufsize;
+            self->remaining = self->bufsize;
+        }
+        pyo_midi_ramp(self->data, pos, self->bufsize, &self->oldValue, self->value, self->step, &self->remaining);
     }
 
     (*self->muladd_func_ptr)(self);
@@ -1384,8 +1389,10 @@ Touchin_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->channel = 0;
     self->value = 0.;
     self->oldValue = 0.;
+    self->remaining = 0;
     self->minscale = 0.;
     self->maxscale = 1.;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 
@@ -1415,6 +1422,18 @@ Touchin_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+static PyObject *
+Touchin_setControlRate(Touchin *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Touchin_getServer(Touchin* self) { GET_SERVER };
 static PyObject * Touchin_getStream(Touchin* self) { GET_STREAM };
 static PyObject * Touchin_setMul(Touchin *self, PyObject *arg) { SET_MUL };
@@ -1514,6 +1533,7 @@ static PyMethodDef Touchin_methods[] = {
 	{"setMinScale", (PyCFunction)Touchin_setMinScale, METH_O, "Sets the minimum value of scaling."},
 	{"setMaxScale", (PyCFunction)Touchin_setMaxScale, METH_O, "Sets the maximum value of scaling."},
 	{"setChannel", (PyCFunction)Touchin_setChannel, METH_O, "Sets the midi channel."},
+	{"setControlRate", (PyCFunction)Touchin_setControlRate, METH_O, "Interpolates linearly over the buffer toward the last value received."},
 	{"setMul", (PyCFunction)Touchin_setMul, METH_O, "Sets oscillator mul factor."},
 	{"setAdd", (PyCFunction)Touchin_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)Touchin_setSub, METH_O, "Sets inverse add factor."},
@@ -1659,49 +1679,23 @@ Programin_setProcMode(Programin *self)
     }
 }
 
-// Take MIDI events and translate them...
-void Programin_translateMidi(Programin *self, PmEvent *buffer, int count)
-{
-    int i, ok;
-
-    for (i=count-1; i>=0; i--) {
-        int status = Pm_MessageStatus(buffer[i].message);	// Temp note event holders
-        int number = Pm_MessageData1(buffer[i].message);
-
-        if (self->channel == 0) {
-            if ((status & 0xF0) == 0xc0)
-                ok = 1;
-            else
-                ok = 0;
-        }
-        else {
-            if (status == (0xc0 | (self->channel - 1)))
-                ok = 1;
-            else
-                ok = 0;
-        }
-
-        if (ok == 1) {
-            self->value = (MYFLT)number;
-            break;
-        }
-    }
-}
-
 static void
 Programin_compute_next_data_frame(Programin *self)
 {
-    PmEvent *tmp;
-    int i, count;
-
-    tmp = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
+    PmEvent *buffer;
+    int i, j, count, pos = 0;
 
-    if (count > 0)
-        Programin_translateMidi((Programin *)self, tmp, count);
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_PROGRAM, self->channel, &count);
 
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = self->value;
+    for (i=0; i<count; i++) {
+        for (j=pos; j<buffer[i].timestamp; j++) {
+            self->data[j] = self->value;
+        }
+        pos = j;
+        self->value = (MYFLT)Pm_MessageData1(buffer[i].message);
+    }
+    for (j=pos; j<self->bufsize; j++) {
+        self->data[j] = self->value;
     }
 
     (*self->muladd_func_ptr)(self);
@@ -1924,11 +1918,15 @@ typedef struct {
     int channel;
     int stealing;
     MYFLT *trigger_streams;
+    MYFLT *value_streams; /* pitch and velocity of each voice, sample by sample */
+    MYFLT *lastpitch; /* last valid pitch of each voice */
 } MidiNote;
 
 static void
 MidiNote_setProcMode(MidiNote *self) {};
 
+MYFLT MidiNote_getValue(MidiNote *self, int voice, int which);
+
 int
 pitchIsIn(int *buf, int pitch, int len) {
     int i;
@@ -1980,62 +1978,65 @@ int whichVoice(int *buf, int pitch, int len) {
     return voice;
 }
 
-// Take MIDI events and keep track of notes
-void grabMidiNotes(MidiNote *self, PmEvent *buffer, int count)
+// Take a MIDI note event and keep track of notes, triggers are set at the event's sample
+static void
+MidiNote_grabNote(MidiNote *self, PmMessage message, int offset)
 {
-    int i, ok, voice, kind;
-
-    for (i=0; i<count; i++) {
-        int status = Pm_MessageStatus(buffer[i].message);	// Temp note event holders
-        int pitch = Pm_MessageData1(buffer[i].message);
-        int velocity = Pm_MessageData2(buffer[i].message);
+    int voice, kind;
+    int status = Pm_MessageStatus(message);	// Temp note event holders
+    int pitch = Pm_MessageData1(message);
+    int velocity = Pm_MessageData2(message);
 
-        if (self->channel == 0) {
-            if ((status & 0xF0) == 0x90 || (status & 0xF0) == 0x80)
-                ok = 1;
-            else
-                ok = 0;
+    if ((status & 0xF0) == 0x80)
+        kind = 0;
+    else if ((status & 0xF0) == 0x90 && velocity == 0)
+        kind = 0;
+    else
+        kind = 1;
+
+    if (pitchIsIn(self->notebuf, pitch, self->voices) == 0 && kind == 1 && pitch >= self->first && pitch <= self->last) {
+        //printf("%i, %i, %i\n", status, pitch, velocity);
+        if (!self->stealing) {
+            voice = nextEmptyVoice(self->notebuf, self->vcount, self->voices);
+            if (voice != -1) {
+                self->vcount = voice;
+                self->notebuf[voice*2] = pitch;
+                self->notebuf[voice*2+1] = velocity;
+                self->trigger_streams[self->bufsize*(self->vcount*2) + offset] = 1.0;
+            }
         }
         else {
-            if ( status == (0x90 | (self->channel - 1)) || status == (0x80 | (self->channel - 1)))
-                ok = 1;
-            else
-                ok = 0;
+            self->vcount = (self->vcount + 1) % self->voices;
+            self->notebuf[self->vcount*2] = pitch;
+            self->notebuf[self->vcount*2+1] = velocity;
+            self->trigger_streams[self->bufsize*(self->vcount*2) + offset] = 1.0;
         }
+    }
+    else if (pitchIsIn(self->notebuf, pitch, self->voices) == 1 && kind == 0 && pitch >= self->first && pitch <= self->last) {
+        //printf("%i, %i, %i\n", status, pitch, velocity);
+        voice = whichVoice(self->notebuf, pitch, self->voices);
+        self->notebuf[voice*2] = -1;
+        self->notebuf[voice*2+1] = 0.;
+        self->trigger_streams[self->bufsize*(voice*2+1) + offset] = 1.0;
+    }
+}
 
-        if (ok == 1) {
-            if ((status & 0xF0) == 0x80)
-                kind = 0;
-            else if ((status & 0xF0) == 0x90 && velocity == 0)
-                kind = 0;
-            else
-                kind = 1;
-
-            if (pitchIsIn(self->notebuf, pitch, self->voices) == 0 && kind == 1 && pitch >= self->first && pitch <= self->last) {
-                //printf("%i, %i, %i\n", status, pitch, velocity);
-                if (!self->stealing) {
-                    voice = nextEmptyVoice(self->notebuf, self->vcount, self->voices);
-                    if (voice != -1) {
-                        self->vcount = voice;
-                        self->notebuf[voice*2] = pitch;
-                        self->notebuf[voice*2+1] = velocity;
-                        self->trigger_streams[self->bufsize*(self->vcount*2)] = 1.0;
-                    }
-                }
-                else {
-                    self->vcount = (self->vcount + 1) % self->voices;
-                    self->notebuf[self->vcount*2] = pitch;
-                    self->notebuf[self->vcount*2+1] = velocity;
-                    self->trigger_streams[self->bufsize*(self->vcount*2)] = 1.0;
-                }
-            }
-            else if (pitchIsIn(self->notebuf, pitch, self->voices) == 1 && kind == 0 && pitch >= self->first && pitch <= self->last) {
-                //printf("%i, %i, %i\n", status, pitch, velocity);
-                voice = whichVoice(self->notebuf, pitch, self->voices);
-                self->notebuf[voice*2] = -1;
-                self->notebuf[voice*2+1] = 0.;
-                self->trigger_streams[self->bufsize*(voice*2+1)] = 1.0;
-            }
+// Writes the current pitch and velocity of the voices in samples [start, end)
+static void
+MidiNote_fillValues(MidiNote *self, int start, int end)
+{
+    int i, j;
+    MYFLT pitch, velocity, *out;
+
+    for (i=0; i<self->voices; i++) {
+        pitch = MidiNote_getValue(self, i, 0);
+        if (pitch != -1)
+            self->lastpitch[i] = pitch;
+        velocity = MidiNote_getValue(self, i, 1);
+        out = self->value_streams + self->bufsize * i * 2;
+        for (j=start; j<end; j++) {
+            out[j] = self->lastpitch[i];
+            out[j+self->bufsize] = velocity;
         }
     }
 }
@@ -2043,17 +2044,20 @@ void grabMidiNotes(MidiNote *self, PmEvent *buffer, int count)
 static void
 MidiNote_compute_next_data_frame(MidiNote *self)
 {
-    PmEvent *tmp;
-    int i, count;
+    PmEvent *buffer;
+    int i, count, pos = 0;
 
     for (i=0; i<self->bufsize*self->voices*2; i++) {
         self->trigger_streams[i] = 0.0;
     }
 
-    tmp = Server_getMidiEventBuffer((Server *)self->server);
-    count = Server_getMidiEventCount((Server *)self->server);
-    if (count > 0)
-        grabMidiNotes((MidiNote *)self, tmp, count);
+    buffer = Server_getMidiEvents((Server *)self->server, PYO_MIDI_NOTE, self->channel, &count);
+    for (i=0; i<count; i++) {
+        MidiNote_fillValues(self, pos, buffer[i].timestamp);
+        pos = buffer[i].timestamp;
+        MidiNote_grabNote(self, buffer[i].message, pos);
+    }
+    MidiNote_fillValues(self, pos, self->bufsize);
 }
 
 static int
@@ -2076,6 +2080,8 @@ MidiNote_dealloc(MidiNote* self)
     pyo_DEALLOC
     free(self->notebuf);
     free(self->trigger_streams);
+    free(self->value_streams);
+    free(self->lastpitch);
     MidiNote_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -2086,6 +2092,12 @@ MidiNote_get_trigger_buffer(MidiNote *self)
     return self->trigger_streams;
 }
 
+static MYFLT *
+MidiNote_get_value_buffer(MidiNote *self)
+{
+    return self->value_streams;
+}
+
 static PyObject *
 MidiNote_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
@@ -2115,14 +2127,17 @@ MidiNote_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     self->notebuf = (int *)realloc(self->notebuf, self->voices * 2 * sizeof(int));
     self->trigger_streams = (MYFLT *)realloc(self->trigger_streams, self->bufsize * self->voices * 2 * sizeof(MYFLT));
+    self->value_streams = (MYFLT *)realloc(self->value_streams, self->bufsize * self->voices * 2 * sizeof(MYFLT));
+    self->lastpitch = (MYFLT *)realloc(self->lastpitch, self->voices * sizeof(MYFLT));
 
     for (i=0; i<self->bufsize*self->voices*2; i++) {
-        self->trigger_streams[i] = 0.0;
+        self->trigger_streams[i] = self->value_streams[i] = 0.0;
     }
 
     for (i=0; i<self->voices; i++) {
         self->notebuf[i*2] = -1;
         self->notebuf[i*2+1] = 0;
+        self->lastpitch[i] = 0.0;
     }
 
     self->centralkey = (self->first + self->last) / 2;
@@ -2338,19 +2353,13 @@ static void
 Notein_compute_next_data_frame(Notein *self)
 {
     int i;
-    MYFLT tmp = MidiNote_getValue(self->handler, self->voice, self->mode);
+    MYFLT *in = MidiNote_get_value_buffer(self->handler) + self->bufsize * (self->voice * 2 + self->mode);
 
-    if (self->mode == 0 && tmp != -1) {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = tmp;
-        }
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = in[i];
     }
-    else if (self->mode == 1) {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = tmp;
-        }
+    if (self->mode == 1)
         (*self->muladd_func_ptr)(self);
-    }
 }
 
 static int
@@ -30,15 +30,12 @@ typedef struct {
     int modebuffer[2];
     int seed;
     int type;
+    PyoRand rng;
 } Noise;
 
 static void
 Noise_generate(Noise *self) {
-    int i;
-
-    for (i=0; i<self->bufsize; i++) {
-        self->data[i] = rand()/((MYFLT)(RAND_MAX)+1)*1.98-0.99;
-    }
+    PyoRand_fill(&self->rng, self->data, 1.98, -0.99, self->bufsize);
 }
 
 static void
@@ -166,9 +163,9 @@ Noise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, NOISE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, NOISE_ID));
 
-    self->seed = rand();
+    self->seed = RANDOM_INT;
 
     (*self->mode_func_ptr)(self);
 
@@ -330,6 +327,7 @@ typedef struct {
     MYFLT c4;
     MYFLT c5;
     MYFLT c6;
+    PyoRand rng;
 } PinkNoise;
 
 static void
@@ -337,8 +335,10 @@ PinkNoise_generate(PinkNoise *self) {
     MYFLT in, val;
     int i;
 
+    /* The filters run over a block of white noise, in place. */
+    PyoRand_fill(&self->rng, self->data, 1.98, -0.99, self->bufsize);
     for (i=0; i<self->bufsize; i++) {
-        in = rand()/((MYFLT)(RAND_MAX)+1)*1.98-0.99;
+        in = self->data[i];
         self->c0 = self->c0 * 0.99886 + in * 0.0555179;
         self->c1 = self->c1 * 0.99332 + in * 0.0750759;
         self->c2 = self->c2 * 0.96900 + in * 0.1538520;
@@ -460,7 +460,7 @@ PinkNoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    Server_generateSeed((Server *)self->server, PINKNOISE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, PINKNOISE_ID));
 
     return (PyObject *)self;
 }
@@ -596,16 +596,17 @@ typedef struct {
     MYFLT y1;
     MYFLT c1;
     MYFLT c2;
+    PyoRand rng;
 } BrownNoise;
 
 static void
 BrownNoise_generate(BrownNoise *self) {
-    MYFLT rnd, val;
+    MYFLT val;
     int i;
 
+    PyoRand_fill(&self->rng, self->data, 1.98, -0.99, self->bufsize);
     for (i=0; i<self->bufsize; i++) {
-        rnd = rand()/((MYFLT)(RAND_MAX)+1)*1.98-0.99;
-        val = self->c1 * rnd + self->c2 * self->y1;
+        val = self->c1 * self->data[i] + self->c2 * self->y1;
         self->y1 = val;
         self->data[i] = val * 20.0; /* gain compensation */
     }
@@ -725,7 +726,7 @@ BrownNoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    Server_generateSeed((Server *)self->server, BROWNNOISE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, BROWNNOISE_ID));
 
     return (PyObject *)self;
 }
@@ -26,22 +26,12 @@
 #include "servermodule.h"
 #include "dummymodule.h"
 #include "tablemodule.h"
+#include "oscarray.h"
 
 /*******************/
 /***** OscBank ******/
 /*******************/
 
-static MYFLT
-OscBank_clip(MYFLT x, int size) {
-    if (x >= size) {
-        x -= (int)(x / size) * size;
-    }
-    else if (x < 0) {
-        x += ((int)(-x / size) + 1) * size;
-    }
-    return x;
-}
-
 typedef struct {
     pyo_audio_HEAD
     PyObject *table;
@@ -61,8 +51,9 @@ typedef struct {
     Stream *arnda_stream;
     int stages;
     int fjit;
+    int quadrature;
     int modebuffer[9];
-    MYFLT *pointerPos;
+    OscArray *osc;
     MYFLT *frequencies;
     MYFLT lastFreq;
     MYFLT lastSpread;
@@ -80,6 +71,7 @@ typedef struct {
     MYFLT *aOldValues;
     MYFLT *aValues;
     MYFLT *aDiffs;
+    PyoRand rng;
 } OscBank;
 
 static void
@@ -89,7 +81,7 @@ OscBank_setFrequencies(OscBank *self, MYFLT freq, MYFLT spread) {
     MYFLT scl = freq * spread;
 
     if (self->fjit == 1) {
-        seed = rand();
+        seed = RANDOM_INT;
         for (i=0; i<self->stages; i++) {
             seed = (seed * 15625 + 1) & 0xFFFF;
             rnd = seed * 1.52587890625e-07 - 0.005 + 1.0;
@@ -115,7 +107,7 @@ OscBank_pickNewFrnds(OscBank *self, MYFLT frndf, MYFLT frnda) {
     else if (frnda > 1.0)
         frnda = 1.0;
 
-    seed = rand();
+    seed = RANDOM_INT;
     for (i=0; i<self->stages; i++) {
         self->fOldValues[i] = self->fValues[i];
         seed = (seed * 15625 + 1) & 0xFFFF;
@@ -134,7 +126,7 @@ OscBank_pickNewArnds(OscBank *self, MYFLT arndf, MYFLT arnda) {
     else if (arnda > 1.0)
         arnda = 1.0;
 
-    seed = rand();
+    seed = RANDOM_INT;
     for (i=0; i<self->stages; i++) {
         self->aOldValues[i] = self->aValues[i];
         seed = (seed * 15625 + 1) & 0xFFFF;
@@ -145,8 +137,8 @@ OscBank_pickNewArnds(OscBank *self, MYFLT arndf, MYFLT arnda) {
 
 static void
 OscBank_readframes(OscBank *self) {
-    MYFLT freq, spread, slope, frndf, frnda, arndf, arnda, amp, modamp, pos, inc, x, y, fpart;
-    int i, j, ipart;
+    MYFLT freq, spread, slope, frndf, frnda, arndf, arnda, amp;
+    int i, j;
     MYFLT *tablelist = TableStream_getData(self->table);
     int size = TableStream_getSize(self->table);
     MYFLT tabscl = size / self->sr;
@@ -193,103 +185,37 @@ OscBank_readframes(OscBank *self) {
         self->lastFjit = self->fjit;
         OscBank_setFrequencies(self, freq, spread);
         if (self->fjit == 0) {
-            for (i=0; i<self->stages; i++) {
-                self->pointerPos[i] = 0.0;
-            }
+            OscArray_resetPhases(self->osc);
         }
     }
 
-    if (frnda == 0.0 && arnda == 0.0) {
-        amp = self->amplitude;
-        for (j=0; j<self->stages; j++) {
-            inc = self->frequencies[j] * tabscl;
-            pos = self->pointerPos[j];
-            for (i=0; i<self->bufsize; i++) {
-                pos = OscBank_clip(pos, size);
-                ipart = (int)pos;
-                fpart = pos - ipart;
-                x = tablelist[ipart];
-                y = tablelist[ipart+1];
-                self->data[i] += (x + (y - x) * fpart) * amp;
-                pos += inc;
-            }
-            self->pointerPos[j] = pos;
-            amp *= slope;
-        }
-    }
-    else if (frnda != 0.0 && arnda != 0.0) {
-        if (self->ftime >= 1.0) {
-            OscBank_pickNewFrnds(self, frndf, frnda);
-        }
-        if (self->atime >= 1.0) {
-            OscBank_pickNewArnds(self, arndf, arnda);
-        }
-        amp = self->amplitude;
-        for (j=0; j<self->stages; j++) {
-            inc = (self->frequencies[j] + (self->fOldValues[j] + self->fDiffs[j] * self->ftime)) * tabscl;
-            pos = self->pointerPos[j];
-            modamp = (1.0 - arnda) + (self->aOldValues[j] + self->aDiffs[j] * self->atime);
-            for (i=0; i<self->bufsize; i++) {
-                pos = OscBank_clip(pos, size);
-                ipart = (int)pos;
-                fpart = pos - ipart;
-                x = tablelist[ipart];
-                y = tablelist[ipart+1];
-                self->data[i] += (x + (y - x) * fpart) * amp * modamp;
-                pos += inc;
-            }
-            self->pointerPos[j] = pos;
-            amp *= slope;
-        }
-        self->ftime += self->finc;
-        self->atime += self->ainc;
+    if (frnda != 0.0 && self->ftime >= 1.0) {
+        OscBank_pickNewFrnds(self, frndf, frnda);
     }
-    else if (frnda != 0.0 && arnda == 0.0) {
-        if (self->ftime >= 1.0) {
-            OscBank_pickNewFrnds(self, frndf, frnda);
-        }
-        amp = self->amplitude;
-        for (j=0; j<self->stages; j++) {
-            inc = (self->frequencies[j] + (self->fOldValues[j] + self->fDiffs[j] * self->ftime)) * tabscl;
-            pos = self->pointerPos[j];
-            for (i=0; i<self->bufsize; i++) {
-                pos = OscBank_clip(pos, size);
-                ipart = (int)pos;
-                fpart = pos - ipart;
-                x = tablelist[ipart];
-                y = tablelist[ipart+1];
-                self->data[i] += (x + (y - x) * fpart) * amp;
-                pos += inc;
-            }
-            self->pointerPos[j] = pos;
-            amp *= slope;
-        }
-        self->ftime += self->finc;
+    if (arnda != 0.0 && self->atime >= 1.0) {
+        OscBank_pickNewArnds(self, arndf, arnda);
     }
-    else if (frnda == 0.0 && arnda != 0.0) {
-        if (self->atime >= 1.0) {
-            OscBank_pickNewArnds(self, arndf, arnda);
-        }
-        amp = self->amplitude;
-        for (j=0; j<self->stages; j++) {
-            inc = self->frequencies[j] * tabscl;
-            pos = self->pointerPos[j];
-            modamp = (1.0 - arnda) + (self->aOldValues[j] + self->aDiffs[j] * self->atime);
-            for (i=0; i<self->bufsize; i++) {
-                pos = OscBank_clip(pos, size);
-                ipart = (int)pos;
-                fpart = pos - ipart;
-                x = tablelist[ipart];
-                y = tablelist[ipart+1];
-                self->data[i] += (x + (y - x) * fpart) * amp * modamp;
-                pos += inc;
-            }
-            self->pointerPos[j] = pos;
-            amp *= slope;
-        }
-        self->atime += self->ainc;
+
+    amp = self->amplitude;
+    for (j=0; j<self->stages; j++) {
+        if (frnda != 0.0)
+            self->osc->inc[j] = (self->frequencies[j] + (self->fOldValues[j] + self->fDiffs[j] * self->ftime)) * tabscl;
+        else
+            self->osc->inc[j] = self->frequencies[j] * tabscl;
+        if (arnda != 0.0)
+            self->osc->amp[j] = amp * ((1.0 - arnda) + (self->aOldValues[j] + self->aDiffs[j] * self->atime));
+        else
+            self->osc->amp[j] = amp;
+        amp *= slope;
     }
+    if (self->quadrature != self->osc->quadrature)
+        OscArray_setQuadrature(self->osc, self->quadrature, size);
+    OscArray_process(self->osc, self->data, self->bufsize, self->stages, tablelist, size);
 
+    if (frnda != 0.0)
+        self->ftime += self->finc;
+    if (arnda != 0.0)
+        self->atime += self->ainc;
 }
 
 static void OscBank_postprocessing_ii(OscBank *self) { POST_PROCESSING_II };
@@ -396,7 +322,7 @@ static void
 OscBank_dealloc(OscBank* self)
 {
     pyo_DEALLOC
-    free(self->pointerPos);
+    OscArray_free(self->osc);
     free(self->frequencies);
     free(self->fOldValues);
     free(self->fValues);
@@ -425,6 +351,7 @@ OscBank_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->arnda = PyFloat_FromDouble(0.0);
     self->stages = 24;
     self->fjit = 0;
+    self->quadrature = 0;
     self->lastFreq = self->lastSpread = -1.0;
     self->lastFjit = -1;
     self->ftime = 1.0;
@@ -496,7 +423,7 @@ OscBank_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    self->pointerPos = (MYFLT *)realloc(self->pointerPos, self->stages * sizeof(MYFLT));
+    self->osc = OscArray_new(self->stages);
     self->frequencies = (MYFLT *)realloc(self->frequencies, self->stages * sizeof(MYFLT));
     self->fOldValues = (MYFLT *)realloc(self->fOldValues, self->stages * sizeof(MYFLT));
     self->fValues = (MYFLT *)realloc(self->fValues, self->stages * sizeof(MYFLT));
@@ -506,12 +433,12 @@ OscBank_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->aDiffs = (MYFLT *)realloc(self->aDiffs, self->stages * sizeof(MYFLT));
 
     for (i=0; i<self->stages; i++) {
-        self->pointerPos[i] = self->frequencies[i] = self->fOldValues[i] = self->fValues[i] = self->fDiffs[i] = self->aOldValues[i] = self->aValues[i] = self->aDiffs[i] = 0.0;
+        self->frequencies[i] = self->fOldValues[i] = self->fValues[i] = self->fDiffs[i] = self->aOldValues[i] = self->aValues[i] = self->aDiffs[i] = 0.0;
     }
 
     self->amplitude = 1. / self->stages;
 
-    Server_generateSeed((Server *)self->server, OSCBANK_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, OSCBANK_ID));
 
     return (PyObject *)self;
 }
@@ -798,6 +725,19 @@ OscBank_setFjit(OscBank *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+OscBank_setQuadrature(OscBank *self, PyObject *arg)
+{
+    int isInt = PyInt_Check(arg);
+
+	if (isInt) {
+        self->quadrature = PyInt_AS_LONG(arg) != 0;
+    }
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyMemberDef OscBank_members[] = {
     {"server", T_OBJECT_EX, offsetof(OscBank, server), 0, "Pyo server."},
     {"stream", T_OBJECT_EX, offsetof(OscBank, stream), 0, "Stream object."},
@@ -828,6 +768,7 @@ static PyMethodDef OscBank_methods[] = {
     {"setArndf", (PyCFunction)OscBank_setArndf, METH_O, "Sets frequency of random amplitude changes."},
     {"setArnda", (PyCFunction)OscBank_setArnda, METH_O, "Sets amplitude of random amplitude changes."},
     {"setFjit", (PyCFunction)OscBank_setFjit, METH_O, "Sets frequencies jitter on/off switch."},
+    {"setQuadrature", (PyCFunction)OscBank_setQuadrature, METH_O, "Sets the oscillator mode, table lookup or quadrature."},
     {"setMul", (PyCFunction)OscBank_setMul, METH_O, "Sets oscillator mul factor."},
     {"setAdd", (PyCFunction)OscBank_setAdd, METH_O, "Sets oscillator add factor."},
     {"setSub", (PyCFunction)OscBank_setSub, METH_O, "Sets inverse add factor."},
@@ -27,6 +27,9 @@
 #include "dummymodule.h"
 #include "tablemodule.h"
 #include "interpolation.h"
+#include "sinekernel.h"
+#include "powkernel.h"
+#include "packed.h"
 
 static MYFLT SINE_ARRAY[513] = {0.0, 0.012271538285719925, 0.024541228522912288, 0.036807222941358832, 0.049067674327418015, 0.061320736302208578, 0.073564563599667426, 0.085797312344439894, 0.098017140329560604, 0.11022220729388306, 0.1224106751992162, 0.13458070850712617, 0.14673047445536175, 0.15885814333386145, 0.17096188876030122, 0.18303988795514095, 0.19509032201612825, 0.20711137619221856, 0.2191012401568698, 0.23105810828067111, 0.24298017990326387, 0.25486565960451457, 0.26671275747489837, 0.27851968938505306, 0.29028467725446233, 0.30200594931922808, 0.31368174039889152, 0.32531029216226293, 0.33688985339222005, 0.34841868024943456, 0.35989503653498811, 0.37131719395183754, 0.38268343236508978, 0.3939920400610481, 0.40524131400498986, 0.41642956009763715, 0.42755509343028208, 0.43861623853852766, 0.44961132965460654, 0.46053871095824001, 0.47139673682599764, 0.48218377207912272, 0.49289819222978404, 0.50353838372571758, 0.51410274419322166, 0.52458968267846895, 0.53499761988709715, 0.54532498842204646, 0.55557023301960218, 0.56573181078361312, 0.57580819141784534, 0.58579785745643886, 0.59569930449243336, 0.60551104140432555, 0.61523159058062682, 0.62485948814238634, 0.63439328416364549, 0.64383154288979139, 0.65317284295377676, 0.66241577759017178, 0.67155895484701833, 0.68060099779545302, 0.68954054473706683, 0.69837624940897292, 0.70710678118654746, 0.71573082528381859, 0.72424708295146689, 0.7326542716724127, 0.74095112535495899, 0.74913639452345926, 0.75720884650648446, 0.76516726562245885, 0.77301045336273688, 0.78073722857209438, 0.78834642762660623, 0.79583690460888346, 0.80320753148064483, 0.81045719825259477, 0.81758481315158371, 0.82458930278502529, 0.83146961230254512, 0.83822470555483797, 0.84485356524970701, 0.8513551931052652, 0.85772861000027212, 0.8639728561215867, 0.87008699110871135, 0.87607009419540649, 0.88192126434835494, 0.88763962040285393, 0.89322430119551532, 0.89867446569395382, 0.90398929312344334, 0.90916798309052238, 0.91420975570353069, 0.91911385169005777, 0.92387953251128674, 0.92850608047321548, 0.93299279883473885, 0.93733901191257496, 0.94154406518302081, 0.94560732538052128, 0.94952818059303667, 0.95330604035419375, 0.95694033573220894, 0.96043051941556579, 0.96377606579543984, 0.96697647104485207, 0.97003125319454397, 0.97293995220556007, 0.97570213003852857, 0.97831737071962765, 0.98078528040323043, 0.98310548743121629, 0.98527764238894122, 0.98730141815785843, 0.98917650996478101, 0.99090263542778001, 0.99247953459870997, 0.99390697000235606, 0.99518472667219682, 0.996312612182778, 0.99729045667869021, 0.99811811290014918, 0.99879545620517241, 0.99932238458834954, 0.99969881869620425, 0.9999247018391445, 1.0, 0.9999247018391445, 0.99969881869620425, 0.99932238458834954, 0.99879545620517241, 0.99811811290014918, 0.99729045667869021, 0.996312612182778, 0.99518472667219693, 0.99390697000235606, 0.99247953459870997, 0.99090263542778001, 0.98917650996478101, 0.98730141815785843, 0.98527764238894122, 0.98310548743121629, 0.98078528040323043, 0.97831737071962765, 0.97570213003852857, 0.97293995220556018, 0.97003125319454397, 0.96697647104485207, 0.96377606579543984, 0.9604305194155659, 0.95694033573220894, 0.95330604035419386, 0.94952818059303667, 0.94560732538052139, 0.94154406518302081, 0.93733901191257496, 0.93299279883473885, 0.92850608047321559, 0.92387953251128674, 0.91911385169005777, 0.91420975570353069, 0.90916798309052249, 0.90398929312344345, 0.89867446569395393, 0.89322430119551521, 0.88763962040285393, 0.88192126434835505, 0.8760700941954066, 0.87008699110871146, 0.86397285612158681, 0.85772861000027212, 0.8513551931052652, 0.84485356524970723, 0.83822470555483819, 0.83146961230254546, 0.82458930278502529, 0.81758481315158371, 0.81045719825259477, 0.80320753148064494, 0.79583690460888357, 0.78834642762660634, 0.7807372285720946, 0.7730104533627371, 0.76516726562245907, 0.75720884650648479, 0.74913639452345926, 0.74095112535495899, 0.73265427167241282, 0.724247082951467, 0.71573082528381871, 0.70710678118654757, 0.69837624940897292, 0.68954054473706705, 0.68060099779545324, 0.67155895484701855, 0.66241577759017201, 0.65317284295377664, 0.64383154288979139, 0.63439328416364549, 0.62485948814238634, 0.61523159058062693, 0.60551104140432555, 0.59569930449243347, 0.58579785745643898, 0.57580819141784545, 0.56573181078361345, 0.55557023301960218, 0.54532498842204635, 0.53499761988709715, 0.52458968267846895, 0.51410274419322177, 0.50353838372571758, 0.49289819222978415, 0.48218377207912289, 0.47139673682599781, 0.46053871095824023, 0.44961132965460687, 0.43861623853852755, 0.42755509343028203, 0.41642956009763715, 0.40524131400498986, 0.39399204006104815, 0.38268343236508984, 0.37131719395183765, 0.35989503653498833, 0.34841868024943479, 0.33688985339222027, 0.3253102921622632, 0.31368174039889141, 0.30200594931922803, 0.29028467725446233, 0.27851968938505312, 0.26671275747489848, 0.25486565960451468, 0.24298017990326404, 0.2310581082806713, 0.21910124015687002, 0.20711137619221884, 0.19509032201612858, 0.1830398879551409, 0.17096188876030119, 0.15885814333386145, 0.1467304744553618, 0.13458070850712628, 0.12241067519921635, 0.11022220729388325, 0.09801714032956084, 0.085797312344440158, 0.073564563599667745, 0.061320736302208495, 0.049067674327417973, 0.036807222941358832, 0.024541228522912326, 0.012271538285720007, 1.2246467991473532e-16, -0.012271538285719761, -0.024541228522912083, -0.036807222941358582, -0.049067674327417724, -0.061320736302208245, -0.073564563599667496, -0.085797312344439922, -0.09801714032956059, -0.110222207293883, -0.1224106751992161, -0.13458070850712606, -0.14673047445536158, -0.15885814333386122, -0.17096188876030097, -0.18303988795514067, -0.19509032201612836, -0.20711137619221862, -0.21910124015686983, -0.23105810828067111, -0.24298017990326382, -0.25486565960451446, -0.26671275747489825, -0.27851968938505289, -0.29028467725446216, -0.30200594931922781, -0.31368174039889118, -0.32531029216226304, -0.33688985339222011, -0.34841868024943456, -0.35989503653498811, -0.37131719395183749, -0.38268343236508967, -0.39399204006104793, -0.40524131400498969, -0.41642956009763693, -0.42755509343028181, -0.43861623853852733, -0.44961132965460665, -0.46053871095824006, -0.47139673682599764, -0.48218377207912272, -0.49289819222978393, -0.50353838372571746, -0.51410274419322155, -0.52458968267846873, -0.53499761988709693, -0.54532498842204613, -0.55557023301960196, -0.56573181078361323, -0.57580819141784534, -0.58579785745643886, -0.59569930449243325, -0.60551104140432543, -0.61523159058062671, -0.62485948814238623, -0.63439328416364527, -0.64383154288979128, -0.65317284295377653, -0.66241577759017178, -0.67155895484701844, -0.68060099779545302, -0.68954054473706683, -0.6983762494089728, -0.70710678118654746, -0.71573082528381848, -0.72424708295146667, -0.73265427167241259, -0.74095112535495877, -0.74913639452345904, -0.75720884650648423, -0.76516726562245885, -0.77301045336273666, -0.78073722857209438, -0.78834642762660589, -0.79583690460888334, -0.80320753148064505, -0.81045719825259466, -0.81758481315158371, -0.82458930278502507, -0.83146961230254524, -0.83822470555483775, -0.84485356524970712, -0.85135519310526486, -0.85772861000027201, -0.86397285612158647, -0.87008699110871135, -0.87607009419540671, -0.88192126434835494, -0.88763962040285405, -0.89322430119551521, -0.89867446569395382, -0.90398929312344312, -0.90916798309052238, -0.91420975570353047, -0.91911385169005766, -0.92387953251128652, -0.92850608047321548, -0.93299279883473896, -0.93733901191257485, -0.94154406518302081, -0.94560732538052117, -0.94952818059303667, -0.95330604035419375, -0.95694033573220882, -0.96043051941556568, -0.96377606579543984, -0.96697647104485218, -0.97003125319454397, -0.97293995220556018, -0.97570213003852846, -0.97831737071962765, -0.98078528040323032, -0.98310548743121629, -0.98527764238894111, -0.98730141815785832, -0.9891765099647809, -0.99090263542778001, -0.99247953459871008, -0.99390697000235606, -0.99518472667219693, -0.996312612182778, -0.99729045667869021, -0.99811811290014918, -0.99879545620517241, -0.99932238458834943, -0.99969881869620425, -0.9999247018391445, -1.0, -0.9999247018391445, -0.99969881869620425, -0.99932238458834954, -0.99879545620517241, -0.99811811290014918, -0.99729045667869021, -0.996312612182778, -0.99518472667219693, -0.99390697000235606, -0.99247953459871008, -0.99090263542778001, -0.9891765099647809, -0.98730141815785843, -0.98527764238894122, -0.9831054874312164, -0.98078528040323043, -0.97831737071962777, -0.97570213003852857, -0.97293995220556029, -0.97003125319454397, -0.96697647104485229, -0.96377606579543995, -0.96043051941556579, -0.95694033573220894, -0.95330604035419375, -0.94952818059303679, -0.94560732538052128, -0.94154406518302092, -0.93733901191257496, -0.93299279883473907, -0.92850608047321559, -0.92387953251128663, -0.91911385169005788, -0.91420975570353058, -0.90916798309052249, -0.90398929312344334, -0.89867446569395404, -0.89322430119551532, -0.88763962040285416, -0.88192126434835505, -0.87607009419540693, -0.87008699110871146, -0.8639728561215867, -0.85772861000027223, -0.85135519310526508, -0.84485356524970734, -0.83822470555483797, -0.83146961230254557, -0.82458930278502529, -0.81758481315158404, -0.81045719825259488, -0.80320753148064528, -0.79583690460888368, -0.78834642762660612, -0.78073722857209471, -0.77301045336273688, -0.76516726562245918, -0.75720884650648457, -0.7491363945234597, -0.74095112535495922, -0.73265427167241315, -0.72424708295146711, -0.71573082528381904, -0.70710678118654768, -0.69837624940897269, -0.68954054473706716, -0.68060099779545302, -0.67155895484701866, -0.66241577759017178, -0.65317284295377709, -0.6438315428897915, -0.63439328416364593, -0.62485948814238645, -0.61523159058062737, -0.60551104140432566, -0.59569930449243325, -0.58579785745643909, -0.57580819141784523, -0.56573181078361356, -0.55557023301960218, -0.5453249884220468, -0.53499761988709726, -0.52458968267846939, -0.51410274419322188, -0.50353838372571813, -0.49289819222978426, -0.48218377207912261, -0.47139673682599792, -0.46053871095823995, -0.44961132965460698, -0.43861623853852766, -0.42755509343028253, -0.41642956009763726, -0.40524131400499042, -0.39399204006104827, -0.38268343236509039, -0.37131719395183777, -0.359895036534988, -0.3484186802494349, -0.33688985339222, -0.32531029216226331, -0.31368174039889152, -0.30200594931922853, -0.29028467725446244, -0.27851968938505367, -0.26671275747489859, -0.25486565960451435, -0.24298017990326418, -0.23105810828067103, -0.21910124015687016, -0.20711137619221853, -0.19509032201612872, -0.18303988795514103, -0.17096188876030177, -0.15885814333386158, -0.14673047445536239, -0.13458070850712642, -0.12241067519921603, -0.11022220729388338, -0.09801714032956052, -0.085797312344440282, -0.073564563599667426, -0.06132073630220905, -0.049067674327418091, -0.036807222941359394, -0.024541228522912451, -0.012271538285720572, 0.0};
 static MYFLT COSINE_ARRAY[513] = {1.0, 0.9999247018391445, 0.9996988186962042, 0.9993223845883495, 0.9987954562051724, 0.9981181129001492, 0.9972904566786902, 0.996312612182778, 0.9951847266721969, 0.9939069700023561, 0.99247953459871, 0.99090263542778, 0.989176509964781, 0.9873014181578584, 0.9852776423889412, 0.9831054874312163, 0.9807852804032304, 0.9783173707196277, 0.9757021300385286, 0.9729399522055602, 0.970031253194544, 0.9669764710448521, 0.9637760657954398, 0.9604305194155658, 0.9569403357322088, 0.9533060403541939, 0.9495281805930367, 0.9456073253805213, 0.9415440651830208, 0.937339011912575, 0.932992798834739, 0.9285060804732156, 0.9238795325112867, 0.9191138516900578, 0.9142097557035307, 0.9091679830905224, 0.9039892931234433, 0.8986744656939538, 0.8932243011955153, 0.8876396204028539, 0.881921264348355, 0.8760700941954066, 0.8700869911087115, 0.8639728561215868, 0.8577286100002721, 0.8513551931052652, 0.8448535652497071, 0.8382247055548381, 0.8314696123025452, 0.8245893027850253, 0.8175848131515837, 0.8104571982525948, 0.8032075314806449, 0.7958369046088836, 0.7883464276266063, 0.7807372285720945, 0.773010453362737, 0.765167265622459, 0.7572088465064846, 0.7491363945234594, 0.7409511253549591, 0.7326542716724128, 0.724247082951467, 0.7157308252838186, 0.7071067811865476, 0.6983762494089729, 0.6895405447370669, 0.6806009977954531, 0.6715589548470183, 0.6624157775901718, 0.6531728429537768, 0.6438315428897915, 0.6343932841636455, 0.6248594881423865, 0.6152315905806268, 0.6055110414043255, 0.5956993044924335, 0.5857978574564389, 0.5758081914178453, 0.5657318107836132, 0.5555702330196023, 0.5453249884220465, 0.5349976198870973, 0.5245896826784688, 0.5141027441932217, 0.5035383837257176, 0.4928981922297841, 0.48218377207912283, 0.4713967368259978, 0.46053871095824, 0.4496113296546066, 0.4386162385385277, 0.4275550934302822, 0.4164295600976373, 0.40524131400498986, 0.3939920400610481, 0.38268343236508984, 0.3713171939518376, 0.3598950365349883, 0.3484186802494345, 0.33688985339222005, 0.325310292162263, 0.3136817403988916, 0.3020059493192282, 0.29028467725446233, 0.27851968938505306, 0.2667127574748984, 0.2548656596045146, 0.24298017990326398, 0.23105810828067128, 0.21910124015686977, 0.20711137619221856, 0.19509032201612833, 0.18303988795514106, 0.17096188876030136, 0.1588581433338614, 0.14673047445536175, 0.13458070850712622, 0.12241067519921628, 0.11022220729388318, 0.09801714032956077, 0.08579731234443988, 0.07356456359966745, 0.06132073630220865, 0.049067674327418126, 0.03680722294135899, 0.024541228522912264, 0.012271538285719944, 6.123031769111886e-17, -0.012271538285719823, -0.024541228522912142, -0.036807222941358866, -0.04906767432741801, -0.06132073630220853, -0.07356456359966733, -0.08579731234443976, -0.09801714032956065, -0.11022220729388306, -0.12241067519921615, -0.1345807085071261, -0.14673047445536164, -0.15885814333386128, -0.17096188876030124, -0.18303988795514092, -0.1950903220161282, -0.20711137619221845, -0.21910124015686966, -0.23105810828067114, -0.24298017990326387, -0.2548656596045145, -0.2667127574748983, -0.27851968938505295, -0.29028467725446216, -0.3020059493192281, -0.3136817403988914, -0.32531029216226287, -0.33688985339221994, -0.3484186802494344, -0.35989503653498817, -0.3713171939518375, -0.3826834323650897, -0.393992040061048, -0.40524131400498975, -0.416429560097637, -0.42755509343028186, -0.4386162385385274, -0.4496113296546067, -0.46053871095824006, -0.4713967368259977, -0.4821837720791227, -0.492898192229784, -0.5035383837257175, -0.5141027441932217, -0.5245896826784687, -0.534997619887097, -0.5453249884220462, -0.555570233019602, -0.5657318107836132, -0.5758081914178453, -0.5857978574564389, -0.5956993044924334, -0.6055110414043254, -0.6152315905806267, -0.6248594881423862, -0.6343932841636454, -0.6438315428897913, -0.6531728429537765, -0.6624157775901719, -0.6715589548470184, -0.680600997795453, -0.6895405447370669, -0.6983762494089728, -0.7071067811865475, -0.7157308252838186, -0.7242470829514668, -0.7326542716724127, -0.7409511253549589, -0.7491363945234591, -0.7572088465064846, -0.765167265622459, -0.773010453362737, -0.7807372285720945, -0.7883464276266062, -0.7958369046088835, -0.8032075314806448, -0.8104571982525947, -0.8175848131515836, -0.8245893027850251, -0.8314696123025453, -0.8382247055548381, -0.8448535652497071, -0.8513551931052652, -0.857728610000272, -0.8639728561215867, -0.8700869911087113, -0.8760700941954065, -0.8819212643483549, -0.8876396204028538, -0.8932243011955152, -0.8986744656939539, -0.9039892931234433, -0.9091679830905224, -0.9142097557035307, -0.9191138516900578, -0.9238795325112867, -0.9285060804732155, -0.9329927988347388, -0.9373390119125748, -0.9415440651830207, -0.9456073253805212, -0.9495281805930367, -0.9533060403541939, -0.9569403357322088, -0.9604305194155658,
@@ -67,13 +70,78 @@ typedef struct {
     PyObject *phase;
     Stream *phase_stream;
     int modebuffer[4];
+    int accuracy;
     MYFLT pointerPos;
 } Sine;
 
+/* Renders `num` samples of a polynomial sine, NULL `frs` or `phs` means a
+ * scalar frequency or phase. Returns the new position, which stays in table
+ * units (0 -> 512) so that the accuracy can change while playing. */
+static MYFLT
+Sine_renderVoice(MYFLT *out, MYFLT pointerPos, MYFLT fr, MYFLT *frs, MYFLT ph, MYFLT *phs, double sr, int accuracy, int num)
+{
+    int i;
+    MYFLT fac, offset = phs == NULL ? ph : 0.0;
+
+    if (frs == NULL && phs == NULL) {
+        return SineKernel_oscillate(out, pointerPos * ONE_OVER_512, fr / sr, ph, num, accuracy) * 512;
+    }
+    else if (frs == NULL) {
+        pointerPos = SineKernel_ramp(out, pointerPos * ONE_OVER_512, fr / sr, offset, num) * 512;
+    }
+    else {
+        fac = 512 / sr;
+        for (i=0; i<num; i++) {
+            pointerPos = Sine_clip(pointerPos);
+            out[i] = pointerPos * ONE_OVER_512 + offset;
+            pointerPos += frs[i] * fac;
+        }
+    }
+
+    if (phs != NULL) {
+        for (i=0; i<num; i++) {
+            out[i] += phs[i];
+        }
+    }
+
+    SineKernel_process(out, out, num, accuracy);
+    return pointerPos;
+}
+
+/* Same as Sine_renderVoice with the wavetable, the result is identical to
+ * the readframes functions. */
+static MYFLT
+Sine_renderTable(MYFLT *out, MYFLT pointerPos, MYFLT fr, MYFLT *frs, MYFLT ph, MYFLT *phs, double sr, int num)
+{
+    MYFLT inc, fac, pos, fpart;
+    int i, ipart;
+
+    inc = fr * 512 / sr;
+    fac = 512 / sr;
+    ph = ph * 512;
+    for (i=0; i<num; i++) {
+        if (frs != NULL)
+            inc = frs[i] * fac;
+        pointerPos = Sine_clip(pointerPos);
+        if (phs != NULL)
+            pos = pointerPos + phs[i] * 512;
+        else
+            pos = pointerPos + ph;
+        if (pos >= 512)
+            pos -= 512;
+        ipart = (int)pos;
+        fpart = pos - ipart;
+        out[i] = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        pointerPos += inc;
+    }
+    return pointerPos;
+}
+
 static void
 Sine_readframes_ii(Sine *self) {
     MYFLT inc, fr, ph, pos, fpart;
     int i, ipart;
+    FUSED_MULADD_INIT
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     ph = PyFloat_AS_DOUBLE(self->phase) * 512;
@@ -86,7 +154,7 @@ Sine_readframes_ii(Sine *self) {
             pos -= 512;
         ipart = (int)pos;
         fpart = pos - ipart;
-        self->data[i] = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        self->data[i] = FUSED_MULADD(SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart);
         self->pointerPos += inc;
     }
 }
@@ -95,6 +163,7 @@ static void
 Sine_readframes_ai(Sine *self) {
     MYFLT inc, ph, pos, fpart, fac;
     int i, ipart;
+    FUSED_MULADD_INIT
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = PyFloat_AS_DOUBLE(self->phase) * 512;
@@ -108,7 +177,7 @@ Sine_readframes_ai(Sine *self) {
             pos -= 512;
         ipart = (int)pos;
         fpart = pos - ipart;
-        self->data[i] = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        self->data[i] = FUSED_MULADD(SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart);
         self->pointerPos += inc;
     }
 }
@@ -117,6 +186,7 @@ static void
 Sine_readframes_ia(Sine *self) {
     MYFLT inc, fr, pos, fpart;
     int i, ipart;
+    FUSED_MULADD_INIT
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -129,7 +199,7 @@ Sine_readframes_ia(Sine *self) {
             pos -= 512;
         ipart = (int)pos;
         fpart = pos - ipart;
-        self->data[i] = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        self->data[i] = FUSED_MULADD(SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart);
         self->pointerPos += inc;
     }
 }
@@ -138,6 +208,7 @@ static void
 Sine_readframes_aa(Sine *self) {
     MYFLT inc, pos, fpart, fac;
     int i, ipart;
+    FUSED_MULADD_INIT
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -151,12 +222,35 @@ Sine_readframes_aa(Sine *self) {
             pos -= 512;
         ipart = (int)pos;
         fpart = pos - ipart;
-        self->data[i] = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        self->data[i] = FUSED_MULADD(SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart);
         self->pointerPos += inc;
     }
 }
 
-static void Sine_postprocessing_ii(Sine *self) { POST_PROCESSING_II };
+static void
+Sine_readframes_poly(Sine *self) {
+    int i;
+    MYFLT fr = 0.0, ph = 0.0, *frs = NULL, *phs = NULL;
+    FUSED_MULADD_INIT
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        frs = Stream_getData((Stream *)self->freq_stream);
+    if (self->modebuffer[3] == 0)
+        ph = PyFloat_AS_DOUBLE(self->phase);
+    else
+        phs = Stream_getData((Stream *)self->phase_stream);
+
+    self->pointerPos = Sine_renderVoice(self->data, self->pointerPos, fr, frs, ph, phs, self->sr, self->accuracy, self->bufsize);
+
+    if (fused_mul != 1.0 || fused_add != 0.0) {
+        for (i=0; i<self->bufsize; i++) {
+            self->data[i] = FUSED_MULADD(self->data[i]);
+        }
+    }
+}
+
 static void Sine_postprocessing_ai(Sine *self) { POST_PROCESSING_AI };
 static void Sine_postprocessing_ia(Sine *self) { POST_PROCESSING_IA };
 static void Sine_postprocessing_aa(Sine *self) { POST_PROCESSING_AA };
@@ -187,10 +281,13 @@ Sine_setProcMode(Sine *self)
             self->proc_func_ptr = Sine_readframes_aa;
             break;
     }
+    if (self->accuracy != SINE_ACCURACY_TABLE) {
+        self->proc_func_ptr = Sine_readframes_poly;
+    }
 
 	switch (muladdmode) {
         case 0:
-            self->muladd_func_ptr = Sine_postprocessing_ii;
+            self->muladd_func_ptr = pyo_postprocessing_fused;
             break;
         case 1:
             self->muladd_func_ptr = Sine_postprocessing_ai;
@@ -271,17 +368,21 @@ Sine_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
+    self->accuracy = SINE_ACCURACY_TABLE;
     self->pointerPos = 0.;
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Sine_compute_next_data_frame);
     self->mode_func_ptr = Sine_setProcMode;
 
-    static char *kwlist[] = {"freq", "phase", "mul", "add", NULL};
+    static char *kwlist[] = {"freq", "phase", "mul", "add", "accuracy", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "|OOOO", kwlist, &freqtmp, &phasetmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "|OOOOi", kwlist, &freqtmp, &phasetmp, &multmp, &addtmp, &self->accuracy))
         Py_RETURN_NONE;
 
+    if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+        self->accuracy = SINE_ACCURACY_TABLE;
+
     if (freqtmp) {
         PyObject_CallMethod((PyObject *)self, "setFreq", "O", freqtmp);
     }
@@ -393,6 +494,25 @@ Sine_setPhase(Sine *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Sine_setAccuracy(Sine *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+    if (PyNumber_Check(arg) == 1) {
+        self->accuracy = PyInt_AsLong(PyNumber_Int(arg));
+        if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+            self->accuracy = SINE_ACCURACY_TABLE;
+        (*self->mode_func_ptr)(self);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject *
 Sine_reset(Sine *self)
 {
@@ -419,6 +539,7 @@ static PyMethodDef Sine_methods[] = {
 {"stop", (PyCFunction)Sine_stop, METH_NOARGS, "Stops computing."},
 {"setFreq", (PyCFunction)Sine_setFreq, METH_O, "Sets oscillator frequency in cycle per second."},
 {"setPhase", (PyCFunction)Sine_setPhase, METH_O, "Sets oscillator phase between 0 and 1."},
+{"setAccuracy", (PyCFunction)Sine_setAccuracy, METH_O, "Sets the sine computation (0 = table, 1 = fast polynomial, 2 = precise polynomial)."},
 {"reset", (PyCFunction)Sine_reset, METH_NOARGS, "Resets pointer position to 0."},
 {"setMul", (PyCFunction)Sine_setMul, METH_O, "Sets Sine mul factor."},
 {"setAdd", (PyCFunction)Sine_setAdd, METH_O, "Sets Sine add factor."},
@@ -521,10 +642,44 @@ typedef struct {
     PyObject *feedback;
     Stream *feedback_stream;
     int modebuffer[4];
+    int accuracy;
     MYFLT pointerPos;
     MYFLT lastValue;
 } SineLoop;
 
+/* Renders `num` samples of a SineLoop with any accuracy, NULL `frs` or `fds`
+ * means a scalar frequency or feedback. The wavetable result is identical
+ * to the readframes functions. The feedback makes each sample depend on
+ * the previous one, the polynomial is computed per sample. */
+static void
+SineLoop_renderVoice(MYFLT *out, MYFLT *pointerPos, MYFLT *lastValue, MYFLT fr, MYFLT *frs, MYFLT fd, MYFLT *fds, double sr, int accuracy, int num)
+{
+    MYFLT inc, fac, feed, pos, fpart, pointer = *pointerPos, last = *lastValue;
+    int i, ipart;
+
+    inc = fr * 512 / sr;
+    fac = 512 / sr;
+    feed = _clip(fd) * 512;
+    for (i=0; i<num; i++) {
+        if (frs != NULL)
+            inc = frs[i] * fac;
+        if (fds != NULL)
+            feed = _clip(fds[i]) * 512;
+        pointer = Sine_clip(pointer);
+        pos = Sine_clip(pointer + last * feed);
+        if (accuracy == SINE_ACCURACY_TABLE) {
+            ipart = (int)pos;
+            fpart = pos - ipart;
+            out[i] = last = SINE_ARRAY[ipart] * (1.0 - fpart) + SINE_ARRAY[ipart+1] * fpart;
+        }
+        else
+            out[i] = last = SineKernel_sample(pos * ONE_OVER_512, accuracy);
+        pointer += inc;
+    }
+    *pointerPos = pointer;
+    *lastValue = last;
+}
+
 static void
 SineLoop_readframes_ii(SineLoop *self) {
     MYFLT inc, fr, feed, pos, fpart;
@@ -605,6 +760,22 @@ SineLoop_readframes_aa(SineLoop *self) {
     }
 }
 
+static void
+SineLoop_readframes_poly(SineLoop *self) {
+    MYFLT fr = 0.0, fd = 0.0, *frs = NULL, *fds = NULL;
+
+    if (self->modebuffer[2] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        frs = Stream_getData((Stream *)self->freq_stream);
+    if (self->modebuffer[3] == 0)
+        fd = PyFloat_AS_DOUBLE(self->feedback);
+    else
+        fds = Stream_getData((Stream *)self->feedback_stream);
+
+    SineLoop_renderVoice(self->data, &self->pointerPos, &self->lastValue, fr, frs, fd, fds, self->sr, self->accuracy, self->bufsize);
+}
+
 static void SineLoop_postprocessing_ii(SineLoop *self) { POST_PROCESSING_II };
 static void SineLoop_postprocessing_ai(SineLoop *self) { POST_PROCESSING_AI };
 static void SineLoop_postprocessing_ia(SineLoop *self) { POST_PROCESSING_IA };
@@ -636,6 +807,9 @@ SineLoop_setProcMode(SineLoop *self)
             self->proc_func_ptr = SineLoop_readframes_aa;
             break;
     }
+    if (self->accuracy != SINE_ACCURACY_TABLE) {
+        self->proc_func_ptr = SineLoop_readframes_poly;
+    }
 
 	switch (muladdmode) {
         case 0:
@@ -719,17 +893,21 @@ SineLoop_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
 	self->modebuffer[3] = 0;
+    self->accuracy = SINE_ACCURACY_TABLE;
     self->pointerPos = self->lastValue = 0.;
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, SineLoop_compute_next_data_frame);
     self->mode_func_ptr = SineLoop_setProcMode;
 
-    static char *kwlist[] = {"freq", "feedback", "mul", "add", NULL};
+    static char *kwlist[] = {"freq", "feedback", "mul", "add", "accuracy", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "|OOOO", kwlist, &freqtmp, &feedbacktmp, &multmp, &addtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "|OOOOi", kwlist, &freqtmp, &feedbacktmp, &multmp, &addtmp, &self->accuracy))
         Py_RETURN_NONE;
 
+    if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+        self->accuracy = SINE_ACCURACY_TABLE;
+
     if (freqtmp) {
         PyObject_CallMethod((PyObject *)self, "setFreq", "O", freqtmp);
     }
@@ -841,6 +1019,25 @@ SineLoop_setFeedback(SineLoop *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+SineLoop_setAccuracy(SineLoop *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+    if (PyNumber_Check(arg) == 1) {
+        self->accuracy = PyInt_AsLong(PyNumber_Int(arg));
+        if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+            self->accuracy = SINE_ACCURACY_TABLE;
+        (*self->mode_func_ptr)(self);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyMemberDef SineLoop_members[] = {
 	{"server", T_OBJECT_EX, offsetof(SineLoop, server), 0, "Pyo server."},
 	{"stream", T_OBJECT_EX, offsetof(SineLoop, stream), 0, "Stream object."},
@@ -859,6 +1056,7 @@ static PyMethodDef SineLoop_methods[] = {
 	{"stop", (PyCFunction)SineLoop_stop, METH_NOARGS, "Stops computing."},
 	{"setFreq", (PyCFunction)SineLoop_setFreq, METH_O, "Sets oscillator frequency in cycle per second."},
 	{"setFeedback", (PyCFunction)SineLoop_setFeedback, METH_O, "Sets oscillator feedback between 0 and 1."},
+	{"setAccuracy", (PyCFunction)SineLoop_setAccuracy, METH_O, "Sets the sine computation (0 = table, 1 = fast polynomial, 2 = precise polynomial)."},
 	{"setMul", (PyCFunction)SineLoop_setMul, METH_O, "Sets SineLoop mul factor."},
 	{"setAdd", (PyCFunction)SineLoop_setAdd, METH_O, "Sets SineLoop add factor."},
 	{"setSub", (PyCFunction)SineLoop_setSub, METH_O, "Sets inverse add factor."},
@@ -974,16 +1172,18 @@ typedef struct {
     int modebuffer[4];
     double pointerPos;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } Osc;
 
 static void
 Osc_readframes_ii(Osc *self) {
-    MYFLT fr, ph, fpart;
+    MYFLT fr, ph;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -996,19 +1196,22 @@ Osc_readframes_ii(Osc *self) {
         pos = self->pointerPos + ph;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 Osc_readframes_ai(Osc *self) {
-    MYFLT ph, fpart, sizeOnSr;
+    MYFLT ph, sizeOnSr;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -1022,19 +1225,22 @@ Osc_readframes_ai(Osc *self) {
         pos = self->pointerPos + ph;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 Osc_readframes_ia(Osc *self) {
-    MYFLT fr, pha, fpart;
+    MYFLT fr, pha;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -1047,19 +1253,22 @@ Osc_readframes_ia(Osc *self) {
         pos = self->pointerPos + pha;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 Osc_readframes_aa(Osc *self) {
-    MYFLT pha, fpart, sizeOnSr;
+    MYFLT pha, sizeOnSr;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -1073,10 +1282,10 @@ Osc_readframes_aa(Osc *self) {
         pos = self->pointerPos + pha;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void Osc_postprocessing_ii(Osc *self) { POST_PROCESSING_II };
@@ -1233,7 +1442,7 @@ Osc_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -1365,7 +1574,7 @@ Osc_setInterp(Osc *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2005,16 +2214,18 @@ typedef struct {
     int modebuffer[4];
     double pointerPos;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } OscTrig;
 
 static void
 OscTrig_readframes_ii(OscTrig *self) {
-    MYFLT fr, ph, fpart;
+    MYFLT fr, ph;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -2032,19 +2243,22 @@ OscTrig_readframes_ii(OscTrig *self) {
         pos = self->pointerPos + ph;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 OscTrig_readframes_ai(OscTrig *self) {
-    MYFLT ph, fpart, sizeOnSr;
+    MYFLT ph, sizeOnSr;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -2063,19 +2277,22 @@ OscTrig_readframes_ai(OscTrig *self) {
         pos = self->pointerPos + ph;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 OscTrig_readframes_ia(OscTrig *self) {
-    MYFLT fr, pha, fpart;
+    MYFLT fr, pha;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -2093,19 +2310,22 @@ OscTrig_readframes_ia(OscTrig *self) {
         pos = self->pointerPos + pha;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void
 OscTrig_readframes_aa(OscTrig *self) {
-    MYFLT pha, fpart, sizeOnSr;
+    MYFLT pha, sizeOnSr;
     double inc, pos;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -2124,10 +2344,10 @@ OscTrig_readframes_aa(OscTrig *self) {
         pos = self->pointerPos + pha;
         if (pos >= size)
             pos -= size;
-        ipart = (int)pos;
-        fpart = pos - ipart;
-        self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+        ipos[i] = (int)pos;
+        fpos[i] = pos - ipos[i];
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
 }
 
 static void OscTrig_postprocessing_ii(OscTrig *self) { POST_PROCESSING_II };
@@ -2292,7 +2512,7 @@ OscTrig_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -2455,7 +2675,7 @@ OscTrig_setInterp(OscTrig *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2598,27 +2818,59 @@ typedef struct {
     double pointerPos;
 } Phasor;
 
-static void
-Phasor_readframes_ii(Phasor *self) {
-    MYFLT fr, ph;
-    double inc, pos;
+/* Renders `num` samples of a ramp, NULL `frs` or `phs` means a scalar
+ * frequency or phase. Returns the new position. With a scalar frequency,
+ * the ramp is vectorized. */
+static double
+Phasor_renderVoice(MYFLT *out, double pointerPos, MYFLT fr, MYFLT *frs, MYFLT ph, MYFLT *phs, double sr, int num)
+{
+    MYFLT pha, oneOnSr;
+    double pos;
     int i;
 
-    fr = PyFloat_AS_DOUBLE(self->freq);
-    ph = _clip(PyFloat_AS_DOUBLE(self->phase));
-    inc = fr / self->sr;
+    if (frs == NULL) {
+        pointerPos = SineKernel_ramp(out, pointerPos, fr / sr, phs == NULL ? _clip(ph) : 0.0, num);
+        if (phs != NULL) {
+            for (i=0; i<num; i++) {
+                out[i] += _clip(phs[i]);
+                if (out[i] > 1)
+                    out[i] -= 1.0;
+            }
+        }
+        return pointerPos;
+    }
 
-    for (i=0; i<self->bufsize; i++) {
-        pos = self->pointerPos + ph;
+    oneOnSr = 1.0 / sr;
+    pha = _clip(ph);
+    for (i=0; i<num; i++) {
+        if (phs != NULL)
+            pha = _clip(phs[i]);
+        pos = pointerPos + pha;
         if (pos > 1)
             pos -= 1.0;
-        self->data[i] = pos;
+        out[i] = pos;
 
-        self->pointerPos += inc;
-        if (self->pointerPos < 0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1)
-            self->pointerPos -= 1.0;
+        pointerPos += frs[i] * oneOnSr;
+        if (pointerPos < 0)
+            pointerPos += 1.0;
+        else if (pointerPos >= 1)
+            pointerPos -= 1.0;
+    }
+    return pointerPos;
+}
+
+static void
+Phasor_readframes_ii(Phasor *self) {
+    int i;
+    FUSED_MULADD_INIT
+
+    self->pointerPos = Phasor_renderVoice(self->data, self->pointerPos, PyFloat_AS_DOUBLE(self->freq), NULL,
+                                          PyFloat_AS_DOUBLE(self->phase), NULL, self->sr, self->bufsize);
+
+    if (fused_mul != 1.0 || fused_add != 0.0) {
+        for (i=0; i<self->bufsize; i++) {
+            self->data[i] = FUSED_MULADD(self->data[i]);
+        }
     }
 }
 
@@ -2627,6 +2879,7 @@ Phasor_readframes_ai(Phasor *self) {
     MYFLT ph, oneOnSr;
     double inc, pos;
     int i;
+    FUSED_MULADD_INIT
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = _clip(PyFloat_AS_DOUBLE(self->phase));
@@ -2636,7 +2889,7 @@ Phasor_readframes_ai(Phasor *self) {
         pos = self->pointerPos + ph;
         if (pos > 1)
             pos -= 1.0;
-        self->data[i] = pos;
+        self->data[i] = FUSED_MULADD(pos);
 
         inc = fr[i] * oneOnSr;
         self->pointerPos += inc;
@@ -2649,28 +2902,18 @@ Phasor_readframes_ai(Phasor *self) {
 
 static void
 Phasor_readframes_ia(Phasor *self) {
-    MYFLT fr, pha;
-    double inc, pos;
     int i;
+    FUSED_MULADD_INIT
 
-    fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
 
-    inc = fr / self->sr;
-
-    for (i=0; i<self->bufsize; i++) {
-        pha = _clip(ph[i]);
-
-        pos = self->pointerPos + pha;
-        if (pos > 1)
-            pos -= 1.0;
-        self->data[i] = pos;
+    self->pointerPos = Phasor_renderVoice(self->data, self->pointerPos, PyFloat_AS_DOUBLE(self->freq), NULL,
+                                          0.0, ph, self->sr, self->bufsize);
 
-        self->pointerPos += inc;
-        if (self->pointerPos < 0)
-            self->pointerPos += 1.0;
-        else if (self->pointerPos >= 1)
-            self->pointerPos -= 1.0;
+    if (fused_mul != 1.0 || fused_add != 0.0) {
+        for (i=0; i<self->bufsize; i++) {
+            self->data[i] = FUSED_MULADD(self->data[i]);
+        }
     }
 }
 
@@ -2679,6 +2922,7 @@ Phasor_readframes_aa(Phasor *self) {
     MYFLT pha, oneOnSr;
     double inc, pos;
     int i;
+    FUSED_MULADD_INIT
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -2691,7 +2935,7 @@ Phasor_readframes_aa(Phasor *self) {
         pos = self->pointerPos + pha;
         if (pos > 1)
             pos -= 1.0;
-        self->data[i] = pos;
+        self->data[i] = FUSED_MULADD(pos);
 
         inc = fr[i] * oneOnSr;
         self->pointerPos += inc;
@@ -2702,7 +2946,6 @@ Phasor_readframes_aa(Phasor *self) {
     }
 }
 
-static void Phasor_postprocessing_ii(Phasor *self) { POST_PROCESSING_II };
 static void Phasor_postprocessing_ai(Phasor *self) { POST_PROCESSING_AI };
 static void Phasor_postprocessing_ia(Phasor *self) { POST_PROCESSING_IA };
 static void Phasor_postprocessing_aa(Phasor *self) { POST_PROCESSING_AA };
@@ -2735,7 +2978,7 @@ Phasor_setProcMode(Phasor *self)
     }
 	switch (muladdmode) {
         case 0:
-            self->muladd_func_ptr = Phasor_postprocessing_ii;
+            self->muladd_func_ptr = pyo_postprocessing_fused;
             break;
         case 1:
             self->muladd_func_ptr = Phasor_postprocessing_ai;
@@ -3055,6 +3298,261 @@ Phasor_members,             /* tp_members */
 Phasor_new,                 /* tp_new */
 };
 
+/****************************************/
+/* MultiOscMain, read by PackedChannel  */
+/****************************************/
+/* MultiOscMain renders all the voices of a Sine, SineLoop or Phasor in one
+ * object, in a packed stream whose channels are the voices. */
+#define MULTIOSC_SINE 0
+#define MULTIOSC_SINELOOP 1
+#define MULTIOSC_PHASOR 2
+
+typedef struct {
+    pyo_audio_HEAD
+    int wave; /* 0 = Sine, 1 = SineLoop, 2 = Phasor */
+    int voices;
+    int accuracy;
+    PyObject *freq; /* list of streams or None, one per voice */
+    PyObject *phase; /* phase, or feedback for a SineLoop */
+    MYFLT *freqs;
+    MYFLT *phases;
+    Stream **freq_streams; /* borrowed from the lists, NULL for a float */
+    Stream **phase_streams;
+    double *pointerPos;
+    MYFLT *lastValue;
+} MultiOscMain;
+
+static void
+MultiOscMain_compute_next_data_frame(MultiOscMain *self)
+{
+    int i;
+    MYFLT pos, *out, *frs, *phs;
+
+    for (i=0; i<self->voices; i++) {
+        out = self->data + i * self->bufsize;
+        frs = self->freq_streams[i] == NULL ? NULL : Stream_getData(self->freq_streams[i]);
+        phs = self->phase_streams[i] == NULL ? NULL : Stream_getData(self->phase_streams[i]);
+        switch (self->wave) {
+            case MULTIOSC_SINE:
+                if (self->accuracy == SINE_ACCURACY_TABLE)
+                    self->pointerPos[i] = Sine_renderTable(out, self->pointerPos[i], self->freqs[i], frs,
+                                                           self->phases[i], phs, self->sr, self->bufsize);
+                else
+                    self->pointerPos[i] = Sine_renderVoice(out, self->pointerPos[i], self->freqs[i], frs,
+                                                           self->phases[i], phs, self->sr, self->accuracy, self->bufsize);
+                break;
+            case MULTIOSC_SINELOOP:
+                pos = self->pointerPos[i];
+                SineLoop_renderVoice(out, &pos, &self->lastValue[i], self->freqs[i], frs,
+                                     self->phases[i], phs, self->sr, self->accuracy, self->bufsize);
+                self->pointerPos[i] = pos;
+                break;
+            case MULTIOSC_PHASOR:
+                self->pointerPos[i] = Phasor_renderVoice(out, self->pointerPos[i], self->freqs[i], frs,
+                                                         self->phases[i], phs, self->sr, self->bufsize);
+                break;
+        }
+    }
+}
+
+static void
+MultiOscMain_setProcMode(MultiOscMain *self) {}
+
+static int
+MultiOscMain_traverse(MultiOscMain *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->freq);
+    Py_VISIT(self->phase);
+    return 0;
+}
+
+static int
+MultiOscMain_clear(MultiOscMain *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->freq);
+    Py_CLEAR(self->phase);
+    return 0;
+}
+
+static void
+MultiOscMain_dealloc(MultiOscMain* self)
+{
+    pyo_DEALLOC
+    free(self->freqs);
+    free(self->phases);
+    free(self->freq_streams);
+    free(self->phase_streams);
+    free(self->pointerPos);
+    free(self->lastValue);
+    MultiOscMain_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+MultiOscMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i;
+    PyObject *freqtmp=NULL, *phasetmp=NULL;
+    MultiOscMain *self;
+    self = (MultiOscMain *)type->tp_alloc(type, 0);
+
+    self->wave = MULTIOSC_SINE;
+    self->voices = 1;
+    self->accuracy = SINE_ACCURACY_TABLE;
+
+    INIT_OBJECT_COMMON
+    Stream_setFunctionPtr(self->stream, MultiOscMain_compute_next_data_frame);
+    self->mode_func_ptr = MultiOscMain_setProcMode;
+
+    static char *kwlist[] = {"wave", "voices", "freq", "phase", "accuracy", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "iiOO|i", kwlist, &self->wave, &self->voices, &freqtmp, &phasetmp, &self->accuracy))
+        Py_RETURN_NONE;
+
+    if (self->voices < 1)
+        self->voices = 1;
+    if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+        self->accuracy = SINE_ACCURACY_TABLE;
+
+    self->freqs = (MYFLT *)calloc(self->voices, sizeof(MYFLT));
+    self->phases = (MYFLT *)calloc(self->voices, sizeof(MYFLT));
+    self->freq_streams = (Stream **)calloc(self->voices, sizeof(Stream *));
+    self->phase_streams = (Stream **)calloc(self->voices, sizeof(Stream *));
+    self->pointerPos = (double *)calloc(self->voices, sizeof(double));
+    self->lastValue = (MYFLT *)calloc(self->voices, sizeof(MYFLT));
+    INIT_PACKED_STREAM(self->voices)
+
+    if (Packed_setValues(freqtmp, self->voices, &self->freq, self->freqs, self->freq_streams) < 0 ||
+        Packed_setValues(phasetmp, self->voices, &self->phase, self->phases, self->phase_streams) < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    return (PyObject *)self;
+}
+
+static PyObject * MultiOscMain_getServer(MultiOscMain* self) { GET_SERVER };
+static PyObject * MultiOscMain_getStream(MultiOscMain* self) { GET_STREAM };
+
+static PyObject * MultiOscMain_play(MultiOscMain *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * MultiOscMain_stop(MultiOscMain *self) { STOP_PACKED(self->voices) };
+
+static PyObject *
+MultiOscMain_setFreq(MultiOscMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->voices, &self->freq, self->freqs, self->freq_streams) < 0)
+        return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+MultiOscMain_setPhase(MultiOscMain *self, PyObject *arg)
+{
+    if (Packed_setValues(arg, self->voices, &self->phase, self->phases, self->phase_streams) < 0)
+        return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+MultiOscMain_setAccuracy(MultiOscMain *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+    if (PyNumber_Check(arg) == 1) {
+        self->accuracy = PyInt_AsLong(PyNumber_Int(arg));
+        if (self->accuracy < 0 || self->accuracy >= SINE_ACCURACIES)
+            self->accuracy = SINE_ACCURACY_TABLE;
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+MultiOscMain_reset(MultiOscMain *self)
+{
+    int i;
+
+    for (i=0; i<self->voices; i++) {
+        self->pointerPos[i] = 0.0;
+        self->lastValue[i] = 0.0;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyMemberDef MultiOscMain_members[] = {
+{"server", T_OBJECT_EX, offsetof(MultiOscMain, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(MultiOscMain, stream), 0, "Stream object."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef MultiOscMain_methods[] = {
+{"getServer", (PyCFunction)MultiOscMain_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)MultiOscMain_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)MultiOscMain_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)MultiOscMain_stop, METH_NOARGS, "Stops computing."},
+{"setFreq", (PyCFunction)MultiOscMain_setFreq, METH_O, "Sets the frequencies of the voices, a list of floats or PyoObjects."},
+{"setPhase", (PyCFunction)MultiOscMain_setPhase, METH_O, "Sets the phases (feedbacks for SineLoop) of the voices, a list of floats or PyoObjects."},
+{"setAccuracy", (PyCFunction)MultiOscMain_setAccuracy, METH_O, "Sets the sine computation (0 = table, 1 = fast polynomial, 2 = precise polynomial)."},
+{"reset", (PyCFunction)MultiOscMain_reset, METH_NOARGS, "Resets pointer positions to 0."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject MultiOscMainType = {
+PyObject_HEAD_INIT(NULL)
+0,                         /*ob_size*/
+"_pyo.MultiOscMain_base",         /*tp_name*/
+sizeof(MultiOscMain),         /*tp_basicsize*/
+0,                         /*tp_itemsize*/
+(destructor)MultiOscMain_dealloc, /*tp_dealloc*/
+0,                         /*tp_print*/
+0,                         /*tp_getattr*/
+0,                         /*tp_setattr*/
+0,                         /*tp_compare*/
+0,                         /*tp_repr*/
+0,             /*tp_as_number*/
+0,                         /*tp_as_sequence*/
+0,                         /*tp_as_mapping*/
+0,                         /*tp_hash */
+0,                         /*tp_call*/
+0,                         /*tp_str*/
+0,                         /*tp_getattro*/
+0,                         /*tp_setattro*/
+0,                         /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES, /*tp_flags*/
+"MultiOscMain objects. Renders the voices of a Sine, SineLoop or Phasor.",           /* tp_doc */
+(traverseproc)MultiOscMain_traverse,   /* tp_traverse */
+(inquiry)MultiOscMain_clear,           /* tp_clear */
+0,		               /* tp_richcompare */
+0,		               /* tp_weaklistoffset */
+0,		               /* tp_iter */
+0,		               /* tp_iternext */
+MultiOscMain_methods,             /* tp_methods */
+MultiOscMain_members,             /* tp_members */
+0,                      /* tp_getset */
+0,                         /* tp_base */
+0,                         /* tp_dict */
+0,                         /* tp_descr_get */
+0,                         /* tp_descr_set */
+0,                         /* tp_dictoffset */
+0,      /* tp_init */
+0,                         /* tp_alloc */
+MultiOscMain_new,                 /* tp_new */
+};
+
+/************************************************************************************************/
 /**************/
 /* Pointer object */
 /**************/
@@ -3411,34 +3909,35 @@ typedef struct {
     MYFLT y2;
     MYFLT c;
     MYFLT lastPh;
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } Pointer2;
 
 static void
 Pointer2_readframes_a(Pointer2 *self) {
-    MYFLT fpart, phdiff, b, fr;
+    MYFLT phdiff, b, fr;
     double ph;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    int i;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
     double tableSr = TableStream_getSamplingRate(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *pha = Stream_getData((Stream *)self->index_stream);
 
+    for (i=0; i<self->bufsize; i++) {
+        ph = Osc_clip(pha[i] * size, size);
+        ipos[i] = (int)ph;
+        fpos[i] = ph - ipos[i];
+    }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+
     if (!self->autosmooth) {
-        for (i=0; i<self->bufsize; i++) {
-            ph = Osc_clip(pha[i] * size, size);
-            ipart = (int)ph;
-            fpart = ph - ipart;
-            self->y1 = self->y2 = self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
-        }
+        self->y1 = self->y2 = self->data[self->bufsize-1];
     }
     else {
         for (i=0; i<self->bufsize; i++) {
             ph = Osc_clip(pha[i] * size, size);
-            ipart = (int)ph;
-            fpart = ph - ipart;
-            self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
             phdiff = MYFABS(ph - self->lastPh);
             self->lastPh = ph;
             if (phdiff < 1) {
@@ -3582,7 +4081,7 @@ Pointer2_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -3675,7 +4174,7 @@ Pointer2_setInterp(Pointer2 *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -4519,18 +5018,21 @@ typedef struct {
     int modebuffer[5];
     MYFLT pointerPos;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } Pulsar;
 
 static void
 Pulsar_readframes_iii(Pulsar *self) {
-    MYFLT fr, ph, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, tmp;
+    MYFLT fr, ph, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -4550,30 +5052,38 @@ Pulsar_readframes_iii(Pulsar *self) {
         if (pos < frac) {
             scl_pos = pos * invfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_aii(Pulsar *self) {
-    MYFLT ph, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, tmp, oneOnSr;
+    MYFLT ph, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, oneOnSr;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -4594,30 +5104,38 @@ Pulsar_readframes_aii(Pulsar *self) {
         if (pos < frac) {
             scl_pos = pos * invfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_iai(Pulsar *self) {
-    MYFLT fr, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, tmp;
+    MYFLT fr, frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -4637,30 +5155,38 @@ Pulsar_readframes_iai(Pulsar *self) {
         if (pos < frac) {
             scl_pos = pos * invfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_aai(Pulsar *self) {
-    MYFLT frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, tmp, oneOnSr;
+    MYFLT frac, invfrac, pos, scl_pos, t_pos, e_pos, fpart, oneOnSr;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -4681,30 +5207,38 @@ Pulsar_readframes_aai(Pulsar *self) {
         if (pos < frac) {
             scl_pos = pos * invfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_iia(Pulsar *self) {
-    MYFLT fr, ph, pos, curfrac, scl_pos, t_pos, e_pos, fpart, tmp;
+    MYFLT fr, ph, pos, curfrac, scl_pos, t_pos, e_pos, fpart;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -4724,30 +5258,38 @@ Pulsar_readframes_iia(Pulsar *self) {
         if (pos < curfrac) {
             scl_pos = pos / curfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_aia(Pulsar *self) {
-    MYFLT ph, pos, curfrac, scl_pos, t_pos, e_pos, fpart, tmp, oneOnSr;
+    MYFLT ph, pos, curfrac, scl_pos, t_pos, e_pos, fpart, oneOnSr;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     ph = PyFloat_AS_DOUBLE(self->phase);
@@ -4768,30 +5310,38 @@ Pulsar_readframes_aia(Pulsar *self) {
         if (pos < curfrac) {
             scl_pos = pos / curfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_iaa(Pulsar *self) {
-    MYFLT fr, pos, curfrac, scl_pos, t_pos, e_pos, fpart, tmp;
+    MYFLT fr, pos, curfrac, scl_pos, t_pos, e_pos, fpart;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -4811,30 +5361,38 @@ Pulsar_readframes_iaa(Pulsar *self) {
         if (pos < curfrac) {
             scl_pos = pos / curfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void
 Pulsar_readframes_aaa(Pulsar *self) {
-    MYFLT pos, curfrac, scl_pos, t_pos, e_pos, fpart, tmp, oneOnSr;
+    MYFLT pos, curfrac, scl_pos, t_pos, e_pos, fpart, oneOnSr;
     double inc;
     int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     MYFLT *envlist = TableStream_getData(self->env);
     int size = TableStream_getSize(self->table);
     int envsize = TableStream_getSize(self->env);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    double amp[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *ph = Stream_getData((Stream *)self->phase_stream);
@@ -4855,19 +5413,23 @@ Pulsar_readframes_aaa(Pulsar *self) {
         if (pos < curfrac) {
             scl_pos = pos / curfrac;
             t_pos = scl_pos * size;
-            ipart = (int)t_pos;
-            fpart = t_pos - ipart;
-            tmp = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)t_pos;
+            fpos[i] = t_pos - ipos[i];
 
             e_pos = scl_pos * envsize;
             ipart = (int)e_pos;
             fpart = e_pos - ipart;
-            self->data[i] = tmp * (envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart);
+            amp[i] = envlist[ipart] * (1.0 - fpart) + envlist[ipart+1] * fpart;
         }
         else {
-            self->data[i] = 0.0;
+            ipos[i] = 0;
+            fpos[i] = amp[i] = 0.0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = amp[i] != 0.0 ? self->data[i] * amp[i] : 0.0;
+    }
 }
 
 static void Pulsar_postprocessing_ii(Pulsar *self) { POST_PROCESSING_II };
@@ -5055,7 +5617,7 @@ Pulsar_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -5246,7 +5808,7 @@ Pulsar_setInterp(Pulsar *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -5385,15 +5947,17 @@ typedef struct {
     TriggerStream *trig_stream;
     int init;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } TableRead;
 
 static void
 TableRead_readframes_i(TableRead *self) {
-    MYFLT fr, inc, fpart;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    MYFLT fr, inc;
+    int i, num = 0;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     inc = fr * size / self->sr;
@@ -5418,23 +5982,28 @@ TableRead_readframes_i(TableRead *self) {
                 self->go = 0;
         }
         if (self->go == 1) {
-            ipart = (int)self->pointerPos;
-            fpart = self->pointerPos - ipart;
-            self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)self->pointerPos;
+            fpos[i] = self->pointerPos - ipos[i];
+            num++;
         }
         else
             self->data[i] = 0.0;
 
         self->pointerPos += inc;
     }
+    /* the samples read are the first ones, `go` is only cleared in the loop */
+    (*interp)(tablelist, ipos, fpos, self->data, num, size);
 }
 
 static void
 TableRead_readframes_a(TableRead *self) {
-    MYFLT inc, fpart, sizeOnSr;
-    int i, ipart;
-    MYFLT *tablelist = TableStream_getData(self->table);
+    MYFLT inc, sizeOnSr;
+    int i, num = 0;
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
 
@@ -5460,9 +6029,9 @@ TableRead_readframes_a(TableRead *self) {
                 self->go = 0;
         }
         if (self->go == 1) {
-            ipart = (int)self->pointerPos;
-            fpart = self->pointerPos - ipart;
-            self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)self->pointerPos;
+            fpos[i] = self->pointerPos - ipos[i];
+            num++;
         }
         else
             self->data[i] = 0.0;
@@ -5470,6 +6039,8 @@ TableRead_readframes_a(TableRead *self) {
         inc = fr[i] * sizeOnSr;
         self->pointerPos += inc;
     }
+    /* the samples read are the first ones, `go` is only cleared in the loop */
+    (*interp)(tablelist, ipos, fpos, self->data, num, size);
 }
 
 static void TableRead_postprocessing_ii(TableRead *self) { POST_PROCESSING_II };
@@ -5586,6 +6157,7 @@ TableRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, TableRead_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = TableRead_setProcMode;
 
     static char *kwlist[] = {"table", "freq", "loop", "interp", "mul", "add", NULL};
@@ -5624,11 +6196,12 @@ TableRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     self->init = 1;
 
@@ -5760,7 +6333,7 @@ TableRead_setInterp(TableRead *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -7089,8 +7662,9 @@ typedef struct {
 
 static void
 Blit_readframes_ii(Blit *self) {
-    MYFLT p, m, rate, val;
+    MYFLT p, m, rate;
     int i, nHarms;
+    MYFLT phase[self->bufsize];
 
     MYFLT freq = PyFloat_AS_DOUBLE(self->freq);
     MYFLT hrms = PyFloat_AS_DOUBLE(self->harms);
@@ -7101,24 +7675,19 @@ Blit_readframes_ii(Blit *self) {
     rate = PI / p;
 
     for (i=0; i<self->bufsize; i++) {
-        if (self->phase <= 0.0)
-            val = 1.0;
-        else {
-            val = MYSIN(m * self->phase);
-            val /= m * MYSIN(self->phase);
-        }
+        phase[i] = self->phase;
         self->phase += rate;
         if (self->phase >= PI)
             self->phase -= PI;
-
-        self->data[i] = val;
     }
+    SineKernel_blit(phase, NULL, m, self->data, self->bufsize);
 }
 
 static void
 Blit_readframes_ai(Blit *self) {
-    MYFLT p, m, rate, val;
+    MYFLT p, m, rate;
     int i, nHarms;
+    MYFLT phase[self->bufsize];
 
     MYFLT *freq = Stream_getData((Stream *)self->freq_stream);
     MYFLT hrms = PyFloat_AS_DOUBLE(self->harms);
@@ -7129,24 +7698,19 @@ Blit_readframes_ai(Blit *self) {
     for (i=0; i<self->bufsize; i++) {
         p = self->sr / freq[i];
         rate = PI / p;
-        if (self->phase <= 0.0)
-            val = 1.0;
-        else {
-            val = MYSIN(m * self->phase);
-            val /= m * MYSIN(self->phase);
-        }
+        phase[i] = self->phase;
         self->phase += rate;
         if (self->phase >= PI)
             self->phase -= PI;
-
-        self->data[i] = val;
     }
+    SineKernel_blit(phase, NULL, m, self->data, self->bufsize);
 }
 
 static void
 Blit_readframes_ia(Blit *self) {
-    MYFLT p, m, rate, val;
+    MYFLT p, rate;
     int i, nHarms;
+    MYFLT phase[self->bufsize], m[self->bufsize];
 
     MYFLT freq = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *hrms = Stream_getData((Stream *)self->harms_stream);
@@ -7156,46 +7720,35 @@ Blit_readframes_ia(Blit *self) {
 
     for (i=0; i<self->bufsize; i++) {
         nHarms = (int)hrms[i];
-        m = 2.0 * nHarms + 1.0;
-        if (self->phase <= 0.0)
-            val = 1.0;
-        else {
-            val = MYSIN(m * self->phase);
-            val /= m * MYSIN(self->phase);
-        }
+        m[i] = 2.0 * nHarms + 1.0;
+        phase[i] = self->phase;
         self->phase += rate;
         if (self->phase >= PI)
             self->phase -= PI;
-
-        self->data[i] = val;
     }
+    SineKernel_blit(phase, m, 0.0, self->data, self->bufsize);
 }
 
 static void
 Blit_readframes_aa(Blit *self) {
-    MYFLT p, m, rate, val;
+    MYFLT p, rate;
     int i, nHarms;
+    MYFLT phase[self->bufsize], m[self->bufsize];
 
     MYFLT *freq = Stream_getData((Stream *)self->freq_stream);
     MYFLT *hrms = Stream_getData((Stream *)self->harms_stream);
 
     for (i=0; i<self->bufsize; i++) {
         nHarms = (int)hrms[i];
-        m = 2.0 * nHarms + 1.0;
+        m[i] = 2.0 * nHarms + 1.0;
         p = self->sr / freq[i];
         rate = PI / p;
-        if (self->phase <= 0.0)
-            val = 1.0;
-        else {
-            val = MYSIN(m * self->phase);
-            val /= m * MYSIN(self->phase);
-        }
+        phase[i] = self->phase;
         self->phase += rate;
         if (self->phase >= PI)
             self->phase -= PI;
-
-        self->data[i] = val;
     }
+    SineKernel_blit(phase, m, 0.0, self->data, self->bufsize);
 }
 
 static void Blit_postprocessing_ii(Blit *self) { POST_PROCESSING_II };
@@ -9903,6 +10456,23 @@ typedef struct {
     MYFLT nyquist;
 } SuperSaw;
 
+/* The coefficients are divided by a0 here, the filter loops only multiply. */
+static void
+SuperSaw_computeCoeffs(SuperSaw *self, MYFLT fr) {
+    MYFLT inva0;
+
+    self->lastFilterFreq = fr;
+    self->w0 = TWOPI * fr / self->sr;
+    self->c = MYCOS(self->w0);
+    self->alpha = MYSIN(self->w0) * 0.5;
+    self->a0 = 1 + self->alpha;
+    inva0 = 1.0 / self->a0;
+    self->b0 = self->b2 = (1 + self->c) * 0.5 * inva0;
+    self->b1 = -(1 + self->c) * inva0;
+    self->a1 = -2 * self->c * inva0;
+    self->a2 = (1 - self->alpha) * inva0;
+}
+
 static void
 SuperSaw_readframes_iii(SuperSaw *self) {
     MYFLT fr, det, bal, twoOnSr, val;
@@ -9923,17 +10493,8 @@ SuperSaw_readframes_iii(SuperSaw *self) {
     det_ind = (int)(det * 126);
     bal_ind = (int)(bal * 126);
 
-    if (fr != self->lastFilterFreq) {
-        self->lastFilterFreq = fr;
-        self->w0 = TWOPI * fr / self->sr;
-        self->c = MYCOS(self->w0);
-        self->alpha = MYSIN(self->w0) * 0.5;
-        self->b0 = self->b2 = (1 + self->c) * 0.5;
-        self->b1 = -(1 + self->c);
-        self->a0 = 1 + self->alpha;
-        self->a1 = -2 * self->c;
-        self->a2 = 1 - self->alpha;
-    }
+    if (fr != self->lastFilterFreq)
+        SuperSaw_computeCoeffs(self, fr);
 
     for (j=0; j<7; j++) {
         inc[j] = fr * SUPERSAW_DETUNES[j][det_ind] * twoOnSr;
@@ -9950,7 +10511,7 @@ SuperSaw_readframes_iii(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -9978,17 +10539,8 @@ SuperSaw_readframes_aii(SuperSaw *self) {
             fr = 1.0;
         else if (fr >= self->nyquist)
             fr = self->nyquist;
-        if (fr != self->lastFilterFreq) {
-            self->lastFilterFreq = fr;
-            self->w0 = TWOPI * fr / self->sr;
-            self->c = MYCOS(self->w0);
-            self->alpha = MYSIN(self->w0) * 0.5;
-            self->b0 = self->b2 = (1 + self->c) * 0.5;
-            self->b1 = -(1 + self->c);
-            self->a0 = 1 + self->alpha;
-            self->a1 = -2 * self->c;
-            self->a2 = 1 - self->alpha;
-        }
+        if (fr != self->lastFilterFreq)
+            SuperSaw_computeCoeffs(self, fr);
         val = 0.0;
         for (j=0; j<7; j++) {
             val += self->pointerPos[j] * SUPERSAW_BALANCES[j][bal_ind];
@@ -9998,7 +10550,7 @@ SuperSaw_readframes_aii(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10024,17 +10576,8 @@ SuperSaw_readframes_iai(SuperSaw *self) {
 
     bal_ind = (int)(bal * 126);
 
-    if (fr != self->lastFilterFreq) {
-        self->lastFilterFreq = fr;
-        self->w0 = TWOPI * fr / self->sr;
-        self->c = MYCOS(self->w0);
-        self->alpha = MYSIN(self->w0) * 0.5;
-        self->b0 = self->b2 = (1 + self->c) * 0.5;
-        self->b1 = -(1 + self->c);
-        self->a0 = 1 + self->alpha;
-        self->a1 = -2 * self->c;
-        self->a2 = 1 - self->alpha;
-    }
+    if (fr != self->lastFilterFreq)
+        SuperSaw_computeCoeffs(self, fr);
 
     for (i=0; i<self->bufsize; i++) {
         det_ind = (int)(_clip(detune[i]) * 126);
@@ -10047,7 +10590,7 @@ SuperSaw_readframes_iai(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10074,17 +10617,8 @@ SuperSaw_readframes_aai(SuperSaw *self) {
             fr = 1.0;
         else if (fr >= self->nyquist)
             fr = self->nyquist;
-        if (fr != self->lastFilterFreq) {
-            self->lastFilterFreq = fr;
-            self->w0 = TWOPI * fr / self->sr;
-            self->c = MYCOS(self->w0);
-            self->alpha = MYSIN(self->w0) * 0.5;
-            self->b0 = self->b2 = (1 + self->c) * 0.5;
-            self->b1 = -(1 + self->c);
-            self->a0 = 1 + self->alpha;
-            self->a1 = -2 * self->c;
-            self->a2 = 1 - self->alpha;
-        }
+        if (fr != self->lastFilterFreq)
+            SuperSaw_computeCoeffs(self, fr);
         det_ind = (int)(_clip(detune[i]) * 126);
         val = 0.0;
         for (j=0; j<7; j++) {
@@ -10095,7 +10629,7 @@ SuperSaw_readframes_aai(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10122,17 +10656,8 @@ SuperSaw_readframes_iia(SuperSaw *self) {
 
     det_ind = (int)(det * 126);
 
-    if (fr != self->lastFilterFreq) {
-        self->lastFilterFreq = fr;
-        self->w0 = TWOPI * fr / self->sr;
-        self->c = MYCOS(self->w0);
-        self->alpha = MYSIN(self->w0) * 0.5;
-        self->b0 = self->b2 = (1 + self->c) * 0.5;
-        self->b1 = -(1 + self->c);
-        self->a0 = 1 + self->alpha;
-        self->a1 = -2 * self->c;
-        self->a2 = 1 - self->alpha;
-    }
+    if (fr != self->lastFilterFreq)
+        SuperSaw_computeCoeffs(self, fr);
 
     for (j=0; j<7; j++) {
         inc[j] = fr * SUPERSAW_DETUNES[j][det_ind] * twoOnSr;
@@ -10149,7 +10674,7 @@ SuperSaw_readframes_iia(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10176,17 +10701,8 @@ SuperSaw_readframes_aia(SuperSaw *self) {
             fr = 1.0;
         else if (fr >= self->nyquist)
             fr = self->nyquist;
-        if (fr != self->lastFilterFreq) {
-            self->lastFilterFreq = fr;
-            self->w0 = TWOPI * fr / self->sr;
-            self->c = MYCOS(self->w0);
-            self->alpha = MYSIN(self->w0) * 0.5;
-            self->b0 = self->b2 = (1 + self->c) * 0.5;
-            self->b1 = -(1 + self->c);
-            self->a0 = 1 + self->alpha;
-            self->a1 = -2 * self->c;
-            self->a2 = 1 - self->alpha;
-        }
+        if (fr != self->lastFilterFreq)
+            SuperSaw_computeCoeffs(self, fr);
         bal_ind = (int)(_clip(balance[i]) * 126);
         val = 0.0;
         for (j=0; j<7; j++) {
@@ -10197,7 +10713,7 @@ SuperSaw_readframes_aia(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10221,17 +10737,8 @@ SuperSaw_readframes_iaa(SuperSaw *self) {
     else if (fr >= self->nyquist)
         fr = self->nyquist;
 
-    if (fr != self->lastFilterFreq) {
-        self->lastFilterFreq = fr;
-        self->w0 = TWOPI * fr / self->sr;
-        self->c = MYCOS(self->w0);
-        self->alpha = MYSIN(self->w0) * 0.5;
-        self->b0 = self->b2 = (1 + self->c) * 0.5;
-        self->b1 = -(1 + self->c);
-        self->a0 = 1 + self->alpha;
-        self->a1 = -2 * self->c;
-        self->a2 = 1 - self->alpha;
-    }
+    if (fr != self->lastFilterFreq)
+        SuperSaw_computeCoeffs(self, fr);
 
     for (i=0; i<self->bufsize; i++) {
         det_ind = (int)(_clip(detune[i]) * 126);
@@ -10245,7 +10752,7 @@ SuperSaw_readframes_iaa(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10270,17 +10777,8 @@ SuperSaw_readframes_aaa(SuperSaw *self) {
             fr = 1.0;
         else if (fr >= self->nyquist)
             fr = self->nyquist;
-        if (fr != self->lastFilterFreq) {
-            self->lastFilterFreq = fr;
-            self->w0 = TWOPI * fr / self->sr;
-            self->c = MYCOS(self->w0);
-            self->alpha = MYSIN(self->w0) * 0.5;
-            self->b0 = self->b2 = (1 + self->c) * 0.5;
-            self->b1 = -(1 + self->c);
-            self->a0 = 1 + self->alpha;
-            self->a1 = -2 * self->c;
-            self->a2 = 1 - self->alpha;
-        }
+        if (fr != self->lastFilterFreq)
+            SuperSaw_computeCoeffs(self, fr);
         det_ind = (int)(_clip(detune[i]) * 126);
         bal_ind = (int)(_clip(balance[i]) * 126);
 
@@ -10293,7 +10791,7 @@ SuperSaw_readframes_aaa(SuperSaw *self) {
             else if (self->pointerPos[j] >= 1.0)
                 self->pointerPos[j] -= 2.0;
         }
-        self->data[i] = ( (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2) ) / self->a0;
+        self->data[i] = (self->b0 * val) + (self->b1 * self->x1) + (self->b2 * self->x2) - (self->a1 * self->y1) - (self->a2 * self->y2);
         self->y2 = self->y1;
         self->y1 = self->data[i];
         self->x2 = self->x1;
@@ -10728,10 +11226,29 @@ typedef struct {
     MYFLT pointerPos;
 } RCOsc;
 
+/* The pow calls of the four modes are batched over the buffer: `pos` holds
+ * the pointer positions, `sh` the sharpness (NULL to use `csh`). */
+static void
+RCOsc_render(RCOsc *self, MYFLT *pos, MYFLT *sh, MYFLT csh) {
+    int i;
+
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = pos[i] < 1 ? 1.0 - pos[i] : 2.0 - pos[i];
+    }
+    PowKernel_process(self->data, sh, csh, self->data, self->bufsize);
+    for (i=0; i<self->bufsize; i++) {
+        if (pos[i] < 1)
+            self->data[i] = ( (1.0 - self->data[i]) + 1.0 ) * 2.0 - 3.0;
+        else
+            self->data[i] = ( 1.0 + self->data[i] ) * 2.0 - 3.0;
+    }
+}
+
 static void
 RCOsc_readframes_ii(RCOsc *self) {
-    MYFLT fr, sh, inc, down_phase, up_phase;
+    MYFLT fr, sh, inc;
     int i;
+    MYFLT pos[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     sh = _clip(PyFloat_AS_DOUBLE(self->sharp));
@@ -10739,27 +11256,21 @@ RCOsc_readframes_ii(RCOsc *self) {
     inc = fr * 2 / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
-        if (self->pointerPos < 1) {
-            down_phase = 1.0 - self->pointerPos;
-            up_phase = 1.0;
-        }
-        else {
-            down_phase = 0.0;
-            up_phase = 2.0 - self->pointerPos;
-        }
-        self->data[i] = ( (1.0 - MYPOW(down_phase, sh)) + (MYPOW(up_phase, sh)) ) * 2.0 - 3.0;
+        pos[i] = self->pointerPos;
         self->pointerPos += inc;
         if (self->pointerPos < 0)
             self->pointerPos += 2.0;
         else if (self->pointerPos >= 2)
             self->pointerPos -= 2.0;
     }
+    RCOsc_render(self, pos, NULL, sh);
 }
 
 static void
 RCOsc_readframes_ai(RCOsc *self) {
-    MYFLT sh, down_phase, up_phase, twoOverSr;
+    MYFLT sh, twoOverSr;
     int i;
+    MYFLT pos[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     sh = _clip(PyFloat_AS_DOUBLE(self->sharp));
@@ -10767,27 +11278,21 @@ RCOsc_readframes_ai(RCOsc *self) {
 
     twoOverSr = 2.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
-        if (self->pointerPos < 1) {
-            down_phase = 1.0 - self->pointerPos;
-            up_phase = 1.0;
-        }
-        else {
-            down_phase = 0.0;
-            up_phase = 2.0 - self->pointerPos;
-        }
-        self->data[i] = ( (1.0 - MYPOW(down_phase, sh)) + (MYPOW(up_phase, sh)) ) * 2.0 - 3.0;
+        pos[i] = self->pointerPos;
         self->pointerPos += fr[i] * twoOverSr;
         if (self->pointerPos < 0)
             self->pointerPos += 2.0;
         else if (self->pointerPos >= 2)
             self->pointerPos -= 2.0;
     }
+    RCOsc_render(self, pos, NULL, sh);
 }
 
 static void
 RCOsc_readframes_ia(RCOsc *self) {
-    MYFLT fr, sh, inc, down_phase, up_phase;
+    MYFLT fr, sh, inc;
     int i;
+    MYFLT pos[self->bufsize], shs[self->bufsize];
 
     fr = PyFloat_AS_DOUBLE(self->freq);
     MYFLT *sharp = Stream_getData((Stream *)self->sharp_stream);
@@ -10795,28 +11300,22 @@ RCOsc_readframes_ia(RCOsc *self) {
 
     for (i=0; i<self->bufsize; i++) {
         sh = _clip(sharp[i]);
-        sh = sh * sh * 99.0 + 1.0;
-        if (self->pointerPos < 1) {
-            down_phase = 1.0 - self->pointerPos;
-            up_phase = 1.0;
-        }
-        else {
-            down_phase = 0.0;
-            up_phase = 2.0 - self->pointerPos;
-        }
-        self->data[i] = ( (1.0 - MYPOW(down_phase, sh)) + (MYPOW(up_phase, sh)) ) * 2.0 - 3.0;
+        shs[i] = sh * sh * 99.0 + 1.0;
+        pos[i] = self->pointerPos;
         self->pointerPos += inc;
         if (self->pointerPos < 0)
             self->pointerPos += 2.0;
         else if (self->pointerPos >= 2)
             self->pointerPos -= 2.0;
     }
+    RCOsc_render(self, pos, shs, 0.0);
 }
 
 static void
 RCOsc_readframes_aa(RCOsc *self) {
-    MYFLT sh, down_phase, up_phase, twoOverSr;
+    MYFLT sh, twoOverSr;
     int i;
+    MYFLT pos[self->bufsize], shs[self->bufsize];
 
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
     MYFLT *sharp = Stream_getData((Stream *)self->sharp_stream);
@@ -10824,22 +11323,15 @@ RCOsc_readframes_aa(RCOsc *self) {
     twoOverSr = 2.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
         sh = _clip(sharp[i]);
-        sh = sh * sh * 99.0 + 1.0;
-        if (self->pointerPos < 1) {
-            down_phase = 1.0 - self->pointerPos;
-            up_phase = 1.0;
-        }
-        else {
-            down_phase = 0.0;
-            up_phase = 2.0 - self->pointerPos;
-        }
-        self->data[i] = ( (1.0 - MYPOW(down_phase, sh)) + (MYPOW(up_phase, sh)) ) * 2.0 - 3.0;
+        shs[i] = sh * sh * 99.0 + 1.0;
+        pos[i] = self->pointerPos;
         self->pointerPos += fr[i] * twoOverSr;
         if (self->pointerPos < 0)
             self->pointerPos += 2.0;
         else if (self->pointerPos >= 2)
             self->pointerPos -= 2.0;
     }
+    RCOsc_render(self, pos, shs, 0.0);
 }
 
 static void RCOsc_postprocessing_ii(RCOsc *self) { POST_PROCESSING_II };
@@ -11343,6 +11835,8 @@ TableScale_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, TableScale_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
     self->mode_func_ptr = TableScale_setProcMode;
 
     static char *kwlist[] = {"table", "outtable", "mul", "add", NULL};
@@ -11361,6 +11855,9 @@ TableScale_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         PyErr_SetString(PyExc_TypeError, "\"outtable\" argument of TableScale must be a PyoTableObject.\n");
         Py_RETURN_NONE;
     }
+    /* TableScale writes in the table, which can't share its samples. */
+    if (PyObject_HasAttrString((PyObject *)outtabletmp, "_unshare"))
+        Py_XDECREF(PyObject_CallMethod((PyObject *)outtabletmp, "_unshare", NULL));
     Py_XDECREF(self->outtable);
     self->outtable = PyObject_CallMethod((PyObject *)outtabletmp, "getTableStream", "");
 
@@ -11442,6 +11939,9 @@ TableScale_setOuttable(TableScale *self, PyObject *arg)
 	}
 
 	tmp = arg;
+    if (PyObject_HasAttrString((PyObject *)tmp, "_unshare")) {
+        Py_XDECREF(PyObject_CallMethod((PyObject *)tmp, "_unshare", NULL));
+    }
 	Py_DECREF(self->outtable);
     self->outtable = PyObject_CallMethod((PyObject *)tmp, "getTableStream", "");
 
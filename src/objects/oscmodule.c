@@ -25,30 +25,22 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "oscqueue.h"
 #include "lo/lo.h"
 
-void error(int num, const char *msg, const char *path)
-{
-    printf("liblo server error %d in path %s: %s\n", num, path, msg);
-}
+/* Messages a receiver's network thread can hold for the audio thread. */
+#define OSC_RECEIVER_QUEUE 512
 
 /* main OSC receiver */
 typedef struct {
     pyo_audio_HEAD
-    lo_server osc_server;
+    OscQueue *queue;
     int port;
+    int count; /* messages of the current block, still in the queue */
     PyObject *dict;
     PyObject *address_path;
 } OscReceiver;
 
-int OscReceiver_handler(const char *path, const char *types, lo_arg **argv, int argc,
-                        void *data, void *user_data)
-{
-    OscReceiver *self = user_data;
-    PyDict_SetItem(self->dict, PyString_FromString(path), PyFloat_FromDouble(argv[0]->FLOAT_VALUE));
-    return 0;
-}
-
 MYFLT OscReceiver_getValue(OscReceiver *self, PyObject *path)
 {
     PyObject *tmp;
@@ -56,10 +48,45 @@ MYFLT OscReceiver_getValue(OscReceiver *self, PyObject *path)
     return PyFloat_AsDouble(tmp);
 }
 
+/* Messages of the current block, in time order, with their frame offsets. */
+int OscReceiver_getCount(OscReceiver *self)
+{
+    return self->count;
+}
+
+OscQueueEvent * OscReceiver_getEvent(OscReceiver *self, int i, int *frame)
+{
+    OscQueueEvent *ev = OscQueue_get(self->queue, i);
+    *frame = Server_getClockFrame((Server *)self->server, ev->time);
+    return ev;
+}
+
 static void
 OscReceiver_compute_next_data_frame(OscReceiver *self)
 {
-    while (lo_server_recv_noblock(self->osc_server, 0) != 0) {};
+    int i, n;
+    OscQueueEvent *ev;
+    PyObject *key, *value;
+
+    if (self->queue == NULL)
+        return;
+
+    /* The messages of the last block were read by the OscReceive objects. */
+    OscQueue_release(self->queue, self->count);
+    n = OscQueue_count(self->queue);
+    for (i=0; i<n; i++) {
+        ev = OscQueue_get(self->queue, i);
+        if (Server_getClockFrame((Server *)self->server, ev->time) >= self->bufsize)
+            break;
+        if (ev->argc == 1 && OscQueue_isNumber(ev, 0)) {
+            key = PyString_FromString(ev->path);
+            value = PyFloat_FromDouble(OscQueue_number(ev, 0));
+            PyDict_SetItem(self->dict, key, value);
+            Py_DECREF(key);
+            Py_DECREF(value);
+        }
+    }
+    self->count = i;
 }
 
 static int
@@ -83,7 +110,7 @@ OscReceiver_clear(OscReceiver *self)
 static void
 OscReceiver_dealloc(OscReceiver* self)
 {
-    lo_server_free(self->osc_server);
+    OscQueue_free(self->queue);
     pyo_DEALLOC
     OscReceiver_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -99,6 +126,7 @@ OscReceiver_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, OscReceiver_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"port", "address", NULL};
 
@@ -129,11 +157,7 @@ OscReceiver_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         }
     }
 
-    char buf[20];
-    sprintf(buf, "%i", self->port);
-    self->osc_server = lo_server_new(buf, error);
-
-    lo_server_add_method(self->osc_server, NULL, TYPE_F, OscReceiver_handler, self);
+    self->queue = OscQueue_new(self->port, OSC_RECEIVER_QUEUE);
 
     return (PyObject *)self;
 }
@@ -252,11 +276,30 @@ typedef struct {
     PyObject *input;
     PyObject *address_path;
     MYFLT value;
+    MYFLT target;
     MYFLT factor;
     int interpolation;
     int modebuffer[2];
 } OscReceive;
 
+/* Writes data[start:end], going to the target value. */
+static void
+OscReceive_fill(OscReceive *self, int start, int end)
+{
+    int i;
+
+    if (self->interpolation == 1) {
+        for (i=start; i<end; i++) {
+            self->data[i] = self->value = self->value + (self->target - self->value) * self->factor;
+        }
+    }
+    else {
+        for (i=start; i<end; i++) {
+            self->data[i] = self->value = self->target;
+        }
+    }
+}
+
 static void OscReceive_postprocessing_ii(OscReceive *self) { POST_PROCESSING_II };
 static void OscReceive_postprocessing_ai(OscReceive *self) { POST_PROCESSING_AI };
 static void OscReceive_postprocessing_ia(OscReceive *self) { POST_PROCESSING_IA };
@@ -307,20 +350,28 @@ OscReceive_setProcMode(OscReceive *self)
 static void
 OscReceive_compute_next_data_frame(OscReceive *self)
 {
-    int i;
-    MYFLT val = OscReceiver_getValue((OscReceiver *)self->input, self->address_path);
-
-    if (self->interpolation == 1) {
-
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->value = self->value + (val - self->value) * self->factor;
-        }
-    }
-    else {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->value = val;
-        }
+    int i, frame, count, pos = 0, found = 0;
+    OscQueueEvent *ev;
+    OscReceiver *receiver = (OscReceiver *)self->input;
+    char *path = PyString_AsString(self->address_path);
+
+    /* The messages take effect at their frames, values set from python at
+     * the start of the block. */
+    count = OscReceiver_getCount(receiver);
+    for (i=0; i<count; i++) {
+        ev = OscReceiver_getEvent(receiver, i, &frame);
+        if (ev->argc != 1 || !OscQueue_isNumber(ev, 0) || strcmp(ev->path, path) != 0)
+            continue;
+        if (frame > self->bufsize)
+            frame = self->bufsize;
+        OscReceive_fill(self, pos, frame);
+        pos = frame;
+        self->target = OscQueue_number(ev, 0);
+        found = 1;
     }
+    if (!found)
+        self->target = OscReceiver_getValue(receiver, self->address_path);
+    OscReceive_fill(self, pos, self->bufsize);
 
     (*self->muladd_func_ptr)(self);
 }
@@ -359,7 +410,7 @@ OscReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     OscReceive *self;
     self = (OscReceive *)type->tp_alloc(type, 0);
 
-    self->value = 0.;
+    self->value = self->target = 0.;
     self->interpolation = 1;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
@@ -369,6 +420,7 @@ OscReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->factor = 1. / (0.01 * self->sr);
 
     Stream_setFunctionPtr(self->stream, OscReceive_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = OscReceive_setProcMode;
 
     static char *kwlist[] = {"input", "address", "mul", "add", NULL};
@@ -548,26 +600,40 @@ typedef struct {
     PyObject *input;
     Stream *input_stream;
     PyObject *address_path;
-    lo_address address;
+    OscSender *sender;
+    int destination;
     char *host;
     int port;
     int count;
     int bufrate;
+    int changeonly; /* sends a value only when it differs from the last one sent */
+    int sent;
+    float last;
 } OscSend;
 
+/* The value goes to the server's OSC sender, which sends the values of the
+ * buffer in bundles from its thread. */
 static void
 OscSend_compute_next_data_frame(OscSend *self)
 {
+    OscQueueEvent *ev;
+
     self->count++;
     if (self->count >= self->bufrate) {
         self->count = 0;
         MYFLT *in = Stream_getData((Stream *)self->input_stream);
         float value = (float)in[0];
 
-        char *path  = PyString_AsString(self->address_path);
+        if (self->destination < 0 || (self->changeonly && self->sent && value == self->last))
+            return;
 
-        if (lo_send(self->address, path, "f", value) == -1) {
-            printf("OSC error %d: %s\n", lo_address_errno(self->address), lo_address_errstr(self->address));
+        ev = OscSender_reserve(self->sender, self->destination);
+        if (ev != NULL) {
+            OscQueue_setPath(ev, PyString_AsString(self->address_path));
+            OscQueue_addDouble(ev, LO_FLOAT, value);
+            OscSender_commit(self->sender);
+            self->last = value;
+            self->sent = 1;
         }
     }
 }
@@ -611,9 +677,14 @@ OscSend_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->host = NULL;
     self->count = 0;
     self->bufrate = 1;
+    self->changeonly = 0;
+    self->sent = 0;
+    self->destination = -1;
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, OscSend_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"input", "port", "address", "host", NULL};
 
@@ -633,13 +704,30 @@ OscSend_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->address_path);
     self->address_path = pathtmp;
 
-    char buf[20];
-    sprintf(buf, "%i", self->port);
-    self->address = lo_address_new(self->host, buf);
+    self->sender = Server_getOscSender((Server *)self->server);
+    if (self->sender != NULL) {
+        self->destination = OscSender_getDestination(self->sender, self->host, self->port);
+        if (self->destination < 0)
+            printf("OSC warning: too many destinations, values sent to port %d are ignored.\n", self->port);
+    }
 
     return (PyObject *)self;
 }
 
+static PyObject *
+OscSend_setChangeOnly(OscSend *self, PyObject *arg)
+{
+	if (arg == NULL) {
+		Py_INCREF(Py_None);
+		return Py_None;
+	}
+
+    self->changeonly = PyObject_IsTrue(arg);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject *
 OscSend_setBufferRate(OscSend *self, PyObject *arg)
 {
@@ -675,6 +763,7 @@ static PyMethodDef OscSend_methods[] = {
 {"play", (PyCFunction)OscSend_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
 {"stop", (PyCFunction)OscSend_stop, METH_NOARGS, "Stops computing."},
 {"setBufferRate", (PyCFunction)OscSend_setBufferRate, METH_O, "Set how many buffers to wait before sending a new value."},
+{"setChangeOnly", (PyCFunction)OscSend_setChangeOnly, METH_O, "Send a value only when it differs from the last one sent."},
 {NULL}  /* Sentinel */
 };
 
@@ -726,6 +815,8 @@ typedef struct {
     PyObject *value;
     PyObject *address_path;
     lo_address address;
+    OscSender *sender;
+    int destination;
     char *host;
     char *types;
     int port;
@@ -733,6 +824,49 @@ typedef struct {
     int num_items;
 } OscDataSend;
 
+/* Builds the message in the server's OSC sender, returns -1 if it doesn't
+ * fit in a queued message. */
+static int
+OscDataSend_queue(OscDataSend *self, char *path)
+{
+    int i, ok = 0;
+    OscQueueEvent *ev;
+
+    if (self->destination < 0)
+        return -1;
+    ev = OscSender_reserve(self->sender, self->destination);
+    if (ev == NULL)
+        return 0;
+    OscQueue_setPath(ev, path);
+    if (strlen(path) >= OSC_QUEUE_PATH)
+        ok = -1;
+
+    for (i=0; i<self->num_items && ok == 0; i++) {
+        switch (self->types[i]) {
+            case LO_INT32:
+                ok = OscQueue_addInt(ev, LO_INT32, PyInt_AsLong(PyList_GetItem(self->value, i)));
+                break;
+            case LO_INT64:
+                ok = OscQueue_addInt(ev, LO_INT64, (long)PyLong_AsLong(PyList_GetItem(self->value, i)));
+                break;
+            case LO_FLOAT:
+                ok = OscQueue_addDouble(ev, LO_FLOAT, PyFloat_AsDouble(PyList_GetItem(self->value, i)));
+                break;
+            case LO_DOUBLE:
+                ok = OscQueue_addDouble(ev, LO_DOUBLE, PyFloat_AsDouble(PyList_GetItem(self->value, i)));
+                break;
+            case LO_STRING:
+                ok = OscQueue_addString(ev, LO_STRING, PyString_AsString(PyList_GetItem(self->value, i)));
+                break;
+            default:
+                break;
+        }
+    }
+    if (ok == 0)
+        OscSender_commit(self->sender);
+    return ok;
+}
+
 static void
 OscDataSend_compute_next_data_frame(OscDataSend *self)
 {
@@ -740,7 +874,11 @@ OscDataSend_compute_next_data_frame(OscDataSend *self)
     lo_message *msg;
     char *path  = PyString_AsString(self->address_path);
 
-    if (self->something_to_send == 1) {
+    if (self->something_to_send == 1 && OscDataSend_queue(self, path) == 0) {
+        self->something_to_send = 0;
+    }
+    /* Too large for the queue, sent from here. */
+    else if (self->something_to_send == 1) {
         msg = lo_message_new();
 
         for (i=0; i<self->num_items; i++) {
@@ -811,6 +949,8 @@ OscDataSend_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, OscDataSend_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"types", "port", "address", "host", NULL};
 
@@ -834,6 +974,11 @@ OscDataSend_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     sprintf(buf, "%i", self->port);
     self->address = lo_address_new(self->host, buf);
 
+    self->destination = -1;
+    self->sender = Server_getOscSender((Server *)self->server);
+    if (self->sender != NULL)
+        self->destination = OscSender_getDestination(self->sender, self->host, self->port);
+
     return (PyObject *)self;
 }
 
@@ -927,64 +1072,76 @@ PyTypeObject OscDataSendType = {
 /* main OscDataReceive */
 typedef struct {
     pyo_audio_HEAD
-    lo_server osc_server;
+    OscQueue *queue;
     PyObject *address_path;
     PyObject *callable;
     int port;
 } OscDataReceive;
 
-int OscDataReceive_handler(const char *path, const char *types, lo_arg **argv, int argc,
-                        void *data, void *user_data)
+static void
+OscDataReceive_call(OscDataReceive *self, OscQueueEvent *ev)
 {
-    OscDataReceive *self = user_data;
     PyObject *tup, *result=NULL;
-    tup = PyTuple_New(argc+1);
     int i, ok = 0;
 
     Py_ssize_t lsize = PyList_Size(self->address_path);
     for (i=0; i<lsize; i++) {
-        if (lo_pattern_match(path, PyString_AsString(PyList_GetItem(self->address_path, i)))) {
+        if (lo_pattern_match(ev->path, PyString_AsString(PyList_GetItem(self->address_path, i)))) {
             ok = 1;
             break;
         }
     }
 
     if (ok) {
-        PyTuple_SetItem(tup, 0, PyString_FromString(path));
-        for (i=0; i<argc; i++) {
-            switch (types[i]) {
+        tup = PyTuple_New(ev->argc+1);
+        PyTuple_SetItem(tup, 0, PyString_FromString(ev->path));
+        for (i=0; i<ev->argc; i++) {
+            switch (ev->types[i]) {
                 case LO_INT32:
-                    PyTuple_SetItem(tup, i+1, PyInt_FromLong(argv[i]->i));
+                    PyTuple_SetItem(tup, i+1, PyInt_FromLong(ev->values[i].h));
                     break;
                 case LO_INT64:
-                    PyTuple_SetItem(tup, i+1, PyLong_FromLong(argv[i]->h));
+                    PyTuple_SetItem(tup, i+1, PyLong_FromLongLong(ev->values[i].h));
                     break;
                 case LO_FLOAT:
-                    PyTuple_SetItem(tup, i+1, PyFloat_FromDouble(argv[i]->f));
-                    break;
                 case LO_DOUBLE:
-                    PyTuple_SetItem(tup, i+1, PyFloat_FromDouble(argv[i]->d));
+                    PyTuple_SetItem(tup, i+1, PyFloat_FromDouble(ev->values[i].d));
                     break;
                 case LO_STRING:
-                    PyTuple_SetItem(tup, i+1, PyString_FromString(&argv[i]->s));
+                case LO_SYMBOL:
+                    PyTuple_SetItem(tup, i+1, PyString_FromString(ev->text + ev->values[i].s));
                     break;
                 default:
+                    Py_INCREF(Py_None);
+                    PyTuple_SetItem(tup, i+1, Py_None);
                     break;
             }
         }
         result = PyObject_Call(self->callable, tup, NULL);
         if (result == NULL)
             PyErr_Print();
+        Py_DECREF(tup);
+        Py_XDECREF(result);
     }
-    Py_XDECREF(tup);
-    Py_XDECREF(result);
-    return 0;
 }
 
 static void
 OscDataReceive_compute_next_data_frame(OscDataReceive *self)
 {
-    while (lo_server_recv_noblock(self->osc_server, 0) != 0) {};
+    int i, n;
+    OscQueueEvent *ev;
+
+    if (self->queue == NULL)
+        return;
+
+    n = OscQueue_count(self->queue);
+    for (i=0; i<n; i++) {
+        ev = OscQueue_get(self->queue, i);
+        if (Server_getClockFrame((Server *)self->server, ev->time) >= self->bufsize)
+            break;
+        OscDataReceive_call(self, ev);
+    }
+    OscQueue_release(self->queue, i);
 }
 
 static int
@@ -1008,7 +1165,7 @@ OscDataReceive_clear(OscDataReceive *self)
 static void
 OscDataReceive_dealloc(OscDataReceive* self)
 {
-    lo_server_free(self->osc_server);
+    OscQueue_free(self->queue);
     pyo_DEALLOC
     OscDataReceive_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -1024,6 +1181,7 @@ OscDataReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, OscDataReceive_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"port", "address", "callable", NULL};
 
@@ -1045,11 +1203,7 @@ OscDataReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         Py_RETURN_NONE;
     }
 
-    char buf[20];
-    sprintf(buf, "%i", self->port);
-    self->osc_server = lo_server_new(buf, error);
-
-    lo_server_add_method(self->osc_server, NULL, NULL, OscDataReceive_handler, self);
+    self->queue = OscQueue_new(self->port, OSC_RECEIVER_QUEUE);
 
     return (PyObject *)self;
 }
@@ -1150,29 +1304,14 @@ PyTypeObject OscDataReceiveType = {
 /* main OSC list receiver */
 typedef struct {
     pyo_audio_HEAD
-    lo_server osc_server;
+    OscQueue *queue;
     PyObject *dict;
     PyObject *address_path;
     int port;
     int num;
+    int count; /* messages of the current block, still in the queue */
 } OscListReceiver;
 
-int OscListReceiver_handler(const char *path, const char *types, lo_arg **argv, int argc,
-                        void *data, void *user_data)
-{
-    OscListReceiver *self = user_data;
-
-    int i;
-    PyObject *flist;
-    flist = PyList_New(self->num);
-
-    for (i=0; i<self->num; i++) {
-        PyList_SET_ITEM(flist, i, PyFloat_FromDouble(argv[i]->FLOAT_VALUE));
-    }
-    PyDict_SetItem(self->dict, PyString_FromString(path), flist);
-    return 0;
-}
-
 PyObject *
 OscListReceiver_getValue(OscListReceiver *self, PyObject *path)
 {
@@ -1181,10 +1320,46 @@ OscListReceiver_getValue(OscListReceiver *self, PyObject *path)
     return tmp;
 }
 
+/* Messages of the current block, in time order, with their frame offsets. */
+int OscListReceiver_getCount(OscListReceiver *self)
+{
+    return self->count;
+}
+
+OscQueueEvent * OscListReceiver_getEvent(OscListReceiver *self, int i, int *frame)
+{
+    OscQueueEvent *ev = OscQueue_get(self->queue, i);
+    *frame = Server_getClockFrame((Server *)self->server, ev->time);
+    return ev;
+}
+
 static void
 OscListReceiver_compute_next_data_frame(OscListReceiver *self)
 {
-    while (lo_server_recv_noblock(self->osc_server, 0) != 0) {};
+    int i, j, n;
+    OscQueueEvent *ev;
+    PyObject *key, *flist;
+
+    if (self->queue == NULL)
+        return;
+
+    /* The messages of the last block were read by the OscListReceive objects. */
+    OscQueue_release(self->queue, self->count);
+    n = OscQueue_count(self->queue);
+    for (i=0; i<n; i++) {
+        ev = OscQueue_get(self->queue, i);
+        if (Server_getClockFrame((Server *)self->server, ev->time) >= self->bufsize)
+            break;
+        flist = PyList_New(self->num);
+        for (j=0; j<self->num; j++) {
+            PyList_SET_ITEM(flist, j, PyFloat_FromDouble(OscQueue_number(ev, j)));
+        }
+        key = PyString_FromString(ev->path);
+        PyDict_SetItem(self->dict, key, flist);
+        Py_DECREF(key);
+        Py_DECREF(flist);
+    }
+    self->count = i;
 }
 
 static int
@@ -1208,7 +1383,7 @@ OscListReceiver_clear(OscListReceiver *self)
 static void
 OscListReceiver_dealloc(OscListReceiver* self)
 {
-    lo_server_free(self->osc_server);
+    OscQueue_free(self->queue);
     pyo_DEALLOC
     OscListReceiver_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -1226,6 +1401,7 @@ OscListReceiver_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, OscListReceiver_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"port", "address", "num", NULL};
 
@@ -1264,11 +1440,7 @@ OscListReceiver_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         }
     }
 
-    char buf[20];
-    sprintf(buf, "%i", self->port);
-    self->osc_server = lo_server_new(buf, error);
-
-    lo_server_add_method(self->osc_server, NULL, NULL, OscListReceiver_handler, self);
+    self->queue = OscQueue_new(self->port, OSC_RECEIVER_QUEUE);
 
     return (PyObject *)self;
 }
@@ -1397,12 +1569,31 @@ typedef struct {
     PyObject *input;
     PyObject *address_path;
     MYFLT value;
+    MYFLT target;
     MYFLT factor;
     int order;
     int interpolation;
     int modebuffer[2];
 } OscListReceive;
 
+/* Writes data[start:end], going to the target value. */
+static void
+OscListReceive_fill(OscListReceive *self, int start, int end)
+{
+    int i;
+
+    if (self->interpolation == 1) {
+        for (i=start; i<end; i++) {
+            self->data[i] = self->value = self->value + (self->target - self->value) * self->factor;
+        }
+    }
+    else {
+        for (i=start; i<end; i++) {
+            self->data[i] = self->value = self->target;
+        }
+    }
+}
+
 static void OscListReceive_postprocessing_ii(OscListReceive *self) { POST_PROCESSING_II };
 static void OscListReceive_postprocessing_ai(OscListReceive *self) { POST_PROCESSING_AI };
 static void OscListReceive_postprocessing_ia(OscListReceive *self) { POST_PROCESSING_IA };
@@ -1453,21 +1644,31 @@ OscListReceive_setProcMode(OscListReceive *self)
 static void
 OscListReceive_compute_next_data_frame(OscListReceive *self)
 {
-    int i;
-    PyObject *flist = OscListReceiver_getValue((OscListReceiver *)self->input, self->address_path);
-    MYFLT val = PyFloat_AsDouble(PyList_GET_ITEM(flist, self->order));
-
-    if (self->interpolation == 1) {
-
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->value = self->value + (val - self->value) * self->factor;
-        }
+    int i, frame, count, pos = 0, found = 0;
+    OscQueueEvent *ev;
+    PyObject *flist;
+    OscListReceiver *receiver = (OscListReceiver *)self->input;
+    char *path = PyString_AsString(self->address_path);
+
+    /* The messages take effect at their frames, values set from python at
+     * the start of the block. */
+    count = OscListReceiver_getCount(receiver);
+    for (i=0; i<count; i++) {
+        ev = OscListReceiver_getEvent(receiver, i, &frame);
+        if (strcmp(ev->path, path) != 0)
+            continue;
+        if (frame > self->bufsize)
+            frame = self->bufsize;
+        OscListReceive_fill(self, pos, frame);
+        pos = frame;
+        self->target = OscQueue_number(ev, self->order);
+        found = 1;
     }
-    else {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->value = val;
-        }
+    if (!found) {
+        flist = OscListReceiver_getValue(receiver, self->address_path);
+        self->target = PyFloat_AsDouble(PyList_GET_ITEM(flist, self->order));
     }
+    OscListReceive_fill(self, pos, self->bufsize);
 
     (*self->muladd_func_ptr)(self);
 }
@@ -1507,7 +1708,7 @@ OscListReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self = (OscListReceive *)type->tp_alloc(type, 0);
 
     self->order = 0;
-    self->value = 0.;
+    self->value = self->target = 0.;
     self->interpolation = 1;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
@@ -1517,6 +1718,7 @@ OscListReceive_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->factor = 1. / (0.01 * self->sr);
 
     Stream_setFunctionPtr(self->stream, OscListReceive_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = OscListReceive_setProcMode;
 
     static char *kwlist[] = {"input", "address", "order", "mul", "add", NULL};
@@ -0,0 +1,317 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include "structmember.h"
+#include "pyomodule.h"
+#include "streammodule.h"
+#include "servermodule.h"
+#include "dummymodule.h"
+
+/* PackedChannel reads one channel of a packed stream, rendered by an
+ * object processing all the channels at once. */
+typedef struct {
+    pyo_audio_HEAD
+    PyObject *mainObj;
+    Stream *main_stream;
+    int modebuffer[2];
+    int chnl;
+} PackedChannel;
+
+static void PackedChannel_postprocessing_ii(PackedChannel *self) { POST_PROCESSING_II };
+static void PackedChannel_postprocessing_ai(PackedChannel *self) { POST_PROCESSING_AI };
+static void PackedChannel_postprocessing_ia(PackedChannel *self) { POST_PROCESSING_IA };
+static void PackedChannel_postprocessing_aa(PackedChannel *self) { POST_PROCESSING_AA };
+static void PackedChannel_postprocessing_ireva(PackedChannel *self) { POST_PROCESSING_IREVA };
+static void PackedChannel_postprocessing_areva(PackedChannel *self) { POST_PROCESSING_AREVA };
+static void PackedChannel_postprocessing_revai(PackedChannel *self) { POST_PROCESSING_REVAI };
+static void PackedChannel_postprocessing_revaa(PackedChannel *self) { POST_PROCESSING_REVAA };
+static void PackedChannel_postprocessing_revareva(PackedChannel *self) { POST_PROCESSING_REVAREVA };
+
+static void
+PackedChannel_setProcMode(PackedChannel *self)
+{
+    int muladdmode;
+    muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
+
+	switch (muladdmode) {
+        case 0:
+            self->muladd_func_ptr = PackedChannel_postprocessing_ii;
+            break;
+        case 1:
+            self->muladd_func_ptr = PackedChannel_postprocessing_ai;
+            break;
+        case 2:
+            self->muladd_func_ptr = PackedChannel_postprocessing_revai;
+            break;
+        case 10:
+            self->muladd_func_ptr = PackedChannel_postprocessing_ia;
+            break;
+        case 11:
+            self->muladd_func_ptr = PackedChannel_postprocessing_aa;
+            break;
+        case 12:
+            self->muladd_func_ptr = PackedChannel_postprocessing_revaa;
+            break;
+        case 20:
+            self->muladd_func_ptr = PackedChannel_postprocessing_ireva;
+            break;
+        case 21:
+            self->muladd_func_ptr = PackedChannel_postprocessing_areva;
+            break;
+        case 22:
+            self->muladd_func_ptr = PackedChannel_postprocessing_revareva;
+            break;
+    }
+}
+
+/* Without mul and add, the stream points to the channel in the main stream,
+ * nothing is copied. */
+static void
+PackedChannel_compute_next_data_frame(PackedChannel *self)
+{
+    int i;
+    MYFLT *tmp = Stream_getData(self->main_stream) + self->chnl * self->bufsize;
+
+    if (self->modebuffer[0] == 0 && self->modebuffer[1] == 0 &&
+        PyFloat_AS_DOUBLE(self->mul) == 1 && PyFloat_AS_DOUBLE(self->add) == 0) {
+        Stream_setData(self->stream, tmp);
+        return;
+    }
+
+    Stream_setData(self->stream, self->data);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = tmp[i];
+    }
+    (*self->muladd_func_ptr)(self);
+}
+
+static int
+PackedChannel_traverse(PackedChannel *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->mainObj);
+    Py_VISIT(self->main_stream);
+    return 0;
+}
+
+static int
+PackedChannel_clear(PackedChannel *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->mainObj);
+    Py_CLEAR(self->main_stream);
+    return 0;
+}
+
+static void
+PackedChannel_dealloc(PackedChannel* self)
+{
+    pyo_DEALLOC
+    PackedChannel_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+PackedChannel_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i;
+    PyObject *maintmp=NULL, *streamtmp, *multmp=NULL, *addtmp=NULL;
+    PackedChannel *self;
+    self = (PackedChannel *)type->tp_alloc(type, 0);
+
+    self->chnl = 0;
+	self->modebuffer[0] = 0;
+	self->modebuffer[1] = 0;
+
+    INIT_OBJECT_COMMON
+    Stream_setFunctionPtr(self->stream, PackedChannel_compute_next_data_frame);
+    self->mode_func_ptr = PackedChannel_setProcMode;
+
+    static char *kwlist[] = {"mainObj", "chnl", "mul", "add", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|iOO", kwlist, &maintmp, &self->chnl, &multmp, &addtmp))
+        Py_RETURN_NONE;
+
+    streamtmp = PyObject_CallMethod(maintmp, "_getStream", NULL);
+    if (streamtmp == NULL)
+        return NULL;
+    Py_XDECREF(self->mainObj);
+    Py_INCREF(maintmp);
+    self->mainObj = maintmp;
+    Py_XDECREF(self->main_stream);
+    self->main_stream = (Stream *)streamtmp;
+
+    if (self->chnl < 0 || self->chnl >= Stream_getPackedChannels(self->main_stream))
+        self->chnl = 0;
+
+    if (multmp) {
+        PyObject_CallMethod((PyObject *)self, "setMul", "O", multmp);
+    }
+
+    if (addtmp) {
+        PyObject_CallMethod((PyObject *)self, "setAdd", "O", addtmp);
+    }
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    (*self->mode_func_ptr)(self);
+
+    return (PyObject *)self;
+}
+
+static PyObject * PackedChannel_getServer(PackedChannel* self) { GET_SERVER };
+static PyObject * PackedChannel_getStream(PackedChannel* self) { GET_STREAM };
+static PyObject * PackedChannel_setMul(PackedChannel *self, PyObject *arg) { SET_MUL };
+static PyObject * PackedChannel_setAdd(PackedChannel *self, PyObject *arg) { SET_ADD };
+static PyObject * PackedChannel_setSub(PackedChannel *self, PyObject *arg) { SET_SUB };
+static PyObject * PackedChannel_setDiv(PackedChannel *self, PyObject *arg) { SET_DIV };
+
+static PyObject * PackedChannel_play(PackedChannel *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * PackedChannel_out(PackedChannel *self, PyObject *args, PyObject *kwds) { OUT };
+static PyObject *
+PackedChannel_stop(PackedChannel *self)
+{
+    int i;
+
+    Stream_setData(self->stream, self->data);
+    Stream_setStreamActive(self->stream, 0);
+    Stream_setStreamChnl(self->stream, 0);
+    Stream_setStreamToDac(self->stream, 0);
+    for (i=0; i<self->bufsize; i++) {
+        self->data[i] = 0;
+    }
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject * PackedChannel_multiply(PackedChannel *self, PyObject *arg) { MULTIPLY };
+static PyObject * PackedChannel_inplace_multiply(PackedChannel *self, PyObject *arg) { INPLACE_MULTIPLY };
+static PyObject * PackedChannel_add(PackedChannel *self, PyObject *arg) { ADD };
+static PyObject * PackedChannel_inplace_add(PackedChannel *self, PyObject *arg) { INPLACE_ADD };
+static PyObject * PackedChannel_sub(PackedChannel *self, PyObject *arg) { SUB };
+static PyObject * PackedChannel_inplace_sub(PackedChannel *self, PyObject *arg) { INPLACE_SUB };
+static PyObject * PackedChannel_div(PackedChannel *self, PyObject *arg) { DIV };
+static PyObject * PackedChannel_inplace_div(PackedChannel *self, PyObject *arg) { INPLACE_DIV };
+
+static PyMemberDef PackedChannel_members[] = {
+{"server", T_OBJECT_EX, offsetof(PackedChannel, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(PackedChannel, stream), 0, "Stream object."},
+{"mul", T_OBJECT_EX, offsetof(PackedChannel, mul), 0, "Mul factor."},
+{"add", T_OBJECT_EX, offsetof(PackedChannel, add), 0, "Add factor."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef PackedChannel_methods[] = {
+{"getServer", (PyCFunction)PackedChannel_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)PackedChannel_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)PackedChannel_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"out", (PyCFunction)PackedChannel_out, METH_VARARGS|METH_KEYWORDS, "Starts computing and sends sound to soundcard channel speficied by argument."},
+{"stop", (PyCFunction)PackedChannel_stop, METH_NOARGS, "Stops computing."},
+{"setMul", (PyCFunction)PackedChannel_setMul, METH_O, "Sets PackedChannel mul factor."},
+{"setAdd", (PyCFunction)PackedChannel_setAdd, METH_O, "Sets PackedChannel add factor."},
+{"setSub", (PyCFunction)PackedChannel_setSub, METH_O, "Sets inverse add factor."},
+{"setDiv", (PyCFunction)PackedChannel_setDiv, METH_O, "Sets inverse mul factor."},
+{NULL}  /* Sentinel */
+};
+
+static PyNumberMethods PackedChannel_as_number = {
+(binaryfunc)PackedChannel_add,                      /*nb_add*/
+(binaryfunc)PackedChannel_sub,                 /*nb_subtract*/
+(binaryfunc)PackedChannel_multiply,                 /*nb_multiply*/
+(binaryfunc)PackedChannel_div,                   /*nb_divide*/
+0,                /*nb_remainder*/
+0,                   /*nb_divmod*/
+0,                   /*nb_power*/
+0,                  /*nb_neg*/
+0,                /*nb_pos*/
+0,                  /*(unaryfunc)array_abs,*/
+0,                    /*nb_nonzero*/
+0,                    /*nb_invert*/
+0,               /*nb_lshift*/
+0,              /*nb_rshift*/
+0,              /*nb_and*/
+0,              /*nb_xor*/
+0,               /*nb_or*/
+0,                                          /*nb_coerce*/
+0,                       /*nb_int*/
+0,                      /*nb_long*/
+0,                     /*nb_float*/
+0,                       /*nb_oct*/
+0,                       /*nb_hex*/
+(binaryfunc)PackedChannel_inplace_add,              /*inplace_add*/
+(binaryfunc)PackedChannel_inplace_sub,         /*inplace_subtract*/
+(binaryfunc)PackedChannel_inplace_multiply,         /*inplace_multiply*/
+(binaryfunc)PackedChannel_inplace_div,           /*inplace_divide*/
+0,        /*inplace_remainder*/
+0,           /*inplace_power*/
+0,       /*inplace_lshift*/
+0,      /*inplace_rshift*/
+0,      /*inplace_and*/
+0,      /*inplace_xor*/
+0,       /*inplace_or*/
+0,             /*nb_floor_divide*/
+0,              /*nb_true_divide*/
+0,     /*nb_inplace_floor_divide*/
+0,      /*nb_inplace_true_divide*/
+0,                     /* nb_index */
+};
+
+PyTypeObject PackedChannelType = {
+PyObject_HEAD_INIT(NULL)
+0,                         /*ob_size*/
+"_pyo.PackedChannel_base",         /*tp_name*/
+sizeof(PackedChannel),         /*tp_basicsize*/
+0,                         /*tp_itemsize*/
+(destructor)PackedChannel_dealloc, /*tp_dealloc*/
+0,                         /*tp_print*/
+0,                         /*tp_getattr*/
+0,                         /*tp_setattr*/
+0,                         /*tp_compare*/
+0,                         /*tp_repr*/
+&PackedChannel_as_number,             /*tp_as_number*/
+0,                         /*tp_as_sequence*/
+0,                         /*tp_as_mapping*/
+0,                         /*tp_hash */
+0,                         /*tp_call*/
+0,                         /*tp_str*/
+0,                         /*tp_getattro*/
+0,                         /*tp_setattro*/
+0,                         /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC | Py_TPFLAGS_CHECKTYPES,  /*tp_flags*/
+"PackedChannel objects. Reads a channel of a packed stream.",           /* tp_doc */
+(traverseproc)PackedChannel_traverse,   /* tp_traverse */
+(inquiry)PackedChannel_clear,           /* tp_clear */
+0,		               /* tp_richcompare */
+0,		               /* tp_weaklistoffset */
+0,		               /* tp_iter */
+0,		               /* tp_iternext */
+PackedChannel_methods,             /* tp_methods */
+PackedChannel_members,             /* tp_members */
+0,                      /* tp_getset */
+0,                         /* tp_base */
+0,                         /* tp_dict */
+0,                         /* tp_descr_get */
+0,                         /* tp_descr_set */
+0,                         /* tp_dictoffset */
+0,      /* tp_init */
+0,                         /* tp_alloc */
+PackedChannel_new,                 /* tp_new */
+};
@@ -2201,71 +2201,240 @@ VoiceManager_new,                                     /* tp_new */
 /****************/
 /**** Mixer *****/
 /****************/
+
+/* The routing matrix is only read and written by the audio thread. Python
+ * setters post their changes in a lock-free list, applied in posting order
+ * at the start of the next buffer. Applied changes come back through a
+ * second list and are freed, with the references and memory they carry,
+ * by the next setter. */
+#define MIXER_ADD 0
+#define MIXER_DEL 1
+#define MIXER_AMP 2
+#define MIXER_TIME 3
+#define MIXER_RESIZE 4
+
+typedef struct {
+    int size; /* number of input slots */
+    Stream **streams; /* NULL for a free slot */
+    /* routes of a slot are contiguous, one per output */
+    MYFLT *gains;
+    MYFLT *currentGains;
+    MYFLT *stepVals;
+    long *timeCounts;
+} MixerMatrix;
+
+typedef struct MixerChange {
+    int kind;
+    int slot;
+    int out;
+    MYFLT value;
+    Stream *stream;
+    PyObject *input; /* reference released once the change is applied */
+    MixerMatrix *matrix; /* the new matrix, then the old one to free */
+    struct MixerChange *next;
+} MixerChange;
+
 typedef struct {
     pyo_audio_HEAD
     PyObject *inputs;
     PyObject *gains;
-    PyObject *lastGains;
-    PyObject *currentGains;
-    PyObject *stepVals;
-    PyObject *timeCounts;
+    PyObject *slots; /* input key -> slot in the matrix */
     int num_outs;
     MYFLT time;
     long timeStep;
+    MixerMatrix *matrix;
+    int capacity; /* size of the last matrix posted */
+    char *used; /* slots taken, as seen from python */
+    MixerChange * volatile pending;
+    MixerChange * volatile done;
     MYFLT *buffer_streams;
 } Mixer;
 
+static MixerMatrix *
+MixerMatrix_new(int size, int outs)
+{
+    MixerMatrix *m = (MixerMatrix *)malloc(sizeof(MixerMatrix));
+
+    m->size = size;
+    m->streams = (Stream **)calloc(size, sizeof(Stream *));
+    m->gains = (MYFLT *)calloc(size * outs, sizeof(MYFLT));
+    m->currentGains = (MYFLT *)calloc(size * outs, sizeof(MYFLT));
+    m->stepVals = (MYFLT *)calloc(size * outs, sizeof(MYFLT));
+    m->timeCounts = (long *)calloc(size * outs, sizeof(long));
+    return m;
+}
+
+static void
+MixerMatrix_free(MixerMatrix *m)
+{
+    if (m == NULL)
+        return;
+    free(m->streams);
+    free(m->gains);
+    free(m->currentGains);
+    free(m->stepVals);
+    free(m->timeCounts);
+    free(m);
+}
+
+static void
+MixerChange_freeList(MixerChange *c)
+{
+    MixerChange *next;
+
+    while (c != NULL) {
+        next = c->next;
+        Py_XDECREF(c->input);
+        MixerMatrix_free(c->matrix);
+        free(c);
+        c = next;
+    }
+}
+
+/* Python side. Frees the applied changes, then posts `c`. */
+static void
+Mixer_post(Mixer *self, MixerChange *c)
+{
+    MixerChange *old;
+
+    MixerChange_freeList(__sync_lock_test_and_set(&self->done, NULL));
+    do {
+        old = self->pending;
+        c->next = old;
+    } while (!__sync_bool_compare_and_swap(&self->pending, old, c));
+}
+
+static MixerChange *
+MixerChange_new(int kind, int slot, int out, MYFLT value)
+{
+    MixerChange *c = (MixerChange *)calloc(1, sizeof(MixerChange));
+
+    c->kind = kind;
+    c->slot = slot;
+    c->out = out;
+    c->value = value;
+    return c;
+}
+
+static void
+Mixer_apply(Mixer *self, MixerChange *c)
+{
+    int i, r, outs = self->num_outs;
+    MixerMatrix *m = self->matrix;
+
+    switch (c->kind) {
+        case MIXER_RESIZE:
+            for (i=0; i<m->size; i++) {
+                c->matrix->streams[i] = m->streams[i];
+            }
+            memcpy(c->matrix->gains, m->gains, m->size * outs * sizeof(MYFLT));
+            memcpy(c->matrix->currentGains, m->currentGains, m->size * outs * sizeof(MYFLT));
+            memcpy(c->matrix->stepVals, m->stepVals, m->size * outs * sizeof(MYFLT));
+            memcpy(c->matrix->timeCounts, m->timeCounts, m->size * outs * sizeof(long));
+            self->matrix = c->matrix;
+            c->matrix = m;
+            break;
+        case MIXER_ADD:
+            m->streams[c->slot] = c->stream;
+            break;
+        case MIXER_DEL:
+            m->streams[c->slot] = NULL;
+            for (i=0; i<outs; i++) {
+                r = c->slot * outs + i;
+                m->gains[r] = m->currentGains[r] = m->stepVals[r] = 0.0;
+                m->timeCounts[r] = 0;
+            }
+            break;
+        case MIXER_AMP:
+            r = c->slot * outs + c->out;
+            if (c->value != m->gains[r]) {
+                m->gains[r] = c->value;
+                m->timeCounts[r] = 0;
+                m->stepVals[r] = (c->value - m->currentGains[r]) / self->timeStep;
+            }
+            break;
+        case MIXER_TIME:
+            self->timeStep = (long)(c->value * self->sr);
+            for (i=0; i<m->size*outs; i++) {
+                m->timeCounts[i] = self->timeStep - 1;
+            }
+            break;
+    }
+}
+
+/* Audio side. Applies the pending changes in posting order. */
+static void
+Mixer_applyChanges(Mixer *self)
+{
+    MixerChange *c, *next, *first = NULL, *last, *old;
+
+    c = __sync_lock_test_and_set(&self->pending, NULL);
+    if (c == NULL)
+        return;
+
+    last = c;
+    while (c != NULL) {
+        next = c->next;
+        c->next = first;
+        first = c;
+        c = next;
+    }
+    for (c=first; c!=NULL; c=c->next) {
+        Mixer_apply(self, c);
+    }
+
+    do {
+        old = self->done;
+        last->next = old;
+    } while (!__sync_bool_compare_and_swap(&self->done, old, first));
+}
+
 static void
 Mixer_generate(Mixer *self) {
-    int num, k, j, i, tmpCount;
-    MYFLT amp, lastAmp, currentAmp, tmpStepVal;
-    PyObject *keys;
-    PyObject *key;
-    PyObject *list_of_gains, *list_of_last_gains, *list_of_current_gains, *list_of_step_vals, *list_of_time_counts;
+    int j, k, i, n, r;
+    long count;
+    MYFLT amp, currentAmp, stepVal;
+    MYFLT *st, *out;
+    MixerMatrix *m;
+
+    Mixer_applyChanges(self);
+    m = self->matrix;
 
     for (i=0; i<(self->num_outs * self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
 
-    keys = PyDict_Keys(self->inputs);
-    num = PyList_Size(keys);
-
-    for (j=0; j<num; j++) {
-        key = PyList_GetItem(keys, j);
-        MYFLT *st = Stream_getData((Stream *)PyObject_CallMethod((PyObject *)PyDict_GetItem(self->inputs, key), "_getStream", NULL));
-        list_of_gains = PyDict_GetItem(self->gains, key);
-        list_of_last_gains = PyDict_GetItem(self->lastGains, key);
-        list_of_current_gains = PyDict_GetItem(self->currentGains, key);
-        list_of_step_vals = PyDict_GetItem(self->stepVals, key);
-        list_of_time_counts = PyDict_GetItem(self->timeCounts, key);
+    for (j=0; j<m->size; j++) {
+        if (m->streams[j] == NULL)
+            continue;
+        st = Stream_getData(m->streams[j]);
         for (k=0; k<self->num_outs; k++) {
-            amp = (MYFLT)PyFloat_AS_DOUBLE(PyList_GetItem(list_of_gains, k));
-            lastAmp = (MYFLT)PyFloat_AS_DOUBLE(PyList_GetItem(list_of_last_gains, k));
-            currentAmp = (MYFLT)PyFloat_AS_DOUBLE(PyList_GetItem(list_of_current_gains, k));
-            tmpStepVal = (MYFLT)PyFloat_AS_DOUBLE(PyList_GetItem(list_of_step_vals, k));
-            tmpCount = (int)PyLong_AsLong(PyList_GetItem(list_of_time_counts, k));
-            if (amp != lastAmp) {
-                tmpCount = 0;
-                tmpStepVal = (amp - currentAmp) / self->timeStep;
-                PyList_SetItem(list_of_last_gains, k, PyFloat_FromDouble(amp));
-            }
-            for (i=0; i<self->bufsize; i++) {
-                if (tmpCount == (self->timeStep - 1)) {
-                    currentAmp = amp;
-                    tmpCount++;
+            r = j * self->num_outs + k;
+            out = self->buffer_streams + self->bufsize * k;
+            currentAmp = m->currentGains[r];
+            n = 0;
+            /* ramping part of the buffer */
+            count = m->timeCounts[r];
+            if (count < self->timeStep) {
+                amp = m->gains[r];
+                stepVal = m->stepVals[r];
+                n = self->timeStep - count < self->bufsize ? (int)(self->timeStep - count) : self->bufsize;
+                for (i=0; i<n; i++) {
+                    if (count == (self->timeStep - 1))
+                        currentAmp = amp;
+                    else
+                        currentAmp += stepVal;
+                    count++;
+                    out[i] += st[i] * currentAmp;
                 }
-                else if (tmpCount < self->timeStep) {
-                    currentAmp += tmpStepVal;
-                    tmpCount++;
-                }
-                self->buffer_streams[self->bufsize * k + i] += st[i] * currentAmp;
+                m->timeCounts[r] = count;
+                m->currentGains[r] = currentAmp;
             }
-            PyList_SetItem(list_of_current_gains, k, PyFloat_FromDouble(currentAmp));
-            PyList_SetItem(list_of_step_vals, k, PyFloat_FromDouble(tmpStepVal));
-            PyList_SetItem(list_of_time_counts, k, PyLong_FromLong(tmpCount));
+            /* steady part, silent routes are skipped */
+            if (currentAmp != 0.0 && n < self->bufsize)
+                pyo_accumulate_gain(out + n, st + n, currentAmp, self->bufsize - n);
         }
     }
-    Py_XDECREF(keys);
 }
 
 MYFLT *
@@ -2292,10 +2461,7 @@ Mixer_traverse(Mixer *self, visitproc visit, void *arg)
     pyo_VISIT
     Py_VISIT(self->inputs);
     Py_VISIT(self->gains);
-    Py_VISIT(self->lastGains);
-    Py_VISIT(self->currentGains);
-    Py_VISIT(self->stepVals);
-    Py_VISIT(self->timeCounts);
+    Py_VISIT(self->slots);
     return 0;
 }
 
@@ -2305,10 +2471,7 @@ Mixer_clear(Mixer *self)
     pyo_CLEAR
     Py_CLEAR(self->inputs);
     Py_CLEAR(self->gains);
-    Py_CLEAR(self->lastGains);
-    Py_CLEAR(self->currentGains);
-    Py_CLEAR(self->stepVals);
-    Py_CLEAR(self->timeCounts);
+    Py_CLEAR(self->slots);
     return 0;
 }
 
@@ -2316,6 +2479,10 @@ static void
 Mixer_dealloc(Mixer* self)
 {
     pyo_DEALLOC
+    MixerChange_freeList(self->pending);
+    MixerChange_freeList(self->done);
+    MixerMatrix_free(self->matrix);
+    free(self->used);
     free(self->buffer_streams);
     Mixer_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -2331,23 +2498,25 @@ Mixer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     self->inputs = PyDict_New();
     self->gains = PyDict_New();
-    self->lastGains = PyDict_New();
-    self->currentGains = PyDict_New();
-    self->stepVals = PyDict_New();
-    self->timeCounts = PyDict_New();
+    self->slots = PyDict_New();
     self->num_outs = 2;
     self->time = 0.025;
-    self->timeStep = (long)(self->time * self->sr);
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Mixer_compute_next_data_frame);
     self->mode_func_ptr = Mixer_setProcMode;
 
+    self->timeStep = (long)(self->time * self->sr);
+
     static char *kwlist[] = {"outs", "time", NULL};
 
     if (! PyArg_ParseTupleAndKeywords(args, kwds, "|iO", kwlist, &self->num_outs, &timetmp))
         Py_RETURN_NONE;
 
+    self->capacity = 8;
+    self->matrix = MixerMatrix_new(self->capacity, self->num_outs);
+    self->used = (char *)calloc(self->capacity, sizeof(char));
+
     if (timetmp) {
         PyObject_CallMethod((PyObject *)self, "setTime", "O", timetmp);
     }
@@ -2370,8 +2539,7 @@ static PyObject * Mixer_stop(Mixer *self) { STOP };
 static PyObject *
 Mixer_setTime(Mixer *self, PyObject *arg)
 {
-    int i, j, num;
-	PyObject *tmp, *keys, *key, *list_of_time_counts;
+	PyObject *tmp;
 
 	if (arg == NULL) {
 		Py_INCREF(Py_None);
@@ -2380,40 +2548,55 @@ Mixer_setTime(Mixer *self, PyObject *arg)
 
 	int isNumber = PyNumber_Check(arg);
 
-	tmp = arg;
-	Py_INCREF(tmp);
 	if (isNumber == 1) {
-		self->time = PyFloat_AS_DOUBLE(PyNumber_Float(tmp));
-        self->timeStep = (long)(self->time * self->sr);
-
-        keys = PyDict_Keys(self->inputs);
-        num = PyList_Size(keys);
-        if (num != 0) {
-            for (j=0; j<num; j++) {
-                key = PyList_GET_ITEM(keys, j);
-                list_of_time_counts = PyDict_GetItem(self->timeCounts, key);
-                for (i=0; i<self->num_outs; i++) {
-                    PyList_SET_ITEM(list_of_time_counts, i, PyLong_FromLong(self->timeStep-1));
-                }
-            }
-        }
+		tmp = PyNumber_Float(arg);
+		self->time = PyFloat_AS_DOUBLE(tmp);
+		Py_DECREF(tmp);
+        Mixer_post(self, MixerChange_new(MIXER_TIME, 0, 0, self->time));
 	}
 
 	Py_INCREF(Py_None);
 	return Py_None;
 }
 
+static PyObject *
+Mixer_delInput(Mixer *self, PyObject *arg)
+{
+    int slot;
+    PyObject *tmp;
+    MixerChange *c;
+
+    PyObject *key = arg;
+    tmp = PyDict_GetItem(self->slots, key);
+    if (tmp == NULL) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    slot = PyInt_AsLong(tmp);
+    c = MixerChange_new(MIXER_DEL, slot, 0, 0.0);
+    /* the input stays alive until the audio thread stops reading it */
+    c->input = PyDict_GetItem(self->inputs, key);
+    Py_INCREF(c->input);
+    Mixer_post(self, c);
+
+    self->used[slot] = 0;
+    PyDict_DelItem(self->inputs, key);
+    PyDict_DelItem(self->gains, key);
+    PyDict_DelItem(self->slots, key);
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject *
 Mixer_addInput(Mixer *self, PyObject *args, PyObject *kwds)
 {
-    int i;
-	PyObject *tmp;
+    int i, slot;
+	PyObject *tmp, *streamtmp;
     PyObject *initGains;
-    PyObject *initLastGains;
-    PyObject *initCurrentGains;
-    PyObject *initStepVals;
-    PyObject *initTimeCounts;
     PyObject *voice;
+    MixerChange *c;
 
     static char *kwlist[] = {"voice", "input", NULL};
 
@@ -2422,47 +2605,42 @@ Mixer_addInput(Mixer *self, PyObject *args, PyObject *kwds)
         return Py_None;
     }
 
+    streamtmp = PyObject_CallMethod(tmp, "_getStream", NULL);
+    if (streamtmp == NULL)
+        return NULL;
+
+    if (PyDict_GetItem(self->slots, voice) != NULL)
+        Py_XDECREF(Mixer_delInput(self, voice));
+
+    for (slot=0; slot<self->capacity; slot++) {
+        if (!self->used[slot])
+            break;
+    }
+    if (slot == self->capacity) {
+        c = MixerChange_new(MIXER_RESIZE, 0, 0, 0.0);
+        c->matrix = MixerMatrix_new(self->capacity * 2, self->num_outs);
+        Mixer_post(self, c);
+        self->used = (char *)realloc(self->used, self->capacity * 2 * sizeof(char));
+        memset(self->used + self->capacity, 0, self->capacity * sizeof(char));
+        self->capacity *= 2;
+    }
+    self->used[slot] = 1;
+
+    c = MixerChange_new(MIXER_ADD, slot, 0, 0.0);
+    c->stream = (Stream *)streamtmp;
+    Mixer_post(self, c);
+    Py_DECREF(streamtmp);
+
     PyDict_SetItem(self->inputs, voice, tmp);
+    tmp = PyInt_FromLong(slot);
+    PyDict_SetItem(self->slots, voice, tmp);
+    Py_DECREF(tmp);
     initGains = PyList_New(self->num_outs);
-    initLastGains = PyList_New(self->num_outs);
-    initCurrentGains = PyList_New(self->num_outs);
-    initStepVals = PyList_New(self->num_outs);
-    initTimeCounts = PyList_New(self->num_outs);
     for (i=0; i<self->num_outs; i++) {
         PyList_SET_ITEM(initGains, i, PyFloat_FromDouble(0.0));
-        PyList_SET_ITEM(initLastGains, i, PyFloat_FromDouble(0.0));
-        PyList_SET_ITEM(initCurrentGains, i, PyFloat_FromDouble(0.0));
-        PyList_SET_ITEM(initStepVals, i, PyFloat_FromDouble(0.0));
-        PyList_SET_ITEM(initTimeCounts, i, PyInt_FromLong(0));
     }
     PyDict_SetItem(self->gains, voice, initGains);
-    PyDict_SetItem(self->lastGains, voice, initLastGains);
-    PyDict_SetItem(self->currentGains, voice, initCurrentGains);
-    PyDict_SetItem(self->stepVals, voice, initStepVals);
-    PyDict_SetItem(self->timeCounts, voice, initTimeCounts);
-
-	Py_INCREF(Py_None);
-	return Py_None;
-}
-
-static PyObject *
-Mixer_delInput(Mixer *self, PyObject *arg)
-{
-    int ret;
-
-    PyObject *key = arg;
-    ret = PyDict_DelItem(self->inputs, key);
-    if (ret == 0) {
-        PyDict_DelItem(self->gains, key);
-        PyDict_DelItem(self->lastGains, key);
-        PyDict_DelItem(self->currentGains, key);
-        PyDict_DelItem(self->stepVals, key);
-        PyDict_DelItem(self->timeCounts, key);
-    }
-    else {
-        Py_INCREF(Py_None);
-        return Py_None;
-    }
+    Py_DECREF(initGains);
 
 	Py_INCREF(Py_None);
 	return Py_None;
@@ -2472,7 +2650,7 @@ static PyObject *
 Mixer_setAmp(Mixer *self, PyObject *args, PyObject *kwds)
 {
     int tmpout;
-    PyObject *tmpin, *amp;
+    PyObject *tmpin, *amp, *slot;
     static char *kwlist[] = {"vin", "vout", "amp", NULL};
 
     if (! PyArg_ParseTupleAndKeywords(args, kwds, "OiO", kwlist, &tmpin, &tmpout, &amp)) {
@@ -2486,8 +2664,15 @@ Mixer_setAmp(Mixer *self, PyObject *args, PyObject *kwds)
         return Py_None;
     }
 
-    Py_INCREF(amp);
-    PyList_SET_ITEM(PyDict_GetItem(self->gains, tmpin), tmpout, PyNumber_Float(amp));
+    slot = PyDict_GetItem(self->slots, tmpin);
+    if (slot == NULL || tmpout < 0 || tmpout >= self->num_outs) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    amp = PyNumber_Float(amp);
+    Mixer_post(self, MixerChange_new(MIXER_AMP, PyInt_AsLong(slot), tmpout, PyFloat_AS_DOUBLE(amp)));
+    PyList_SetItem(PyDict_GetItem(self->gains, tmpin), tmpout, amp);
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2999,6 +3184,7 @@ Selector_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Selector_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = Selector_setProcMode;
 
     static char *kwlist[] = {"inputs", "voice", "mul", "add", NULL};
@@ -19,6 +19,7 @@
  *************************************************************************/
 
 #include <Python.h>
+#include <math.h>
 #include "structmember.h"
 #include "pyomodule.h"
 #include "streammodule.h"
@@ -34,13 +35,105 @@ typedef struct {
     MYFLT sampleToSec;
     double currentTime;
     int init;
+    TimerEvent timer;
+    long long last; /* sample of the last call, while the server keeps the deadline */
+    long long period; /* samples between two calls, while the server keeps the deadline */
 } Pattern;
 
+static void
+Pattern_callback(PyObject *obj, double value)
+{
+    PyObject *tuple, *result;
+    Pattern *self = (Pattern *)obj;
+
+    tuple = PyTuple_New(0);
+    result = PyObject_Call((PyObject *)self->callable, tuple, NULL);
+    if (result == NULL)
+        PyErr_Print();
+    else
+        Py_DECREF(result);
+    Py_DECREF(tuple);
+}
+
+static void
+Pattern_call(Pattern *self)
+{
+    if (Server_isGILFree((Server *)self->server))
+        Server_postCallback((Server *)self->server, (PyObject *)self, Pattern_callback, 0);
+    else
+        Pattern_callback((PyObject *)self, 0);
+}
+
+/* Samples from a call to the next one, as counted by Pattern_generate_i. */
+static long long
+Pattern_period(Pattern *self, MYFLT tm)
+{
+    long long n;
+    double dt = self->sampleToSec;
+
+    if (tm <= 0)
+        return 1;
+    n = (long long)ceil(tm / dt);
+    while (n > 1 && (n - 1) * dt >= tm)
+        n--;
+    while (n * dt < tm)
+        n++;
+    return n;
+}
+
+static void
+Pattern_timeout(PyObject *obj, unsigned long long time)
+{
+    long long due = (long long)time, end;
+    Pattern *self = (Pattern *)obj;
+
+    /* Stopped by its duration, the stop method will take the deadline back. */
+    if (Stream_getStreamActive(self->stream) == 0)
+        return;
+
+    /* The calls due in the same buffer are merged. */
+    end = (due / self->bufsize + 1) * self->bufsize;
+    self->last = due + (end - 1 - due) / self->period * self->period;
+    Server_scheduleTimer((Server *)self->server, &self->timer, self->last + self->period);
+    Pattern_call(self);
+}
+
+/* Gives the next deadline to the server, the stream isn't computed until
+   the pattern is stopped, played again or gets a time stream. */
+static void
+Pattern_schedule(Pattern *self, MYFLT tm)
+{
+    long long now = (long long)Server_getCurrentSample((Server *)self->server);
+    long long due;
+
+    if (!Stream_isTimed(self->stream)) {
+        /* From the process function, the current buffer is counted. */
+        now += self->bufsize;
+        self->last = now - (long long)(self->currentTime / self->sampleToSec + 0.5);
+    }
+    self->period = Pattern_period(self, tm);
+    due = self->last + self->period;
+    if (due < now)
+        due = now;
+    if (Server_scheduleTimer((Server *)self->server, &self->timer, due) == 0)
+        Stream_setTimed(self->stream, 1);
+}
+
+/* Called before the stream is computed again, the count goes on. */
+static void
+Pattern_unschedule(Pattern *self)
+{
+    if (!Stream_isTimed(self->stream))
+        return;
+    TimerWheel_cancel(&self->timer);
+    Stream_setTimed(self->stream, 0);
+    self->currentTime = ((long long)Server_getCurrentSample((Server *)self->server) - self->last) * (double)self->sampleToSec;
+}
+
 static void
 Pattern_generate_i(Pattern *self) {
     MYFLT tm;
     int i, flag;
-    PyObject *result;
 
     flag = 0;
     tm = PyFloat_AS_DOUBLE(self->time);
@@ -55,16 +148,16 @@ Pattern_generate_i(Pattern *self) {
     }
     if (flag == 1 || self->init == 1) {
         self->init = 0;
-        result = PyObject_Call((PyObject *)self->callable, PyTuple_New(0), NULL);
-        if (result == NULL)
-            PyErr_Print();
+        Pattern_call(self);
     }
+    /* The callable may have changed the pattern. */
+    if (Stream_getStreamActive(self->stream) && !Stream_isTimed(self->stream) && self->modebuffer[0] == 0)
+        Pattern_schedule(self, PyFloat_AS_DOUBLE(self->time));
 }
 
 static void
 Pattern_generate_a(Pattern *self) {
     int i, flag;
-    PyObject *result;
 
     MYFLT *tm = Stream_getData((Stream *)self->time_stream);
 
@@ -79,9 +172,7 @@ Pattern_generate_a(Pattern *self) {
     }
     if (flag == 1 || self->init == 1) {
         self->init = 0;
-        result = PyObject_Call((PyObject *)self->callable, PyTuple_New(0), NULL);
-        if (result == NULL)
-            PyErr_Print();
+        Pattern_call(self);
     }
 }
 
@@ -129,6 +220,7 @@ Pattern_clear(Pattern *self)
 static void
 Pattern_dealloc(Pattern* self)
 {
+    TimerWheel_cancel(&self->timer);
     pyo_DEALLOC
     Pattern_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -148,12 +240,18 @@ Pattern_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Pattern_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    if (Server_isGILFree((Server *)self->server))
+        Stream_setStreamShared(self->stream, 1);
+    else
+        Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = Pattern_setProcMode;
 
     Stream_setStreamActive(self->stream, 0);
 
     self->sampleToSec = 1. / self->sr;
     self->currentTime = 0.;
+    TimerEvent_init(&self->timer, self, Pattern_timeout);
 
     static char *kwlist[] = {"callable", "time", NULL};
 
@@ -181,11 +279,17 @@ static PyObject * Pattern_getStream(Pattern* self) { GET_STREAM };
 static PyObject *
 Pattern_play(Pattern *self, PyObject *args, PyObject *kwds)
 {
+    Pattern_unschedule(self);
     self->init = 1;
     PLAY
 };
 
-static PyObject * Pattern_stop(Pattern *self) { STOP };
+static PyObject *
+Pattern_stop(Pattern *self)
+{
+    Pattern_unschedule(self);
+    STOP
+};
 
 static PyObject *
 Pattern_setFunction(Pattern *self, PyObject *arg)
@@ -225,8 +329,11 @@ Pattern_setTime(Pattern *self, PyObject *arg)
 	if (isNumber == 1) {
 		self->time = PyNumber_Float(tmp);
         self->modebuffer[0] = 0;
+        if (Stream_isTimed(self->stream))
+            Pattern_schedule(self, PyFloat_AS_DOUBLE(self->time));
 	}
 	else {
+        Pattern_unschedule(self);
 		self->time = tmp;
         streamtmp = PyObject_CallMethod((PyObject *)self->time, "_getStream", NULL);
         Py_INCREF(streamtmp);
@@ -378,6 +485,7 @@ Score_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Score_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
     self->mode_func_ptr = Score_setProcMode;
 
     static char *kwlist[] = {"input", "fname", NULL};
@@ -466,29 +574,91 @@ typedef struct {
     MYFLT time;
     MYFLT sampleToSec;
     double currentTime;
+    TimerEvent timer;
+    long long start; /* sample at which the count started, while the server keeps the deadline */
 } CallAfter;
 
+static void
+CallAfter_callback(PyObject *obj, double value)
+{
+    PyObject *tuple, *result;
+    CallAfter *self = (CallAfter *)obj;
+
+    if (self->arg == Py_None)
+        tuple = PyTuple_New(0);
+    else
+        tuple = PyTuple_Pack(1, self->arg);
+    result = PyObject_Call(self->callable, tuple, NULL);
+    if (result == NULL)
+        PyErr_Print();
+    else
+        Py_DECREF(result);
+    Py_DECREF(tuple);
+    result = PyObject_CallMethod((PyObject *)self, "stop", NULL);
+    Py_XDECREF(result);
+}
+
+static void
+CallAfter_call(CallAfter *self)
+{
+    if (Server_isGILFree((Server *)self->server)) {
+        /* Don't fire again before the dispatcher calls stop. */
+        Stream_setStreamActive(self->stream, 0);
+        Server_postCallback((Server *)self->server, (PyObject *)self, CallAfter_callback, 0);
+    }
+    else
+        CallAfter_callback((PyObject *)self, 0);
+}
+
+static void
+CallAfter_timeout(PyObject *obj, unsigned long long time)
+{
+    CallAfter *self = (CallAfter *)obj;
+
+    if (Stream_getStreamActive(self->stream) == 0)
+        return;
+    Stream_setTimed(self->stream, 0);
+    self->currentTime = ((long long)time - self->start) * (double)self->sampleToSec;
+    CallAfter_call(self);
+}
+
+/* Called before the stream is computed again, the count goes on. */
+static void
+CallAfter_unschedule(CallAfter *self)
+{
+    if (!Stream_isTimed(self->stream))
+        return;
+    TimerWheel_cancel(&self->timer);
+    Stream_setTimed(self->stream, 0);
+    self->currentTime = ((long long)Server_getCurrentSample((Server *)self->server) - self->start) * (double)self->sampleToSec;
+}
+
 static void
 CallAfter_generate(CallAfter *self) {
     int i;
-    PyObject *tuple, *result;
+    long long n, end;
+    double dt = self->sampleToSec;
 
     for (i=0; i<self->bufsize; i++) {
         if (self->currentTime >= self->time) {
-            if (self->arg == Py_None)
-                tuple = PyTuple_New(0);
-            else {
-                tuple = PyTuple_New(1);
-                PyTuple_SET_ITEM(tuple, 0, self->arg);
-            }
-            result = PyObject_Call(self->callable, tuple, NULL);
-            if (result == NULL)
-                PyErr_Print();
-            PyObject_CallMethod((PyObject *)self, "stop", NULL);
-            break;
+            CallAfter_call(self);
+            return;
         }
         self->currentTime += self->sampleToSec;
     }
+
+    /* Still waiting, the server keeps the deadline. */
+    end = (long long)Server_getCurrentSample((Server *)self->server) + self->bufsize;
+    self->start = end - (long long)(self->currentTime / dt + 0.5);
+    n = (long long)ceil(self->time / dt);
+    while (n > 0 && (n - 1) * dt >= self->time)
+        n--;
+    while (n * dt < self->time)
+        n++;
+    if (self->start + n > end)
+        end = self->start + n;
+    if (Server_scheduleTimer((Server *)self->server, &self->timer, end) == 0)
+        Stream_setTimed(self->stream, 1);
 }
 
 static void
@@ -524,6 +694,7 @@ CallAfter_clear(CallAfter *self)
 static void
 CallAfter_dealloc(CallAfter* self)
 {
+    TimerWheel_cancel(&self->timer);
     pyo_DEALLOC
     CallAfter_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -542,10 +713,16 @@ CallAfter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, CallAfter_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    if (Server_isGILFree((Server *)self->server))
+        Stream_setStreamShared(self->stream, 1);
+    else
+        Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = CallAfter_setProcMode;
 
     self->sampleToSec = 1. / self->sr;
     self->currentTime = 0.;
+    TimerEvent_init(&self->timer, self, CallAfter_timeout);
 
     static char *kwlist[] = {"callable", "time", "arg", NULL};
 
@@ -575,8 +752,19 @@ CallAfter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 static PyObject * CallAfter_getServer(CallAfter* self) { GET_SERVER };
 static PyObject * CallAfter_getStream(CallAfter* self) { GET_STREAM };
 
-static PyObject * CallAfter_play(CallAfter *self, PyObject *args, PyObject *kwds) { PLAY };
-static PyObject * CallAfter_stop(CallAfter *self) { STOP };
+static PyObject *
+CallAfter_play(CallAfter *self, PyObject *args, PyObject *kwds)
+{
+    CallAfter_unschedule(self);
+    PLAY
+};
+
+static PyObject *
+CallAfter_stop(CallAfter *self)
+{
+    CallAfter_unschedule(self);
+    STOP
+};
 
 static PyMemberDef CallAfter_members[] = {
 {"server", T_OBJECT_EX, offsetof(CallAfter, server), 0, "Pyo server."},
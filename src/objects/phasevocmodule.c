@@ -28,7 +28,10 @@
 #include "dummymodule.h"
 #include "tablemodule.h"
 #include "fft.h"
+#include "pvfile.h"
+#include "oscarray.h"
 #include "wind.h"
+#include "dspthread.h"
 
 static int
 isPowerOfTwo(int x) {
@@ -57,16 +60,23 @@ typedef struct {
     MYFLT *imag;
     MYFLT *lastPhase;
     MYFLT **twiddle;
-    MYFLT *window;
+    const MYFLT *window;
     MYFLT **magn;
     MYFLT **freq;
     int *count;
+    HelperThread *helper; /* computes the frames one hop late when not NULL */
+    int job_mod;
+    MYFLT *job_buffer;
+    MYFLT *job_magn;
+    MYFLT *job_freq;
 } PVAnal;
 
 
 static void
 PVAnal_realloc_memories(PVAnal *self) {
-    int i, j, n8;
+    int i;
+    if (self->helper != NULL)
+        HelperThread_wait(self->helper);
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     self->factor = self->sr / (self->hopsize * TWOPI);
@@ -74,7 +84,6 @@ PVAnal_realloc_memories(PVAnal *self) {
     self->inputLatency = self->size - self->hopsize;
     self->incount = self->inputLatency;
     self->overcount = 0;
-    n8 = self->size >> 3;
     self->input_buffer = (MYFLT *)realloc(self->input_buffer, self->size * sizeof(MYFLT));
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
@@ -83,35 +92,66 @@ PVAnal_realloc_memories(PVAnal *self) {
     self->lastPhase = (MYFLT *)realloc(self->lastPhase, self->hsize * sizeof(MYFLT));
     self->real = (MYFLT *)realloc(self->real, self->hsize * sizeof(MYFLT));
     self->imag = (MYFLT *)realloc(self->imag, self->hsize * sizeof(MYFLT));
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    self->job_buffer = (MYFLT *)realloc(self->job_buffer, self->size * sizeof(MYFLT));
+    self->job_magn = (MYFLT *)realloc(self->job_magn, self->hsize * sizeof(MYFLT));
+    self->job_freq = (MYFLT *)realloc(self->job_freq, self->hsize * sizeof(MYFLT));
+    for (i=0; i<self->hsize; i++)
+        self->job_magn[i] = self->job_freq[i] = 0.0;
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->hsize; i++)
         self->lastPhase[i] = self->real[i] = self->imag[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, self->wintype);
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, self->wintype);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = self->incount;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, (4 * self->size + 5 * self->hsize) * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
+}
+
+/* Analyses the frame in `buffer`, rotated by `mod` samples, into `magn` and `freq`. */
+static void
+PVAnal_analyse(PVAnal *self, MYFLT *buffer, int mod, MYFLT *magn, MYFLT *freq) {
+    int k;
+    MYFLT real, imag, mag, phase, tmp;
+
+    for (k=0; k<self->size; k++) {
+        self->inframe[(k+mod)%self->size] = buffer[k] * self->window[k];
+    }
+    realfft_split(self->inframe, self->outframe, self->size, self->twiddle);
+    self->real[0] = self->outframe[0];
+    self->imag[0] = 0.0;
+    for (k=1; k<self->hsize; k++) {
+        self->real[k] = self->outframe[k];
+        self->imag[k] = self->outframe[self->size - k];
+    }
+
+    for (k=0; k<self->hsize; k++) {
+        real = self->real[k];
+        imag = self->imag[k];
+        mag = MYSQRT(real*real + imag*imag);
+        phase = MYATAN2(imag, real);
+        tmp = phase - self->lastPhase[k];
+        self->lastPhase[k] = phase;
+        while (tmp > PI) tmp -= TWOPI;
+        while (tmp < -PI) tmp += TWOPI;
+        magn[k] = mag;
+        freq[k] = (tmp + k * self->scale) * self->factor;
+    }
+}
+
+static void
+PVAnal_job(void *data) {
+    PVAnal *self = (PVAnal *)data;
+    PVAnal_analyse(self, self->job_buffer, self->job_mod, self->job_magn, self->job_freq);
 }
 
 static void
 PVAnal_process(PVAnal *self) {
     int i, k, mod;
-    MYFLT real, imag, mag, phase, tmp;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
     for (i=0; i<self->bufsize; i++) {
@@ -121,29 +161,17 @@ PVAnal_process(PVAnal *self) {
         if (self->incount >= self->size) {
             self->incount = self->inputLatency;
             mod = self->hopsize * self->overcount;
-            for (k=0; k<self->size; k++) {
-                self->inframe[(k+mod)%self->size] = self->input_buffer[k] * self->window[k];
-            }
-            realfft_split(self->inframe, self->outframe, self->size, self->twiddle);
-            self->real[0] = self->outframe[0];
-            self->imag[0] = 0.0;
-            for (k=1; k<self->hsize; k++) {
-                self->real[k] = self->outframe[k];
-                self->imag[k] = self->outframe[self->size - k];
-            }
-
-            for (k=0; k<self->hsize; k++) {
-                real = self->real[k];
-                imag = self->imag[k];
-                mag = MYSQRT(real*real + imag*imag);
-                phase = MYATAN2(imag, real);
-                tmp = phase - self->lastPhase[k];
-                self->lastPhase[k] = phase;
-                while (tmp > PI) tmp -= TWOPI;
-                while (tmp < -PI) tmp += TWOPI;
-                self->magn[self->overcount][k] = mag;
-                self->freq[self->overcount][k] = (tmp + k * self->scale) * self->factor;
+            if (self->helper != NULL) {
+                /* Publishes the frame analysed during the last hop and posts this one. */
+                HelperThread_wait(self->helper);
+                memcpy(self->magn[self->overcount], self->job_magn, self->hsize * sizeof(MYFLT));
+                memcpy(self->freq[self->overcount], self->job_freq, self->hsize * sizeof(MYFLT));
+                memcpy(self->job_buffer, self->input_buffer, self->size * sizeof(MYFLT));
+                self->job_mod = mod;
+                HelperThread_post(self->helper);
             }
+            else
+                PVAnal_analyse(self, self->input_buffer, mod, self->magn[self->overcount], self->freq[self->overcount]);
             for (k=0; k<self->inputLatency; k++) {
                 self->input_buffer[k] = self->input_buffer[k + self->hopsize];
             }
@@ -163,6 +191,7 @@ PVAnal_setProcMode(PVAnal *self)
 static void
 PVAnal_compute_next_data_frame(PVAnal *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -189,25 +218,19 @@ PVAnal_clear(PVAnal *self)
 static void
 PVAnal_dealloc(PVAnal* self)
 {
-    int i;
     pyo_DEALLOC
+    HelperThread_free(self->helper);
     free(self->input_buffer);
     free(self->inframe);
     free(self->outframe);
     free(self->real);
     free(self->imag);
     free(self->lastPhase);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    free(self->window);
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
+    free(self->job_buffer);
+    free(self->job_magn);
+    free(self->job_freq);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->window);
     free(self->count);
     PVAnal_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -307,8 +330,32 @@ static PyObject *
 PVAnal_setWinType(PVAnal *self, PyObject *arg)
 {
     if (PyLong_Check(arg) || PyInt_Check(arg)) {
+        if (self->helper != NULL)
+            HelperThread_wait(self->helper);
         self->wintype = PyInt_AsLong(arg);
-        gen_window(self->window, self->size, self->wintype);
+        fft_release_table(self->window);
+        self->window = fft_acquire_window(self->size, self->wintype);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+PVAnal_setThreaded(PVAnal *self, PyObject *arg)
+{
+    int i;
+
+    if (PyObject_IsTrue(arg) && self->helper == NULL) {
+        for (i=0; i<self->hsize; i++)
+            self->job_magn[i] = self->job_freq[i] = 0.0;
+        self->helper = HelperThread_new(PVAnal_job, (void *)self);
+        if (self->helper == NULL)
+            printf("PVAnal warning : unable to start the helper thread.\n");
+    }
+    else if (!PyObject_IsTrue(arg) && self->helper != NULL) {
+        HelperThread_free(self->helper);
+        self->helper = NULL;
     }
 
     Py_INCREF(Py_None);
@@ -332,6 +379,7 @@ static PyMethodDef PVAnal_methods[] = {
 {"setSize", (PyCFunction)PVAnal_setSize, METH_O, "Sets a new FFT size."},
 {"setOverlaps", (PyCFunction)PVAnal_setOverlaps, METH_O, "Sets a new number of overlaps."},
 {"setWinType", (PyCFunction)PVAnal_setWinType, METH_O, "Sets a new window type."},
+{"setThreaded", (PyCFunction)PVAnal_setThreaded, METH_O, "Computes the frames on a helper thread, one hop later."},
 {NULL}  /* Sentinel */
 };
 
@@ -403,14 +451,21 @@ typedef struct {
     MYFLT *imag;
     MYFLT *sumPhase;
     MYFLT **twiddle;
-    MYFLT *window;
+    const MYFLT *window;
+    HelperThread *helper; /* computes the frames one hop late when not NULL */
+    int job_mod;
+    MYFLT *job_magn;
+    MYFLT *job_freq;
+    MYFLT *job_frame;
     int modebuffer[2]; // need at least 2 slots for mul & add
 } PVSynth;
 
 
 static void
 PVSynth_realloc_memories(PVSynth *self) {
-    int i, n8;
+    int i;
+    if (self->helper != NULL)
+        HelperThread_wait(self->helper);
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     self->factor = self->hopsize * TWOPI / self->sr;
@@ -418,7 +473,6 @@ PVSynth_realloc_memories(PVSynth *self) {
     self->inputLatency = self->size - self->hopsize;
     self->overcount = 0;
     self->ampscl = 1.0 / MYSQRT(self->olaps);
-    n8 = self->size >> 3;
     self->output_buffer = (MYFLT *)realloc(self->output_buffer, self->size * sizeof(MYFLT));
     self->inframe = (MYFLT *)realloc(self->inframe, self->size * sizeof(MYFLT));
     self->outframe = (MYFLT *)realloc(self->outframe, self->size * sizeof(MYFLT));
@@ -432,18 +486,57 @@ PVSynth_realloc_memories(PVSynth *self) {
     self->outputAccum = (MYFLT *)realloc(self->outputAccum, (self->size+self->hopsize) * sizeof(MYFLT));
     for (i=0; i<(self->size+self->hopsize); i++)
         self->outputAccum[i] = 0.0;
-    self->twiddle = (MYFLT **)realloc(self->twiddle, 4 * sizeof(MYFLT *));
-    for(i=0; i<4; i++)
-        self->twiddle[i] = (MYFLT *)malloc(n8 * sizeof(MYFLT));
-    fft_compute_split_twiddle(self->twiddle, self->size);
-    self->window = (MYFLT *)realloc(self->window, self->size * sizeof(MYFLT));
-    gen_window(self->window, self->size, self->wintype);
+    self->job_magn = (MYFLT *)realloc(self->job_magn, self->hsize * sizeof(MYFLT));
+    self->job_freq = (MYFLT *)realloc(self->job_freq, self->hsize * sizeof(MYFLT));
+    self->job_frame = (MYFLT *)realloc(self->job_frame, self->size * sizeof(MYFLT));
+    for (i=0; i<self->size; i++)
+        self->job_frame[i] = 0.0;
+    fft_release_table(self->twiddle);
+    self->twiddle = fft_acquire_split_twiddle(self->size);
+    fft_release_table(self->window);
+    self->window = fft_acquire_window(self->size, self->wintype);
+    Stream_setMemory(self->stream, (5 * self->size + self->hopsize + 5 * self->hsize) * sizeof(MYFLT));
+}
+
+/* Resynthesizes the frame given by `magn` and `freq` into outframe. */
+static void
+PVSynth_synthesize(PVSynth *self, MYFLT *magn, MYFLT *freq) {
+    int k;
+    MYFLT mag, phase, tmp;
+
+    for (k=0; k<self->hsize; k++) {
+        mag = magn[k];
+        tmp = freq[k];
+        tmp = (tmp - k * self->scale) * self->factor;
+        self->sumPhase[k] += tmp;
+        phase = self->sumPhase[k];
+        self->real[k] = mag * MYCOS(phase);
+        self->imag[k] = mag * MYSIN(phase);
+    }
+
+    self->inframe[0] = self->real[0];
+    self->inframe[self->hsize] = 0.0;
+    for (k=1; k<self->hsize; k++) {
+        self->inframe[k] = self->real[k];
+        self->inframe[self->size - k] = self->imag[k];
+    }
+    irealfft_split(self->inframe, self->outframe, self->size, self->twiddle);
+}
+
+static void
+PVSynth_job(void *data) {
+    int k;
+    PVSynth *self = (PVSynth *)data;
+
+    PVSynth_synthesize(self, self->job_magn, self->job_freq);
+    for (k=0; k<self->size; k++) {
+        self->job_frame[k] = self->outframe[(k+self->job_mod)%self->size] * self->window[k] * self->ampscl;
+    }
 }
 
 static void
 PVSynth_process(PVSynth *self) {
     int i, k, mod;
-    MYFLT mag, phase, tmp;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -459,26 +552,23 @@ PVSynth_process(PVSynth *self) {
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = self->output_buffer[count[i] - self->inputLatency];
         if (count[i] >= (self->size-1)) {
-            for (k=0; k<self->hsize; k++) {
-                mag = magn[self->overcount][k];
-                tmp = freq[self->overcount][k];
-                tmp = (tmp - k * self->scale) * self->factor;
-                self->sumPhase[k] += tmp;
-                phase = self->sumPhase[k];
-                self->real[k] = mag * MYCOS(phase);
-                self->imag[k] = mag * MYSIN(phase);
-            }
-
-            self->inframe[0] = self->real[0];
-            self->inframe[self->hsize] = 0.0;
-            for (k=1; k<self->hsize; k++) {
-                self->inframe[k] = self->real[k];
-                self->inframe[self->size - k] = self->imag[k];
-            }
-            irealfft_split(self->inframe, self->outframe, self->size, self->twiddle);
             mod = self->hopsize * self->overcount;
-            for (k=0; k<self->size; k++) {
-                self->outputAccum[k] += self->outframe[(k+mod)%self->size] * self->window[k] * self->ampscl;
+            if (self->helper != NULL) {
+                /* Overlap-adds the frame synthesized during the last hop and posts this one. */
+                HelperThread_wait(self->helper);
+                for (k=0; k<self->size; k++) {
+                    self->outputAccum[k] += self->job_frame[k];
+                }
+                memcpy(self->job_magn, magn[self->overcount], self->hsize * sizeof(MYFLT));
+                memcpy(self->job_freq, freq[self->overcount], self->hsize * sizeof(MYFLT));
+                self->job_mod = mod;
+                HelperThread_post(self->helper);
+            }
+            else {
+                PVSynth_synthesize(self, magn[self->overcount], freq[self->overcount]);
+                for (k=0; k<self->size; k++) {
+                    self->outputAccum[k] += self->outframe[(k+mod)%self->size] * self->window[k] * self->ampscl;
+                }
             }
             for (k=0; k<self->hopsize; k++) {
                 self->output_buffer[k] = self->outputAccum[k];
@@ -572,8 +662,8 @@ PVSynth_clear(PVSynth *self)
 static void
 PVSynth_dealloc(PVSynth* self)
 {
-    int i;
     pyo_DEALLOC
+    HelperThread_free(self->helper);
     free(self->output_buffer);
     free(self->outputAccum);
     free(self->inframe);
@@ -581,11 +671,11 @@ PVSynth_dealloc(PVSynth* self)
     free(self->real);
     free(self->imag);
     free(self->sumPhase);
-    for(i=0; i<4; i++) {
-        free(self->twiddle[i]);
-    }
-    free(self->twiddle);
-    free(self->window);
+    free(self->job_magn);
+    free(self->job_freq);
+    free(self->job_frame);
+    fft_release_table(self->twiddle);
+    fft_release_table(self->window);
     PVSynth_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -619,7 +709,6 @@ PVSynth_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -658,7 +747,6 @@ PVSynth_setInput(PVSynth *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -670,8 +758,32 @@ static PyObject *
 PVSynth_setWinType(PVSynth *self, PyObject *arg)
 {
     if (PyLong_Check(arg) || PyInt_Check(arg)) {
+        if (self->helper != NULL)
+            HelperThread_wait(self->helper);
         self->wintype = PyInt_AsLong(arg);
-        gen_window(self->window, self->size, self->wintype);
+        fft_release_table(self->window);
+        self->window = fft_acquire_window(self->size, self->wintype);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+PVSynth_setThreaded(PVSynth *self, PyObject *arg)
+{
+    int i;
+
+    if (PyObject_IsTrue(arg) && self->helper == NULL) {
+        for (i=0; i<self->size; i++)
+            self->job_frame[i] = 0.0;
+        self->helper = HelperThread_new(PVSynth_job, (void *)self);
+        if (self->helper == NULL)
+            printf("PVSynth warning : unable to start the helper thread.\n");
+    }
+    else if (!PyObject_IsTrue(arg) && self->helper != NULL) {
+        HelperThread_free(self->helper);
+        self->helper = NULL;
     }
 
     Py_INCREF(Py_None);
@@ -718,6 +830,7 @@ static PyMethodDef PVSynth_methods[] = {
 {"stop", (PyCFunction)PVSynth_stop, METH_NOARGS, "Stops computing."},
 {"setInput", (PyCFunction)PVSynth_setInput, METH_O, "Sets a new input object."},
 {"setWinType", (PyCFunction)PVSynth_setWinType, METH_O, "Sets a new window type."},
+{"setThreaded", (PyCFunction)PVSynth_setThreaded, METH_O, "Computes the frames on a helper thread, one hop later."},
 {"setMul", (PyCFunction)PVSynth_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)PVSynth_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)PVSynth_setSub, METH_O, "Sets inverse add factor."},
@@ -828,9 +941,8 @@ typedef struct {
     int first;
     int inc;
     int update;
-    MYFLT *ppos;
-    MYFLT *amp;
-    MYFLT *freq;
+    int quadrature;
+    OscArray *osc;
     MYFLT *outbuf;
     MYFLT *table;
     int modebuffer[3]; // need at least 2 slots for mul & add
@@ -843,22 +955,24 @@ PVAddSynth_realloc_memories(PVAddSynth *self) {
     self->hopsize = self->size / self->olaps;
     self->inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->ppos = (MYFLT *)realloc(self->ppos, self->num * sizeof(MYFLT));
-    self->amp = (MYFLT *)realloc(self->amp, self->num * sizeof(MYFLT));
-    self->freq = (MYFLT *)realloc(self->freq, self->num * sizeof(MYFLT));
+    OscArray_resize(self->osc, self->num);
+    OscArray_resetPhases(self->osc);
     for (i=0; i<self->num; i++) {
-        self->ppos[i] = self->amp[i] = 0.0;
-        self->freq[i] = (i * self->inc + self->first) * self->size / self->sr;
+        self->osc->amp[i] = self->osc->damp[i] = self->osc->dinc[i] = 0.0;
+        self->osc->inc[i] = (i * self->inc + self->first) * self->size / self->sr * 8192.0 / self->sr;
+        /* Oscillators read at the position of their next sample. */
+        self->osc->pos[i] = self->osc->inc[i] - MYFLOOR(self->osc->inc[i] / 8192.0) * 8192.0;
     }
     self->outbuf = (MYFLT *)realloc(self->outbuf, self->hopsize * sizeof(MYFLT));
     for (i=0; i<self->hopsize; i++)
         self->outbuf[i] = 0.0;
+    Stream_setMemory(self->stream, self->hopsize * sizeof(MYFLT) + OscArray_getMemory(self->osc));
 }
 
 static void
 PVAddSynth_process_i(PVAddSynth *self) {
-    int i, k, n, bin, ipart;
-    MYFLT pitch, tamp, tfreq, inca, incf, ratio, fpart;
+    int i, k, n, bin;
+    MYFLT pitch, tamp, tfreq, ratio;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -872,6 +986,8 @@ PVAddSynth_process_i(PVAddSynth *self) {
         self->update = 0;
         PVAddSynth_realloc_memories(self);
     }
+    if (self->quadrature != self->osc->quadrature)
+        OscArray_setQuadrature(self->osc, self->quadrature, 8192);
 
     ratio = 8192.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
@@ -880,25 +996,17 @@ PVAddSynth_process_i(PVAddSynth *self) {
             for (n=0; n<self->hopsize; n++) {
                 self->outbuf[n] = 0.0;
             }
+            /* The synthesized bins are a prefix of the oscillators. */
             for (k=0; k<self->num; k++) {
                 bin = k * self->inc + self->first;
-                if (bin < self->hsize) {
-                    tamp = magn[self->overcount][bin];
-                    tfreq = freq[self->overcount][bin] * pitch;
-                    inca = (tamp - self->amp[k]) / self->hopsize;
-                    incf = (tfreq - self->freq[k]) / self->hopsize;
-                    for (n=0; n<self->hopsize; n++) {
-                        self->ppos[k] += self->freq[k] * ratio;
-                        while (self->ppos[k] < 0.0) self->ppos[k] += 8192.0;
-                        while (self->ppos[k] >= 8192.0) self->ppos[k] -= 8192.0;
-                        ipart = (int)self->ppos[k];
-                        fpart = self->ppos[k] - ipart;
-                        self->outbuf[n] += self->amp[k] * (self->table[ipart] + (self->table[ipart+1] - self->table[ipart]) * fpart);
-                        self->amp[k] += inca;
-                        self->freq[k] += incf;
-                    }
-                }
+                if (bin >= self->hsize)
+                    break;
+                tamp = magn[self->overcount][bin];
+                tfreq = freq[self->overcount][bin] * pitch * ratio;
+                self->osc->damp[k] = (tamp - self->osc->amp[k]) / self->hopsize;
+                self->osc->dinc[k] = (tfreq - self->osc->inc[k]) / self->hopsize;
             }
+            OscArray_process(self->osc, self->outbuf, self->hopsize, k, self->table, 8192);
             self->overcount++;
             if (self->overcount >= self->olaps)
                 self->overcount = 0;
@@ -908,8 +1016,8 @@ PVAddSynth_process_i(PVAddSynth *self) {
 
 static void
 PVAddSynth_process_a(PVAddSynth *self) {
-    int i, k, n, bin, ipart;
-    MYFLT pitch, tamp, tfreq, inca, incf, ratio, fpart;
+    int i, k, n, bin;
+    MYFLT pitch, tamp, tfreq, ratio;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -923,6 +1031,8 @@ PVAddSynth_process_a(PVAddSynth *self) {
         self->update = 0;
         PVAddSynth_realloc_memories(self);
     }
+    if (self->quadrature != self->osc->quadrature)
+        OscArray_setQuadrature(self->osc, self->quadrature, 8192);
 
     ratio = 8192.0 / self->sr;
     for (i=0; i<self->bufsize; i++) {
@@ -932,25 +1042,17 @@ PVAddSynth_process_a(PVAddSynth *self) {
             for (n=0; n<self->hopsize; n++) {
                 self->outbuf[n] = 0.0;
             }
+            /* The synthesized bins are a prefix of the oscillators. */
             for (k=0; k<self->num; k++) {
                 bin = k * self->inc + self->first;
-                if (bin < self->hsize) {
-                    tamp = magn[self->overcount][bin];
-                    tfreq = freq[self->overcount][bin] * pitch;
-                    inca = (tamp - self->amp[k]) / self->hopsize;
-                    incf = (tfreq - self->freq[k]) / self->hopsize;
-                    for (n=0; n<self->hopsize; n++) {
-                        self->ppos[k] += self->freq[k] * ratio;
-                        while (self->ppos[k] < 0.0) self->ppos[k] += 8192.0;
-                        while (self->ppos[k] >= 8192.0) self->ppos[k] -= 8192.0;
-                        ipart = (int)self->ppos[k];
-                        fpart = self->ppos[k] - ipart;
-                        self->outbuf[n] += self->amp[k] * (self->table[ipart] + (self->table[ipart+1] - self->table[ipart]) * fpart);
-                        self->amp[k] += inca;
-                        self->freq[k] += incf;
-                    }
-                }
+                if (bin >= self->hsize)
+                    break;
+                tamp = magn[self->overcount][bin];
+                tfreq = freq[self->overcount][bin] * pitch * ratio;
+                self->osc->damp[k] = (tamp - self->osc->amp[k]) / self->hopsize;
+                self->osc->dinc[k] = (tfreq - self->osc->inc[k]) / self->hopsize;
             }
+            OscArray_process(self->osc, self->outbuf, self->hopsize, k, self->table, 8192);
             self->overcount++;
             if (self->overcount >= self->olaps)
                 self->overcount = 0;
@@ -1047,11 +1149,9 @@ static void
 PVAddSynth_dealloc(PVAddSynth* self)
 {
     pyo_DEALLOC
-    free(self->ppos);
+    OscArray_free(self->osc);
     free(self->outbuf);
     free(self->table);
-    free(self->amp);
-    free(self->freq);
     PVAddSynth_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1069,6 +1169,7 @@ PVAddSynth_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->first = 0;
     self->inc = 1;
     self->update = 0;
+    self->quadrature = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -1090,7 +1191,6 @@ PVAddSynth_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -1116,6 +1216,7 @@ PVAddSynth_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->table[i] = (MYFLT)(MYSIN(TWOPI * i / 8192.0));
     self->table[8192] = 0.0;
 
+    self->osc = OscArray_new(self->num);
     PVAddSynth_realloc_memories(self);
 
     (*self->mode_func_ptr)(self);
@@ -1138,7 +1239,6 @@ PVAddSynth_setInput(PVAddSynth *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -1228,6 +1328,17 @@ PVAddSynth_setInc(PVAddSynth *self, PyObject *arg)
     return Py_None;
 }
 
+static PyObject *
+PVAddSynth_setQuadrature(PVAddSynth *self, PyObject *arg)
+{
+    if (PyLong_Check(arg) || PyInt_Check(arg)) {
+        self->quadrature = PyInt_AsLong(arg) != 0;
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject * PVAddSynth_getServer(PVAddSynth* self) { GET_SERVER };
 static PyObject * PVAddSynth_getStream(PVAddSynth* self) { GET_STREAM };
 static PyObject * PVAddSynth_setMul(PVAddSynth *self, PyObject *arg) { SET_MUL };
@@ -1269,6 +1380,7 @@ static PyMethodDef PVAddSynth_methods[] = {
 {"setNum", (PyCFunction)PVAddSynth_setNum, METH_O, "Sets the number of oscillators."},
 {"setFirst", (PyCFunction)PVAddSynth_setFirst, METH_O, "Sets the first bin to synthesize."},
 {"setInc", (PyCFunction)PVAddSynth_setInc, METH_O, "Sets the synthesized bin increment."},
+{"setQuadrature", (PyCFunction)PVAddSynth_setQuadrature, METH_O, "Sets the oscillator mode, table lookup or quadrature."},
 {"setMul", (PyCFunction)PVAddSynth_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)PVAddSynth_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)PVAddSynth_setSub, METH_O, "Sets inverse add factor."},
@@ -1383,26 +1495,18 @@ typedef struct {
 
 static void
 PVTranspose_realloc_memories(PVTranspose *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -1501,6 +1605,7 @@ PVTranspose_setProcMode(PVTranspose *self)
 static void
 PVTranspose_compute_next_data_frame(PVTranspose *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -1531,14 +1636,7 @@ PVTranspose_clear(PVTranspose *self)
 static void
 PVTranspose_dealloc(PVTranspose* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVTranspose_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -1572,7 +1670,6 @@ PVTranspose_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -1618,7 +1715,6 @@ PVTranspose_setInput(PVTranspose *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -1749,7 +1845,7 @@ typedef struct {
 
 static void
 PVVerb_realloc_memories(PVVerb *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
@@ -1758,21 +1854,13 @@ PVVerb_realloc_memories(PVVerb *self) {
     self->l_freq = (MYFLT *)realloc(self->l_freq, self->hsize * sizeof(MYFLT));
     for (i=0; i<self->hsize; i++)
         self->l_magn[i] = self->l_freq[i] = 0.0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, 2 * self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -1802,6 +1890,7 @@ PVVerb_process_ii(PVVerb *self) {
         self->olaps = olaps;
         PVVerb_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -1849,6 +1938,7 @@ PVVerb_process_ai(PVVerb *self) {
         self->olaps = olaps;
         PVVerb_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -1902,6 +1992,7 @@ PVVerb_process_ia(PVVerb *self) {
         self->olaps = olaps;
         PVVerb_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -1950,6 +2041,7 @@ PVVerb_process_aa(PVVerb *self) {
         self->olaps = olaps;
         PVVerb_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -2034,6 +2126,8 @@ PVVerb_clear(PVVerb *self)
 {
     pyo_CLEAR
     Py_CLEAR(self->input);
+    if (self->pv_stream != NULL)
+        PVStream_shareFrames(self->pv_stream, NULL);
     Py_CLEAR(self->input_stream);
     Py_CLEAR(self->pv_stream);
     Py_CLEAR(self->revtime);
@@ -2046,14 +2140,7 @@ PVVerb_clear(PVVerb *self)
 static void
 PVVerb_dealloc(PVVerb* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->l_magn);
     free(self->l_freq);
     free(self->count);
@@ -2090,7 +2177,6 @@ PVVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -2140,7 +2226,7 @@ PVVerb_setInput(PVVerb *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
+    PVStream_shareFrames(self->pv_stream, NULL);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -2305,26 +2391,18 @@ typedef struct {
 
 static void
 PVGate_realloc_memories(PVGate *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -2345,6 +2423,7 @@ PVGate_process_ii(PVGate *self) {
         self->olaps = olaps;
         PVGate_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -2381,6 +2460,7 @@ PVGate_process_ai(PVGate *self) {
         self->olaps = olaps;
         PVGate_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -2420,6 +2500,7 @@ PVGate_process_ia(PVGate *self) {
         self->olaps = olaps;
         PVGate_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -2457,6 +2538,7 @@ PVGate_process_aa(PVGate *self) {
         self->olaps = olaps;
         PVGate_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -2526,6 +2608,8 @@ PVGate_clear(PVGate *self)
 {
     pyo_CLEAR
     Py_CLEAR(self->input);
+    if (self->pv_stream != NULL)
+        PVStream_shareFrames(self->pv_stream, NULL);
     Py_CLEAR(self->input_stream);
     Py_CLEAR(self->pv_stream);
     Py_CLEAR(self->thresh);
@@ -2538,14 +2622,7 @@ PVGate_clear(PVGate *self)
 static void
 PVGate_dealloc(PVGate* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVGate_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -2580,7 +2657,6 @@ PVGate_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -2630,7 +2706,7 @@ PVGate_setInput(PVGate *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
+    PVStream_shareFrames(self->pv_stream, NULL);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -2795,26 +2871,18 @@ typedef struct {
 
 static void
 PVCross_realloc_memories(PVCross *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -2901,6 +2969,7 @@ PVCross_setProcMode(PVCross *self)
 static void
 PVCross_compute_next_data_frame(PVCross *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -2935,14 +3004,7 @@ PVCross_clear(PVCross *self)
 static void
 PVCross_dealloc(PVCross* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVCross_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -2976,7 +3038,6 @@ PVCross_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -2988,7 +3049,6 @@ PVCross_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input2);
     self->input2 = input2tmp;
     input2_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input2_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input2_streamtmp;
 
@@ -3034,7 +3094,6 @@ PVCross_setInput(PVCross *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -3057,7 +3116,6 @@ PVCross_setInput2(PVCross *self, PyObject *arg)
     Py_XDECREF(self->input2);
     self->input2 = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input_streamtmp;
 
@@ -3185,26 +3243,18 @@ typedef struct {
 
 static void
 PVMult_realloc_memories(PVMult *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -3246,6 +3296,7 @@ PVMult_setProcMode(PVMult *self)
 static void
 PVMult_compute_next_data_frame(PVMult *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -3276,14 +3327,7 @@ PVMult_clear(PVMult *self)
 static void
 PVMult_dealloc(PVMult* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVMult_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -3316,7 +3360,6 @@ PVMult_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -3328,7 +3371,6 @@ PVMult_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input2);
     self->input2 = input2tmp;
     input2_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input2_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input2_streamtmp;
 
@@ -3370,7 +3412,6 @@ PVMult_setInput(PVMult *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -3393,7 +3434,6 @@ PVMult_setInput2(PVMult *self, PyObject *arg)
     Py_XDECREF(self->input2);
     self->input2 = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input_streamtmp;
 
@@ -3488,26 +3528,18 @@ typedef struct {
 
 static void
 PVMorph_realloc_memories(PVMorph *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -3604,6 +3636,7 @@ PVMorph_setProcMode(PVMorph *self)
 static void
 PVMorph_compute_next_data_frame(PVMorph *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -3638,14 +3671,7 @@ PVMorph_clear(PVMorph *self)
 static void
 PVMorph_dealloc(PVMorph* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVMorph_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -3679,7 +3705,6 @@ PVMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -3691,7 +3716,6 @@ PVMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input2);
     self->input2 = input2tmp;
     input2_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input2_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input2_streamtmp;
 
@@ -3737,7 +3761,6 @@ PVMorph_setInput(PVMorph *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -3760,7 +3783,6 @@ PVMorph_setInput2(PVMorph *self, PyObject *arg)
     Py_XDECREF(self->input2);
     self->input2 = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input_streamtmp;
 
@@ -3891,26 +3913,18 @@ typedef struct {
 
 static void
 PVFilter_realloc_memories(PVFilter *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -3935,6 +3949,7 @@ PVFilter_process_i(PVFilter *self) {
         self->olaps = olaps;
         PVFilter_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     factor = (MYFLT)tsize / self->hsize;
 
@@ -3987,6 +4002,7 @@ PVFilter_process_a(PVFilter *self) {
         self->olaps = olaps;
         PVFilter_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     factor = (MYFLT)tsize / self->hsize;
 
@@ -4066,6 +4082,8 @@ PVFilter_clear(PVFilter *self)
 {
     pyo_CLEAR
     Py_CLEAR(self->input);
+    if (self->pv_stream != NULL)
+        PVStream_shareFrames(self->pv_stream, NULL);
     Py_CLEAR(self->input_stream);
     Py_CLEAR(self->pv_stream);
     Py_CLEAR(self->gain);
@@ -4077,14 +4095,7 @@ PVFilter_clear(PVFilter *self)
 static void
 PVFilter_dealloc(PVFilter* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVFilter_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -4120,7 +4131,6 @@ PVFilter_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -4169,7 +4179,7 @@ PVFilter_setInput(PVFilter *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
+    PVStream_shareFrames(self->pv_stream, NULL);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -4354,14 +4364,9 @@ PVDelay_realloc_memories(PVDelay *self) {
     self->numFrames = (int)(self->maxdelay * self->sr / self->hopsize + 0.5);
     self->overcount = 0;
     self->framecount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     self->magn_buf = (MYFLT **)realloc(self->magn_buf, self->numFrames * sizeof(MYFLT *));
     self->freq_buf = (MYFLT **)realloc(self->freq_buf, self->numFrames * sizeof(MYFLT *));
     for (i=0; i<self->numFrames; i++) {
@@ -4372,11 +4377,8 @@ PVDelay_realloc_memories(PVDelay *self) {
     }
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, 2 * (size_t)self->numFrames * self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -4524,6 +4526,7 @@ PVDelay_setProcMode(PVDelay *self)
 static void
 PVDelay_compute_next_data_frame(PVDelay *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -4556,12 +4559,6 @@ PVDelay_dealloc(PVDelay* self)
 {
     int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     for(i=0; i<self->numFrames; i++) {
         free(self->magn_buf[i]);
         free(self->freq_buf[i]);
@@ -4602,7 +4599,6 @@ PVDelay_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -4651,7 +4647,6 @@ PVDelay_setInput(PVDelay *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -4819,6 +4814,7 @@ typedef struct {
     MYFLT **freq;
     MYFLT **magn_buf;
     MYFLT **freq_buf;
+    PVFile *file; /* when set, frames are read from the file instead */
     int *count;
     int modebuffer[1];
 } PVBuffer;
@@ -4832,14 +4828,9 @@ PVBuffer_realloc_memories(PVBuffer *self) {
     self->numFrames = (int)(self->length * self->sr / self->hopsize + 0.5);
     self->overcount = 0;
     self->framecount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     self->magn_buf = (MYFLT **)realloc(self->magn_buf, self->numFrames * sizeof(MYFLT *));
     self->freq_buf = (MYFLT **)realloc(self->freq_buf, self->numFrames * sizeof(MYFLT *));
     for (i=0; i<self->numFrames; i++) {
@@ -4850,17 +4841,64 @@ PVBuffer_realloc_memories(PVBuffer *self) {
     }
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    if (self->file != NULL && (self->file->fftsize != self->size || self->file->olaps != self->olaps)) {
+        printf("PVBuffer warning : input size or overlaps differ from the analysis file, file unloaded.\n");
+        PVFile_close(self->file);
+        self->file = NULL;
+    }
+    Stream_setMemory(self->stream, 2 * (size_t)self->numFrames * self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
+}
+
+static void
+PVBuffer_readFrame(PVBuffer *self, MYFLT index, MYFLT pitch) {
+    int k, indexi;
+    long frame, numFrames;
+    MYFLT *magn = self->magn[self->overcount];
+    MYFLT *freq = self->freq[self->overcount];
+    float *fmagn, *ffreq;
+
+    for (k=0; k<self->hsize; k++)
+        magn[k] = freq[k] = 0.0;
+
+    if (index < 0.0)
+        index = 0.0;
+    else if (index >= 1.0)
+        index = 1.0;
+
+    if (self->file != NULL) {
+        numFrames = self->file->numFrames;
+        frame = (long)(index * numFrames);
+        if (frame >= numFrames)
+            frame = numFrames - 1;
+        fmagn = PVFile_getMagn(self->file, frame);
+        ffreq = PVFile_getFreq(self->file, frame);
+        for (k=0; k<self->hsize; k++) {
+            indexi = (int)(k * pitch);
+            if (indexi < self->hsize) {
+                magn[indexi] += fmagn[k];
+                freq[indexi] = ffreq[k] * pitch;
+            }
+        }
+    }
+    else {
+        frame = (long)(index * self->numFrames);
+        if (frame >= self->numFrames)
+            frame = self->numFrames - 1;
+        for (k=0; k<self->hsize; k++) {
+            indexi = (int)(k * pitch);
+            if (indexi < self->hsize) {
+                magn[indexi] += self->magn_buf[frame][k];
+                freq[indexi] = self->freq_buf[frame][k] * pitch;
+            }
+        }
+    }
 }
 
 static void
 PVBuffer_process_i(PVBuffer *self) {
-    int i, k, frame, indexi;
-    MYFLT index, pitch;
+    int i, k;
+    MYFLT pitch;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -4878,30 +4916,14 @@ PVBuffer_process_i(PVBuffer *self) {
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
         if (count[i] >= (self->size-1)) {
-            if (self->framecount < self->numFrames) {
+            if (self->file == NULL && self->framecount < self->numFrames) {
                 for (k=0; k<self->hsize; k++) {
                     self->magn_buf[self->framecount][k] = magn[self->overcount][k];
                     self->freq_buf[self->framecount][k] = freq[self->overcount][k];
                 }
                 self->framecount++;
             }
-            for (k=0; k<self->hsize; k++) {
-                self->magn[self->overcount][k] = 0.0;
-                self->freq[self->overcount][k] = 0.0;
-            }
-            index = ind[i];
-            if (index < 0.0)
-                index = 0.0;
-            else if (index >= 1.0)
-                index = 1.0;
-            frame = (int)(index * self->numFrames);
-            for (k=0; k<self->hsize; k++) {
-                indexi = (int)(k * pitch);
-                if (indexi < self->hsize) {
-                    self->magn[self->overcount][indexi] += self->magn_buf[frame][k];
-                    self->freq[self->overcount][indexi] = self->freq_buf[frame][k] * pitch;
-                }
-            }
+            PVBuffer_readFrame(self, ind[i], pitch);
             self->overcount++;
             if (self->overcount >= self->olaps)
                 self->overcount = 0;
@@ -4911,8 +4933,7 @@ PVBuffer_process_i(PVBuffer *self) {
 
 static void
 PVBuffer_process_a(PVBuffer *self) {
-    int i, k, frame, indexi;
-    MYFLT index, pitch;
+    int i, k;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -4930,31 +4951,14 @@ PVBuffer_process_a(PVBuffer *self) {
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
         if (count[i] >= (self->size-1)) {
-            if (self->framecount < self->numFrames) {
+            if (self->file == NULL && self->framecount < self->numFrames) {
                 for (k=0; k<self->hsize; k++) {
                     self->magn_buf[self->framecount][k] = magn[self->overcount][k];
                     self->freq_buf[self->framecount][k] = freq[self->overcount][k];
                 }
                 self->framecount++;
             }
-            for (k=0; k<self->hsize; k++) {
-                self->magn[self->overcount][k] = 0.0;
-                self->freq[self->overcount][k] = 0.0;
-            }
-            index = ind[i];
-            pitch = pit[i];
-            if (index < 0.0)
-                index = 0.0;
-            else if (index >= 1.0)
-                index = 1.0;
-            frame = (int)(index * self->numFrames);
-            for (k=0; k<self->hsize; k++) {
-                indexi = (int)(k * pitch);
-                if (indexi < self->hsize) {
-                    self->magn[self->overcount][indexi] += self->magn_buf[frame][k];
-                    self->freq[self->overcount][indexi] = self->freq_buf[frame][k] * pitch;
-                }
-            }
+            PVBuffer_readFrame(self, ind[i], pit[i]);
             self->overcount++;
             if (self->overcount >= self->olaps)
                 self->overcount = 0;
@@ -4980,6 +4984,7 @@ PVBuffer_setProcMode(PVBuffer *self)
 static void
 PVBuffer_compute_next_data_frame(PVBuffer *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -5016,12 +5021,6 @@ PVBuffer_dealloc(PVBuffer* self)
 {
     int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     for(i=0; i<self->numFrames; i++) {
         free(self->magn_buf[i]);
         free(self->freq_buf[i]);
@@ -5029,6 +5028,7 @@ PVBuffer_dealloc(PVBuffer* self)
     free(self->magn_buf);
     free(self->freq_buf);
     free(self->count);
+    PVFile_close(self->file);
     PVBuffer_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -5062,7 +5062,6 @@ PVBuffer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -5116,7 +5115,6 @@ PVBuffer_setInput(PVBuffer *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -5187,6 +5185,79 @@ PVBuffer_setPitch(PVBuffer *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+PVBuffer_save(PVBuffer *self, PyObject *arg)
+{
+    int i;
+    char *path;
+    PVFileWriter *writer;
+
+    if (! PyString_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "PVBuffer save() argument must be a string.\n");
+        return NULL;
+    }
+    path = PyString_AsString(arg);
+
+    if (self->file != NULL) {
+        printf("PVBuffer warning : frames are read from an analysis file, nothing to save.\n");
+        Py_RETURN_NONE;
+    }
+
+    writer = PVFileWriter_new(path, self->size, self->olaps, self->sr);
+    if (writer == NULL) {
+        printf("PVBuffer failed to open the file %s.\n", path);
+        Py_RETURN_NONE;
+    }
+    for (i=0; i<self->framecount; i++) {
+        if (PVFileWriter_write(writer, self->magn_buf[i], self->freq_buf[i]) < 0)
+            break;
+    }
+    if (PVFileWriter_close(writer) < 0 || i < self->framecount)
+        printf("PVBuffer failed to write the file %s.\n", path);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PVBuffer_load(PVBuffer *self, PyObject *arg)
+{
+    char *path;
+    PVFile *file, *old;
+
+    if (arg == Py_None) {
+        old = self->file;
+        self->file = NULL;
+        PVFile_close(old);
+        Py_RETURN_NONE;
+    }
+
+    if (! PyString_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "PVBuffer load() argument must be a string or None.\n");
+        return NULL;
+    }
+    path = PyString_AsString(arg);
+
+    file = PVFile_open(path);
+    if (file == NULL) {
+        printf("PVBuffer failed to open the analysis file %s.\n", path);
+        Py_RETURN_NONE;
+    }
+    if (file->fftsize != self->size || file->olaps != self->olaps) {
+        printf("PVBuffer warning : %s was analysed with size %d and %d overlaps, input uses size %d and %d overlaps.\n",
+               path, file->fftsize, file->olaps, self->size, self->olaps);
+        PVFile_close(file);
+        Py_RETURN_NONE;
+    }
+    if (file->sr != self->sr)
+        printf("PVBuffer warning : %s was analysed at %.0f Hz, playback speed will differ.\n", path, file->sr);
+
+    old = self->file;
+    self->file = file;
+    PVFile_close(old);
+
+    Py_RETURN_NONE;
+}
+
 static PyMemberDef PVBuffer_members[] = {
 {"server", T_OBJECT_EX, offsetof(PVBuffer, server), 0, "Pyo server."},
 {"stream", T_OBJECT_EX, offsetof(PVBuffer, stream), 0, "Stream object."},
@@ -5204,6 +5275,8 @@ static PyMethodDef PVBuffer_methods[] = {
 {"setInput", (PyCFunction)PVBuffer_setInput, METH_O, "Sets a new input object."},
 {"setIndex", (PyCFunction)PVBuffer_setIndex, METH_O, "Sets a new pointer object."},
 {"setPitch", (PyCFunction)PVBuffer_setPitch, METH_O, "Sets a new transposition factor."},
+{"save", (PyCFunction)PVBuffer_save, METH_O, "Writes the recorded frames in an analysis file."},
+{"load", (PyCFunction)PVBuffer_load, METH_O, "Reads frames from a memory-mapped analysis file."},
 {"play", (PyCFunction)PVBuffer_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
 {"stop", (PyCFunction)PVBuffer_stop, METH_NOARGS, "Stops computing."},
 {NULL}  /* Sentinel */
@@ -5274,26 +5347,18 @@ typedef struct {
 
 static void
 PVShift_realloc_memories(PVShift *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -5396,6 +5461,7 @@ PVShift_setProcMode(PVShift *self)
 static void
 PVShift_compute_next_data_frame(PVShift *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -5426,14 +5492,7 @@ PVShift_clear(PVShift *self)
 static void
 PVShift_dealloc(PVShift* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVShift_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -5467,7 +5526,6 @@ PVShift_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -5513,7 +5571,6 @@ PVShift_setInput(PVShift *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -5645,7 +5702,7 @@ typedef struct {
 
 static void
 PVAmpMod_realloc_memories(PVAmpMod *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
@@ -5654,21 +5711,13 @@ PVAmpMod_realloc_memories(PVAmpMod *self) {
     self->pointers = (MYFLT *)realloc(self->pointers, self->hsize * sizeof(MYFLT));
     for (i=0; i<self->hsize; i++)
         self->pointers[i] = 0.0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -5690,6 +5739,7 @@ PVAmpMod_process_ii(PVAmpMod *self) {
         self->olaps = olaps;
         PVAmpMod_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -5731,6 +5781,7 @@ PVAmpMod_process_ai(PVAmpMod *self) {
         self->olaps = olaps;
         PVAmpMod_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -5771,6 +5822,7 @@ PVAmpMod_process_ia(PVAmpMod *self) {
         self->olaps = olaps;
         PVAmpMod_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -5813,6 +5865,7 @@ PVAmpMod_process_aa(PVAmpMod *self) {
         self->olaps = olaps;
         PVAmpMod_realloc_memories(self);
     }
+    PV_PROCESS_IN_PLACE
 
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
@@ -5886,6 +5939,8 @@ PVAmpMod_clear(PVAmpMod *self)
 {
     pyo_CLEAR
     Py_CLEAR(self->input);
+    if (self->pv_stream != NULL)
+        PVStream_shareFrames(self->pv_stream, NULL);
     Py_CLEAR(self->input_stream);
     Py_CLEAR(self->pv_stream);
     Py_CLEAR(self->basefreq);
@@ -5898,14 +5953,7 @@ PVAmpMod_clear(PVAmpMod *self)
 static void
 PVAmpMod_dealloc(PVAmpMod* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->table);
     free(self->pointers);
     free(self->count);
@@ -5942,7 +5990,6 @@ PVAmpMod_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -5997,7 +6044,7 @@ PVAmpMod_setInput(PVAmpMod *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
+    PVStream_shareFrames(self->pv_stream, NULL);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -6177,7 +6224,7 @@ typedef struct {
 
 static void
 PVFreqMod_realloc_memories(PVFreqMod *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
@@ -6186,21 +6233,13 @@ PVFreqMod_realloc_memories(PVFreqMod *self) {
     self->pointers = (MYFLT *)realloc(self->pointers, self->hsize * sizeof(MYFLT));
     for (i=0; i<self->hsize; i++)
         self->pointers[i] = 0.0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -6464,6 +6503,7 @@ PVFreqMod_setProcMode(PVFreqMod *self)
 static void
 PVFreqMod_compute_next_data_frame(PVFreqMod *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -6502,14 +6542,7 @@ PVFreqMod_clear(PVFreqMod *self)
 static void
 PVFreqMod_dealloc(PVFreqMod* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->table);
     free(self->pointers);
     free(self->count);
@@ -6547,7 +6580,6 @@ PVFreqMod_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -6606,7 +6638,6 @@ PVFreqMod_setInput(PVFreqMod *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -6823,8 +6854,10 @@ typedef struct {
     MYFLT **freq;
     MYFLT **magn_buf;
     MYFLT **freq_buf;
+    PVFile *file; /* when set, frames are read from the file instead */
     int *count;
     int modebuffer[2];
+    PyoRand rng;
 } PVBufLoops;
 
 static void
@@ -6843,14 +6876,9 @@ PVBufLoops_realloc_memories(PVBufLoops *self) {
         self->speeds[i] = 1.0;
         self->pointers[i] = 0.0;
     }
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     self->magn_buf = (MYFLT **)realloc(self->magn_buf, self->numFrames * sizeof(MYFLT *));
     self->freq_buf = (MYFLT **)realloc(self->freq_buf, self->numFrames * sizeof(MYFLT *));
     for (i=0; i<self->numFrames; i++) {
@@ -6861,11 +6889,13 @@ PVBufLoops_realloc_memories(PVBufLoops *self) {
     }
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    if (self->file != NULL && (self->file->fftsize != self->size || self->file->olaps != self->olaps)) {
+        printf("PVBufLoops warning : input size or overlaps differ from the analysis file, file unloaded.\n");
+        PVFile_close(self->file);
+        self->file = NULL;
+    }
+    Stream_setMemory(self->stream, (2 + 2 * (size_t)self->numFrames) * self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -6931,8 +6961,9 @@ PVBufLoops_setSpeeds(PVBufLoops *self, MYFLT low, MYFLT high) {
 
 static void
 PVBufLoops_process(PVBufLoops *self) {
-    int i, k, frame;
-    MYFLT low, high, pos;
+    int i, k;
+    long frame, numFrames;
+    MYFLT low, high, pos, oneOnNumFrames;
     MYFLT **magn = PVStream_getMagn((PVStream *)self->input_stream);
     MYFLT **freq = PVStream_getFreq((PVStream *)self->input_stream);
     int *count = PVStream_getCount((PVStream *)self->input_stream);
@@ -6948,7 +6979,7 @@ PVBufLoops_process(PVBufLoops *self) {
     for (i=0; i<self->bufsize; i++) {
         self->count[i] = count[i];
         if (count[i] >= (self->size-1)) {
-            if (self->framecount < self->numFrames) {
+            if (self->file == NULL && self->framecount < self->numFrames) {
                 for (k=0; k<self->hsize; k++) {
                     self->magn_buf[self->framecount][k] = magn[self->overcount][k];
                     self->freq_buf[self->framecount][k] = freq[self->overcount][k];
@@ -6973,17 +7004,35 @@ PVBufLoops_process(PVBufLoops *self) {
                     self->last_mode = self->mode;
                     PVBufLoops_setSpeeds(self, low, high);
                 }
-                for (k=0; k<self->hsize; k++) {
-                    pos = self->pointers[k];
-                    frame = (int)(pos * (self->numFrames-1));
-                    self->magn[self->overcount][k] = self->magn_buf[frame][k];
-                    self->freq[self->overcount][k] = self->freq_buf[frame][k];
-                    pos += self->OneOnNumFrames * self->speeds[k];
-                    if (pos < 0.0)
-                        pos += 1.0;
-                    else if (pos >= 1.0)
-                        pos -= 1.0;
-                    self->pointers[k] = pos;
+                if (self->file != NULL) {
+                    numFrames = self->file->numFrames;
+                    oneOnNumFrames = 1.0 / numFrames;
+                    for (k=0; k<self->hsize; k++) {
+                        pos = self->pointers[k];
+                        frame = (long)(pos * (numFrames-1));
+                        self->magn[self->overcount][k] = PVFile_getMagn(self->file, frame)[k];
+                        self->freq[self->overcount][k] = PVFile_getFreq(self->file, frame)[k];
+                        pos += oneOnNumFrames * self->speeds[k];
+                        if (pos < 0.0)
+                            pos += 1.0;
+                        else if (pos >= 1.0)
+                            pos -= 1.0;
+                        self->pointers[k] = pos;
+                    }
+                }
+                else {
+                    for (k=0; k<self->hsize; k++) {
+                        pos = self->pointers[k];
+                        frame = (long)(pos * (self->numFrames-1));
+                        self->magn[self->overcount][k] = self->magn_buf[frame][k];
+                        self->freq[self->overcount][k] = self->freq_buf[frame][k];
+                        pos += self->OneOnNumFrames * self->speeds[k];
+                        if (pos < 0.0)
+                            pos += 1.0;
+                        else if (pos >= 1.0)
+                            pos -= 1.0;
+                        self->pointers[k] = pos;
+                    }
                 }
 
             }
@@ -7003,6 +7052,7 @@ PVBufLoops_setProcMode(PVBufLoops *self)
 static void
 PVBufLoops_compute_next_data_frame(PVBufLoops *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -7039,12 +7089,6 @@ PVBufLoops_dealloc(PVBufLoops* self)
 {
     int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     for(i=0; i<self->numFrames; i++) {
         free(self->magn_buf[i]);
         free(self->freq_buf[i]);
@@ -7054,6 +7098,7 @@ PVBufLoops_dealloc(PVBufLoops* self)
     free(self->count);
     free(self->speeds);
     free(self->pointers);
+    PVFile_close(self->file);
     PVBufLoops_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -7091,7 +7136,6 @@ PVBufLoops_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7112,6 +7156,8 @@ PVBufLoops_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     self->count = (int *)realloc(self->count, self->bufsize * sizeof(int));
 
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, PVBUFLOOPS_ID));
+
     PVBufLoops_realloc_memories(self);
 
     (*self->mode_func_ptr)(self);
@@ -7148,7 +7194,6 @@ PVBufLoops_setInput(PVBufLoops *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7250,6 +7295,79 @@ PVBufLoops_reset(PVBufLoops *self) {
 	return Py_None;
 }
 
+static PyObject *
+PVBufLoops_save(PVBufLoops *self, PyObject *arg)
+{
+    int i;
+    char *path;
+    PVFileWriter *writer;
+
+    if (! PyString_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "PVBufLoops save() argument must be a string.\n");
+        return NULL;
+    }
+    path = PyString_AsString(arg);
+
+    if (self->file != NULL) {
+        printf("PVBufLoops warning : frames are read from an analysis file, nothing to save.\n");
+        Py_RETURN_NONE;
+    }
+
+    writer = PVFileWriter_new(path, self->size, self->olaps, self->sr);
+    if (writer == NULL) {
+        printf("PVBufLoops failed to open the file %s.\n", path);
+        Py_RETURN_NONE;
+    }
+    for (i=0; i<self->framecount; i++) {
+        if (PVFileWriter_write(writer, self->magn_buf[i], self->freq_buf[i]) < 0)
+            break;
+    }
+    if (PVFileWriter_close(writer) < 0 || i < self->framecount)
+        printf("PVBufLoops failed to write the file %s.\n", path);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PVBufLoops_load(PVBufLoops *self, PyObject *arg)
+{
+    char *path;
+    PVFile *file, *old;
+
+    if (arg == Py_None) {
+        old = self->file;
+        self->file = NULL;
+        PVFile_close(old);
+        Py_RETURN_NONE;
+    }
+
+    if (! PyString_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "PVBufLoops load() argument must be a string or None.\n");
+        return NULL;
+    }
+    path = PyString_AsString(arg);
+
+    file = PVFile_open(path);
+    if (file == NULL) {
+        printf("PVBufLoops failed to open the analysis file %s.\n", path);
+        Py_RETURN_NONE;
+    }
+    if (file->fftsize != self->size || file->olaps != self->olaps) {
+        printf("PVBufLoops warning : %s was analysed with size %d and %d overlaps, input uses size %d and %d overlaps.\n",
+               path, file->fftsize, file->olaps, self->size, self->olaps);
+        PVFile_close(file);
+        Py_RETURN_NONE;
+    }
+    if (file->sr != self->sr)
+        printf("PVBufLoops warning : %s was analysed at %.0f Hz, playback speed will differ.\n", path, file->sr);
+
+    old = self->file;
+    self->file = file;
+    PVFile_close(old);
+
+    Py_RETURN_NONE;
+}
+
 static PyMemberDef PVBufLoops_members[] = {
 {"server", T_OBJECT_EX, offsetof(PVBufLoops, server), 0, "Pyo server."},
 {"stream", T_OBJECT_EX, offsetof(PVBufLoops, stream), 0, "Stream object."},
@@ -7269,6 +7387,8 @@ static PyMethodDef PVBufLoops_methods[] = {
 {"setHigh", (PyCFunction)PVBufLoops_setHigh, METH_O, "Sets a new highest speed."},
 {"setMode", (PyCFunction)PVBufLoops_setMode, METH_O, "Sets a new mode."},
 {"reset", (PyCFunction)PVBufLoops_reset, METH_NOARGS, "Preset pointer positions."},
+{"save", (PyCFunction)PVBufLoops_save, METH_O, "Writes the recorded frames in an analysis file."},
+{"load", (PyCFunction)PVBufLoops_load, METH_O, "Reads frames from a memory-mapped analysis file."},
 {"play", (PyCFunction)PVBufLoops_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
 {"stop", (PyCFunction)PVBufLoops_stop, METH_NOARGS, "Stops computing."},
 {NULL}  /* Sentinel */
@@ -7356,14 +7476,9 @@ PVBufTabLoops_realloc_memories(PVBufTabLoops *self) {
     for (i=0; i<self->hsize; i++) {
         self->pointers[i] = 0.0;
     }
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     self->magn_buf = (MYFLT **)realloc(self->magn_buf, self->numFrames * sizeof(MYFLT *));
     self->freq_buf = (MYFLT **)realloc(self->freq_buf, self->numFrames * sizeof(MYFLT *));
     for (i=0; i<self->numFrames; i++) {
@@ -7374,11 +7489,8 @@ PVBufTabLoops_realloc_memories(PVBufTabLoops *self) {
     }
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, (1 + 2 * (size_t)self->numFrames) * self->hsize * sizeof(MYFLT) + PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -7444,6 +7556,7 @@ PVBufTabLoops_setProcMode(PVBufTabLoops *self)
 static void
 PVBufTabLoops_compute_next_data_frame(PVBufTabLoops *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -7474,12 +7587,6 @@ PVBufTabLoops_dealloc(PVBufTabLoops* self)
 {
     int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     for(i=0; i<self->numFrames; i++) {
         free(self->magn_buf[i]);
         free(self->freq_buf[i]);
@@ -7520,7 +7627,6 @@ PVBufTabLoops_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7572,7 +7678,6 @@ PVBufTabLoops_setInput(PVBufTabLoops *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7692,26 +7797,18 @@ typedef struct {
 
 static void
 PVMix_realloc_memories(PVMix *self) {
-    int i, j, inputLatency;
+    int i, inputLatency;
     self->hsize = self->size / 2;
     self->hopsize = self->size / self->olaps;
     inputLatency = self->size - self->hopsize;
     self->overcount = 0;
-    self->magn = (MYFLT **)realloc(self->magn, self->olaps * sizeof(MYFLT *));
-    self->freq = (MYFLT **)realloc(self->freq, self->olaps * sizeof(MYFLT *));
-    for (i=0; i<self->olaps; i++) {
-        self->magn[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        self->freq[i] = (MYFLT *)malloc(self->hsize * sizeof(MYFLT));
-        for (j=0; j<self->hsize; j++)
-            self->magn[i][j] = self->freq[i][j] = 0.0;
-    }
+    PVStream_allocFrames(self->pv_stream, self->size, self->olaps);
+    self->magn = PVStream_getMagn(self->pv_stream);
+    self->freq = PVStream_getFreq(self->pv_stream);
     for (i=0; i<self->bufsize; i++)
         self->count[i] = inputLatency;
-    PVStream_setFFTsize(self->pv_stream, self->size);
-    PVStream_setOlaps(self->pv_stream, self->olaps);
-    PVStream_setMagn(self->pv_stream, self->magn);
-    PVStream_setFreq(self->pv_stream, self->freq);
     PVStream_setCount(self->pv_stream, self->count);
+    Stream_setMemory(self->stream, PVStream_getMemory(self->pv_stream));
 }
 
 static void
@@ -7760,6 +7857,7 @@ PVMix_setProcMode(PVMix *self)
 static void
 PVMix_compute_next_data_frame(PVMix *self)
 {
+    PV_BEGIN_FRAME
     (*self->proc_func_ptr)(self);
 }
 
@@ -7790,14 +7888,7 @@ PVMix_clear(PVMix *self)
 static void
 PVMix_dealloc(PVMix* self)
 {
-    int i;
     pyo_DEALLOC
-    for(i=0; i<self->olaps; i++) {
-        free(self->magn[i]);
-        free(self->freq[i]);
-    }
-    free(self->magn);
-    free(self->freq);
     free(self->count);
     PVMix_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -7830,7 +7921,6 @@ PVMix_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7842,7 +7932,6 @@ PVMix_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     Py_XDECREF(self->input2);
     self->input2 = input2tmp;
     input2_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input2_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input2_streamtmp;
 
@@ -7884,7 +7973,6 @@ PVMix_setInput(PVMix *self, PyObject *arg)
     Py_XDECREF(self->input);
     self->input = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input_stream);
     self->input_stream = (PVStream *)input_streamtmp;
 
@@ -7907,7 +7995,6 @@ PVMix_setInput2(PVMix *self, PyObject *arg)
     Py_XDECREF(self->input2);
     self->input2 = inputtmp;
     input_streamtmp = PyObject_CallMethod((PyObject *)self->input2, "_getPVStream", NULL);
-    Py_INCREF(input_streamtmp);
     Py_XDECREF(self->input2_stream);
     self->input2_stream = (PVStream *)input_streamtmp;
 
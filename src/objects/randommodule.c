@@ -38,7 +38,9 @@ typedef struct {
     MYFLT oldValue;
     MYFLT diff;
     MYFLT time;
+    int krate;
     int modebuffer[5]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } Randi;
 
 static void
@@ -58,7 +60,7 @@ Randi_generate_iii(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -82,7 +84,7 @@ Randi_generate_aii(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -106,7 +108,7 @@ Randi_generate_iai(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -130,7 +132,7 @@ Randi_generate_aai(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -154,7 +156,7 @@ Randi_generate_iia(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -178,7 +180,7 @@ Randi_generate_aia(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -202,7 +204,7 @@ Randi_generate_iaa(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
@@ -226,13 +228,44 @@ Randi_generate_aaa(Randi *self) {
         else if (self->time >= 1.0) {
             self->time -= 1.0;
             self->oldValue = self->value;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             self->diff = self->value - self->oldValue;
         }
         self->data[i] = self->oldValue + self->diff * self->time;
     }
 }
 
+/* Control-rate mode, min, max and freq are read at the end of the buffer. */
+static void
+Randi_generate_k(Randi *self) {
+    MYFLT mi, ma, fr;
+    MYFLT start = self->oldValue + self->diff * self->time;
+
+    if (self->modebuffer[2] == 0)
+        mi = PyFloat_AS_DOUBLE(self->min);
+    else
+        mi = Stream_getData((Stream *)self->min_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        ma = PyFloat_AS_DOUBLE(self->max);
+    else
+        ma = Stream_getData((Stream *)self->max_stream)[self->bufsize-1];
+    if (self->modebuffer[4] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        fr = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+
+    self->time += fr / self->sr * self->bufsize;
+    if (self->time < 0.0)
+        self->time -= MYFLOOR(self->time);
+    else if (self->time >= 1.0) {
+        self->time -= MYFLOOR(self->time);
+        self->oldValue = self->value;
+        self->value = (ma - mi) * RANDOM_UNIFORM + mi;
+        self->diff = self->value - self->oldValue;
+    }
+    pyo_fill_ramp(self->data, start, self->oldValue + self->diff * self->time, self->bufsize);
+}
+
 static void Randi_postprocessing_ii(Randi *self) { POST_PROCESSING_II };
 static void Randi_postprocessing_ai(Randi *self) { POST_PROCESSING_AI };
 static void Randi_postprocessing_ia(Randi *self) { POST_PROCESSING_IA };
@@ -275,6 +308,9 @@ Randi_setProcMode(Randi *self)
         case 111:
             self->proc_func_ptr = Randi_generate_aaa;
             break;
+    }
+    if (self->krate) {
+        self->proc_func_ptr = Randi_generate_k;
     }
 	switch (muladdmode) {
         case 0:
@@ -305,6 +341,7 @@ Randi_setProcMode(Randi *self)
             self->muladd_func_ptr = Randi_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
@@ -362,6 +399,7 @@ Randi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->freq = PyFloat_FromDouble(1.);
     self->value = self->oldValue = self->diff = 0.0;
     self->time = 1.0;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -399,7 +437,7 @@ Randi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, RANDI_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, RANDI_ID));
 
     if (self->modebuffer[2] == 0)
         mi = PyFloat_AS_DOUBLE(self->min);
@@ -417,6 +455,18 @@ Randi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+static PyObject *
+Randi_setControlRate(Randi *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Randi_getServer(Randi* self) { GET_SERVER };
 static PyObject * Randi_getStream(Randi* self) { GET_STREAM };
 static PyObject * Randi_setMul(Randi *self, PyObject *arg) { SET_MUL };
@@ -559,6 +609,7 @@ static PyMethodDef Randi_methods[] = {
 {"setMin", (PyCFunction)Randi_setMin, METH_O, "Sets minimum possible value."},
 {"setMax", (PyCFunction)Randi_setMax, METH_O, "Sets maximum possible value."},
 {"setFreq", (PyCFunction)Randi_setFreq, METH_O, "Sets polling frequency."},
+{"setControlRate", (PyCFunction)Randi_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
 {"setMul", (PyCFunction)Randi_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)Randi_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)Randi_setSub, METH_O, "Sets inverse add factor."},
@@ -663,7 +714,9 @@ typedef struct {
     Stream *freq_stream;
     MYFLT value;
     MYFLT time;
+    int krate;
     int modebuffer[5]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } Randh;
 
 static void
@@ -682,7 +735,7 @@ Randh_generate_iii(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
         }
         self->data[i] = self->value;
     }
@@ -704,7 +757,7 @@ Randh_generate_aii(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
         }
         self->data[i] = self->value;
     }
@@ -726,7 +779,7 @@ Randh_generate_iai(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
         }
         self->data[i] = self->value;
     }
@@ -748,7 +801,7 @@ Randh_generate_aai(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
         }
         self->data[i] = self->value;
     }
@@ -770,7 +823,7 @@ Randh_generate_iia(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
         }
         self->data[i] = self->value;
     }
@@ -792,7 +845,7 @@ Randh_generate_aia(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
         }
         self->data[i] = self->value;
     }
@@ -814,7 +867,7 @@ Randh_generate_iaa(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
         }
         self->data[i] = self->value;
     }
@@ -836,12 +889,41 @@ Randh_generate_aaa(Randh *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
         }
         self->data[i] = self->value;
     }
 }
 
+/* Control-rate mode, min, max and freq are read at the end of the buffer. */
+static void
+Randh_generate_k(Randh *self) {
+    MYFLT mi, ma, fr;
+    MYFLT start = self->value;
+
+    if (self->modebuffer[2] == 0)
+        mi = PyFloat_AS_DOUBLE(self->min);
+    else
+        mi = Stream_getData((Stream *)self->min_stream)[self->bufsize-1];
+    if (self->modebuffer[3] == 0)
+        ma = PyFloat_AS_DOUBLE(self->max);
+    else
+        ma = Stream_getData((Stream *)self->max_stream)[self->bufsize-1];
+    if (self->modebuffer[4] == 0)
+        fr = PyFloat_AS_DOUBLE(self->freq);
+    else
+        fr = Stream_getData((Stream *)self->freq_stream)[self->bufsize-1];
+
+    self->time += fr / self->sr * self->bufsize;
+    if (self->time < 0.0)
+        self->time -= MYFLOOR(self->time);
+    else if (self->time >= 1.0) {
+        self->time -= MYFLOOR(self->time);
+        self->value = (ma - mi) * RANDOM_UNIFORM + mi;
+    }
+    pyo_fill_ramp(self->data, start, self->value, self->bufsize);
+}
+
 static void Randh_postprocessing_ii(Randh *self) { POST_PROCESSING_II };
 static void Randh_postprocessing_ai(Randh *self) { POST_PROCESSING_AI };
 static void Randh_postprocessing_ia(Randh *self) { POST_PROCESSING_IA };
@@ -884,6 +966,9 @@ Randh_setProcMode(Randh *self)
         case 111:
             self->proc_func_ptr = Randh_generate_aaa;
             break;
+    }
+    if (self->krate) {
+        self->proc_func_ptr = Randh_generate_k;
     }
 	switch (muladdmode) {
         case 0:
@@ -914,6 +999,7 @@ Randh_setProcMode(Randh *self)
             self->muladd_func_ptr = Randh_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
@@ -971,6 +1057,7 @@ Randh_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->freq = PyFloat_FromDouble(1.);
     self->value = 0.0;
     self->time = 1.0;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -1008,7 +1095,7 @@ Randh_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, RANDH_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, RANDH_ID));
 
     if (self->modebuffer[2] == 0)
         mi = PyFloat_AS_DOUBLE(self->min);
@@ -1026,6 +1113,18 @@ Randh_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+static PyObject *
+Randh_setControlRate(Randh *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Randh_getServer(Randh* self) { GET_SERVER };
 static PyObject * Randh_getStream(Randh* self) { GET_STREAM };
 static PyObject * Randh_setMul(Randh *self, PyObject *arg) { SET_MUL };
@@ -1168,6 +1267,7 @@ static PyMethodDef Randh_methods[] = {
 {"setMin", (PyCFunction)Randh_setMin, METH_O, "Sets minimum possible value."},
 {"setMax", (PyCFunction)Randh_setMax, METH_O, "Sets maximum possible value."},
 {"setFreq", (PyCFunction)Randh_setFreq, METH_O, "Sets polling frequency."},
+{"setControlRate", (PyCFunction)Randh_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
 {"setMul", (PyCFunction)Randh_setMul, METH_O, "Sets oscillator mul factor."},
 {"setAdd", (PyCFunction)Randh_setAdd, METH_O, "Sets oscillator add factor."},
 {"setSub", (PyCFunction)Randh_setSub, METH_O, "Sets inverse add factor."},
@@ -1271,6 +1371,7 @@ typedef struct {
     MYFLT value;
     MYFLT time;
     int modebuffer[3]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } Choice;
 
 static void
@@ -1286,7 +1387,7 @@ Choice_generate_i(Choice *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = self->choice[(int)((rand()/((MYFLT)(RAND_MAX))) * self->chSize)];
+            self->value = self->choice[(int)(RANDOM_UNIFORM * self->chSize)];
         }
         self->data[i] = self->value;
     }
@@ -1305,7 +1406,7 @@ Choice_generate_a(Choice *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = self->choice[(int)((rand()/((MYFLT)(RAND_MAX))) * self->chSize)];
+            self->value = self->choice[(int)(RANDOM_UNIFORM * self->chSize)];
         }
         self->data[i] = self->value;
     }
@@ -1443,7 +1544,7 @@ Choice_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, CHOICE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, CHOICE_ID));
 
     (*self->mode_func_ptr)(self);
 
@@ -1649,6 +1750,7 @@ typedef struct {
     MYFLT value;
     MYFLT time;
     int modebuffer[4]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } RandInt;
 
 static void
@@ -1665,7 +1767,7 @@ RandInt_generate_ii(RandInt *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma));
         }
         self->data[i] = self->value;
     }
@@ -1685,7 +1787,7 @@ RandInt_generate_ai(RandInt *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma[i]));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma[i]));
         }
         self->data[i] = self->value;
     }
@@ -1705,7 +1807,7 @@ RandInt_generate_ia(RandInt *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma));
         }
         self->data[i] = self->value;
     }
@@ -1725,7 +1827,7 @@ RandInt_generate_aa(RandInt *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma[i]));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma[i]));
         }
         self->data[i] = self->value;
     }
@@ -1874,7 +1976,7 @@ RandInt_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, RANDINT_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, RANDINT_ID));
 
     (*self->mode_func_ptr)(self);
 
@@ -2091,6 +2193,7 @@ typedef struct {
     MYFLT time;
     MYFLT inc;
     int modebuffer[4]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } RandDur;
 
 static void
@@ -2111,7 +2214,7 @@ RandDur_generate_ii(RandDur *self) {
             range = ma - mi;
             if (range < 0.0)
                 range = 0.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->inc = (1.0 / self->value) / self->sr;
         }
         self->data[i] = self->value;
@@ -2137,7 +2240,7 @@ RandDur_generate_ai(RandDur *self) {
             range = ma - mi;
             if (range < 0.0)
                 range = 0.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->inc = (1.0 / self->value) / self->sr;
         }
         self->data[i] = self->value;
@@ -2162,7 +2265,7 @@ RandDur_generate_ia(RandDur *self) {
             range = ma[i] - mi;
             if (range < 0.0)
                 range = 0.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->inc = (1.0 / self->value) / self->sr;
         }
         self->data[i] = self->value;
@@ -2188,7 +2291,7 @@ RandDur_generate_aa(RandDur *self) {
             range = ma[i] - mi;
             if (range < 0.0)
                 range = 0.0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             self->inc = (1.0 / self->value) / self->sr;
         }
         self->data[i] = self->value;
@@ -2339,7 +2442,7 @@ RandDur_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, RANDDUR_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, RANDDUR_ID));
 
     if (self->modebuffer[2] == 0)
         mi = PyFloat_AS_DOUBLE(self->min);
@@ -2587,124 +2690,12 @@ typedef struct {
     int loopLen;
     int loopStop;
     int modebuffer[5]; // need at least 2 slots for mul & add
+    PyoRand rng;
+    int distribution; /* PYORAND_* type drawn by blocks, when type_func_ptr is NULL */
+    MYFLT *draws; /* x1, x2 and values of the draws of the current buffer */
+    int *drawpos; /* offsets of the draws */
 } Xnoise;
 
-// no parameter
-static MYFLT
-Xnoise_uniform(Xnoise *self) {
-    return RANDOM_UNIFORM;
-}
-
-static MYFLT
-Xnoise_linear_min(Xnoise *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    if (a < b) return a;
-    else return b;
-}
-
-static MYFLT
-Xnoise_linear_max(Xnoise *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    if (a > b) return a;
-    else return b;
-}
-
-static MYFLT
-Xnoise_triangle(Xnoise *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    return ((a + b) * 0.5);
-}
-
-// x1 = slope
-static MYFLT
-Xnoise_expon_min(Xnoise *self) {
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT val = -MYLOG(RANDOM_UNIFORM) / self->xx1;
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-static MYFLT
-Xnoise_expon_max(Xnoise *self) {
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT val = 1.0 - (-MYLOG(RANDOM_UNIFORM) / self->xx1);
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = bandwidth
-static MYFLT
-Xnoise_biexpon(Xnoise *self) {
-    MYFLT polar, val;
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT sum = RANDOM_UNIFORM * 2.0;
-
-    if (sum > 1.0) {
-        polar = -1;
-        sum = 2.0 - sum;
-    }
-    else
-        polar = 1;
-
-    val = 0.5 * (polar * MYLOG(sum) / self->xx1) + 0.5;
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-static MYFLT
-Xnoise_cauchy(Xnoise *self) {
-    MYFLT rnd, val, dir;
-    do {
-        rnd = RANDOM_UNIFORM;
-    }
-    while (rnd == 0.5);
-
-    if (rand() < (RAND_MAX / 2))
-        dir = -1;
-    else
-        dir = 1;
-
-    val = 0.5 * (MYTAN(rnd) * self->xx1 * dir) + 0.5;
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = locator, x2 = shape
-static MYFLT
-Xnoise_weibull(Xnoise *self) {
-    MYFLT rnd, val;
-    if (self->xx2 <= 0.0) self->xx2 = 0.00001;
-
-    rnd = 1.0 / (1.0 - RANDOM_UNIFORM);
-    val = self->xx1 * MYPOW(MYLOG(rnd), (1.0 / self->xx2));
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = locator, x2 = bandwidth
-static MYFLT
-Xnoise_gaussian(Xnoise *self) {
-    MYFLT rnd, val;
-
-    rnd = (RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM);
-    val = (self->xx2 * (rnd - 3.0) * 0.33 + self->xx1);
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
 // x1 = gravity center, x2 = compress/expand
 static MYFLT
 Xnoise_poisson(Xnoise *self) {
@@ -2727,7 +2718,7 @@ Xnoise_poisson(Xnoise *self) {
             }
         }
     }
-    val = self->poisson_buffer[rand() % self->poisson_tab] / 12.0 * self->xx2;
+    val = self->poisson_buffer[RANDOM_INT % self->poisson_tab] / 12.0 * self->xx2;
 
     if (val < 0.0) return 0.0;
     else if (val > 1.0) return 1.0;
@@ -2742,12 +2733,12 @@ Xnoise_walker(Xnoise *self) {
     if (self->xx2 < 0.002) self->xx2 = 0.002;
 
     modulo = (int)(self->xx2 * 1000.0);
-    dir = rand() % 2;
+    dir = RANDOM_INT % 2;
 
     if (dir == 0)
-        self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
     else
-        self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
     if (self->walkerValue > self->xx1)
         self->walkerValue = self->xx1;
@@ -2769,12 +2760,12 @@ Xnoise_loopseg(Xnoise *self) {
         if (self->xx2 < 0.002) self->xx2 = 0.002;
 
         modulo = (int)(self->xx2 * 1000.0);
-        dir = rand() % 2;
+        dir = RANDOM_INT % 2;
 
         if (dir == 0)
-            self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
         else
-            self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
         if (self->walkerValue > self->xx1)
             self->walkerValue = self->xx1;
@@ -2787,7 +2778,7 @@ Xnoise_loopseg(Xnoise *self) {
             self->loopChoice = 0;
         else {
             self->loopChoice = 1;
-            self->loopStop = (rand() % 4) + 1;
+            self->loopStop = (RANDOM_INT % 4) + 1;
         }
     }
     else {
@@ -2804,20 +2795,50 @@ Xnoise_loopseg(Xnoise *self) {
 
         if (self->loopTime == self->loopStop) {
             self->loopChoice = 0;
-            self->loopLen = (rand() % 10) + 3;
+            self->loopLen = (RANDOM_INT % 10) + 3;
         }
     }
 
     return self->walkerValue;
 }
 
+/* Draws the `num` values of the buffer, at the offsets in drawpos with the
+ * parameters in draws, and holds each one until the next. */
+static void
+Xnoise_draw(Xnoise *self, int num) {
+    int i, j, start = 0;
+    MYFLT *x1 = self->draws, *x2 = self->draws + self->bufsize, *vals = self->draws + 2 * self->bufsize;
+
+    if (self->type_func_ptr == NULL)
+        PyoRand_distribution(&self->rng, self->distribution, x1, x2, vals, num);
+    else {
+        for (j=0; j<num; j++) {
+            self->xx1 = x1[j];
+            self->xx2 = x2[j];
+            vals[j] = (*self->type_func_ptr)(self);
+        }
+    }
+
+    for (j=0; j<num; j++) {
+        for (i=start; i<self->drawpos[j]; i++) {
+            self->data[i] = self->value;
+        }
+        start = self->drawpos[j];
+        self->value = vals[j];
+    }
+    for (i=start; i<self->bufsize; i++) {
+        self->data[i] = self->value;
+    }
+}
+
 static void
 Xnoise_generate_iii(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -2826,19 +2847,22 @@ Xnoise_generate_iii(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_aii(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -2847,20 +2871,22 @@ Xnoise_generate_aii(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_iai(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -2869,20 +2895,22 @@ Xnoise_generate_iai(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_aai(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -2891,21 +2919,22 @@ Xnoise_generate_aai(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_iia(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -2914,19 +2943,22 @@ Xnoise_generate_iia(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_aia(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -2935,20 +2967,22 @@ Xnoise_generate_aia(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_iaa(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -2957,20 +2991,22 @@ Xnoise_generate_iaa(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void
 Xnoise_generate_aaa(Xnoise *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -2979,12 +3015,12 @@ Xnoise_generate_aaa(Xnoise *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    Xnoise_draw(self, num);
 }
 
 static void Xnoise_postprocessing_ii(Xnoise *self) { POST_PROCESSING_II };
@@ -3003,34 +3039,17 @@ Xnoise_setRandomType(Xnoise *self)
 
     switch (self->type) {
         case 0:
-            self->type_func_ptr = Xnoise_uniform;
-            break;
         case 1:
-            self->type_func_ptr = Xnoise_linear_min;
-            break;
         case 2:
-            self->type_func_ptr = Xnoise_linear_max;
-            break;
         case 3:
-            self->type_func_ptr = Xnoise_triangle;
-            break;
         case 4:
-            self->type_func_ptr = Xnoise_expon_min;
-            break;
         case 5:
-            self->type_func_ptr = Xnoise_expon_max;
-            break;
         case 6:
-            self->type_func_ptr = Xnoise_biexpon;
-            break;
         case 7:
-            self->type_func_ptr = Xnoise_cauchy;
-            break;
         case 8:
-            self->type_func_ptr = Xnoise_weibull;
-            break;
         case 9:
-            self->type_func_ptr = Xnoise_gaussian;
+            self->type_func_ptr = NULL;
+            self->distribution = self->type;
             break;
         case 10:
             self->type_func_ptr = Xnoise_poisson;
@@ -3145,6 +3164,8 @@ static void
 Xnoise_dealloc(Xnoise* self)
 {
     pyo_DEALLOC
+    free(self->draws);
+    free(self->drawpos);
     Xnoise_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -3171,7 +3192,10 @@ Xnoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
 
-    Server_generateSeed((Server *)self->server, XNOISE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, XNOISE_ID));
+
+    self->draws = (MYFLT *)realloc(self->draws, 3 * self->bufsize * sizeof(MYFLT));
+    self->drawpos = (int *)realloc(self->drawpos, self->bufsize * sizeof(int));
 
     self->poisson_tab = 0;
     self->lastPoissonX1 = -99.0;
@@ -3182,7 +3206,7 @@ Xnoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->loop_buffer[i] = 0.0;
     }
     self->loopChoice = self->loopCountPlay = self->loopTime = self->loopCountRec = self->loopStop = 0;
-    self->loopLen = (rand() % 10) + 3;
+    self->loopLen = (RANDOM_INT % 10) + 3;
 
     Stream_setFunctionPtr(self->stream, Xnoise_compute_next_data_frame);
     self->mode_func_ptr = Xnoise_setProcMode;
@@ -3507,6 +3531,10 @@ typedef struct {
     int loopLen;
     int loopStop;
     int modebuffer[5]; // need at least 2 slots for mul & add
+    PyoRand rng;
+    int distribution; /* PYORAND_* type drawn by blocks, when type_func_ptr is NULL */
+    MYFLT *draws; /* x1, x2 and values of the draws of the current buffer */
+    int *drawpos; /* offsets of the draws */
 } XnoiseMidi;
 
 static MYFLT
@@ -3533,122 +3561,6 @@ XnoiseMidi_convert(XnoiseMidi *self) {
     return val;
 }
 
-// no parameter
-static MYFLT
-XnoiseMidi_uniform(XnoiseMidi *self) {
-    return RANDOM_UNIFORM;
-}
-
-static MYFLT
-XnoiseMidi_linear_min(XnoiseMidi *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    if (a < b) return a;
-    else return b;
-}
-
-static MYFLT
-XnoiseMidi_linear_max(XnoiseMidi *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    if (a > b) return a;
-    else return b;
-}
-
-static MYFLT
-XnoiseMidi_triangle(XnoiseMidi *self) {
-    MYFLT a = RANDOM_UNIFORM;
-    MYFLT b = RANDOM_UNIFORM;
-    return ((a + b) * 0.5);
-}
-
-// x1 = slope
-static MYFLT
-XnoiseMidi_expon_min(XnoiseMidi *self) {
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT val = -MYLOG(RANDOM_UNIFORM) / self->xx1;
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-static MYFLT
-XnoiseMidi_expon_max(XnoiseMidi *self) {
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT val = 1.0 - (-MYLOG(RANDOM_UNIFORM) / self->xx1);
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = bandwidth
-static MYFLT
-XnoiseMidi_biexpon(XnoiseMidi *self) {
-    MYFLT polar, val;
-    if (self->xx1 <= 0.0) self->xx1 = 0.00001;
-    MYFLT sum = RANDOM_UNIFORM * 2.0;
-
-    if (sum > 1.0) {
-        polar = -1;
-        sum = 2.0 - sum;
-    }
-    else
-        polar = 1;
-
-    val = 0.5 * (polar * MYLOG(sum) / self->xx1) + 0.5;
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-static MYFLT
-XnoiseMidi_cauchy(XnoiseMidi *self) {
-    MYFLT rnd, val, dir;
-    do {
-        rnd = RANDOM_UNIFORM;
-    }
-    while (rnd == 0.5);
-
-    if (rand() < (RAND_MAX / 2))
-        dir = -1;
-    else
-        dir = 1;
-
-    val = 0.5 * (MYTAN(rnd) * self->xx1 * dir) + 0.5;
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = locator, x2 = shape
-static MYFLT
-XnoiseMidi_weibull(XnoiseMidi *self) {
-    MYFLT rnd, val;
-    if (self->xx2 <= 0.0) self->xx2 = 0.00001;
-
-    rnd = 1.0 / (1.0 - RANDOM_UNIFORM);
-    val = self->xx1 * MYPOW(MYLOG(rnd), (1.0 / self->xx2));
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
-// x1 = locator, x2 = bandwidth
-static MYFLT
-XnoiseMidi_gaussian(XnoiseMidi *self) {
-    MYFLT rnd, val;
-
-    rnd = (RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM + RANDOM_UNIFORM);
-    val = (self->xx2 * (rnd - 3.0) * 0.33 + self->xx1);
-
-    if (val < 0.0) return 0.0;
-    else if (val > 1.0) return 1.0;
-    else return val;
-}
-
 // x1 = gravity center, x2 = compress/expand
 static MYFLT
 XnoiseMidi_poisson(XnoiseMidi *self) {
@@ -3671,7 +3583,7 @@ XnoiseMidi_poisson(XnoiseMidi *self) {
             }
         }
     }
-    val = self->poisson_buffer[rand() % self->poisson_tab] / 12.0 * self->xx2;
+    val = self->poisson_buffer[RANDOM_INT % self->poisson_tab] / 12.0 * self->xx2;
 
     if (val < 0.0) return 0.0;
     else if (val > 1.0) return 1.0;
@@ -3686,12 +3598,12 @@ XnoiseMidi_walker(XnoiseMidi *self) {
     if (self->xx2 < 0.002) self->xx2 = 0.002;
 
     modulo = (int)(self->xx2 * 1000.0);
-    dir = rand() % 2;
+    dir = RANDOM_INT % 2;
 
     if (dir == 0)
-        self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
     else
-        self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
     if (self->walkerValue > self->xx1)
         self->walkerValue = self->xx1;
@@ -3713,12 +3625,12 @@ XnoiseMidi_loopseg(XnoiseMidi *self) {
         if (self->xx2 < 0.002) self->xx2 = 0.002;
 
         modulo = (int)(self->xx2 * 1000.0);
-        dir = rand() % 2;
+        dir = RANDOM_INT % 2;
 
         if (dir == 0)
-            self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
         else
-            self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
         if (self->walkerValue > self->xx1)
             self->walkerValue = self->xx1;
@@ -3731,7 +3643,7 @@ XnoiseMidi_loopseg(XnoiseMidi *self) {
             self->loopChoice = 0;
         else {
             self->loopChoice = 1;
-            self->loopStop = (rand() % 4) + 1;
+            self->loopStop = (RANDOM_INT % 4) + 1;
         }
     }
     else {
@@ -3748,20 +3660,51 @@ XnoiseMidi_loopseg(XnoiseMidi *self) {
 
         if (self->loopTime == self->loopStop) {
             self->loopChoice = 0;
-            self->loopLen = (rand() % 10) + 3;
+            self->loopLen = (RANDOM_INT % 10) + 3;
         }
     }
 
     return self->walkerValue;
 }
 
+/* Draws the `num` values of the buffer, at the offsets in drawpos with the
+ * parameters in draws, and holds each one until the next. */
+static void
+XnoiseMidi_draw(XnoiseMidi *self, int num) {
+    int i, j, start = 0;
+    MYFLT *x1 = self->draws, *x2 = self->draws + self->bufsize, *vals = self->draws + 2 * self->bufsize;
+
+    if (self->type_func_ptr == NULL)
+        PyoRand_distribution(&self->rng, self->distribution, x1, x2, vals, num);
+    else {
+        for (j=0; j<num; j++) {
+            self->xx1 = x1[j];
+            self->xx2 = x2[j];
+            vals[j] = (*self->type_func_ptr)(self);
+        }
+    }
+
+    for (j=0; j<num; j++) {
+        for (i=start; i<self->drawpos[j]; i++) {
+            self->data[i] = self->value;
+        }
+        start = self->drawpos[j];
+        self->value = vals[j];
+            self->value = XnoiseMidi_convert(self);
+    }
+    for (i=start; i<self->bufsize; i++) {
+        self->data[i] = self->value;
+    }
+}
+
 static void
 XnoiseMidi_generate_iii(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -3770,20 +3713,22 @@ XnoiseMidi_generate_iii(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_aii(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -3792,21 +3737,22 @@ XnoiseMidi_generate_aii(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_iai(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -3815,21 +3761,22 @@ XnoiseMidi_generate_iai(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_aai(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT fr = PyFloat_AS_DOUBLE(self->freq);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
     inc = fr / self->sr;
 
     for (i=0; i<self->bufsize; i++) {
@@ -3838,22 +3785,22 @@ XnoiseMidi_generate_aai(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_iia(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -3862,20 +3809,22 @@ XnoiseMidi_generate_iia(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_aia(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
-    self->xx2 = PyFloat_AS_DOUBLE(self->x2);
+    MYFLT x2 = PyFloat_AS_DOUBLE(self->x2);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -3884,21 +3833,22 @@ XnoiseMidi_generate_aia(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2;
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_iaa(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
-    self->xx1 = PyFloat_AS_DOUBLE(self->x1);
+    MYFLT x1 = PyFloat_AS_DOUBLE(self->x1);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -3907,21 +3857,22 @@ XnoiseMidi_generate_iaa(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1;
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void
 XnoiseMidi_generate_aaa(XnoiseMidi *self) {
-    int i;
+    int i, num = 0;
     MYFLT inc;
     MYFLT *x1 = Stream_getData((Stream *)self->x1_stream);
     MYFLT *x2 = Stream_getData((Stream *)self->x2_stream);
     MYFLT *fr = Stream_getData((Stream *)self->freq_stream);
+    MYFLT *px1 = self->draws, *px2 = self->draws + self->bufsize;
 
     for (i=0; i<self->bufsize; i++) {
         inc = fr[i] / self->sr;
@@ -3930,13 +3881,12 @@ XnoiseMidi_generate_aaa(XnoiseMidi *self) {
             self->time += 1.0;
         else if (self->time >= 1.0) {
             self->time -= 1.0;
-            self->xx1 = x1[i];
-            self->xx2 = x2[i];
-            self->value = (*self->type_func_ptr)(self);
-            self->value = XnoiseMidi_convert(self);
+            self->drawpos[num] = i;
+            px1[num] = x1[i];
+            px2[num++] = x2[i];
         }
-        self->data[i] = self->value;
     }
+    XnoiseMidi_draw(self, num);
 }
 
 static void XnoiseMidi_postprocessing_ii(XnoiseMidi *self) { POST_PROCESSING_II };
@@ -3955,34 +3905,17 @@ XnoiseMidi_setRandomType(XnoiseMidi *self)
 
     switch (self->type) {
         case 0:
-            self->type_func_ptr = XnoiseMidi_uniform;
-            break;
         case 1:
-            self->type_func_ptr = XnoiseMidi_linear_min;
-            break;
         case 2:
-            self->type_func_ptr = XnoiseMidi_linear_max;
-            break;
         case 3:
-            self->type_func_ptr = XnoiseMidi_triangle;
-            break;
         case 4:
-            self->type_func_ptr = XnoiseMidi_expon_min;
-            break;
         case 5:
-            self->type_func_ptr = XnoiseMidi_expon_max;
-            break;
         case 6:
-            self->type_func_ptr = XnoiseMidi_biexpon;
-            break;
         case 7:
-            self->type_func_ptr = XnoiseMidi_cauchy;
-            break;
         case 8:
-            self->type_func_ptr = XnoiseMidi_weibull;
-            break;
         case 9:
-            self->type_func_ptr = XnoiseMidi_gaussian;
+            self->type_func_ptr = NULL;
+            self->distribution = self->type;
             break;
         case 10:
             self->type_func_ptr = XnoiseMidi_poisson;
@@ -4097,6 +4030,8 @@ static void
 XnoiseMidi_dealloc(XnoiseMidi* self)
 {
     pyo_DEALLOC
+    free(self->draws);
+    free(self->drawpos);
     XnoiseMidi_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -4127,7 +4062,10 @@ XnoiseMidi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
 
-    Server_generateSeed((Server *)self->server, XNOISEMIDI_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, XNOISEMIDI_ID));
+
+    self->draws = (MYFLT *)realloc(self->draws, 3 * self->bufsize * sizeof(MYFLT));
+    self->drawpos = (int *)realloc(self->drawpos, self->bufsize * sizeof(int));
 
     self->poisson_tab = 0;
     self->lastPoissonX1 = -99.0;
@@ -4138,7 +4076,7 @@ XnoiseMidi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->loop_buffer[i] = 0.0;
     }
     self->loopChoice = self->loopCountPlay = self->loopTime = self->loopCountRec = self->loopStop = 0;
-    self->loopLen = (rand() % 10) + 3;
+    self->loopLen = (RANDOM_INT % 10) + 3;
 
     Stream_setFunctionPtr(self->stream, XnoiseMidi_compute_next_data_frame);
     self->mode_func_ptr = XnoiseMidi_setProcMode;
@@ -4511,6 +4449,7 @@ typedef struct {
     int loopLen;
     int loopStop;
     int modebuffer[6]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } XnoiseDur;
 
 // no parameter
@@ -4590,7 +4529,7 @@ XnoiseDur_cauchy(XnoiseDur *self) {
     }
     while (rnd == 0.5);
 
-    if (rand() < (RAND_MAX / 2))
+    if (RANDOM_INT < (RANDOM_MAX / 2))
         dir = -1;
     else
         dir = 1;
@@ -4651,7 +4590,7 @@ XnoiseDur_poisson(XnoiseDur *self) {
             }
         }
     }
-    val = self->poisson_buffer[rand() % self->poisson_tab] / 12.0 * self->xx2;
+    val = self->poisson_buffer[RANDOM_INT % self->poisson_tab] / 12.0 * self->xx2;
 
     if (val < 0.0) return 0.0;
     else if (val > 1.0) return 1.0;
@@ -4666,12 +4605,12 @@ XnoiseDur_walker(XnoiseDur *self) {
     if (self->xx2 < 0.002) self->xx2 = 0.002;
 
     modulo = (int)(self->xx2 * 1000.0);
-    dir = rand() % 2;
+    dir = RANDOM_INT % 2;
 
     if (dir == 0)
-        self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
     else
-        self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
     if (self->walkerValue > self->xx1)
         self->walkerValue = self->xx1;
@@ -4693,12 +4632,12 @@ XnoiseDur_loopseg(XnoiseDur *self) {
         if (self->xx2 < 0.002) self->xx2 = 0.002;
 
         modulo = (int)(self->xx2 * 1000.0);
-        dir = rand() % 2;
+        dir = RANDOM_INT % 2;
 
         if (dir == 0)
-            self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
         else
-            self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
         if (self->walkerValue > self->xx1)
             self->walkerValue = self->xx1;
@@ -4711,7 +4650,7 @@ XnoiseDur_loopseg(XnoiseDur *self) {
             self->loopChoice = 0;
         else {
             self->loopChoice = 1;
-            self->loopStop = (rand() % 4) + 1;
+            self->loopStop = (RANDOM_INT % 4) + 1;
         }
     }
     else {
@@ -4728,7 +4667,7 @@ XnoiseDur_loopseg(XnoiseDur *self) {
 
         if (self->loopTime == self->loopStop) {
             self->loopChoice = 0;
-            self->loopLen = (rand() % 10) + 3;
+            self->loopLen = (RANDOM_INT % 10) + 3;
         }
     }
 
@@ -4939,7 +4878,7 @@ XnoiseDur_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
 
-    Server_generateSeed((Server *)self->server, XNOISEDUR_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, XNOISEDUR_ID));
 
     self->poisson_tab = 0;
     self->lastPoissonX1 = -99.0;
@@ -4950,7 +4889,7 @@ XnoiseDur_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->loop_buffer[i] = 0.0;
     }
     self->loopChoice = self->loopCountPlay = self->loopTime = self->loopCountRec = self->loopStop = 0;
-    self->loopLen = (rand() % 10) + 3;
+    self->loopLen = (RANDOM_INT % 10) + 3;
 
     Stream_setFunctionPtr(self->stream, XnoiseDur_compute_next_data_frame);
     self->mode_func_ptr = XnoiseDur_setProcMode;
@@ -5313,6 +5252,7 @@ typedef struct {
     MYFLT *trigsBuffer;
     TriggerStream *trig_stream;
     int modebuffer[3]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } Urn;
 
 static void
@@ -5332,9 +5272,9 @@ Urn_choose(Urn *self) {
     int value = 0;
     int i, pick;
 
-    pick = rand() % self->length;
+    pick = RANDOM_INT % self->length;
     while (pick == self->lastvalue)
-        pick = rand() % self->length;
+        pick = RANDOM_INT % self->length;
 
     for (i=0; i<self->length; i++) {
         if (i != pick)
@@ -5537,11 +5477,12 @@ Urn_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     Urn_reset(self);
 
-    Server_generateSeed((Server *)self->server, URN_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, URN_ID));
 
     (*self->mode_func_ptr)(self);
 
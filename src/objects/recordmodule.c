@@ -26,6 +26,8 @@
 #include "dummymodule.h"
 #include "sndfile.h"
 #include "interpolation.h"
+#include "diskwriter.h"
+#include "eventfile.h"
 
 /************/
 /* Record */
@@ -41,6 +43,9 @@ typedef struct {
     char *recpath;
     SNDFILE *recfile;
     SF_INFO recinfo;
+    DiskWriter *writer;
+    unsigned long overflows;
+    unsigned long dropped;
     MYFLT *buffer;
 } Record;
 
@@ -70,7 +75,7 @@ Record_process(Record *self) {
     self->count++;
 
     if (self->count == self->buffering)
-        SF_WRITE(self->recfile, self->buffer, totlen);
+        DiskWriter_write(self->writer, self->buffer, self->bufsize*self->buffering);
 }
 
 static void
@@ -109,6 +114,7 @@ Record_dealloc(Record* self)
     if (Stream_getStreamActive(self->stream))
         PyObject_CallMethod((PyObject *)self, "stop", NULL);
     pyo_DEALLOC
+    DiskWriter_close(self->writer);
     free(self->buffer);
     Record_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -120,6 +126,8 @@ Record_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     int i, buflen;
     int fileformat = 0;
     int sampletype = 0;
+    double ringdur = 2.0;
+    long ringsize;
     PyObject *input_listtmp;
     Record *self;
     self = (Record *)type->tp_alloc(type, 0);
@@ -130,11 +138,12 @@ Record_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Record_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
     self->mode_func_ptr = Record_setProcMode;
 
-    static char *kwlist[] = {"input", "filename", "chnls", "fileformat", "sampletype", "buffering", NULL};
+    static char *kwlist[] = {"input", "filename", "chnls", "fileformat", "sampletype", "buffering", "ringdur", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "Os|iiii", kwlist, &input_listtmp, &self->recpath, &self->chnls, &fileformat, &sampletype, &self->buffering))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "Os|iiiid", kwlist, &input_listtmp, &self->recpath, &self->chnls, &fileformat, &sampletype, &self->buffering, &ringdur))
         Py_RETURN_NONE;
 
     Py_XDECREF(self->input_list);
@@ -207,6 +216,16 @@ Record_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         Py_RETURN_NONE;
     }
 
+    /* The file is written by the disk writer thread, the ring holds at least two buffers. */
+    ringsize = (long)(ringdur * self->sr);
+    if (ringsize < 2 * self->bufsize * self->buffering)
+        ringsize = 2 * self->bufsize * self->buffering;
+    if (! (self->writer = DiskWriter_new(self->recfile, self->chnls, ringsize))) {
+        printf("Record warning : unable to start the disk writer thread.\n");
+        sf_close(self->recfile);
+        Py_RETURN_NONE;
+    }
+
     buflen = self->bufsize * self->chnls * self->buffering;
     self->buffer = (MYFLT *)realloc(self->buffer, buflen * sizeof(MYFLT));
     for (i=0; i<buflen; i++) {
@@ -226,10 +245,23 @@ static PyObject * Record_getStream(Record* self) { GET_STREAM };
 static PyObject * Record_play(Record *self, PyObject *args, PyObject *kwds) { PLAY };
 static PyObject * Record_stop(Record *self)
 {
-    sf_close(self->recfile);
+    if (self->writer != NULL) {
+        self->overflows = DiskWriter_getOverflows(self->writer);
+        self->dropped = DiskWriter_getDropped(self->writer);
+        DiskWriter_close(self->writer);
+        self->writer = NULL;
+    }
     STOP
 };
 
+static PyObject *
+Record_getOverflows(Record *self)
+{
+    if (self->writer != NULL)
+        return Py_BuildValue("kk", DiskWriter_getOverflows(self->writer), DiskWriter_getDropped(self->writer));
+    return Py_BuildValue("kk", self->overflows, self->dropped);
+}
+
 static PyMemberDef Record_members[] = {
 {"server", T_OBJECT_EX, offsetof(Record, server), 0, "Pyo server."},
 {"stream", T_OBJECT_EX, offsetof(Record, stream), 0, "Stream object."},
@@ -242,6 +274,7 @@ static PyMethodDef Record_methods[] = {
 {"_getStream", (PyCFunction)Record_getStream, METH_NOARGS, "Returns stream object."},
 {"play", (PyCFunction)Record_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
 {"stop", (PyCFunction)Record_stop, METH_NOARGS, "Stops computing."},
+{"getOverflows", (PyCFunction)Record_getOverflows, METH_NOARGS, "Returns the number of dropped blocks and frames."},
 {NULL}  /* Sentinel */
 };
 
@@ -287,6 +320,29 @@ Record_members,                                 /* tp_members */
 Record_new,                                     /* tp_new */
 };
 
+/* The events of a file as a list of tuples (time in seconds, values...). */
+static PyObject *
+EventFile_getList(const char *path)
+{
+    long i;
+    int j;
+    EventFile *file;
+    PyObject *data, *point;
+
+    if ((file = EventFile_open(path)) == NULL)
+        return PyList_New(0);
+    data = PyList_New(file->numEvents);
+    for (i=0; i<file->numEvents; i++) {
+        point = PyTuple_New(file->nfields + 1);
+        PyTuple_SET_ITEM(point, 0, PyFloat_FromDouble(EventFile_getTime(file, i) / file->sr));
+        for (j=0; j<file->nfields; j++)
+            PyTuple_SET_ITEM(point, j + 1, PyFloat_FromDouble(EventFile_getField(file, i, j)));
+        PyList_SET_ITEM(data, i, point);
+    }
+    EventFile_close(file);
+    return data;
+}
+
 /************/
 /* ControlRec */
 /************/
@@ -302,6 +358,9 @@ typedef struct {
     long time;
     long size;
     MYFLT *buffer;
+    char *path; /* events written in this file instead of kept in memory */
+    EventWriter *writer;
+    unsigned long dropped;
 } ControlRec;
 
 static void
@@ -310,7 +369,18 @@ ControlRec_process(ControlRec *self) {
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    if (self->dur > 0.0) {
+    if (self->path != NULL) {
+        for (i=0; i<self->bufsize; i++) {
+            if ((self->time % self->modulo) == 0 && self->writer != NULL && (self->size == 0 || self->count < self->size)) {
+                EventWriter_write(self->writer, self->time, &in[i]);
+                self->count++;
+            }
+            self->time++;
+        }
+        if (self->size > 0 && self->count >= self->size)
+            PyObject_CallMethod((PyObject *)self, "stop", NULL);
+    }
+    else if (self->dur > 0.0) {
         for (i=0; i<self->bufsize; i++) {
             if ((self->time % self->modulo) == 0 && self->count < self->size) {
                 self->buffer[self->count] = in[i];
@@ -369,6 +439,8 @@ ControlRec_dealloc(ControlRec* self)
     pyo_DEALLOC
     if (self->buffer != NULL)
         free(self->buffer);
+    EventWriter_close(self->writer);
+    free(self->path);
     ControlRec_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -378,6 +450,7 @@ ControlRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i;
     long j;
+    char *path = NULL;
     PyObject *inputtmp, *input_streamtmp;
     ControlRec *self;
     self = (ControlRec *)type->tp_alloc(type, 0);
@@ -388,19 +461,25 @@ ControlRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, ControlRec_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = ControlRec_setProcMode;
 
-    static char *kwlist[] = {"input", "rate", "dur", NULL};
+    static char *kwlist[] = {"input", "rate", "dur", "path", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_O_IF, kwlist, &inputtmp, &self->rate, &self->dur))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_O_IFS, kwlist, &inputtmp, &self->rate, &self->dur, &path))
         Py_RETURN_NONE;
 
     INIT_INPUT_STREAM
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    if (self->dur > 0.0) {
+    if (path != NULL)
+        self->path = strdup(path);
+
+    if (self->dur > 0.0)
         self->size = (long)(self->dur * self->rate + 1);
+    if (self->dur > 0.0 && self->path == NULL) {
         self->buffer = (MYFLT *)realloc(self->buffer, self->size * sizeof(MYFLT));
         for (j=0; j<self->size; j++) {
             self->buffer[j] = 0.0;
@@ -416,20 +495,55 @@ ControlRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 static PyObject * ControlRec_getServer(ControlRec* self) { GET_SERVER };
 static PyObject * ControlRec_getStream(ControlRec* self) { GET_STREAM };
 
+static void
+ControlRec_closeFile(ControlRec *self)
+{
+    if (self->writer != NULL) {
+        self->dropped = EventWriter_getDropped(self->writer);
+        if (EventWriter_close(self->writer) < 0)
+            printf("ControlRec failed to write the file %s.\n", self->path);
+        self->writer = NULL;
+    }
+}
+
 static PyObject * ControlRec_play(ControlRec *self, PyObject *args, PyObject *kwds) {
     self->count = self->time = 0;
+    /* Times restart at 0, a new recording replaces the file. */
+    if (self->path != NULL) {
+        ControlRec_closeFile(self);
+        self->dropped = 0;
+        self->writer = EventWriter_new(self->path, 1, self->sr, self->rate * 2 > 1024 ? self->rate * 2 : 1024);
+        if (self->writer == NULL)
+            printf("ControlRec failed to open the file %s.\n", self->path);
+        Stream_setMemory(self->stream, EventWriter_getMemory(self->writer));
+    }
     PLAY
 };
 
 static PyObject * ControlRec_stop(ControlRec *self) { STOP };
 
+static PyObject *
+ControlRec_close(ControlRec *self) {
+    ControlRec_closeFile(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+ControlRec_getDropped(ControlRec *self) {
+    if (self->writer != NULL)
+        return PyLong_FromUnsignedLong(EventWriter_getDropped(self->writer));
+    return PyLong_FromUnsignedLong(self->dropped);
+}
+
 static PyObject *
 ControlRec_getData(ControlRec *self) {
     int i;
     PyObject *data, *point;
     MYFLT time, timescl = 1.0 / self->rate;
 
-    if (self->dur > 0.0) {
+    if (self->path != NULL)
+        data = EventFile_getList(self->path);
+    else if (self->dur > 0.0) {
         data = PyList_New(self->size);
         for (i=0; i<self->size; i++) {
             time = i * timescl;
@@ -466,6 +580,8 @@ static PyMethodDef ControlRec_methods[] = {
     {"play", (PyCFunction)ControlRec_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
     {"stop", (PyCFunction)ControlRec_stop, METH_NOARGS, "Stops computing."},
     {"getData", (PyCFunction)ControlRec_getData, METH_NOARGS, "Returns list of sampled points."},
+    {"close", (PyCFunction)ControlRec_close, METH_NOARGS, "Writes the pending events and closes the file."},
+    {"getDropped", (PyCFunction)ControlRec_getDropped, METH_NOARGS, "Returns the number of events dropped because the ring was full."},
     {NULL}  /* Sentinel */
 };
 
@@ -529,6 +645,8 @@ typedef struct {
     TriggerStream *trig_stream;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
     MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
+    EventFile *file; /* read instead of `values` if not NULL */
+    double ratio; /* samples of the file per sample of the server */
 } ControlRead;
 
 static void
@@ -566,6 +684,54 @@ ControlRead_readframes_i(ControlRead *self) {
     }
 }
 
+/* The events are read at their times, `rate` is ignored. The value between
+ * two events is interpolated from the four events around it. */
+static void
+ControlRead_readframes_file(ControlRead *self) {
+    long i, k, last = self->file->numEvents - 1;
+    double pos, t0 = 0.0, invdur = 0.0;
+    MYFLT frac, win[4];
+
+    if (self->go == 0)
+        PyObject_CallMethod((PyObject *)self, "stop", NULL);
+
+    win[0] = win[1] = win[2] = win[3] = 0.0;
+    k = -1;
+    for (i=0; i<self->bufsize; i++) {
+        self->trigsBuffer[i] = 0.0;
+        if (self->go == 0) {
+            self->data[i] = 0.0;
+            self->time++;
+            continue;
+        }
+        pos = self->time * self->ratio;
+        while (self->count < last && EventFile_getTime(self->file, self->count + 1) <= pos)
+            self->count++;
+        if (self->count != k) {
+            k = self->count;
+            win[0] = EventFile_getField(self->file, k > 0 ? k - 1 : 0, 0);
+            win[1] = EventFile_getField(self->file, k, 0);
+            win[2] = EventFile_getField(self->file, k < last ? k + 1 : last, 0);
+            win[3] = EventFile_getField(self->file, k < last - 1 ? k + 2 : last, 0);
+            t0 = (double)EventFile_getTime(self->file, k);
+            invdur = k < last ? 1.0 / (EventFile_getTime(self->file, k + 1) - t0) : 0.0;
+        }
+        frac = (MYFLT)((pos - t0) * invdur);
+        if (frac < 0.0)
+            frac = 0.0;
+        self->data[i] = (*self->interp_func_ptr)(win, 1, frac, 4);
+
+        self->time++;
+        if (pos >= EventFile_getTime(self->file, last)) {
+            self->trigsBuffer[i] = 1.0;
+            if (self->loop == 1)
+                self->time = self->count = 0;
+            else
+                self->go = 0;
+        }
+    }
+}
+
 static void ControlRead_postprocessing_ii(ControlRead *self) { POST_PROCESSING_II };
 static void ControlRead_postprocessing_ai(ControlRead *self) { POST_PROCESSING_AI };
 static void ControlRead_postprocessing_ia(ControlRead *self) { POST_PROCESSING_IA };
@@ -582,7 +748,12 @@ ControlRead_setProcMode(ControlRead *self)
     int muladdmode;
     muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
 
-    self->proc_func_ptr = ControlRead_readframes_i;
+    if (self->file != NULL) {
+        self->proc_func_ptr = ControlRead_readframes_file;
+    }
+    else {
+        self->proc_func_ptr = ControlRead_readframes_i;
+    }
 
 	switch (muladdmode) {
         case 0:
@@ -644,6 +815,7 @@ ControlRead_dealloc(ControlRead* self)
     pyo_DEALLOC
     free(self->values);
     free(self->trigsBuffer);
+    EventFile_close(self->file);
     ControlRead_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -665,6 +837,7 @@ ControlRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, ControlRead_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = ControlRead_setProcMode;
 
     static char *kwlist[] = {"values", "rate", "loop", "interp", "mul", "add", NULL};
@@ -672,7 +845,10 @@ ControlRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|iiiOO", kwlist, &valuestmp, &self->rate, &self->loop, &self->interp, &multmp, &addtmp))
         Py_RETURN_NONE;
 
-    if (valuestmp) {
+    if (valuestmp && PyString_Check(valuestmp)) {
+        PyObject_CallMethod((PyObject *)self, "setFile", "O", valuestmp);
+    }
+    else if (valuestmp) {
         PyObject_CallMethod((PyObject *)self, "setValues", "O", valuestmp);
     }
 
@@ -693,6 +869,7 @@ ControlRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     self->modulo = (int)(self->sr / self->rate);
@@ -749,11 +926,69 @@ ControlRead_setValues(ControlRead *self, PyObject *arg)
     for (i=0; i<self->size; i++) {
         self->values[i] = PyFloat_AS_DOUBLE(PyList_GET_ITEM(arg, i));
     }
+    EventFile_close(self->file);
+    self->file = NULL;
+    (*self->mode_func_ptr)(self);
 
 	Py_INCREF(Py_None);
 	return Py_None;
 }
 
+static PyObject *
+ControlRead_setFile(ControlRead *self, PyObject *arg)
+{
+    char *path;
+    EventFile *file;
+
+    if (arg == NULL || ! PyString_Check(arg)) {
+        PyErr_SetString(PyExc_TypeError, "ControlRead.setFile : argument must be the path of an event file.");
+        return PyInt_FromLong(-1);
+    }
+
+    path = PyString_AsString(arg);
+    file = EventFile_open(path);
+    if (file == NULL || file->numEvents == 0) {
+        printf("ControlRead failed to open the event file %s.\n", path);
+        EventFile_close(file);
+        Py_RETURN_NONE;
+    }
+    EventFile_close(self->file);
+    self->file = file;
+    self->ratio = file->sr / self->sr;
+    self->count = self->time = 0;
+    (*self->mode_func_ptr)(self);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+ControlRead_seek(ControlRead *self, PyObject *arg)
+{
+    double pos;
+
+    if (arg == NULL || ! PyNumber_Check(arg))
+        Py_RETURN_NONE;
+
+    pos = PyFloat_AsDouble(arg);
+    if (pos < 0.0)
+        pos = 0.0;
+    if (self->file != NULL) {
+        self->time = (long)(pos * self->sr);
+        /* The last event at or before the new position. */
+        self->count = EventFile_search(self->file, (int64_t)(self->time * self->ratio) + 1) - 1;
+        if (self->count < 0)
+            self->count = 0;
+    }
+    else if (self->size > 0) {
+        self->count = (long)(pos * self->rate);
+        if (self->count >= self->size)
+            self->count = self->size - 1;
+        self->time = self->count * self->modulo;
+    }
+
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 ControlRead_setRate(ControlRead *self, PyObject *arg)
 {
@@ -819,6 +1054,8 @@ static PyMethodDef ControlRead_methods[] = {
     {"play", (PyCFunction)ControlRead_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
     {"stop", (PyCFunction)ControlRead_stop, METH_NOARGS, "Stops computing."},
     {"setValues", (PyCFunction)ControlRead_setValues, METH_O, "Fill buffer with values in input."},
+    {"setFile", (PyCFunction)ControlRead_setFile, METH_O, "Reads the values from an event file."},
+    {"seek", (PyCFunction)ControlRead_seek, METH_O, "Moves the reading position, in seconds."},
     {"setRate", (PyCFunction)ControlRead_setRate, METH_O, "Sets reading rate."},
     {"setLoop", (PyCFunction)ControlRead_setLoop, METH_O, "Sets the looping mode."},
     {"setInterp", (PyCFunction)ControlRead_setInterp, METH_O, "Sets reader interpolation mode."},
@@ -928,12 +1165,15 @@ typedef struct {
     MYFLT last_pitch;
     MYFLT last_vel;
     long time;
+    char *path; /* events written in this file instead of kept in memory */
+    EventWriter *writer;
+    unsigned long dropped;
 } NoteinRec;
 
 static void
 NoteinRec_process(NoteinRec *self) {
     int i;
-    MYFLT pit, vel;
+    MYFLT pit, vel, fields[2];
 
     MYFLT *inp = Stream_getData((Stream *)self->inputp_stream);
     MYFLT *inv = Stream_getData((Stream *)self->inputv_stream);
@@ -944,9 +1184,17 @@ NoteinRec_process(NoteinRec *self) {
         if (pit != self->last_pitch || vel != self->last_vel) {
             self->last_pitch = pit;
             self->last_vel = vel;
-            PyList_Append(self->tmp_list_p, PyFloat_FromDouble(pit));
-            PyList_Append(self->tmp_list_v, PyFloat_FromDouble(vel));
-            PyList_Append(self->tmp_list_t, PyFloat_FromDouble( (float)self->time / self->sr) );
+            if (self->path != NULL) {
+                fields[0] = pit;
+                fields[1] = vel;
+                if (self->writer != NULL)
+                    EventWriter_write(self->writer, self->time, fields);
+            }
+            else {
+                PyList_Append(self->tmp_list_p, PyFloat_FromDouble(pit));
+                PyList_Append(self->tmp_list_v, PyFloat_FromDouble(vel));
+                PyList_Append(self->tmp_list_t, PyFloat_FromDouble( (float)self->time / self->sr) );
+            }
         }
         self->time++;
     }
@@ -996,6 +1244,8 @@ static void
 NoteinRec_dealloc(NoteinRec* self)
 {
     pyo_DEALLOC
+    EventWriter_close(self->writer);
+    free(self->path);
     NoteinRec_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1004,6 +1254,7 @@ static PyObject *
 NoteinRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i;
+    char *path = NULL;
     PyObject *inputptmp, *inputp_streamtmp, *inputvtmp, *inputv_streamtmp;
     NoteinRec *self;
     self = (NoteinRec *)type->tp_alloc(type, 0);
@@ -1015,13 +1266,18 @@ NoteinRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, NoteinRec_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = NoteinRec_setProcMode;
 
-    static char *kwlist[] = {"inputp", "inputv", NULL};
+    static char *kwlist[] = {"inputp", "inputv", "path", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, "OO", kwlist, &inputptmp, &inputvtmp))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "OO|s", kwlist, &inputptmp, &inputvtmp, &path))
         Py_RETURN_NONE;
 
+    if (path != NULL)
+        self->path = strdup(path);
+
     Py_XDECREF(self->inputp);
     self->inputp = inputptmp;
     inputp_streamtmp = PyObject_CallMethod((PyObject *)self->inputp, "_getStream", NULL);
@@ -1046,18 +1302,54 @@ NoteinRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 static PyObject * NoteinRec_getServer(NoteinRec* self) { GET_SERVER };
 static PyObject * NoteinRec_getStream(NoteinRec* self) { GET_STREAM };
 
+static void
+NoteinRec_closeFile(NoteinRec *self)
+{
+    if (self->writer != NULL) {
+        self->dropped = EventWriter_getDropped(self->writer);
+        if (EventWriter_close(self->writer) < 0)
+            printf("NoteinRec failed to write the file %s.\n", self->path);
+        self->writer = NULL;
+    }
+}
+
 static PyObject * NoteinRec_play(NoteinRec *self, PyObject *args, PyObject *kwds) {
     self->time = 0;
+    /* Times restart at 0, a new recording replaces the file. */
+    if (self->path != NULL) {
+        NoteinRec_closeFile(self);
+        self->dropped = 0;
+        self->writer = EventWriter_new(self->path, 2, self->sr, 1024);
+        if (self->writer == NULL)
+            printf("NoteinRec failed to open the file %s.\n", self->path);
+        Stream_setMemory(self->stream, EventWriter_getMemory(self->writer));
+    }
     PLAY
 };
 
 static PyObject * NoteinRec_stop(NoteinRec *self) { STOP };
 
+static PyObject *
+NoteinRec_close(NoteinRec *self) {
+    NoteinRec_closeFile(self);
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+NoteinRec_getDropped(NoteinRec *self) {
+    if (self->writer != NULL)
+        return PyLong_FromUnsignedLong(EventWriter_getDropped(self->writer));
+    return PyLong_FromUnsignedLong(self->dropped);
+}
+
 static PyObject *
 NoteinRec_getData(NoteinRec *self) {
     int i;
     PyObject *data, *point;
 
+    if (self->path != NULL)
+        return EventFile_getList(self->path);
+
     Py_ssize_t size = PyList_Size(self->tmp_list_p);
     data = PyList_New(size);
 
@@ -1085,6 +1377,8 @@ static PyMethodDef NoteinRec_methods[] = {
     {"play", (PyCFunction)NoteinRec_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
     {"stop", (PyCFunction)NoteinRec_stop, METH_NOARGS, "Stops computing."},
     {"getData", (PyCFunction)NoteinRec_getData, METH_NOARGS, "Returns list of sampled points."},
+    {"close", (PyCFunction)NoteinRec_close, METH_NOARGS, "Writes the pending events and closes the file."},
+    {"getDropped", (PyCFunction)NoteinRec_getDropped, METH_NOARGS, "Returns the number of events dropped because the ring was full."},
     {NULL}  /* Sentinel */
 };
 
@@ -1146,6 +1440,9 @@ typedef struct {
     long size;
     MYFLT *trigsBuffer;
     TriggerStream *trig_stream;
+    EventFile *file; /* read instead of `values` and `timestamps` if not NULL */
+    int field;
+    double ratio; /* samples of the file per sample of the server */
 } NoteinRead;
 
 static void
@@ -1180,6 +1477,38 @@ NoteinRead_readframes_i(NoteinRead *self) {
     }
 }
 
+static void
+NoteinRead_readframes_file(NoteinRead *self) {
+    long i, size = self->file->numEvents;
+    double pos;
+
+    if (self->go == 0)
+        PyObject_CallMethod((PyObject *)self, "stop", NULL);
+
+    for (i=0; i<self->bufsize; i++) {
+        self->trigsBuffer[i] = 0.0;
+        if (self->go == 1) {
+            pos = self->time * self->ratio;
+            while (self->count < size && EventFile_getTime(self->file, self->count) <= pos) {
+                self->value = EventFile_getField(self->file, self->count, self->field);
+                self->count++;
+            }
+            self->data[i] = self->value;
+        }
+        else
+            self->data[i] = 0.0;
+
+        if (self->count >= size) {
+            self->trigsBuffer[i] = 1.0;
+            if (self->loop == 1)
+                self->time = self->count = 0;
+            else
+                self->go = 0;
+        }
+        self->time++;
+    }
+}
+
 static void NoteinRead_postprocessing_ii(NoteinRead *self) { POST_PROCESSING_II };
 static void NoteinRead_postprocessing_ai(NoteinRead *self) { POST_PROCESSING_AI };
 static void NoteinRead_postprocessing_ia(NoteinRead *self) { POST_PROCESSING_IA };
@@ -1196,7 +1525,12 @@ NoteinRead_setProcMode(NoteinRead *self)
     int muladdmode;
     muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
 
-    self->proc_func_ptr = NoteinRead_readframes_i;
+    if (self->file != NULL) {
+        self->proc_func_ptr = NoteinRead_readframes_file;
+    }
+    else {
+        self->proc_func_ptr = NoteinRead_readframes_i;
+    }
 
 	switch (muladdmode) {
         case 0:
@@ -1259,6 +1593,7 @@ NoteinRead_dealloc(NoteinRead* self)
     free(self->values);
     free(self->timestamps);
     free(self->trigsBuffer);
+    EventFile_close(self->file);
     NoteinRead_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -1279,6 +1614,7 @@ NoteinRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, NoteinRead_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = NoteinRead_setProcMode;
 
     static char *kwlist[] = {"values", "timestamps", "loop", "mul", "add", NULL};
@@ -1286,11 +1622,12 @@ NoteinRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     if (! PyArg_ParseTupleAndKeywords(args, kwds, "OO|iOO", kwlist, &valuestmp, &timestampstmp, &self->loop, &multmp, &addtmp))
         Py_RETURN_NONE;
 
-    if (valuestmp) {
-        PyObject_CallMethod((PyObject *)self, "setValues", "O", valuestmp);
+    /* An event file gives the values and the timestamps, `timestamps` is the field to read. */
+    if (PyString_Check(valuestmp)) {
+        PyObject_CallMethod((PyObject *)self, "setFile", "OO", valuestmp, timestampstmp);
     }
-
-    if (timestampstmp) {
+    else {
+        PyObject_CallMethod((PyObject *)self, "setValues", "O", valuestmp);
         PyObject_CallMethod((PyObject *)self, "setTimestamps", "O", timestampstmp);
     }
 
@@ -1311,6 +1648,7 @@ NoteinRead_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     (*self->mode_func_ptr)(self);
@@ -1363,6 +1701,9 @@ NoteinRead_setValues(NoteinRead *self, PyObject *arg)
     for (i=0; i<self->size; i++) {
         self->values[i] = PyFloat_AS_DOUBLE(PyList_GET_ITEM(arg, i));
     }
+    EventFile_close(self->file);
+    self->file = NULL;
+    (*self->mode_func_ptr)(self);
 
 	Py_INCREF(Py_None);
 	return Py_None;
@@ -1388,6 +1729,68 @@ NoteinRead_setTimestamps(NoteinRead *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+NoteinRead_setFile(NoteinRead *self, PyObject *args)
+{
+    char *path;
+    int field = 0;
+    EventFile *file;
+
+    if (! PyArg_ParseTuple(args, "s|i", &path, &field))
+        return PyInt_FromLong(-1);
+
+    file = EventFile_open(path);
+    if (file == NULL || file->numEvents == 0 || field < 0 || field >= file->nfields) {
+        printf("NoteinRead failed to open the event file %s.\n", path);
+        EventFile_close(file);
+        Py_RETURN_NONE;
+    }
+    EventFile_close(self->file);
+    self->file = file;
+    self->field = field;
+    self->ratio = file->sr / self->sr;
+    self->count = self->time = 0;
+    (*self->mode_func_ptr)(self);
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+NoteinRead_seek(NoteinRead *self, PyObject *arg)
+{
+    long low, high, mid;
+    double pos;
+
+    if (arg == NULL || ! PyNumber_Check(arg))
+        Py_RETURN_NONE;
+
+    pos = PyFloat_AsDouble(arg);
+    if (pos < 0.0)
+        pos = 0.0;
+    self->time = (long)(pos * self->sr);
+    /* The first event at or after the new position, the value is the one of the previous event. */
+    if (self->file != NULL) {
+        self->count = EventFile_search(self->file, (int64_t)ceil(self->time * self->ratio));
+        self->value = self->count > 0 ? EventFile_getField(self->file, self->count - 1, self->field) : 0.0;
+    }
+    else if (self->size > 0) {
+        low = 0;
+        high = self->size;
+        while (low < high) {
+            mid = low + (high - low) / 2;
+            if (self->timestamps[mid] < self->time)
+                low = mid + 1;
+            else
+                high = mid;
+        }
+        /* Past the end, the last event is read again. */
+        self->count = low < self->size ? low : self->size - 1;
+        self->value = self->count > 0 ? self->values[self->count - 1] : 0.0;
+    }
+
+    Py_RETURN_NONE;
+}
+
 static PyObject *
 NoteinRead_setLoop(NoteinRead *self, PyObject *arg)
 {
@@ -1419,6 +1822,8 @@ static PyMethodDef NoteinRead_methods[] = {
     {"stop", (PyCFunction)NoteinRead_stop, METH_NOARGS, "Stops computing."},
     {"setValues", (PyCFunction)NoteinRead_setValues, METH_O, "Fill buffer with values in input."},
     {"setTimestamps", (PyCFunction)NoteinRead_setTimestamps, METH_O, "Fill buffer with timestamps in input."},
+    {"setFile", (PyCFunction)NoteinRead_setFile, METH_VARARGS, "Reads the values and the timestamps from an event file."},
+    {"seek", (PyCFunction)NoteinRead_seek, METH_O, "Moves the reading position, in seconds."},
     {"setLoop", (PyCFunction)NoteinRead_setLoop, METH_O, "Sets the looping mode."},
     {"setMul", (PyCFunction)NoteinRead_setMul, METH_O, "Sets oscillator mul factor."},
     {"setAdd", (PyCFunction)NoteinRead_setAdd, METH_O, "Sets oscillator add factor."},
@@ -27,6 +27,9 @@
 #include "dummymodule.h"
 #include "sndfile.h"
 #include "interpolation.h"
+#include "tablemodule.h"
+#include "diskstream.h"
+#include "resampler.h"
 
 /* SfPlayer object */
 typedef struct {
@@ -36,9 +39,10 @@ typedef struct {
     int modebuffer[1];
     SNDFILE *sf;
     SF_INFO info;
+    DiskStream *disk;
     char *path;
     int loop;
-    int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
+    int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic, 5 = sinc */
     int sndSize; /* number of frames */
     int sndChnls;
     int sndSr;
@@ -50,6 +54,7 @@ typedef struct {
     TriggerStream *trig_stream;
     int init;
     MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
+    Resampler *resampler; /* windowed-sinc interpolation, from the file to the server rate */
 } SfPlayer;
 
 MYFLT max_arr(MYFLT *a,int n)
@@ -76,11 +81,49 @@ MYFLT min_arr(MYFLT *a,int n)
     return m;
 }
 
+/* Builds the sinc interpolator for the sampling rate of the file, when
+ * interp is 5. Its cutoff follows the ratio between the rates of the file
+ * and the server, not the speed. */
+static void
+SfPlayer_setResampler(SfPlayer *self)
+{
+    if (self->interp == 5) {
+        /* fallback when the sampling rate is unknown */
+        self->interp_func_ptr = cubic;
+        if (self->resampler != NULL && self->resampler->insr == self->sndSr)
+            return;
+        Resampler_free(self->resampler);
+        self->resampler = Resampler_new(self->sndSr, self->sr, RESAMPLER_DEFAULT_QUALITY);
+    }
+    else {
+        Resampler_free(self->resampler);
+        self->resampler = NULL;
+    }
+}
+
+/* Reads one channel of the buffer at the positions index[i] + frac[i]. */
+static void
+SfPlayer_interpolate(SfPlayer *self, MYFLT *buf, int *index, MYFLT *frac, MYFLT *out, int size)
+{
+    int i;
+
+    if (self->resampler != NULL) {
+        for (i=0; i<self->bufsize; i++) {
+            out[i] = Resampler_interpolate(self->resampler, buf, index[i], frac[i]);
+        }
+    }
+    else
+        (*TableInterp_getBlock(self->interp == 5 ? 4 : self->interp, TABLE_NATIVE))(buf, index, frac, out, self->bufsize, size);
+}
+
 static void
 SfPlayer_readframes_i(SfPlayer *self) {
-    MYFLT sp, frac, bufpos, delta, startPos;
-    int i, j, totlen, buflen, shortbuflen, pad, bufindex;
-    sf_count_t index;
+    MYFLT sp, bufpos, delta, startPos;
+    int i, j, totlen, buflen, shortbuflen, pad, margin, lead, readlen;
+    sf_count_t index, first;
+    MYFLT *readbuf;
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
 
     if (self->modebuffer[0] == 0)
         sp = PyFloat_AS_DOUBLE(self->speed);
@@ -88,7 +131,9 @@ SfPlayer_readframes_i(SfPlayer *self) {
         sp = Stream_getData((Stream *)self->speed_stream)[0];
     delta = MYFABS(sp) * self->srScale;
 
-    buflen = (int)(self->bufsize * delta + 0.5) + 64;
+    /* the sinc interpolation reads `margin` samples on each side */
+    margin = self->resampler != NULL ? self->resampler->taps / 2 : 0;
+    buflen = (int)(self->bufsize * delta + 0.5) + 64 + 2 * margin;
     totlen = self->sndChnls*buflen;
     MYFLT buffer[totlen];
     MYFLT buffer2[self->sndChnls][buflen];
@@ -107,31 +152,32 @@ SfPlayer_readframes_i(SfPlayer *self) {
                 return;
             }
         }
-        index = (int)self->pointerPos;
-        sf_seek(self->sf, index, SEEK_SET); /* sets position pointer in the file */
+        /* first frame of the buffer, zeros before the beginning of the file */
+        first = (int)self->pointerPos - margin;
+        lead = first < 0 ? (int)-first : 0;
+        for (i=0; i<(lead*self->sndChnls); i++) {
+            buffer[i] = 0.;
+        }
+        index = first + lead;
+        readlen = buflen - lead;
+        readbuf = buffer + lead*self->sndChnls;
 
         /* fill a buffer with enough samples to satisfy speed reading */
         /* if not enough samples left in the file */
-        if ((index+buflen) > self->sndSize) {
+        if ((index+readlen) > self->sndSize) {
             shortbuflen = self->sndSize - index;
-            pad = (buflen-shortbuflen)*self->sndChnls;
-            SF_READ(self->sf, buffer, shortbuflen*self->sndChnls);
+            pad = (readlen-shortbuflen)*self->sndChnls;
+            DiskStream_read(self->disk, index, readbuf, shortbuflen*self->sndChnls);
             if (self->loop == 0) { /* with zero padding if noloop */
                 for (i=0; i<pad; i++) {
-                    buffer[i+shortbuflen*self->sndChnls] = 0.;
-                }
-            }
-            else { /* wrap around and read new samples if loop */
-                MYFLT buftemp[pad];
-                sf_seek(self->sf, (int)self->startPos, SEEK_SET);
-                SF_READ(self->sf, buftemp, pad);
-                for (i=0; i<(pad); i++) {
-                    buffer[i+shortbuflen*self->sndChnls] = buftemp[i];
+                    readbuf[i+shortbuflen*self->sndChnls] = 0.;
                 }
             }
+            else /* wrap around and read new samples if loop */
+                DiskStream_read(self->disk, (int)self->startPos, readbuf+shortbuflen*self->sndChnls, pad);
         }
         else /* without zero padding */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index, readbuf, readlen*self->sndChnls);
 
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -141,16 +187,17 @@ SfPlayer_readframes_i(SfPlayer *self) {
         /* fill samplesBuffer with samples */
         for (i=0; i<self->bufsize; i++) {
             self->trigsBuffer[i] = 0.0;
-            bufpos = self->pointerPos - index;
-            bufindex = (int)bufpos;
-            frac = bufpos - bufindex;
-            for (j=0; j<self->sndChnls; j++) {
-                self->samplesBuffer[i+(j*self->bufsize)] = (*self->interp_func_ptr)(buffer2[j], bufindex, frac, buflen);
-            }
+            bufpos = self->pointerPos - first;
+            ipos[i] = (int)bufpos;
+            fpos[i] = bufpos - ipos[i];
             self->pointerPos += delta;
         }
+        for (j=0; j<self->sndChnls; j++) {
+            SfPlayer_interpolate(self, buffer2[j], ipos, fpos, self->samplesBuffer + j * self->bufsize, buflen);
+        }
         if (self->pointerPos >= self->sndSize)
             self->trigsBuffer[0] = 1.0;
+        DiskStream_hint(self->disk, (long)self->pointerPos, 1, self->sndSize, self->loop ? (long)self->startPos : -1);
     }
     else if (sp < 0){ /* backward reading */
         startPos = self->startPos;
@@ -173,13 +220,20 @@ SfPlayer_readframes_i(SfPlayer *self) {
             }
         }
 
-        index = (int)self->pointerPos + 1;
+        /* end of the buffer, zeros after the end of the file */
+        first = (int)self->pointerPos + 1 + margin;
+        lead = first > self->sndSize ? (int)(first - self->sndSize) : 0;
+        for (i=((buflen-lead)*self->sndChnls); i<totlen; i++) {
+            buffer[i] = 0.;
+        }
+        index = first - lead;
+        readlen = buflen - lead;
 
         /* fill a buffer with enough samples to satisfy speed reading */
         /* if not enough samples to read in the file */
-        if ((index-buflen) < 0) {
+        if ((index-readlen) < 0) {
             shortbuflen = index;
-            int pad = buflen - shortbuflen;
+            int pad = readlen - shortbuflen;
             int padlen = pad*self->sndChnls;
 
             if (self->loop == 0) { /* with zero padding if noloop */
@@ -187,25 +241,13 @@ SfPlayer_readframes_i(SfPlayer *self) {
                     buffer[i] = 0.;
                 }
             }
-            else { /* wrap around and read new samples if loop */
-                MYFLT buftemp[padlen];
-                sf_seek(self->sf, (int)startPos-pad, SEEK_SET);
-                SF_READ(self->sf, buftemp, padlen);
-                for (i=0; i<padlen; i++) {
-                    buffer[i] = buftemp[i];
-                }
-            }
+            else /* wrap around and read new samples if loop */
+                DiskStream_read(self->disk, (int)startPos-pad, buffer, padlen);
 
-            MYFLT buftemp2[shortbuflen*self->sndChnls];
-            sf_seek(self->sf, 0, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buftemp2, shortbuflen*self->sndChnls);
-            for (i=0; i<(shortbuflen*self->sndChnls); i++) {
-                buffer[i+padlen] = buftemp2[i];
-            }
+            DiskStream_read(self->disk, 0, buffer+padlen, shortbuflen*self->sndChnls);
         }
         else /* without zero padding */
-            sf_seek(self->sf, index-buflen, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index-readlen, buffer, readlen*self->sndChnls);
 
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -227,20 +269,21 @@ SfPlayer_readframes_i(SfPlayer *self) {
         /* fill stream buffer with samples */
         for (i=0; i<self->bufsize; i++) {
             self->trigsBuffer[i] = 0.0;
-            bufpos = index - self->pointerPos;
-            bufindex = (int)bufpos;
-            frac = bufpos - bufindex;
-            for (j=0; j<self->sndChnls; j++) {
-                self->samplesBuffer[i+(j*self->bufsize)] = (*self->interp_func_ptr)(buffer2[j], bufindex, frac, buflen);
-            }
+            bufpos = first - self->pointerPos;
+            ipos[i] = (int)bufpos;
+            fpos[i] = bufpos - ipos[i];
             self->pointerPos -= delta;
         }
+        for (j=0; j<self->sndChnls; j++) {
+            SfPlayer_interpolate(self, buffer2[j], ipos, fpos, self->samplesBuffer + j * self->bufsize, buflen);
+        }
         if (self->pointerPos <= 0) {
             if (self->init == 0)
                 self->trigsBuffer[0] = 1.0;
             else
                 self->init = 0;
         }
+        DiskStream_hint(self->disk, (long)self->pointerPos, -1, 0, self->loop ? (long)startPos + 1 : -1);
     }
     else { /* speed == 0.0 */
         for (i = 0; i < (self->bufsize*self->sndChnls); i++) {
@@ -285,8 +328,10 @@ static void
 SfPlayer_dealloc(SfPlayer* self)
 {
     pyo_DEALLOC
+    DiskStream_free(self->disk);
     if (self->sf != NULL)
         sf_close(self->sf);
+    Resampler_free(self->resampler);
     free(self->trigsBuffer);
     free(self->samplesBuffer);
     SfPlayer_clear(self);
@@ -310,6 +355,7 @@ SfPlayer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, SfPlayer_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = SfPlayer_setProcMode;
 
     static char *kwlist[] = {"path", "speed", "loop", "offset", "interp", NULL};
@@ -334,10 +380,12 @@ SfPlayer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     {
         printf("Failed to open the file.\n");
     }
+    self->disk = DiskStream_new(self->path, self->sf, &self->info);
     self->sndSize = self->info.frames;
     self->sndSr = self->info.samplerate;
     self->sndChnls = self->info.channels;
     self->srScale = self->sndSr / self->sr;
+    SfPlayer_setResampler(self);
 
     self->samplesBuffer = (MYFLT *)realloc(self->samplesBuffer, self->bufsize * self->sndChnls * sizeof(MYFLT));
     self->trigsBuffer = (MYFLT *)realloc(self->trigsBuffer, self->bufsize * sizeof(MYFLT));
@@ -347,6 +395,7 @@ SfPlayer_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     self->startPos = offset * self->sr * self->srScale;
@@ -423,6 +472,7 @@ SfPlayer_setSound(SfPlayer *self, PyObject *arg)
 
     self->path = PyString_AsString(arg);
 
+    DiskStream_free(self->disk);
     sf_close(self->sf);
 
     /* Open the sound file. */
@@ -432,10 +482,12 @@ SfPlayer_setSound(SfPlayer *self, PyObject *arg)
     {
         printf("Failed to open the file.\n");
     }
+    self->disk = DiskStream_new(self->path, self->sf, &self->info);
     self->sndSize = self->info.frames;
     self->sndSr = self->info.samplerate;
     //self->sndChnls = self->info.channels;
     self->srScale = self->sndSr / self->sr;
+    SfPlayer_setResampler(self);
 
     //self->samplesBuffer = (MYFLT *)realloc(self->samplesBuffer, self->bufsize * self->sndChnls * sizeof(MYFLT));
 
@@ -495,6 +547,7 @@ SfPlayer_setInterp(SfPlayer *self, PyObject *arg)
     }
 
     SET_INTERP_POINTER
+    SfPlayer_setResampler(self);
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -840,6 +893,7 @@ typedef struct {
     int modebuffer[1];
     SNDFILE *sf;
     SF_INFO info;
+    DiskStream *disk;
     char *path;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
     int sndSize; /* number of frames */
@@ -856,6 +910,7 @@ typedef struct {
     MYFLT *markers;
     int markers_size;
     MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
+    PyoRand rng;
 } SfMarkerShuffler;
 
 /*** PROTOTYPES ***/
@@ -893,26 +948,22 @@ SfMarkerShuffler_readframes_i(SfMarkerShuffler *self) {
             self->lastDir = 1;
         }
         index = (int)self->pointerPos;
-        sf_seek(self->sf, index, SEEK_SET); /* sets position pointer in the file */
 
         /* fill a buffer with enough samples to satisfy speed reading */
         /* if not enough samples to read in the file */
         if ((index+buflen) > self->endPos) {
             shortbuflen = self->endPos - index;
-            SF_READ(self->sf, buffer, shortbuflen*self->sndChnls);
+            if (shortbuflen < 0) /* already past a marker set for the other direction */
+                shortbuflen = 0;
+            DiskStream_read(self->disk, index, buffer, shortbuflen*self->sndChnls);
 
             /* wrap around and read new samples from new marker */
             int pad = buflen - shortbuflen;
             int padlen = pad*self->sndChnls;
-            MYFLT buftemp[padlen];
-            sf_seek(self->sf, (int)self->nextStartPos, SEEK_SET);
-            SF_READ(self->sf, buftemp, padlen);
-            for (i=0; i<padlen; i++) {
-                buffer[i+shortbuflen*self->sndChnls] = buftemp[i];
-            }
+            DiskStream_read(self->disk, (int)self->nextStartPos, buffer+shortbuflen*self->sndChnls, padlen);
         }
         else /* without wraparound */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index, buffer, totlen);
 
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -934,6 +985,7 @@ SfMarkerShuffler_readframes_i(SfMarkerShuffler *self) {
             SfMarkerShuffler_chooseNewMark((SfMarkerShuffler *)self, 1);
             self->pointerPos = self->startPos + off;
         }
+        DiskStream_hint(self->disk, (long)self->pointerPos, 1, (long)self->endPos, (long)self->nextStartPos);
     }
     else if (sp < 0) { /* reading backward */
         if (self->startPos == -1 || self->lastDir != -1) {
@@ -947,27 +999,17 @@ SfMarkerShuffler_readframes_i(SfMarkerShuffler *self) {
         /* if not enough samples to read in the file */
         if ((index-buflen) < self->endPos) {
             shortbuflen = index - self->endPos;
+            if (shortbuflen < 0)
+                shortbuflen = 0;
             int pad = buflen - shortbuflen;
             int padlen = pad*self->sndChnls;
 
             /* wrap around and read new samples from new marker */
-            MYFLT buftemp[padlen];
-            sf_seek(self->sf, (int)self->nextStartPos-pad, SEEK_SET);
-            SF_READ(self->sf, buftemp, padlen);
-            for (i=0; i<padlen; i++) {
-                buffer[i] = buftemp[i];
-            }
-
-            MYFLT buftemp2[shortbuflen*self->sndChnls];
-            sf_seek(self->sf, self->endPos, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buftemp2, shortbuflen*self->sndChnls);
-            for (i=0; i<(shortbuflen*self->sndChnls); i++) {
-                buffer[i+padlen] = buftemp2[i];
-            }
+            DiskStream_read(self->disk, (int)self->nextStartPos-pad, buffer, padlen);
+            DiskStream_read(self->disk, (int)self->endPos, buffer+padlen, shortbuflen*self->sndChnls);
         }
         else { /* without wraparound */
-            sf_seek(self->sf, index-buflen, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index-buflen, buffer, totlen);
         }
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -1001,6 +1043,7 @@ SfMarkerShuffler_readframes_i(SfMarkerShuffler *self) {
             SfMarkerShuffler_chooseNewMark((SfMarkerShuffler *)self, 0);
             self->pointerPos = self->startPos - off;
         }
+        DiskStream_hint(self->disk, (long)self->pointerPos, -1, (long)self->endPos, (long)self->nextStartPos);
     }
     else { /* speed == 0 */
         self->lastDir = 0;
@@ -1028,7 +1071,7 @@ SfMarkerShuffler_chooseNewMark(SfMarkerShuffler *self, int dir)
     int mark;
     if (dir == 1) {
         if (self->startPos == -1) {
-            mark = (int)(self->markers_size * (rand()/((MYFLT)(RAND_MAX)+1)));
+            mark = (int)(self->markers_size * RANDOM_UNIFORM);
             self->startPos = self->markers[mark] * self->srScale;
             self->endPos = self->markers[mark+1] * self->srScale;
         }
@@ -1037,13 +1080,13 @@ SfMarkerShuffler_chooseNewMark(SfMarkerShuffler *self, int dir)
             self->endPos = self->nextEndPos;
         }
 
-        mark = (int)(self->markers_size * (rand()/((MYFLT)(RAND_MAX)+1)));
+        mark = (int)(self->markers_size * RANDOM_UNIFORM);
         self->nextStartPos = self->markers[mark] * self->srScale;
         self->nextEndPos = self->markers[mark+1] * self->srScale;
     }
     else {
         if (self->startPos == -1) {
-            mark = self->markers_size - (int)(self->markers_size * (rand()/((MYFLT)(RAND_MAX)+1)));
+            mark = self->markers_size - (int)(self->markers_size * RANDOM_UNIFORM);
             self->startPos = self->markers[mark] * self->srScale;
             self->endPos = self->markers[mark-1] * self->srScale;
         }
@@ -1052,7 +1095,7 @@ SfMarkerShuffler_chooseNewMark(SfMarkerShuffler *self, int dir)
             self->endPos = self->nextEndPos;
         }
 
-        mark = self->markers_size - (int)(self->markers_size * (rand()/((MYFLT)(RAND_MAX)+1)));
+        mark = self->markers_size - (int)(self->markers_size * RANDOM_UNIFORM);
         self->nextStartPos = self->markers[mark] * self->srScale;
         self->nextEndPos = self->markers[mark-1] * self->srScale;
     }
@@ -1094,6 +1137,7 @@ static void
 SfMarkerShuffler_dealloc(SfMarkerShuffler* self)
 {
     pyo_DEALLOC
+    DiskStream_free(self->disk);
     if (self->sf != NULL)
         sf_close(self->sf);
     free(self->samplesBuffer);
@@ -1152,6 +1196,7 @@ SfMarkerShuffler_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         printf("Failed to open the file.\n");
         Py_RETURN_NONE;
     }
+    self->disk = DiskStream_new(self->path, self->sf, &self->info);
     self->sndSize = self->info.frames;
     self->sndSr = self->info.samplerate;
     self->sndChnls = self->info.channels;
@@ -1162,7 +1207,7 @@ SfMarkerShuffler_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     self->samplesBuffer = (MYFLT *)realloc(self->samplesBuffer, self->bufsize * self->sndChnls * sizeof(MYFLT));
 
-    Server_generateSeed((Server *)self->server, SFMARKERSHUFFLER_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, SFMARKERSHUFFLER_ID));
 
     return (PyObject *)self;
 }
@@ -1574,6 +1619,7 @@ typedef struct {
     int modebuffer[2];
     SNDFILE *sf;
     SF_INFO info;
+    DiskStream *disk;
     char *path;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
     int sndSize; /* number of frames */
@@ -1628,26 +1674,22 @@ SfMarkerLooper_readframes_i(SfMarkerLooper *self) {
             self->lastDir = 1;
         }
         index = (int)self->pointerPos;
-        sf_seek(self->sf, index, SEEK_SET); /* sets position pointer in the file */
 
         /* fill a buffer with enough samples to satisfy speed reading */
         /* if not enough samples to read in the file */
         if ((index+buflen) > self->endPos) {
             shortbuflen = self->endPos - index;
-            SF_READ(self->sf, buffer, shortbuflen*self->sndChnls);
+            if (shortbuflen < 0) /* already past a marker set for the other direction */
+                shortbuflen = 0;
+            DiskStream_read(self->disk, index, buffer, shortbuflen*self->sndChnls);
 
             /* wrap around and read new samples if loop */
             int pad = buflen - shortbuflen;
             int padlen = pad*self->sndChnls;
-            MYFLT buftemp[padlen];
-            sf_seek(self->sf, (int)self->nextStartPos, SEEK_SET);
-            SF_READ(self->sf, buftemp, padlen);
-            for (i=0; i<(padlen); i++) {
-                buffer[i+shortbuflen*self->sndChnls] = buftemp[i];
-            }
+            DiskStream_read(self->disk, (int)self->nextStartPos, buffer+shortbuflen*self->sndChnls, padlen);
         }
         else /* without zero padding */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index, buffer, totlen);
 
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -1669,6 +1711,7 @@ SfMarkerLooper_readframes_i(SfMarkerLooper *self) {
             SfMarkerLooper_chooseNewMark((SfMarkerLooper *)self, 1);
             self->pointerPos = self->startPos + off;
         }
+        DiskStream_hint(self->disk, (long)self->pointerPos, 1, (long)self->endPos, (long)self->nextStartPos);
     }
     else if (sp < 0) { /* reading backward */
         if (self->startPos == -1 || self->lastDir != -1) {
@@ -1682,27 +1725,17 @@ SfMarkerLooper_readframes_i(SfMarkerLooper *self) {
         /* if not enough samples to read in the file */
         if ((index-buflen) < self->endPos) {
             shortbuflen = index - self->endPos;
+            if (shortbuflen < 0)
+                shortbuflen = 0;
             int pad = buflen - shortbuflen;
             int padlen = pad*self->sndChnls;
 
             /* wrap around and read new samples if loop */
-            MYFLT buftemp[padlen];
-            sf_seek(self->sf, (int)self->nextStartPos-pad, SEEK_SET);
-            SF_READ(self->sf, buftemp, padlen);
-            for (i=0; i<padlen; i++) {
-                buffer[i] = buftemp[i];
-            }
-
-            MYFLT buftemp2[shortbuflen*self->sndChnls];
-            sf_seek(self->sf, self->endPos, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buftemp2, shortbuflen*self->sndChnls);
-            for (i=0; i<(shortbuflen*self->sndChnls); i++) {
-                buffer[i+padlen] = buftemp2[i];
-            }
+            DiskStream_read(self->disk, (int)self->nextStartPos-pad, buffer, padlen);
+            DiskStream_read(self->disk, (int)self->endPos, buffer+padlen, shortbuflen*self->sndChnls);
         }
         else { /* without zero padding */
-            sf_seek(self->sf, index-buflen, SEEK_SET); /* sets position pointer in the file */
-            SF_READ(self->sf, buffer, totlen);
+            DiskStream_read(self->disk, index-buflen, buffer, totlen);
         }
         /* de-interleave samples */
         for (i=0; i<totlen; i++) {
@@ -1736,6 +1769,7 @@ SfMarkerLooper_readframes_i(SfMarkerLooper *self) {
             SfMarkerLooper_chooseNewMark((SfMarkerLooper *)self, 0);
             self->pointerPos = self->startPos - off;
         }
+        DiskStream_hint(self->disk, (long)self->pointerPos, -1, (long)self->endPos, (long)self->nextStartPos);
     }
     else { /* speed == 0 */
         self->lastDir = 0;
@@ -1840,6 +1874,7 @@ static void
 SfMarkerLooper_dealloc(SfMarkerLooper* self)
 {
     pyo_DEALLOC
+    DiskStream_free(self->disk);
     if (self->sf != NULL)
         sf_close(self->sf);
     free(self->samplesBuffer);
@@ -1868,6 +1903,7 @@ SfMarkerLooper_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, SfMarkerLooper_compute_next_data_frame);
+    Stream_setStreamShared(self->stream, 1);
     self->mode_func_ptr = SfMarkerLooper_setProcMode;
 
     static char *kwlist[] = {"path", "markers", "speed", "mark", "interp", NULL};
@@ -1906,6 +1942,7 @@ SfMarkerLooper_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         printf("Failed to open the file.\n");
         Py_RETURN_NONE;
     }
+    self->disk = DiskStream_new(self->path, self->sf, &self->info);
     self->sndSize = self->info.frames;
     self->sndSr = self->info.samplerate;
     self->sndChnls = self->info.channels;
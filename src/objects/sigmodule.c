@@ -29,6 +29,8 @@ typedef struct {
     pyo_audio_HEAD
     PyObject *value;
     Stream *value_stream;
+    int krate;
+    MYFLT lastValue; /* last value given, in control-rate mode */
     int modebuffer[3];
 } Sig;
 
@@ -77,23 +79,33 @@ Sig_setProcMode(Sig *self)
             self->muladd_func_ptr = Sig_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
 Sig_compute_next_data_frame(Sig *self)
 {
     int i;
-    if (self->modebuffer[2] == 0) {
-        MYFLT val = PyFloat_AS_DOUBLE(self->value);
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = val;
-        }
+    MYFLT val;
+    if (self->krate) {
+        if (self->modebuffer[2] == 0)
+            val = PyFloat_AS_DOUBLE(self->value);
+        else
+            val = Stream_getData((Stream *)self->value_stream)[self->bufsize-1];
+        pyo_fill_ramp(self->data, self->lastValue, val, self->bufsize);
+        Stream_setConstant(self->stream, val == self->lastValue);
+        self->lastValue = val;
+    }
+    else if (self->modebuffer[2] == 0) {
+        pyo_fill(self->data, PyFloat_AS_DOUBLE(self->value), self->bufsize);
+        Stream_setConstant(self->stream, 1);
     }
     else {
         MYFLT *vals = Stream_getData((Stream *)self->value_stream);
         for (i=0; i<self->bufsize; i++) {
             self->data[i] = vals[i];
         }
+        Stream_setConstant(self->stream, Stream_isConstant(self->value_stream));
     }
     (*self->muladd_func_ptr)(self);
 }
@@ -133,6 +145,8 @@ Sig_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self = (Sig *)type->tp_alloc(type, 0);
 
     self->value = PyFloat_FromDouble(0.0);
+    self->krate = 0;
+    self->lastValue = 0.0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -199,6 +213,22 @@ Sig_setValue(Sig *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+Sig_setControlRate(Sig *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        if (self->modebuffer[2] == 0)
+            self->lastValue = PyFloat_AS_DOUBLE(self->value);
+        else
+            self->lastValue = Stream_getData((Stream *)self->value_stream)[self->bufsize-1];
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * Sig_getServer(Sig* self) { GET_SERVER };
 static PyObject * Sig_getStream(Sig* self) { GET_STREAM };
 static PyObject * Sig_setMul(Sig *self, PyObject *arg) { SET_MUL };
@@ -235,6 +265,7 @@ static PyMethodDef Sig_methods[] = {
 {"out", (PyCFunction)Sig_out, METH_VARARGS|METH_KEYWORDS, "Starts computing and sends sound to soundcard channel speficied by argument."},
 {"stop", (PyCFunction)Sig_stop, METH_NOARGS, "Stops computing."},
 {"setValue", (PyCFunction)Sig_setValue, METH_O, "Sets Sig value."},
+{"setControlRate", (PyCFunction)Sig_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
 {"setMul", (PyCFunction)Sig_setMul, METH_O, "Sets Sig mul factor."},
 {"setAdd", (PyCFunction)Sig_setAdd, METH_O, "Sets Sig add factor."},
 {"setSub", (PyCFunction)Sig_setSub, METH_O, "Sets inverse add factor."},
@@ -339,6 +370,7 @@ typedef struct {
     long timeStep;
     MYFLT stepVal;
     long timeCount;
+    int krate;
     int modebuffer[3];
 } SigTo;
 
@@ -355,8 +387,14 @@ SigTo_generates_i(SigTo *self) {
             self->lastValue = value;
         }
         if (self->timeStep <= 0) {
-            for (i=0; i<self->bufsize; i++)
-                self->data[i] = self->currentValue = self->lastValue = value;
+            pyo_fill(self->data, value, self->bufsize);
+            self->currentValue = self->lastValue = value;
+            Stream_setConstant(self->stream, 1);
+        }
+        else if (self->timeCount >= self->timeStep) {
+            /* The ramp is over. */
+            pyo_fill(self->data, self->currentValue, self->bufsize);
+            Stream_setConstant(self->stream, 1);
         }
         else {
             for (i=0; i<self->bufsize; i++) {
@@ -379,6 +417,7 @@ SigTo_generates_i(SigTo *self) {
                 value = vals[i];
                 self->data[i] = self->currentValue = self->lastValue = value;
             }
+            Stream_setConstant(self->stream, Stream_isConstant(self->value_stream));
         }
         else {
             for (i=0; i<self->bufsize; i++) {
@@ -404,6 +443,37 @@ SigTo_generates_i(SigTo *self) {
     }
 }
 
+/* Control-rate mode, the ramp advances one buffer at a time toward the last
+ * value of the buffer. */
+static void
+SigTo_generates_k(SigTo *self) {
+    MYFLT value, start = self->currentValue;
+
+    if (self->modebuffer[2] == 0)
+        value = PyFloat_AS_DOUBLE(self->value);
+    else
+        value = Stream_getData((Stream *)self->value_stream)[self->bufsize-1];
+    if (value != self->lastValue) {
+        self->timeCount = 0;
+        self->timeStep = (long)(self->time * self->sr);
+        self->stepVal = (value - self->currentValue) / self->timeStep;
+        self->lastValue = value;
+    }
+    if (self->timeStep <= 0)
+        self->currentValue = self->lastValue = value;
+    else if (self->timeCount < self->timeStep) {
+        if ((self->timeStep - self->timeCount) <= self->bufsize) {
+            self->currentValue = value;
+            self->timeCount = self->timeStep;
+        }
+        else {
+            self->currentValue += self->stepVal * self->bufsize;
+            self->timeCount += self->bufsize;
+        }
+    }
+    pyo_fill_ramp(self->data, start, self->currentValue, self->bufsize);
+}
+
 static void SigTo_postprocessing_ii(SigTo *self) { POST_PROCESSING_II };
 static void SigTo_postprocessing_ai(SigTo *self) { POST_PROCESSING_AI };
 static void SigTo_postprocessing_ia(SigTo *self) { POST_PROCESSING_IA };
@@ -420,7 +490,12 @@ SigTo_setProcMode(SigTo *self)
     int muladdmode;
     muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
 
-    self->proc_func_ptr = SigTo_generates_i;
+    if (self->krate) {
+        self->proc_func_ptr = SigTo_generates_k;
+    }
+    else {
+        self->proc_func_ptr = SigTo_generates_i;
+    }
 
 	switch (muladdmode) {
         case 0:
@@ -451,6 +526,7 @@ SigTo_setProcMode(SigTo *self)
             self->muladd_func_ptr = SigTo_postprocessing_revareva;
             break;
     }
+    Stream_setControlRate(self->stream, self->krate && muladdmode == 0);
 }
 
 static void
@@ -499,6 +575,7 @@ SigTo_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->time = 0.025;
     self->timeCount = 0;
     self->stepVal = 0.0;
+    self->krate = 0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -596,6 +673,18 @@ SigTo_setTime(SigTo *self, PyObject *arg)
 	return Py_None;
 }
 
+static PyObject *
+SigTo_setControlRate(SigTo *self, PyObject *arg)
+{
+	if (arg != NULL && PyInt_Check(arg)) {
+        self->krate = PyInt_AsLong(arg) != 0;
+        (*self->mode_func_ptr)(self);
+	}
+
+	Py_INCREF(Py_None);
+	return Py_None;
+}
+
 static PyObject * SigTo_getServer(SigTo* self) { GET_SERVER };
 static PyObject * SigTo_getStream(SigTo* self) { GET_STREAM };
 static PyObject * SigTo_setMul(SigTo *self, PyObject *arg) { SET_MUL };
@@ -631,6 +720,7 @@ static PyMethodDef SigTo_methods[] = {
 {"stop", (PyCFunction)SigTo_stop, METH_NOARGS, "Stops computing."},
 {"setValue", (PyCFunction)SigTo_setValue, METH_O, "Sets SigTo value."},
 {"setTime", (PyCFunction)SigTo_setTime, METH_O, "Sets ramp time in seconds."},
+{"setControlRate", (PyCFunction)SigTo_setControlRate, METH_O, "Computes one value per buffer, interpolated over the buffer."},
 {"setMul", (PyCFunction)SigTo_setMul, METH_O, "Sets SigTo mul factor."},
 {"setAdd", (PyCFunction)SigTo_setAdd, METH_O, "Sets SigTo add factor."},
 {"setSub", (PyCFunction)SigTo_setSub, METH_O, "Sets inverse add factor."},
@@ -753,7 +843,7 @@ VarPort_generates_i(VarPort *self) {
         self->lastValue = self->value;
     }
 
-    if (self->flag == 1) {
+    if (self->flag == 1 && self->timeCount < self->timeStep) {
         for (i=0; i<self->bufsize; i++) {
             if (self->timeCount >= self->timeStep)
                 self->currentValue = self->value;
@@ -766,9 +856,13 @@ VarPort_generates_i(VarPort *self) {
         }
     }
     else {
-        for (i=0; i<self->bufsize; i++) {
-            self->data[i] = self->currentValue;
+        /* Holds the value, the ramp is over. */
+        if (self->flag == 1) {
+            self->currentValue = self->value;
+            self->timeCount += self->bufsize;
         }
+        pyo_fill(self->data, self->currentValue, self->bufsize);
+        Stream_setConstant(self->stream, 1);
     }
 
     if (self->timeCount >= self->timeout && self->flag == 1) {
@@ -896,6 +990,7 @@ VarPort_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, VarPort_compute_next_data_frame);
+    Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = VarPort_setProcMode;
 
     static char *kwlist[] = {"value", "time", "init", "callable", "arg", "mul", "add", NULL};
@@ -21,12 +21,19 @@
 #include <Python.h>
 #include "structmember.h"
 #include <math.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
 #include "pyomodule.h"
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
 #include "sndfile.h"
 #include "wind.h"
+#include "sndmap.h"
+#include "samplecache.h"
+#include "resampler.h"
 
 #define __TABLE_MODULE
 #include "tablemodule.h"
@@ -38,6 +45,7 @@
 static void
 TableStream_dealloc(TableStream* self)
 {
+    free(self->expanded);
     self->ob_type->tp_free((PyObject*)self);
 }
 
@@ -49,10 +57,64 @@ TableStream_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     return (PyObject *)self;
 }
 
+/* Converts `num` samples to a compact format, in a new buffer. */
+static void *
+TableStream_packSamples(MYFLT *data, long num, int format)
+{
+    long i;
+    MYFLT x;
+    float *f;
+    short *h;
+
+    if (format == TABLE_FLOAT32) {
+        f = (float *)malloc(num * sizeof(float));
+        for (i=0; i<num; i++) {
+            f[i] = (float)data[i];
+        }
+        return f;
+    }
+    h = (short *)malloc(num * sizeof(short));
+    for (i=0; i<num; i++) {
+        x = data[i] * 32768.0;
+        h[i] = x >= 32767.0 ? 32767 : x <= -32768.0 ? -32768 : (short)MYROUND(x);
+    }
+    return h;
+}
+
+static void
+TableStream_unpackSamples(void *samples, int format, MYFLT *data, long num)
+{
+    long i;
+    float *f = (float *)samples;
+    short *h = (short *)samples;
+    MYFLT **pages = (MYFLT **)samples;
+
+    if (format == TABLE_PAGED) {
+        for (i=0; i<num; i+=TABLE_PAGE_SIZE) {
+            memcpy(data + i, pages[i >> TABLE_PAGE_BITS], (num - i < TABLE_PAGE_SIZE ? num - i : TABLE_PAGE_SIZE) * sizeof(MYFLT));
+        }
+    }
+    else if (format == TABLE_FLOAT32) {
+        for (i=0; i<num; i++) {
+            data[i] = (MYFLT)f[i];
+        }
+    }
+    else {
+        for (i=0; i<num; i++) {
+            data[i] = h[i] * (MYFLT)(1.0 / 32768.0);
+        }
+    }
+}
+
 MYFLT *
 TableStream_getData(TableStream *self)
 {
-    return (MYFLT *)self->data;
+    if (self->samples != NULL && (self->expanded == NULL || self->expsize != self->size)) {
+        self->expanded = (MYFLT *)realloc(self->expanded, (self->size + 1) * sizeof(MYFLT));
+        self->expsize = self->size;
+        TableStream_unpackSamples(self->samples, self->format, self->expanded, self->size + 1);
+    }
+    return self->samples != NULL ? self->expanded : (MYFLT *)self->data;
 }
 
 void
@@ -61,6 +123,66 @@ TableStream_setData(TableStream *self, MYFLT *data)
     self->data = data;
 }
 
+void *
+TableStream_getSamples(TableStream *self)
+{
+    return self->samples != NULL ? self->samples : (void *)self->data;
+}
+
+int
+TableStream_getFormat(TableStream *self)
+{
+    return self->samples != NULL ? self->format : TABLE_NATIVE;
+}
+
+/* Reads `num` samples from `start`, in any storage format, without the
+ * converted copy. The caller keeps the samples within the table. */
+void
+TableStream_readSamples(TableStream *self, long start, long num, MYFLT *out)
+{
+    long i, n;
+    MYFLT **pages;
+
+    if (self->samples == NULL) {
+        memcpy(out, self->data + start, num * sizeof(MYFLT));
+    }
+    else if (self->format == TABLE_PAGED) {
+        pages = (MYFLT **)self->samples;
+        for (i=0; i<num; i+=n) {
+            n = TABLE_PAGE_SIZE - ((start + i) & TABLE_PAGE_MASK);
+            if (n > num - i)
+                n = num - i;
+            memcpy(out + i, &TABLE_PAGE_SAMPLE(pages, start + i), n * sizeof(MYFLT));
+        }
+    }
+    else if (self->format == TABLE_FLOAT32) {
+        TableStream_unpackSamples((float *)self->samples + start, self->format, out, num);
+    }
+    else {
+        TableStream_unpackSamples((short *)self->samples + start, self->format, out, num);
+    }
+}
+
+/* Points the paged table to a new directory holding the same pages. The
+ * converted samples are kept, readers may still be using them. */
+void
+TableStream_setPages(TableStream *self, MYFLT **pages)
+{
+    self->samples = (void *)pages;
+    self->format = TABLE_PAGED;
+}
+
+/* `samples`, in the compact `format`, replace `data`. NULL gives the table
+ * back to `data`. */
+void
+TableStream_setSamples(TableStream *self, void *samples, int format)
+{
+    free(self->expanded);
+    self->expanded = NULL;
+    self->samples = samples;
+    self->format = samples != NULL ? format : TABLE_NATIVE;
+}
+
 int
 TableStream_getSize(TableStream *self)
 {
@@ -85,6 +207,32 @@ TableStream_setSamplingRate(TableStream *self, double sr)
     self->samplingRate = sr;
 }
 
+/* Bytes of the samples, in their storage format, and of their converted copy. */
+static PyObject *
+TableStream_getMemory(TableStream *self)
+{
+    size_t bytes, num = (size_t)self->size + 1, pages;
+
+    if (self->samples == NULL)
+        bytes = num * sizeof(MYFLT);
+    else if (self->format == TABLE_PAGED) {
+        pages = (num + TABLE_PAGE_MASK) >> TABLE_PAGE_BITS;
+        bytes = pages * (TABLE_PAGE_SIZE * sizeof(MYFLT) + sizeof(MYFLT *));
+    }
+    else if (self->format == TABLE_FLOAT32)
+        bytes = num * sizeof(float);
+    else
+        bytes = num * sizeof(short);
+    if (self->expanded != NULL)
+        bytes += ((size_t)self->expsize + 1) * sizeof(MYFLT);
+    return PyLong_FromSize_t(bytes);
+}
+
+static PyMethodDef TableStream_methods[] = {
+{"getMemory", (PyCFunction)TableStream_getMemory, METH_NOARGS, "Returns the heap memory used by the samples, in bytes."},
+{NULL}  /* Sentinel */
+};
+
 PyTypeObject TableStreamType = {
 PyObject_HEAD_INIT(NULL)
 0, /*ob_size*/
@@ -114,7 +262,7 @@ Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
 0, /* tp_weaklistoffset */
 0, /* tp_iter */
 0, /* tp_iternext */
-0, /* tp_methods */
+TableStream_methods, /* tp_methods */
 0, /* tp_members */
 0, /* tp_getset */
 0, /* tp_base */
@@ -3646,15 +3794,114 @@ typedef struct {
     MYFLT stop;
     MYFLT crossfade;
     MYFLT insertPos;
+    char *cache; /* directory of the raw copies, NULL to load in memory */
+    SndMap *map;
+    SampleCache *shared; /* samples shared with the tables loading the same region */
+    int noshare; /* written by other objects, never shares its samples */
+    int resample; /* rate the sounds are converted to, 0 keeps the rate of the file */
+    int storage; /* format of the samples loaded in memory, see tablemodule.h */
+    void *samples; /* compact samples, self->data is then NULL or the MYFLT view of the TableStream */
 } SndTable;
 
+/* Leaves self->data allocated in memory, or NULL, before it is resized or
+ * freed. `keep` copies the mapped, shared or compact samples. */
+static void
+SndTable_releaseData(SndTable *self, int keep) {
+    if (self->map == NULL && self->shared == NULL && self->samples == NULL)
+        return;
+    if (keep) {
+        self->data = (MYFLT *)malloc((self->size + 1) * sizeof(MYFLT));
+        if (self->samples != NULL)
+            TableStream_unpackSamples(self->samples, self->storage, self->data, self->size + 1);
+        else
+            memcpy(self->data, self->map != NULL ? self->map->data : self->shared->data, (self->size + 1) * sizeof(MYFLT));
+    }
+    else
+        self->data = NULL;
+    if (self->map != NULL)
+        SndMap_close(self->map);
+    SampleCache_release(self->shared);
+    if (self->samples != NULL) {
+        free(self->samples);
+        TableStream_setSamples(self->tablestream, NULL, TABLE_NATIVE);
+    }
+    self->map = NULL;
+    self->shared = NULL;
+    self->samples = NULL;
+}
+
+/* Copy-on-write, before a method modifies shared samples. The pages of a
+ * mapped table are already copied by the system. A compact table goes back
+ * to MYFLT samples. */
+static void
+SndTable_ownData(SndTable *self) {
+    if (self->shared == NULL && self->samples == NULL)
+        return;
+    SndTable_releaseData(self, 1);
+    TableStream_setData(self->tablestream, self->data);
+}
+
+/* Before a method reads the samples of a compact table. */
+static void
+SndTable_viewData(SndTable *self) {
+    if (self->samples != NULL)
+        self->data = TableStream_getData(self->tablestream);
+}
+
+/* Converts the loaded samples to the storage format of the table. Mapped
+ * tables are left as they are. */
+static void
+SndTable_compact(SndTable *self) {
+    void *samples;
+
+    if (self->storage == TABLE_NATIVE || self->map != NULL || self->data == NULL)
+        return;
+#ifndef USE_DOUBLE
+    if (self->storage == TABLE_FLOAT32)
+        return;
+#endif
+    samples = TableStream_packSamples(self->data, self->size + 1, self->storage);
+    if (self->shared != NULL)
+        SndTable_releaseData(self, 0);
+    else
+        free(self->data);
+    self->data = NULL;
+    self->samples = samples;
+    TableStream_setSamples(self->tablestream, samples, self->storage);
+    TableStream_setData(self->tablestream, NULL);
+}
+
+/* Converts the samples, in memory, from the rate of the file to the rate
+ * self->resample. Returns the new buffer and size. */
+static MYFLT *
+SndTable_resampleData(SndTable *self, MYFLT *data, long *size) {
+    long outsize;
+    MYFLT *out;
+    Resampler *resampler;
+
+    if ((resampler = Resampler_new(self->sndSr, self->resample, RESAMPLER_DEFAULT_QUALITY)) == NULL)
+        return data;
+    outsize = Resampler_getOutputSize(resampler, *size);
+    out = (MYFLT *)malloc((outsize + 1) * sizeof(MYFLT));
+    Resampler_process(resampler, data, *size, out, outsize);
+    Resampler_free(resampler);
+    out[outsize] = out[0];
+    free(data);
+    *size = outsize;
+    return out;
+}
+
 static void
 SndTable_loadSound(SndTable *self) {
     SNDFILE *sf;
     SF_INFO info;
     unsigned int i, num, num_items, num_chnls, snd_size, start, stop;
     unsigned int num_count = 0;
+    int rate;
+    long size;
     MYFLT *tmp;
+    SndMap *map;
+    SampleCache *shared;
 
     info.format = 0;
     sf = sf_open(self->path, SFM_READ, &info);
@@ -3666,6 +3913,7 @@ SndTable_loadSound(SndTable *self) {
     snd_size = info.frames;
     self->sndSr = info.samplerate;
     num_chnls = info.channels;
+    rate = self->resample > 0 ? self->resample : self->sndSr;
 
     if (self->stop <= 0 || self->stop <= self->start || (self->stop*self->sndSr) > snd_size)
         stop = snd_size;
@@ -3677,6 +3925,43 @@ SndTable_loadSound(SndTable *self) {
     else
         start = (unsigned int)(self->start * self->sndSr);
 
+    /* The cache files hold samples at the rate of the file. */
+    if (self->cache != NULL && rate == self->sndSr) {
+        map = SndMap_open(self->cache, self->path, sf, &info, self->chnl, start, stop - start);
+        if (map != NULL) {
+            sf_close(sf);
+            SndTable_releaseData(self, 0);
+            free(self->data);
+            self->map = map;
+            self->data = map->data;
+            self->size = stop - start;
+            self->start = 0.0;
+            self->stop = -1.0;
+            TableStream_setSize(self->tablestream, self->size);
+            TableStream_setSamplingRate(self->tablestream, self->sndSr);
+            TableStream_setData(self->tablestream, self->data);
+            return;
+        }
+        printf("SndTable warning : can't use the cache directory %s, the sound is loaded in memory.\n", self->cache);
+    }
+    SndTable_releaseData(self, 0);
+
+    if (!self->noshare && (shared = SampleCache_find(self->path, self->chnl, start, stop - start, rate)) != NULL) {
+        sf_close(sf);
+        free(self->data);
+        self->shared = shared;
+        self->data = shared->data;
+        self->size = shared->size;
+        self->sndSr = shared->sndSr;
+        self->start = 0.0;
+        self->stop = -1.0;
+        TableStream_setSize(self->tablestream, self->size);
+        TableStream_setSamplingRate(self->tablestream, self->sndSr);
+        TableStream_setData(self->tablestream, self->data);
+        SndTable_compact(self);
+        return;
+    }
+
     self->size = stop - start;
     num_items = self->size * num_chnls;
 
@@ -3713,12 +3998,23 @@ SndTable_loadSound(SndTable *self) {
 
     self->data[self->size] = self->data[0];
 
+    if (rate != self->sndSr) {
+        size = self->size;
+        self->data = SndTable_resampleData(self, self->data, &size);
+        self->size = size;
+        self->sndSr = rate;
+    }
+
+    if (!self->noshare)
+        self->shared = SampleCache_insert(self->path, self->chnl, start, stop - start, self->sndSr, self->data, self->size);
+
     self->start = 0.0;
     self->stop = -1.0;
     free(tmp);
     TableStream_setSize(self->tablestream, self->size);
     TableStream_setSamplingRate(self->tablestream, self->sndSr);
     TableStream_setData(self->tablestream, self->data);
+    SndTable_compact(self);
 }
 
 static void
@@ -3729,6 +4025,8 @@ SndTable_appendSound(SndTable *self) {
     MYFLT *tmp, *tmp_data;
     MYFLT cross_amp;
 
+    SndTable_releaseData(self, 1);
+
     info.format = 0;
     sf = sf_open(self->path, SFM_READ, &info);
     if (sf == NULL)
@@ -3826,6 +4124,8 @@ SndTable_prependSound(SndTable *self) {
     MYFLT *tmp, *tmp_data;
     MYFLT cross_amp;
 
+    SndTable_releaseData(self, 1);
+
     info.format = 0;
     sf = sf_open(self->path, SFM_READ, &info);
     if (sf == NULL)
@@ -3920,6 +4220,8 @@ SndTable_insertSound(SndTable *self) {
     MYFLT *tmp, *tmp_data;
     MYFLT cross_amp;
 
+    SndTable_releaseData(self, 1);
+
     info.format = 0;
     sf = sf_open(self->path, SFM_READ, &info);
     if (sf == NULL)
@@ -4040,7 +4342,9 @@ SndTable_clear(SndTable *self)
 static void
 SndTable_dealloc(SndTable* self)
 {
+    SndTable_releaseData(self, 0);
     free(self->data);
+    free(self->cache);
     SndTable_clear(self);
     self->ob_type->tp_free((PyObject*)self);
 }
@@ -4063,11 +4367,16 @@ SndTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     MAKE_NEW_TABLESTREAM(self->tablestream, &TableStreamType, NULL);
 
-    static char *kwlist[] = {"path", "chnl", "start", "stop", NULL};
+    char *cachetmp = NULL;
+
+    static char *kwlist[] = {"path", "chnl", "start", "stop", "cache", "storage", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_S_IFF, kwlist, &self->path, &self->chnl, &self->start, &self->stop))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_S_IFFSI, kwlist, &self->path, &self->chnl, &self->start, &self->stop, &cachetmp, &self->storage))
         return PyInt_FromLong(-1);
 
+    if (cachetmp != NULL && strcmp(cachetmp, "") != 0)
+        self->cache = strdup(cachetmp);
+
     if (strcmp(self->path, "") == 0) {
         self->size = (int)self->sr;
         self->data = (MYFLT *)realloc(self->data, (self->size + 1) * sizeof(MYFLT));
@@ -4091,26 +4400,26 @@ SndTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
 static PyObject * SndTable_getServer(SndTable* self) { GET_SERVER };
 static PyObject * SndTable_getTableStream(SndTable* self) { GET_TABLE_STREAM };
-static PyObject * SndTable_setData(SndTable *self, PyObject *arg) { SET_TABLE_DATA };
-static PyObject * SndTable_normalize(SndTable *self) { NORMALIZE };
-static PyObject * SndTable_reset(SndTable *self) { TABLE_RESET };
-static PyObject * SndTable_removeDC(SndTable *self) { REMOVE_DC };
-static PyObject * SndTable_reverse(SndTable *self) { REVERSE };
-static PyObject * SndTable_invert(SndTable *self) { INVERT };
-static PyObject * SndTable_rectify(SndTable *self) { RECTIFY };
-static PyObject * SndTable_bipolarGain(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_BIPOLAR_GAIN };
-static PyObject * SndTable_lowpass(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_LOWPASS };
-static PyObject * SndTable_fadein(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_FADEIN };
-static PyObject * SndTable_fadeout(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_FADEOUT };
-static PyObject * SndTable_pow(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_POWER };
-static PyObject * SndTable_copy(SndTable *self, PyObject *arg) { COPY };
-static PyObject * SndTable_setTable(SndTable *self, PyObject *arg) { SET_TABLE };
-static PyObject * SndTable_getTable(SndTable *self) { GET_TABLE };
-static PyObject * SndTable_put(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_PUT };
-static PyObject * SndTable_get(SndTable *self, PyObject *args, PyObject *kwds) { TABLE_GET };
-static PyObject * SndTable_add(SndTable *self, PyObject *arg) { TABLE_ADD };
-static PyObject * SndTable_sub(SndTable *self, PyObject *arg) { TABLE_SUB };
-static PyObject * SndTable_mul(SndTable *self, PyObject *arg) { TABLE_MUL };
+static PyObject * SndTable_setData(SndTable *self, PyObject *arg) { SndTable_ownData(self); SET_TABLE_DATA };
+static PyObject * SndTable_normalize(SndTable *self) { SndTable_ownData(self); NORMALIZE };
+static PyObject * SndTable_reset(SndTable *self) { SndTable_ownData(self); TABLE_RESET };
+static PyObject * SndTable_removeDC(SndTable *self) { SndTable_ownData(self); REMOVE_DC };
+static PyObject * SndTable_reverse(SndTable *self) { SndTable_ownData(self); REVERSE };
+static PyObject * SndTable_invert(SndTable *self) { SndTable_ownData(self); INVERT };
+static PyObject * SndTable_rectify(SndTable *self) { SndTable_ownData(self); RECTIFY };
+static PyObject * SndTable_bipolarGain(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_BIPOLAR_GAIN };
+static PyObject * SndTable_lowpass(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_LOWPASS };
+static PyObject * SndTable_fadein(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_FADEIN };
+static PyObject * SndTable_fadeout(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_FADEOUT };
+static PyObject * SndTable_pow(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_POWER };
+static PyObject * SndTable_copy(SndTable *self, PyObject *arg) { SndTable_ownData(self); COPY };
+static PyObject * SndTable_setTable(SndTable *self, PyObject *arg) { SndTable_ownData(self); SET_TABLE };
+static PyObject * SndTable_getTable(SndTable *self) { SndTable_viewData(self); GET_TABLE };
+static PyObject * SndTable_put(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_ownData(self); TABLE_PUT };
+static PyObject * SndTable_get(SndTable *self, PyObject *args, PyObject *kwds) { SndTable_viewData(self); TABLE_GET };
+static PyObject * SndTable_add(SndTable *self, PyObject *arg) { SndTable_ownData(self); TABLE_ADD };
+static PyObject * SndTable_sub(SndTable *self, PyObject *arg) { SndTable_ownData(self); TABLE_SUB };
+static PyObject * SndTable_mul(SndTable *self, PyObject *arg) { SndTable_ownData(self); TABLE_MUL };
 
 static PyObject *
 SndTable_getViewTable(SndTable *self, PyObject *args, PyObject *kwds) {
@@ -4123,6 +4432,8 @@ SndTable_getViewTable(SndTable *self, PyObject *args, PyObject *kwds) {
     PyObject *samples, *tuple;
     PyObject *sizetmp = NULL;
 
+    SndTable_viewData(self);
+
     static char *kwlist[] = {"size", "begin", "end", "yOffset", NULL};
 
     if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE__OFFI, kwlist, &sizetmp, &begin, &end, &yOffset))
@@ -4221,6 +4532,8 @@ SndTable_getEnvelope(SndTable *self, PyObject *arg) {
     MYFLT absin, last;
     PyObject *samples;
 
+    SndTable_viewData(self);
+
 	if (arg == NULL) {
 		Py_INCREF(Py_None);
 		return Py_None;
@@ -4290,6 +4603,7 @@ SndTable_append(SndTable *self, PyObject *args, PyObject *kwds)
         self->crossfade = crosstmp;
 
     SndTable_appendSound(self);
+    SndTable_compact(self);
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -4323,6 +4637,7 @@ SndTable_insert(SndTable *self, PyObject *args, PyObject *kwds)
         self->insertPos = postmp;
         SndTable_insertSound(self);
     }
+    SndTable_compact(self);
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -4333,6 +4648,7 @@ SndTable_setSize(SndTable *self, PyObject *value)
 {
     Py_ssize_t i;
 
+    SndTable_releaseData(self, 0);
     self->size = PyInt_AsLong(value);
 
     self->data = (MYFLT *)realloc(self->data, (self->size+1) * sizeof(MYFLT));
@@ -4350,6 +4666,16 @@ SndTable_setSize(SndTable *self, PyObject *value)
     return Py_None;
 }
 
+static PyObject *
+SndTable_unshare(SndTable *self)
+{
+    self->noshare = 1;
+    SndTable_ownData(self);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
 static PyObject *
 SndTable_getSize(SndTable *self)
 {
@@ -4371,6 +4697,7 @@ static PyMemberDef SndTable_members[] = {
 
 static PyMethodDef SndTable_methods[] = {
 {"getServer", (PyCFunction)SndTable_getServer, METH_NOARGS, "Returns server object."},
+{"_unshare", (PyCFunction)SndTable_unshare, METH_NOARGS, "Gives the table its own samples, for objects writing into it."},
 {"copy", (PyCFunction)SndTable_copy, METH_O, "Copy data from table given in argument."},
 {"setTable", (PyCFunction)SndTable_setTable, METH_O, "Sets the table content from a list of floats (must be the same size as the object size)."},
 {"getTable", (PyCFunction)SndTable_getTable, METH_NOARGS, "Returns a list of table samples."},
@@ -4453,23 +4780,389 @@ SndTable_new,                 /* tp_new */
 0,               /* tp_del */
 };
 
+/*****************************/
+/* SndTableLoader structure */
+/*****************************/
+/* Loads SndTables with a pool of threads. The tables are only given back to
+ * python once loaded, the threads are the only ones touching them before. */
+typedef struct {
+    SndTable *table;
+    char *path;
+    int chnl;
+    MYFLT start;
+    MYFLT stop;
+} SndTableJob;
+
+typedef struct {
+    PyObject_HEAD
+    PyObject *jobs; /* keeps the tables and the paths alive */
+    SndTableJob *job;
+    int num;
+    int next;       /* next job to start */
+    int *done;      /* finished jobs, in order */
+    int numDone;
+    int numWaited;
+    int abort;
+    double sr;      /* rate of the resampled tables, 0 to keep the file rates */
+    pthread_t *threads;
+    int numThreads;
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+} SndTableLoader;
+
+static void *
+SndTableLoader_run(void *arg)
+{
+    int i;
+    SndTableJob *job;
+    SndTableLoader *self = (SndTableLoader *)arg;
+
+    pthread_mutex_lock(&self->mutex);
+    while (!self->abort && self->next < self->num) {
+        i = self->next++;
+        pthread_mutex_unlock(&self->mutex);
+
+        job = &self->job[i];
+        job->table->path = job->path;
+        job->table->chnl = job->chnl;
+        job->table->start = job->start;
+        job->table->stop = job->stop;
+        job->table->resample = (int)self->sr;
+        SndTable_loadSound(job->table);
+
+        pthread_mutex_lock(&self->mutex);
+        self->done[self->numDone++] = i;
+        pthread_cond_broadcast(&self->cond);
+    }
+    pthread_mutex_unlock(&self->mutex);
+
+    return NULL;
+}
+
+static void
+SndTableLoader_dealloc(SndTableLoader* self)
+{
+    int i;
+
+    pthread_mutex_lock(&self->mutex);
+    self->abort = 1;
+    pthread_mutex_unlock(&self->mutex);
+    Py_BEGIN_ALLOW_THREADS
+    for (i=0; i<self->numThreads; i++) {
+        pthread_join(self->threads[i], NULL);
+    }
+    Py_END_ALLOW_THREADS
+    pthread_mutex_destroy(&self->mutex);
+    pthread_cond_destroy(&self->cond);
+    free(self->threads);
+    free(self->job);
+    free(self->done);
+    Py_XDECREF(self->jobs);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+SndTableLoader_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i, resample = 0, threads = 0;
+    double start, stop;
+    PyObject *jobstmp, *item, *table, *sr;
+    SndTableLoader *self;
+
+    static char *kwlist[] = {"jobs", "threads", "resample", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|ii", kwlist, &jobstmp, &threads, &resample))
+        return NULL;
+
+    if (! PyList_Check(jobstmp)) {
+        PyErr_SetString(PyExc_TypeError, "SndTableLoader jobs must be a list of (SndTable_base, path, chnl, start, stop) tuples.");
+        return NULL;
+    }
+
+    self = (SndTableLoader *)type->tp_alloc(type, 0);
+    pthread_mutex_init(&self->mutex, NULL);
+    pthread_cond_init(&self->cond, NULL);
+    Py_INCREF(jobstmp);
+    self->jobs = jobstmp;
+    self->num = PyList_Size(jobstmp);
+    self->job = (SndTableJob *)calloc(self->num + 1, sizeof(SndTableJob));
+    self->done = (int *)calloc(self->num + 1, sizeof(int));
+
+    for (i=0; i<self->num; i++) {
+        item = PyList_GET_ITEM(jobstmp, i);
+        if (! PyArg_ParseTuple(item, "Osidd", &table, &self->job[i].path, &self->job[i].chnl, &start, &stop) ||
+            ! PyObject_TypeCheck(table, &SndTableType)) {
+            if (! PyErr_Occurred())
+                PyErr_SetString(PyExc_TypeError, "SndTableLoader jobs must be a list of (SndTable_base, path, chnl, start, stop) tuples.");
+            Py_DECREF(self);
+            return NULL;
+        }
+        self->job[i].table = (SndTable *)table;
+        self->job[i].start = (MYFLT)start;
+        self->job[i].stop = (MYFLT)stop;
+    }
+
+    if (resample) {
+        sr = PyObject_CallMethod(PyServer_get_server(), "getSamplingRate", NULL);
+        if (sr != NULL) {
+            self->sr = PyFloat_AsDouble(sr);
+            Py_DECREF(sr);
+        }
+    }
+
+    if (threads <= 0) {
+#ifdef _SC_NPROCESSORS_ONLN
+        threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        if (threads <= 0)
+            threads = 4;
+    }
+    if (threads > self->num)
+        threads = self->num;
+    self->threads = (pthread_t *)malloc((threads + 1) * sizeof(pthread_t));
+    for (i=0; i<threads; i++) {
+        if (pthread_create(&self->threads[i], NULL, SndTableLoader_run, self) != 0)
+            break;
+        self->numThreads++;
+    }
+    /* Without threads, the tables are loaded here. */
+    if (self->numThreads == 0 && self->num > 0) {
+        printf("SndTableLoader warning : unable to start the loading threads.\n");
+        Py_BEGIN_ALLOW_THREADS
+        SndTableLoader_run(self);
+        Py_END_ALLOW_THREADS
+    }
+
+    return (PyObject *)self;
+}
+
+static PyObject *
+SndTableLoader_wait(SndTableLoader *self)
+{
+    int index = -1;
+
+    Py_BEGIN_ALLOW_THREADS
+    pthread_mutex_lock(&self->mutex);
+    while (self->numWaited == self->numDone && self->numDone < self->num)
+        pthread_cond_wait(&self->cond, &self->mutex);
+    if (self->numWaited < self->numDone)
+        index = self->done[self->numWaited++];
+    pthread_mutex_unlock(&self->mutex);
+    Py_END_ALLOW_THREADS
+
+    if (index < 0) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+    return PyInt_FromLong(index);
+}
+
+static PyMethodDef SndTableLoader_methods[] = {
+{"wait", (PyCFunction)SndTableLoader_wait, METH_NOARGS, "Waits for the next loaded table and returns its job index, None when all the tables are loaded."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject SndTableLoaderType = {
+PyObject_HEAD_INIT(NULL)
+0,                         /*ob_size*/
+"_pyo.SndTableLoader_base",         /*tp_name*/
+sizeof(SndTableLoader),         /*tp_basicsize*/
+0,                         /*tp_itemsize*/
+(destructor)SndTableLoader_dealloc, /*tp_dealloc*/
+0,                         /*tp_print*/
+0,                         /*tp_getattr*/
+0,                         /*tp_setattr*/
+0,                         /*tp_compare*/
+0,                         /*tp_repr*/
+0,                         /*tp_as_number*/
+0,                         /*tp_as_sequence*/
+0,                         /*tp_as_mapping*/
+0,                         /*tp_hash */
+0,                         /*tp_call*/
+0,                         /*tp_str*/
+0,                         /*tp_getattro*/
+0,                         /*tp_setattro*/
+0,                         /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE, /*tp_flags*/
+"SndTableLoader objects. Loads SndTables with a pool of threads.",  /* tp_doc */
+0,                         /* tp_traverse */
+0,                         /* tp_clear */
+0,		               /* tp_richcompare */
+0,		               /* tp_weaklistoffset */
+0,		               /* tp_iter */
+0,		               /* tp_iternext */
+SndTableLoader_methods,             /* tp_methods */
+0,                         /* tp_members */
+0,                      /* tp_getset */
+0,                         /* tp_base */
+0,                         /* tp_dict */
+0,                         /* tp_descr_get */
+0,                         /* tp_descr_set */
+0,                         /* tp_dictoffset */
+0,      /* tp_init */
+0,                         /* tp_alloc */
+SndTableLoader_new,                 /* tp_new */
+};
+
 /***********************/
 /* NewTable structure */
 /***********************/
+/* A chunked table keeps its samples in `data`, rounded up to whole pages,
+ * followed by the pages appended while the recording goes past its end.
+ * `pages` indexes both. Python methods gather them back in `data`. */
+#define NEWTABLE_MAX_RETIRED 32
+
 typedef struct {
     pyo_table_HEAD
     MYFLT length;
     MYFLT feedback;
     MYFLT sr;
     int pointer;
+    int chunked;
+    MYFLT **pages;
+    int numpages; /* pages allocated */
+    int maxpages; /* capacity of the `pages` directory */
+    int datapages; /* pages [0, datapages) point into `data` */
+    MYFLT **retired[NEWTABLE_MAX_RETIRED]; /* old directories, readers may still use them */
+    int numretired;
 } NewTable;
 
+static void
+NewTable_freeRetired(NewTable *self)
+{
+    int i;
+
+    for (i=0; i<self->numretired; i++) {
+        free(self->retired[i]);
+    }
+    self->numretired = 0;
+}
+
+/* Rebuilds the directory over `data`, which must hold all the samples. */
+static void
+NewTable_setPages(NewTable *self)
+{
+    int i, n = (self->size + 1 + TABLE_PAGE_MASK) >> TABLE_PAGE_BITS;
+
+    self->data = (MYFLT *)realloc(self->data, ((long)n << TABLE_PAGE_BITS) * sizeof(MYFLT));
+    for (i=self->size+1; i<(n << TABLE_PAGE_BITS); i++) {
+        self->data[i] = 0.0;
+    }
+
+    NewTable_freeRetired(self);
+    if (n > self->maxpages) {
+        self->maxpages = n < 8 ? 16 : n * 2;
+        self->pages = (MYFLT **)realloc(self->pages, self->maxpages * sizeof(MYFLT *));
+    }
+    for (i=0; i<n; i++) {
+        self->pages[i] = self->data + ((long)i << TABLE_PAGE_BITS);
+    }
+    self->numpages = self->datapages = n;
+
+    TableStream_setSamples(self->tablestream, NULL, TABLE_NATIVE);
+    TableStream_setData(self->tablestream, self->data);
+    TableStream_setSize(self->tablestream, self->size);
+}
+
+/* Copies the appended pages in `data`, called before the Python methods. */
+static void
+NewTable_gather(NewTable *self)
+{
+    int i;
+
+    if (!self->chunked || self->numpages == self->datapages)
+        return;
+
+    self->data = (MYFLT *)realloc(self->data, ((long)self->numpages << TABLE_PAGE_BITS) * sizeof(MYFLT));
+    for (i=self->datapages; i<self->numpages; i++) {
+        memcpy(self->data + ((long)i << TABLE_PAGE_BITS), self->pages[i], TABLE_PAGE_SIZE * sizeof(MYFLT));
+        free(self->pages[i]);
+    }
+    self->datapages = self->numpages;
+    NewTable_setPages(self);
+}
+
+/* Allocates the pages holding the first `num` samples, on the audio thread.
+ * Only the page and, when full, the directory are allocated, the samples
+ * already recorded never move. */
+static int
+NewTable_reserve(NewTable *self, long num)
+{
+    MYFLT **dir;
+    MYFLT *page;
+    int n = (int)((num + TABLE_PAGE_MASK) >> TABLE_PAGE_BITS);
+
+    while (self->numpages < n) {
+        if (self->numpages == self->maxpages) {
+            if (self->numretired == NEWTABLE_MAX_RETIRED)
+                return -1;
+            dir = (MYFLT **)malloc(self->maxpages * 2 * sizeof(MYFLT *));
+            if (dir == NULL)
+                return -1;
+            memcpy(dir, self->pages, self->numpages * sizeof(MYFLT *));
+            self->retired[self->numretired++] = self->pages;
+            self->pages = dir;
+            self->maxpages *= 2;
+        }
+        page = (MYFLT *)calloc(TABLE_PAGE_SIZE, sizeof(MYFLT));
+        if (page == NULL)
+            return -1;
+        self->pages[self->numpages++] = page;
+    }
+    return 0;
+}
+
+/* Records at the pointer of a chunked table, the table grows when the
+ * recording goes past its end. */
+static void
+NewTable_appendChunk(NewTable *self, MYFLT *data, int datasize)
+{
+    int i, pos, size = self->size;
+
+    if (NewTable_reserve(self, (long)self->pointer + datasize + 1) < 0) {
+        datasize = (int)(((long)self->numpages << TABLE_PAGE_BITS) - 1 - self->pointer);
+        if (datasize <= 0)
+            return;
+    }
+
+    for (i=0; i<datasize; i++) {
+        pos = self->pointer + i;
+        if (pos < size)
+            TABLE_PAGE_SAMPLE(self->pages, pos) = data[i] + TABLE_PAGE_SAMPLE(self->pages, pos) * self->feedback;
+        else
+            TABLE_PAGE_SAMPLE(self->pages, pos) = data[i];
+    }
+    self->pointer += datasize;
+
+    if (self->pointer > size) {
+        size = self->pointer;
+        TABLE_PAGE_SAMPLE(self->pages, size) = TABLE_PAGE_SAMPLE(self->pages, 0);
+        if (self->numpages > self->datapages)
+            TableStream_setPages(self->tablestream, self->pages);
+        /* The new samples must be visible before the new size. */
+        __sync_synchronize();
+        self->size = size;
+        self->length = size / self->sr;
+        TableStream_setSize(self->tablestream, size);
+    }
+}
+
 static PyObject *
 NewTable_recordChunk(NewTable *self, MYFLT *data, int datasize)
 {
     int i;
 
-    if (self->feedback == 0.0) {
+    if (self->chunked) {
+        for (i=0; i<datasize; i++) {
+            TABLE_PAGE_SAMPLE(self->pages, self->pointer) = data[i] + TABLE_PAGE_SAMPLE(self->pages, self->pointer) * self->feedback;
+            self->pointer++;
+            if (self->pointer >= self->size) {
+                self->pointer = 0;
+                TABLE_PAGE_SAMPLE(self->pages, self->size) = TABLE_PAGE_SAMPLE(self->pages, 0);
+            }
+        }
+    }
+    else if (self->feedback == 0.0) {
         for (i=0; i<datasize; i++) {
             self->data[self->pointer++] = data[i];
             if (self->pointer == self->size) {
@@ -4510,6 +5203,13 @@ NewTable_clear(NewTable *self)
 static void
 NewTable_dealloc(NewTable* self)
 {
+    int i;
+
+    for (i=self->datapages; i<self->numpages; i++) {
+        free(self->pages[i]);
+    }
+    NewTable_freeRetired(self);
+    free(self->pages);
     free(self->data);
     NewTable_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -4530,9 +5230,9 @@ NewTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     MAKE_NEW_TABLESTREAM(self->tablestream, &TableStreamType, NULL);
 
-    static char *kwlist[] = {"length", "init", "feedback", NULL};
+    static char *kwlist[] = {"length", "init", "feedback", "chunked", NULL};
 
-    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_F_OF, kwlist, &self->length, &inittmp, &self->feedback))
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE_F_OFI, kwlist, &self->length, &inittmp, &self->feedback, &self->chunked))
         Py_RETURN_NONE;
 
     self->sr = (MYFLT)PyFloat_AsDouble(PyObject_CallMethod(self->server, "getSamplingRate", NULL));
@@ -4552,31 +5252,47 @@ NewTable_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     TableStream_setData(self->tablestream, self->data);
     TableStream_setSamplingRate(self->tablestream, self->sr);
 
+    if (self->chunked)
+        NewTable_setPages(self);
+
     return (PyObject *)self;
 }
 
 static PyObject * NewTable_getServer(NewTable* self) { GET_SERVER };
 static PyObject * NewTable_getTableStream(NewTable* self) { GET_TABLE_STREAM };
-static PyObject * NewTable_setData(NewTable *self, PyObject *arg) { SET_TABLE_DATA };
-static PyObject * NewTable_normalize(NewTable *self) { NORMALIZE };
-static PyObject * NewTable_reset(NewTable *self) { TABLE_RESET };
-static PyObject * NewTable_removeDC(NewTable *self) { REMOVE_DC };
-static PyObject * NewTable_reverse(NewTable *self) { REVERSE };
-static PyObject * NewTable_invert(NewTable *self) { INVERT };
-static PyObject * NewTable_rectify(NewTable *self) { RECTIFY };
-static PyObject * NewTable_bipolarGain(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_BIPOLAR_GAIN };
-static PyObject * NewTable_lowpass(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_LOWPASS };
-static PyObject * NewTable_fadein(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_FADEIN };
-static PyObject * NewTable_fadeout(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_FADEOUT };
-static PyObject * NewTable_pow(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_POWER };
-static PyObject * NewTable_copy(NewTable *self, PyObject *arg) { COPY };
-static PyObject * NewTable_setTable(NewTable *self, PyObject *arg) { SET_TABLE };
-static PyObject * NewTable_getTable(NewTable *self) { GET_TABLE };
-static PyObject * NewTable_put(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_PUT };
-static PyObject * NewTable_get(NewTable *self, PyObject *args, PyObject *kwds) { TABLE_GET };
-static PyObject * NewTable_add(NewTable *self, PyObject *arg) { TABLE_ADD };
-static PyObject * NewTable_sub(NewTable *self, PyObject *arg) { TABLE_SUB };
-static PyObject * NewTable_mul(NewTable *self, PyObject *arg) { TABLE_MUL };
+static PyObject * NewTable_setDataInternal(NewTable *self, PyObject *arg) { SET_TABLE_DATA };
+
+static PyObject *
+NewTable_setData(NewTable *self, PyObject *arg)
+{
+    PyObject *ret;
+
+    NewTable_gather(self);
+    ret = NewTable_setDataInternal(self, arg);
+    if (self->chunked)
+        NewTable_setPages(self);
+    return ret;
+}
+
+static PyObject * NewTable_normalize(NewTable *self) { NewTable_gather(self); NORMALIZE };
+static PyObject * NewTable_reset(NewTable *self) { NewTable_gather(self); TABLE_RESET };
+static PyObject * NewTable_removeDC(NewTable *self) { NewTable_gather(self); REMOVE_DC };
+static PyObject * NewTable_reverse(NewTable *self) { NewTable_gather(self); REVERSE };
+static PyObject * NewTable_invert(NewTable *self) { NewTable_gather(self); INVERT };
+static PyObject * NewTable_rectify(NewTable *self) { NewTable_gather(self); RECTIFY };
+static PyObject * NewTable_bipolarGain(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_BIPOLAR_GAIN };
+static PyObject * NewTable_lowpass(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_LOWPASS };
+static PyObject * NewTable_fadein(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_FADEIN };
+static PyObject * NewTable_fadeout(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_FADEOUT };
+static PyObject * NewTable_pow(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_POWER };
+static PyObject * NewTable_copy(NewTable *self, PyObject *arg) { NewTable_gather(self); COPY };
+static PyObject * NewTable_setTable(NewTable *self, PyObject *arg) { NewTable_gather(self); SET_TABLE };
+static PyObject * NewTable_getTable(NewTable *self) { NewTable_gather(self); GET_TABLE };
+static PyObject * NewTable_put(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_PUT };
+static PyObject * NewTable_get(NewTable *self, PyObject *args, PyObject *kwds) { NewTable_gather(self); TABLE_GET };
+static PyObject * NewTable_add(NewTable *self, PyObject *arg) { NewTable_gather(self); TABLE_ADD };
+static PyObject * NewTable_sub(NewTable *self, PyObject *arg) { NewTable_gather(self); TABLE_SUB };
+static PyObject * NewTable_mul(NewTable *self, PyObject *arg) { NewTable_gather(self); TABLE_MUL };
 
 static PyObject *
 NewTable_getViewTable(NewTable *self, PyObject *args, PyObject *kwds) {
@@ -4594,6 +5310,8 @@ NewTable_getViewTable(NewTable *self, PyObject *args, PyObject *kwds) {
     if (! PyArg_ParseTupleAndKeywords(args, kwds, TYPE__OFFI, kwlist, &sizetmp, &begin, &end, &yOffset))
         return PyInt_FromLong(-1);
 
+    NewTable_gather(self);
+
     if (end <= 0.0)
         end = self->size;
     else {
@@ -5252,6 +5970,21 @@ TableRec_compute_next_data_frame(TableRec *self)
         }
     }
 
+    /* A chunked table grows with the recording, which goes on until stop(). */
+    if (self->table->chunked) {
+        MYFLT *in = Stream_getData((Stream *)self->input_stream);
+        for (i=0; i<self->bufsize; i++) {
+            if (self->pointer < self->fadeInSample)
+                val = self->pointer / self->fadeInSample;
+            else
+                val = 1.;
+            self->buffer[i] = in[i] * val;
+            self->time_buffer_streams[i] = self->pointer++;
+        }
+        NewTable_appendChunk(self->table, self->buffer, self->bufsize);
+        return;
+    }
+
     if ((size - self->pointer) >= self->bufsize)
         num = self->bufsize;
     else {
@@ -5348,6 +6081,8 @@ TableRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, TableRec_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
     Stream_setStreamActive(self->stream, 0);
 
     static char *kwlist[] = {"input", "table", "fadetime", NULL};
@@ -5376,6 +6111,7 @@ TableRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     int size = PyInt_AsLong(NewTable_getSize((NewTable *)self->table));
@@ -5397,6 +6133,8 @@ static PyObject * TableRec_play(TableRec *self, PyObject *args, PyObject *kwds)
 {
     self->pointer = 0;
     self->active = 1;
+    if (self->table->chunked)
+        self->table->pointer = 0;
     PLAY
 };
 
@@ -5837,6 +6575,8 @@ TableMorph_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, TableMorph_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"input", "table", "sources", NULL};
 
@@ -6147,6 +6887,8 @@ TrigTableRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, TrigTableRec_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
 
     static char *kwlist[] = {"input", "trig", "table", "fadetime", NULL};
 
@@ -6181,6 +6923,7 @@ TrigTableRec_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     int size = PyInt_AsLong(NewTable_getSize((NewTable *)self->table));
@@ -6613,6 +7356,8 @@ TablePut_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, TablePut_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamShared(self->stream, 1);
     Stream_setStreamActive(self->stream, 0);
 
     static char *kwlist[] = {"input", "table", NULL};
@@ -6639,6 +7384,7 @@ TablePut_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     return (PyObject *)self;
@@ -6756,12 +7502,27 @@ TableWrite_compute_next_data_frame(TableWrite *self)
     PyObject *table;
 
     table = PyObject_CallMethod((PyObject *)self->table, "getTableStream", "");
-    MYFLT *tablelist = TableStream_getData((TableStream *)table);
     int size = TableStream_getSize((TableStream *)table);
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *pos = Stream_getData((Stream *)self->pos_stream);
 
+    /* Writes in the pages of a growing table, not in a converted copy. */
+    if (TableStream_getFormat((TableStream *)table) == TABLE_PAGED) {
+        MYFLT **pages = (MYFLT **)TableStream_getSamples((TableStream *)table);
+        for (i=0; i<self->bufsize; i++) {
+            ipos = (int)(pos[i] * size);
+            if (ipos < 0)
+                ipos = 0;
+            else if (ipos >= size)
+                ipos = size - 1;
+            TABLE_PAGE_SAMPLE(pages, ipos) = in[i];
+        }
+        return;
+    }
+
+    MYFLT *tablelist = TableStream_getData((TableStream *)table);
+
     for (i=0; i<self->bufsize; i++) {
         ipos = (int)(pos[i] * size);
         if (ipos < 0)
@@ -6815,6 +7576,8 @@ TableWrite_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     INIT_OBJECT_COMMON
 
     Stream_setFunctionPtr(self->stream, TableWrite_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    Stream_setStreamPyCall(self->stream, 1);
     Stream_setStreamActive(self->stream, 1);
 
     static char *kwlist[] = {"input", "pos", "table", NULL};
@@ -35,6 +35,7 @@ typedef struct {
     Stream *max_stream;
     MYFLT value;
     int modebuffer[3]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } TrigRandInt;
 
 static void
@@ -45,7 +46,7 @@ TrigRandInt_generate_i(TrigRandInt *self) {
 
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1)
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma));
 
         self->data[i] = self->value;
     }
@@ -59,7 +60,7 @@ TrigRandInt_generate_a(TrigRandInt *self) {
 
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1)
-            self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma[i]));
+            self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma[i]));
 
         self->data[i] = self->value;
     }
@@ -198,13 +199,13 @@ TrigRandInt_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, TRIGRANDINT_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, TRIGRANDINT_ID));
 
     if (self->modebuffer[2] == 0)
         ma = PyFloat_AS_DOUBLE(PyNumber_Float(self->max));
     else
         ma = Stream_getData((Stream *)self->max_stream)[0];
-    self->value = (MYFLT)((int)(rand()/((MYFLT)(RAND_MAX)+1)*ma));
+    self->value = (MYFLT)((int)(RANDOM_UNIFORM*ma));
 
     (*self->mode_func_ptr)(self);
 
@@ -388,6 +389,7 @@ typedef struct {
     MYFLT stepVal;
     int timeCount;
     int modebuffer[4]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } TrigRand;
 
 static void
@@ -401,7 +403,7 @@ TrigRand_generate_ii(TrigRand *self) {
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1) {
             self->timeCount = 0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             if (self->time <= 0.0)
                 self->currentValue = self->value;
             else
@@ -432,7 +434,7 @@ TrigRand_generate_ai(TrigRand *self) {
         MYFLT range = ma - mi[i];
         if (in[i] == 1) {
             self->timeCount = 0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             if (self->time <= 0.0)
                 self->currentValue = self->value;
             else
@@ -463,7 +465,7 @@ TrigRand_generate_ia(TrigRand *self) {
         MYFLT range = ma[i] - mi;
         if (in[i] == 1) {
             self->timeCount = 0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi;
+            self->value = range * RANDOM_UNIFORM + mi;
             if (self->time <= 0.0)
                 self->currentValue = self->value;
             else
@@ -494,7 +496,7 @@ TrigRand_generate_aa(TrigRand *self) {
         MYFLT range = ma[i] - mi[i];
         if (in[i] == 1) {
             self->timeCount = 0;
-            self->value = range * (rand()/((MYFLT)(RAND_MAX)+1)) + mi[i];
+            self->value = range * RANDOM_UNIFORM + mi[i];
             if (self->time <= 0.0)
                 self->currentValue = self->value;
             else
@@ -579,7 +581,13 @@ TrigRand_setProcMode(TrigRand *self)
 static void
 TrigRand_compute_next_data_frame(TrigRand *self)
 {
-    (*self->proc_func_ptr)(self);
+    if (Stream_getNumTriggers(self->input_stream) == 0 && self->timeCount >= self->timeStep) {
+        /* No trigger and the ramp is over, the value is held. */
+        pyo_fill(self->data, self->currentValue, self->bufsize);
+        Stream_setConstant(self->stream, 1);
+    }
+    else
+        (*self->proc_func_ptr)(self);
     (*self->muladd_func_ptr)(self);
 }
 
@@ -666,7 +674,7 @@ TrigRand_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, TRIGRAND_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, TRIGRAND_ID));
 
     self->value = self->currentValue = inittmp;
     self->timeStep = (int)(self->time * self->sr);
@@ -914,6 +922,7 @@ typedef struct {
     MYFLT stepVal;
     int timeCount;
     int modebuffer[2]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } TrigChoice;
 
 static void
@@ -924,7 +933,7 @@ TrigChoice_generate(TrigChoice *self) {
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1) {
             self->timeCount = 0;
-            self->value = self->choice[(int)((rand()/((MYFLT)(RAND_MAX))) * self->chSize)];
+            self->value = self->choice[(int)(RANDOM_UNIFORM * self->chSize)];
             if (self->time <= 0.0)
                 self->currentValue = self->value;
             else
@@ -1068,7 +1077,7 @@ TrigChoice_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, TRIGCHOICE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, TRIGCHOICE_ID));
 
     self->value = self->currentValue = inittmp;
     self->timeStep = (int)(self->time * self->sr);
@@ -1265,30 +1274,48 @@ typedef struct {
     PyObject *func;
 } TrigFunc;
 
+static int
+TrigFunc_call(TrigFunc *self)
+{
+    PyObject *tuple, *result;
+
+    if (self->arg == Py_None)
+        tuple = PyTuple_New(0);
+    else
+        tuple = PyTuple_Pack(1, self->arg);
+    result = PyObject_Call(self->func, tuple, NULL);
+    Py_DECREF(tuple);
+    if (result == NULL) {
+        PyErr_Print();
+        return -1;
+    }
+    Py_DECREF(result);
+    return 0;
+}
+
+static void
+TrigFunc_callback(PyObject *obj, double value)
+{
+    TrigFunc_call((TrigFunc *)obj);
+}
+
 static void
 TrigFunc_generate(TrigFunc *self) {
     int i;
-    PyObject *tuple, *result;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
+    if (Server_isGILFree((Server *)self->server)) {
+        for (i=0; i<self->bufsize; i++) {
+            if (in[i] == 1)
+                Server_postCallback((Server *)self->server, (PyObject *)self, TrigFunc_callback, 0);
+        }
+        return;
+    }
+
     for (i=0; i<self->bufsize; i++) {
         if (in[i] == 1) {
-            if (self->arg == Py_None) {
-                result = PyObject_Call(self->func, PyTuple_New(0), NULL);
-                if (result == NULL) {
-                    PyErr_Print();
-                    return;
-                }
-            }
-            else {
-                tuple = PyTuple_New(1);
-                PyTuple_SET_ITEM(tuple, 0, self->arg);
-                result = PyObject_Call(self->func, tuple, NULL);
-                if (result == NULL) {
-                    PyErr_Print();
-                    return;
-                }
-            }
+            if (TrigFunc_call(self) < 0)
+                return;
         }
     }
 }
@@ -1341,6 +1368,11 @@ TrigFunc_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, TrigFunc_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    if (Server_isGILFree((Server *)self->server))
+        Stream_setStreamShared(self->stream, 1);
+    else
+        Stream_setStreamPyCall(self->stream, 1);
 
     static char *kwlist[] = {"input", "function", "arg", NULL};
 
@@ -1479,16 +1511,18 @@ typedef struct {
     MYFLT *trigsBuffer;
     TriggerStream *trig_stream;
     int interp; /* 0 = default to 2, 1 = nointerp, 2 = linear, 3 = cos, 4 = cubic */
-    MYFLT (*interp_func_ptr)(MYFLT *, int, MYFLT, int);
 } TrigEnv;
 
 static void
 TrigEnv_readframes_i(TrigEnv *self) {
-    MYFLT fpart;
-    int i, ipart;
+    int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    char on[self->bufsize];
 
     for (i=0; i<self->bufsize; i++) {
         self->trigsBuffer[i] = 0.0;
@@ -1507,29 +1541,41 @@ TrigEnv_readframes_i(TrigEnv *self) {
             self->pointerPos = 0.;
         }
         if (self->active == 1) {
-            ipart = (int)self->pointerPos;
-            fpart = self->pointerPos - ipart;
-            self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)self->pointerPos;
+            fpos[i] = self->pointerPos - ipos[i];
+            on[i] = 1;
             self->pointerPos += self->inc;
         }
-        else
-            self->data[i] = 0.;
+        else {
+            ipos[i] = 0;
+            fpos[i] = 0.0;
+            on[i] = 0;
+        }
 
         if (self->pointerPos > size && self->active == 1) {
             self->trigsBuffer[i] = 1.0;
             self->active = 0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        if (!on[i])
+            self->data[i] = 0.;
+    }
 }
 
 static void
 TrigEnv_readframes_a(TrigEnv *self) {
-    MYFLT fpart, dur;
-    int i, ipart;
+    MYFLT dur;
+    int i;
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *dur_st = Stream_getData((Stream *)self->dur_stream);
-    MYFLT *tablelist = TableStream_getData(self->table);
+    void *tablelist = TableStream_getSamples(self->table);
+    TableInterpBlockFunc interp = TableInterp_getBlock(self->interp, TableStream_getFormat(self->table));
     int size = TableStream_getSize(self->table);
+    int ipos[self->bufsize];
+    MYFLT fpos[self->bufsize];
+    char on[self->bufsize];
 
     for (i=0; i<self->bufsize; i++) {
         self->trigsBuffer[i] = 0.0;
@@ -1548,19 +1594,27 @@ TrigEnv_readframes_a(TrigEnv *self) {
             self->pointerPos = 0.;
         }
         if (self->active == 1) {
-            ipart = (int)self->pointerPos;
-            fpart = self->pointerPos - ipart;
-            self->data[i] = (*self->interp_func_ptr)(tablelist, ipart, fpart, size);
+            ipos[i] = (int)self->pointerPos;
+            fpos[i] = self->pointerPos - ipos[i];
+            on[i] = 1;
             self->pointerPos += self->inc;
         }
-        else
-            self->data[i] = 0.;
+        else {
+            ipos[i] = 0;
+            fpos[i] = 0.0;
+            on[i] = 0;
+        }
 
         if (self->pointerPos > size && self->active == 1) {
             self->trigsBuffer[i] = 1.0;
             self->active = 0;
         }
     }
+    (*interp)(tablelist, ipos, fpos, self->data, self->bufsize, size);
+    for (i=0; i<self->bufsize; i++) {
+        if (!on[i])
+            self->data[i] = 0.;
+    }
 }
 
 static void TrigEnv_postprocessing_ii(TrigEnv *self) { POST_PROCESSING_II };
@@ -1622,7 +1676,14 @@ TrigEnv_setProcMode(TrigEnv *self)
 static void
 TrigEnv_compute_next_data_frame(TrigEnv *self)
 {
-    (*self->proc_func_ptr)(self);
+    if (Stream_getNumTriggers(self->input_stream) == 0 && self->active == 0) {
+        /* No trigger and no envelope running. */
+        pyo_fill(self->data, 0.0, self->bufsize);
+        pyo_fill(self->trigsBuffer, 0.0, self->bufsize);
+        Stream_setConstant(self->stream, 1);
+    }
+    else
+        (*self->proc_func_ptr)(self);
     (*self->muladd_func_ptr)(self);
 }
 
@@ -1719,11 +1780,12 @@ TrigEnv_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     (*self->mode_func_ptr)(self);
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     return (PyObject *)self;
 }
@@ -1822,7 +1884,7 @@ TrigEnv_setInterp(TrigEnv *self, PyObject *arg)
 		self->interp = PyInt_AsLong(PyNumber_Int(arg));
     }
 
-    SET_INTERP_POINTER
+    SET_TABLE_INTERP
 
     Py_INCREF(Py_None);
     return Py_None;
@@ -2161,6 +2223,7 @@ TrigLinseg_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     (*self->mode_func_ptr)(self);
@@ -2564,6 +2627,7 @@ TrigExpseg_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     }
 
     MAKE_NEW_TRIGGER_STREAM(self->trig_stream, &TriggerStreamType, NULL);
+    Stream_setStreamKeep(self->stream, 1);
     TriggerStream_setData(self->trig_stream, self->trigsBuffer);
 
     (*self->mode_func_ptr)(self);
@@ -2780,6 +2844,7 @@ typedef struct {
     int loopLen;
     int loopStop;
     int modebuffer[4]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } TrigXnoise;
 
 // no parameter
@@ -2859,7 +2924,7 @@ TrigXnoise_cauchy(TrigXnoise *self) {
     }
     while (rnd == 0.5);
 
-    if (rand() < (RAND_MAX / 2))
+    if (RANDOM_INT < (RANDOM_MAX / 2))
         dir = -1;
     else
         dir = 1;
@@ -2920,7 +2985,7 @@ TrigXnoise_poisson(TrigXnoise *self) {
             }
         }
     }
-    val = self->poisson_buffer[rand() % self->poisson_tab] / 12.0 * self->xx2;
+    val = self->poisson_buffer[RANDOM_INT % self->poisson_tab] / 12.0 * self->xx2;
 
     if (val < 0.0) return 0.0;
     else if (val > 1.0) return 1.0;
@@ -2935,12 +3000,12 @@ TrigXnoise_walker(TrigXnoise *self) {
     if (self->xx2 < 0.002) self->xx2 = 0.002;
 
     modulo = (int)(self->xx2 * 1000.0);
-    dir = rand() % 2;
+    dir = RANDOM_INT % 2;
 
     if (dir == 0)
-        self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
     else
-        self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
     if (self->walkerValue > self->xx1)
         self->walkerValue = self->xx1;
@@ -2962,12 +3027,12 @@ TrigXnoise_loopseg(TrigXnoise *self) {
         if (self->xx2 < 0.002) self->xx2 = 0.002;
 
         modulo = (int)(self->xx2 * 1000.0);
-        dir = rand() % 2;
+        dir = RANDOM_INT % 2;
 
         if (dir == 0)
-            self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
         else
-            self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
         if (self->walkerValue > self->xx1)
             self->walkerValue = self->xx1;
@@ -2980,7 +3045,7 @@ TrigXnoise_loopseg(TrigXnoise *self) {
             self->loopChoice = 0;
         else {
             self->loopChoice = 1;
-            self->loopStop = (rand() % 4) + 1;
+            self->loopStop = (RANDOM_INT % 4) + 1;
         }
     }
     else {
@@ -2997,7 +3062,7 @@ TrigXnoise_loopseg(TrigXnoise *self) {
 
         if (self->loopTime == self->loopStop) {
             self->loopChoice = 0;
-            self->loopLen = (rand() % 10) + 3;
+            self->loopLen = (RANDOM_INT % 10) + 3;
         }
     }
 
@@ -3236,7 +3301,7 @@ TrigXnoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
 
-    Server_generateSeed((Server *)self->server, TRIGXNOISE_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, TRIGXNOISE_ID));
 
     self->poisson_tab = 0;
     self->lastPoissonX1 = -99.0;
@@ -3247,7 +3312,7 @@ TrigXnoise_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->loop_buffer[i] = 0.0;
     }
     self->loopChoice = self->loopCountPlay = self->loopTime = self->loopCountRec = self->loopStop = 0;
-    self->loopLen = (rand() % 10) + 3;
+    self->loopLen = (RANDOM_INT % 10) + 3;
 
     Stream_setFunctionPtr(self->stream, TrigXnoise_compute_next_data_frame);
     self->mode_func_ptr = TrigXnoise_setProcMode;
@@ -3534,6 +3599,7 @@ typedef struct {
     int loopLen;
     int loopStop;
     int modebuffer[4]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } TrigXnoiseMidi;
 
 static MYFLT
@@ -3638,7 +3704,7 @@ TrigXnoiseMidi_cauchy(TrigXnoiseMidi *self) {
     }
     while (rnd == 0.5);
 
-    if (rand() < (RAND_MAX / 2))
+    if (RANDOM_INT < (RANDOM_MAX / 2))
         dir = -1;
     else
         dir = 1;
@@ -3699,7 +3765,7 @@ TrigXnoiseMidi_poisson(TrigXnoiseMidi *self) {
             }
         }
     }
-    val = self->poisson_buffer[rand() % self->poisson_tab] / 12.0 * self->xx2;
+    val = self->poisson_buffer[RANDOM_INT % self->poisson_tab] / 12.0 * self->xx2;
 
     if (val < 0.0) return 0.0;
     else if (val > 1.0) return 1.0;
@@ -3714,12 +3780,12 @@ TrigXnoiseMidi_walker(TrigXnoiseMidi *self) {
     if (self->xx2 < 0.002) self->xx2 = 0.002;
 
     modulo = (int)(self->xx2 * 1000.0);
-    dir = rand() % 2;
+    dir = RANDOM_INT % 2;
 
     if (dir == 0)
-        self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
     else
-        self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+        self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
     if (self->walkerValue > self->xx1)
         self->walkerValue = self->xx1;
@@ -3741,12 +3807,12 @@ TrigXnoiseMidi_loopseg(TrigXnoiseMidi *self) {
         if (self->xx2 < 0.002) self->xx2 = 0.002;
 
         modulo = (int)(self->xx2 * 1000.0);
-        dir = rand() % 2;
+        dir = RANDOM_INT % 2;
 
         if (dir == 0)
-            self->walkerValue = self->walkerValue + (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue + (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
         else
-            self->walkerValue = self->walkerValue - (((rand() % modulo) - (modulo / 2)) * 0.001);
+            self->walkerValue = self->walkerValue - (((RANDOM_INT % modulo) - (modulo / 2)) * 0.001);
 
         if (self->walkerValue > self->xx1)
             self->walkerValue = self->xx1;
@@ -3759,7 +3825,7 @@ TrigXnoiseMidi_loopseg(TrigXnoiseMidi *self) {
             self->loopChoice = 0;
         else {
             self->loopChoice = 1;
-            self->loopStop = (rand() % 4) + 1;
+            self->loopStop = (RANDOM_INT % 4) + 1;
         }
     }
     else {
@@ -3776,7 +3842,7 @@ TrigXnoiseMidi_loopseg(TrigXnoiseMidi *self) {
 
         if (self->loopTime == self->loopStop) {
             self->loopChoice = 0;
-            self->loopLen = (rand() % 10) + 3;
+            self->loopLen = (RANDOM_INT % 10) + 3;
         }
     }
 
@@ -4024,7 +4090,7 @@ TrigXnoiseMidi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
 
-    Server_generateSeed((Server *)self->server, TRIGXNOISEMIDI_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, TRIGXNOISEMIDI_ID));
 
     self->poisson_tab = 0;
     self->lastPoissonX1 = -99.0;
@@ -4035,7 +4101,7 @@ TrigXnoiseMidi_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->loop_buffer[i] = 0.0;
     }
     self->loopChoice = self->loopCountPlay = self->loopTime = self->loopCountRec = self->loopStop = 0;
-    self->loopLen = (rand() % 10) + 3;
+    self->loopLen = (RANDOM_INT % 10) + 3;
 
     Stream_setFunctionPtr(self->stream, TrigXnoiseMidi_compute_next_data_frame);
     self->mode_func_ptr = TrigXnoiseMidi_setProcMode;
@@ -4355,36 +4421,54 @@ typedef struct {
     int modebuffer[2]; // need at least 2 slots for mul & add
 } Counter;
 
+static void
+Counter_trigger(Counter *self) {
+    self->value = (MYFLT)self->tmp;
+    if (self->dir == 0) {
+        self->tmp++;
+        if (self->tmp >= self->max)
+            self->tmp = self->min;
+    }
+    else if (self->dir == 1) {
+        self->tmp--;
+        if (self->tmp < self->min)
+            self->tmp = self->max - 1;
+    }
+    else if (self->dir == 2) {
+        self->tmp = self->tmp + self->direction;
+        if (self->tmp >= self->max) {
+            self->direction = -1;
+            self->tmp = self->max - 2;
+        }
+        if (self->tmp <= self->min) {
+            self->direction = 1;
+            self->tmp = self->min;
+        }
+    }
+}
+
 static void
 Counter_generates(Counter *self) {
-    int i;
+    int i, pos, num = Stream_getNumTriggers(self->input_stream);
+    int *trigs = Stream_getTriggers(self->input_stream);
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
 
-    for (i=0; i<self->bufsize; i++) {
-        if (in[i] == 1) {
-            self->value = (MYFLT)self->tmp;
-            if (self->dir == 0) {
-                self->tmp++;
-                if (self->tmp >= self->max)
-                    self->tmp = self->min;
-            }
-            else if (self->dir == 1) {
-                self->tmp--;
-                if (self->tmp < self->min)
-                    self->tmp = self->max - 1;
-            }
-            else if (self->dir == 2) {
-                self->tmp = self->tmp + self->direction;
-                if (self->tmp >= self->max) {
-                    self->direction = -1;
-                    self->tmp = self->max - 2;
-                }
-                if (self->tmp <= self->min) {
-                    self->direction = 1;
-                    self->tmp = self->min;
-                }
-            }
+    if (num >= 0) {
+        /* The value is held from one trigger to the next. */
+        pos = 0;
+        for (i=0; i<num; i++) {
+            pyo_fill(self->data + pos, self->value, trigs[i] - pos);
+            Counter_trigger(self);
+            pos = trigs[i];
         }
+        pyo_fill(self->data + pos, self->value, self->bufsize - pos);
+        Stream_setConstant(self->stream, num == 0);
+        return;
+    }
+
+    for (i=0; i<self->bufsize; i++) {
+        if (in[i] == 1)
+            Counter_trigger(self);
         self->data[i] = self->value;
     }
 }
@@ -5141,6 +5225,7 @@ typedef struct {
     PyObject *percent;
     Stream *percent_stream;
     int modebuffer[3];
+    PyoRand rng;
 } Percent;
 
 static void
@@ -5152,7 +5237,7 @@ Percent_generates_i(Percent *self) {
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = 0.0;
         if (in[i] == 1.0) {
-            guess = (rand()/((MYFLT)(RAND_MAX)+1)) * 100.0;
+            guess = RANDOM_UNIFORM * 100.0;
             if (guess <= perc)
                 self->data[i] = 1.0;
         }
@@ -5169,7 +5254,7 @@ Percent_generates_a(Percent *self) {
     for (i=0; i<self->bufsize; i++) {
         self->data[i] = 0.0;
         if (in[i] == 1.0) {
-            guess = (rand()/((MYFLT)(RAND_MAX)+1)) * 100.0;
+            guess = RANDOM_UNIFORM * 100.0;
             if (guess <= perc[i])
                 self->data[i] = 1.0;
         }
@@ -5306,7 +5391,7 @@ Percent_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, PERCENT_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, PERCENT_ID));
 
     (*self->mode_func_ptr)(self);
 
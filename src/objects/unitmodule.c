@@ -0,0 +1,362 @@
+/**************************************************************************
+ * Copyright 2009-2015 Olivier Belanger                                   *
+ *                                                                        *
+ * This file is part of pyo, a python module to help digital signal       *
+ * processing script creation.                                            *
+ *                                                                        *
+ * pyo is free software: you can redistribute it and/or modify            *
+ * it under the terms of the GNU Lesser General Public License as         *
+ * published by the Free Software Foundation, either version 3 of the     *
+ * License, or (at your option) any later version.                        *
+ *                                                                        *
+ * pyo is distributed in the hope that it will be useful,                 *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ * GNU Lesser General Public License for more details.                    *
+ *                                                                        *
+ * You should have received a copy of the GNU Lesser General Public       *
+ * License along with pyo.  If not, see <http://www.gnu.org/licenses/>.   *
+ *************************************************************************/
+
+#include <Python.h>
+#include "structmember.h"
+#include "pyomodule.h"
+#include "streammodule.h"
+#include "servermodule.h"
+#include "packed.h"
+#include "pyounit.h"
+
+#define PYO_MAX_UNITS 256
+
+static const PyoUnit *units[PYO_MAX_UNITS];
+static int unit_count = 0;
+
+int
+PyoUnit_register(const PyoUnit *unit)
+{
+    if (unit_count == PYO_MAX_UNITS || PyoUnit_find(unit->name) != NULL)
+        return -1;
+    units[unit_count++] = unit;
+    return 0;
+}
+
+const PyoUnit *
+PyoUnit_find(const char *name)
+{
+    int i;
+
+    for (i=0; i<unit_count; i++) {
+        if (strcmp(units[i]->name, name) == 0)
+            return units[i];
+    }
+    return NULL;
+}
+
+/* The unit given as a name or a capsule. Returns NULL with an exception set
+ * if there is none or if it was built for another ABI. */
+static const PyoUnit *
+PyoUnit_fromObject(PyObject *arg)
+{
+    const PyoUnit *unit = NULL;
+
+    if (PyString_Check(arg)) {
+        unit = PyoUnit_find(PyString_AsString(arg));
+        if (unit == NULL) {
+            PyErr_Format(PyExc_ValueError, "no unit named \"%s\".", PyString_AsString(arg));
+            return NULL;
+        }
+    }
+    else if (PyCapsule_CheckExact(arg)) {
+        unit = (const PyoUnit *)PyCapsule_GetPointer(arg, PYO_UNIT_CAPSULE);
+        if (unit == NULL)
+            return NULL;
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError, "unit must be a name or a capsule.");
+        return NULL;
+    }
+
+    if (unit->version != PYO_UNIT_VERSION || unit->floatsize != sizeof(MYFLT)) {
+        PyErr_Format(PyExc_ValueError, "unit \"%s\" is built for another version or precision of pyo.", unit->name);
+        return NULL;
+    }
+    if (unit->noutputs < 1 || unit->ninputs < 0 || unit->nparams < 0 || unit->process == NULL) {
+        PyErr_Format(PyExc_ValueError, "unit \"%s\" is malformed.", unit->name);
+        return NULL;
+    }
+    return unit;
+}
+
+PyObject *
+PyoUnit_info(PyObject *self, PyObject *arg)
+{
+    int i;
+    PyObject *params;
+    const PyoUnit *unit = PyoUnit_fromObject(arg);
+
+    if (unit == NULL)
+        return NULL;
+
+    params = PyList_New(unit->nparams);
+    for (i=0; i<unit->nparams; i++) {
+        PyList_SET_ITEM(params, i, Py_BuildValue("(sdi)", unit->params[i].name, (double)unit->params[i].value,
+                                                 unit->params[i].rate));
+    }
+    return Py_BuildValue("{s:s,s:i,s:i,s:N}", "name", unit->name, "inputs", unit->ninputs,
+                         "outputs", unit->noutputs, "params", params);
+}
+
+/*************************************/
+/* UnitMain, read by PackedChannel  */
+/*************************************/
+/* UnitMain hosts a PyoUnit. Its outputs are the channels of its packed
+ * stream. */
+typedef struct {
+    pyo_audio_HEAD
+    const PyoUnit *unit;
+    void *state;
+    PyObject *input; /* list of streams, one per input */
+    PyObject *params; /* list of streams or None, one per parameter */
+    Stream **input_streams; /* borrowed from the lists, NULL for a float */
+    Stream **param_streams;
+    MYFLT *values;
+    MYFLT *vectors; /* audio rate parameters given as floats, aligned */
+    int stride; /* samples between two vectors */
+    const MYFLT **ins;
+    MYFLT **outs;
+    const MYFLT **pvals;
+} UnitMain;
+
+static void
+UnitMain_compute_next_data_frame(UnitMain *self)
+{
+    int j;
+    const PyoUnit *unit = self->unit;
+
+    for (j=0; j<unit->ninputs; j++) {
+        self->ins[j] = Stream_getData(self->input_streams[j]);
+    }
+    for (j=0; j<unit->nparams; j++) {
+        if (self->param_streams[j] != NULL)
+            self->pvals[j] = Stream_getData(self->param_streams[j]);
+        else if (unit->params[j].rate == PYO_UNIT_ARATE)
+            self->pvals[j] = self->vectors + j * self->stride;
+        else
+            self->pvals[j] = self->values + j;
+    }
+    (*unit->process)(self->state, self->ins, self->outs, self->pvals, self->bufsize);
+}
+
+static void
+UnitMain_setProcMode(UnitMain *self) {}
+
+static int
+UnitMain_traverse(UnitMain *self, visitproc visit, void *arg)
+{
+    pyo_VISIT
+    Py_VISIT(self->input);
+    Py_VISIT(self->params);
+    return 0;
+}
+
+static int
+UnitMain_clear(UnitMain *self)
+{
+    pyo_CLEAR
+    Py_CLEAR(self->input);
+    Py_CLEAR(self->params);
+    return 0;
+}
+
+static void
+UnitMain_dealloc(UnitMain* self)
+{
+    pyo_DEALLOC
+    if (self->state != NULL && self->unit->release != NULL)
+        (*self->unit->release)(self->state);
+    free(self->state);
+    free(self->input_streams);
+    free(self->param_streams);
+    free(self->values);
+    pyo_aligned_free(self->vectors);
+    free(self->ins);
+    free(self->outs);
+    free(self->pvals);
+    UnitMain_clear(self);
+    self->ob_type->tp_free((PyObject*)self);
+}
+
+static PyObject *
+UnitMain_setParams(UnitMain *self, PyObject *arg)
+{
+    int j;
+    const PyoUnit *unit = self->unit;
+
+    if (unit->nparams == 0) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    if (Packed_setValues(arg, unit->nparams, &self->params, self->values, self->param_streams) < 0)
+        return NULL;
+    for (j=0; j<unit->nparams; j++) {
+        if (unit->params[j].rate == PYO_UNIT_ARATE && self->param_streams[j] == NULL)
+            pyo_fill(self->vectors + j * self->stride, self->values[j], self->bufsize);
+    }
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+UnitMain_setInput(UnitMain *self, PyObject *arg)
+{
+    if (self->unit->ninputs == 0) {
+        Py_INCREF(Py_None);
+        return Py_None;
+    }
+
+    if (Packed_setValues(arg, self->unit->ninputs, &self->input, NULL, self->input_streams) < 0)
+        return NULL;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+static PyObject *
+UnitMain_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
+{
+    int i, j;
+    PyObject *unittmp, *inputtmp=NULL, *paramstmp=NULL, *res;
+    const PyoUnit *unit;
+    UnitMain *self;
+    self = (UnitMain *)type->tp_alloc(type, 0);
+
+    INIT_OBJECT_COMMON
+    Stream_setFunctionPtr(self->stream, UnitMain_compute_next_data_frame);
+    self->mode_func_ptr = UnitMain_setProcMode;
+
+    static char *kwlist[] = {"unit", "input", "params", NULL};
+
+    if (! PyArg_ParseTupleAndKeywords(args, kwds, "O|OO", kwlist, &unittmp, &inputtmp, &paramstmp))
+        Py_RETURN_NONE;
+
+    if ((unit = PyoUnit_fromObject(unittmp)) == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    self->unit = unit;
+
+    self->input_streams = (Stream **)calloc(unit->ninputs + 1, sizeof(Stream *));
+    self->param_streams = (Stream **)calloc(unit->nparams + 1, sizeof(Stream *));
+    self->values = (MYFLT *)calloc(unit->nparams + 1, sizeof(MYFLT));
+    self->stride = PYO_ALIGN_FRAMES(self->bufsize);
+    self->vectors = (MYFLT *)pyo_aligned_calloc((unit->nparams + 1) * self->stride * sizeof(MYFLT));
+    self->ins = (const MYFLT **)calloc(unit->ninputs + 1, sizeof(MYFLT *));
+    self->outs = (MYFLT **)calloc(unit->noutputs, sizeof(MYFLT *));
+    self->pvals = (const MYFLT **)calloc(unit->nparams + 1, sizeof(MYFLT *));
+    self->state = calloc(1, unit->size > 0 ? unit->size : 1);
+    INIT_PACKED_STREAM(unit->noutputs)
+    for (j=0; j<unit->noutputs; j++) {
+        self->outs[j] = self->data + j * self->bufsize;
+    }
+    Stream_setMemory(self->stream, unit->size + (unit->nparams + 1) * self->stride * sizeof(MYFLT));
+
+    for (j=0; j<unit->nparams; j++) {
+        self->values[j] = unit->params[j].value;
+        pyo_fill(self->vectors + j * self->stride, self->values[j], self->bufsize);
+    }
+    if (unit->init != NULL)
+        (*unit->init)(self->state, self->sr, self->bufsize);
+
+    if (unit->ninputs > 0) {
+        if (inputtmp == NULL || inputtmp == Py_None) {
+            PyErr_Format(PyExc_TypeError, "unit \"%s\" needs %d input(s).", unit->name, unit->ninputs);
+            Py_DECREF(self);
+            return NULL;
+        }
+        res = UnitMain_setInput(self, inputtmp);
+        if (res == NULL) {
+            Py_DECREF(self);
+            return NULL;
+        }
+        Py_DECREF(res);
+    }
+
+    if (paramstmp != NULL && paramstmp != Py_None) {
+        res = UnitMain_setParams(self, paramstmp);
+        if (res == NULL) {
+            Py_DECREF(self);
+            return NULL;
+        }
+        Py_DECREF(res);
+    }
+
+    PyObject_CallMethod(self->server, "addStream", "O", self->stream);
+
+    return (PyObject *)self;
+}
+
+static PyObject * UnitMain_getServer(UnitMain* self) { GET_SERVER };
+static PyObject * UnitMain_getStream(UnitMain* self) { GET_STREAM };
+
+static PyObject * UnitMain_play(UnitMain *self, PyObject *args, PyObject *kwds) { PLAY };
+static PyObject * UnitMain_stop(UnitMain *self) { STOP_PACKED(self->unit->noutputs) };
+
+static PyMemberDef UnitMain_members[] = {
+{"server", T_OBJECT_EX, offsetof(UnitMain, server), 0, "Pyo server."},
+{"stream", T_OBJECT_EX, offsetof(UnitMain, stream), 0, "Stream object."},
+{NULL}  /* Sentinel */
+};
+
+static PyMethodDef UnitMain_methods[] = {
+{"getServer", (PyCFunction)UnitMain_getServer, METH_NOARGS, "Returns server object."},
+{"_getStream", (PyCFunction)UnitMain_getStream, METH_NOARGS, "Returns stream object."},
+{"play", (PyCFunction)UnitMain_play, METH_VARARGS|METH_KEYWORDS, "Starts computing without sending sound to soundcard."},
+{"stop", (PyCFunction)UnitMain_stop, METH_NOARGS, "Stops computing."},
+{"setInput", (PyCFunction)UnitMain_setInput, METH_O, "Sets the list of input signals."},
+{"setParams", (PyCFunction)UnitMain_setParams, METH_O, "Sets the list of parameters."},
+{NULL}  /* Sentinel */
+};
+
+PyTypeObject UnitMainType = {
+PyObject_HEAD_INIT(NULL)
+0,                                              /*ob_size*/
+"_pyo.UnitMain_base",                           /*tp_name*/
+sizeof(UnitMain),                               /*tp_basicsize*/
+0,                                              /*tp_itemsize*/
+(destructor)UnitMain_dealloc,                   /*tp_dealloc*/
+0,                                              /*tp_print*/
+0,                                              /*tp_getattr*/
+0,                                              /*tp_setattr*/
+0,                                              /*tp_compare*/
+0,                                              /*tp_repr*/
+0,                                              /*tp_as_number*/
+0,                                              /*tp_as_sequence*/
+0,                                              /*tp_as_mapping*/
+0,                                              /*tp_hash */
+0,                                              /*tp_call*/
+0,                                              /*tp_str*/
+0,                                              /*tp_getattro*/
+0,                                              /*tp_setattro*/
+0,                                              /*tp_as_buffer*/
+Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE | Py_TPFLAGS_HAVE_GC, /*tp_flags*/
+"UnitMain objects. Hosts a block processing unit, its outputs in a packed stream.", /* tp_doc */
+(traverseproc)UnitMain_traverse,                /* tp_traverse */
+(inquiry)UnitMain_clear,                        /* tp_clear */
+0,                                              /* tp_richcompare */
+0,                                              /* tp_weaklistoffset */
+0,                                              /* tp_iter */
+0,                                              /* tp_iternext */
+UnitMain_methods,                               /* tp_methods */
+UnitMain_members,                               /* tp_members */
+0,                                              /* tp_getset */
+0,                                              /* tp_base */
+0,                                              /* tp_dict */
+0,                                              /* tp_descr_get */
+0,                                              /* tp_descr_set */
+0,                                              /* tp_dictoffset */
+0,                                              /* tp_init */
+0,                                              /* tp_alloc */
+UnitMain_new,                                   /* tp_new */
+};
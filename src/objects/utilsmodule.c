@@ -41,6 +41,26 @@ typedef struct {
     MYFLT sampleToSec;
 } Print;
 
+static void
+Print_callback(PyObject *obj, double value)
+{
+    Print *self = (Print *)obj;
+
+    if (self->message == NULL || self->message[0] == '\0')
+        printf("%f\n", value);
+    else
+        printf("%s : %f\n", self->message, value);
+}
+
+static void
+Print_print(Print *self, MYFLT value)
+{
+    if (Server_isGILFree((Server *)self->server))
+        Server_postCallback((Server *)self->server, (PyObject *)self, Print_callback, value);
+    else
+        Print_callback((PyObject *)self, value);
+}
+
 static void
 Print_process_time(Print *self) {
     int i;
@@ -49,10 +69,7 @@ Print_process_time(Print *self) {
     for (i=0; i<self->bufsize; i++) {
         if (self->currentTime >= self->time) {
             self->currentTime = 0.0;
-            if (self->message == NULL || self->message[0] == '\0')
-                printf("%f\n", in[i]);
-            else
-                printf("%s : %f\n", self->message, in[i]);
+            Print_print(self, in[i]);
         }
         self->currentTime += self->sampleToSec;
     }
@@ -67,10 +84,7 @@ Print_process_change(Print *self) {
     for (i=0; i<self->bufsize; i++) {
         inval = in[i];
         if (inval < (self->lastValue-0.00001) || inval > (self->lastValue+0.00001)) {
-            if (self->message == NULL || self->message[0] == '\0')
-                printf("%f\n", inval);
-            else
-                printf("%s : %f\n", self->message, inval);
+            Print_print(self, inval);
             self->lastValue = inval;
         }
     }
@@ -138,6 +152,11 @@ Print_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     INIT_OBJECT_COMMON
     Stream_setFunctionPtr(self->stream, Print_compute_next_data_frame);
+    Stream_setStreamSink(self->stream, 1);
+    if (Server_isGILFree((Server *)self->server))
+        Stream_setStreamShared(self->stream, 1);
+    else
+        Stream_setStreamPyCall(self->stream, 1);
     self->mode_func_ptr = Print_setProcMode;
 
     self->sampleToSec = 1. / self->sr;
@@ -2609,9 +2628,9 @@ PyTypeObject BetweenType = {
 /* Denorm */
 /************/
 #ifndef USE_DOUBLE
-#define DENORM_RAND  ((MYFLT) ((rand()/((MYFLT)(RAND_MAX)*0.5+1) - 1.0) * (MYFLT)(1.0e-24)))
+#define DENORM_RAND  ((MYFLT) ((RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5+1) - 1.0) * (MYFLT)(1.0e-24)))
 #else
-#define DENORM_RAND  ((MYFLT) ((rand()/((MYFLT)(RAND_MAX)*0.5+1) - 1.0) * (MYFLT)(1.0e-60)))
+#define DENORM_RAND  ((MYFLT) ((RANDOM_INT/((MYFLT)(RANDOM_MAX)*0.5+1) - 1.0) * (MYFLT)(1.0e-60)))
 #endif
 
 typedef struct {
@@ -2619,6 +2638,7 @@ typedef struct {
     PyObject *input;
     Stream *input_stream;
     int modebuffer[2]; // need at least 2 slots for mul & add
+    PyoRand rng;
 } Denorm;
 
 static void
@@ -2745,7 +2765,7 @@ Denorm_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
-    Server_generateSeed((Server *)self->server, DENORM_ID);
+    PyoRand_seed(&self->rng, Server_generateSeed((Server *)self->server, DENORM_ID));
 
     (*self->mode_func_ptr)(self);
 
@@ -25,6 +25,7 @@
 #include "streammodule.h"
 #include "servermodule.h"
 #include "dummymodule.h"
+#include "wglines.h"
 
 #define NUM_REFS  13
 
@@ -53,265 +54,69 @@ typedef struct {
     Stream *mix_stream;
     void (*mix_func_ptr)();
     int modebuffer[5];
-    MYFLT total_signal;
-    MYFLT delays[8];
-    long size[8];
-    int in_count[8];
-    MYFLT *buffer[8];
+    WGLines lines;
     // lowpass
     MYFLT damp;
     MYFLT lastFreq;
-    // sample memories
-    MYFLT lastSamples[8];
-    // jitters
-    MYFLT rnd[8];
-    MYFLT rnd_value[8];
-    MYFLT rnd_oldValue[8];
-    MYFLT rnd_diff[8];
-    MYFLT rnd_time[8];
-    MYFLT rnd_timeInc[8];
-    MYFLT rnd_range[8];
-    MYFLT rnd_halfRange[8];
 } WGVerb;
 
 static void
-WGVerb_process_ii(WGVerb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt;
-    int i, j, ind;
+WGVerb_process(WGVerb *self) {
+    MYFLT fd, freq, *feedback, *cutoff;
+    int i;
+    MYFLT feed[self->bufsize];
+    MYFLT damp[self->bufsize];
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
-    MYFLT freq = PyFloat_AS_DOUBLE(self->cutoff);
-
-    if (feed < 0)
-        feed = 0;
-    else if (feed > 1)
-        feed = 1;
-
-    if (freq != self->lastFreq) {
-        self->lastFreq = freq;
-        self->damp = 2.0 - MYCOS(TWOPI * freq / self->sr);
-        self->damp = (self->damp - MYSQRT(self->damp * self->damp - 1.0));
-    }
-
-    for (i=0; i<self->bufsize; i++) {
-        inval = in[i];
-        junction = self->total_signal * .25;
-        self->total_signal = 0.0;
-        for (j=0; j<8; j++) {
-            self->rnd_time[j] += self->rnd_timeInc[j];
-            if (self->rnd_time[j] < 0.0)
-                self->rnd_time[j] += 1.0;
-            else if (self->rnd_time[j] >= 1.0) {
-                self->rnd_time[j] -= 1.0;
-                self->rnd_oldValue[j] = self->rnd_value[j];
-                self->rnd_value[j] = self->rnd_range[j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[j];
-                self->rnd_diff[j] = self->rnd_value[j] - self->rnd_oldValue[j];
-            }
-            self->rnd[j] = self->rnd_oldValue[j] + self->rnd_diff[j] * self->rnd_time[j];
-
-            xind = self->in_count[j] - (self->delays[j] + self->rnd[j]);
-            if (xind < 0)
-                xind += self->size[j];
-            ind = (int)xind;
-            frac = xind - ind;
-            x = self->buffer[j][ind];
-            x1 = self->buffer[j][ind+1];
-            val = x + (x1 - x) * frac;
-            val *= feed;
-            filt = (self->lastSamples[j] - val) * self->damp + val;
-            self->total_signal += filt;
-
-            self->buffer[j][self->in_count[j]] = inval + junction - self->lastSamples[j];
-            self->lastSamples[j] = filt;
-            if(self->in_count[j] == 0)
-                self->buffer[j][self->size[j]] = self->buffer[j][0];
-            self->in_count[j]++;
-            if (self->in_count[j] >= self->size[j])
-                self->in_count[j] = 0;
+    MYFLT *pfeed = feed, *pdamp = damp, *pout = self->data, *pstart = NULL;
+
+    if (self->modebuffer[2] == 0) {
+        fd = PyFloat_AS_DOUBLE(self->feedback);
+        if (fd < 0)
+            fd = 0;
+        else if (fd > 1)
+            fd = 1;
+        for (i=0; i<self->bufsize; i++) {
+            feed[i] = fd;
         }
-        self->data[i] = self->total_signal * 0.25;
-    }
-}
-
-static void
-WGVerb_process_ai(WGVerb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, feed;
-    int i, j, ind;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *feedback = Stream_getData((Stream *)self->feedback_stream);
-    MYFLT freq = PyFloat_AS_DOUBLE(self->cutoff);
-
-    if (freq != self->lastFreq) {
-        self->lastFreq = freq;
-        self->damp = 2.0 - MYCOS(TWOPI * freq / self->sr);
-        self->damp = (self->damp - MYSQRT(self->damp * self->damp - 1.0));
     }
-
-    for (i=0; i<self->bufsize; i++) {
-        inval = in[i];
-        feed = feedback[i];
-        if (feed < 0)
-            feed = 0;
-        else if (feed > 1)
-            feed = 1;
-        junction = self->total_signal * .25;
-        self->total_signal = 0.0;
-        for (j=0; j<8; j++) {
-            self->rnd_time[j] += self->rnd_timeInc[j];
-            if (self->rnd_time[j] < 0.0)
-                self->rnd_time[j] += 1.0;
-            else if (self->rnd_time[j] >= 1.0) {
-                self->rnd_time[j] -= 1.0;
-                self->rnd_oldValue[j] = self->rnd_value[j];
-                self->rnd_value[j] = self->rnd_range[j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[j];
-                self->rnd_diff[j] = self->rnd_value[j] - self->rnd_oldValue[j];
-            }
-            self->rnd[j] = self->rnd_oldValue[j] + self->rnd_diff[j] * self->rnd_time[j];
-
-            xind = self->in_count[j] - (self->delays[j] + self->rnd[j]);
-            if (xind < 0)
-                xind += self->size[j];
-            ind = (int)xind;
-            frac = xind - ind;
-            x = self->buffer[j][ind];
-            x1 = self->buffer[j][ind+1];
-            val = x + (x1 - x) * frac;
-            val *= feed;
-            filt = (self->lastSamples[j] - val) * self->damp + val;
-            self->total_signal += filt;
-
-            self->buffer[j][self->in_count[j]] = inval + junction - self->lastSamples[j];
-            self->lastSamples[j] = filt;
-            if(self->in_count[j] == 0)
-                self->buffer[j][self->size[j]] = self->buffer[j][0];
-            self->in_count[j]++;
-            if (self->in_count[j] >= self->size[j])
-                self->in_count[j] = 0;
+    else {
+        feedback = Stream_getData((Stream *)self->feedback_stream);
+        for (i=0; i<self->bufsize; i++) {
+            fd = feedback[i];
+            if (fd < 0)
+                fd = 0;
+            else if (fd > 1)
+                fd = 1;
+            feed[i] = fd;
         }
-        self->data[i] = self->total_signal * 0.25;
     }
-}
-
-static void
-WGVerb_process_ia(WGVerb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, freq;
-    int i, j, ind;
 
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT feed = PyFloat_AS_DOUBLE(self->feedback);
-    MYFLT *cutoff = Stream_getData((Stream *)self->cutoff_stream);
-
-    if (feed < 0)
-        feed = 0;
-    else if (feed > 1)
-        feed = 1;
-
-    for (i=0; i<self->bufsize; i++) {
-        inval = in[i];
-        freq = cutoff[i];
+    if (self->modebuffer[3] == 0) {
+        freq = PyFloat_AS_DOUBLE(self->cutoff);
         if (freq != self->lastFreq) {
             self->lastFreq = freq;
             self->damp = 2.0 - MYCOS(TWOPI * freq / self->sr);
             self->damp = (self->damp - MYSQRT(self->damp * self->damp - 1.0));
         }
-        junction = self->total_signal * .25;
-        self->total_signal = 0.0;
-        for (j=0; j<8; j++) {
-            self->rnd_time[j] += self->rnd_timeInc[j];
-            if (self->rnd_time[j] < 0.0)
-                self->rnd_time[j] += 1.0;
-            else if (self->rnd_time[j] >= 1.0) {
-                self->rnd_time[j] -= 1.0;
-                self->rnd_oldValue[j] = self->rnd_value[j];
-                self->rnd_value[j] = self->rnd_range[j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[j];
-                self->rnd_diff[j] = self->rnd_value[j] - self->rnd_oldValue[j];
-            }
-            self->rnd[j] = self->rnd_oldValue[j] + self->rnd_diff[j] * self->rnd_time[j];
-
-            xind = self->in_count[j] - (self->delays[j] + self->rnd[j]);
-            if (xind < 0)
-                xind += self->size[j];
-            ind = (int)xind;
-            frac = xind - ind;
-            x = self->buffer[j][ind];
-            x1 = self->buffer[j][ind+1];
-            val = x + (x1 - x) * frac;
-            val *= feed;
-            filt = (self->lastSamples[j] - val) * self->damp + val;
-            self->total_signal += filt;
-
-            self->buffer[j][self->in_count[j]] = inval + junction - self->lastSamples[j];
-            self->lastSamples[j] = filt;
-            if(self->in_count[j] == 0)
-                self->buffer[j][self->size[j]] = self->buffer[j][0];
-            self->in_count[j]++;
-            if (self->in_count[j] >= self->size[j])
-                self->in_count[j] = 0;
+        for (i=0; i<self->bufsize; i++) {
+            damp[i] = self->damp;
         }
-        self->data[i] = self->total_signal * 0.25;
     }
-}
-
-static void
-WGVerb_process_aa(WGVerb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, feed, freq;
-    int i, j, ind;
-
-    MYFLT *in = Stream_getData((Stream *)self->input_stream);
-    MYFLT *feedback = Stream_getData((Stream *)self->feedback_stream);
-    MYFLT *cutoff = Stream_getData((Stream *)self->cutoff_stream);
-
-    for (i=0; i<self->bufsize; i++) {
-        inval = in[i];
-        feed = feedback[i];
-        freq = cutoff[i];
-        if (feed < 0)
-            feed = 0;
-        else if (feed > 1)
-            feed = 1;
-        if (freq != self->lastFreq) {
-            self->lastFreq = freq;
-            self->damp = 2.0 - MYCOS(TWOPI * freq / self->sr);
-            self->damp = (self->damp - MYSQRT(self->damp * self->damp - 1.0));
-        }
-        junction = self->total_signal * .25;
-        self->total_signal = 0.0;
-        for (j=0; j<8; j++) {
-            self->rnd_time[j] += self->rnd_timeInc[j];
-            if (self->rnd_time[j] < 0.0)
-                self->rnd_time[j] += 1.0;
-            else if (self->rnd_time[j] >= 1.0) {
-                self->rnd_time[j] -= 1.0;
-                self->rnd_oldValue[j] = self->rnd_value[j];
-                self->rnd_value[j] = self->rnd_range[j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[j];
-                self->rnd_diff[j] = self->rnd_value[j] - self->rnd_oldValue[j];
+    else {
+        cutoff = Stream_getData((Stream *)self->cutoff_stream);
+        for (i=0; i<self->bufsize; i++) {
+            freq = cutoff[i];
+            if (freq != self->lastFreq) {
+                self->lastFreq = freq;
+                self->damp = 2.0 - MYCOS(TWOPI * freq / self->sr);
+                self->damp = (self->damp - MYSQRT(self->damp * self->damp - 1.0));
             }
-            self->rnd[j] = self->rnd_oldValue[j] + self->rnd_diff[j] * self->rnd_time[j];
-
-            xind = self->in_count[j] - (self->delays[j] + self->rnd[j]);
-            if (xind < 0)
-                xind += self->size[j];
-            ind = (int)xind;
-            frac = xind - ind;
-            x = self->buffer[j][ind];
-            x1 = self->buffer[j][ind+1];
-            val = x + (x1 - x) * frac;
-            val *= feed;
-            filt = (self->lastSamples[j] - val) * self->damp + val;
-            self->total_signal += filt;
-
-            self->buffer[j][self->in_count[j]] = inval + junction - self->lastSamples[j];
-            self->lastSamples[j] = filt;
-            if(self->in_count[j] == 0)
-                self->buffer[j][self->size[j]] = self->buffer[j][0];
-            self->in_count[j]++;
-            if (self->in_count[j] >= self->size[j])
-                self->in_count[j] = 0;
+            damp[i] = self->damp;
         }
-        self->data[i] = self->total_signal * 0.25;
     }
+
+    WGLines_process(&self->lines, 1, &in, &pstart, &pfeed, &pdamp, &pout, self->bufsize);
 }
 
 static void
@@ -366,25 +171,12 @@ static void WGVerb_postprocessing_revareva(WGVerb *self) { POST_PROCESSING_REVAR
 static void
 WGVerb_setProcMode(WGVerb *self)
 {
-    int procmode, muladdmode, mixmode;
-    procmode = self->modebuffer[2] + self->modebuffer[3] * 10;
+    int muladdmode, mixmode;
     muladdmode = self->modebuffer[0] + self->modebuffer[1] * 10;
     mixmode = self->modebuffer[4];
 
-	switch (procmode) {
-        case 0:
-            self->proc_func_ptr = WGVerb_process_ii;
-            break;
-        case 1:
-            self->proc_func_ptr = WGVerb_process_ai;
-            break;
-        case 10:
-            self->proc_func_ptr = WGVerb_process_ia;
-            break;
-        case 11:
-            self->proc_func_ptr = WGVerb_process_aa;
-            break;
-    }
+    /* feedback and cutoff are read by WGVerb_process. */
+    self->proc_func_ptr = WGVerb_process;
     switch (mixmode) {
         case 0:
             self->mix_func_ptr = WGVerb_mix_i;
@@ -469,7 +261,7 @@ WGVerb_dealloc(WGVerb* self)
     int i;
     pyo_DEALLOC
     for (i=0; i<8; i++) {
-        free(self->buffer[i]);
+        free(self->lines.buffer[i]);
     }
     WGVerb_clear(self);
     self->ob_type->tp_free((PyObject*)self);
@@ -479,6 +271,7 @@ static PyObject *
 WGVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i, j;
+    size_t memory = 0;
     PyObject *inputtmp, *input_streamtmp, *feedbacktmp=NULL, *cutofftmp=NULL, *mixtmp=NULL, *multmp=NULL, *addtmp=NULL;
     WGVerb *self;
     self = (WGVerb *)type->tp_alloc(type, 0);
@@ -488,7 +281,7 @@ WGVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->mix = PyFloat_FromDouble(0.5);
     self->lastFreq = self->damp = 0.0;
 
-    self->total_signal = 0.0;
+    self->lines.total_signal = 0.0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
 	self->modebuffer[2] = 0;
@@ -500,15 +293,16 @@ WGVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->mode_func_ptr = WGVerb_setProcMode;
 
     for (i=0; i<8; i++) {
-        self->in_count[i] = 0;
-        self->lastSamples[i] = 0.0;
-        self->rnd[i] = self->rnd_value[i] = self->rnd_oldValue[i] = self->rnd_diff[i] = 0.0;
-        self->rnd_time[i] = 1.0;
-        self->rnd_timeInc[i] = reverbParams[i][2] * randomScaling / self->sr;
-        self->rnd_range[i] = reverbParams[i][1] * randomScaling * self->sr;
-        self->rnd_halfRange[i] = self->rnd_range[i] * 0.5;
-        self->delays[i] = reverbParams[i][0] * (self->sr / 44100.0);
+        self->lines.in_count[i] = 0;
+        self->lines.lastSamples[i] = 0.0;
+        self->lines.rnd[i] = self->lines.rnd_value[i] = self->lines.rnd_oldValue[i] = self->lines.rnd_diff[i] = 0.0;
+        self->lines.rnd_time[i] = 1.0;
+        self->lines.rnd_timeInc[i] = reverbParams[i][2] * randomScaling / self->sr;
+        self->lines.rnd_range[i] = reverbParams[i][1] * randomScaling * self->sr;
+        self->lines.rnd_halfRange[i] = self->lines.rnd_range[i] * 0.5;
+        self->lines.delays[i] = reverbParams[i][0] * (self->sr / 44100.0);
     }
+    PyoRand_seed(&self->lines.rng, Server_generateSeed((Server *)self->server, WGVERB_ID));
 
     static char *kwlist[] = {"input", "feedback", "cutoff", "mix", "mul", "add", NULL};
 
@@ -540,12 +334,16 @@ WGVerb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     PyObject_CallMethod(self->server, "addStream", "O", self->stream);
 
     for (i=0; i<8; i++) {
-        self->size[i] = reverbParams[i][0] * (self->sr / 44100.0) + (int)(reverbParams[i][1] * self->sr + 0.5);
-        self->buffer[i] = (MYFLT *)realloc(self->buffer[i], (self->size[i]+1) * sizeof(MYFLT));
-        for (j=0; j<(self->size[i]+1); j++) {
-            self->buffer[i][j] = 0.;
+        self->lines.size[i] = reverbParams[i][0] * (self->sr / 44100.0) + (int)(reverbParams[i][1] * self->sr + 0.5);
+        self->lines.buffer[i] = (MYFLT *)realloc(self->lines.buffer[i], (self->lines.size[i]+1) * sizeof(MYFLT));
+        for (j=0; j<(self->lines.size[i]+1); j++) {
+            self->lines.buffer[i][j] = 0.;
         }
+        memory += self->lines.size[i] + 1;
     }
+    Stream_setMemory(self->stream, memory * sizeof(MYFLT));
+
+    Stream_setTail(self->stream, (long)(self->sr * 0.125));
 
     (*self->mode_func_ptr)(self);
 
@@ -804,11 +602,7 @@ typedef struct {
     void (*mix_func_ptr)();
     int modebuffer[4];
     MYFLT firstRefGain;
-    MYFLT total_signal[2];
-    MYFLT delays[2][8];
-    long size[2][8];
-    int in_count[2][8];
-    MYFLT *buffer[2][8];
+    WGLines lines[2];
     MYFLT *ref_buffer[NUM_REFS];
     int ref_size[NUM_REFS];
     int ref_in_count[NUM_REFS];
@@ -819,28 +613,35 @@ typedef struct {
     MYFLT lastFreq;
     MYFLT nyquist;
     MYFLT lastInpos;
-    // sample memories
-    MYFLT lastSamples[2][8];
-    // jitters
-    MYFLT rnd[2][8];
-    MYFLT rnd_value[2][8];
-    MYFLT rnd_oldValue[2][8];
-    MYFLT rnd_diff[2][8];
-    MYFLT rnd_time[2][8];
-    MYFLT rnd_timeInc[2][8];
-    MYFLT rnd_range[2][8];
-    MYFLT rnd_halfRange[2][8];
     MYFLT *buffer_streams;
     MYFLT *input_buffer[2];
 } STReverb;
 
+/* Runs the two networks over the block, see WGLines_process. */
+static void
+STReverb_lines(STReverb *self, MYFLT inval[2][self->bufsize], MYFLT start[2][self->bufsize],
+               MYFLT feed[2][self->bufsize], MYFLT damp[2][self->bufsize])
+{
+    MYFLT *pin[2] = {inval[0], inval[1]};
+    MYFLT *pstart[2] = {start[0], start[1]};
+    MYFLT *pfeed[2] = {feed[0], feed[1]};
+    MYFLT *pdamp[2] = {damp[0], damp[1]};
+    MYFLT *pout[2] = {self->buffer_streams, self->buffer_streams + self->bufsize};
+
+    WGLines_process(self->lines, 2, pin, pstart, pfeed, pdamp, pout, self->bufsize);
+}
+
 static void
 STReverb_process_ii(STReverb *self) {
-    int i, j, k, k2, ind, half;
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, amp1, amp2, b, f, sum_ref, feed, step, invp;
+    int i, k, k2, half;
+    MYFLT amp1, amp2, b, f, sum_ref, feed, step, invp;
     MYFLT ref_amp_l[NUM_REFS];
     MYFLT ref_amp_r[NUM_REFS];
     MYFLT ref_buf[2];
+    MYFLT inval[2][self->bufsize];
+    MYFLT start[2][self->bufsize];
+    MYFLT feeds[2][self->bufsize];
+    MYFLT damp[2][self->bufsize];
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT inpos = PyFloat_AS_DOUBLE(self->inpos);
@@ -915,53 +716,26 @@ STReverb_process_ii(STReverb *self) {
             ref_buf[1] += sum_ref * ref_amp_r[k];
         }
         for (k=0; k<2; k++) {
-            inval = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
-            junction = self->total_signal[k] * .25;
-            self->total_signal[k] = ref_buf[k] * self->firstRefGain;
-            for (j=0; j<8; j++) {
-                self->rnd_time[k][j] += self->rnd_timeInc[k][j];
-                if (self->rnd_time[k][j] < 0.0)
-                    self->rnd_time[k][j] += 1.0;
-                else if (self->rnd_time[k][j] >= 1.0) {
-                    self->rnd_time[k][j] -= 1.0;
-                    self->rnd_oldValue[k][j] = self->rnd_value[k][j];
-                    self->rnd_value[k][j] = self->rnd_range[k][j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[k][j];
-                    self->rnd_diff[k][j] = self->rnd_value[k][j] - self->rnd_oldValue[k][j];
-                }
-                self->rnd[k][j] = self->rnd_oldValue[k][j] + self->rnd_diff[k][j] * self->rnd_time[k][j];
-
-                xind = self->in_count[k][j] - (self->delays[k][j] + self->rnd[k][j]);
-                if (xind < 0)
-                    xind += self->size[k][j];
-                ind = (int)xind;
-                frac = xind - ind;
-                x = self->buffer[k][j][ind];
-                x1 = self->buffer[k][j][ind+1];
-                val = x + (x1 - x) * frac;
-                val *= feed;
-                filt = val + (self->lastSamples[k][j] - val) * self->damp[k];
-                self->total_signal[k] += filt;
-
-                self->buffer[k][j][self->in_count[k][j]] = inval + junction - self->lastSamples[k][j];
-                self->lastSamples[k][j] = filt;
-                if(self->in_count[k][j] == 0)
-                    self->buffer[k][j][self->size[k][j]] = self->buffer[k][j][0];
-                self->in_count[k][j]++;
-                if (self->in_count[k][j] >= self->size[k][j])
-                    self->in_count[k][j] = 0;
-            }
-            self->buffer_streams[i+k*self->bufsize] = self->total_signal[k] * 0.25;
+            inval[k][i] = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
+            start[k][i] = ref_buf[k] * self->firstRefGain;
+            damp[k][i] = self->damp[k];
+            feeds[k][i] = feed;
         }
     }
+    STReverb_lines(self, inval, start, feeds, damp);
 }
 
 static void
 STReverb_process_ai(STReverb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, amp1, amp2, b, f, sum_ref, inpos, feed, step, invp;
+    MYFLT amp1, amp2, b, f, sum_ref, inpos, feed, step, invp;
     MYFLT ref_amp_l[NUM_REFS];
     MYFLT ref_amp_r[NUM_REFS];
     MYFLT ref_buf[2];
-    int i, j, k, k2, ind, half;
+    MYFLT inval[2][self->bufsize];
+    MYFLT start[2][self->bufsize];
+    MYFLT feeds[2][self->bufsize];
+    MYFLT damp[2][self->bufsize];
+    int i, k, k2, half;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *pos = Stream_getData((Stream *)self->inpos_stream);
@@ -1036,53 +810,26 @@ STReverb_process_ai(STReverb *self) {
             ref_buf[1] += sum_ref * ref_amp_r[k];
         }
         for (k=0; k<2; k++) {
-            inval = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
-            junction = self->total_signal[k] * .25;
-            self->total_signal[k] = ref_buf[k] * self->firstRefGain;
-            for (j=0; j<8; j++) {
-                self->rnd_time[k][j] += self->rnd_timeInc[k][j];
-                if (self->rnd_time[k][j] < 0.0)
-                    self->rnd_time[k][j] += 1.0;
-                else if (self->rnd_time[k][j] >= 1.0) {
-                    self->rnd_time[k][j] -= 1.0;
-                    self->rnd_oldValue[k][j] = self->rnd_value[k][j];
-                    self->rnd_value[k][j] = self->rnd_range[k][j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[k][j];
-                    self->rnd_diff[k][j] = self->rnd_value[k][j] - self->rnd_oldValue[k][j];
-                }
-                self->rnd[k][j] = self->rnd_oldValue[k][j] + self->rnd_diff[k][j] * self->rnd_time[k][j];
-
-                xind = self->in_count[k][j] - (self->delays[k][j] + self->rnd[k][j]);
-                if (xind < 0)
-                    xind += self->size[k][j];
-                ind = (int)xind;
-                frac = xind - ind;
-                x = self->buffer[k][j][ind];
-                x1 = self->buffer[k][j][ind+1];
-                val = x + (x1 - x) * frac;
-                val *= feed;
-                filt = val + (self->lastSamples[k][j] - val) * self->damp[k];
-                self->total_signal[k] += filt;
-
-                self->buffer[k][j][self->in_count[k][j]] = inval + junction - self->lastSamples[k][j];
-                self->lastSamples[k][j] = filt;
-                if(self->in_count[k][j] == 0)
-                    self->buffer[k][j][self->size[k][j]] = self->buffer[k][j][0];
-                self->in_count[k][j]++;
-                if (self->in_count[k][j] >= self->size[k][j])
-                    self->in_count[k][j] = 0;
-            }
-            self->buffer_streams[i+k*self->bufsize] = self->total_signal[k] * 0.25;
+            inval[k][i] = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
+            start[k][i] = ref_buf[k] * self->firstRefGain;
+            damp[k][i] = self->damp[k];
+            feeds[k][i] = feed;
         }
     }
+    STReverb_lines(self, inval, start, feeds, damp);
 }
 
 static void
 STReverb_process_ia(STReverb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, amp1, amp2, b, f, sum_ref, feed, freq, step, invp;
+    MYFLT amp1, amp2, b, f, sum_ref, feed, freq, step, invp;
     MYFLT ref_amp_l[NUM_REFS];
     MYFLT ref_amp_r[NUM_REFS];
     MYFLT ref_buf[2];
-    int i, j, k, k2, ind, half;
+    MYFLT inval[2][self->bufsize];
+    MYFLT start[2][self->bufsize];
+    MYFLT feeds[2][self->bufsize];
+    MYFLT damp[2][self->bufsize];
+    int i, k, k2, half;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT inpos = PyFloat_AS_DOUBLE(self->inpos);
@@ -1158,53 +905,26 @@ STReverb_process_ia(STReverb *self) {
             ref_buf[1] += sum_ref * ref_amp_r[k];
         }
         for (k=0; k<2; k++) {
-            inval = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
-            junction = self->total_signal[k] * .25;
-            self->total_signal[k] = ref_buf[k] * self->firstRefGain;
-            for (j=0; j<8; j++) {
-                self->rnd_time[k][j] += self->rnd_timeInc[k][j];
-                if (self->rnd_time[k][j] < 0.0)
-                    self->rnd_time[k][j] += 1.0;
-                else if (self->rnd_time[k][j] >= 1.0) {
-                    self->rnd_time[k][j] -= 1.0;
-                    self->rnd_oldValue[k][j] = self->rnd_value[k][j];
-                    self->rnd_value[k][j] = self->rnd_range[k][j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[k][j];
-                    self->rnd_diff[k][j] = self->rnd_value[k][j] - self->rnd_oldValue[k][j];
-                }
-                self->rnd[k][j] = self->rnd_oldValue[k][j] + self->rnd_diff[k][j] * self->rnd_time[k][j];
-
-                xind = self->in_count[k][j] - (self->delays[k][j] + self->rnd[k][j]);
-                if (xind < 0)
-                    xind += self->size[k][j];
-                ind = (int)xind;
-                frac = xind - ind;
-                x = self->buffer[k][j][ind];
-                x1 = self->buffer[k][j][ind+1];
-                val = x + (x1 - x) * frac;
-                val *= feed;
-                filt = val + (self->lastSamples[k][j] - val) * self->damp[k];
-                self->total_signal[k] += filt;
-
-                self->buffer[k][j][self->in_count[k][j]] = inval + junction - self->lastSamples[k][j];
-                self->lastSamples[k][j] = filt;
-                if(self->in_count[k][j] == 0)
-                    self->buffer[k][j][self->size[k][j]] = self->buffer[k][j][0];
-                self->in_count[k][j]++;
-                if (self->in_count[k][j] >= self->size[k][j])
-                    self->in_count[k][j] = 0;
-            }
-            self->buffer_streams[i+k*self->bufsize] = self->total_signal[k] * 0.25;
+            inval[k][i] = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
+            start[k][i] = ref_buf[k] * self->firstRefGain;
+            damp[k][i] = self->damp[k];
+            feeds[k][i] = feed;
         }
     }
+    STReverb_lines(self, inval, start, feeds, damp);
 }
 
 static void
 STReverb_process_aa(STReverb *self) {
-    MYFLT val, x, x1, xind, frac, junction, inval, filt, amp1, amp2, b, f, sum_ref, inpos, feed, freq, step, invp;
+    MYFLT amp1, amp2, b, f, sum_ref, inpos, feed, freq, step, invp;
     MYFLT ref_amp_l[NUM_REFS];
     MYFLT ref_amp_r[NUM_REFS];
     MYFLT ref_buf[2];
-    int i, j, k, k2, ind, half;
+    MYFLT inval[2][self->bufsize];
+    MYFLT start[2][self->bufsize];
+    MYFLT feeds[2][self->bufsize];
+    MYFLT damp[2][self->bufsize];
+    int i, k, k2, half;
 
     MYFLT *in = Stream_getData((Stream *)self->input_stream);
     MYFLT *pos = Stream_getData((Stream *)self->inpos_stream);
@@ -1280,44 +1000,13 @@ STReverb_process_aa(STReverb *self) {
             ref_buf[1] += sum_ref * ref_amp_r[k];
         }
         for (k=0; k<2; k++) {
-            inval = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
-            junction = self->total_signal[k] * .25;
-            self->total_signal[k] = ref_buf[k] * self->firstRefGain;
-            for (j=0; j<8; j++) {
-                self->rnd_time[k][j] += self->rnd_timeInc[k][j];
-                if (self->rnd_time[k][j] < 0.0)
-                    self->rnd_time[k][j] += 1.0;
-                else if (self->rnd_time[k][j] >= 1.0) {
-                    self->rnd_time[k][j] -= 1.0;
-                    self->rnd_oldValue[k][j] = self->rnd_value[k][j];
-                    self->rnd_value[k][j] = self->rnd_range[k][j] * (rand()/((MYFLT)(RAND_MAX)+1)) - self->rnd_halfRange[k][j];
-                    self->rnd_diff[k][j] = self->rnd_value[k][j] - self->rnd_oldValue[k][j];
-                }
-                self->rnd[k][j] = self->rnd_oldValue[k][j] + self->rnd_diff[k][j] * self->rnd_time[k][j];
-
-                xind = self->in_count[k][j] - (self->delays[k][j] + self->rnd[k][j]);
-                if (xind < 0)
-                    xind += self->size[k][j];
-                ind = (int)xind;
-                frac = xind - ind;
-                x = self->buffer[k][j][ind];
-                x1 = self->buffer[k][j][ind+1];
-                val = x + (x1 - x) * frac;
-                val *= feed;
-                filt = val + (self->lastSamples[k][j] - val) * self->damp[k];
-                self->total_signal[k] += filt;
-
-                self->buffer[k][j][self->in_count[k][j]] = inval + junction - self->lastSamples[k][j];
-                self->lastSamples[k][j] = filt;
-                if(self->in_count[k][j] == 0)
-                    self->buffer[k][j][self->size[k][j]] = self->buffer[k][j][0];
-                self->in_count[k][j]++;
-                if (self->in_count[k][j] >= self->size[k][j])
-                    self->in_count[k][j] = 0;
-            }
-            self->buffer_streams[i+k*self->bufsize] = self->total_signal[k] * 0.25;
+            inval[k][i] = self->input_buffer[k][i] * 0.8 + self->input_buffer[1-k][i] * 0.2 + ref_buf[k] * 0.1;
+            start[k][i] = ref_buf[k] * self->firstRefGain;
+            damp[k][i] = self->damp[k];
+            feeds[k][i] = feed;
         }
     }
+    STReverb_lines(self, inval, start, feeds, damp);
 }
 
 static void
@@ -1447,7 +1136,7 @@ STReverb_dealloc(STReverb* self)
     for (k=0; k<2; k++) {
             free(self->input_buffer[k]);
         for (i=0; i<8; i++) {
-            free(self->buffer[k][i]);
+            free(self->lines[k].buffer[i]);
         }
     }
     for (i=0; i<NUM_REFS; i++) {
@@ -1463,6 +1152,7 @@ STReverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
 {
     int i, j, k, din;
     long maxsize;
+    size_t memory = 0;
     MYFLT roomSize = 1.0;
     MYFLT firstRefTmp = -3.0;
     PyObject *inputtmp, *input_streamtmp, *inpostmp=NULL, *revtimetmp=NULL, *cutofftmp=NULL, *mixtmp=NULL;
@@ -1473,7 +1163,7 @@ STReverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->revtime = PyFloat_FromDouble(0.5);
     self->cutoff = PyFloat_FromDouble(5000.0);
     self->mix = PyFloat_FromDouble(0.5);
-    self->total_signal[0] = self->total_signal[1] = self->lastFreq = self->damp[0] = self->damp[1] = 0.0;
+    self->lines[0].total_signal = self->lines[1].total_signal = self->lastFreq = self->damp[0] = self->damp[1] = 0.0;
     self->lastInpos = -1.0;
 	self->modebuffer[0] = 0;
 	self->modebuffer[1] = 0;
@@ -1521,21 +1211,23 @@ STReverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     self->avg_time = 0.0;
     for (k=0; k<2; k++) {
         din = k * 3;
+        PyoRand_seed(&self->lines[k].rng, Server_generateSeed((Server *)self->server, STREV_ID));
         for (i=0; i<8; i++) {
-            self->in_count[k][i] = 0;
-            self->lastSamples[k][i] = 0.0;
-            self->rnd[k][i] = self->rnd_value[k][i] = self->rnd_oldValue[k][i] = self->rnd_diff[k][i] = 0.0;
-            self->rnd_time[k][i] = 1.0;
-            self->rnd_timeInc[k][i] = reverbParams[i][2] * randomScaling / self->sr;
-            self->rnd_range[k][i] = reverbParams[i][1] * randomScaling * self->sr;
-            self->rnd_halfRange[k][i] = self->rnd_range[k][i] * 0.5;
-            self->delays[k][i] = reverbParams[i][din] * self->srfac * roomSize;
-            self->avg_time += self->delays[k][i] / self->sr;
-            self->size[k][i] = reverbParams[i][din] * self->srfac * roomSize + (int)(reverbParams[i][1] * self->sr + 0.5);
+            self->lines[k].in_count[i] = 0;
+            self->lines[k].lastSamples[i] = 0.0;
+            self->lines[k].rnd[i] = self->lines[k].rnd_value[i] = self->lines[k].rnd_oldValue[i] = self->lines[k].rnd_diff[i] = 0.0;
+            self->lines[k].rnd_time[i] = 1.0;
+            self->lines[k].rnd_timeInc[i] = reverbParams[i][2] * randomScaling / self->sr;
+            self->lines[k].rnd_range[i] = reverbParams[i][1] * randomScaling * self->sr;
+            self->lines[k].rnd_halfRange[i] = self->lines[k].rnd_range[i] * 0.5;
+            self->lines[k].delays[i] = reverbParams[i][din] * self->srfac * roomSize;
+            self->avg_time += self->lines[k].delays[i] / self->sr;
+            self->lines[k].size[i] = reverbParams[i][din] * self->srfac * roomSize + (int)(reverbParams[i][1] * self->sr + 0.5);
             maxsize = reverbParams[i][din] * self->srfac * 4.0 + (int)(reverbParams[i][1] * self->sr + 0.5);
-            self->buffer[k][i] = (MYFLT *)realloc(self->buffer[k][i], (maxsize+1) * sizeof(MYFLT));
+            self->lines[k].buffer[i] = (MYFLT *)realloc(self->lines[k].buffer[i], (maxsize+1) * sizeof(MYFLT));
+            memory += maxsize + 1;
             for (j=0; j<(maxsize+1); j++) {
-                self->buffer[k][i][j] = 0.;
+                self->lines[k].buffer[i][j] = 0.;
             }
         }
     }
@@ -1546,6 +1238,7 @@ STReverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
         self->ref_size[k] = (int)(first_ref_delays[k] * self->srfac * roomSize + 0.5);
         maxsize = (int)(first_ref_delays[k] * self->srfac * 4.0 + 0.5);
         self->ref_buffer[k] = (MYFLT *)realloc(self->ref_buffer[k], (maxsize+1) * sizeof(MYFLT));
+        memory += maxsize + 1;
         for (i=0; i<(maxsize+1); i++) {
             self->ref_buffer[k][i] = 0.0;
         }
@@ -1562,6 +1255,8 @@ STReverb_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
     for (i=0; i<(2 * self->bufsize); i++) {
         self->buffer_streams[i] = 0.0;
     }
+    memory += 4 * self->bufsize;
+    Stream_setMemory(self->stream, memory * sizeof(MYFLT));
 
     (*self->mode_func_ptr)(self);
 
@@ -1735,16 +1430,16 @@ STReverb_setRoomSize(STReverb *self, PyObject *arg)
         for (k=0; k<2; k++) {
             din = k * 3;
             for (i=0; i<8; i++) {
-                self->in_count[k][i] = 0;
-                self->lastSamples[k][i] = 0.0;
-                self->rnd[k][i] = self->rnd_value[k][i] = self->rnd_oldValue[k][i] = self->rnd_diff[k][i] = 0.0;
-                self->rnd_time[k][i] = 1.0;
-                self->delays[k][i] = reverbParams[i][din] * self->srfac * roomSize;
-                self->avg_time += self->delays[k][i] / self->sr;
-                self->size[k][i] = reverbParams[i][din] * self->srfac * roomSize + (int)(reverbParams[i][1] * self->sr + 0.5);
+                self->lines[k].in_count[i] = 0;
+                self->lines[k].lastSamples[i] = 0.0;
+                self->lines[k].rnd[i] = self->lines[k].rnd_value[i] = self->lines[k].rnd_oldValue[i] = self->lines[k].rnd_diff[i] = 0.0;
+                self->lines[k].rnd_time[i] = 1.0;
+                self->lines[k].delays[i] = reverbParams[i][din] * self->srfac * roomSize;
+                self->avg_time += self->lines[k].delays[i] / self->sr;
+                self->lines[k].size[i] = reverbParams[i][din] * self->srfac * roomSize + (int)(reverbParams[i][1] * self->sr + 0.5);
                 maxsize = reverbParams[i][din] * self->srfac * 2 + (int)(reverbParams[i][1] * self->sr + 0.5);
                 for (j=0; j<(maxsize+1); j++) {
-                    self->buffer[k][i][j] = 0.;
+                    self->lines[k].buffer[i][j] = 0.;
                 }
             }
         }